@@ -32,18 +32,25 @@
 #include "GFXAPI.h"
 #include "Core/Error.h"
 #include "Utils/Math/Common.h"
+#include <algorithm>
 
 namespace Falcor
 {
+namespace
+{
+/// Default number of pages of empty memory kept for reuse.
+const size_t kDefaultRetainedPageCount = 8;
+} // namespace
+
 GpuMemoryHeap::~GpuMemoryHeap()
 {
-    mDeferredReleases = decltype(mDeferredReleases)();
+    mDeferredReleases.clear();
 }
 
 GpuMemoryHeap::GpuMemoryHeap(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence)
-    : mpDevice(pDevice), mMemoryType(memoryType), mpFence(pFence), mPageSize(pageSize)
+    : mpDevice(pDevice), mMemoryType(memoryType), mpFence(pFence), mPageSize(pageSize), mMaxRetainedBytes(kDefaultRetainedPageCount * pageSize)
 {
-    allocateNewPage();
+    addPage(mPageSize);
 }
 
 ref<GpuMemoryHeap> GpuMemoryHeap::create(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence)
@@ -51,57 +58,38 @@ ref<GpuMemoryHeap> GpuMemoryHeap::create(ref<Device> pDevice, MemoryType memoryT
     return ref<GpuMemoryHeap>(new GpuMemoryHeap(pDevice, memoryType, pageSize, pFence));
 }
 
-void GpuMemoryHeap::allocateNewPage()
+void GpuMemoryHeap::addPage(size_t size)
 {
-    if (mpActivePage)
-    {
-        mUsedPages[mCurrentPageId] = std::move(mpActivePage);
-    }
-
-    if (mAvailablePages.size())
-    {
-        mpActivePage = std::move(mAvailablePages.front());
-        mAvailablePages.pop();
-        mpActivePage->allocationsCount = 0;
-        mpActivePage->currentOffset = 0;
-    }
-    else
-    {
-        mpActivePage = std::make_unique<PageData>();
-        initBasePageData((*mpActivePage), mPageSize);
-    }
-
-    mpActivePage->currentOffset = 0;
-    mCurrentPageId++;
+    uint32_t page = mAllocator.addPage(size);
+    if (page >= mPages.size())
+        mPages.resize(page + 1);
+    initBasePageData(mPages[page], size);
+    mCreatedPageCount++;
 }
 
 GpuMemoryHeap::Allocation GpuMemoryHeap::allocate(size_t size, size_t alignment)
 {
-    Allocation data;
-    if (size > mPageSize)
-    {
-        data.pageID = GpuMemoryHeap::Allocation::kMegaPageId;
-        initBasePageData(data, size);
-    }
-    else
-    {
-        // Calculate the start
-        size_t currentOffset = align_to(alignment, mpActivePage->currentOffset);
-        if (currentOffset + size > mPageSize)
-        {
-            currentOffset = 0;
-            allocateNewPage();
-        }
+    // Zero sized allocations still return a valid range.
+    size = std::max<size_t>(size, 1);
 
-        data.pageID = mCurrentPageId;
-        data.size = size;
-        data.offset = currentOffset;
-        data.pData = mpActivePage->pData + currentOffset;
-        data.gfxBufferResource = mpActivePage->gfxBufferResource;
-        mpActivePage->currentOffset = currentOffset + size;
-        mpActivePage->allocationsCount++;
+    auto range = mAllocator.allocate(size, alignment);
+    if (!range.isValid())
+    {
+        // Requests larger than the page size get a dedicated page. It must cover the size class the allocator
+        // searches for, and is rounded up to a multiple of the page size so it can be reused for similar requests.
+        addPage(align_to(mPageSize, TLSFAllocator::getRequiredPageSize(size, alignment)));
+        range = mAllocator.allocate(size, alignment);
+        FALCOR_ASSERT(range.isValid());
     }
 
+    const auto& page = mPages[range.page];
+    Allocation data;
+    data.gfxBufferResource = page.gfxBufferResource;
+    data.size = size;
+    data.offset = range.offset;
+    data.pData = page.pData + range.offset;
+    data.pageID = range.page;
+    data.range = range;
     data.fenceValue = mpFence->getSignaledValue();
     return data;
 }
@@ -115,39 +103,67 @@ GpuMemoryHeap::Allocation GpuMemoryHeap::allocate(size_t size, ResourceBindFlags
 void GpuMemoryHeap::release(Allocation& data)
 {
     FALCOR_ASSERT(data.gfxBufferResource);
-    mDeferredReleases.push(data);
+    // The allocation may have been used by any work submitted until now, so the release waits for
+    // the current fence value rather than the one at allocation time. This keeps the queue ordered.
+    data.fenceValue = mpFence->getSignaledValue();
+    mDeferredReleases.push_back(data);
 }
 
 void GpuMemoryHeap::executeDeferredReleases()
 {
     uint64_t currentValue = mpFence->getCurrentValue();
-    while (mDeferredReleases.size() && mDeferredReleases.top().fenceValue < currentValue)
+    while (mDeferredReleases.size() && mDeferredReleases.front().fenceValue < currentValue)
     {
-        const Allocation& data = mDeferredReleases.top();
-        if (data.pageID == mCurrentPageId)
-        {
-            mpActivePage->allocationsCount--;
-            if (mpActivePage->allocationsCount == 0)
-            {
-                mpActivePage->currentOffset = 0;
-            }
-        }
-        else
+        mAllocator.free(mDeferredReleases.front().range);
+        mDeferredReleases.pop_front();
+    }
+
+    releaseEmptyPages();
+}
+
+void GpuMemoryHeap::releaseEmptyPages()
+{
+    std::vector<uint32_t> emptyPages;
+    size_t emptyBytes = 0;
+    for (uint32_t page = 0; page < mAllocator.getPageSlotCount(); ++page)
+    {
+        if (mAllocator.isPageValid(page) && mAllocator.isPageEmpty(page))
         {
-            if (data.pageID != Allocation::kMegaPageId)
-            {
-                auto& pData = mUsedPages[data.pageID];
-                pData->allocationsCount--;
-                if (pData->allocationsCount == 0)
-                {
-                    mAvailablePages.push(std::move(pData));
-                    mUsedPages.erase(data.pageID);
-                }
-            }
-            // else it's a mega-page. Popping it will release the resource
+            emptyPages.push_back(page);
+            emptyBytes += mAllocator.getPageSize(page);
         }
-        mDeferredReleases.pop();
     }
+    if (emptyBytes <= mMaxRetainedBytes)
+        return;
+
+    // Release the largest pages first, these are typically dedicated pages for large requests.
+    std::sort(
+        emptyPages.begin(),
+        emptyPages.end(),
+        [this](uint32_t a, uint32_t b) { return mAllocator.getPageSize(a) > mAllocator.getPageSize(b); }
+    );
+    // Always keep at least one page.
+    uint32_t pageCount = mAllocator.getStats().pageCount;
+    for (uint32_t page : emptyPages)
+    {
+        if (emptyBytes <= mMaxRetainedBytes || pageCount == 1)
+            break;
+        pageCount--;
+        emptyBytes -= mAllocator.getPageSize(page);
+        mAllocator.removePage(page);
+        mPages[page] = {};
+        mReleasedPageCount++;
+    }
+}
+
+GpuMemoryHeap::Stats GpuMemoryHeap::getStats() const
+{
+    Stats stats;
+    stats.allocator = mAllocator.getStats();
+    stats.createdPageCount = mCreatedPageCount;
+    stats.releasedPageCount = mReleasedPageCount;
+    stats.pendingReleaseCount = (uint32_t)mDeferredReleases.size();
+    return stats;
 }
 
 Slang::ComPtr<gfx::IBufferResource> createBufferResource(
@@ -33,11 +33,20 @@
 #include "Fence.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
-#include <queue>
-#include <unordered_map>
+#include "Utils/TLSFAllocator.h"
+#include <deque>
+#include <vector>
 
 namespace Falcor
 {
+/**
+ * Heap for transient GPU memory (upload and readback data).
+ *
+ * Memory is sub-allocated from pages using a TLSF allocator, which reuses freed ranges in any page.
+ * Requests larger than the page size get a dedicated page, sized to a multiple of the page size.
+ * Empty pages are kept for reuse up to a budget (see setMaxRetainedBytes()), the remaining empty pages are released.
+ * Releases are deferred until the GPU has finished all work submitted before the release.
+ */
 class FALCOR_API GpuMemoryHeap : public Object
 {
     FALCOR_OBJECT(GpuMemoryHeap)
@@ -45,7 +54,7 @@ public:
     struct BaseData
     {
         Slang::ComPtr<gfx::IBufferResource> gfxBufferResource;
-        uint32_t size = 0;
+        uint64_t size = 0;
         GpuAddress offset = 0;
         uint8_t* pData = nullptr;
 
@@ -56,9 +65,15 @@ public:
     {
         uint64_t pageID = 0;
         uint64_t fenceValue = 0;
+        TLSFAllocator::Allocation range; ///< Range of the allocation in its page.
+    };
 
-        static constexpr uint64_t kMegaPageId = -1;
-        bool operator<(const Allocation& other) const { return fenceValue > other.fenceValue; }
+    struct Stats
+    {
+        TLSFAllocator::Stats allocator;    ///< Sub-allocator statistics.
+        uint64_t createdPageCount = 0;     ///< Number of pages created since the heap was created.
+        uint64_t releasedPageCount = 0;    ///< Number of pages released since the heap was created.
+        uint32_t pendingReleaseCount = 0;  ///< Number of releases waiting for the GPU.
     };
 
     ~GpuMemoryHeap();
@@ -74,35 +89,44 @@ public:
 
     Allocation allocate(size_t size, size_t alignment = 1);
     Allocation allocate(size_t size, ResourceBindFlags bindFlags);
+
+    /**
+     * Release an allocation.
+     * The memory is reused once the GPU has finished all work submitted before this call.
+     */
     void release(Allocation& data);
     size_t getPageSize() const { return mPageSize; }
     void executeDeferredReleases();
 
+    /**
+     * Set the maximum total size of empty pages kept for reuse.
+     * Empty pages exceeding the budget are released in executeDeferredReleases(), largest first.
+     * @param[in] bytes Budget in bytes.
+     */
+    void setMaxRetainedBytes(size_t bytes) { mMaxRetainedBytes = bytes; }
+    size_t getMaxRetainedBytes() const { return mMaxRetainedBytes; }
+
+    Stats getStats() const;
+
     void breakStrongReferenceToDevice();
 
 private:
     GpuMemoryHeap(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence);
 
-    struct PageData : public BaseData
-    {
-        uint32_t allocationsCount = 0;
-        size_t currentOffset = 0;
-
-        using UniquePtr = std::unique_ptr<PageData>;
-    };
+    void addPage(size_t size);
+    void releaseEmptyPages();
+    void initBasePageData(BaseData& data, size_t size);
 
     BreakableReference<Device> mpDevice;
     MemoryType mMemoryType;
     ref<Fence> mpFence;
     size_t mPageSize = 0;
-    size_t mCurrentPageId = 0;
-    PageData::UniquePtr mpActivePage;
-
-    std::priority_queue<Allocation> mDeferredReleases;
-    std::unordered_map<size_t, PageData::UniquePtr> mUsedPages;
-    std::queue<PageData::UniquePtr> mAvailablePages;
+    size_t mMaxRetainedBytes = 0;
 
-    void allocateNewPage();
-    void initBasePageData(BaseData& data, size_t size);
+    TLSFAllocator mAllocator;
+    std::vector<BaseData> mPages; ///< Pages indexed by allocator page index.
+    std::deque<Allocation> mDeferredReleases;
+    uint64_t mCreatedPageCount = 0;
+    uint64_t mReleasedPageCount = 0;
 };
 } // namespace Falcor
@@ -434,12 +434,12 @@ FALCOR_API void ParameterBlock::setVariable(const BindLocation& bindLocation, co
 // Buffer
 //
 
-void ParameterBlock::setBuffer(std::string_view name, const ref<Buffer>& pBuffer)
+void ParameterBlock::setBuffer(std::string_view name, ref<Buffer> pBuffer)
 {
-    getRootVar()[name].setBuffer(pBuffer);
+    getRootVar()[name].setBuffer(std::move(pBuffer));
 }
 
-void ParameterBlock::setBuffer(const BindLocation& bindLoc, const ref<Buffer>& pBuffer)
+void ParameterBlock::setBuffer(const BindLocation& bindLoc, ref<Buffer> pBuffer)
 {
     gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLoc);
     if (isUavType(bindLoc.getType()))
@@ -448,8 +448,8 @@ void ParameterBlock::setBuffer(const BindLocation& bindLoc, const ref<Buffer>& p
             FALCOR_THROW("Trying to bind buffer '{}' created without UnorderedAccess flag as a UAV.", pBuffer->getName());
         auto pUAV = pBuffer ? pBuffer->getUAV() : nullptr;
         mpShaderObject->setResource(gfxOffset, pUAV ? pUAV->getGfxResourceView() : nullptr);
-        mUAVs[gfxOffset] = pUAV;
-        mResources[gfxOffset] = pBuffer;
+        mUAVs[gfxOffset] = std::move(pUAV);
+        mResources[gfxOffset] = std::move(pBuffer);
     }
     else if (isSrvType(bindLoc.getType()))
     {
@@ -457,8 +457,8 @@ void ParameterBlock::setBuffer(const BindLocation& bindLoc, const ref<Buffer>& p
             FALCOR_THROW("Trying to bind buffer '{}' created without ShaderResource flag as an SRV.", pBuffer->getName());
         auto pSRV = pBuffer ? pBuffer->getSRV() : nullptr;
         mpShaderObject->setResource(gfxOffset, pSRV ? pSRV->getGfxResourceView() : nullptr);
-        mSRVs[gfxOffset] = pSRV;
-        mResources[gfxOffset] = pBuffer;
+        mSRVs[gfxOffset] = std::move(pSRV);
+        mResources[gfxOffset] = std::move(pBuffer);
     }
     else
     {
@@ -500,12 +500,12 @@ ref<Buffer> ParameterBlock::getBuffer(const BindLocation& bindLoc) const
 // Texture
 //
 
-void ParameterBlock::setTexture(std::string_view name, const ref<Texture>& pTexture)
+void ParameterBlock::setTexture(std::string_view name, ref<Texture> pTexture)
 {
-    getRootVar()[name].setTexture(pTexture);
+    getRootVar()[name].setTexture(std::move(pTexture));
 }
 
-void ParameterBlock::setTexture(const BindLocation& bindLocation, const ref<Texture>& pTexture)
+void ParameterBlock::setTexture(const BindLocation& bindLocation, ref<Texture> pTexture)
 {
     gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
     if (isUavType(bindLocation.getType()))
@@ -514,8 +514,8 @@ void ParameterBlock::setTexture(const BindLocation& bindLocation, const ref<Text
             FALCOR_THROW("Trying to bind texture '{}' created without UnorderedAccess flag as a UAV.", pTexture->getName());
         auto pUAV = pTexture ? pTexture->getUAV() : nullptr;
         mpShaderObject->setResource(gfxOffset, pUAV ? pUAV->getGfxResourceView() : nullptr);
-        mUAVs[gfxOffset] = pUAV;
-        mResources[gfxOffset] = pTexture;
+        mUAVs[gfxOffset] = std::move(pUAV);
+        mResources[gfxOffset] = std::move(pTexture);
     }
     else if (isSrvType(bindLocation.getType()))
     {
@@ -523,8 +523,8 @@ void ParameterBlock::setTexture(const BindLocation& bindLocation, const ref<Text
             FALCOR_THROW("Trying to bind texture '{}' created without ShaderResource flag as an SRV.", pTexture->getName());
         auto pSRV = pTexture ? pTexture->getSRV() : nullptr;
         mpShaderObject->setResource(gfxOffset, pSRV ? pSRV->getGfxResourceView() : nullptr);
-        mSRVs[gfxOffset] = pSRV;
-        mResources[gfxOffset] = pTexture;
+        mSRVs[gfxOffset] = std::move(pSRV);
+        mResources[gfxOffset] = std::move(pTexture);
     }
     else
     {
@@ -566,15 +566,15 @@ ref<Texture> ParameterBlock::getTexture(const BindLocation& bindLocation) const
 // ResourceView
 //
 
-void ParameterBlock::setSrv(const BindLocation& bindLocation, const ref<ShaderResourceView>& pSrv)
+void ParameterBlock::setSrv(const BindLocation& bindLocation, ref<ShaderResourceView> pSrv)
 {
     if (isSrvType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
         mpShaderObject->setResource(gfxOffset, pSrv ? pSrv->getGfxResourceView() : nullptr);
-        mSRVs[gfxOffset] = pSrv;
         // Note: The resource view does not hold a strong reference to the resource, so we need to keep it alive here.
         mResources[gfxOffset] = ref<Resource>(pSrv ? pSrv->getResource() : nullptr);
+        mSRVs[gfxOffset] = std::move(pSrv);
     }
     else
     {
@@ -598,15 +598,15 @@ ref<ShaderResourceView> ParameterBlock::getSrv(const BindLocation& bindLocation)
     }
 }
 
-void ParameterBlock::setUav(const BindLocation& bindLocation, const ref<UnorderedAccessView>& pUav)
+void ParameterBlock::setUav(const BindLocation& bindLocation, ref<UnorderedAccessView> pUav)
 {
     if (isUavType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
         mpShaderObject->setResource(gfxOffset, pUav ? pUav->getGfxResourceView() : nullptr);
-        mUAVs[gfxOffset] = pUav;
         // Note: The resource view does not hold a strong reference to the resource, so we need to keep it alive here.
         mResources[gfxOffset] = ref<Resource>(pUav ? pUav->getResource() : nullptr);
+        mUAVs[gfxOffset] = std::move(pUav);
     }
     else
     {
@@ -630,13 +630,13 @@ ref<UnorderedAccessView> ParameterBlock::getUav(const BindLocation& bindLocation
     }
 }
 
-void ParameterBlock::setAccelerationStructure(const BindLocation& bindLocation, const ref<RtAccelerationStructure>& pAccl)
+void ParameterBlock::setAccelerationStructure(const BindLocation& bindLocation, ref<RtAccelerationStructure> pAccl)
 {
     if (isAccelerationStructureType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
-        mAccelerationStructures[gfxOffset] = pAccl;
         FALCOR_GFX_CALL(mpShaderObject->setResource(gfxOffset, pAccl ? pAccl->getGfxAccelerationStructure() : nullptr));
+        mAccelerationStructures[gfxOffset] = std::move(pAccl);
     }
     else
     {
@@ -664,19 +664,20 @@ ref<RtAccelerationStructure> ParameterBlock::getAccelerationStructure(const Bind
 // Sampler
 //
 
-void ParameterBlock::setSampler(std::string_view name, const ref<Sampler>& pSampler)
+void ParameterBlock::setSampler(std::string_view name, ref<Sampler> pSampler)
 {
-    getRootVar()[name].setSampler(pSampler);
+    getRootVar()[name].setSampler(std::move(pSampler));
 }
 
-void ParameterBlock::setSampler(const BindLocation& bindLocation, const ref<Sampler>& pSampler)
+void ParameterBlock::setSampler(const BindLocation& bindLocation, ref<Sampler> pSampler)
 {
     if (isSamplerType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
-        const ref<Sampler>& pBoundSampler = pSampler ? pSampler : mpDevice->getDefaultSampler();
-        mSamplers[gfxOffset] = pBoundSampler;
-        FALCOR_GFX_CALL(mpShaderObject->setSampler(gfxOffset, pBoundSampler->getGfxSamplerState()));
+        if (!pSampler)
+            pSampler = mpDevice->getDefaultSampler();
+        FALCOR_GFX_CALL(mpShaderObject->setSampler(gfxOffset, pSampler->getGfxSamplerState()));
+        mSamplers[gfxOffset] = std::move(pSampler);
     }
     else
     {
@@ -709,18 +710,18 @@ ref<Sampler> ParameterBlock::getSampler(const BindLocation& bindLocation) const
 // ParameterBlock
 //
 
-void ParameterBlock::setParameterBlock(std::string_view name, const ref<ParameterBlock>& pBlock)
+void ParameterBlock::setParameterBlock(std::string_view name, ref<ParameterBlock> pBlock)
 {
-    getRootVar()[name].setParameterBlock(pBlock);
+    getRootVar()[name].setParameterBlock(std::move(pBlock));
 }
 
-void ParameterBlock::setParameterBlock(const BindLocation& bindLocation, const ref<ParameterBlock>& pBlock)
+void ParameterBlock::setParameterBlock(const BindLocation& bindLocation, ref<ParameterBlock> pBlock)
 {
     if (isParameterBlockType(bindLocation.getType()))
     {
         auto gfxOffset = getGFXShaderOffset(bindLocation);
-        mParameterBlocks[gfxOffset] = pBlock;
         FALCOR_GFX_CALL(mpShaderObject->setObject(gfxOffset, pBlock ? pBlock->mpShaderObject : nullptr));
+        mParameterBlocks[gfxOffset] = std::move(pBlock);
     }
     else
     {
@@ -54,6 +54,9 @@ class CopyContext;
 
 /**
  * A parameter block. This block stores all the parameter data associated with a specific type in shader code
+ *
+ * The resource setters take their reference by value and move it into the block, so binding a temporary
+ * (e.g. the result of RenderData::getTexture()) does not touch the reference count.
  */
 class FALCOR_API ParameterBlock : public Object
 {
@@ -134,7 +137,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pBuffer The buffer object.
      */
-    void setBuffer(std::string_view name, const ref<Buffer>& pBuffer);
+    void setBuffer(std::string_view name, ref<Buffer> pBuffer);
 
     /**
      * Bind a buffer to a variable by bind location.
@@ -142,7 +145,7 @@ public:
      * @param[in] bindLocation The bind location of the variable to bind to.
      * @param[in] pBuffer The buffer object.
      */
-    void setBuffer(const BindLocation& bindLocation, const ref<Buffer>& pBuffer);
+    void setBuffer(const BindLocation& bindLocation, ref<Buffer> pBuffer);
 
     /**
      * Get the buffer bound to a variable by name.
@@ -170,7 +173,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pTexture The texture object.
      */
-    void setTexture(std::string_view name, const ref<Texture>& pTexture);
+    void setTexture(std::string_view name, ref<Texture> pTexture);
 
     /**
      * Bind a texture to a variable by bind location.
@@ -178,7 +181,7 @@ public:
      * @param[in] bindLocation The bind location of the variable to bind to.
      * @param[in] pTexture The texture object.
      */
-    void setTexture(const BindLocation& bindLocation, const ref<Texture>& pTexture);
+    void setTexture(const BindLocation& bindLocation, ref<Texture> pTexture);
 
     /**
      * Get the texture bound to a variable by name.
@@ -206,7 +209,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pSrv The shader-resource-view object.
      */
-    void setSrv(const BindLocation& bindLocation, const ref<ShaderResourceView>& pSrv);
+    void setSrv(const BindLocation& bindLocation, ref<ShaderResourceView> pSrv);
 
     /**
      * Get the SRV bound to a variable by bind location.
@@ -222,7 +225,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pSrv The unordered-access-view object.
      */
-    void setUav(const BindLocation& bindLocation, const ref<UnorderedAccessView>& pUav);
+    void setUav(const BindLocation& bindLocation, ref<UnorderedAccessView> pUav);
 
     /**
      * Get the UAV bound to a variable by bind location.
@@ -238,7 +241,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pAccel The acceleration structure object.
      */
-    void setAccelerationStructure(const BindLocation& bindLocation, const ref<RtAccelerationStructure>& pAccl);
+    void setAccelerationStructure(const BindLocation& bindLocation, ref<RtAccelerationStructure> pAccl);
 
     /**
      * Get the acceleration structure bound to a variable by bind location.
@@ -258,7 +261,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pSampler The sampler object.
      */
-    void setSampler(std::string_view name, const ref<Sampler>& pSampler);
+    void setSampler(std::string_view name, ref<Sampler> pSampler);
 
     /**
      * Bind a sampler to a variable by bind location.
@@ -266,7 +269,7 @@ public:
      * @param[in] bindLocation The bind location of the variable to bind to.
      * @param[in] pSampler The sampler object.
      */
-    void setSampler(const BindLocation& bindLocation, const ref<Sampler>& pSampler);
+    void setSampler(const BindLocation& bindLocation, ref<Sampler> pSampler);
 
     /**
      * Get the sampler bound to a variable by bind location.
@@ -294,7 +297,7 @@ public:
      * @param[in] name The name of the variable to bind to.
      * @param[in] pBlock The parameter block.
      */
-    void setParameterBlock(std::string_view name, const ref<ParameterBlock>& pBlock);
+    void setParameterBlock(std::string_view name, ref<ParameterBlock> pBlock);
 
     /**
      * Bind a parameter block to a variable by bind location.
@@ -302,7 +305,7 @@ public:
      * @param[in] bindLocation The bind location of the variable to bind to.
      * @param[in] pBlock The parameter block object.
      */
-    void setParameterBlock(const BindLocation& bindLocation, const ref<ParameterBlock>& pBlock);
+    void setParameterBlock(const BindLocation& bindLocation, ref<ParameterBlock> pBlock);
 
     /**
      * Get the parameter block bound to a variable by name.
@@ -323,12 +326,12 @@ public:
     /**
      * Get the parameter block's reflection interface
      */
-    ref<const ParameterBlockReflection> getReflection() const { return mpReflector; }
+    const ref<const ParameterBlockReflection>& getReflection() const { return mpReflector; }
 
     /**
      * Get the block reflection type
      */
-    ref<const ReflectionType> getElementType() const { return mpReflector->getElementType(); }
+    const ref<const ReflectionType>& getElementType() const { return mpReflector->getElementType(); }
 
     /**
      * Get the size of the reflection type
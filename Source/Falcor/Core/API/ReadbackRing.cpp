@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ReadbackRing.h"
+#include "Device.h"
+#include "RenderContext.h"
+#include <cstring>
+
+namespace Falcor
+{
+ref<ReadbackRing> ReadbackRing::create(ref<Device> pDevice, size_t slotSize, uint32_t slotCount, ReadbackOverflowPolicy policy)
+{
+    return ref<ReadbackRing>(new ReadbackRing(pDevice, slotSize, slotCount, policy));
+}
+
+ReadbackRing::ReadbackRing(ref<Device> pDevice, size_t slotSize, uint32_t slotCount, ReadbackOverflowPolicy policy)
+    : mpDevice(pDevice), mSlotSize(slotSize), mSlots(slotCount, policy)
+{
+    FALCOR_CHECK(mpDevice, "Invalid device.");
+    FALCOR_CHECK(slotSize > 0, "Readback slot size must be non-zero.");
+
+    mpBuffer = mpDevice->createBuffer(slotSize * slotCount, ResourceBindFlags::None, MemoryType::ReadBack);
+    mpBuffer->setName("ReadbackRing::mpBuffer");
+    mpFence = mpDevice->createFence();
+}
+
+bool ReadbackRing::beginWrite()
+{
+    FALCOR_CHECK(mWriteSlot == ReadbackSlots<Fence>::kInvalidSlot, "beginWrite() called twice without endWrite().");
+    mWriteSlot = mSlots.acquire(*mpFence);
+    return mWriteSlot != ReadbackSlots<Fence>::kInvalidSlot;
+}
+
+void ReadbackRing::endWrite(RenderContext* pRenderContext, uint64_t tag)
+{
+    FALCOR_CHECK(mWriteSlot != ReadbackSlots<Fence>::kInvalidSlot, "endWrite() called without a successful beginWrite().");
+
+    // Submit command list and insert signal.
+    pRenderContext->submit(false);
+    uint64_t fenceValue = pRenderContext->signal(mpFence.get());
+
+    mSlots.commit(mWriteSlot, fenceValue, tag);
+    mWriteSlot = ReadbackSlots<Fence>::kInvalidSlot;
+}
+
+uint64_t ReadbackRing::getWriteOffset() const
+{
+    FALCOR_CHECK(mWriteSlot != ReadbackSlots<Fence>::kInvalidSlot, "No slot acquired for writing.");
+    return mWriteSlot * mSlotSize;
+}
+
+bool ReadbackRing::readLatest(void* pData, bool wait, uint64_t* pTag)
+{
+    FALCOR_ASSERT(pData);
+    uint32_t slot = mSlots.acquireLatest(*mpFence, wait);
+    if (slot == ReadbackSlots<Fence>::kInvalidSlot)
+        return false;
+
+    const uint8_t* pSrc = static_cast<const uint8_t*>(mpBuffer->map(Buffer::MapType::Read));
+    std::memcpy(pData, pSrc + slot * mSlotSize, mSlotSize);
+    mpBuffer->unmap();
+
+    if (pTag)
+        *pTag = mSlots.getSlotTag(slot);
+    return true;
+}
+} // namespace Falcor
@@ -0,0 +1,335 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "fwd.h"
+#include "Buffer.h"
+#include "Fence.h"
+#include "Core/Macros.h"
+#include "Core/Error.h"
+#include "Core/Object.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+class RenderContext;
+
+/// Policy for writing a new readback when all slots of a ring are in flight.
+enum class ReadbackOverflowPolicy
+{
+    DropOldest, ///< Reuse the oldest in-flight slot. Its result is discarded.
+    SkipNew,    ///< Skip the new readback.
+    Wait,       ///< Block until the oldest in-flight slot is complete and reuse it.
+};
+
+/**
+ * Slot state machine of a readback ring.
+ *
+ * Each slot is either free, pending (written by the GPU, tagged with the fence value signaled after the write)
+ * or ready (the fence has passed the tagged value). Readers use latest-available semantics: acquireLatest() returns
+ * the newest ready slot and frees all older ones, so results that were never read are silently superseded.
+ *
+ * The class only tracks state and is parameterized on the fence type so that it can be tested on the CPU.
+ * FenceType must provide getCurrentValue() and wait(value).
+ */
+template<typename FenceType>
+class ReadbackSlots
+{
+public:
+    static constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+
+    enum class SlotState
+    {
+        Free,
+        Pending,
+        Ready,
+    };
+
+    /**
+     * Constructor.
+     * @param[in] slotCount Number of slots.
+     * @param[in] policy Policy when all slots are pending.
+     */
+    ReadbackSlots(uint32_t slotCount, ReadbackOverflowPolicy policy) : mSlots(slotCount), mPolicy(policy)
+    {
+        FALCOR_CHECK(slotCount > 0, "Readback ring needs at least one slot.");
+    }
+
+    /**
+     * Acquire a slot for writing.
+     * Free slots are used first, then the oldest ready slot (which has not been read). If all slots are pending,
+     * the overflow policy decides.
+     * @param[in] fence Fence used for polling and waiting.
+     * @return Slot index, or kInvalidSlot if the readback should be skipped.
+     */
+    uint32_t acquire(FenceType& fence)
+    {
+        update(fence);
+
+        uint32_t oldestReady = kInvalidSlot;
+        uint32_t oldestPending = kInvalidSlot;
+        for (uint32_t i = 0; i < (uint32_t)mSlots.size(); ++i)
+        {
+            const Slot& slot = mSlots[i];
+            if (slot.state == SlotState::Free)
+                return beginWrite(i);
+            uint32_t& oldest = slot.state == SlotState::Ready ? oldestReady : oldestPending;
+            if (oldest == kInvalidSlot || slot.sequence < mSlots[oldest].sequence)
+                oldest = i;
+        }
+
+        if (oldestReady != kInvalidSlot)
+        {
+            mDroppedCount++;
+            return beginWrite(oldestReady);
+        }
+
+        FALCOR_ASSERT(oldestPending != kInvalidSlot);
+        switch (mPolicy)
+        {
+        case ReadbackOverflowPolicy::DropOldest:
+            // The GPU executes the new copy after the old one, so the slot can be overwritten without waiting.
+            mDroppedCount++;
+            return beginWrite(oldestPending);
+        case ReadbackOverflowPolicy::SkipNew:
+            mSkippedCount++;
+            return kInvalidSlot;
+        case ReadbackOverflowPolicy::Wait:
+            fence.wait(mSlots[oldestPending].fenceValue);
+            mDroppedCount++;
+            return beginWrite(oldestPending);
+        default:
+            FALCOR_UNREACHABLE();
+        }
+        return kInvalidSlot;
+    }
+
+    /**
+     * Mark a slot acquired for writing as pending.
+     * @param[in] slot Slot index returned by acquire().
+     * @param[in] fenceValue Fence value signaled after the GPU write.
+     * @param[in] tag User data returned when reading the slot.
+     */
+    void commit(uint32_t slot, uint64_t fenceValue, uint64_t tag = 0)
+    {
+        FALCOR_ASSERT(slot < mSlots.size() && slot == mWriteSlot);
+        Slot& s = mSlots[slot];
+        s.state = SlotState::Pending;
+        s.fenceValue = fenceValue;
+        s.sequence = mNextSequence++;
+        s.tag = tag;
+        mWriteSlot = kInvalidSlot;
+    }
+
+    /**
+     * Poll the fence and mark completed slots as ready.
+     * @param[in] fence Fence used for polling.
+     */
+    void update(FenceType& fence)
+    {
+        const uint64_t completedValue = fence.getCurrentValue();
+        for (Slot& slot : mSlots)
+        {
+            if (slot.state == SlotState::Pending && slot.fenceValue <= completedValue)
+                slot.state = SlotState::Ready;
+        }
+    }
+
+    /**
+     * Get the newest ready slot and free it along with all older ready slots.
+     * The data of the returned slot stays valid until the next call to acquire().
+     * @param[in] fence Fence used for polling and waiting.
+     * @param[in] wait If true, wait for the newest pending slot first. This returns the last written result.
+     * @return Slot index, or kInvalidSlot if no result is available.
+     */
+    uint32_t acquireLatest(FenceType& fence, bool wait = false)
+    {
+        if (wait)
+        {
+            uint32_t newestPending = findNewest(SlotState::Pending);
+            if (newestPending != kInvalidSlot)
+                fence.wait(mSlots[newestPending].fenceValue);
+        }
+        update(fence);
+
+        uint32_t newest = findNewest(SlotState::Ready);
+        if (newest == kInvalidSlot)
+            return kInvalidSlot;
+
+        for (Slot& slot : mSlots)
+        {
+            if (slot.state == SlotState::Ready)
+            {
+                if (slot.sequence < mSlots[newest].sequence)
+                    mDroppedCount++;
+                slot.state = SlotState::Free;
+            }
+        }
+        mReadCount++;
+        return newest;
+    }
+
+    /// Free all slots. Pending results are discarded.
+    void reset()
+    {
+        for (Slot& slot : mSlots)
+            slot.state = SlotState::Free;
+        mWriteSlot = kInvalidSlot;
+    }
+
+    uint32_t getSlotCount() const { return (uint32_t)mSlots.size(); }
+    SlotState getSlotState(uint32_t slot) const { return mSlots[slot].state; }
+    uint64_t getSlotTag(uint32_t slot) const { return mSlots[slot].tag; }
+    uint64_t getSlotFenceValue(uint32_t slot) const { return mSlots[slot].fenceValue; }
+    ReadbackOverflowPolicy getPolicy() const { return mPolicy; }
+
+    /// Number of results that were written but never read.
+    uint64_t getDroppedCount() const { return mDroppedCount; }
+    /// Number of writes skipped because of ReadbackOverflowPolicy::SkipNew.
+    uint64_t getSkippedCount() const { return mSkippedCount; }
+    /// Number of results read.
+    uint64_t getReadCount() const { return mReadCount; }
+
+private:
+    struct Slot
+    {
+        SlotState state = SlotState::Free;
+        uint64_t fenceValue = 0;
+        uint64_t sequence = 0; ///< Write order, used to find the oldest/newest slot.
+        uint64_t tag = 0;
+    };
+
+    uint32_t beginWrite(uint32_t slot)
+    {
+        FALCOR_CHECK(mWriteSlot == kInvalidSlot, "Readback slot acquired twice without commit.");
+        mSlots[slot].state = SlotState::Free;
+        mWriteSlot = slot;
+        return slot;
+    }
+
+    uint32_t findNewest(SlotState state) const
+    {
+        uint32_t newest = kInvalidSlot;
+        for (uint32_t i = 0; i < (uint32_t)mSlots.size(); ++i)
+        {
+            if (mSlots[i].state == state && (newest == kInvalidSlot || mSlots[i].sequence > mSlots[newest].sequence))
+                newest = i;
+        }
+        return newest;
+    }
+
+    std::vector<Slot> mSlots;
+    ReadbackOverflowPolicy mPolicy;
+    uint32_t mWriteSlot = kInvalidSlot; ///< Slot acquired for writing, not yet committed.
+    uint64_t mNextSequence = 0;
+    uint64_t mDroppedCount = 0;
+    uint64_t mSkippedCount = 0;
+    uint64_t mReadCount = 0;
+};
+
+/**
+ * N-deep ring of readback buffers for non-blocking GPU to CPU transfers.
+ *
+ * Typical usage per frame:
+ *
+ * if (pRing->beginWrite())
+ * {
+ *     <copy results to pRing->getBuffer() at pRing->getWriteOffset()>
+ *     pRing->endWrite(pRenderContext);
+ * }
+ * if (pRing->readLatest(&result))
+ *     <use result, which is typically a few frames old>
+ *
+ * endWrite() submits the command list and signals an internal fence, it does not flush the GPU.
+ * With N slots, results are available without stalls as long as the GPU is less than N frames behind.
+ */
+class FALCOR_API ReadbackRing : public Object
+{
+    FALCOR_OBJECT(ReadbackRing)
+public:
+    /**
+     * Create a readback ring.
+     * @param[in] pDevice GPU device.
+     * @param[in] slotSize Size of a slot in bytes.
+     * @param[in] slotCount Number of slots.
+     * @param[in] policy Policy when all slots are in flight.
+     * @return A new object, or throws an exception if creation failed.
+     */
+    static ref<ReadbackRing> create(
+        ref<Device> pDevice,
+        size_t slotSize,
+        uint32_t slotCount = 3,
+        ReadbackOverflowPolicy policy = ReadbackOverflowPolicy::DropOldest
+    );
+
+    /**
+     * Begin writing a new result.
+     * @return True if a slot was acquired, false if the readback should be skipped.
+     */
+    bool beginWrite();
+
+    /**
+     * Finish writing a result. Submits the command list and signals the fence.
+     * @param[in] pRenderContext Render context used for the copies.
+     * @param[in] tag User data returned by readLatest().
+     */
+    void endWrite(RenderContext* pRenderContext, uint64_t tag = 0);
+
+    /// Get the readback buffer holding all slots.
+    const ref<Buffer>& getBuffer() const { return mpBuffer; }
+
+    /// Get the byte offset into the readback buffer of the slot acquired by beginWrite().
+    uint64_t getWriteOffset() const;
+
+    /**
+     * Read the newest completed result.
+     * @param[out] pData Destination for slotSize bytes.
+     * @param[in] wait If true, block until the last written result is available.
+     * @param[out] pTag (Optional) Tag passed to endWrite().
+     * @return True if a new result was read, false otherwise.
+     */
+    bool readLatest(void* pData, bool wait = false, uint64_t* pTag = nullptr);
+
+    /// Discard all results in flight.
+    void reset() { mSlots.reset(); }
+
+    size_t getSlotSize() const { return mSlotSize; }
+    const ReadbackSlots<Fence>& getSlots() const { return mSlots; }
+
+private:
+    ReadbackRing(ref<Device> pDevice, size_t slotSize, uint32_t slotCount, ReadbackOverflowPolicy policy);
+
+    ref<Device> mpDevice;
+    ref<Buffer> mpBuffer;
+    ref<Fence> mpFence;
+    size_t mSlotSize;
+    ReadbackSlots<Fence> mSlots;
+    uint32_t mWriteSlot = ReadbackSlots<Fence>::kInvalidSlot;
+};
+} // namespace Falcor
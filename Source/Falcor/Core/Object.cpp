@@ -38,9 +38,112 @@ static std::mutex sTrackedObjectsMutex;
 static std::set<const Object*> sTrackedObjects;
 #endif
 
+#if FALCOR_ENABLE_REF_COUNT_STATS
+namespace
+{
+/// Reference count statistics of a single thread.
+/// The counters are only written by the owning thread, so updating them does not need a contended read-modify-write.
+/// They are atomic so that getRefCountStats() can read them from other threads.
+/// The struct is trivially destructible, so it stays valid while other thread local and static objects release
+/// references on exit.
+struct ThreadRefCountStats
+{
+    enum class State
+    {
+        Unregistered, ///< Not yet registered with the registry.
+        Registered,   ///< Registered, counters are summed by getRefCountStats().
+        Exited,       ///< The thread is exiting, operations are added to the registry directly.
+    };
+
+    std::atomic<uint64_t> incRefCount{0};
+    std::atomic<uint64_t> decRefCount{0};
+    State state{State::Unregistered};
+};
+
+/// Registry of the statistics of all registered threads and the accumulated statistics of exited threads.
+struct RefCountStatsRegistry
+{
+    std::mutex mutex;
+    std::set<const ThreadRefCountStats*> threads;
+    Object::RefCountStats exitedThreads;
+};
+
+RefCountStatsRegistry& getRefCountStatsRegistry()
+{
+    // Intentionally leaked, references may be released during static destruction.
+    static RefCountStatsRegistry* pRegistry = new RefCountStatsRegistry();
+    return *pRegistry;
+}
+
+thread_local ThreadRefCountStats tRefCountStats;
+
+/// Moves the statistics of the thread to the registry when the thread exits.
+struct ThreadRefCountStatsGuard
+{
+    void touch() {}
+
+    ~ThreadRefCountStatsGuard()
+    {
+        auto& registry = getRefCountStatsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.exitedThreads.incRefCount += tRefCountStats.incRefCount.load(std::memory_order_relaxed);
+        registry.exitedThreads.decRefCount += tRefCountStats.decRefCount.load(std::memory_order_relaxed);
+        registry.threads.erase(&tRefCountStats);
+        tRefCountStats.state = ThreadRefCountStats::State::Exited;
+    }
+};
+
+thread_local ThreadRefCountStatsGuard tRefCountStatsGuard;
+
+void countRefOp(bool inc)
+{
+    if (tRefCountStats.state != ThreadRefCountStats::State::Registered)
+    {
+        auto& registry = getRefCountStatsRegistry();
+        if (tRefCountStats.state == ThreadRefCountStats::State::Exited)
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            (inc ? registry.exitedThreads.incRefCount : registry.exitedThreads.decRefCount)++;
+            return;
+        }
+        // Touching the guard registers its destructor for this thread.
+        tRefCountStatsGuard.touch();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.insert(&tRefCountStats);
+        tRefCountStats.state = ThreadRefCountStats::State::Registered;
+    }
+
+    auto& counter = inc ? tRefCountStats.incRefCount : tRefCountStats.decRefCount;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+} // namespace
+
+Object::RefCountStats Object::getRefCountStats()
+{
+    auto& registry = getRefCountStatsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    RefCountStats stats = registry.exitedThreads;
+    for (const ThreadRefCountStats* pThread : registry.threads)
+    {
+        stats.incRefCount += pThread->incRefCount.load(std::memory_order_relaxed);
+        stats.decRefCount += pThread->decRefCount.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+Object::RefCountStats Object::getThreadRefCountStats()
+{
+    return {tRefCountStats.incRefCount.load(std::memory_order_relaxed), tRefCountStats.decRefCount.load(std::memory_order_relaxed)};
+}
+#endif
+
 void Object::incRef() const
 {
-    uint32_t refCount = mRefCount.fetch_add(1);
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    countRefOp(true);
+#endif
+    // Taking a new reference requires no ordering, the caller already holds one.
+    uint32_t refCount = mRefCount.fetch_add(1, std::memory_order_relaxed);
 #if FALCOR_ENABLE_OBJECT_TRACKING
     if (refCount == 0)
     {
@@ -52,7 +155,11 @@ void Object::incRef() const
 
 void Object::decRef(bool dealloc) const noexcept
 {
-    uint32_t refCount = mRefCount.fetch_sub(1);
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    countRefOp(false);
+#endif
+    // Releasing a reference must be ordered with the deallocation by the last owner.
+    uint32_t refCount = mRefCount.fetch_sub(1, std::memory_order_acq_rel);
     if (refCount <= 0)
     {
         reportFatalErrorAndTerminate("Internal error: Object reference count < 0!");
@@ -51,6 +51,21 @@
  */
 #define FALCOR_ENABLE_REF_TRACKING 0
 
+/**
+ * Enable/disable reference count statistics.
+ * When enabled, the number of reference count increments and decrements
+ * is counted per thread (see Object::getRefCountStats()). This helps finding
+ * hot paths that copy references where borrowing or moving them would be
+ * sufficient. Enabled in debug builds by default.
+ */
+#ifndef FALCOR_ENABLE_REF_COUNT_STATS
+#ifdef _DEBUG
+#define FALCOR_ENABLE_REF_COUNT_STATS 1
+#else
+#define FALCOR_ENABLE_REF_COUNT_STATS 0
+#endif
+#endif
+
 #if FALCOR_ENABLE_REF_TRACKING
 #if !FALCOR_ENABLE_OBJECT_TRACKING
 #error "FALCOR_ENABLE_REF_TRACKING requires FALCOR_ENABLE_OBJECT_TRACKING"
@@ -125,6 +140,30 @@ public:
     /// Decrease the reference count of the object and possibly deallocate it.
     void decRef(bool dealloc = true) const noexcept;
 
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    /// Reference count statistics.
+    struct RefCountStats
+    {
+        uint64_t incRefCount = 0; ///< Number of reference count increments.
+        uint64_t decRefCount = 0; ///< Number of reference count decrements.
+
+        uint64_t getTotal() const { return incRefCount + decRefCount; }
+
+        RefCountStats operator-(const RefCountStats& other) const
+        {
+            return {incRefCount - other.incRefCount, decRefCount - other.decRefCount};
+        }
+    };
+
+    /// Return the number of reference count operations on all objects since startup, summed over all threads.
+    /// Take the difference of two snapshots to measure a section of code.
+    static RefCountStats getRefCountStats();
+
+    /// Return the number of reference count operations on all objects done by the calling thread.
+    /// Unlike getRefCountStats(), the result is not affected by other threads.
+    static RefCountStats getThreadRefCountStats();
+#endif
+
 #if FALCOR_ENABLE_OBJECT_TRACKING
     /// Dump all objects that are currently alive.
     static void dumpAliveObjects();
@@ -487,7 +526,7 @@ class BreakableReference
 {
 public:
     BreakableReference(const ref<T>& r) : mStrongRef(r), mWeakRef(mStrongRef.get()) {}
-    BreakableReference(ref<T>&& r) : mStrongRef(r), mWeakRef(mStrongRef.get()) {}
+    BreakableReference(ref<T>&& r) : mStrongRef(std::move(r)), mWeakRef(mStrongRef.get()) {}
 
     BreakableReference() = delete;
     BreakableReference& operator=(const ref<T>&) = delete;
@@ -797,4 +797,15 @@ protected:
     StateGraph mRtsoGraph;
 };
 
+/**
+ * Program permutation, used to compile program versions ahead of their first use.
+ * See ProgramManager::precompilePrograms().
+ */
+struct ProgramPermutation
+{
+    ref<Program> pProgram;                ///< Program.
+    DefineList defines;                   ///< Complete list of program defines the version will be used with.
+    TypeConformanceList typeConformances; ///< Complete list of program type conformances the version will be used with.
+};
+
 } // namespace Falcor
@@ -26,13 +26,20 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "ProgramManager.h"
+#include "ProgramVars.h"
+#include "Core/API/ComputeStateObject.h"
 #include "Core/API/Device.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 #include "Utils/Timing/CpuTimer.h"
 
+#include <BS_thread_pool.hpp>
 #include <slang.h>
 
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace Falcor
 {
 
@@ -121,7 +128,31 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     CpuTimer timer;
     timer.update();
 
-    auto pSlangRequest = createSlangCompileRequest(program);
+    program.mFileTimeMap.clear(); // TODO @skallweit
+    auto pVersion =
+        createProgramVersion(program, program.getDefineList(), mpDevice->getSlangGlobalSession(), program.mFileTimeMap, log);
+    if (pVersion == nullptr)
+        return nullptr;
+
+    timer.update();
+    double time = timer.delta();
+    mCompilationStats.programVersionCount++;
+    mCompilationStats.programVersionTotalTime += time;
+    mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    logDebug("Created program version in {:.3f} s: {}", time, pVersion->getName());
+
+    return pVersion;
+}
+
+ref<const ProgramVersion> ProgramManager::createProgramVersion(
+    const Program& program,
+    const DefineList& defineList,
+    slang::IGlobalSession* pSlangGlobalSession,
+    Program::string_time_map& fileTimeMap,
+    std::string& log
+) const
+{
+    auto pSlangRequest = createSlangCompileRequest(program, defineList, pSlangGlobalSession);
     if (pSlangRequest == nullptr)
         return nullptr;
 
@@ -169,7 +200,7 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     {
         std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
         if (std::filesystem::exists(depFilePath))
-            program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+            fileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
     }
 
     // Note: the `ProgramReflection` needs to be able to refer back to the
@@ -205,16 +236,198 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     }
 
     auto descStr = program.getProgramDescString();
-    pVersion->init(program.getDefineList(), pReflector, descStr, pSlangEntryPoints);
+    pVersion->init(defineList, pReflector, descStr, pSlangEntryPoints);
+
+    return pVersion;
+}
 
+std::vector<ProgramManager::PrecompileResult> ProgramManager::precompilePrograms(
+    const std::vector<ProgramPermutation>& permutations,
+    uint32_t threadCount
+)
+{
+    CpuTimer timer;
     timer.update();
-    double time = timer.delta();
-    mCompilationStats.programVersionCount++;
-    mCompilationStats.programVersionTotalTime += time;
-    mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
-    logDebug("Created program version in {:.3f} s: {}", timer.delta(), descStr);
 
-    return pVersion;
+    std::vector<PrecompileResult> results(permutations.size());
+
+    // Find the permutations that need to be compiled. Permutations that already have a program version or
+    // that occur multiple times in the list are compiled at most once.
+    struct Job
+    {
+        const Program* pProgram;
+        Program::ProgramVersionKey key;
+        Program::string_time_map fileTimeMap;
+        ref<const ProgramVersion> pVersion;
+        std::string log;
+        double time = 0.0;
+    };
+    std::vector<Job> jobs;
+    std::vector<size_t> jobIndices(permutations.size(), size_t(-1));
+    std::map<std::pair<const Program*, Program::ProgramVersionKey>, size_t> jobMap;
+
+    for (size_t i = 0; i < permutations.size(); ++i)
+    {
+        const auto& permutation = permutations[i];
+        FALCOR_CHECK(permutation.pProgram, "Program permutation {} has no program.", i);
+        const Program* pProgram = permutation.pProgram.get();
+        Program::ProgramVersionKey key{permutation.defines, permutation.typeConformances};
+
+        auto& result = results[i];
+        result.name = pProgram->getProgramDescString();
+        result.defines = permutation.defines;
+
+        if (pProgram->mProgramVersions.find(key) != pProgram->mProgramVersions.end())
+        {
+            result.success = true;
+            result.alreadyCompiled = true;
+            continue;
+        }
+
+        auto [it, inserted] = jobMap.emplace(std::make_pair(pProgram, key), jobs.size());
+        if (inserted)
+            jobs.push_back({pProgram, key});
+        jobIndices[i] = it->second;
+    }
+
+    if (!jobs.empty())
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::min(threadCount, (uint32_t)jobs.size());
+
+        // Slang global sessions can't be used from multiple threads concurrently.
+        // Each job borrows a session from a pool, new sessions are created on the worker threads as needed.
+        std::string prelude = getHlslLanguagePrelude();
+        std::vector<slang::IGlobalSession*> freeSessions;
+        for (const auto& pSession : mPrecompileSlangGlobalSessions)
+        {
+            pSession->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
+            freeSessions.push_back(pSession);
+        }
+
+        auto acquireSession = [&]() -> Slang::ComPtr<slang::IGlobalSession>
+        {
+            {
+                std::lock_guard<std::mutex> lock(mPrecompileSessionMutex);
+                if (!freeSessions.empty())
+                {
+                    Slang::ComPtr<slang::IGlobalSession> pSession(freeSessions.back());
+                    freeSessions.pop_back();
+                    return pSession;
+                }
+            }
+            Slang::ComPtr<slang::IGlobalSession> pSession;
+            if (SLANG_FAILED(slang::createGlobalSession(pSession.writeRef())))
+                FALCOR_THROW("Failed to create Slang global session.");
+            pSession->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
+            std::lock_guard<std::mutex> lock(mPrecompileSessionMutex);
+            mPrecompileSlangGlobalSessions.push_back(pSession);
+            return pSession;
+        };
+        auto releaseSession = [&](slang::IGlobalSession* pSession)
+        {
+            std::lock_guard<std::mutex> lock(mPrecompileSessionMutex);
+            freeSessions.push_back(pSession);
+        };
+
+        BS::thread_pool threadPool(threadCount);
+        for (auto& job : jobs)
+        {
+            threadPool.push_task(
+                [&]()
+                {
+                    CpuTimer jobTimer;
+                    jobTimer.update();
+                    Slang::ComPtr<slang::IGlobalSession> pSession;
+                    try
+                    {
+                        pSession = acquireSession();
+                        job.pVersion = createProgramVersion(*job.pProgram, job.key.defineList, pSession, job.fileTimeMap, job.log);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        job.pVersion = nullptr;
+                        job.log += e.what();
+                    }
+                    if (pSession)
+                        releaseSession(pSession);
+                    jobTimer.update();
+                    job.time = jobTimer.delta();
+                }
+            );
+        }
+        threadPool.wait_for_tasks();
+
+        // Register the compiled versions with their programs. Program::getActiveVersion() picks them up
+        // when the program switches to the permutation's defines and type conformances.
+        for (auto& job : jobs)
+        {
+            if (!job.pVersion)
+                continue;
+            job.pProgram->mProgramVersions.emplace(job.key, job.pVersion);
+            job.pProgram->mFileTimeMap.insert(job.fileTimeMap.begin(), job.fileTimeMap.end());
+
+            mCompilationStats.programVersionCount++;
+            mCompilationStats.programVersionTotalTime += job.time;
+            mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, job.time);
+            logDebug("Precompiled program version in {:.3f} s: {}", job.time, job.pVersion->getName());
+        }
+
+        // Create the kernels of the new versions, they are cached in the versions. For compute programs also create a
+        // pipeline state, which runs the downstream compiler. The pipeline state is not kept, but its code is stored in
+        // the gfx shader cache, so creating the pipeline state on first dispatch does not compile again.
+        // This uses the device and runs on the calling thread.
+        for (auto& job : jobs)
+        {
+            if (!job.pVersion)
+                continue;
+            CpuTimer kernelTimer;
+            kernelTimer.update();
+            try
+            {
+                auto pVars = ProgramVars::create(ref<Device>(mpDevice), job.pVersion->getReflector());
+                auto pKernels = job.pVersion->getKernels(mpDevice, pVars.get());
+                if (job.pProgram->mDesc.hasEntryPoint(ShaderType::Compute))
+                    mpDevice->createComputeStateObject(ComputeStateObjectDesc{pKernels});
+            }
+            catch (const std::exception& e)
+            {
+                job.log += e.what();
+                logWarning("Failed to precompile kernels of program version {}: {}", job.pVersion->getName(), e.what());
+            }
+            kernelTimer.update();
+            job.time += kernelTimer.delta();
+        }
+    }
+
+    size_t failedCount = 0;
+    for (size_t i = 0; i < permutations.size(); ++i)
+    {
+        if (jobIndices[i] == size_t(-1))
+            continue;
+        const auto& job = jobs[jobIndices[i]];
+        auto& result = results[i];
+        result.success = job.pVersion != nullptr;
+        result.time = job.time;
+        result.log = job.log;
+        if (!result.success)
+        {
+            logWarning("Failed to precompile program:\n{}\n\n{}", result.name, result.log);
+            failedCount++;
+        }
+    }
+
+    timer.update();
+    logInfo(
+        "Precompiled {} program versions for {} permutations in {:.3f} s ({} failed).",
+        jobs.size(),
+        permutations.size(),
+        timer.delta(),
+        failedCount
+    );
+
+    return results;
 }
 
 ref<const ProgramKernels> ProgramManager::createProgramKernels(
@@ -619,9 +832,12 @@ ProgramManager::ForcedCompilerFlags ProgramManager::getForcedCompilerFlags()
     return mForcedCompilerFlags;
 }
 
-SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
+SlangCompileRequest* ProgramManager::createSlangCompileRequest(
+    const Program& program,
+    const DefineList& defineList,
+    slang::IGlobalSession* pSlangGlobalSession
+) const
 {
-    slang::IGlobalSession* pSlangGlobalSession = mpDevice->getSlangGlobalSession();
     FALCOR_ASSERT(pSlangGlobalSession);
 
     slang::SessionDesc sessionDesc;
@@ -707,7 +923,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     // Add global followed by program specific defines.
     for (const auto& shaderDefine : mGlobalDefineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
-    for (const auto& shaderDefine : program.getDefineList())
+    for (const auto& shaderDefine : defineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
 
     // Add a `#define`s based on the target and shader model.
@@ -736,8 +952,6 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     pSlangGlobalSession->createSession(sessionDesc, pSlangSession.writeRef());
     FALCOR_ASSERT(pSlangSession);
 
-    program.mFileTimeMap.clear(); // TODO @skallweit
-
     SlangCompileRequest* pSlangRequest = nullptr;
     pSlangSession->createCompileRequest(&pSlangRequest);
     FALCOR_ASSERT(pSlangRequest);
@@ -31,6 +31,9 @@
 #include "Core/API/fwd.h"
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -64,8 +67,35 @@ public:
     void registerProgramForReload(Program* program);
     void unregisterProgramForReload(Program* program);
 
+    /// Statistics of a precompiled program permutation.
+    struct PrecompileResult
+    {
+        std::string name;             ///< Program description.
+        DefineList defines;           ///< Program defines of the permutation.
+        bool success = false;         ///< True if the program version is available.
+        bool alreadyCompiled = false; ///< True if the program version existed before the call.
+        double time = 0.0;            ///< Compilation time in seconds, including kernel creation.
+        std::string log;              ///< Compiler diagnostics.
+    };
+
     ref<const ProgramVersion> createProgramVersion(const Program& program, std::string& log) const;
 
+    /**
+     * Compile program versions for a list of program permutations concurrently.
+     * The compiled versions are registered with their programs, so that switching a program to the defines and type
+     * conformances of a permutation later does not trigger a compilation. Failures are reported in the results and
+     * logged as warnings, the program then compiles (and reports errors) as usual on first use.
+     * The Slang front-end runs on the compiler threads. The kernels of the new versions are then created on the
+     * calling thread. For compute programs a pipeline state is created as well, which stores the downstream compiler
+     * output in the gfx shader cache (see Device::Desc::shaderCachePath). Pipeline states are not kept, so the first
+     * dispatch still creates one, but without recompiling. Graphics and ray tracing pipeline states depend on the
+     * render targets and pipeline settings of the pass and are still compiled on first use.
+     * @param[in] permutations List of program permutations. Duplicates and existing versions are skipped.
+     * @param[in] threadCount Number of compiler threads (0 = number of hardware threads).
+     * @return Results in the order of the permutations.
+     */
+    std::vector<PrecompileResult> precompilePrograms(const std::vector<ProgramPermutation>& permutations, uint32_t threadCount = 0);
+
     ref<const ProgramKernels> createProgramKernels(
         const Program& program,
         const ProgramVersion& programVersion,
@@ -145,7 +175,19 @@ public:
     void resetCompilationStats() { mCompilationStats = {}; }
 
 private:
-    SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
+    ref<const ProgramVersion> createProgramVersion(
+        const Program& program,
+        const DefineList& defineList,
+        slang::IGlobalSession* pSlangGlobalSession,
+        Program::string_time_map& fileTimeMap,
+        std::string& log
+    ) const;
+
+    SlangCompileRequest* createSlangCompileRequest(
+        const Program& program,
+        const DefineList& defineList,
+        slang::IGlobalSession* pSlangGlobalSession
+    ) const;
 
     Device* mpDevice;
 
@@ -157,6 +199,11 @@ private:
     bool mGenerateDebugInfo = false;
     ForcedCompilerFlags mForcedCompilerFlags;
 
+    /// Slang global sessions used by precompilePrograms(). A global session is only used by one thread at a time.
+    std::vector<Slang::ComPtr<slang::IGlobalSession>> mPrecompileSlangGlobalSessions;
+    /// Protects mPrecompileSlangGlobalSessions, which is the only state the precompile worker threads modify.
+    std::mutex mPrecompileSessionMutex;
+
     mutable uint32_t mHitGroupID = 0;
 };
 
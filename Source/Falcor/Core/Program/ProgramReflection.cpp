@@ -56,7 +56,7 @@ TypedShaderVarOffset TypedShaderVarOffset::operator[](std::string_view name) con
 
     if (auto pStructType = pType->asStructType())
     {
-        if (auto pMember = pStructType->findMember(name))
+        if (const auto& pMember = pStructType->findMember(name))
         {
             return TypedShaderVarOffset(pMember->getType(), (*this) + pMember->getBindLocation());
         }
@@ -2060,7 +2060,7 @@ TypedShaderVarOffset ReflectionType::findMemberByOffset(size_t offset) const
 
 TypedShaderVarOffset ReflectionStructType::findMemberByOffset(size_t offset) const
 {
-    for (auto pMember : mMembers)
+    for (const auto& pMember : mMembers)
     {
         auto memberOffset = pMember->getBindLocation();
         auto memberUniformOffset = memberOffset.getUniform().getByteOffset();
@@ -2079,18 +2079,13 @@ TypedShaderVarOffset ReflectionStructType::findMemberByOffset(size_t offset) con
     return TypedShaderVarOffset::kInvalid;
 }
 
-ref<const ReflectionVar> ReflectionType::findMember(std::string_view name) const
+const ref<const ReflectionVar>& ReflectionType::findMember(std::string_view name) const
 {
+    static const ref<const ReflectionVar> pNull;
     if (auto pStructType = asStructType())
-    {
-        size_t fieldIndex = pStructType->getMemberIndex(name);
-        if (fieldIndex == ReflectionStructType::kInvalidMemberIndex)
-            return nullptr;
+        return pStructType->getMember(name);
 
-        return pStructType->getMember(fieldIndex);
-    }
-
-    return nullptr;
+    return pNull;
 }
 
 int32_t ReflectionStructType::getMemberIndex(std::string_view name) const
@@ -2413,7 +2408,7 @@ ref<ReflectionType> ProgramReflection::findType(std::string_view name) const
     return pFalcorTypeLayout;
 }
 
-ref<const ReflectionVar> ProgramReflection::findMember(std::string_view name) const
+const ref<const ReflectionVar>& ProgramReflection::findMember(std::string_view name) const
 {
     return mpDefaultBlock->findMember(name);
 }
@@ -677,7 +677,7 @@ public:
      *
      * If this type doesn't have fields/members, or doesn't have a field/member matching `name`, then returns null.
      */
-    ref<const ReflectionVar> findMember(std::string_view name) const;
+    const ref<const ReflectionVar>& findMember(std::string_view name) const;
 
     /**
      * Get the (type and) offset of a field/member with the given `name`.
@@ -1407,7 +1407,7 @@ public:
     /**
      * Get the type of the contents of the parameter block.
      */
-    ref<const ReflectionType> getElementType() const { return mpElementType; }
+    const ref<const ReflectionType>& getElementType() const { return mpElementType; }
 
     using BindLocation = TypedShaderVarOffset;
 
@@ -1554,7 +1554,7 @@ public:
 
     ProgramVersion const* getProgramVersion() const { return mpProgramVersion; }
 
-    ref<const ReflectionVar> findMember(std::string_view name) const { return getElementType()->findMember(name); }
+    const ref<const ReflectionVar>& findMember(std::string_view name) const { return getElementType()->findMember(name); }
 
 protected:
     ParameterBlockReflection(ProgramVersion const* pProgramVersion);
@@ -1714,7 +1714,7 @@ public:
      */
     ref<ReflectionType> findType(std::string_view name) const;
 
-    ref<const ReflectionVar> findMember(std::string_view name) const;
+    const ref<const ReflectionVar>& findMember(std::string_view name) const;
 
     const std::vector<ref<EntryPointGroupReflection>>& getEntryPointGroups() const { return mEntryPointGroups; }
 
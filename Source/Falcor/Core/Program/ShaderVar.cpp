@@ -90,7 +90,7 @@ ShaderVar ShaderVar::operator[](size_t index) const
     {
         if (index < pStructType->getMemberCount())
         {
-            auto pMember = pStructType->getMember(index);
+            const auto& pMember = pStructType->getMember(index);
             // Need to apply the offsets from member
             TypedShaderVarOffset newOffset = TypedShaderVarOffset(pMember->getType(), mOffset + pMember->getBindLocation());
             return ShaderVar(mpBlock, newOffset);
@@ -125,7 +125,7 @@ ShaderVar ShaderVar::findMember(std::string_view name) const
 
     if (auto pStructType = pType->asStructType())
     {
-        if (auto pMember = pStructType->findMember(name))
+        if (const auto& pMember = pStructType->findMember(name))
         {
             // Need to apply the offsets from member
             TypedShaderVarOffset newOffset = TypedShaderVarOffset(pMember->getType(), mOffset + pMember->getBindLocation());
@@ -163,7 +163,7 @@ ShaderVar ShaderVar::findMember(uint32_t index) const
     {
         if (index < pStructType->getMemberCount())
         {
-            auto pMember = pStructType->getMember(index);
+            const auto& pMember = pStructType->getMember(index);
 
             // Need to apply the offsets from member
             TypedShaderVarOffset newOffset = TypedShaderVarOffset(pMember->getType(), mOffset + pMember->getBindLocation());
@@ -202,9 +202,9 @@ void ShaderVar::setBlob(void const* data, size_t size) const
 // Resource binding
 //
 
-void ShaderVar::setBuffer(const ref<Buffer>& pBuffer) const
+void ShaderVar::setBuffer(ref<Buffer> pBuffer) const
 {
-    mpBlock->setBuffer(mOffset, pBuffer);
+    mpBlock->setBuffer(mOffset, std::move(pBuffer));
 }
 
 ref<Buffer> ShaderVar::getBuffer() const
@@ -212,9 +212,9 @@ ref<Buffer> ShaderVar::getBuffer() const
     return mpBlock->getBuffer(mOffset);
 }
 
-void ShaderVar::setTexture(const ref<Texture>& pTexture) const
+void ShaderVar::setTexture(ref<Texture> pTexture) const
 {
-    mpBlock->setTexture(mOffset, pTexture);
+    mpBlock->setTexture(mOffset, std::move(pTexture));
 }
 
 ref<Texture> ShaderVar::getTexture() const
@@ -222,9 +222,9 @@ ref<Texture> ShaderVar::getTexture() const
     return mpBlock->getTexture(mOffset);
 }
 
-void ShaderVar::setSrv(const ref<ShaderResourceView>& pSrv) const
+void ShaderVar::setSrv(ref<ShaderResourceView> pSrv) const
 {
-    mpBlock->setSrv(mOffset, pSrv);
+    mpBlock->setSrv(mOffset, std::move(pSrv));
 }
 
 ref<ShaderResourceView> ShaderVar::getSrv() const
@@ -232,9 +232,9 @@ ref<ShaderResourceView> ShaderVar::getSrv() const
     return mpBlock->getSrv(mOffset);
 }
 
-void ShaderVar::setUav(const ref<UnorderedAccessView>& pUav) const
+void ShaderVar::setUav(ref<UnorderedAccessView> pUav) const
 {
-    mpBlock->setUav(mOffset, pUav);
+    mpBlock->setUav(mOffset, std::move(pUav));
 }
 
 ref<UnorderedAccessView> ShaderVar::getUav() const
@@ -242,9 +242,9 @@ ref<UnorderedAccessView> ShaderVar::getUav() const
     return mpBlock->getUav(mOffset);
 }
 
-void ShaderVar::setAccelerationStructure(const ref<RtAccelerationStructure>& pAccl) const
+void ShaderVar::setAccelerationStructure(ref<RtAccelerationStructure> pAccl) const
 {
-    mpBlock->setAccelerationStructure(mOffset, pAccl);
+    mpBlock->setAccelerationStructure(mOffset, std::move(pAccl));
 }
 
 ref<RtAccelerationStructure> ShaderVar::getAccelerationStructure() const
@@ -252,9 +252,9 @@ ref<RtAccelerationStructure> ShaderVar::getAccelerationStructure() const
     return mpBlock->getAccelerationStructure(mOffset);
 }
 
-void ShaderVar::setSampler(const ref<Sampler>& pSampler) const
+void ShaderVar::setSampler(ref<Sampler> pSampler) const
 {
-    mpBlock->setSampler(mOffset, pSampler);
+    mpBlock->setSampler(mOffset, std::move(pSampler));
 }
 
 ref<Sampler> ShaderVar::getSampler() const
@@ -262,9 +262,9 @@ ref<Sampler> ShaderVar::getSampler() const
     return mpBlock->getSampler(mOffset);
 }
 
-void ShaderVar::setParameterBlock(const ref<ParameterBlock>& pBlock) const
+void ShaderVar::setParameterBlock(ref<ParameterBlock> pBlock) const
 {
-    mpBlock->setParameterBlock(mOffset, pBlock);
+    mpBlock->setParameterBlock(mOffset, std::move(pBlock));
 }
 
 ref<ParameterBlock> ShaderVar::getParameterBlock() const
@@ -376,24 +376,24 @@ void const* ShaderVar::getRawData() const
     return (uint8_t*)(mpBlock->getRawData()) + mOffset.getUniform().getByteOffset();
 }
 
-void ShaderVar::setImpl(const ref<Texture>& pTexture) const
+void ShaderVar::setImpl(ref<Texture> pTexture) const
 {
-    mpBlock->setTexture(mOffset, pTexture);
+    mpBlock->setTexture(mOffset, std::move(pTexture));
 }
 
-void ShaderVar::setImpl(const ref<Sampler>& pSampler) const
+void ShaderVar::setImpl(ref<Sampler> pSampler) const
 {
-    mpBlock->setSampler(mOffset, pSampler);
+    mpBlock->setSampler(mOffset, std::move(pSampler));
 }
 
-void ShaderVar::setImpl(const ref<Buffer>& pBuffer) const
+void ShaderVar::setImpl(ref<Buffer> pBuffer) const
 {
-    mpBlock->setBuffer(mOffset, pBuffer);
+    mpBlock->setBuffer(mOffset, std::move(pBuffer));
 }
 
-void ShaderVar::setImpl(const ref<ParameterBlock>& pBlock) const
+void ShaderVar::setImpl(ref<ParameterBlock> pBlock) const
 {
-    mpBlock->setParameterBlock(mOffset, pBlock);
+    mpBlock->setParameterBlock(mOffset, std::move(pBlock));
 }
 
 FALCOR_SCRIPT_BINDING(ShaderVar)
@@ -36,6 +36,7 @@
 #include "Utils/Math/Vector.h"
 #include <memory>
 #include <string_view>
+#include <utility>
 #include <cstddef>
 
 namespace Falcor
@@ -214,6 +215,17 @@ struct FALCOR_API ShaderVar
         setImpl(val);
     }
 
+    /**
+     * Bind a temporary reference to the object pointed to by this shader variable.
+     * The reference is moved into the parameter block, which avoids a reference count
+     * round trip for statements like `var["gOutput"] = renderData.getTexture(kOutput);`.
+     */
+    template<typename T>
+    void operator=(ref<T>&& val) const
+    {
+        setImpl(std::move(val));
+    }
+
     //
     // Uniforms
     //
@@ -249,7 +261,7 @@ struct FALCOR_API ShaderVar
      * Throws an exception if this variable doesn't point at a buffer or the
      * buffer has incompatible bind flags.
      */
-    void setBuffer(const ref<Buffer>& pBuffer) const;
+    void setBuffer(ref<Buffer> pBuffer) const;
 
     /**
      * Get the buffer bound to this variable.
@@ -269,7 +281,7 @@ struct FALCOR_API ShaderVar
      * Throws an exception if this variable doesn't point at a texture or the
      * texture has incompatible bind flags.
      */
-    void setTexture(const ref<Texture>& pTexture) const;
+    void setTexture(ref<Texture> pTexture) const;
 
     /**
      * Get the texture bound to this variable.
@@ -288,7 +300,7 @@ struct FALCOR_API ShaderVar
      * Bind an SRV to this variable.
      * Throws an exception if this variable doesn't point at an SRV.
      */
-    void setSrv(const ref<ShaderResourceView>& pSrv) const;
+    void setSrv(ref<ShaderResourceView> pSrv) const;
 
     /**
      * Get the SRV bound to this variable.
@@ -300,7 +312,7 @@ struct FALCOR_API ShaderVar
      * Bind a UAV to this variable.
      * Throws an exception if this variable doesn't point at a UAV.
      */
-    void setUav(const ref<UnorderedAccessView>& pUav) const;
+    void setUav(ref<UnorderedAccessView> pUav) const;
 
     /**
      * Get the UAV bound to this variable.
@@ -312,7 +324,7 @@ struct FALCOR_API ShaderVar
      * Bind an acceleration structure to this variable.
      * Throws an exception if this variable doesn't point at an acceleration structure.
      */
-    void setAccelerationStructure(const ref<RtAccelerationStructure>& pAccl) const;
+    void setAccelerationStructure(ref<RtAccelerationStructure> pAccl) const;
 
     /**
      * Get the acceleration structure bound to this variable.
@@ -324,7 +336,7 @@ struct FALCOR_API ShaderVar
      * Bind a sampler to this variable.
      * Throws an exception if this variable doesn't point at a sampler.
      */
-    void setSampler(const ref<Sampler>& pSampler) const;
+    void setSampler(ref<Sampler> pSampler) const;
 
     /**
      * Get the sampler bound to this variable.
@@ -343,7 +355,7 @@ struct FALCOR_API ShaderVar
      * Bind a parameter block to this variable.
      * Throws an exception if this variable doesn't point at a parameter block.
      */
-    void setParameterBlock(const ref<ParameterBlock>& pBlock) const;
+    void setParameterBlock(ref<ParameterBlock> pBlock) const;
 
     /**
      * Get the parameter block bound to this variable.
@@ -458,10 +470,10 @@ private:
      */
     TypedShaderVarOffset mOffset;
 
-    void setImpl(const ref<Texture>& pTexture) const;
-    void setImpl(const ref<Sampler>& pSampler) const;
-    void setImpl(const ref<Buffer>& pBuffer) const;
-    void setImpl(const ref<ParameterBlock>& pBlock) const;
+    void setImpl(ref<Texture> pTexture) const;
+    void setImpl(ref<Sampler> pSampler) const;
+    void setImpl(ref<Buffer> pBuffer) const;
+    void setImpl(ref<ParameterBlock> pBlock) const;
 
     template<typename T>
     void setImpl(const T& val) const;
@@ -417,6 +417,17 @@ void SampleApp::renderGlobalUI(Gui* pGui)
         if (controlsGroup.button("Save Config"))
             saveConfigToFile();
 
+#if FALCOR_ENABLE_REF_COUNT_STATS
+        controlsGroup.separator();
+        controlsGroup.text(fmt::format(
+            "Ref count ops/frame: {} ({} inc, {} dec)",
+            mFrameRefCountStats.getTotal(),
+            mFrameRefCountStats.incRefCount,
+            mFrameRefCountStats.decRefCount
+        ));
+        controlsGroup.tooltip("Number of reference count increments/decrements on all objects during the last frame.");
+#endif
+
         controlsGroup.release();
     }
 }
@@ -475,6 +486,13 @@ void SampleApp::renderFrame()
     mClock.tick();
     mFrameRate.newFrame();
 
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    // Reference count operations of the previous frame (from frame start to frame start).
+    auto refCountStats = Object::getRefCountStats();
+    mFrameRefCountStats = refCountStats - mFrameStartRefCountStats;
+    mFrameStartRefCountStats = refCountStats;
+#endif
+
     RenderContext* pRenderContext = mpDevice->getRenderContext();
 
     // Render a frame.
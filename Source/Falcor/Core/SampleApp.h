@@ -332,6 +332,11 @@ private:
     FrameRate mFrameRate;
     Clock mClock;
 
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    Object::RefCountStats mFrameStartRefCountStats; ///< Reference count statistics at the start of the current frame.
+    Object::RefCountStats mFrameRefCountStats;      ///< Reference count operations during the last frame.
+#endif
+
     bool mShouldTerminate = false; ///< True if application should terminate.
     bool mRendererPaused = false;  ///< True if rendering is paused.
     bool mVsyncOn = false;
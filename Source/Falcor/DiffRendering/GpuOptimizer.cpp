@@ -0,0 +1,176 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GpuOptimizer.h"
+#include "SceneGradients.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Scripting/ScriptBindings.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFilename[] = "DiffRendering/Optimizer.cs.slang";
+
+DefineList getDefines(const OptimizerConfig& config)
+{
+    DefineList defines;
+    defines.add("OPTIMIZER_TYPE", std::to_string(uint32_t(config.type)));
+    return defines;
+}
+} // namespace
+
+GpuOptimizer::GpuOptimizer(ref<Device> pDevice, uint32_t paramCount, const OptimizerConfig& config, std::vector<OptimizerParamGroup> groups)
+    : mpDevice(pDevice), mParamCount(paramCount), mConfig(config), mGroups(Optimizer::validateGroups(paramCount, std::move(groups)))
+{
+    mpStepPass = ComputePass::create(mpDevice, kShaderFilename, "main", getDefines(mConfig));
+
+    // Moments are not needed for SGD without momentum, bind dummy buffers instead.
+    bool isAdam = mConfig.type == OptimizerType::Adam || mConfig.type == OptimizerType::AdamW;
+    uint32_t moment1Count = (isAdam || mConfig.momentum != 0.f) ? std::max(mParamCount, 1u) : 1;
+    uint32_t moment2Count = isAdam ? std::max(mParamCount, 1u) : 1;
+
+    auto bindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+    mpMoment1 = mpDevice->createBuffer(moment1Count * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr);
+    mpMoment2 = mpDevice->createBuffer(moment2Count * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr);
+}
+
+void GpuOptimizer::step(RenderContext* pRenderContext, const ref<Buffer>& pGrads, const ref<Buffer>& pParams)
+{
+    FALCOR_CHECK(pGrads && pGrads->getSize() >= mParamCount * sizeof(float), "Gradient buffer is too small.");
+
+    mpStepPass->getRootVar()["gOptimizer"]["grads"] = pGrads;
+    execute(pRenderContext, mpStepPass, pParams, 0);
+}
+
+void GpuOptimizer::step(RenderContext* pRenderContext, const SceneGradients& sceneGradients, GradientType gradType, const ref<Buffer>& pParams)
+{
+    FALCOR_CHECK(
+        sceneGradients.getGradDim(gradType) == mParamCount,
+        "Gradient dimension ({}) does not match parameter count ({}).",
+        sceneGradients.getGradDim(gradType),
+        mParamCount
+    );
+
+    // Use the dense gradients if available, otherwise the compacted coordinate list of sparse gradients.
+    if (const auto& pGrads = sceneGradients.getGradsBuffer(gradType))
+    {
+        step(pRenderContext, pGrads, pParams);
+        return;
+    }
+    FALCOR_ASSERT(sceneGradients.isSparse(gradType));
+
+    if (!mpSparseStepPass)
+        mpSparseStepPass = ComputePass::create(mpDevice, kShaderFilename, "mainSparse", getDefines(mConfig));
+
+    auto var = mpSparseStepPass->getRootVar()["gOptimizer"];
+    var["sparseIndices"] = sceneGradients.getSparseIndicesBuffer(gradType);
+    var["sparseValues"] = sceneGradients.getSparseValuesBuffer(gradType);
+    var["sparseCounters"] = sceneGradients.getSparseCountersBuffer(gradType);
+    execute(pRenderContext, mpSparseStepPass, pParams, sceneGradients.getSparseSlotCount(gradType) * kSparseGradBlockSize);
+}
+
+void GpuOptimizer::execute(RenderContext* pRenderContext, const ref<ComputePass>& pPass, const ref<Buffer>& pParams, uint32_t threadCount)
+{
+    FALCOR_CHECK(pParams && pParams->getSize() >= mParamCount * sizeof(float), "Parameter buffer is too small.");
+
+    if (mClearState)
+    {
+        pRenderContext->clearUAV(mpMoment1->getUAV().get(), uint4(0));
+        pRenderContext->clearUAV(mpMoment2->getUAV().get(), uint4(0));
+        mClearState = false;
+    }
+
+    mStepCount++;
+
+    auto var = pPass->getRootVar()["gOptimizer"];
+    var["values"] = pParams;
+    var["moment1"] = mpMoment1;
+    var["moment2"] = mpMoment2;
+
+    for (const auto& group : mGroups)
+    {
+        if (group.learningRate == 0.f || group.size == 0)
+            continue; // Skip groups with zero learning rate.
+
+        OptimizerStepParams params = Optimizer::getStepParams(mConfig, group, mStepCount);
+        var["params"].setBlob(params);
+        pPass->execute(pRenderContext, uint3(threadCount > 0 ? threadCount : group.size, 1, 1));
+    }
+}
+
+void GpuOptimizer::reset()
+{
+    mStepCount = 0;
+    mClearState = true;
+}
+
+void GpuOptimizer::setLearningRate(uint32_t groupIndex, float learningRate)
+{
+    FALCOR_CHECK(groupIndex < mGroups.size(), "Group index {} is out of range.", groupIndex);
+    mGroups[groupIndex].learningRate = learningRate;
+}
+
+FALCOR_SCRIPT_BINDING(GpuOptimizer)
+{
+    using namespace pybind11::literals;
+
+    FALCOR_SCRIPT_BINDING_DEPENDENCY(RenderContext)
+
+    pybind11::falcor_enum<OptimizerType>(m, "OptimizerType");
+
+    pybind11::class_<OptimizerConfig> config(m, "OptimizerConfig");
+    config.def(pybind11::init<>());
+    config.def_readwrite("type", &OptimizerConfig::type);
+    config.def_readwrite("momentum", &OptimizerConfig::momentum);
+    config.def_readwrite("beta1", &OptimizerConfig::beta1);
+    config.def_readwrite("beta2", &OptimizerConfig::beta2);
+    config.def_readwrite("epsilon", &OptimizerConfig::epsilon);
+
+    pybind11::class_<OptimizerParamGroup> group(m, "OptimizerParamGroup");
+    group.def(pybind11::init<>());
+    group.def_readwrite("offset", &OptimizerParamGroup::offset);
+    group.def_readwrite("size", &OptimizerParamGroup::size);
+    group.def_readwrite("learning_rate", &OptimizerParamGroup::learningRate);
+    group.def_readwrite("weight_decay", &OptimizerParamGroup::weightDecay);
+    group.def_readwrite("min_value", &OptimizerParamGroup::minValue);
+    group.def_readwrite("max_value", &OptimizerParamGroup::maxValue);
+
+    pybind11::class_<GpuOptimizer, ref<GpuOptimizer>> optimizer(m, "GpuOptimizer");
+    optimizer.def_static("create", &GpuOptimizer::create, "device"_a, "param_count"_a, "config"_a, "groups"_a = std::vector<OptimizerParamGroup>());
+    optimizer.def(
+        "step",
+        pybind11::overload_cast<RenderContext*, const ref<Buffer>&, const ref<Buffer>&>(&GpuOptimizer::step),
+        "render_context"_a,
+        "grads"_a,
+        "params"_a
+    );
+    optimizer.def("reset", &GpuOptimizer::reset);
+    optimizer.def("set_learning_rate", &GpuOptimizer::setLearningRate, "group_index"_a, "learning_rate"_a);
+    optimizer.def_property_readonly("step_count", &GpuOptimizer::getStepCount);
+}
+} // namespace Falcor
@@ -0,0 +1,118 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Optimizer.h"
+#include "SharedTypes.slang"
+#include "Core/Object.h"
+#include "Core/API/Buffer.h"
+#include "Core/Pass/ComputePass.h"
+
+namespace Falcor
+{
+class RenderContext;
+class SceneGradients;
+
+/**
+ * GPU version of Optimizer, updating parameters stored in GPU buffers.
+ *
+ * Gradients and parameters are raw buffers of floats, e.g. the gradients aggregated by SceneGradients.
+ * The moments are kept on the GPU, so parameters never need to be read back. Each parameter group is
+ * updated by one dispatch of Optimizer.cs.slang.
+ */
+class FALCOR_API GpuOptimizer : public Object
+{
+    FALCOR_OBJECT(GpuOptimizer);
+
+public:
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] paramCount Number of parameters.
+     * @param[in] config Optimizer hyperparameters.
+     * @param[in] groups Parameter groups. Groups must not overlap. If empty, a single group with default
+     *            settings covers all parameters.
+     */
+    GpuOptimizer(ref<Device> pDevice, uint32_t paramCount, const OptimizerConfig& config, std::vector<OptimizerParamGroup> groups = {});
+
+    static ref<GpuOptimizer> create(
+        ref<Device> pDevice,
+        uint32_t paramCount,
+        const OptimizerConfig& config,
+        std::vector<OptimizerParamGroup> groups = {}
+    )
+    {
+        return make_ref<GpuOptimizer>(pDevice, paramCount, config, std::move(groups));
+    }
+
+    /**
+     * Take an optimization step.
+     * @param[in] pRenderContext Render context.
+     * @param[in] pGrads Buffer holding the gradients of all parameters.
+     * @param[in] pParams Buffer holding the parameters to update.
+     */
+    void step(RenderContext* pRenderContext, const ref<Buffer>& pGrads, const ref<Buffer>& pParams);
+
+    /**
+     * Take an optimization step using aggregated scene gradients.
+     * Sparse scene gradients without a dense mirror are read from the compacted coordinate list. In that case
+     * only parameters in blocks that received gradients are updated (lazy update, see Optimizer.cs.slang).
+     * @param[in] pRenderContext Render context.
+     * @param[in] sceneGradients Scene gradients. The gradients must have been aggregated.
+     * @param[in] gradType Gradient type to use.
+     * @param[in] pParams Buffer holding the parameters to update.
+     */
+    void step(RenderContext* pRenderContext, const SceneGradients& sceneGradients, GradientType gradType, const ref<Buffer>& pParams);
+
+    /// Reset the optimizer state. The moments are cleared on the next step.
+    void reset();
+
+    /// Set the learning rate of a group, e.g. for learning rate schedules.
+    void setLearningRate(uint32_t groupIndex, float learningRate);
+
+    uint32_t getParamCount() const { return mParamCount; }
+    uint32_t getStepCount() const { return mStepCount; }
+    const OptimizerConfig& getConfig() const { return mConfig; }
+    const std::vector<OptimizerParamGroup>& getGroups() const { return mGroups; }
+
+private:
+    /// Dispatch the pass for all groups. A thread count of 0 dispatches one thread per parameter of the group.
+    void execute(RenderContext* pRenderContext, const ref<ComputePass>& pPass, const ref<Buffer>& pParams, uint32_t threadCount);
+
+    ref<Device> mpDevice;
+    uint32_t mParamCount;
+    OptimizerConfig mConfig;
+    std::vector<OptimizerParamGroup> mGroups;
+    uint32_t mStepCount = 0;
+    bool mClearState = true;
+
+    ref<ComputePass> mpStepPass;
+    ref<ComputePass> mpSparseStepPass; ///< Created on first use with sparse scene gradients.
+    ref<Buffer> mpMoment1;
+    ref<Buffer> mpMoment2;
+};
+} // namespace Falcor
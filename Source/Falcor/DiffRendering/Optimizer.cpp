@@ -0,0 +1,295 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Optimizer.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define FALCOR_OPTIMIZER_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_OPTIMIZER_SSE2 0
+#endif
+
+namespace Falcor
+{
+namespace
+{
+/// Number of parameters updated per task.
+const uint32_t kChunkSize = 1 << 14;
+
+struct Chunk
+{
+    uint32_t groupIndex;
+    uint32_t begin;
+    uint32_t end;
+};
+
+// The scalar updates mirror Optimizer.cs.slang. The SSE2 paths perform the same operations in the same order.
+
+// Clamping passes NaN through in all paths so that a diverged parameter is not silently snapped to the range.
+float clampValue(float x, float minValue, float maxValue)
+{
+    return x < minValue ? minValue : (x > maxValue ? maxValue : x);
+}
+
+#if FALCOR_OPTIMIZER_SSE2
+__m128 clampValue(__m128 x, __m128 minValue, __m128 maxValue)
+{
+    // _mm_max_ps/_mm_min_ps return the second operand if either is NaN.
+    return _mm_min_ps(maxValue, _mm_max_ps(minValue, x));
+}
+#endif
+
+void stepSGD(const OptimizerStepParams& p, const float* pGrads, float* pParams, float* pMomentum, uint32_t begin, uint32_t end)
+{
+    uint32_t i = begin;
+#if FALCOR_OPTIMIZER_SSE2
+    const __m128 lr = _mm_set1_ps(p.learningRate);
+    const __m128 wd = _mm_set1_ps(p.weightDecay);
+    const __m128 mu = _mm_set1_ps(p.momentum);
+    const __m128 minValue = _mm_set1_ps(p.minValue);
+    const __m128 maxValue = _mm_set1_ps(p.maxValue);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(pParams + i);
+        __m128 g = _mm_add_ps(_mm_loadu_ps(pGrads + i), _mm_mul_ps(wd, x));
+        if (pMomentum)
+        {
+            g = _mm_add_ps(_mm_mul_ps(mu, _mm_loadu_ps(pMomentum + i)), g);
+            _mm_storeu_ps(pMomentum + i, g);
+        }
+        x = _mm_sub_ps(x, _mm_mul_ps(lr, g));
+        _mm_storeu_ps(pParams + i, clampValue(x, minValue, maxValue));
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        float x = pParams[i];
+        float g = pGrads[i] + p.weightDecay * x;
+        if (pMomentum)
+        {
+            g = p.momentum * pMomentum[i] + g;
+            pMomentum[i] = g;
+        }
+        x = x - p.learningRate * g;
+        pParams[i] = clampValue(x, p.minValue, p.maxValue);
+    }
+}
+
+void stepAdam(
+    const OptimizerStepParams& p,
+    bool decoupledWeightDecay,
+    const float* pGrads,
+    float* pParams,
+    float* pMoment1,
+    float* pMoment2,
+    uint32_t begin,
+    uint32_t end
+)
+{
+    // L2 regularization adds to the gradient, decoupled weight decay scales the parameter.
+    const float l2 = decoupledWeightDecay ? 0.f : p.weightDecay;
+    const float decay = decoupledWeightDecay ? 1.f - p.learningRate * p.weightDecay : 1.f;
+    const float oneMinusBeta1 = 1.f - p.beta1;
+    const float oneMinusBeta2 = 1.f - p.beta2;
+
+    uint32_t i = begin;
+#if FALCOR_OPTIMIZER_SSE2
+    const __m128 l2v = _mm_set1_ps(l2);
+    const __m128 decayv = _mm_set1_ps(decay);
+    const __m128 beta1 = _mm_set1_ps(p.beta1);
+    const __m128 beta2 = _mm_set1_ps(p.beta2);
+    const __m128 oneMinusBeta1v = _mm_set1_ps(oneMinusBeta1);
+    const __m128 oneMinusBeta2v = _mm_set1_ps(oneMinusBeta2);
+    const __m128 stepSize = _mm_set1_ps(p.stepSize);
+    const __m128 invBiasCorrection2 = _mm_set1_ps(p.invBiasCorrection2);
+    const __m128 epsilon = _mm_set1_ps(p.epsilon);
+    const __m128 minValue = _mm_set1_ps(p.minValue);
+    const __m128 maxValue = _mm_set1_ps(p.maxValue);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(pParams + i);
+        __m128 g = _mm_add_ps(_mm_loadu_ps(pGrads + i), _mm_mul_ps(l2v, x));
+        x = _mm_mul_ps(x, decayv);
+        __m128 m = _mm_add_ps(_mm_mul_ps(beta1, _mm_loadu_ps(pMoment1 + i)), _mm_mul_ps(oneMinusBeta1v, g));
+        __m128 v = _mm_add_ps(_mm_mul_ps(beta2, _mm_loadu_ps(pMoment2 + i)), _mm_mul_ps(oneMinusBeta2v, _mm_mul_ps(g, g)));
+        _mm_storeu_ps(pMoment1 + i, m);
+        _mm_storeu_ps(pMoment2 + i, v);
+        __m128 denom = _mm_add_ps(_mm_sqrt_ps(_mm_mul_ps(v, invBiasCorrection2)), epsilon);
+        x = _mm_sub_ps(x, _mm_div_ps(_mm_mul_ps(stepSize, m), denom));
+        _mm_storeu_ps(pParams + i, clampValue(x, minValue, maxValue));
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        float x = pParams[i];
+        float g = pGrads[i] + l2 * x;
+        x = x * decay;
+        float m = p.beta1 * pMoment1[i] + oneMinusBeta1 * g;
+        float v = p.beta2 * pMoment2[i] + oneMinusBeta2 * (g * g);
+        pMoment1[i] = m;
+        pMoment2[i] = v;
+        float denom = std::sqrt(v * p.invBiasCorrection2) + p.epsilon;
+        x = x - (p.stepSize * m) / denom;
+        pParams[i] = clampValue(x, p.minValue, p.maxValue);
+    }
+}
+} // namespace
+
+Optimizer::Optimizer(uint32_t paramCount, const OptimizerConfig& config, std::vector<OptimizerParamGroup> groups)
+    : mParamCount(paramCount), mConfig(config), mGroups(validateGroups(paramCount, std::move(groups)))
+{
+    reset();
+}
+
+void Optimizer::step(fstd::span<const float> grads, fstd::span<float> params)
+{
+    FALCOR_CHECK(grads.size() == mParamCount, "Gradient count ({}) does not match parameter count ({}).", grads.size(), mParamCount);
+    FALCOR_CHECK(params.size() == mParamCount, "Parameter count ({}) does not match optimizer ({}).", params.size(), mParamCount);
+
+    mStepCount++;
+
+    std::vector<OptimizerStepParams> stepParams(mGroups.size());
+    std::vector<Chunk> chunks;
+    for (uint32_t groupIndex = 0; groupIndex < (uint32_t)mGroups.size(); ++groupIndex)
+    {
+        const auto& group = mGroups[groupIndex];
+        if (group.learningRate == 0.f)
+            continue; // Skip groups with zero learning rate.
+        stepParams[groupIndex] = getStepParams(mConfig, group, mStepCount);
+        for (uint32_t begin = group.offset; begin < group.offset + group.size; begin += kChunkSize)
+            chunks.push_back({groupIndex, begin, std::min(begin + kChunkSize, group.offset + group.size)});
+    }
+
+    float* pMoment1 = mMoment1.empty() ? nullptr : mMoment1.data();
+    float* pMoment2 = mMoment2.empty() ? nullptr : mMoment2.data();
+
+    auto stepChunk = [&](size_t chunkIndex)
+    {
+        const Chunk& chunk = chunks[chunkIndex];
+        const OptimizerStepParams& p = stepParams[chunk.groupIndex];
+        switch (mConfig.type)
+        {
+        case OptimizerType::SGD:
+            stepSGD(p, grads.data(), params.data(), pMoment1, chunk.begin, chunk.end);
+            break;
+        case OptimizerType::Adam:
+        case OptimizerType::AdamW:
+            stepAdam(p, mConfig.type == OptimizerType::AdamW, grads.data(), params.data(), pMoment1, pMoment2, chunk.begin, chunk.end);
+            break;
+        default:
+            FALCOR_UNREACHABLE();
+        }
+    };
+
+    auto chunkRange = NumericRange<size_t>(0, chunks.size());
+    std::for_each(std::execution::par, chunkRange.begin(), chunkRange.end(), stepChunk);
+}
+
+void Optimizer::reset()
+{
+    mStepCount = 0;
+    mMoment1.clear();
+    mMoment2.clear();
+
+    // The SGD momentum buffer is only needed with momentum.
+    bool isAdam = mConfig.type == OptimizerType::Adam || mConfig.type == OptimizerType::AdamW;
+    if (isAdam || mConfig.momentum != 0.f)
+        mMoment1.resize(mParamCount, 0.f);
+    if (isAdam)
+        mMoment2.resize(mParamCount, 0.f);
+}
+
+void Optimizer::setLearningRate(uint32_t groupIndex, float learningRate)
+{
+    FALCOR_CHECK(groupIndex < mGroups.size(), "Group index {} is out of range.", groupIndex);
+    mGroups[groupIndex].learningRate = learningRate;
+}
+
+OptimizerStepParams Optimizer::getStepParams(const OptimizerConfig& config, const OptimizerParamGroup& group, uint32_t stepCount)
+{
+    FALCOR_ASSERT(stepCount > 0);
+
+    OptimizerStepParams p;
+    p.offset = group.offset;
+    p.size = group.size;
+    p.learningRate = group.learningRate;
+    p.weightDecay = group.weightDecay;
+    p.minValue = group.minValue;
+    p.maxValue = group.maxValue;
+    p.momentum = config.momentum;
+    p.beta1 = config.beta1;
+    p.beta2 = config.beta2;
+    p.epsilon = config.epsilon;
+
+    // Bias corrections are computed in double precision, 1 - beta^t loses precision in float for beta close to one.
+    double biasCorrection1 = 1.0 - std::pow((double)config.beta1, (double)stepCount);
+    double biasCorrection2 = 1.0 - std::pow((double)config.beta2, (double)stepCount);
+    p.stepSize = (float)(group.learningRate / biasCorrection1);
+    p.invBiasCorrection2 = (float)(1.0 / biasCorrection2);
+    return p;
+}
+
+std::vector<OptimizerParamGroup> Optimizer::validateGroups(uint32_t paramCount, std::vector<OptimizerParamGroup> groups)
+{
+    if (groups.empty())
+    {
+        OptimizerParamGroup group;
+        group.size = paramCount;
+        groups.push_back(group);
+        return groups;
+    }
+
+    // Check for overlaps in offset order, but keep the order of the groups for indexing.
+    std::vector<const OptimizerParamGroup*> sorted;
+    for (const auto& group : groups)
+        sorted.push_back(&group);
+    std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->offset < b->offset; });
+
+    uint32_t end = 0;
+    for (const auto* pGroup : sorted)
+    {
+        const auto& group = *pGroup;
+        FALCOR_CHECK(
+            (uint64_t)group.offset + group.size <= paramCount,
+            "Parameter group [{}, {}) exceeds the parameter count ({}).",
+            group.offset,
+            (uint64_t)group.offset + group.size,
+            paramCount
+        );
+        FALCOR_CHECK(group.offset >= end, "Parameter groups overlap at parameter {}.", group.offset);
+        FALCOR_CHECK(group.minValue <= group.maxValue, "Parameter group has an empty value range.");
+        end = group.offset + group.size;
+    }
+    return groups;
+}
+} // namespace Falcor
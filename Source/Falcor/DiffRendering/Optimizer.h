@@ -0,0 +1,122 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "OptimizerParams.slang"
+#include "Core/Macros.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+/// Optimizer hyperparameters shared by all parameter groups.
+struct OptimizerConfig
+{
+    OptimizerType type = OptimizerType::Adam;
+    float momentum = 0.9f; ///< SGD momentum. Set to zero to disable momentum.
+    float beta1 = 0.9f;    ///< Adam decay rate of the first moment.
+    float beta2 = 0.999f;  ///< Adam decay rate of the second moment.
+    float epsilon = 1e-8f; ///< Adam denominator offset.
+};
+
+/// Range of consecutive parameters sharing a learning rate, weight decay and value range.
+struct OptimizerParamGroup
+{
+    uint32_t offset = 0;       ///< Index of the first parameter.
+    uint32_t size = 0;         ///< Number of parameters.
+    float learningRate = 1e-3f; ///< Learning rate. Groups with zero learning rate are not updated.
+    float weightDecay = 0.f;   ///< L2 regularization (SGD, Adam) or decoupled weight decay (AdamW).
+    float minValue = -std::numeric_limits<float>::infinity(); ///< Minimum parameter value.
+    float maxValue = std::numeric_limits<float>::infinity();  ///< Maximum parameter value.
+};
+
+/**
+ * First-order optimizer for inverse rendering (SGD with momentum, Adam and AdamW).
+ *
+ * Parameters are partitioned into groups with their own learning rate, weight decay and value range.
+ * Parameters not covered by any group are left unchanged. The update follows the PyTorch definitions
+ * of the optimizers, with parameters clamped to the group's value range after each step.
+ *
+ * Parameters and gradients are stored on the CPU. The update is vectorized and runs in parallel over
+ * chunks of parameters. See GpuOptimizer for the same update on GPU buffers (e.g. SceneGradients).
+ */
+class FALCOR_API Optimizer
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] paramCount Number of parameters.
+     * @param[in] config Optimizer hyperparameters.
+     * @param[in] groups Parameter groups. Groups must not overlap. If empty, a single group with default
+     *            settings covers all parameters.
+     */
+    Optimizer(uint32_t paramCount, const OptimizerConfig& config, std::vector<OptimizerParamGroup> groups = {});
+
+    /**
+     * Take an optimization step.
+     * @param[in] grads Gradients of all parameters.
+     * @param[in,out] params Parameters to update.
+     */
+    void step(fstd::span<const float> grads, fstd::span<float> params);
+
+    /// Reset the optimizer state (moments and step count).
+    void reset();
+
+    /// Set the learning rate of a group, e.g. for learning rate schedules.
+    void setLearningRate(uint32_t groupIndex, float learningRate);
+
+    uint32_t getParamCount() const { return mParamCount; }
+    uint32_t getStepCount() const { return mStepCount; }
+    const OptimizerConfig& getConfig() const { return mConfig; }
+    const std::vector<OptimizerParamGroup>& getGroups() const { return mGroups; }
+
+    /**
+     * Compute the constants for updating a group in a step.
+     * @param[in] config Optimizer hyperparameters.
+     * @param[in] group Parameter group.
+     * @param[in] stepCount Number of the step, starting at 1.
+     */
+    static OptimizerStepParams getStepParams(const OptimizerConfig& config, const OptimizerParamGroup& group, uint32_t stepCount);
+
+    /**
+     * Validate parameter groups. Throws if groups overlap or exceed the parameter count.
+     * @return The groups, or a single group covering all parameters if empty.
+     */
+    static std::vector<OptimizerParamGroup> validateGroups(uint32_t paramCount, std::vector<OptimizerParamGroup> groups);
+
+private:
+    uint32_t mParamCount;
+    OptimizerConfig mConfig;
+    std::vector<OptimizerParamGroup> mGroups;
+    uint32_t mStepCount = 0;
+
+    std::vector<float> mMoment1; ///< SGD momentum buffer or Adam first moment.
+    std::vector<float> mMoment2; ///< Adam second moment.
+};
+} // namespace Falcor
@@ -39,15 +39,32 @@ const char kTmpGradsBufferName[] = "tmpGrads";
 const char kAggregateShaderFilename[] = "DiffRendering/AggregateGradients.cs.slang";
 } // namespace
 
-SceneGradients::SceneGradients(ref<Device> pDevice, uint2 gradDim, uint2 hashSize, GradientAggregateMode mode)
-    : mpDevice(pDevice), mGradDim(gradDim), mHashSize(hashSize), mAggregateMode(mode)
+SceneGradients::SceneGradients(
+    ref<Device> pDevice,
+    uint2 gradDim,
+    uint2 hashSize,
+    GradientAggregateMode mode,
+    uint2 sparseCapacity,
+    bool sparseDenseMirror
+)
+    : mpDevice(pDevice), mGradDim(gradDim), mHashSize(hashSize), mAggregateMode(mode), mSparseDenseMirror(sparseDenseMirror)
 {
+    if (mAggregateMode == GradientAggregateMode::Sparse)
+    {
+        // The dense temporary buffers are not used.
+        mHashSize = uint2(1);
+        for (size_t i = 0; i < size_t(GradientType::Count); i++)
+            mSparseSlotCount[i] = mGradDim[i] > 0 ? SparseGradientTable::getSlotCount(std::max(sparseCapacity[i], 1u)) : 0;
+    }
+
     createParameterBlock();
 
     // Create a pass for aggregating gradients.
     ProgramDesc desc;
     if (mAggregateMode == GradientAggregateMode::Direct)
         desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainDirect");
+    else if (mAggregateMode == GradientAggregateMode::Sparse)
+        desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainSparse");
     else
         desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainHashGrid");
 
@@ -66,12 +83,29 @@ void SceneGradients::createParameterBlock()
     auto bindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
     for (size_t i = 0; i < size_t(GradientType::Count); i++)
     {
+        // Sparsely stored gradients only get dense storage if the mirror is requested.
         uint32_t elemCount = std::max(mGradDim[i], 1u);
-        mpGrads[i] =
-            mpDevice->createBuffer(elemCount * sizeof(float), bindFlags | ResourceBindFlags::Shared, MemoryType::DeviceLocal, nullptr);
+        if (mSparseSlotCount[i] == 0 || mSparseDenseMirror)
+            mpGrads[i] =
+                mpDevice->createBuffer(elemCount * sizeof(float), bindFlags | ResourceBindFlags::Shared, MemoryType::DeviceLocal, nullptr);
 
         uint32_t hashSize = std::max(mHashSize[i], 1u);
-        mpTmpGrads[i] = mpDevice->createBuffer(elemCount * hashSize * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr);
+        uint32_t tmpElemCount = mSparseSlotCount[i] > 0 ? 1 : elemCount * hashSize;
+        mpTmpGrads[i] = mpDevice->createBuffer(tmpElemCount * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr);
+
+        // Create the sparse hash table and the compacted output.
+        // Dummy buffers are bound if the gradient type is stored densely.
+        uint32_t slotCount = std::max(mSparseSlotCount[i], 1u);
+        mpSparseKeys[i] = mpDevice->createBuffer(slotCount * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal, nullptr);
+        mpSparseTable[i] =
+            mpDevice->createBuffer(slotCount * kSparseGradBlockSize * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr);
+        mpSparseCounters[i] = mpDevice->createBuffer(2 * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal, nullptr);
+        if (mSparseSlotCount[i] > 0)
+        {
+            mpSparseIndices[i] = mpDevice->createBuffer(slotCount * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal, nullptr);
+            mpSparseValues[i] =
+                mpDevice->createBuffer(slotCount * kSparseGradBlockSize * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr);
+        }
     }
 
     // Bind resources to parameter block.
@@ -82,6 +116,10 @@ void SceneGradients::createParameterBlock()
         var["gradDim"][i] = mGradDim[i];
         var["hashSize"][i] = mHashSize[i];
         var[kTmpGradsBufferName][i] = mpTmpGrads[i];
+        var["sparseSlotCount"][i] = mSparseSlotCount[i];
+        var["sparseKeys"][i] = mpSparseKeys[i];
+        var["sparseTable"][i] = mpSparseTable[i];
+        var["sparseCounters"][i] = mpSparseCounters[i];
     }
 }
 
@@ -89,13 +127,44 @@ void SceneGradients::clearGrads(RenderContext* pRenderContext, GradientType _gra
 {
     uint32_t gradType = uint32_t(_gradType);
     pRenderContext->clearUAV(mpTmpGrads[gradType]->getUAV().get(), uint4(0));
-    pRenderContext->clearUAV(mpGrads[gradType]->getUAV().get(), uint4(0));
+    if (mpGrads[gradType])
+        pRenderContext->clearUAV(mpGrads[gradType]->getUAV().get(), uint4(0));
+    if (mSparseSlotCount[gradType] > 0)
+    {
+        pRenderContext->clearUAV(mpSparseKeys[gradType]->getUAV().get(), uint4(0));
+        pRenderContext->clearUAV(mpSparseTable[gradType]->getUAV().get(), uint4(0));
+        pRenderContext->clearUAV(mpSparseCounters[gradType]->getUAV().get(), uint4(0));
+    }
 }
 
 void SceneGradients::aggregateGrads(RenderContext* pRenderContext, GradientType _gradType)
 {
     uint32_t gradType = uint32_t(_gradType);
 
+    if (mAggregateMode == GradientAggregateMode::Sparse)
+    {
+        if (mSparseSlotCount[gradType] == 0)
+            return;
+
+        // Reset the compacted block count, keep the overflow count.
+        const uint32_t zero = 0;
+        pRenderContext->updateBuffer(mpSparseCounters[gradType].get(), &zero, 0, sizeof(zero));
+
+        auto var = mpAggregatePass->getRootVar()["gAggregator"];
+        var["gradDim"] = mGradDim[gradType];
+        var["sparseSlotCount"] = mSparseSlotCount[gradType];
+        var["sparseKeys"] = mpSparseKeys[gradType];
+        var["sparseTable"] = mpSparseTable[gradType];
+        var["sparseCounters"] = mpSparseCounters[gradType];
+        var["sparseIndices"] = mpSparseIndices[gradType];
+        var["sparseValues"] = mpSparseValues[gradType];
+        var["writeDense"] = mpGrads[gradType] != nullptr;
+        var[kGradsBufferName] = mpGrads[gradType];
+
+        mpAggregatePass->execute(pRenderContext, uint3(mSparseSlotCount[gradType], 1, 1));
+        return;
+    }
+
     uint32_t hashSize = (mAggregateMode == GradientAggregateMode::Direct ? 1 : mHashSize[gradType]);
 
     // Bind resources.
@@ -109,6 +178,36 @@ void SceneGradients::aggregateGrads(RenderContext* pRenderContext, GradientType
     mpAggregatePass->execute(pRenderContext, uint3(mGradDim[gradType], hashSize, 1));
 }
 
+SparseGradients SceneGradients::readSparseGrads(GradientType _gradType) const
+{
+    uint32_t gradType = uint32_t(_gradType);
+    FALCOR_CHECK(mSparseSlotCount[gradType] > 0, "Gradient type '{}' is not stored sparsely.", enumToString(_gradType));
+
+    std::vector<uint32_t> counters = mpSparseCounters[gradType]->getElements<uint32_t>(0, 2);
+
+    SparseGradients result;
+    result.overflowCount = counters[1];
+    if (counters[0] > 0)
+    {
+        result.blockIndices = mpSparseIndices[gradType]->getElements<uint32_t>(0, counters[0]);
+        result.values = mpSparseValues[gradType]->getElements<float>(0, counters[0] * kSparseGradBlockSize);
+    }
+    result.sort();
+    return result;
+}
+
+uint64_t SceneGradients::getTmpMemoryUsage(GradientType _gradType) const
+{
+    uint32_t gradType = uint32_t(_gradType);
+    uint64_t size = mpTmpGrads[gradType]->getSize();
+    for (const auto& pBuffer : {mpSparseKeys[gradType], mpSparseTable[gradType], mpSparseIndices[gradType], mpSparseValues[gradType]})
+    {
+        if (pBuffer)
+            size += pBuffer->getSize();
+    }
+    return size;
+}
+
 inline void aggregate(SceneGradients& self, RenderContext* pRenderContext, GradientType gradType)
 {
     self.aggregateGrads(pRenderContext, gradType);
@@ -125,6 +224,9 @@ FALCOR_SCRIPT_BINDING(SceneGradients)
 
     pybind11::class_<SceneGradients, ref<SceneGradients>> sg(m, "SceneGradients");
     sg.def_static("create", &SceneGradients::create, "device"_a, "grad_dim"_a, "hash_size"_a);
+    sg.def_static(
+        "create_sparse", &SceneGradients::createSparse, "device"_a, "grad_dim"_a, "sparse_capacity"_a, "dense_mirror"_a = false
+    );
     sg.def("clear", &SceneGradients::clearGrads, "render_context"_a, "grad_type"_a);
     sg.def("get_grads_buffer", &SceneGradients::getGradsBuffer, "grad_type"_a);
     sg.def("aggregate", aggregate, "render_context"_a, "grad_type"_a);
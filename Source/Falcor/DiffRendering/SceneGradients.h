@@ -29,21 +29,57 @@
 #include "Core/API/ParameterBlock.h"
 #include "RenderGraph/RenderPass.h"
 #include "SharedTypes.slang"
+#include "SparseGradients.h"
 
 namespace Falcor
 {
+/**
+ * Storage for gradients of scene parameters, accumulated by differentiable shaders.
+ *
+ * In the Direct and HashGrid modes, gradients are accumulated into a dense temporary buffer with hashSize
+ * copies of all parameters to reduce atomic contention, which are then summed into the dense gradients.
+ *
+ * In the Sparse mode, gradients are accumulated into a hash table of parameter blocks sized by the number of
+ * blocks expected to receive gradients (see SparseGradientTable for the CPU reference). Aggregation compacts
+ * the table into a coordinate list. Use this mode for high-dimensional parameters (e.g. per texel or per vertex)
+ * where only a small fraction of parameters receives gradients in each iteration. No storage or work scales
+ * with the number of parameters, unless the optional dense mirror is enabled for consumers that need dense
+ * gradients. Otherwise consume the coordinate list (see GpuOptimizer) or readSparseGrads().
+ */
 class FALCOR_API SceneGradients : public Object
 {
     FALCOR_OBJECT(SceneGradients);
 
 public:
-    SceneGradients(ref<Device> pDevice, uint2 gradDim, uint2 hashSize, GradientAggregateMode mode = GradientAggregateMode::HashGrid);
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] gradDim Number of parameters per gradient type.
+     * @param[in] hashSize Number of copies of the temporary gradients per gradient type (HashGrid mode).
+     * @param[in] mode Aggregation mode.
+     * @param[in] sparseCapacity Number of parameter blocks the hash table can hold per gradient type (Sparse mode).
+     *            Rounded up to a power of two. Gradients that do not fit are dropped and counted.
+     * @param[in] sparseDenseMirror Also scatter the sparse gradients into dense gradient buffers (Sparse mode).
+     */
+    SceneGradients(
+        ref<Device> pDevice,
+        uint2 gradDim,
+        uint2 hashSize,
+        GradientAggregateMode mode = GradientAggregateMode::HashGrid,
+        uint2 sparseCapacity = uint2(0),
+        bool sparseDenseMirror = false
+    );
 
     static ref<SceneGradients> create(ref<Device> pDevice, uint2 gradDim, uint2 hashSize)
     {
         return make_ref<SceneGradients>(pDevice, gradDim, hashSize, GradientAggregateMode::HashGrid);
     }
 
+    static ref<SceneGradients> createSparse(ref<Device> pDevice, uint2 gradDim, uint2 sparseCapacity, bool denseMirror = false)
+    {
+        return make_ref<SceneGradients>(pDevice, gradDim, uint2(1), GradientAggregateMode::Sparse, sparseCapacity, denseMirror);
+    }
+
     ~SceneGradients() = default;
 
     void bindShaderData(const ShaderVar& var) const { var = mpSceneGradientsBlock; }
@@ -54,9 +90,38 @@ public:
     uint32_t getGradDim(GradientType gradType) const { return mGradDim[size_t(gradType)]; }
     uint32_t getHashSize(GradientType gradType) const { return mHashSize[size_t(gradType)]; }
 
+    GradientAggregateMode getAggregateMode() const { return mAggregateMode; }
+
     const ref<Buffer>& getTmpGradsBuffer(GradientType gradType) const { return mpTmpGrads[size_t(gradType)]; }
+
+    /// Get the dense gradients. Returns nullptr for gradient types stored sparsely without a dense mirror.
     const ref<Buffer>& getGradsBuffer(GradientType gradType) const { return mpGrads[size_t(gradType)]; }
 
+    /// Check if the gradient type is stored sparsely (sparse mode with a non-zero gradient dimension).
+    bool isSparse(GradientType gradType) const { return mSparseSlotCount[size_t(gradType)] > 0; }
+
+    /// Get the number of hash table slots (0 if not in sparse mode).
+    uint32_t getSparseSlotCount(GradientType gradType) const { return mSparseSlotCount[size_t(gradType)]; }
+
+    /// Get the compacted block indices (sparse mode). Valid after aggregateGrads().
+    const ref<Buffer>& getSparseIndicesBuffer(GradientType gradType) const { return mpSparseIndices[size_t(gradType)]; }
+
+    /// Get the compacted gradients, kSparseGradBlockSize per block (sparse mode). Valid after aggregateGrads().
+    const ref<Buffer>& getSparseValuesBuffer(GradientType gradType) const { return mpSparseValues[size_t(gradType)]; }
+
+    /// Get the counters (sparse mode): number of compacted blocks and number of dropped gradients.
+    const ref<Buffer>& getSparseCountersBuffer(GradientType gradType) const { return mpSparseCounters[size_t(gradType)]; }
+
+    /**
+     * Read back the compacted gradients (sparse mode). This call blocks until the GPU is done.
+     * @param[in] gradType Gradient type.
+     * @return Sparse gradients sorted by block index.
+     */
+    SparseGradients readSparseGrads(GradientType gradType) const;
+
+    /// Get the GPU memory used by temporary gradient storage (excluding the dense gradients and their mirror), in bytes.
+    uint64_t getTmpMemoryUsage(GradientType gradType) const;
+
 private:
     void createParameterBlock();
 
@@ -64,12 +129,20 @@ private:
     uint2 mGradDim;
     uint2 mHashSize;
     GradientAggregateMode mAggregateMode;
+    bool mSparseDenseMirror;
 
     ref<ParameterBlock> mpSceneGradientsBlock;
 
     ref<Buffer> mpGrads[size_t(GradientType::Count)];
     ref<Buffer> mpTmpGrads[size_t(GradientType::Count)];
 
+    uint32_t mSparseSlotCount[size_t(GradientType::Count)] = {};
+    ref<Buffer> mpSparseKeys[size_t(GradientType::Count)];
+    ref<Buffer> mpSparseTable[size_t(GradientType::Count)];
+    ref<Buffer> mpSparseCounters[size_t(GradientType::Count)];
+    ref<Buffer> mpSparseIndices[size_t(GradientType::Count)];
+    ref<Buffer> mpSparseValues[size_t(GradientType::Count)];
+
     ref<ComputePass> mpAggregatePass;
 };
 } // namespace Falcor
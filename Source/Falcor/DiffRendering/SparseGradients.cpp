@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SparseGradients.h"
+#include "Core/Error.h"
+#include "Utils/Math/HashUtils.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+std::vector<float> SparseGradients::toDense(uint32_t gradDim) const
+{
+    std::vector<float> dense(gradDim, 0.f);
+    for (size_t i = 0; i < blockIndices.size(); ++i)
+    {
+        for (uint32_t j = 0; j < kSparseGradBlockSize; ++j)
+        {
+            uint64_t index = (uint64_t)blockIndices[i] * kSparseGradBlockSize + j;
+            if (index < gradDim)
+                dense[index] += values[i * kSparseGradBlockSize + j];
+        }
+    }
+    return dense;
+}
+
+void SparseGradients::sort()
+{
+    std::vector<uint32_t> order(blockIndices.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return blockIndices[a] < blockIndices[b]; });
+
+    std::vector<uint32_t> sortedIndices(order.size());
+    std::vector<float> sortedValues(values.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        sortedIndices[i] = blockIndices[order[i]];
+        std::copy_n(values.begin() + order[i] * kSparseGradBlockSize, kSparseGradBlockSize, sortedValues.begin() + i * kSparseGradBlockSize);
+    }
+    blockIndices = std::move(sortedIndices);
+    values = std::move(sortedValues);
+}
+
+SparseGradientTable::SparseGradientTable(uint32_t gradDim, uint32_t capacity)
+    : mGradDim(gradDim), mKeys(getSlotCount(capacity), 0), mValues(mKeys.size() * kSparseGradBlockSize, 0.f)
+{}
+
+uint32_t SparseGradientTable::getSlotCount(uint32_t capacity)
+{
+    FALCOR_CHECK(capacity <= (1u << 31), "Sparse gradient capacity is too large.");
+    uint32_t slotCount = 1;
+    while (slotCount < capacity)
+        slotCount <<= 1;
+    return slotCount;
+}
+
+uint64_t SparseGradientTable::getMemoryUsage(uint32_t capacity)
+{
+    // Keys and values of the table plus the same for the compacted output.
+    const uint64_t slotBytes = sizeof(uint32_t) + kSparseGradBlockSize * sizeof(float);
+    return 2 * getSlotCount(capacity) * slotBytes;
+}
+
+uint64_t SparseGradientTable::getDenseMemoryUsage(uint32_t gradDim, uint32_t hashSize)
+{
+    return (uint64_t)gradDim * hashSize * sizeof(float);
+}
+
+bool SparseGradientTable::add(uint32_t gradIndex, float value)
+{
+    if (gradIndex >= mGradDim)
+        return true;
+
+    const uint32_t block = gradIndex / kSparseGradBlockSize;
+    const uint32_t key = block + 1;
+    const uint32_t mask = getSlotCount() - 1;
+    uint32_t slot = jenkinsHash(block) & mask;
+    for (uint32_t probe = 0; probe < kSparseGradMaxProbes; ++probe)
+    {
+        if (mKeys[slot] == 0)
+        {
+            mKeys[slot] = key;
+            mOccupiedCount++;
+        }
+        if (mKeys[slot] == key)
+        {
+            mValues[slot * kSparseGradBlockSize + gradIndex % kSparseGradBlockSize] += value;
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    mOverflowCount++;
+    return false;
+}
+
+void SparseGradientTable::clear()
+{
+    std::fill(mKeys.begin(), mKeys.end(), 0);
+    std::fill(mValues.begin(), mValues.end(), 0.f);
+    mOccupiedCount = 0;
+    mOverflowCount = 0;
+}
+
+SparseGradients SparseGradientTable::compact() const
+{
+    SparseGradients result;
+    result.blockIndices.reserve(mOccupiedCount);
+    result.values.reserve(mOccupiedCount * kSparseGradBlockSize);
+    for (uint32_t slot = 0; slot < getSlotCount(); ++slot)
+    {
+        if (mKeys[slot] == 0)
+            continue;
+        result.blockIndices.push_back(mKeys[slot] - 1);
+        result.values.insert(
+            result.values.end(), mValues.begin() + slot * kSparseGradBlockSize, mValues.begin() + (slot + 1) * kSparseGradBlockSize
+        );
+    }
+    result.overflowCount = mOverflowCount;
+    result.sort();
+    return result;
+}
+} // namespace Falcor
@@ -0,0 +1,116 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SharedTypes.slang"
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Sparse gradients in coordinate list format.
+ * Gradients are stored per block of kSparseGradBlockSize consecutive parameters.
+ */
+struct FALCOR_API SparseGradients
+{
+    std::vector<uint32_t> blockIndices; ///< Index of each block (parameter index / kSparseGradBlockSize), in ascending order.
+    std::vector<float> values;          ///< Gradients, kSparseGradBlockSize per block.
+    uint32_t overflowCount = 0;         ///< Number of gradients dropped because the hash table was full.
+
+    uint32_t getBlockCount() const { return (uint32_t)blockIndices.size(); }
+
+    /**
+     * Convert to dense gradients.
+     * @param[in] gradDim Number of parameters.
+     * @return Gradients of all parameters.
+     */
+    std::vector<float> toDense(uint32_t gradDim) const;
+
+    /// Sort blocks by index.
+    void sort();
+};
+
+/**
+ * CPU reference of the sparse gradient storage in SceneGradients (GradientAggregateMode::Sparse).
+ *
+ * Gradients are accumulated in an open addressing hash table keyed by parameter block. Each slot holds
+ * the block index plus one (0 marks an empty slot) and the gradients of the block. Collisions are
+ * resolved with linear probing; after kSparseGradMaxProbes occupied slots the gradient is dropped.
+ * Compaction extracts the occupied slots into a coordinate list.
+ *
+ * This mirrors atomicAddSparseGrad() in SceneGradients.slang and the sparse path in
+ * AggregateGradients.cs.slang, except that the GPU inserts concurrently, so blocks may land in other
+ * slots and summation order differs.
+ */
+class FALCOR_API SparseGradientTable
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] gradDim Number of parameters.
+     * @param[in] capacity Minimum number of slots. Rounded up to a power of two.
+     */
+    SparseGradientTable(uint32_t gradDim, uint32_t capacity);
+
+    /// Get the number of slots for a requested capacity.
+    static uint32_t getSlotCount(uint32_t capacity);
+
+    /// Get the memory used on the GPU by the hash table and the compacted output, in bytes.
+    static uint64_t getMemoryUsage(uint32_t capacity);
+
+    /// Get the memory used on the GPU by the dense temporary gradients of the hash grid mode, in bytes.
+    static uint64_t getDenseMemoryUsage(uint32_t gradDim, uint32_t hashSize);
+
+    /**
+     * Add a gradient.
+     * @param[in] gradIndex Parameter index. Indices out of range are ignored.
+     * @param[in] value Gradient.
+     * @return False if the gradient was dropped because the table is full.
+     */
+    bool add(uint32_t gradIndex, float value);
+
+    /// Clear all gradients.
+    void clear();
+
+    /// Extract the occupied blocks, sorted by block index.
+    SparseGradients compact() const;
+
+    uint32_t getGradDim() const { return mGradDim; }
+    uint32_t getSlotCount() const { return (uint32_t)mKeys.size(); }
+    uint32_t getOccupiedSlotCount() const { return mOccupiedCount; }
+    uint32_t getOverflowCount() const { return mOverflowCount; }
+
+private:
+    uint32_t mGradDim;
+    std::vector<uint32_t> mKeys;
+    std::vector<float> mValues;
+    uint32_t mOccupiedCount = 0;
+    uint32_t mOverflowCount = 0;
+};
+} // namespace Falcor
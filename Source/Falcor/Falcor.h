@@ -56,6 +56,7 @@
 #include "Core/API/QueryHeap.h"
 #include "Core/API/RasterizerState.h"
 #include "Core/API/Raytracing.h"
+#include "Core/API/ReadbackRing.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/Resource.h"
 #include "Core/API/GpuMemoryHeap.h"
@@ -32,6 +32,7 @@
 #include "GlobalState.h"
 #include "Core/ObjectPython.h"
 #include "Core/API/Device.h"
+#include "Core/API/PythonHelpers.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -427,6 +428,21 @@ void RenderGraph::execute(RenderContext* pRenderContext)
     mpExe->execute(c);
 }
 
+std::vector<ProgramManager::PrecompileResult> RenderGraph::precompilePrograms(RenderContext* pRenderContext, uint32_t threadCount)
+{
+    std::string log;
+    if (!compile(pRenderContext, log))
+        FALCOR_THROW("Failed to compile render graph:\n{}", log);
+
+    FALCOR_ASSERT(mpExe);
+    RenderGraphExe::Context c{
+        pRenderContext, mPassesDictionary, mCompilerDeps.defaultResourceProps.dims, mCompilerDeps.defaultResourceProps.format};
+    std::vector<ProgramPermutation> permutations;
+    mpExe->collectProgramPermutations(c, permutations);
+
+    return mpDevice->getProgramManager()->precompilePrograms(permutations, threadCount);
+}
+
 void RenderGraph::update(const ref<RenderGraph>& pGraph)
 {
     // Fill in missing passes from referenced graph.
@@ -728,6 +744,25 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     renderGraph.def("get_pass", &RenderGraph::getPass, "name"_a);
     renderGraph.def("__getitem__", [](RenderGraph& self, const std::string& name) { return self.getPass(name); });
     renderGraph.def("get_output", pybind11::overload_cast<const std::string&>(&RenderGraph::getOutput), "name"_a);
+    renderGraph.def(
+        "precompile_programs",
+        [](RenderGraph& graph, uint32_t thread_count)
+        {
+            pybind11::list results;
+            for (const auto& result : graph.precompilePrograms(graph.getDevice()->getRenderContext(), thread_count))
+            {
+                pybind11::dict d;
+                d["name"] = result.name;
+                d["defines"] = defineListToPython(result.defines);
+                d["success"] = result.success;
+                d["already_compiled"] = result.alreadyCompiled;
+                d["time"] = result.time;
+                results.append(d);
+            }
+            return results;
+        },
+        "thread_count"_a = 0
+    );
 
     // PYTHONDEPRECATED BEGIN
     renderGraph.def(
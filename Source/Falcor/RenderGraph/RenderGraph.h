@@ -33,6 +33,7 @@
 #include "Core/Object.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Formats.h"
+#include "Core/Program/ProgramManager.h"
 #include "Utils/UI/Gui.h"
 #include "Utils/Algorithm/DirectedGraph.h"
 #include "Scene/Scene.h"
@@ -149,6 +150,16 @@ public:
      */
     void execute(RenderContext* pRenderContext);
 
+    /**
+     * Compile the program permutations the passes expect to use, before the graph is executed.
+     * The graph is compiled if needed. Permutations are collected from the passes (see RenderPass::collectProgramPermutations())
+     * and compiled concurrently.
+     * @param[in] pRenderContext The render context.
+     * @param[in] threadCount Number of compiler threads (0 = number of hardware threads).
+     * @return Compilation results per permutation.
+     */
+    std::vector<ProgramManager::PrecompileResult> precompilePrograms(RenderContext* pRenderContext, uint32_t threadCount = 0);
+
     /**
      * Update graph based on another graph's topology.
      */
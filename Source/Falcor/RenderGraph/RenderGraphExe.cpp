@@ -43,6 +43,15 @@ void RenderGraphExe::execute(const Context& ctx)
     }
 }
 
+void RenderGraphExe::collectProgramPermutations(const Context& ctx, std::vector<ProgramPermutation>& permutations)
+{
+    for (const auto& pass : mExecutionList)
+    {
+        RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
+        pass.pPass->collectProgramPermutations(ctx.pRenderContext, renderData, permutations);
+    }
+}
+
 void RenderGraphExe::renderUI(RenderContext* pRenderContext, Gui::Widgets& widget)
 {
     for (const auto& p : mExecutionList)
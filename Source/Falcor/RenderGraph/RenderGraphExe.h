@@ -59,6 +59,11 @@ public:
      */
     void execute(const Context& ctx);
 
+    /**
+     * Collect the program permutations of all passes in execution order.
+     */
+    void collectProgramPermutations(const Context& ctx, std::vector<ProgramPermutation>& permutations);
+
     /**
      * Render the UI
      */
@@ -46,7 +46,7 @@ const ref<Resource>& RenderData::getResource(const std::string_view name) const
 
 ref<Texture> RenderData::getTexture(const std::string_view name) const
 {
-    auto pResource = getResource(name);
+    const auto& pResource = getResource(name);
     return pResource ? pResource->asTexture() : nullptr;
 }
 
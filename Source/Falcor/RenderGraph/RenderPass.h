@@ -33,6 +33,7 @@
 #include "Core/HotReloadFlags.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
+#include "Core/Program/Program.h"
 #include "Scene/Scene.h"
 #include "Utils/Properties.h"
 #include "Utils/Dictionary.h"
@@ -42,6 +43,7 @@
 #include <memory>
 #include <string_view>
 #include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -216,6 +218,24 @@ public:
      */
     virtual void onSceneUpdates(RenderContext* pRenderContext, Scene::UpdateFlags sceneUpdates) {}
 
+    /**
+     * Collect the program permutations the pass expects to use.
+     * This function is called by RenderGraph::precompilePrograms() after graph compilation, so that programs can be
+     * compiled concurrently before the first call to execute(). The pass should report the programs with the defines
+     * and type conformances they will have in execute() for the current scene and options, and optionally variants
+     * it is likely to switch to at runtime. Passes whose defines depend on scene data that is prepared in execute()
+     * (e.g. light samplers) may prepare that data here using the render context.
+     * @param[in] pRenderContext Render context.
+     * @param[in] renderData Render data the pass will be executed with.
+     * @param[out] permutations List of permutations to append to.
+     */
+    virtual void collectProgramPermutations(
+        RenderContext* pRenderContext,
+        const RenderData& renderData,
+        std::vector<ProgramPermutation>& permutations
+    )
+    {}
+
     /**
      * Mouse event handler.
      * Returns true if the event was handled by the object, false otherwise
@@ -0,0 +1,134 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ConvergenceStats.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+ConvergenceStats::ConvergenceStats(uint2 frameDim, uint32_t tileSize) : mFrameDim(frameDim), mTileSize(tileSize)
+{
+    FALCOR_CHECK(tileSize > 0, "Tile size must be positive.");
+    reset();
+}
+
+void ConvergenceStats::addFrame(fstd::span<const float> luminance)
+{
+    FALCOR_CHECK(luminance.size() == mState.size(), "Expected {} pixels, got {}.", mState.size(), luminance.size());
+
+    mFrameCount++;
+    const float weight = 1.f / mFrameCount;
+    for (size_t i = 0; i < mState.size(); ++i)
+        mState[i] = updateRunningVariance(mState[i], luminance[i], weight);
+}
+
+void ConvergenceStats::reset()
+{
+    mFrameCount = 0;
+    mState.assign((size_t)mFrameDim.x * mFrameDim.y, float2(0.f));
+}
+
+std::vector<float> ConvergenceStats::computePixelErrors(float minLuminance) const
+{
+    std::vector<float> errors(mState.size());
+    for (size_t i = 0; i < mState.size(); ++i)
+        errors[i] = evalRelativeError(mState[i], mFrameCount, minLuminance);
+    return errors;
+}
+
+std::vector<float> ConvergenceStats::computeTileErrors(float minLuminance) const
+{
+    return computeTileErrors(mFrameDim, mTileSize, computePixelErrors(minLuminance));
+}
+
+ConvergenceResult ConvergenceStats::evaluate(const ConvergenceCriteria& criteria) const
+{
+    return evaluate(computeTileErrors(criteria.minLuminance), mFrameCount, criteria);
+}
+
+uint2 ConvergenceStats::getTileCount(uint2 frameDim, uint32_t tileSize)
+{
+    FALCOR_ASSERT(tileSize > 0);
+    return (frameDim + tileSize - 1u) / tileSize;
+}
+
+std::vector<float> ConvergenceStats::computeTileErrors(uint2 frameDim, uint32_t tileSize, fstd::span<const float> pixelErrors)
+{
+    FALCOR_CHECK(tileSize > 0, "Tile size must be positive.");
+    FALCOR_CHECK(pixelErrors.size() == (size_t)frameDim.x * frameDim.y, "Pixel error count does not match the frame dimensions.");
+
+    const uint2 tileCount = getTileCount(frameDim, tileSize);
+    std::vector<float> tileErrors((size_t)tileCount.x * tileCount.y);
+    for (uint32_t ty = 0; ty < tileCount.y; ++ty)
+    {
+        for (uint32_t tx = 0; tx < tileCount.x; ++tx)
+        {
+            const uint2 begin = uint2(tx, ty) * tileSize;
+            const uint2 end = min(begin + tileSize, frameDim);
+            double sum = 0.0;
+            for (uint32_t y = begin.y; y < end.y; ++y)
+            {
+                for (uint32_t x = begin.x; x < end.x; ++x)
+                {
+                    double e = pixelErrors[(size_t)y * frameDim.x + x];
+                    sum += e * e;
+                }
+            }
+            const uint32_t pixelCount = (end.x - begin.x) * (end.y - begin.y);
+            tileErrors[(size_t)ty * tileCount.x + tx] = (float)std::sqrt(sum / pixelCount);
+        }
+    }
+    return tileErrors;
+}
+
+ConvergenceResult ConvergenceStats::evaluate(fstd::span<const float> tileErrors, uint32_t frameCount, const ConvergenceCriteria& criteria)
+{
+    ConvergenceResult result;
+    result.frameCount = frameCount;
+    result.tileCount = (uint32_t)tileErrors.size();
+
+    double errorSum = 0.0;
+    for (float error : tileErrors)
+    {
+        // NaNs are never converged.
+        if (error <= criteria.targetRelError)
+            result.convergedTileCount++;
+        result.maxTileError = std::max(result.maxTileError, error);
+        errorSum += error;
+    }
+    if (result.tileCount > 0)
+        result.meanTileError = (float)(errorSum / result.tileCount);
+
+    // The variance estimate needs at least two frames.
+    const uint32_t minFrameCount = std::max(criteria.minFrameCount, 2u);
+    result.converged = result.tileCount > 0 && frameCount >= minFrameCount &&
+                       result.convergedTileCount >= criteria.convergedTileFraction * result.tileCount;
+    return result;
+}
+} // namespace Falcor
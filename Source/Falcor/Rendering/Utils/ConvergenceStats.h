@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "ConvergenceStats.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/// Criteria for deciding when an accumulated image has converged.
+struct ConvergenceCriteria
+{
+    float targetRelError = 0.01f;       ///< Tiles with an RMS relative error at or below this are converged.
+    uint32_t minFrameCount = 16;        ///< Minimum number of frames before the variance estimate is trusted.
+    float convergedTileFraction = 1.f;  ///< Fraction of tiles that must be converged for the image to be converged.
+    float minLuminance = 1e-3f;         ///< Lower bound for the mean luminance in the relative error. Must be positive.
+};
+
+/// Convergence state of an accumulated image.
+struct ConvergenceResult
+{
+    uint32_t frameCount = 0;         ///< Number of accumulated frames the result was computed for.
+    uint32_t tileCount = 0;          ///< Number of tiles.
+    uint32_t convergedTileCount = 0; ///< Number of converged tiles.
+    float maxTileError = 0.f;        ///< Maximum tile error.
+    float meanTileError = 0.f;       ///< Mean tile error.
+    bool converged = false;          ///< True if the image meets the convergence criteria.
+};
+
+/**
+ * Convergence tracking for accumulated renders.
+ *
+ * Each pixel keeps the running mean and variance of its luminance (see ConvergenceStats.slang), from which
+ * the relative standard error of the accumulated mean is estimated. Pixel errors are combined into tiles
+ * using the root mean square, and the image is converged when enough tiles are at or below the target error.
+ *
+ * This class is the CPU reference of the tracking in AccumulatePass, which updates the statistics on the GPU
+ * and evaluates the read back tile errors with evaluate().
+ */
+class FALCOR_API ConvergenceStats
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] frameDim Frame dimensions in pixels.
+     * @param[in] tileSize Tile size in pixels.
+     */
+    ConvergenceStats(uint2 frameDim, uint32_t tileSize);
+
+    /**
+     * Add a frame of samples.
+     * @param[in] luminance Luminance per pixel in scanline order.
+     */
+    void addFrame(fstd::span<const float> luminance);
+
+    /// Clear all statistics.
+    void reset();
+
+    /// Compute the relative error per pixel.
+    std::vector<float> computePixelErrors(float minLuminance) const;
+
+    /// Compute the error per tile.
+    std::vector<float> computeTileErrors(float minLuminance) const;
+
+    /// Evaluate the convergence criteria for the current frame.
+    ConvergenceResult evaluate(const ConvergenceCriteria& criteria) const;
+
+    uint2 getFrameDim() const { return mFrameDim; }
+    uint32_t getTileSize() const { return mTileSize; }
+    uint2 getTileCount() const { return getTileCount(mFrameDim, mTileSize); }
+    uint32_t getFrameCount() const { return mFrameCount; }
+
+    /// Get the number of tiles covering a frame. Tiles at the right and bottom border may be partial.
+    static uint2 getTileCount(uint2 frameDim, uint32_t tileSize);
+
+    /**
+     * Combine pixel errors into tile errors (root mean square of the pixels in each tile).
+     * @param[in] frameDim Frame dimensions in pixels.
+     * @param[in] tileSize Tile size in pixels.
+     * @param[in] pixelErrors Error per pixel in scanline order.
+     * @return Error per tile in scanline order.
+     */
+    static std::vector<float> computeTileErrors(uint2 frameDim, uint32_t tileSize, fstd::span<const float> pixelErrors);
+
+    /**
+     * Evaluate the convergence criteria.
+     * @param[in] tileErrors Error per tile.
+     * @param[in] frameCount Number of accumulated frames.
+     * @param[in] criteria Convergence criteria.
+     * @return Convergence result.
+     */
+    static ConvergenceResult evaluate(fstd::span<const float> tileErrors, uint32_t frameCount, const ConvergenceCriteria& criteria);
+
+private:
+    uint2 mFrameDim;
+    uint32_t mTileSize;
+    uint32_t mFrameCount = 0;
+    std::vector<float2> mState; ///< Mean and population variance of the luminance per pixel.
+};
+} // namespace Falcor
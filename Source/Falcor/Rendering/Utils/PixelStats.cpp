@@ -67,12 +67,9 @@ namespace Falcor
         // Prepare state.
         FALCOR_ASSERT(!mRunning);
         mRunning = true;
-        mWaitingForData = false;
         mFrameDim = frameDim;
 
-        // Mark previously stored data as invalid. The config may have changed, so this is the safe bet.
-        mStats = Stats();
-        mStatsValid = false;
+        // Mark previously stored buffers as invalid. The stats read back to the CPU stay valid until newer stats are available.
         mStatsBuffersValid = false;
         mRayCountTextureValid = false;
 
@@ -82,7 +79,7 @@ namespace Falcor
             if (!mpParallelReduction)
             {
                 mpParallelReduction = std::make_unique<ParallelReduction>(mpDevice);
-                mpReductionResult = mpDevice->createBuffer((kRayTypeCount + 3) * sizeof(uint4), ResourceBindFlags::None, MemoryType::ReadBack);
+                mpReductionReadback = ReadbackRing::create(mpDevice, (kRayTypeCount + 3) * sizeof(uint4));
             }
 
             // Prepare stats buffers.
@@ -105,6 +102,13 @@ namespace Falcor
             pRenderContext->clearUAV(mpStatsPathVertexCount->getUAV().get(), uint4(0, 0, 0, 0));
             pRenderContext->clearUAV(mpStatsVolumeLookupCount->getUAV().get(), uint4(0, 0, 0, 0));
         }
+        else
+        {
+            // Discard stats collected while enabled.
+            if (mpReductionReadback) mpReductionReadback->reset();
+            mStats = Stats();
+            mStatsValid = false;
+        }
     }
 
     void PixelStats::endFrame(RenderContext* pRenderContext)
@@ -114,24 +118,24 @@ namespace Falcor
 
         if (mEnabled)
         {
-            // Create fence first time we need it.
-            if (!mpFence) mpFence = mpDevice->createFence();
+            // Acquire a readback slot. If all slots are in flight, the oldest stats are dropped.
+            mpReductionReadback->beginWrite();
+            const ref<Buffer>& pResult = mpReductionReadback->getBuffer();
+            const uint64_t offset = mpReductionReadback->getWriteOffset();
 
             // Sum of the per-pixel counters. The results are copied to a GPU buffer.
             for (uint32_t i = 0; i < kRayTypeCount; i++)
             {
-                mpParallelReduction->execute<uint4>(pRenderContext, mpStatsRayCount[i], ParallelReduction::Type::Sum, nullptr, mpReductionResult, i * sizeof(uint4));
+                mpParallelReduction->execute<uint4>(pRenderContext, mpStatsRayCount[i], ParallelReduction::Type::Sum, nullptr, pResult, offset + i * sizeof(uint4));
             }
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathLength, ParallelReduction::Type::Sum, nullptr, mpReductionResult, kRayTypeCount * sizeof(uint4));
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathVertexCount, ParallelReduction::Type::Sum, nullptr, mpReductionResult, (kRayTypeCount + 1) * sizeof(uint4));
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsVolumeLookupCount, ParallelReduction::Type::Sum, nullptr, mpReductionResult, (kRayTypeCount + 2) * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathLength, ParallelReduction::Type::Sum, nullptr, pResult, offset + kRayTypeCount * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathVertexCount, ParallelReduction::Type::Sum, nullptr, pResult, offset + (kRayTypeCount + 1) * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsVolumeLookupCount, ParallelReduction::Type::Sum, nullptr, pResult, offset + (kRayTypeCount + 2) * sizeof(uint4));
 
-            // Submit command list and insert signal.
-            pRenderContext->submit(false);
-            pRenderContext->signal(mpFence.get());
+            // Submit command list and insert signal. The frame dimensions are stored as the tag for computing averages.
+            mpReductionReadback->endWrite(pRenderContext, ((uint64_t)mFrameDim.x << 32) | mFrameDim.y);
 
             mStatsBuffersValid = true;
-            mWaitingForData = true;
         }
     }
 
@@ -162,8 +166,8 @@ namespace Falcor
         widget.checkbox("Ray stats", mEnabled);
         widget.tooltip("Collects ray tracing traversal stats on the GPU.\nNote that this option slows down the performance.");
 
-        // Fetch data and show stats if available.
-        copyStatsToCPU();
+        // Fetch latest available data and show stats if available.
+        copyStatsToCPU(false);
         if (mStatsValid)
         {
             widget.text("Stats:");
@@ -198,7 +202,7 @@ namespace Falcor
 
     bool PixelStats::getStats(PixelStats::Stats& stats)
     {
-        copyStatsToCPU();
+        copyStatsToCPU(true);
         if (!mStatsValid)
         {
             logWarning("PixelStats::getStats() - Stats are not valid. Ignoring.");
@@ -260,42 +264,34 @@ namespace Falcor
         return mStatsBuffersValid ? mpStatsVolumeLookupCount : nullptr;
     }
 
-    void PixelStats::copyStatsToCPU()
+    void PixelStats::copyStatsToCPU(bool wait)
     {
         FALCOR_ASSERT(!mRunning);
-        if (mWaitingForData)
-        {
-            // Wait for signal.
-            mpFence->wait();
-            mWaitingForData = false;
+        if (!mEnabled || !mpReductionReadback) return;
 
-            if (mEnabled)
-            {
-                // Map the stats buffer.
-                const uint4* result = static_cast<const uint4*>(mpReductionResult->map(Buffer::MapType::Read));
-                FALCOR_ASSERT(result);
-
-                const uint32_t totalPathLength = result[kRayTypeCount].x;
-                const uint32_t totalPathVertices = result[kRayTypeCount + 1].x;
-                const uint32_t totalVolumeLookups = result[kRayTypeCount + 2].x;
-                const uint32_t numPixels = mFrameDim.x * mFrameDim.y;
-                FALCOR_ASSERT(numPixels > 0);
-
-                mStats.visibilityRays = result[(uint32_t)PixelStatsRayType::Visibility].x;
-                mStats.closestHitRays = result[(uint32_t)PixelStatsRayType::ClosestHit].x;
-                mStats.totalRays = mStats.visibilityRays + mStats.closestHitRays;
-                mStats.pathVertices = totalPathVertices;
-                mStats.volumeLookups = totalVolumeLookups;
-                mStats.avgVisibilityRays = (float)mStats.visibilityRays / numPixels;
-                mStats.avgClosestHitRays = (float)mStats.closestHitRays / numPixels;
-                mStats.avgTotalRays = (float)mStats.totalRays / numPixels;
-                mStats.avgPathLength = (float)totalPathLength / numPixels;
-                mStats.avgPathVertices = (float)totalPathVertices / numPixels;
-                mStats.avgVolumeLookups = (float)totalVolumeLookups / numPixels;
-
-                mpReductionResult->unmap();
-                mStatsValid = true;
-            }
+        uint4 result[kRayTypeCount + 3];
+        uint64_t tag = 0;
+        if (mpReductionReadback->readLatest(result, wait, &tag))
+        {
+            const uint32_t totalPathLength = result[kRayTypeCount].x;
+            const uint32_t totalPathVertices = result[kRayTypeCount + 1].x;
+            const uint32_t totalVolumeLookups = result[kRayTypeCount + 2].x;
+            const uint32_t numPixels = (uint32_t)(tag >> 32) * (uint32_t)(tag & 0xffffffff);
+            FALCOR_ASSERT(numPixels > 0);
+
+            mStats.visibilityRays = result[(uint32_t)PixelStatsRayType::Visibility].x;
+            mStats.closestHitRays = result[(uint32_t)PixelStatsRayType::ClosestHit].x;
+            mStats.totalRays = mStats.visibilityRays + mStats.closestHitRays;
+            mStats.pathVertices = totalPathVertices;
+            mStats.volumeLookups = totalVolumeLookups;
+            mStats.avgVisibilityRays = (float)mStats.visibilityRays / numPixels;
+            mStats.avgClosestHitRays = (float)mStats.closestHitRays / numPixels;
+            mStats.avgTotalRays = (float)mStats.totalRays / numPixels;
+            mStats.avgPathLength = (float)totalPathLength / numPixels;
+            mStats.avgPathVertices = (float)totalPathVertices / numPixels;
+            mStats.avgVolumeLookups = (float)totalVolumeLookups / numPixels;
+
+            mStatsValid = true;
         }
     }
 
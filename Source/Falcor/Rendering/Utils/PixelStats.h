@@ -30,7 +30,7 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 #include "Core/API/Texture.h"
-#include "Core/API/Fence.h"
+#include "Core/API/ReadbackRing.h"
 #include "Core/Pass/ComputePass.h"
 #include "Utils/UI/Gui.h"
 #include "Utils/Algorithm/ParallelReduction.h"
@@ -43,6 +43,8 @@ namespace Falcor
         Per-pixel stats are logged in buffers on the GPU, which are immediately ready for consumption
         after end() is called. These stats are summarized in a reduction pass, which are
         available in getStats() or printStats() after async readback to the CPU.
+        The readback uses a ring of staging buffers, so the UI shows the latest available stats
+        without stalling the GPU, while getStats() waits for the stats of the last frame.
     */
     class FALCOR_API PixelStats
     {
@@ -77,7 +79,7 @@ namespace Falcor
 
         void renderUI(Gui::Widgets& widget);
 
-        /** Fetches the latest stats generated by begin()/end().
+        /** Fetches the stats of the last frame generated by begin()/end(). This waits for the GPU if needed.
             \param[out] stats The stats are copied here.
             \return True if stats are available, false otherwise.
         */
@@ -105,7 +107,7 @@ namespace Falcor
         const ref<Texture> getVolumeLookupCountTexture() const;
 
     protected:
-        void copyStatsToCPU();
+        void copyStatsToCPU(bool wait);
         void computeRayCountTexture(RenderContext* pRenderContext);
 
         static const uint32_t kRayTypeCount = (uint32_t)PixelStatsRayType::Count;
@@ -114,8 +116,7 @@ namespace Falcor
 
         // Internal state
         std::unique_ptr<ParallelReduction>  mpParallelReduction;            ///< Helper for parallel reduction on the GPU.
-        ref<Buffer>                         mpReductionResult;              ///< Results buffer for stats readback (CPU mappable).
-        ref<Fence>                          mpFence;                        ///< GPU fence for sychronizing readback.
+        ref<ReadbackRing>                   mpReductionReadback;            ///< Readback ring for the reduction results.
 
         // Configuration
         bool                                mEnabled = false;               ///< Enable pixel statistics.
@@ -123,7 +124,6 @@ namespace Falcor
 
         // Runtime data
         bool                                mRunning = false;               ///< True inbetween begin() / end() calls.
-        bool                                mWaitingForData = false;        ///< True if we are waiting for data to become available on the GPU.
         uint2                               mFrameDim = { 0, 0 };           ///< Frame dimensions at last call to begin().
 
         bool                                mStatsValid = false;            ///< True if stats have been read back and are valid.
@@ -0,0 +1,409 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BinaryScene.h"
+#include "SceneBuilder.h"
+#include "SceneCache.h"
+#include "ImporterError.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+
+#include <lz4_stream/lz4_stream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <execution>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current binary scene version.
+            This needs to be incremented every time the file format changes!
+        */
+        const uint32_t kVersion = 1;
+
+        const size_t kBlockSize = 1 * 1024 * 1024;
+
+        /** Meshes are loaded in batches of roughly this size, bounding the amount of mesh data held in memory
+            in addition to the data already added to the builder.
+        */
+        const uint64_t kMeshBatchBytes = 256ull * 1024 * 1024;
+
+        /** Number of consecutive meshes read by a single task (using one file stream).
+        */
+        const size_t kMeshesPerTask = 64;
+
+        const char* kMagic = "FalcorB$";
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+
+            bool isValid() const
+            {
+                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
+            }
+        };
+
+        /** Mesh record in the scene description. The vertex and index data is stored in the mesh payload file.
+        */
+        struct MeshRecord
+        {
+            uint64_t payloadOffset = 0;     ///< Offset of the mesh data in the payload file.
+            uint64_t indexCount = 0;
+            uint64_t indexDataCount = 0;    ///< Number of 32-bit words of index data.
+            uint64_t staticDataCount = 0;
+            uint64_t skinningDataCount = 0;
+            uint32_t materialIndex = 0;     ///< Index into the materials of the binary scene.
+            uint32_t topology = 0;
+            NodeID skeletonNodeID{ NodeID::Invalid() };
+            uint32_t flags = 0;
+
+            static constexpr uint32_t kUse16BitIndices = 0x1;
+            static constexpr uint32_t kIsFrontFaceCW = 0x2;
+            static constexpr uint32_t kIsAnimated = 0x4;
+
+            uint64_t getPayloadSize() const
+            {
+                return indexDataCount * sizeof(uint32_t) + staticDataCount * sizeof(StaticVertexData) + skinningDataCount * sizeof(SkinningVertexData);
+            }
+        };
+
+        template<typename T>
+        bool readVector(std::istream& fs, std::vector<T>& vec, uint64_t count)
+        {
+            vec.resize(count);
+            fs.read(reinterpret_cast<char*>(vec.data()), count * sizeof(T));
+            return !fs.fail();
+        }
+
+        template<typename T>
+        void writeVector(std::ostream& fs, const std::vector<T>& vec)
+        {
+            fs.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(T));
+        }
+    }
+
+    void BinaryScene::write(SceneBuilder& builder, const std::filesystem::path& path)
+    {
+        // Textures requested with loadMaterialTexture() are assigned to the materials when loading finishes.
+        builder.waitForMaterialTextureLoading();
+
+        const auto& sceneData = builder.mSceneData;
+
+        auto warnSkipped = [&](size_t count, const char* what)
+        {
+            if (count > 0) logWarning("Binary scene export skips {} {} (not supported by the format).", count, what);
+        };
+        warnSkipped(builder.mCurves.size(), "curve(s)");
+        warnSkipped(sceneData.sdfGrids.size(), "SDF grid(s)");
+        warnSkipped(sceneData.gridVolumes.size(), "grid volume(s)");
+        warnSkipped(sceneData.customPrimitiveDesc.size(), "custom primitive(s)");
+        warnSkipped(sceneData.cachedMeshes.size() + sceneData.cachedCurves.size(), "vertex cache(s)");
+
+        for (const auto& pMaterial : sceneData.pMaterials->getMaterials())
+        {
+            auto type = pMaterial->getType();
+            if (type != MaterialType::Standard && type != MaterialType::Hair && type != MaterialType::Cloth)
+            {
+                FALCOR_THROW("Material '{}' of type '{}' is not supported by the binary scene format.", pMaterial->getName(), to_string(type));
+            }
+        }
+
+        std::filesystem::create_directories(path.parent_path());
+
+        // Write mesh payloads.
+        const auto payloadPath = getMeshPayloadPath(path);
+        std::vector<MeshRecord> meshRecords(builder.mMeshes.size());
+        {
+            std::ofstream fs(payloadPath, std::ios_base::binary);
+            if (!fs.is_open()) FALCOR_THROW("Failed to create mesh payload file '{}'.", payloadPath);
+
+            uint64_t offset = 0;
+            for (size_t i = 0; i < builder.mMeshes.size(); ++i)
+            {
+                const auto& mesh = builder.mMeshes[i];
+                auto& record = meshRecords[i];
+                record.payloadOffset = offset;
+                record.indexCount = mesh.indexCount;
+                record.indexDataCount = mesh.indexData.size();
+                record.staticDataCount = mesh.staticData.size();
+                record.skinningDataCount = mesh.skinningData.size();
+                record.materialIndex = mesh.materialId.get();
+                record.topology = (uint32_t)mesh.topology;
+                record.skeletonNodeID = mesh.skeletonNodeID;
+                if (mesh.use16BitIndices) record.flags |= MeshRecord::kUse16BitIndices;
+                if (mesh.isFrontFaceCW) record.flags |= MeshRecord::kIsFrontFaceCW;
+                if (mesh.isAnimated) record.flags |= MeshRecord::kIsAnimated;
+
+                writeVector(fs, mesh.indexData);
+                writeVector(fs, mesh.staticData);
+                writeVector(fs, mesh.skinningData);
+                offset += record.getPayloadSize();
+            }
+
+            if (fs.fail()) FALCOR_THROW("Failed to write mesh payload file '{}'.", payloadPath);
+        }
+
+        // Write scene description.
+        std::ofstream fs(path, std::ios_base::binary);
+        if (!fs.is_open()) FALCOR_THROW("Failed to create binary scene file '{}'.", path);
+
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+        header.version = kVersion;
+        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        {
+            lz4_stream::basic_ostream<kBlockSize> zs(fs);
+            SceneCache::OutputStream stream(zs);
+
+            SceneCache::writeMarker(stream, "Settings");
+            stream.write(sceneData.renderSettings);
+            stream.write(sceneData.cameraSpeed);
+            SceneCache::writeMetadata(stream, sceneData.metadata);
+
+            SceneCache::writeMarker(stream, "Nodes");
+            stream.write((uint32_t)builder.mSceneGraph.size());
+            for (const auto& node : builder.mSceneGraph)
+            {
+                stream.write(node.name);
+                stream.write(node.transform);
+                stream.write(node.meshBind);
+                stream.write(node.localToBindPose);
+                stream.write(node.parent);
+            }
+
+            SceneCache::writeMarker(stream, "Materials");
+            SceneCache::writeMaterials(stream, *sceneData.pMaterials);
+
+            SceneCache::writeMarker(stream, "Cameras");
+            stream.write((uint32_t)sceneData.cameras.size());
+            for (const auto& pCamera : sceneData.cameras) SceneCache::writeCamera(stream, pCamera);
+            stream.write(sceneData.selectedCamera);
+
+            SceneCache::writeMarker(stream, "Lights");
+            stream.write((uint32_t)sceneData.lights.size());
+            for (const auto& pLight : sceneData.lights) SceneCache::writeLight(stream, pLight);
+
+            SceneCache::writeMarker(stream, "EnvMap");
+            bool hasEnvMap = sceneData.pEnvMap != nullptr;
+            stream.write(hasEnvMap);
+            if (hasEnvMap) SceneCache::writeEnvMap(stream, sceneData.pEnvMap);
+
+            SceneCache::writeMarker(stream, "Animations");
+            stream.write((uint32_t)sceneData.animations.size());
+            for (const auto& pAnimation : sceneData.animations) SceneCache::writeAnimation(stream, pAnimation);
+
+            SceneCache::writeMarker(stream, "Meshes");
+            stream.write(payloadPath.filename());
+            stream.write((uint32_t)builder.mMeshes.size());
+            for (size_t i = 0; i < builder.mMeshes.size(); ++i)
+            {
+                const auto& mesh = builder.mMeshes[i];
+                stream.write(mesh.name);
+                stream.write(meshRecords[i]);
+                std::vector<NodeID> instances(mesh.instances.begin(), mesh.instances.end());
+                stream.write(instances);
+            }
+
+            SceneCache::writeMarker(stream, "End");
+        }
+
+        if (fs.fail()) FALCOR_THROW("Failed to write binary scene file '{}'.", path);
+    }
+
+    void BinaryScene::read(const std::filesystem::path& path, SceneBuilder& builder)
+    {
+        std::ifstream fs(path, std::ios_base::binary);
+        if (!fs.is_open()) throw ImporterError(path, "Failed to open binary scene file.");
+
+        Header header;
+        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (fs.fail() || !header.isValid()) throw ImporterError(path, "Invalid header or unsupported version in binary scene file.");
+
+        builder.reportProgress("Reading scene description");
+
+        lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
+        SceneCache::InputStream stream(zs);
+        ref<Device> pDevice = builder.getDevice();
+
+        // Node IDs in the file are relative to the first node of the binary scene.
+        const uint32_t nodeOffset = builder.getNodeCount();
+        auto remapNodeID = [nodeOffset](NodeID nodeID) { return nodeID.isValid() ? NodeID(nodeID.get() + nodeOffset) : nodeID; };
+
+        SceneCache::readMarker(stream, "Settings");
+        builder.setRenderSettings(stream.read<Scene::RenderSettings>());
+        builder.setCameraSpeed(stream.read<float>());
+        builder.setMetadata(SceneCache::readMetadata(stream));
+
+        SceneCache::readMarker(stream, "Nodes");
+        uint32_t nodeCount = stream.read<uint32_t>();
+        for (uint32_t i = 0; i < nodeCount; ++i)
+        {
+            SceneBuilder::Node node;
+            stream.read(node.name);
+            stream.read(node.transform);
+            stream.read(node.meshBind);
+            stream.read(node.localToBindPose);
+            node.parent = remapNodeID(stream.read<NodeID>());
+            builder.addNode(node);
+        }
+
+        SceneCache::readMarker(stream, "Materials");
+        std::vector<ref<Material>> materials(stream.read<uint32_t>());
+        for (auto& pMaterial : materials)
+        {
+            pMaterial = SceneCache::readMaterial(stream, builder.getMaterialTextureLoader(), pDevice);
+            builder.addMaterial(pMaterial);
+        }
+
+        SceneCache::readMarker(stream, "Cameras");
+        std::vector<ref<Camera>> cameras(stream.read<uint32_t>());
+        for (auto& pCamera : cameras)
+        {
+            pCamera = SceneCache::readCamera(stream);
+            pCamera->setNodeID(remapNodeID(pCamera->getNodeID()));
+            builder.addCamera(pCamera);
+        }
+        uint32_t selectedCamera = stream.read<uint32_t>();
+        if (selectedCamera < cameras.size()) builder.setSelectedCamera(cameras[selectedCamera]);
+
+        SceneCache::readMarker(stream, "Lights");
+        uint32_t lightCount = stream.read<uint32_t>();
+        for (uint32_t i = 0; i < lightCount; ++i)
+        {
+            auto pLight = SceneCache::readLight(stream);
+            pLight->setNodeID(remapNodeID(pLight->getNodeID()));
+            builder.addLight(pLight);
+        }
+
+        SceneCache::readMarker(stream, "EnvMap");
+        if (stream.read<bool>()) builder.setEnvMap(SceneCache::readEnvMap(stream, pDevice));
+
+        SceneCache::readMarker(stream, "Animations");
+        uint32_t animationCount = stream.read<uint32_t>();
+        for (uint32_t i = 0; i < animationCount; ++i)
+        {
+            auto pAnimation = SceneCache::readAnimation(stream);
+            pAnimation->setNodeID(remapNodeID(pAnimation->getNodeID()));
+            builder.addAnimation(pAnimation);
+        }
+
+        SceneCache::readMarker(stream, "Meshes");
+        const auto payloadPath = path.parent_path() / stream.read<std::filesystem::path>();
+        const uint32_t meshCount = stream.read<uint32_t>();
+        std::vector<std::string> meshNames(meshCount);
+        std::vector<MeshRecord> meshRecords(meshCount);
+        std::vector<std::vector<NodeID>> meshInstances(meshCount);
+        for (uint32_t i = 0; i < meshCount; ++i)
+        {
+            stream.read(meshNames[i]);
+            stream.read(meshRecords[i]);
+            stream.read(meshInstances[i]);
+            if (meshRecords[i].materialIndex >= materials.size()) throw ImporterError(path, "Mesh '{}' references an invalid material.", meshNames[i]);
+        }
+
+        SceneCache::readMarker(stream, "End");
+        if (fs.bad()) throw ImporterError(path, "Failed to read binary scene file.");
+
+        // Load mesh payloads. Batches of meshes are read in parallel and then added to the builder in order.
+        std::vector<SceneBuilder::ProcessedMesh> batch;
+        for (uint32_t first = 0; first < meshCount;)
+        {
+            uint32_t last = first;
+            uint64_t batchBytes = 0;
+            while (last < meshCount && (last == first || batchBytes + meshRecords[last].getPayloadSize() <= kMeshBatchBytes))
+            {
+                batchBytes += meshRecords[last++].getPayloadSize();
+            }
+
+            batch.clear();
+            batch.resize(last - first);
+
+            std::atomic<bool> failed{false};
+            size_t taskCount = (batch.size() + kMeshesPerTask - 1) / kMeshesPerTask;
+            auto range = NumericRange<size_t>(0, taskCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t task)
+            {
+                std::ifstream payload(payloadPath, std::ios_base::binary);
+                size_t end = std::min(batch.size(), (task + 1) * kMeshesPerTask);
+                for (size_t i = task * kMeshesPerTask; i < end && payload.is_open(); ++i)
+                {
+                    const auto& record = meshRecords[first + i];
+                    auto& mesh = batch[i];
+                    payload.seekg(record.payloadOffset);
+                    if (!readVector(payload, mesh.indexData, record.indexDataCount) ||
+                        !readVector(payload, mesh.staticData, record.staticDataCount) ||
+                        !readVector(payload, mesh.skinningData, record.skinningDataCount))
+                    {
+                        break;
+                    }
+
+                    for (auto& v : mesh.skinningData)
+                    {
+                        for (uint32_t j = 0; j < 4; ++j) v.boneID[j] = remapNodeID(NodeID(v.boneID[j])).get();
+                        v.bindMatrixID = remapNodeID(NodeID(v.bindMatrixID)).get();
+                        v.skeletonMatrixID = remapNodeID(NodeID(v.skeletonMatrixID)).get();
+                    }
+                }
+                if (!payload.is_open() || payload.fail()) failed = true;
+            });
+            if (failed) throw ImporterError(path, "Failed to read mesh payload file '{}'.", payloadPath);
+
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                const auto& record = meshRecords[first + i];
+                auto& mesh = batch[i];
+                mesh.name = std::move(meshNames[first + i]);
+                mesh.topology = (Vao::Topology)record.topology;
+                mesh.pMaterial = materials[record.materialIndex];
+                mesh.skeletonNodeId = remapNodeID(record.skeletonNodeID);
+                mesh.indexCount = record.indexCount;
+                mesh.use16BitIndices = (record.flags & MeshRecord::kUse16BitIndices) != 0;
+                mesh.isFrontFaceCW = (record.flags & MeshRecord::kIsFrontFaceCW) != 0;
+                mesh.isAnimated = (record.flags & MeshRecord::kIsAnimated) != 0;
+
+                MeshID meshID = builder.addProcessedMesh(mesh);
+                for (NodeID nodeID : meshInstances[first + i]) builder.addMeshInstance(remapNodeID(nodeID), meshID);
+            }
+
+            first = last;
+            builder.reportProgress("Loading meshes", (float)first / meshCount);
+        }
+    }
+
+    std::filesystem::path BinaryScene::getMeshPayloadPath(const std::filesystem::path& path)
+    {
+        auto payloadPath = path;
+        payloadPath += ".meshes";
+        return payloadPath;
+    }
+}
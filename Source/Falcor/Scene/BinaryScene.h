@@ -0,0 +1,74 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <filesystem>
+
+namespace Falcor
+{
+    class SceneBuilder;
+
+    /** Binary scene description format.
+
+        A binary scene stores the contents of a SceneBuilder before the scene is finalized: scene graph nodes,
+        materials, meshes and their instances, cameras, lights, the environment map, animations and scene settings.
+        Loading it issues the same SceneBuilder calls an importer would, so build flags apply as usual and a binary
+        scene can replace a slow-to-execute `.pyscene` file.
+
+        The format consists of two files:
+        - `<name>.fscene` holds the scene description (lz4 compressed).
+        - `<name>.fscene.meshes` holds the uncompressed mesh payloads, which are read in parallel.
+        Textures and environment maps are referenced by path.
+
+        Curves, SDF grids, grid volumes, custom primitives and vertex caches are not supported yet and are skipped on export.
+    */
+    class FALCOR_API BinaryScene
+    {
+    public:
+        static constexpr const char* kExtension = "fscene";
+
+        /** Write the contents of a scene builder to a binary scene.
+            Pending material texture loads are completed first, since textures are only assigned to the materials when loading finishes.
+            Throws if the file cannot be written or the builder contains materials that cannot be serialized.
+            \param[in] builder Scene builder.
+            \param[in] path File path of the binary scene.
+        */
+        static void write(SceneBuilder& builder, const std::filesystem::path& path);
+
+        /** Read a binary scene and add its contents to a scene builder.
+            Throws an ImporterError if the file is invalid.
+            \param[in] path File path of the binary scene.
+            \param[in] builder Scene builder.
+        */
+        static void read(const std::filesystem::path& path, SceneBuilder& builder);
+
+        /** Get the path of the mesh payload file belonging to a binary scene.
+        */
+        static std::filesystem::path getMeshPayloadPath(const std::filesystem::path& path);
+    };
+}
@@ -0,0 +1,216 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlasBuildPlanner.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+/// Number of steps when searching for the split of the budget into result and scratch capacity.
+const uint32_t kCapacitySplitSteps = 16;
+
+bool isBetter(const BlasBuildPlanner::Plan& a, const BlasBuildPlanner::Plan& b)
+{
+    if (a.groups.size() != b.groups.size())
+        return a.groups.size() < b.groups.size();
+    return a.getIntermediateBytes() < b.getIntermediateBytes();
+}
+} // namespace
+
+bool BlasBuildPlanner::shouldCompact(CompactionMode mode, bool isDynamic, bool isRebuilt)
+{
+    switch (mode)
+    {
+    case CompactionMode::Auto:
+        return !isDynamic || !isRebuilt;
+    case CompactionMode::Disabled:
+        return false;
+    default:
+        FALCOR_UNREACHABLE();
+        return false;
+    }
+}
+
+BlasBuildPlanner::BlasBuildPlanner(const Config& config) : mConfig(config)
+{
+    FALCOR_CHECK(mConfig.memoryBudget > 0, "'memoryBudget' must be non-zero.");
+    FALCOR_CHECK(mConfig.compactionRatio > 0.f && mConfig.compactionRatio <= 1.f, "'compactionRatio' must be in (0, 1].");
+}
+
+BlasBuildPlanner::Plan BlasBuildPlanner::plan(const std::vector<Item>& items) const
+{
+    for (const auto& item : items)
+        FALCOR_CHECK(item.resultByteSize > 0 && item.scratchByteSize > 0, "BLAS result and scratch sizes must be non-zero.");
+
+    if (items.empty())
+        return {};
+
+    if (mConfig.strategy == Strategy::InOrder)
+        return finalizePlan(items, packInOrder(items));
+
+    // The result and scratch buffers have to fit the largest item of each kind. If the budget is too small
+    // for that, it is raised to the smallest possible intermediate memory.
+    uint64_t maxResult = 0;
+    uint64_t maxScratch = 0;
+    uint64_t sumResult = 0;
+    uint64_t sumScratch = 0;
+    for (const auto& item : items)
+    {
+        maxResult = std::max(maxResult, item.resultByteSize);
+        maxScratch = std::max(maxScratch, item.scratchByteSize);
+        sumResult += item.resultByteSize;
+        sumScratch += item.scratchByteSize;
+    }
+    const uint64_t budget = std::max(mConfig.memoryBudget, maxResult + maxScratch);
+    const uint64_t slack = budget - maxResult - maxScratch;
+
+    // Candidate result capacities: evenly spaced splits of the slack, plus the split proportional to the total sizes.
+    std::vector<uint64_t> resultCapacities;
+    for (uint32_t i = 0; i <= kCapacitySplitSteps; ++i)
+        resultCapacities.push_back(maxResult + (uint64_t)((double)slack * i / kCapacitySplitSteps));
+    uint64_t proportional = (uint64_t)((double)budget * sumResult / (double)(sumResult + sumScratch));
+    resultCapacities.push_back(std::clamp(proportional, maxResult, budget - maxScratch));
+
+    Plan best;
+    for (uint64_t resultCapacity : resultCapacities)
+    {
+        Plan candidate = finalizePlan(items, packBins(items, resultCapacity, budget - resultCapacity));
+        if (best.groups.empty() || isBetter(candidate, best))
+            best = std::move(candidate);
+    }
+    return best;
+}
+
+std::vector<BlasBuildPlanner::Group> BlasBuildPlanner::packInOrder(const std::vector<Item>& items) const
+{
+    std::vector<Group> groups;
+    uint64_t groupSize = 0;
+
+    for (uint32_t i = 0; i < items.size(); ++i)
+    {
+        uint64_t itemSize = items[i].resultByteSize + items[i].scratchByteSize;
+
+        // Start a new group on the first item or if the group size would exceed the budget.
+        if (groupSize == 0 || groupSize + itemSize > mConfig.memoryBudget)
+        {
+            groups.push_back({});
+            groupSize = 0;
+        }
+        groups.back().items.push_back(i);
+        groupSize += itemSize;
+    }
+    return groups;
+}
+
+std::vector<BlasBuildPlanner::Group> BlasBuildPlanner::packBins(
+    const std::vector<Item>& items,
+    uint64_t resultCapacity,
+    uint64_t scratchCapacity
+) const
+{
+    FALCOR_ASSERT(resultCapacity > 0 && scratchCapacity > 0);
+
+    // Sort items by their largest relative size in decreasing order (first-fit decreasing).
+    std::vector<double> keys(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        keys[i] = std::max(
+            (double)items[i].resultByteSize / (double)resultCapacity, (double)items[i].scratchByteSize / (double)scratchCapacity
+        );
+    }
+    std::vector<uint32_t> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    // Place each item into the first group it fits into.
+    std::vector<Group> groups;
+    for (uint32_t i : order)
+    {
+        const auto& item = items[i];
+        auto it = std::find_if(
+            groups.begin(),
+            groups.end(),
+            [&](const Group& group)
+            {
+                return group.resultByteSize + item.resultByteSize <= resultCapacity &&
+                       group.scratchByteSize + item.scratchByteSize <= scratchCapacity;
+            }
+        );
+        if (it == groups.end())
+            it = groups.insert(groups.end(), Group{});
+        it->items.push_back(i);
+        it->resultByteSize += item.resultByteSize;
+        it->scratchByteSize += item.scratchByteSize;
+    }
+    return groups;
+}
+
+BlasBuildPlanner::Plan BlasBuildPlanner::finalizePlan(const std::vector<Item>& items, std::vector<Group> groups) const
+{
+    // Keep items in scene order within groups, and order groups by their first item.
+    for (auto& group : groups)
+        std::sort(group.items.begin(), group.items.end());
+    std::sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) { return a.items.front() < b.items.front(); });
+
+    Plan plan;
+    plan.itemGroups.resize(items.size());
+    plan.resultByteOffsets.resize(items.size());
+    plan.scratchByteOffsets.resize(items.size());
+
+    for (uint32_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex)
+    {
+        auto& group = groups[groupIndex];
+        group.resultByteSize = 0;
+        group.scratchByteSize = 0;
+
+        for (uint32_t i : group.items)
+        {
+            const auto& item = items[i];
+            plan.itemGroups[i] = groupIndex;
+            plan.resultByteOffsets[i] = group.resultByteSize;
+            plan.scratchByteOffsets[i] = group.scratchByteSize;
+            group.resultByteSize += item.resultByteSize;
+            group.scratchByteSize += item.scratchByteSize;
+
+            plan.predictedFinalBytes +=
+                item.useCompaction ? (uint64_t)((double)item.resultByteSize * mConfig.compactionRatio) : item.resultByteSize;
+        }
+
+        plan.resultBufferSize = std::max(plan.resultBufferSize, group.resultByteSize);
+        plan.scratchBufferSize = std::max(plan.scratchBufferSize, group.scratchByteSize);
+    }
+
+    // The result and scratch buffers are alive during the whole build, final buffers are allocated per group and kept.
+    plan.predictedPeakBytes = plan.getIntermediateBytes() + plan.predictedFinalBytes;
+    plan.groups = std::move(groups);
+    return plan;
+}
+} // namespace Falcor
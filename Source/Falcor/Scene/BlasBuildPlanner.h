@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Planner splitting BLAS builds into groups to limit the memory used during the build.
+ *
+ * The BLASes of a group are built together into a shared result buffer using a shared scratch buffer,
+ * then compacted or cloned into a final buffer per group. The result and scratch buffers are reused for
+ * all groups and are therefore sized for the largest group, so the peak memory during the build is
+ * the largest group result size plus the largest group scratch size plus the size of all final BLASes.
+ *
+ * With the BinPacking strategy the memory budget is split into a result and a scratch capacity, and
+ * BLASes are packed into groups with first-fit decreasing. Several splits are tried, the plan with the
+ * fewest groups and then the lowest intermediate memory is chosen. This keeps the intermediate memory
+ * within the budget, unlike filling groups in scene order where the largest result and the largest
+ * scratch size can come from different groups.
+ *
+ * The planner only works on sizes and is testable on the CPU.
+ */
+class FALCOR_API BlasBuildPlanner
+{
+public:
+    enum class Strategy
+    {
+        InOrder,    ///< Fill groups in scene order.
+        BinPacking, ///< Pack groups by result and scratch size.
+    };
+
+    enum class CompactionMode
+    {
+        Auto,     ///< Compact all BLASes except dynamic ones that are rebuilt on update.
+        Disabled, ///< Never compact.
+    };
+
+    struct Config
+    {
+        uint64_t memoryBudget = 1ull << 29;              ///< Target for result plus scratch memory. BLASes that do not fit on their own exceed it.
+        Strategy strategy = Strategy::BinPacking;        ///< Grouping strategy.
+        CompactionMode compaction = CompactionMode::Auto; ///< Compaction policy.
+        float compactionRatio = 0.5f;                    ///< Expected ratio of compacted to result size, used to predict the final memory.
+    };
+
+    /// Sizes of a single BLAS build, including padding.
+    struct Item
+    {
+        uint64_t resultByteSize = 0;
+        uint64_t scratchByteSize = 0;
+        bool useCompaction = false;
+    };
+
+    struct Group
+    {
+        std::vector<uint32_t> items; ///< Items in the group, in increasing order.
+        uint64_t resultByteSize = 0; ///< Sum of result sizes of all items in the group.
+        uint64_t scratchByteSize = 0; ///< Sum of scratch sizes of all items in the group.
+    };
+
+    struct Plan
+    {
+        std::vector<Group> groups;
+        std::vector<uint32_t> itemGroups;          ///< Group index per item.
+        std::vector<uint64_t> resultByteOffsets;   ///< Offset in the result buffer per item.
+        std::vector<uint64_t> scratchByteOffsets;  ///< Offset in the scratch buffer per item.
+
+        uint64_t resultBufferSize = 0;     ///< Required result buffer size (largest group).
+        uint64_t scratchBufferSize = 0;    ///< Required scratch buffer size (largest group).
+        uint64_t predictedFinalBytes = 0;  ///< Predicted size of all final BLASes.
+        uint64_t predictedPeakBytes = 0;   ///< Predicted peak memory during the build.
+
+        uint64_t getIntermediateBytes() const { return resultBufferSize + scratchBufferSize; }
+    };
+
+    /**
+     * Decide if a BLAS should be compacted.
+     * Dynamic BLASes that are rebuilt on update are never compacted, as they are rebuilt in place into their final buffer.
+     * @param[in] mode Compaction mode.
+     * @param[in] isDynamic True if the BLAS has dynamic geometry.
+     * @param[in] isRebuilt True if the BLAS is rebuilt instead of refit on update.
+     */
+    static bool shouldCompact(CompactionMode mode, bool isDynamic, bool isRebuilt);
+
+    BlasBuildPlanner(const Config& config);
+
+    /**
+     * Plan the BLAS build.
+     * @param[in] items Sizes of all BLASes. All sizes must be non-zero.
+     * @return The plan.
+     */
+    Plan plan(const std::vector<Item>& items) const;
+
+    const Config& getConfig() const { return mConfig; }
+
+private:
+    std::vector<Group> packInOrder(const std::vector<Item>& items) const;
+    std::vector<Group> packBins(const std::vector<Item>& items, uint64_t resultCapacity, uint64_t scratchCapacity) const;
+    Plan finalizePlan(const std::vector<Item>& items, std::vector<Group> groups) const;
+
+    Config mConfig;
+};
+} // namespace Falcor
@@ -46,6 +46,14 @@ namespace Falcor
         return extensions;
     }
 
+    bool Importer::isCpuOnly(std::string_view extension, const PluginManager& pm)
+    {
+        for (const auto& [type, info] : pm.getInfos<Importer>())
+            if (std::find(info.extensions.begin(), info.extensions.end(), extension) != info.extensions.end())
+                return info.cpuOnly;
+        return false;
+    }
+
     void Importer::importSceneFromMemory(const void* buffer, size_t byteSize, std::string_view extension, SceneBuilder& builder, const std::map<std::string, std::string>& materialToShortName)
     {
         FALCOR_THROW("Not implemented.");
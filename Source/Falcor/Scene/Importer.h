@@ -52,6 +52,7 @@ namespace Falcor
         {
             std::string desc; ///< Importer description.
             std::vector<std::string> extensions; ///< List of handled file extensions.
+            bool cpuOnly = false; ///< True if importing does no GPU work, so it can run on a worker thread (see SceneBuilder::importFile()).
         };
 
         FALCOR_PLUGIN_BASE_CLASS(Importer);
@@ -88,5 +89,12 @@ namespace Falcor
         /** Return a list of supported file extensions by the current set of loaded importer plugins.
         */
         static std::vector<std::string> getSupportedExtensions(const PluginManager& pm = PluginManager::instance());
+
+        /** Check if the importer for the given file extension does no GPU work (see PluginInfo::cpuOnly).
+            \param extension File extension.
+            \param pm Plugin manager.
+            \return Returns true if a compatible importer was found and it does no GPU work.
+        */
+        static bool isCpuOnly(std::string_view extension, const PluginManager& pm = PluginManager::instance());
     };
 }
@@ -0,0 +1,192 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneIDs.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Set of scene graph nodes instancing a mesh or curve.
+ *
+ * The node IDs are stored in a sorted flat array together with a 64-bit signature,
+ * which is an order-independent hash of the IDs that is updated incrementally.
+ * Comparing two lists first compares the signatures, so lists can be used as hash map
+ * keys without being compared node by node, which keeps grouping of meshes by their
+ * instances roughly linear in the total number of instances.
+ *
+ * Inserting IDs in increasing order (the common case when building a scene) is O(1),
+ * other insertions and removals are linear in the size of the list.
+ */
+class InstanceList
+{
+public:
+    using const_iterator = std::vector<NodeID>::const_iterator;
+    using const_reverse_iterator = std::vector<NodeID>::const_reverse_iterator;
+
+    InstanceList() = default;
+
+    /**
+     * Insert a node.
+     * @param[in] nodeID Node ID.
+     * @return True if the node was inserted, false if it was already in the list.
+     */
+    bool insert(NodeID nodeID)
+    {
+        if (mNodeIDs.empty() || mNodeIDs.back() < nodeID)
+        {
+            mNodeIDs.push_back(nodeID);
+        }
+        else
+        {
+            auto it = std::lower_bound(mNodeIDs.begin(), mNodeIDs.end(), nodeID);
+            if (*it == nodeID)
+                return false;
+            mNodeIDs.insert(it, nodeID);
+        }
+        mSignature += hashNodeID(nodeID);
+        return true;
+    }
+
+    /**
+     * Remove a node.
+     * @param[in] nodeID Node ID.
+     * @return True if the node was removed, false if it was not in the list.
+     */
+    bool erase(NodeID nodeID)
+    {
+        auto it = std::lower_bound(mNodeIDs.begin(), mNodeIDs.end(), nodeID);
+        if (it == mNodeIDs.end() || *it != nodeID)
+            return false;
+        mNodeIDs.erase(it);
+        mSignature -= hashNodeID(nodeID);
+        return true;
+    }
+
+    bool contains(NodeID nodeID) const { return std::binary_search(mNodeIDs.begin(), mNodeIDs.end(), nodeID); }
+
+    void clear()
+    {
+        mNodeIDs.clear();
+        mSignature = 0;
+    }
+
+    void reserve(size_t count) { mNodeIDs.reserve(count); }
+
+    size_t size() const { return mNodeIDs.size(); }
+    bool empty() const { return mNodeIDs.empty(); }
+
+    const_iterator begin() const { return mNodeIDs.begin(); }
+    const_iterator end() const { return mNodeIDs.end(); }
+    const_iterator cbegin() const { return mNodeIDs.cbegin(); }
+    const_iterator cend() const { return mNodeIDs.cend(); }
+    const_reverse_iterator rbegin() const { return mNodeIDs.rbegin(); }
+    const_reverse_iterator rend() const { return mNodeIDs.rend(); }
+
+    NodeID operator[](size_t index) const { return mNodeIDs[index]; }
+
+    /// Get the sorted node IDs.
+    const std::vector<NodeID>& getNodeIDs() const { return mNodeIDs; }
+
+    /// Get the signature of the list. Equal lists have equal signatures.
+    uint64_t getSignature() const { return mSignature; }
+
+    bool operator==(const InstanceList& other) const { return mSignature == other.mSignature && mNodeIDs == other.mNodeIDs; }
+    bool operator!=(const InstanceList& other) const { return !(*this == other); }
+
+private:
+    static uint64_t hashNodeID(NodeID nodeID)
+    {
+        // splitmix64 finalizer.
+        uint64_t x = nodeID.get() + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    std::vector<NodeID> mNodeIDs;
+    uint64_t mSignature = 0;
+};
+
+/**
+ * Groups items (e.g. meshes) with identical instance lists.
+ *
+ * Groups are kept in the order in which they were first encountered. The instance lists are
+ * referenced, not copied, and must stay alive and unchanged while the grouping is in use.
+ */
+template<typename T>
+class InstanceListGroups
+{
+public:
+    /**
+     * Add an item to the group with the given instance list.
+     * @param[in] instances Instance list of the item.
+     * @param[in] item Item to add.
+     * @return Index of the group the item was added to.
+     */
+    size_t add(const InstanceList& instances, T item)
+    {
+        auto [it, inserted] = mGroupIndices.try_emplace(&instances, mGroups.size());
+        if (inserted)
+            mGroups.emplace_back();
+        mGroups[it->second].push_back(item);
+        return it->second;
+    }
+
+    /// Get the groups of items.
+    const std::vector<std::vector<T>>& getGroups() const { return mGroups; }
+
+    /// Get the number of groups.
+    size_t size() const { return mGroups.size(); }
+
+    /// Get the total number of items in all groups.
+    size_t getItemCount() const
+    {
+        size_t count = 0;
+        for (const auto& group : mGroups)
+            count += group.size();
+        return count;
+    }
+
+private:
+    struct Hash
+    {
+        size_t operator()(const InstanceList* pInstances) const { return (size_t)pInstances->getSignature(); }
+    };
+    struct Equal
+    {
+        bool operator()(const InstanceList* pA, const InstanceList* pB) const { return *pA == *pB; }
+    };
+
+    std::unordered_map<const InstanceList*, size_t, Hash, Equal> mGroupIndices;
+    std::vector<std::vector<T>> mGroups;
+};
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Light.h"
+#include "LightPower.h"
 #include "Core/Program/ShaderVar.h"
 #include "Utils/Logger.h"
 #include "Utils/UI/Gui.h"
@@ -188,7 +189,7 @@ namespace Falcor
 
     float PointLight::getPower() const
     {
-        return luminance(mData.intensity) * 4.f * (float)M_PI;
+        return luminance(mData.intensity) * computeSpotLightSolidAngle(mData.openingAngle, mData.penumbraAngle);
     }
 
     void PointLight::renderUI(Gui::Widgets& widget)
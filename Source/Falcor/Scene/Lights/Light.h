@@ -156,7 +156,8 @@ namespace Falcor
         */
         void renderUI(Gui::Widgets& widget) override;
 
-        /** Get total light power (needed for light picking)
+        /** Get total light power (needed for light picking).
+            Accounts for the cone of spot lights.
         */
         float getPower() const override;
 
@@ -87,8 +87,12 @@ namespace Falcor
 
         // Update transform matrices and check for updates.
         // TODO: Move per-mesh instance update flags into Scene. Return just a list of mesh lights that have changed.
-        std::vector<uint32_t> updatedLights;
-        updatedLights.reserve(mMeshLights.size());
+        mUpdatedLights.clear();
+        mUpdatedLights.reserve(mMeshLights.size());
+
+        // Skinning and vertex animations change the vertices of dynamic meshes without changing their transforms.
+        // The scene flags mesh changes before it updates the light collection.
+        const bool meshesChanged = is_set(mpScene->getUpdates(), Scene::UpdateFlags::MeshesChanged);
 
         for (uint32_t lightIdx = 0; lightIdx < mMeshLights.size(); ++lightIdx)
         {
@@ -98,15 +102,18 @@ namespace Falcor
             // Check if instance transform changed.
             if (mpScene->getAnimationController()->isMatrixChanged(NodeID{ instanceData.globalMatrixID })) updateFlags |= UpdateFlags::MatrixChanged;
 
+            // Check if the vertices of a skinned or vertex-animated mesh changed.
+            if (meshesChanged && instanceData.isDynamic()) updateFlags |= UpdateFlags::VerticesChanged;
+
             // Store update status.
-            if (updateFlags != UpdateFlags::None) updatedLights.push_back(lightIdx);
+            if (updateFlags != UpdateFlags::None) mUpdatedLights.push_back(lightIdx);
             if (pUpdateStatus) pUpdateStatus->lightsUpdateInfo.push_back(updateFlags);
         }
 
         // Update light data if needed.
-        if (!updatedLights.empty())
+        if (!mUpdatedLights.empty())
         {
-            updateTrianglePositions(pRenderContext, *mpScene, updatedLights);
+            updateTrianglePositions(pRenderContext, *mpScene, mUpdatedLights);
             return true;
         }
 
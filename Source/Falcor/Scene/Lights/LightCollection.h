@@ -62,6 +62,7 @@ namespace Falcor
         {
             None                = 0u,   ///< Nothing was changed.
             MatrixChanged       = 1u,   ///< Mesh instance transform changed.
+            VerticesChanged     = 2u,   ///< Mesh vertices changed (skinning or vertex animations).
         };
 
         struct UpdateStatus
@@ -164,6 +165,11 @@ namespace Falcor
         */
         const std::vector<MeshLightData>& getMeshLights() const { return mMeshLights; }
 
+        /** Returns the indices of the mesh lights that changed in the last call to update().
+            Only the triangles of these mesh lights have changed, which allows users to update derived data incrementally.
+        */
+        const std::vector<uint32_t>& getUpdatedLights() const { return mUpdatedLights; }
+
         /** Prepare for syncing the CPU data.
             If the mesh light triangles will be accessed with getMeshLightTriangles()
             performance can be improved by calling this function ahead of time.
@@ -206,6 +212,7 @@ namespace Falcor
 
         std::vector<MeshLightData>              mMeshLights;            ///< List of all mesh lights.
         uint32_t                                mTriangleCount = 0;     ///< Total number of triangles in all mesh lights (= mMeshLightTriangles.size()). This may include culled triangles.
+        std::vector<uint32_t>                   mUpdatedLights;         ///< Indices of mesh lights that changed in the last call to update().
 
         mutable std::vector<MeshLightTriangle>  mMeshLightTriangles;    ///< List of all pre-processed mesh light triangles.
         mutable std::vector<uint32_t>           mActiveTriangleList;    ///< List of active (non-culled) emissive triangles.
@@ -0,0 +1,76 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "LightPower.h"
+#include "Light.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+float computeSpotLightSolidAngle(float openingAngle, float penumbraAngle)
+{
+    const double opening = std::clamp((double)openingAngle, 0.0, M_PI);
+    const double penumbra = std::clamp((double)penumbraAngle, 0.0, opening);
+
+    // Full intensity inside the inner cone.
+    const double inner = opening - penumbra;
+    double integral = 1.0 - std::cos(inner);
+
+    // Integrate the smoothstep falloff over the penumbra with Simpson's rule.
+    // The integrand is smooth so a fixed number of intervals is accurate to float precision.
+    if (penumbra > 0.0)
+    {
+        const uint32_t n = 64;
+        const double h = penumbra / n;
+        auto f = [&](double theta)
+        {
+            double t = (opening - theta) / penumbra;
+            return t * t * (3.0 - 2.0 * t) * std::sin(theta);
+        };
+        double sum = f(inner) + f(opening);
+        for (uint32_t i = 1; i < n; ++i)
+            sum += f(inner + i * h) * (i % 2 == 1 ? 4.0 : 2.0);
+        integral += sum * h / 3.0;
+    }
+
+    return float(2.0 * M_PI * integral);
+}
+
+float estimateLightPower(const Light& light, float sceneRadius)
+{
+    switch (light.getType())
+    {
+    case LightType::Directional:
+    case LightType::Distant:
+        return luminance(light.getIntensity()) * (float)M_PI * sceneRadius * sceneRadius;
+    default:
+        return light.getPower();
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,56 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+
+namespace Falcor
+{
+class Light;
+
+/**
+ * Compute the integral of the spot light falloff over the sphere of directions.
+ * The falloff is one inside the cone of half-angle (openingAngle - penumbraAngle), zero outside the opening angle
+ * and a smoothstep in angle in between (see LightHelpers.slang). The power of a spot light is its intensity times
+ * this solid angle.
+ * @param[in] openingAngle Opening half-angle of the spot light in radians, in [0, pi].
+ * @param[in] penumbraAngle Width of the penumbra region in radians, in [0, openingAngle].
+ * @return Effective solid angle in steradians (4pi for an omni-directional point light).
+ */
+FALCOR_API float computeSpotLightSolidAngle(float openingAngle, float penumbraAngle);
+
+/**
+ * Estimate the power of an analytic light for importance sampling lights.
+ * Local lights return their emitted power (see Light::getPower()). Directional and distant lights have infinite
+ * power, instead the power incident on the scene is returned, i.e. the irradiance times the cross-section of the
+ * scene bounding sphere.
+ * @param[in] light Light.
+ * @param[in] sceneRadius Radius of the scene bounding sphere.
+ * @return Power (luminance) estimate.
+ */
+FALCOR_API float estimateLightPower(const Light& light, float sceneRadius);
+} // namespace Falcor
@@ -41,6 +41,7 @@ namespace Falcor
         const std::string kMaterialDataName = "materialData";
         const std::string kMaterialSamplersName = "materialSamplers";
         const std::string kMaterialTexturesName = "materialTextures";
+        const std::string kMaterialTextureArraysName = "materialTextureArrays";
         const std::string kMaterialBuffersName = "materialBuffers";
         const std::string kMaterialTextures3DName = "materialTextures3D";
 
@@ -468,6 +469,14 @@ namespace Falcor
         updateFlags |= mMaterialUpdates;
         mMaterialUpdates = Material::UpdateFlags::None;
 
+        // The size of the texture array descriptor array depends on the number of UDIM texture arrays.
+        // Recreate the parameter block if new arrays were allocated.
+        if (size_t textureArrayCount = mpTextureManager->getTextureArrayCount(); textureArrayCount != mTextureArrayDescCount)
+        {
+            mTextureArrayDescCount = textureArrayCount;
+            mpMaterialsBlock = nullptr;
+        }
+
         // Create parameter block if needed.
         if (!mpMaterialsBlock)
         {
@@ -510,7 +519,7 @@ namespace Falcor
         {
             FALCOR_ASSERT(!mMaterialsChanged);
             mpTextureManager->bindShaderData(blockVar[kMaterialTexturesName], mTextureDescCount,
-                blockVar["udimIndirection"]);
+                blockVar[kMaterialTextureArraysName], mTextureArrayDescCount, blockVar["udimIndirection"]);
         }
 
         // Update buffers.
@@ -636,6 +645,7 @@ namespace Falcor
         defines.add("MATERIAL_SYSTEM_TEXTURE_DESC_COUNT", std::to_string(mTextureDescCount));
         defines.add("MATERIAL_SYSTEM_BUFFER_DESC_COUNT", std::to_string(mBufferDescCount));
         defines.add("MATERIAL_SYSTEM_TEXTURE_3D_DESC_COUNT", std::to_string(mTexture3DDescCount));
+        defines.add("MATERIAL_SYSTEM_TEXTURE_ARRAY_DESC_COUNT", std::to_string(mTextureArrayDescCount));
         defines.add("MATERIAL_SYSTEM_UDIM_INDIRECTION_ENABLED", mpTextureManager->getUdimIndirectionCount() > 0 ? "1" : "0");
         defines.add("MATERIAL_SYSTEM_HAS_SPEC_GLOSS_MATERIALS", mHasSpecGlossStandardMaterial ? "1" : "0");
         defines.add("FALCOR_MATERIAL_INSTANCE_SIZE", std::to_string(materialInstanceByteSize));
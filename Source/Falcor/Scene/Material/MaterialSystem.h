@@ -265,6 +265,7 @@ namespace Falcor
         size_t mTextureDescCount = 0;                               ///< Number of texture descriptors in GPU descriptor array. This variable is for book-keeping until unbounded descriptor arrays are supported (see #1321).
         size_t mBufferDescCount = 0;                                ///< Number of buffer descriptors in GPU descriptor array. This variable is for book-keeping until unbounded descriptor arrays are supported (see #1321).
         size_t mTexture3DDescCount = 0;                             ///< Number of 3D texture descriptors in GPU descriptor array. This variable is for book-keeping until unbounded descriptor arrays are supported (see #1321).
+        size_t mTextureArrayDescCount = 0;                          ///< Number of texture array descriptors (packed UDIM tiles) in GPU descriptor array. Follows the texture manager's array count.
         size_t mReservedTextureDescCount = 0;                       ///< Number of reserved texture descriptors in GPU descriptor array. This variable is for book-keeping until unbounded descriptor arrays are supported (see #1321).
         size_t mReservedBufferDescCount = 0;                        ///< Number of reserved buffer descriptors in GPU descriptor array. This variable is for book-keeping until unbounded descriptor arrays are supported (see #1321).
         size_t mReservedTexture3DDescCount = 0;                     ///< Number of reserved 3D texture descriptors in GPU descriptor array. This variable is for book-keeping until unbounded descriptor arrays are supported (see #1321).
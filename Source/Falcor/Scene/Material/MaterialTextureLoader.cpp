@@ -34,6 +34,7 @@ namespace Falcor
         : mUseSrgb(useSrgb)
         , mTextureManager(textureManager)
     {
+        mTextureManager.beginDeferredLoading();
     }
 
     MaterialTextureLoader::~MaterialTextureLoader()
@@ -52,8 +53,11 @@ namespace Falcor
 
         bool srgb = mUseSrgb && pMaterial->getTextureSlotInfo(slot).srgb;
 
+        // Displacement maps are sampled as plain textures, so UDIM tiles must not be packed into texture arrays.
+        bool packUdimTiles = slot != Material::TextureSlot::Displacement;
+
         // Request texture to be loaded.
-        auto handle = mTextureManager.loadTexture(path, true, srgb);
+        auto handle = mTextureManager.loadTexture(path, true, srgb, ResourceBindFlags::ShaderResource, true, nullptr, nullptr, packUdimTiles);
 
         // Store assignment to material for later.
         mTextureAssignments.emplace_back(TextureAssignment{ pMaterial, slot, handle });
@@ -61,6 +65,7 @@ namespace Falcor
 
     void MaterialTextureLoader::assignTextures()
     {
+        mTextureManager.endDeferredLoading();
         mTextureManager.waitForAllTexturesLoading();
 
         // Assign textures to materials.
@@ -37,10 +37,13 @@ namespace Falcor
     /** Helper class to load material textures using the texture manager.
 
         Calling `loadTexture` does not assign the texture to the material right away.
-        Instead, an asynchronous texture load request is issued and a reference for the
+        Instead, a deferred texture load request is issued and a reference for the
         material assignment is stored. When the client destroys the instance of the
-        `MaterialTextureLoader`, it blocks until all textures are loaded and assigns
-        them to the materials.
+        `MaterialTextureLoader`, all requested textures are loaded in parallel and
+        assigned to the materials.
+
+        No GPU resources are created before the loader is destroyed. Requests can therefore
+        be issued from a worker thread, but the loader must be destroyed on the thread using the device.
     */
     class MaterialTextureLoader
     {
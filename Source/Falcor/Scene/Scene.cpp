@@ -63,10 +63,6 @@ namespace Falcor
 
     namespace
     {
-        // Large scenes are split into multiple BLAS groups in order to reduce build memory usage.
-        // The target is max 0.5GB intermediate memory per BLAS group. Note that this is not a strict limit.
-        const size_t kMaxBLASBuildMemory = 1ull << 29;
-
         const std::string kParameterBlockName = "gScene";
         const std::string kGeometryInstanceBufferName = "geometryInstances";
         const std::string kMeshBufferName = "meshes";
@@ -220,6 +216,17 @@ namespace Falcor
         // Setup volume grid -> id map.
         for (size_t i = 0; i < mGrids.size(); ++i) mGridIDs.emplace(mGrids[i], (uint32_t)i);
 
+        // Reserve grid IDs for streamed grid sequences.
+        for (const auto& pGridVolume : mGridVolumes)
+        {
+            for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridVolume::GridSlot::Count; ++slotIndex)
+            {
+                auto slot = (GridVolume::GridSlot)slotIndex;
+                if (pGridVolume->isGridSequenceStreamed(slot) && pGridVolume->getGrid(slot))
+                    mStreamedGridBindings.push_back({pGridVolume, slot, mGridIDs.at(pGridVolume->getGrid(slot))});
+            }
+        }
+
         // Set default SDF grid config.
         setSDFGridConfig();
 
@@ -1693,6 +1700,24 @@ namespace Falcor
         // Early out if no volumes have changed.
         if (!forceUpdate && combinedUpdates == GridVolume::UpdateFlags::None) return UpdateFlags::None;
 
+        // Replace grids of streamed grid sequences that have changed.
+        if (is_set(combinedUpdates, GridVolume::UpdateFlags::GridsChanged))
+        {
+            auto gridsVar = mpSceneBlock->getRootVar()["grids"];
+            for (const auto& binding : mStreamedGridBindings)
+            {
+                const auto& pGrid = binding.pGridVolume->getGrid(binding.slot);
+                auto& pBoundGrid = mGrids[binding.gridID.get()];
+                if (pGrid && pGrid != pBoundGrid)
+                {
+                    mGridIDs.erase(pBoundGrid);
+                    mGridIDs.emplace(pGrid, binding.gridID);
+                    pBoundGrid = pGrid;
+                    if (!forceUpdate) pBoundGrid->bindShaderData(gridsVar[binding.gridID.get()]);
+                }
+            }
+        }
+
         // Upload grids.
         if (forceUpdate)
         {
@@ -2712,6 +2737,12 @@ namespace Falcor
         mBlasUpdateMode = mode;
     }
 
+    void Scene::setBlasBuildConfig(const BlasBuildPlanner::Config& config)
+    {
+        mBlasBuildConfig = config;
+        mRebuildBlas = true;
+    }
+
     void Scene::createDrawList()
     {
         // This function creates argument buffers for draw indirect calls to rasterize the scene.
@@ -3081,10 +3112,8 @@ namespace Falcor
             // Determine how BLAS build/update should be done.
             // The default choice is to compact all static BLASes and those that don't need to be rebuilt every frame.
             // For all other BLASes, compaction just adds overhead.
-            // TODO: Add compaction on/off switch for profiling.
-            // TODO: Disable compaction for skinned meshes if update performance becomes a problem.
             blas.updateMode = mBlasUpdateMode;
-            blas.useCompaction = (!blas.hasDynamicGeometry()) || blas.updateMode != UpdateMode::Rebuild;
+            blas.useCompaction = BlasBuildPlanner::shouldCompact(mBlasBuildConfig.compaction, blas.hasDynamicGeometry(), blas.updateMode == UpdateMode::Rebuild);
 
             // Setup build parameters.
             RtAccelerationStructureBuildInputs& inputs = blas.buildInputs;
@@ -3129,36 +3158,34 @@ namespace Falcor
 
     void Scene::computeBlasGroups()
     {
-        mBlasGroups.clear();
-        uint64_t groupSize = 0;
+        // Plan the BLAS groups to limit the memory used for intermediate results and scratch data.
+        std::vector<BlasBuildPlanner::Item> items(mBlasData.size());
+        for (size_t blasId = 0; blasId < mBlasData.size(); blasId++)
+        {
+            const auto& blas = mBlasData[blasId];
+            items[blasId] = {blas.resultByteSize, blas.scratchByteSize, blas.useCompaction};
+        }
+        auto plan = BlasBuildPlanner(mBlasBuildConfig).plan(items);
 
+        mBlasGroups.clear();
+        mBlasGroups.resize(plan.groups.size());
+        for (size_t blasGroupIndex = 0; blasGroupIndex < plan.groups.size(); blasGroupIndex++)
+        {
+            auto& group = mBlasGroups[blasGroupIndex];
+            group.blasIndices = plan.groups[blasGroupIndex].items;
+            group.resultByteSize = plan.groups[blasGroupIndex].resultByteSize;
+            group.scratchByteSize = plan.groups[blasGroupIndex].scratchByteSize;
+        }
         for (uint32_t blasId = 0; blasId < mBlasData.size(); blasId++)
         {
             auto& blas = mBlasData[blasId];
-            size_t blasSize = blas.resultByteSize + blas.scratchByteSize;
-
-            // Start new BLAS group on first iteration or if group size would exceed the target.
-            if (groupSize == 0 || groupSize + blasSize > kMaxBLASBuildMemory)
-            {
-                mBlasGroups.push_back({});
-                groupSize = 0;
-            }
-
-            // Add BLAS to current group.
-            FALCOR_ASSERT(mBlasGroups.size() > 0);
-            auto& group = mBlasGroups.back();
-            group.blasIndices.push_back(blasId);
-            blas.blasGroupIndex = (uint32_t)mBlasGroups.size() - 1;
-
-            // Update data offsets and sizes.
-            blas.resultByteOffset = group.resultByteSize;
-            blas.scratchByteOffset = group.scratchByteSize;
-            group.resultByteSize += blas.resultByteSize;
-            group.scratchByteSize += blas.scratchByteSize;
-
-            groupSize += blasSize;
+            blas.blasGroupIndex = plan.itemGroups[blasId];
+            blas.resultByteOffset = plan.resultByteOffsets[blasId];
+            blas.scratchByteOffset = plan.scratchByteOffsets[blasId];
         }
 
+        logInfo("BLAS build split into {} groups, predicted peak memory: {}", mBlasGroups.size(), formatByteSize(plan.predictedPeakBytes));
+
         // Validation that all offsets and sizes are correct.
         uint64_t totalResultSize = 0;
         uint64_t totalScratchSize = 0;
@@ -3276,8 +3303,6 @@ namespace Falcor
                 preparePrebuildInfo(pRenderContext);
                 computeBlasGroups();
 
-                logInfo("BLAS build split into {} groups", mBlasGroups.size());
-
                 // Compute the required maximum size of the result and scratch buffers.
                 uint64_t resultByteSize = 0;
                 uint64_t scratchByteSize = 0;
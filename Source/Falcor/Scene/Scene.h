@@ -29,6 +29,7 @@
 #include "SceneIDs.h"
 #include "SceneTypes.slang"
 #include "HitInfo.h"
+#include "BlasBuildPlanner.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
 #include "Displacement/DisplacementUpdateTask.slang"
@@ -960,6 +961,14 @@ namespace Falcor
         */
         UpdateMode getBlasUpdateMode() { return mBlasUpdateMode; }
 
+        /** Set how BLAS builds are grouped and compacted. Changing the config triggers a BLAS rebuild.
+        */
+        void setBlasBuildConfig(const BlasBuildPlanner::Config& config);
+
+        /** Get the BLAS build config.
+        */
+        const BlasBuildPlanner::Config& getBlasBuildConfig() const { return mBlasBuildConfig; }
+
         /** Update the scene. Call this once per frame to update the camera location, animations, etc.
             \param[in] pRenderContext The render context.
             \param[in] currentTime The current time in seconds.
@@ -1324,6 +1333,14 @@ namespace Falcor
         std::vector<ref<GridVolume>> mGridVolumes;                  ///< All loaded grid volumes.
         std::vector<ref<Grid>> mGrids;                              ///< All loaded grids.
         std::unordered_map<ref<Grid>, SdfGridID> mGridIDs;          ///< Lookup table for grid IDs.
+
+        struct StreamedGridBinding
+        {
+            ref<GridVolume> pGridVolume;
+            GridVolume::GridSlot slot;
+            SdfGridID gridID;
+        };
+        std::vector<StreamedGridBinding> mStreamedGridBindings;     ///< Grid IDs reserved for streamed grid sequences. The grid bound to each ID is replaced during playback.
         ref<LightCollection> mpLightCollection;                     ///< Class for managing emissive geometry. This is created lazily upon first use.
         ref<EnvMap> mpEnvMap;                                       ///< Environment map or nullptr if not loaded.
         bool mEnvMapChanged = false;                                ///< Flag indicating that the environment map has changed since last frame.
@@ -1388,6 +1405,7 @@ namespace Falcor
         // Raytracing data
         UpdateMode mTlasUpdateMode = UpdateMode::Rebuild;   ///< How the TLAS should be updated when there are changes in the scene.
         UpdateMode mBlasUpdateMode = UpdateMode::Refit;     ///< How the BLAS should be updated when there are changes to meshes.
+        BlasBuildPlanner::Config mBlasBuildConfig;          ///< How BLAS builds are grouped and compacted.
 
         std::vector<RtInstanceDesc> mInstanceDescs;         ///< Shared between TLAS builds to avoid reallocating CPU memory.
 
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "SceneBuilder.h"
 #include "SceneCache.h"
+#include "SceneBuilderDump.h"
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
@@ -62,6 +63,56 @@ namespace Falcor
             else return 2;
         }
 
+        // Pack static vertex data. The vertices are processed in chunks in parallel, so that the float16 conversion
+        // of the normals and tangent signs can use the bulk converter. The result is identical to PackedStaticVertexData::pack().
+        void packStaticVertexData(fstd::span<const StaticVertexData> src, fstd::span<PackedStaticVertexData> dst)
+        {
+            FALCOR_ASSERT(src.size() == dst.size());
+            constexpr size_t kChunkSize = 1024;
+            const size_t chunkCount = (src.size() + kChunkSize - 1) / kChunkSize;
+
+            auto packChunk = [&](size_t chunk)
+            {
+                const size_t offset = chunk * kChunkSize;
+                const size_t count = std::min(kChunkSize, src.size() - offset);
+                float values[4 * kChunkSize];
+                uint16_t halfs[4 * kChunkSize];
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    const StaticVertexData& v = src[offset + i];
+                    float packedTangentSignCurveRadius = v.tangent.w;
+                    if (v.curveRadius > 0.f)
+                    {
+                        // This is safe because if v.curveRadius > 0 then v.tangent.w != 0 (curves always have valid tangents).
+                        FALCOR_ASSERT(v.tangent.w != 0.f);
+                        packedTangentSignCurveRadius *= v.curveRadius;
+                    }
+                    values[4 * i + 0] = v.normal.x;
+                    values[4 * i + 1] = v.normal.y;
+                    values[4 * i + 2] = v.normal.z;
+                    values[4 * i + 3] = packedTangentSignCurveRadius;
+                }
+
+                math::float32ToFloat16(fstd::span<const float>(values, 4 * count), fstd::span<uint16_t>(halfs, 4 * count));
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    const StaticVertexData& v = src[offset + i];
+                    PackedStaticVertexData& p = dst[offset + i];
+                    const uint16_t* h = halfs + 4 * i;
+                    p.position = v.position;
+                    p.texCrd = v.texCrd;
+                    p.packedNormalTangentCurveRadius.x = asfloat(((uint32_t)h[1] << 16) | h[0]);
+                    p.packedNormalTangentCurveRadius.y = asfloat(((uint32_t)h[3] << 16) | h[2]);
+                    p.packedNormalTangentCurveRadius.z = asfloat(encodeNormal2x16(v.tangent.xyz()));
+                }
+            };
+
+            auto range = NumericRange<size_t>(0, chunkCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), packChunk);
+        }
+
         class MikkTSpaceWrapper
         {
         public:
@@ -212,8 +263,32 @@ namespace Falcor
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
     }
 
-    SceneBuilder::SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags)
+    SceneBuilder::SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags, ProgressCallback progressCallback)
         : SceneBuilder(pDevice, settings, flags)
+    {
+        mProgressCallback = std::move(progressCallback);
+
+        if (!readSceneCache(path))
+        {
+            importFile(path, {});
+        }
+    }
+
+    SceneBuilder::SceneBuilder(ref<Device> pDevice, const void* buffer, size_t byteSize, std::string_view extension, const Settings& settings, Flags flags)
+        : SceneBuilder(pDevice, settings, flags)
+    {
+        importFromMemory(buffer, byteSize, extension);
+    }
+
+    SceneBuilder::~SceneBuilder() {}
+
+    void SceneBuilder::reportProgress(std::string_view stage, float progress)
+    {
+        if (mProgressCallback && !mProgressCallback(stage, progress))
+            throw SceneBuildCancelled(fmt::format("Scene build was cancelled during stage '{}'.", stage));
+    }
+
+    bool SceneBuilder::readSceneCache(const std::filesystem::path& path)
     {
         std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path, AssetCategory::Scene);
         if (resolvedPath.empty())
@@ -222,11 +297,11 @@ namespace Falcor
         }
 
         // Compute scene cache key based on absolute scene path and build flags.
-        mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags);
+        mSceneCacheKey = computeSceneCacheKey(resolvedPath, mFlags);
 
         // Determine if scene cache should be written after import.
-        bool useCache = is_set(flags, Flags::UseCache);
-        bool rebuildCache = is_set(flags, Flags::RebuildCache);
+        bool useCache = is_set(mFlags, Flags::UseCache);
+        bool rebuildCache = is_set(mFlags, Flags::RebuildCache);
         mWriteSceneCache = useCache || rebuildCache;
 
         // Try to load scene cache if supported, available and requested.
@@ -234,8 +309,15 @@ namespace Falcor
         {
             try
             {
-                mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey));
-                return;
+                reportProgress("Reading scene cache");
+                auto sceneData = SceneCache::readCache(mpDevice, mSceneCacheKey);
+                reportProgress("Creating resources");
+                mpScene = Scene::create(mpDevice, std::move(sceneData));
+                return true;
+            }
+            catch (const SceneBuildCancelled&)
+            {
+                throw;
             }
             catch (const std::exception& e)
             {
@@ -243,17 +325,9 @@ namespace Falcor
             }
         }
 
-        import(path);
-    }
-
-    SceneBuilder::SceneBuilder(ref<Device> pDevice, const void* buffer, size_t byteSize, std::string_view extension, const Settings& settings, Flags flags)
-        : SceneBuilder(pDevice, settings, flags)
-    {
-        importFromMemory(buffer, byteSize, extension);
+        return false;
     }
 
-    SceneBuilder::~SceneBuilder() {}
-
     inline std::map<std::string, std::string> convertDictToMap(const pybind11::dict& dict_)
     {
         std::map<std::string, std::string> dict;
@@ -270,9 +344,13 @@ namespace Falcor
     }
 
     void SceneBuilder::import(const std::filesystem::path& path, const pybind11::dict& dict)
+    {
+        importFile(path, convertDictToMap(dict));
+    }
+
+    void SceneBuilder::importFile(const std::filesystem::path& path, const std::map<std::string, std::string>& materialToShortName)
     {
         logInfo("Importing scene: {}", path);
-        std::map<std::string, std::string> materialToShortName = convertDictToMap(dict);
 
         std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path, AssetCategory::Scene);
         if (resolvedPath.empty())
@@ -283,6 +361,7 @@ namespace Falcor
         mSceneData.path = resolvedPath;
         if (auto importer = Importer::create(getExtensionFromPath(resolvedPath)))
         {
+            reportProgress("Importing");
             importer->importScene(resolvedPath, *this, materialToShortName);
         }
         else
@@ -324,6 +403,7 @@ namespace Falcor
         if (mpScene) return mpScene;
 
         // Finish loading textures. This blocks until all textures are loaded and assigned.
+        reportProgress("Loading textures");
         mpMaterialTextureLoader.reset();
 
         // If no meshes were added, we create a dummy mesh to keep the scene generation working.
@@ -342,6 +422,7 @@ namespace Falcor
 
         // Post-process the scene data.
         TimeReport timeReport;
+        reportProgress("Processing geometry", 0.f);
 
         // Prepare displacement maps. This either removes them (if requested in build flags)
         // or makes sure that normal maps are removed if displacement is in use.
@@ -352,12 +433,15 @@ namespace Falcor
         removeUnusedMeshes();
         flattenStaticMeshInstances();
         pretransformStaticMeshes();
+        reportProgress("Processing geometry", 0.25f);
         unifyTriangleWinding();
         optimizeSceneGraph();
         calculateMeshBoundingBoxes();
         createMeshGroups();
+        reportProgress("Processing geometry", 0.5f);
         optimizeGeometry();
         sortMeshes();
+        reportProgress("Processing geometry", 0.75f);
         createGlobalBuffers();
         createCurveGlobalBuffers();
         collectVolumeGrids();
@@ -365,6 +449,7 @@ namespace Falcor
 
         timeReport.measure("Post processing geometry");
 
+        reportProgress("Optimizing materials");
         optimizeMaterials();
         removeDuplicateMaterials();
         quantizeTexCoords();
@@ -390,11 +475,13 @@ namespace Falcor
         // Write scene cache if requested.
         if (mWriteSceneCache)
         {
+            reportProgress("Writing scene cache");
             SceneCache::writeCache(mSceneData, mSceneCacheKey);
             timeReport.measure("Writing cache");
         }
 
-        // Create the scene object.
+        // Create the scene object. This is the last point the build can be cancelled.
+        reportProgress("Creating resources");
         mpScene = Scene::create(mpDevice, std::move(mSceneData));
         mSceneData = {};
 
@@ -936,12 +1023,17 @@ namespace Falcor
     void SceneBuilder::loadMaterialTexture(const ref<Material>& pMaterial, Material::TextureSlot slot, const std::filesystem::path& path)
     {
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
+        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
+        getMaterialTextureLoader().loadTexture(pMaterial, slot, resolvedPath);
+    }
+
+    MaterialTextureLoader& SceneBuilder::getMaterialTextureLoader()
+    {
         if (!mpMaterialTextureLoader)
         {
             mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
         }
-        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
-        mpMaterialTextureLoader->loadTexture(pMaterial, slot, resolvedPath);
+        return *mpMaterialTextureLoader;
     }
 
     void SceneBuilder::waitForMaterialTextureLoading()
@@ -1485,7 +1577,7 @@ namespace Falcor
             FALCOR_ASSERT(!mesh.instances.empty());
             FALCOR_ASSERT(mesh.skinningData.empty() && mesh.skinningVertexCount == 0);
 
-            std::set<NodeID> newInstances;  // Construct a new set of instances, rather than modifying the one we're iterating over
+            InstanceList newInstances;  // Construct a new set of instances, rather than modifying the one we're iterating over
             uint32_t instCount = 0;
             for (auto instIter = mesh.instances.cbegin(); instIter != mesh.instances.cend(); ++instIter)
             {
@@ -1878,8 +1970,9 @@ namespace Falcor
         // Classify instanced meshes.
         // The instanced meshes are grouped based on their lists of instances.
         // Meshes with an identical set of instances can be placed together in a BLAS.
-        std::map<std::set<NodeID>, meshList> instancesToMeshList;
-        std::map<std::set<NodeID>, meshList> displacedInstancesToMeshList;
+        // The lists are hashed by their signature, so grouping is linear in the number of instances.
+        InstanceListGroups<MeshID> instancesToMeshList;
+        InstanceListGroups<MeshID> displacedInstancesToMeshList;
         size_t instancedMeshCount = 0;
 
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
@@ -1891,28 +1984,27 @@ namespace Falcor
             const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId);
             if (pMaterial->isDisplaced()) mesh.isDisplaced = true;
 
-            if (mesh.isDisplaced) displacedInstancesToMeshList[mesh.instances].push_back(meshID);
-            else instancesToMeshList[mesh.instances].push_back(meshID);
+            if (mesh.isDisplaced) displacedInstancesToMeshList.add(mesh.instances, meshID);
+            else instancesToMeshList.add(mesh.instances, meshID);
             instancedMeshCount++;
         }
 
         // Validate that each mesh is only indexed once.
-        std::set<MeshID> instancedMeshes;
-        size_t instancedCount = 0;
-        for (const auto& it : instancesToMeshList)
-        {
-            instancedMeshes.insert(it.second.begin(), it.second.end());
-            instancedCount += it.second.size();
-        }
-        std::set<MeshID> displacedInstancedMeshes;
-        size_t displacedInstancedCount = 0;
-        for (const auto& it : displacedInstancesToMeshList)
+        std::vector<bool> isMeshGrouped(mMeshes.size(), false);
+        size_t groupedMeshCount = 0;
+        for (const auto& groups : { &instancesToMeshList, &displacedInstancesToMeshList })
         {
-            displacedInstancedMeshes.insert(it.second.begin(), it.second.end());
-            displacedInstancedCount += it.second.size();
+            for (const auto& meshes : groups->getGroups())
+            {
+                for (MeshID meshID : meshes)
+                {
+                    if (isMeshGrouped[meshID.get()]) FALCOR_THROW("Error in instanced mesh grouping logic");
+                    isMeshGrouped[meshID.get()] = true;
+                    groupedMeshCount++;
+                }
+            }
         }
-        if ((instancedCount + displacedInstancedCount) != instancedMeshCount ||
-            (instancedMeshes.size() + displacedInstancedMeshes.size()) != instancedMeshCount) FALCOR_THROW("Error in instanced mesh grouping logic");
+        if (groupedMeshCount != instancedMeshCount) FALCOR_THROW("Error in instanced mesh grouping logic");
 
         logInfo("Found {} static non-instanced meshes, arranged in 1 mesh group.", staticMeshes.size());
         logInfo("Found {} displaced non-instanced meshes, arranged in 1 mesh group.", staticDisplacedMeshes.size());
@@ -1946,9 +2038,9 @@ namespace Falcor
         }
 
         // Instanced static and dynamic meshes are grouped based on instance lists.
-        for (const auto& it : instancesToMeshList)
+        for (const auto& meshes : instancesToMeshList.getGroups())
         {
-            addMeshes(it.second, false, false, is_set(mFlags, Flags::RTDontMergeInstanced));
+            addMeshes(meshes, false, false, is_set(mFlags, Flags::RTDontMergeInstanced));
         }
 
         // All static displaced meshes go in a single group or individual groups depending on config.
@@ -1964,9 +2056,9 @@ namespace Falcor
         }
 
         // Instanced displaced meshes are grouped based on instance lists.
-        for (const auto& it : displacedInstancesToMeshList)
+        for (const auto& meshes : displacedInstancesToMeshList.getGroups())
         {
-            addMeshes(it.second, false, true, is_set(mFlags, Flags::RTDontMergeInstanced));
+            addMeshes(meshes, false, true, is_set(mFlags, Flags::RTDontMergeInstanced));
         }
     }
 
@@ -2424,8 +2516,9 @@ namespace Falcor
             mesh.prevVertexOffset = mesh.skinningVertexOffset;
 
             // Insert the static vertex data in the global array.
-            // The vertices are automatically converted to their packed format in this step.
-            mSceneData.meshStaticData.insert(mSceneData.meshStaticData.end(), mesh.staticData.begin(), mesh.staticData.end());
+            // The vertices are converted to their packed format in this step.
+            mSceneData.meshStaticData.resize(mesh.staticVertexOffset + mesh.staticData.size());
+            packStaticVertexData(mesh.staticData, fstd::span<PackedStaticVertexData>(mSceneData.meshStaticData).subspan(mesh.staticVertexOffset));
 
             if (isIndexed)
             {
@@ -2984,6 +3077,9 @@ namespace Falcor
         sceneBuilder.def("addMeshInstance", &SceneBuilder::addMeshInstance);
         sceneBuilder.def("addSDFGridInstance", &SceneBuilder::addSDFGridInstance);
         sceneBuilder.def("addCustomPrimitive", &SceneBuilder::addCustomPrimitive);
+        sceneBuilder.def("exportBinaryScene", [] (SceneBuilder& sceneBuilder, const std::filesystem::path& path) {
+            SceneBuilderDump::exportBinaryScene(sceneBuilder, path);
+        }, "path"_a);
 
         sceneBuilder.def("getSettings", static_cast<Settings&(SceneBuilder::*)()>(&SceneBuilder::getSettings), pybind11::return_value_policy::reference);
         sceneBuilder.def_property_readonly("assetResolver", &SceneBuilder::getAssetResolver, pybind11::return_value_policy::reference);
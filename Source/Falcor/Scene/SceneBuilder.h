@@ -28,6 +28,7 @@
 #pragma once
 #include "Scene.h"
 #include "SceneCache.h"
+#include "InstanceList.h"
 #include "SceneIDs.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
@@ -36,6 +37,7 @@
 #include "Material/MaterialTextureLoader.h"
 
 #include "Core/Macros.h"
+#include "Core/Error.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/VAO.h"
 #include "Utils/Math/AABB.h"
@@ -46,15 +48,37 @@
 #include <pybind11/pytypes.h>
 
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Falcor
 {
+    /** Exception thrown by SceneBuilder when a build is cancelled through its progress callback.
+    */
+    class FALCOR_API SceneBuildCancelled : public Exception
+    {
+    public:
+        SceneBuildCancelled() noexcept {}
+        SceneBuildCancelled(std::string_view what) : Exception(what) {}
+        SceneBuildCancelled(const SceneBuildCancelled& other) noexcept { mpWhat = other.mpWhat; }
+        virtual ~SceneBuildCancelled() override {}
+    };
+
     class FALCOR_API SceneBuilder
     {
     public:
+        /** Callback receiving the progress of importing and building a scene.
+            It is called from the thread running the builder, which does not have to be the main thread.
+            \param[in] stage Description of the current stage.
+            \param[in] progress Progress of the current stage in [0,1], or a negative value if unknown.
+            \return False to cancel the build. The builder then throws SceneBuildCancelled.
+        */
+        using ProgressCallback = std::function<bool(std::string_view stage, float progress)>;
+
         /** Flags that control how the scene will be built. They can be combined together.
         */
         enum class Flags
@@ -331,10 +355,11 @@ namespace Falcor
         */
         SceneBuilder(ref<Device> pDevice, const Settings& settings, Flags flags = Flags::Default);
 
-        /** Create a new builder and import a scene/model file.
+        /** Create a new builder and import a scene/model file, or read it from the scene cache (see readSceneCache()).
             Throws an ImporterError if importing went wrong.
+            \param[in] progressCallback Optional callback receiving progress of the import and of getScene().
         */
-        SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags = Flags::Default);
+        SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags = Flags::Default, ProgressCallback progressCallback = {});
 
         /** Create a new builder and import a scene/model from memory.
             Throws an ImporterError if importing went wrong.
@@ -349,6 +374,24 @@ namespace Falcor
         */
         void import(const std::filesystem::path& path, const pybind11::dict& dict = pybind11::dict());
 
+        /** Import a scene/model file.
+            Unlike import(), this does not call into Python (unless the importer does). If the importer does no GPU work
+            (see Importer::isCpuOnly()), this can be called from a worker thread. Material textures are only loaded by getScene().
+            Throws an ImporterError if something went wrong.
+            \param[in] path The file path to load.
+            \param[in] materialToShortName Optional map from material names to short names.
+        */
+        void importFile(const std::filesystem::path& path, const std::map<std::string, std::string>& materialToShortName = {});
+
+        /** Read the scene from the scene cache if it is enabled in the build flags and valid for the given scene file.
+            Otherwise, prepares writing the cache in getScene() if the build flags request it.
+            Reading the cache creates GPU resources, so this must be called from the main thread.
+            Throws an ImporterError if the file can't be found or reading the cache failed.
+            \param[in] path Scene file path.
+            \return True if the scene was read from the cache. getScene() then returns it without importing.
+        */
+        bool readSceneCache(const std::filesystem::path& path);
+
         /** Import a scene/model file from memory.
             \param[in] buffer Memory buffer.
             \param[in] byteSize Size in bytes of memory buffer.
@@ -358,6 +401,18 @@ namespace Falcor
         */
         void importFromMemory(const void* buffer, size_t byteSize, std::string_view extension, const pybind11::dict& dict = pybind11::dict());
 
+        /** Set the callback receiving build progress.
+        */
+        void setProgressCallback(ProgressCallback progressCallback) { mProgressCallback = std::move(progressCallback); }
+
+        /** Report progress of the current build stage. This is meant to be called by importers.
+            Does nothing if no progress callback is set.
+            Throws SceneBuildCancelled if the build was cancelled.
+            \param[in] stage Description of the current stage.
+            \param[in] progress Progress of the current stage in [0,1], or a negative value if unknown.
+        */
+        void reportProgress(std::string_view stage, float progress = -1.f);
+
         /// Access the current asset resolver (on top of the stack).
         AssetResolver& getAssetResolver() { return mAssetResolver; }
 
@@ -368,6 +423,7 @@ namespace Falcor
         void popAssetResolver();
 
         /** Get the scene. Make sure to add all the objects before calling this function
+            This loads the material textures and creates the GPU resources of the scene, so it must be called from the main thread.
             \return nullptr if something went wrong, otherwise a new Scene object
         */
         ref<Scene> getScene();
@@ -705,7 +761,7 @@ namespace Falcor
             bool isDisplaced = false;               ///< True if mesh has displacement map.
             bool isAnimated = false;                ///< True if the mesh vertices can be modified during rendering (e.g., skinning or inverse rendering).
             AABB boundingBox;                       ///< Mesh bounding-box in object space.
-            std::set<NodeID> instances;             ///< IDs of all nodes that instantiate this mesh.
+            InstanceList instances;                 ///< IDs of all nodes that instantiate this mesh.
 
             // Pre-processed vertex data.
             std::vector<uint32_t> indexData;    ///< Vertex indices in either 32-bit or 16-bit format packed tightly, or empty if non-indexed.
@@ -747,7 +803,7 @@ namespace Falcor
             uint32_t indexCount = 0;            ///< Number of indices.
             uint32_t vertexCount = 0;           ///< Number of vertices.
             uint32_t degree = 1;                ///< Polynomial degree of curve; linear (1) by default.
-            std::set<NodeID> instances;         ///< IDs of all nodes that instantiate this curve.
+            InstanceList instances;             ///< IDs of all nodes that instantiate this curve.
 
             // Pre-processed curve vertex data.
             std::vector<uint32_t> indexData;    ///< Vertex indices in 32-bit.
@@ -783,6 +839,10 @@ namespace Falcor
 
         std::unique_ptr<MaterialTextureLoader> mpMaterialTextureLoader;
 
+        ProgressCallback mProgressCallback;
+
+        MaterialTextureLoader& getMaterialTextureLoader();
+
         // Helpers
         bool doesNodeHaveAnimation(NodeID nodeID) const;
         void updateLinkedObjects(NodeID oldNodeID, NodeID newNodeID);
@@ -839,6 +899,7 @@ namespace Falcor
 
         friend class SceneCache;
         friend class SceneBuilderDump;
+        friend class BinaryScene;
     };
 
     FALCOR_ENUM_CLASS_OPERATORS(SceneBuilder::Flags);
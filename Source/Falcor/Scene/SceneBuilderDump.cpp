@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "SceneBuilderDump.h"
 #include "Scene/SceneBuilder.h"
+#include "Scene/BinaryScene.h"
 #include "Utils/Math/FNVHash.h"
 #include <fmt/format.h>
 #include <BS_thread_pool.hpp>
@@ -298,4 +299,9 @@ std::map<std::string, std::string> SceneBuilderDump::getDebugContent(const Scene
     return result;
 }
 
+void SceneBuilderDump::exportBinaryScene(SceneBuilder& sceneBuilder, const std::filesystem::path& path)
+{
+    BinaryScene::write(sceneBuilder, path);
+}
+
 } // namespace Falcor
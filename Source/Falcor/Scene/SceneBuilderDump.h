@@ -25,6 +25,7 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include <filesystem>
 #include <map>
 #include <string>
 
@@ -40,6 +41,9 @@ public:
     /// Returns pairs of geometry and its serialization to text used for debugging.
     /// The interface as well as output are unstable and depend on the latest debugging needs
     static std::map<std::string, std::string> getDebugContent(const SceneBuilder& sceneBuilder);
+
+    /// Export the content of the SceneBuilder to a binary scene (see BinaryScene).
+    static void exportBinaryScene(SceneBuilder& sceneBuilder, const std::filesystem::path& path);
 };
 
 } // namespace Falcor
@@ -64,134 +64,6 @@ namespace Falcor
         };
     }
 
-    /** Wrapper around std::ostream to ease serialization of basic types.
-    */
-    class SceneCache::OutputStream
-    {
-    public:
-        OutputStream(std::ostream& stream) : mStream(stream) {}
-
-        void write(const void* data, size_t len)
-        {
-            mStream.write(reinterpret_cast<const char*>(data), len);
-        }
-
-        template<typename T>
-        void write(const T& value)
-        {
-            write(&value, sizeof(T));
-        }
-
-        void write(const std::string& value)
-        {
-            uint64_t len = value.size();
-            write(len);
-            write(value.data(), len);
-        }
-
-        void write(const std::filesystem::path& path)
-        {
-            write(path.string());
-        }
-
-        template<typename T>
-        void write(const std::vector<T>& vec)
-        {
-            uint64_t len = vec.size();
-            write(len);
-            if constexpr (std::is_trivial<T>::value && !std::is_same<T, bool>::value)
-            {
-                write(vec.data(), len * sizeof(T));
-            }
-            else
-            {
-                for (const auto& item : vec) write(item);
-            }
-        }
-
-        template<typename T>
-        void write(const std::optional<T>& opt)
-        {
-            bool hasValue = opt.has_value();
-            write(hasValue);
-            if (hasValue) write(opt.value());
-        }
-
-    private:
-        std::ostream& mStream;
-    };
-
-    /** Wrapper around std::istream to ease serialization of basic types.
-    */
-    class SceneCache::InputStream
-    {
-    public:
-        InputStream(std::istream& stream) : mStream(stream) {}
-
-        void read(void* data, size_t len)
-        {
-            mStream.read(reinterpret_cast<char*>(data), len);
-        }
-
-        template<typename T>
-        void read(T& value)
-        {
-            read(&value, sizeof(T));
-        }
-
-        void read(std::string& value)
-        {
-            uint64_t len = read<uint64_t>();
-            value.resize(len);
-            read(value.data(), len);
-        }
-
-        void read(std::filesystem::path& path)
-        {
-            std::string str;
-            read(str);
-            path = str;
-        }
-
-        template<typename T>
-        T read()
-        {
-            T value;
-            read(value);
-            return value;
-        }
-
-        template<typename T>
-        void read(std::vector<T>& vec)
-        {
-            uint64_t len = read<uint64_t>();
-            vec.resize(len);
-            if constexpr (std::is_trivial<T>::value && !std::is_same<T, bool>::value)
-            {
-                read(vec.data(), len * sizeof(T));
-            }
-            else
-            {
-                for (auto& item : vec) read(item);
-            }
-        }
-
-        template<typename T>
-        void read(std::optional<T>& opt)
-        {
-            bool hasValue = read<bool>();
-            if (hasValue)
-            {
-                T value;
-                read(value);
-                opt = value;
-            }
-        }
-
-    private:
-        std::istream& mStream;
-    };
-
     bool SceneCache::hasValidCache(const Key& key)
     {
         auto cachePath = getCachePath(key);
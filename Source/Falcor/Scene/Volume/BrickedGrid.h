@@ -26,7 +26,12 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Core/API/Device.h"
+#include "Core/API/Formats.h"
 #include "Core/API/Texture.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
 
 namespace Falcor
 {
@@ -36,4 +41,29 @@ namespace Falcor
         ref<Texture> indirection;
         ref<Texture> atlas;
     };
+
+    /** Host-side data of a bricked grid.
+        This is the output of the brick conversion, kept separate from the textures so that it can be
+        produced on worker threads and cached on disk (see GridCache).
+    */
+    struct BrickedGridData
+    {
+        uint3 rangeDim = uint3(0);          ///< Dimensions of the range and indirection textures (mip 0).
+        uint3 atlasDim = uint3(0);          ///< Dimensions of the atlas texture in texels.
+        ResourceFormat atlasFormat = ResourceFormat::Unknown;
+        std::vector<uint32_t> range;        ///< Range texture data (RG16Float, 4 mip levels).
+        std::vector<uint32_t> indirection;  ///< Indirection texture data (RGBA8Uint).
+        std::vector<uint8_t> atlas;         ///< Atlas texture data.
+
+        static constexpr uint32_t kRangeMipCount = 4;
+
+        BrickedGrid createTextures(ref<Device> pDevice) const
+        {
+            BrickedGrid bricks;
+            bricks.range = pDevice->createTexture3D(rangeDim.x, rangeDim.y, rangeDim.z, ResourceFormat::RG16Float, kRangeMipCount, range.data(), ResourceBindFlags::ShaderResource);
+            bricks.indirection = pDevice->createTexture3D(rangeDim.x, rangeDim.y, rangeDim.z, ResourceFormat::RGBA8Uint, 1, indirection.data(), ResourceBindFlags::ShaderResource);
+            bricks.atlas = pDevice->createTexture3D(atlasDim.x, atlasDim.y, atlasDim.z, atlasFormat, 1, atlas.data(), ResourceBindFlags::ShaderResource);
+            return bricks;
+        }
+    };
 }
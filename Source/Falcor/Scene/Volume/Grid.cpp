@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Grid.h"
+#include "GridCache.h"
 #include "GridConverter.h"
 #include "Core/API/Device.h"
 #include "Core/Program/ShaderVar.h"
@@ -35,6 +36,7 @@
 #include "Utils/Math/Common.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
+#include "Utils/NumericRange.h"
 #include "GlobalState.h"
 #include "Utils/PathResolving.h"
 
@@ -57,10 +59,17 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <execution>
+#include <mutex>
+#include <thread>
+
 namespace Falcor
 {
     namespace
     {
+        using NanoVDBGridConverter = NanoVDBConverterBC4;
+
         float3 cast(const nanovdb::Vec3f& v)
         {
             return float3(v[0], v[1], v[2]);
@@ -91,25 +100,31 @@ namespace Falcor
 
     ref<Grid> Grid::createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
     {
-        if (!std::filesystem::exists(path))
-        {
-            logWarning("Error when loading grid. Can't open grid file '{}'.", path);
-            return nullptr;
-        }
+        auto hostData = loadHostData(path, gridname);
+        return hostData ? ref<Grid>(new Grid(pDevice, std::move(*hostData))) : nullptr;
+    }
 
-        if (hasExtension(path, "nvdb"))
-        {
-            return createFromNanoVDBFile(pDevice, path, gridname);
-        }
-        else if (hasExtension(path, "vdb"))
-        {
-            return createFromOpenVDBFile(pDevice, path, gridname);
-        }
-        else
+    std::vector<ref<Grid>> Grid::createFromFiles(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname)
+    {
+        std::vector<ref<Grid>> grids(paths.size());
+
+        // Load and convert in batches to bound the amount of host data waiting for upload.
+        const size_t batchSize = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        std::vector<std::optional<HostData>> batch;
+        for (size_t first = 0; first < paths.size(); first += batchSize)
         {
-            logWarning("Error when loading grid. Unsupported grid file '{}'.", path);
-            return nullptr;
+            batch.clear();
+            batch.resize(std::min(batchSize, paths.size() - first));
+            auto range = NumericRange<size_t>(0, batch.size());
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { batch[i] = loadHostData(paths[first + i], gridname); });
+
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                if (batch[i]) grids[first + i] = ref<Grid>(new Grid(pDevice, std::move(*batch[i])));
+            }
         }
+
+        return grids;
     }
 
     void Grid::renderUI(Gui::Widgets& widget)
@@ -203,16 +218,16 @@ namespace Falcor
     }
 
     Grid::Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle)
+        : Grid(pDevice, createHostData(std::move(gridHandle)))
+    {
+    }
+
+    Grid::Grid(ref<Device> pDevice, HostData hostData)
         : mpDevice(pDevice)
-        , mGridHandle(std::move(gridHandle))
+        , mGridHandle(std::move(hostData.gridHandle))
         , mpFloatGrid(mGridHandle.grid<float>())
         , mAccessor(mpFloatGrid->getAccessor())
     {
-        if (!mpFloatGrid->hasMinMax())
-        {
-            nanovdb::gridStats(*mpFloatGrid);
-        }
-
         // Keep both NanoVDB and brick textures resident in GPU memory for simplicity for now (~15% increased footprint).
         mpBuffer = mpDevice->createStructuredBuffer(
             sizeof(uint32_t),
@@ -221,44 +236,105 @@ namespace Falcor
             MemoryType::DeviceLocal,
             mGridHandle.data()
         );
-        using NanoVDBGridConverter = NanoVDBConverterBC4;
-        mBrickedGrid = NanoVDBGridConverter(mpFloatGrid).convert(mpDevice);
+        mBrickedGrid = hostData.bricks.createTextures(mpDevice);
+    }
+
+    Grid::HostData Grid::createHostData(nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle)
+    {
+        auto floatGrid = gridHandle.grid<float>();
+        if (!floatGrid->hasMinMax())
+        {
+            nanovdb::gridStats(*floatGrid);
+        }
+
+        HostData hostData;
+        hostData.bricks = NanoVDBGridConverter(floatGrid).convertToData();
+        hostData.gridHandle = std::move(gridHandle);
+        return hostData;
+    }
+
+    std::optional<Grid::HostData> Grid::loadHostData(const std::filesystem::path& path, const std::string& gridname)
+    {
+        if (!std::filesystem::exists(path))
+        {
+            logWarning("Error when loading grid. Can't open grid file '{}'.", path);
+            return {};
+        }
+
+        if (hasExtension(path, "nvdb"))
+        {
+            return loadNanoVDBFile(path, gridname);
+        }
+        else if (hasExtension(path, "vdb"))
+        {
+            return loadOpenVDBFile(path, gridname);
+        }
+        else
+        {
+            logWarning("Error when loading grid. Unsupported grid file '{}'.", path);
+            return {};
+        }
     }
 
-    ref<Grid> Grid::createFromNanoVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    std::optional<Grid::HostData> Grid::loadNanoVDBFile(const std::filesystem::path& path, const std::string& gridname)
     {
         if (!nanovdb::io::hasGrid(path.string(), gridname))
         {
             logWarning("Error when loading grid. Can't find grid '{}' in '{}'.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         auto handle = nanovdb::io::readGrid(path.string(), gridname);
         if (!handle)
         {
             logWarning("Error when loading grid.");
-            return nullptr;
+            return {};
         }
 
         auto floatGrid = handle.grid<float>();
         if (!floatGrid || floatGrid->gridType() != nanovdb::GridType::Float)
         {
             logWarning("Error when loading grid. Grid '{}' in '{}' is not of type float.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (floatGrid->isEmpty())
         {
             logWarning("Grid '{}' in '{}' is empty.", gridname, path);
-            return nullptr;
+            return {};
         }
 
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return createHostData(std::move(handle));
     }
 
-    ref<Grid> Grid::createFromOpenVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    std::optional<Grid::HostData> Grid::loadOpenVDBFile(const std::filesystem::path& path, const std::string& gridname)
     {
-        openvdb::initialize();
+        const auto cacheOptions = GridCache::getOptions();
+        std::optional<GridCache::Key> cacheKey;
+
+        // Use the cached NanoVDB grid (and bricks) if available.
+        if (cacheOptions.enabled)
+        {
+            cacheKey = GridCache::computeKey(path, gridname);
+            if (cacheKey)
+            {
+                if (auto handle = GridCache::readGrid(*cacheKey))
+                {
+                    if (cacheOptions.cacheBricks)
+                    {
+                        if (auto bricks = GridCache::readBricks(*cacheKey, NanoVDBGridConverter::getAtlasFormat()))
+                            return HostData{std::move(*handle), std::move(*bricks)};
+                    }
+
+                    auto hostData = createHostData(std::move(*handle));
+                    if (cacheOptions.cacheBricks) GridCache::writeBricks(*cacheKey, hostData.bricks);
+                    return hostData;
+                }
+            }
+        }
+
+        static std::once_flag sInitFlag;
+        std::call_once(sInitFlag, []() { openvdb::initialize(); });
 
         openvdb::io::File file(path.string());
         file.open();
@@ -278,25 +354,32 @@ namespace Falcor
         if (!baseGrid)
         {
             logWarning("Error when loading grid. Can't find grid '{}' in '{}'.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (!baseGrid->isType<openvdb::FloatGrid>())
         {
             logWarning("Error when loading grid. Grid '{}' in '{}' is not of type float.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (baseGrid->empty())
         {
             logWarning("Grid '{}' in '{}' is empty.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         openvdb::FloatGrid::Ptr floatGrid = openvdb::gridPtrCast<openvdb::FloatGrid>(baseGrid);
         auto handle = nanovdb::openToNanoVDB(floatGrid);
+        auto hostData = createHostData(std::move(handle));
 
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        if (cacheKey)
+        {
+            GridCache::writeGrid(*cacheKey, hostData.gridHandle);
+            if (cacheOptions.cacheBricks) GridCache::writeBricks(*cacheKey, hostData.bricks);
+        }
+
+        return hostData;
     }
 
 
@@ -48,7 +48,9 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -89,6 +91,16 @@ namespace Falcor
         */
         static ref<Grid> createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname);
 
+        /** Create grids from a list of files.
+            Files are read and converted in parallel, GPU resources are created on the calling thread.
+            Grids converted from OpenVDB are cached on disk (see GridCache).
+            \param[in] pDevice GPU device.
+            \param[in] paths File paths of the grids (absolute or relative to working directory).
+            \param[in] gridname Name of the grid to load.
+            \return List of grids in the order of the paths. Grids that failed to load are nullptr.
+        */
+        static std::vector<ref<Grid>> createFromFiles(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname);
+
         /** Render the UI.
         */
         void renderUI(Gui::Widgets& widget);
@@ -145,10 +157,26 @@ namespace Falcor
         float4x4 getInvTransform() const;
 
     private:
+        /** Host data of a grid. This is everything needed to create the grid's GPU resources.
+        */
+        struct HostData
+        {
+            nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle;
+            BrickedGridData bricks;
+        };
+
         Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle);
+        Grid(ref<Device> pDevice, HostData hostData);
+
+        /** Compute grid statistics (if missing) and convert the grid to bricks. Does not access the GPU.
+        */
+        static HostData createHostData(nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle);
 
-        static ref<Grid> createFromNanoVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname);
-        static ref<Grid> createFromOpenVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname);
+        /** Load a grid from a file and prepare its host data. Does not access the GPU and is safe to call from multiple threads.
+        */
+        static std::optional<HostData> loadHostData(const std::filesystem::path& path, const std::string& gridname);
+        static std::optional<HostData> loadNanoVDBFile(const std::filesystem::path& path, const std::string& gridname);
+        static std::optional<HostData> loadOpenVDBFile(const std::filesystem::path& path, const std::string& gridname);
 
         ref<Device> mpDevice;
 
@@ -161,5 +189,6 @@ namespace Falcor
         BrickedGrid mBrickedGrid;
 
         friend class SceneCache;
+        friend class GridSequenceStreamer;
     };
 }
@@ -0,0 +1,306 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GridCache.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4146 4244 4267 4275 4996 4456)
+#endif
+#include <nanovdb/util/IO.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const std::string kDirectory = "NVIDIA/Falcor/GridCache";
+
+// Bump the version when the conversion changes to invalidate existing entries.
+const uint32_t kVersion = 1;
+
+const char kBricksMagic[4] = {'F', 'G', 'B', 'R'};
+
+struct BricksHeader
+{
+    char magic[4];
+    uint32_t version;
+    ResourceFormat atlasFormat;
+    uint3 rangeDim;
+    uint3 atlasDim;
+    uint64_t rangeCount;
+    uint64_t indirectionCount;
+    uint64_t atlasSize;
+};
+
+/// Get the number of texels in a volume, saturating instead of overflowing.
+uint64_t getTexelCount(uint3 dim)
+{
+    uint64_t xy = uint64_t(dim.x) * dim.y;
+    if (dim.z != 0 && xy > std::numeric_limits<uint64_t>::max() / dim.z)
+        return std::numeric_limits<uint64_t>::max();
+    return xy * dim.z;
+}
+
+/**
+ * Check that the sizes in a brick cache header match the file size and the texture dimensions.
+ * The sizes are used to allocate the data and BrickedGridData::createTextures() reads the data based on
+ * the dimensions, so a truncated or corrupt file must not get past this check.
+ */
+bool isValidHeader(const BricksHeader& header, uint64_t fileSize)
+{
+    if (fileSize < sizeof(header))
+        return false;
+    uint64_t payloadSize = fileSize - sizeof(header);
+    if (header.rangeCount > payloadSize / sizeof(uint32_t) || header.indirectionCount > payloadSize / sizeof(uint32_t) ||
+        header.atlasSize > payloadSize)
+        return false;
+    if ((header.rangeCount + header.indirectionCount) * sizeof(uint32_t) + header.atlasSize != payloadSize)
+        return false;
+
+    // The range texture has a full mip chain of kRangeMipCount levels, the indirection texture only mip 0.
+    uint64_t rangeCount = 0;
+    for (uint32_t mip = 0; mip < BrickedGridData::kRangeMipCount; ++mip)
+    {
+        uint64_t mipCount = getTexelCount(max(header.rangeDim >> mip, uint3(1)));
+        if (mipCount > header.rangeCount - rangeCount)
+            return false;
+        rangeCount += mipCount;
+    }
+    if (rangeCount != header.rangeCount || getTexelCount(header.rangeDim) != header.indirectionCount)
+        return false;
+
+    const uint32_t bytesPerBlock = getFormatBytesPerBlock(header.atlasFormat);
+    const uint32_t blockWidth = getFormatWidthCompressionRatio(header.atlasFormat);
+    const uint32_t blockHeight = getFormatHeightCompressionRatio(header.atlasFormat);
+    uint3 atlasBlocks = uint3(div_round_up(header.atlasDim.x, blockWidth), div_round_up(header.atlasDim.y, blockHeight), header.atlasDim.z);
+    uint64_t blockCount = getTexelCount(atlasBlocks);
+    return bytesPerBlock != 0 && blockCount <= header.atlasSize / bytesPerBlock && blockCount * bytesPerBlock == header.atlasSize;
+}
+
+std::mutex sOptionsMutex;
+GridCache::Options sOptions;
+
+/// Get a unique temporary path next to the given path.
+std::filesystem::path getTempPath(const std::filesystem::path& path)
+{
+    static std::atomic<uint64_t> sCounter{0};
+    auto threadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return path.string() + fmt::format(".{:x}.{}.tmp", threadHash, sCounter.fetch_add(1));
+}
+
+/// Move a temporary file to its final location. If another thread or process wrote the same entry first, the temporary file is discarded.
+void commitTempFile(const std::filesystem::path& tempPath, const std::filesystem::path& path)
+{
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+        std::filesystem::remove(tempPath, ec);
+}
+} // namespace
+
+void GridCache::setOptions(const Options& options)
+{
+    std::lock_guard<std::mutex> lock(sOptionsMutex);
+    sOptions = options;
+}
+
+GridCache::Options GridCache::getOptions()
+{
+    std::lock_guard<std::mutex> lock(sOptionsMutex);
+    return sOptions;
+}
+
+std::filesystem::path GridCache::getCacheDirectory()
+{
+    auto options = getOptions();
+    return options.directory.empty() ? getAppDataDirectory() / kDirectory : options.directory;
+}
+
+std::optional<GridCache::Key> GridCache::computeKey(const std::filesystem::path& path, const std::string& gridname)
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs.is_open())
+        return {};
+
+    SHA1 sha1;
+    sha1.update(&kVersion, sizeof(kVersion));
+    const uint32_t nanovdbVersion = NANOVDB_MAJOR_VERSION_NUMBER * 1000 + NANOVDB_MINOR_VERSION_NUMBER;
+    sha1.update(&nanovdbVersion, sizeof(nanovdbVersion));
+    sha1.update(gridname.data(), gridname.size());
+    sha1.update(uint8_t(0));
+
+    std::vector<char> buffer(1 << 20);
+    while (fs)
+    {
+        fs.read(buffer.data(), buffer.size());
+        sha1.update(buffer.data(), (size_t)fs.gcount());
+    }
+    if (fs.bad())
+        return {};
+
+    return sha1.finalize();
+}
+
+std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> GridCache::readGrid(const Key& key)
+{
+    auto cachePath = getCachePath(key, "nvdb");
+    if (!std::filesystem::exists(cachePath))
+        return {};
+
+    try
+    {
+        auto handle = nanovdb::io::readGrid(cachePath.string());
+        if (!handle || !handle.grid<float>())
+            return {};
+        logDebug("Loaded grid from cache '{}'.", cachePath);
+        return handle;
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to read grid cache file '{}': {}", cachePath, e.what());
+        return {};
+    }
+}
+
+void GridCache::writeGrid(const Key& key, const nanovdb::GridHandle<nanovdb::HostBuffer>& handle)
+{
+    auto cachePath = getCachePath(key, "nvdb");
+    auto tempPath = getTempPath(cachePath);
+
+    try
+    {
+        std::filesystem::create_directories(cachePath.parent_path());
+        nanovdb::io::writeGrid(tempPath.string(), handle);
+        commitTempFile(tempPath, cachePath);
+        logDebug("Wrote grid to cache '{}'.", cachePath);
+    }
+    catch (const std::exception& e)
+    {
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        logWarning("Failed to write grid cache file '{}': {}", cachePath, e.what());
+    }
+}
+
+std::optional<BrickedGridData> GridCache::readBricks(const Key& key, ResourceFormat atlasFormat)
+{
+    auto cachePath = getCachePath(key, "bricks");
+    std::ifstream fs(cachePath, std::ios_base::binary);
+    if (!fs.is_open())
+        return {};
+
+    BricksHeader header;
+    fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!fs || std::memcmp(header.magic, kBricksMagic, sizeof(kBricksMagic)) != 0 || header.version != kVersion ||
+        header.atlasFormat != atlasFormat)
+        return {};
+
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(cachePath, ec);
+    if (ec || !isValidHeader(header, fileSize))
+    {
+        logWarning("Ignoring invalid brick cache file '{}'.", cachePath);
+        return {};
+    }
+
+    BrickedGridData data;
+    data.rangeDim = header.rangeDim;
+    data.atlasDim = header.atlasDim;
+    data.atlasFormat = header.atlasFormat;
+    data.range.resize(header.rangeCount);
+    data.indirection.resize(header.indirectionCount);
+    data.atlas.resize(header.atlasSize);
+    fs.read(reinterpret_cast<char*>(data.range.data()), data.range.size() * sizeof(uint32_t));
+    fs.read(reinterpret_cast<char*>(data.indirection.data()), data.indirection.size() * sizeof(uint32_t));
+    fs.read(reinterpret_cast<char*>(data.atlas.data()), data.atlas.size());
+    if (!fs)
+    {
+        logWarning("Failed to read brick cache file '{}'.", cachePath);
+        return {};
+    }
+
+    logDebug("Loaded bricks from cache '{}'.", cachePath);
+    return data;
+}
+
+void GridCache::writeBricks(const Key& key, const BrickedGridData& data)
+{
+    auto cachePath = getCachePath(key, "bricks");
+    auto tempPath = getTempPath(cachePath);
+
+    std::error_code ec;
+    std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+    BricksHeader header;
+    std::memcpy(header.magic, kBricksMagic, sizeof(kBricksMagic));
+    header.version = kVersion;
+    header.atlasFormat = data.atlasFormat;
+    header.rangeDim = data.rangeDim;
+    header.atlasDim = data.atlasDim;
+    header.rangeCount = data.range.size();
+    header.indirectionCount = data.indirection.size();
+    header.atlasSize = data.atlas.size();
+
+    {
+        std::ofstream fs(tempPath, std::ios_base::binary);
+        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        fs.write(reinterpret_cast<const char*>(data.range.data()), data.range.size() * sizeof(uint32_t));
+        fs.write(reinterpret_cast<const char*>(data.indirection.data()), data.indirection.size() * sizeof(uint32_t));
+        fs.write(reinterpret_cast<const char*>(data.atlas.data()), data.atlas.size());
+        if (!fs)
+        {
+            fs.close();
+            std::filesystem::remove(tempPath, ec);
+            logWarning("Failed to write brick cache file '{}'.", cachePath);
+            return;
+        }
+    }
+
+    commitTempFile(tempPath, cachePath);
+    logDebug("Wrote bricks to cache '{}'.", cachePath);
+}
+
+std::filesystem::path GridCache::getCachePath(const Key& key, const char* extension)
+{
+    return getCacheDirectory() / (SHA1::toString(key) + "." + extension);
+}
+} // namespace Falcor
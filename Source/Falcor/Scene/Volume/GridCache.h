@@ -0,0 +1,119 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "BrickedGrid.h"
+#include "Core/Macros.h"
+#include "Utils/CryptoUtils.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244 4267)
+#endif
+#include <nanovdb/util/GridHandle.h>
+#include <nanovdb/util/HostBuffer.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace Falcor
+{
+/**
+ * Disk cache for grids converted from OpenVDB.
+ *
+ * Converting an OpenVDB grid to NanoVDB (and the NanoVDB grid to bricks) is expensive, so the results
+ * are cached on disk. Entries are keyed by the contents of the source file and the grid name, so a
+ * cached grid is reused no matter where the file is located, and a modified file never hits a stale entry.
+ * The NanoVDB grid is stored as a regular `.nvdb` file, the brick data optionally in a `.bricks` file next to it.
+ *
+ * All functions are thread-safe. Entries are written to a temporary file first and then renamed,
+ * so concurrent loads of the same grid never observe partially written files.
+ */
+class FALCOR_API GridCache
+{
+public:
+    using Key = SHA1::MD;
+
+    struct Options
+    {
+        bool enabled = true;                ///< Read and write cached NanoVDB grids.
+        bool cacheBricks = false;           ///< Also cache the brick data (increases the cache size by about the size of the brick atlas).
+        std::filesystem::path directory;    ///< Cache directory. If empty, a directory in the application data directory is used.
+    };
+
+    static void setOptions(const Options& options);
+    static Options getOptions();
+
+    /// Get the cache directory.
+    static std::filesystem::path getCacheDirectory();
+
+    /**
+     * Compute the cache key for a grid.
+     * This reads the whole file, which is still much faster than converting it.
+     * @param[in] path Path of the source file.
+     * @param[in] gridname Name of the grid.
+     * @return Returns the key, or an empty optional if the file cannot be read.
+     */
+    static std::optional<Key> computeKey(const std::filesystem::path& path, const std::string& gridname);
+
+    /**
+     * Read a cached NanoVDB grid.
+     * @param[in] key Cache key.
+     * @return Returns the grid, or an empty optional if there is no valid cache entry.
+     */
+    static std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> readGrid(const Key& key);
+
+    /**
+     * Write a NanoVDB grid to the cache. Failures are logged and otherwise ignored.
+     * @param[in] key Cache key.
+     * @param[in] handle Grid to write.
+     */
+    static void writeGrid(const Key& key, const nanovdb::GridHandle<nanovdb::HostBuffer>& handle);
+
+    /**
+     * Read cached brick data.
+     * @param[in] key Cache key.
+     * @param[in] atlasFormat Expected atlas format. Entries using a different format are ignored.
+     * @return Returns the brick data, or an empty optional if there is no valid cache entry.
+     */
+    static std::optional<BrickedGridData> readBricks(const Key& key, ResourceFormat atlasFormat);
+
+    /**
+     * Write brick data to the cache. Failures are logged and otherwise ignored.
+     * @param[in] key Cache key.
+     * @param[in] data Brick data to write.
+     */
+    static void writeBricks(const Key& key, const BrickedGridData& data);
+
+private:
+    static std::filesystem::path getCachePath(const Key& key, const char* extension);
+};
+} // namespace Falcor
@@ -27,8 +27,8 @@
  **************************************************************************/
 #pragma once
 #include "BrickedGrid.h"
-#include "BC4Encode.h"
 #include "Core/API/Formats.h"
+#include "Utils/Image/BlockCompression.h"
 #include "Utils/Logger.h"
 #include "Utils/HostDeviceShared.slangh"
 #include "Utils/NumericRange.h"
@@ -46,6 +46,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <execution>
 #include <vector>
 
@@ -63,7 +64,21 @@ namespace Falcor
         NanoVDBToBricksConverter(const nanovdb::FloatGrid* grid);
         NanoVDBToBricksConverter(const NanoVDBToBricksConverter& rhs) = delete;
 
-        BrickedGrid convert(ref<Device> pDevice);
+        /** Convert the grid to bricks on the CPU. The converter's buffers are moved into the result, so this can only be called once.
+        */
+        BrickedGridData convertToData();
+
+        BrickedGrid convert(ref<Device> pDevice) { return convertToData().createTextures(pDevice); }
+
+        static ResourceFormat getAtlasFormat()
+        {
+            switch (kBitsPerTexel) {
+            case 4: return ResourceFormat::BC4Unorm;
+            case 8: return ResourceFormat::R8Unorm;
+            case 16: return ResourceFormat::R16Unorm;
+            default: FALCOR_THROW("Unsupported bitdepth in NanoVDBToBricksConverter");
+            }
+        }
 
     private:
         const static uint32_t kBrickSize = 8; // Must be 8, to match both NanoVDB leaf size.
@@ -76,24 +91,14 @@ namespace Falcor
         inline uint3 getAtlasSizePixels() const { return mAtlasSizeBricks * kBrickSize; }
         inline uint32_t getAtlasMaxBrick() const { return mAtlasSizeBricks.x * mAtlasSizeBricks.y * mAtlasSizeBricks.z; }
 
-        inline ResourceFormat getAtlasFormat() {
-            switch (kBitsPerTexel) {
-            case 4: return ResourceFormat::BC4Unorm;
-            case 8: return ResourceFormat::R8Unorm;
-            case 16: return ResourceFormat::R16Unorm;
-            default: FALCOR_THROW("Unsupported bitdepth in NanoVDBToBricksConverter");
-            }
-        }
-
         inline float2 combineMajMin(float2 a, float2 b)
         {
             return float2(std::max(a.x, b.x), std::min(a.y, b.y));
         }
 
-        inline float2 unpackMajMin(const uint32_t* data)
+        inline float2 unpackMajMin(const float* data)
         {
-            const uint16_t* data16 = (const uint16_t*)data;
-            return float2(f16tof32(data16[0]), f16tof32(data16[1]));
+            return float2(data[0], data[1]);
         }
 
         inline void expandMinorantMajorant(float value, float& min_inout, float& maj_inout)
@@ -213,30 +218,37 @@ namespace Falcor
                         }
                     }
                     else {
-                        // BC4 compression:
+                        // BC4 compression: gather the 2x2x8 tiles of the brick and encode them as a batch.
                         float invRange = (255.f) / (majorant - minorant);
-                        uint64_t* atlasdst = ((uint64_t*)mAtlasData.data() + atlasx * (kBrickSize / 4) + atlasy * ((atlasSizePixels.x / 4) * kBrickSize / 4) + atlasz * (pixelsPerSlice / 16 * kBrickSize));
+                        uint8_t tiles[kBrickSize * 4][16];
+                        uint64_t blocks[kBrickSize * 4];
+                        uint8_t* tiledst = &tiles[0][0];
                         for (int pixz = 0; pixz < kBrickSize; ++pixz)
                         {
                             for (int tiley = 0; tiley < kBrickSize; tiley += 4)
                             {
-                                for (int tilex = 0; tilex < kBrickSize; tilex += 4) {
-                                    uint8_t tilevals[4][4];
-                                    uint8_t tileminorant = 255, tilemajorant = 0;
+                                for (int tilex = 0; tilex < kBrickSize; tilex += 4)
+                                {
                                     for (int pixy = 0; pixy < 4; ++pixy)
                                     {
                                         for (int pixx = 0; pixx < 4; ++pixx)
                                         {
                                             float f = data[(pixx + tilex) * (kBrickSize * kBrickSize) + (pixy + tiley) * kBrickSize + pixz];
-                                            uint8_t voxel = uint8_t((f - minorant) * invRange);
-                                            tileminorant = std::min(tileminorant, voxel);
-                                            tilemajorant = std::max(tilemajorant, voxel);
-                                            tilevals[pixy][pixx] = voxel;
+                                            *tiledst++ = uint8_t((f - minorant) * invRange);
                                         }
                                     }
-                                    CompressAlphaDxt5((uint8_t*)&tilevals[0][0], atlasdst);
-                                    atlasdst++;
                                 }
+                            }
+                        }
+                        encodeBC4Blocks(&tiles[0][0], kBrickSize * 4, blocks, BCQuality::High);
+
+                        const uint64_t* blocksrc = blocks;
+                        uint64_t* atlasdst = ((uint64_t*)mAtlasData.data() + atlasx * (kBrickSize / 4) + atlasy * ((atlasSizePixels.x / 4) * kBrickSize / 4) + atlasz * (pixelsPerSlice / 16 * kBrickSize));
+                        for (int pixz = 0; pixz < kBrickSize; ++pixz)
+                        {
+                            for (int tiley = 0; tiley < kBrickSize; tiley += 4)
+                            {
+                                for (int tilex = 0; tilex < kBrickSize; tilex += 4) *atlasdst++ = *blocksrc++;
                                 atlasdst += (atlasSizePixels.x / 4 - kBrickSize / 4); // next scanline
                             }
                             atlasdst += (pixelsPerSlice / 16 - (atlasSizePixels.x / 4 * kBrickSize / 4)); // next slice
@@ -251,29 +263,35 @@ namespace Falcor
     void NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::computeMip(int mip)
     {
         uint32_t* rangedst = mRangeData.data() + mLeafCount[mip - 1];
-        uint32_t* rangesrc = mRangeData.data() + ((mip > 1) ? mLeafCount[mip - 2] : 0);
+        uint32_t srcOffset = (mip > 1) ? mLeafCount[mip - 2] : 0;
         int3 leafdim_src = mLeafDim[mip - 1];
         uint32_t rowstride_src = leafdim_src.x;
         uint32_t slicestride_src = leafdim_src.y * rowstride_src;
 
+        // Unpack the majorant/minorant pairs of the source mip in bulk.
+        uint32_t srcCount = mLeafCount[mip - 1] - srcOffset;
+        std::vector<float> majminsrc(2 * srcCount);
+        math::float16ToFloat32(fstd::span<const uint16_t>((const uint16_t*)(mRangeData.data() + srcOffset), 2 * srcCount), majminsrc);
+        const float* rangesrc = majminsrc.data();
+
         int3 leafdim_tgt = mLeafDim[mip];
         uint32_t rowstride_tgt = leafdim_tgt.x;
         uint32_t slicestride_tgt = leafdim_tgt.y * rowstride_tgt;
 
-        for (int z = 0; z < leafdim_tgt.z; ++z, rangesrc += slicestride_src)
+        for (int z = 0; z < leafdim_tgt.z; ++z, rangesrc += 2 * slicestride_src)
         {
-            for (int y = 0; y < leafdim_tgt.y; ++y, rangesrc += rowstride_src)
+            for (int y = 0; y < leafdim_tgt.y; ++y, rangesrc += 2 * rowstride_src)
             {
-                for (int x = 0; x < leafdim_tgt.x; ++x, rangesrc += 2)
+                for (int x = 0; x < leafdim_tgt.x; ++x, rangesrc += 4)
                 {
                     float2 majmin_dst = combineMajMin(
                         combineMajMin(
-                            combineMajMin(unpackMajMin(rangesrc), unpackMajMin(rangesrc + 1)),
-                            combineMajMin(unpackMajMin(rangesrc + rowstride_src), unpackMajMin(rangesrc + 1 + rowstride_src))
+                            combineMajMin(unpackMajMin(rangesrc), unpackMajMin(rangesrc + 2)),
+                            combineMajMin(unpackMajMin(rangesrc + 2 * rowstride_src), unpackMajMin(rangesrc + 2 + 2 * rowstride_src))
                         ),
                         combineMajMin(
-                            combineMajMin(unpackMajMin(rangesrc + slicestride_src), unpackMajMin(rangesrc + slicestride_src + 1)),
-                            combineMajMin(unpackMajMin(rangesrc + slicestride_src + rowstride_src), unpackMajMin(rangesrc + slicestride_src + 1 + rowstride_src))
+                            combineMajMin(unpackMajMin(rangesrc + 2 * slicestride_src), unpackMajMin(rangesrc + 2 * slicestride_src + 2)),
+                            combineMajMin(unpackMajMin(rangesrc + 2 * slicestride_src + 2 * rowstride_src), unpackMajMin(rangesrc + 2 * slicestride_src + 2 + 2 * rowstride_src))
                         )
                     );
                     *rangedst++ = f32tof16(majmin_dst.x) + (f32tof16(majmin_dst.y) << 16);
@@ -283,20 +301,25 @@ namespace Falcor
     }
 
     template <typename TexelType, unsigned int kBitsPerTexel>
-    BrickedGrid NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convert(ref<Device> pDevice)
+    BrickedGridData NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convertToData()
     {
         auto t0 = CpuTimer::getCurrentTimePoint();
         auto range = NumericRange<int>(0, mLeafDim[0].z);
         std::for_each(std::execution::par, range.begin(), range.end(), [&](int z) { convertSlice(z); });
         for (int mip = 1; mip < 4; ++mip) computeMip(mip);
 
-        BrickedGrid bricks;
-        bricks.range = pDevice->createTexture3D(mLeafDim[0].x, mLeafDim[0].y, mLeafDim[0].z, ResourceFormat::RG16Float, 4, mRangeData.data(), ResourceBindFlags::ShaderResource);
-        bricks.indirection = pDevice->createTexture3D(mLeafDim[0].x, mLeafDim[0].y, mLeafDim[0].z, ResourceFormat::RGBA8Uint, 1, mPtrData.data(), ResourceBindFlags::ShaderResource);
-        bricks.atlas = pDevice->createTexture3D(getAtlasSizePixels().x, getAtlasSizePixels().y, getAtlasSizePixels().z, getAtlasFormat(), 1, mAtlasData.data(), ResourceBindFlags::ShaderResource);
+        BrickedGridData data;
+        data.rangeDim = uint3(mLeafDim[0]);
+        data.atlasDim = getAtlasSizePixels();
+        data.atlasFormat = getAtlasFormat();
+        data.range = std::move(mRangeData);
+        data.indirection = std::move(mPtrData);
+        data.atlas.resize(mAtlasData.size() * sizeof(TexelType));
+        std::memcpy(data.atlas.data(), mAtlasData.data(), data.atlas.size());
+        mAtlasData = {};
 
         double dt = CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint());
         logDebug("Converted '{}' in {:.4}ms: mNonEmptyCount {} vs max {}", mpFloatGrid->gridName(), dt, mNonEmptyCount.load(), getAtlasMaxBrick());
-        return bricks;
+        return data;
     }
 }
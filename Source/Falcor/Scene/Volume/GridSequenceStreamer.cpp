@@ -0,0 +1,155 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GridSequenceStreamer.h"
+#include "Core/API/Device.h"
+#include "Utils/Logger.h"
+#include <BS_thread_pool.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace Falcor
+{
+GridSequenceStreamer::GridSequenceStreamer(
+    ref<Device> pDevice,
+    std::vector<std::filesystem::path> paths,
+    std::string gridname,
+    const GridStreamingScheduler::Config& config,
+    size_t threadCount
+)
+    : mpDevice(pDevice)
+    , mPaths(std::move(paths))
+    , mGridName(std::move(gridname))
+    , mScheduler((uint32_t)mPaths.size(), config)
+    , mGrids(mPaths.size())
+    , mpThreadPool(std::make_unique<BS::thread_pool>((BS::concurrency_t)std::max<size_t>(threadCount, 1)))
+{}
+
+GridSequenceStreamer::~GridSequenceStreamer()
+{
+    for (auto& load : mPendingLoads)
+        load.future.wait();
+    mpThreadPool.reset();
+}
+
+bool GridSequenceStreamer::update(uint32_t playhead)
+{
+    bool changed = false;
+
+    // Collect finished loads and create their GPU resources.
+    for (auto it = mPendingLoads.begin(); it != mPendingLoads.end();)
+    {
+        if (it->future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            completeLoad(it->frame, it->future.get());
+            it = mPendingLoads.erase(it);
+            changed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Execute the plan. Evicted grids stay alive as long as they are referenced elsewhere (e.g. bound to the scene).
+    auto plan = mScheduler.update(playhead);
+    for (uint32_t frame : plan.evictions)
+    {
+        mGrids[frame] = nullptr;
+        changed = true;
+    }
+    for (uint32_t frame : plan.loads)
+    {
+        // Only load and convert the grid on the worker. It does not access the GPU.
+        auto load = [path = mPaths[frame], gridname = mGridName]() { return Grid::loadHostData(path, gridname); };
+        mPendingLoads.push_back({frame, mpThreadPool->submit(load)});
+    }
+
+    return changed;
+}
+
+ref<Grid> GridSequenceStreamer::loadFrame(uint32_t frame)
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    if (mGrids[frame])
+        return mGrids[frame];
+
+    // Wait for a pending load of the same frame rather than loading it twice.
+    auto it = std::find_if(mPendingLoads.begin(), mPendingLoads.end(), [frame](const auto& load) { return load.frame == frame; });
+    if (it != mPendingLoads.end())
+    {
+        completeLoad(frame, it->future.get());
+        mPendingLoads.erase(it);
+        return mGrids[frame];
+    }
+
+    if (mScheduler.getFrameState(frame) == GridStreamingScheduler::FrameState::Failed)
+        return nullptr;
+
+    auto pGrid = Grid::createFromFile(mpDevice, mPaths[frame], mGridName);
+    if (pGrid)
+    {
+        mGrids[frame] = pGrid;
+        mScheduler.markResident(frame, pGrid->getGridSizeInBytes());
+    }
+    return pGrid;
+}
+
+const ref<Grid>& GridSequenceStreamer::getGrid(uint32_t frame) const
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    return mGrids[frame];
+}
+
+ref<Grid> GridSequenceStreamer::getClosestResidentGrid(uint32_t frame) const
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    const uint32_t frameCount = getFrameCount();
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        uint32_t f = (frame + frameCount - i) % frameCount;
+        if (mGrids[f])
+            return mGrids[f];
+    }
+    return nullptr;
+}
+
+void GridSequenceStreamer::completeLoad(uint32_t frame, std::optional<Grid::HostData> hostData)
+{
+    if (hostData)
+    {
+        ref<Grid> pGrid(new Grid(mpDevice, std::move(*hostData)));
+        mGrids[frame] = pGrid;
+        mScheduler.onLoadCompleted(frame, pGrid->getGridSizeInBytes());
+    }
+    else
+    {
+        logWarning("Failed to stream grid '{}' from '{}'.", mGridName, mPaths[frame]);
+        mScheduler.onLoadFailed(frame);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Grid.h"
+#include "GridStreamingScheduler.h"
+#include "Core/Macros.h"
+#include "Core/API/fwd.h"
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace BS
+{
+class thread_pool;
+}
+
+namespace Falcor
+{
+/**
+ * Streams a grid sequence from disk.
+ *
+ * Only a window of frames around the playhead is kept resident. Upcoming frames are loaded
+ * and converted on background threads as decided by a GridStreamingScheduler, and frames
+ * leaving the window are released. The background threads only prepare host data, the GPU
+ * resources are created in update() on the calling thread.
+ */
+class FALCOR_API GridSequenceStreamer
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] paths File paths of the grids, one per frame.
+     * @param[in] gridname Name of the grid to load.
+     * @param[in] config Streaming configuration.
+     * @param[in] threadCount Number of background loading threads.
+     */
+    GridSequenceStreamer(
+        ref<Device> pDevice,
+        std::vector<std::filesystem::path> paths,
+        std::string gridname,
+        const GridStreamingScheduler::Config& config = {},
+        size_t threadCount = 2
+    );
+
+    /**
+     * Destructor.
+     * Blocks until all pending loads have finished.
+     */
+    ~GridSequenceStreamer();
+
+    GridSequenceStreamer(const GridSequenceStreamer&) = delete;
+    GridSequenceStreamer& operator=(const GridSequenceStreamer&) = delete;
+
+    /**
+     * Collect finished loads and schedule loads/evictions for the given playhead.
+     * This is meant to be called once per frame from the main thread.
+     * @param[in] playhead Current frame.
+     * @return True if the set of resident frames changed.
+     */
+    bool update(uint32_t playhead);
+
+    /**
+     * Load a frame synchronously and make it resident.
+     * @param[in] frame Frame index.
+     * @return The grid, or nullptr if it failed to load.
+     */
+    ref<Grid> loadFrame(uint32_t frame);
+
+    /**
+     * Get the grid for a frame.
+     * @param[in] frame Frame index.
+     * @return The grid if the frame is resident, nullptr otherwise.
+     */
+    const ref<Grid>& getGrid(uint32_t frame) const;
+
+    /**
+     * Get the resident grid closest to a frame, searching backwards in playback order.
+     * This is used to keep displaying the previous frame while the current one is still loading.
+     * @param[in] frame Frame index.
+     * @return The grid, or nullptr if no frame is resident.
+     */
+    ref<Grid> getClosestResidentGrid(uint32_t frame) const;
+
+    uint32_t getFrameCount() const { return (uint32_t)mPaths.size(); }
+    const std::string& getGridName() const { return mGridName; }
+    const std::vector<std::filesystem::path>& getPaths() const { return mPaths; }
+    const GridStreamingScheduler& getScheduler() const { return mScheduler; }
+
+private:
+    struct PendingLoad
+    {
+        uint32_t frame;
+        std::future<std::optional<Grid::HostData>> future;
+    };
+
+    void completeLoad(uint32_t frame, std::optional<Grid::HostData> hostData);
+
+    ref<Device> mpDevice;
+    std::vector<std::filesystem::path> mPaths;
+    std::string mGridName;
+    GridStreamingScheduler mScheduler;
+    std::vector<ref<Grid>> mGrids; ///< Resident grids, indexed by frame (nullptr if not resident).
+    std::vector<PendingLoad> mPendingLoads;
+    std::unique_ptr<BS::thread_pool> mpThreadPool;
+};
+} // namespace Falcor
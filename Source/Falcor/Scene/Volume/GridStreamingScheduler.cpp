@@ -0,0 +1,194 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GridStreamingScheduler.h"
+#include "Core/Error.h"
+#include <algorithm>
+
+namespace Falcor
+{
+GridStreamingScheduler::GridStreamingScheduler(uint32_t frameCount, const Config& config) : mConfig(config), mFrames(frameCount)
+{
+    FALCOR_CHECK(frameCount > 0, "Grid sequence must have at least one frame.");
+    FALCOR_CHECK(mConfig.maxConcurrentLoads > 0, "'maxConcurrentLoads' must be at least 1.");
+}
+
+GridStreamingScheduler::Plan GridStreamingScheduler::update(uint32_t playhead)
+{
+    FALCOR_CHECK(playhead < getFrameCount(), "Playhead {} is out of range (frame count is {}).", playhead, getFrameCount());
+
+    Plan plan;
+    const auto window = getWindow(playhead);
+
+    std::vector<bool> inWindow(mFrames.size(), false);
+    for (uint32_t frame : window)
+        inWindow[frame] = true;
+
+    // Evict all resident frames outside the window. Frames that are still loading cannot be
+    // cancelled, they account towards the budget and are evicted once they complete.
+    uint64_t usedBytes = 0;
+    for (uint32_t frame = 0; frame < getFrameCount(); ++frame)
+    {
+        if (inWindow[frame])
+            continue;
+        if (mFrames[frame].state == FrameState::Resident)
+            evict(frame, plan);
+        else if (mFrames[frame].state == FrameState::Loading)
+            usedBytes += getFrameBytes(frame);
+    }
+
+    // Walk the window in priority order. Frames are kept or loaded as long as they fit into the budget.
+    // Once the budget is exhausted all remaining resident frames in the window are evicted.
+    // The frame at the playhead is always kept.
+    bool overBudget = false;
+    for (size_t i = 0; i < window.size(); ++i)
+    {
+        uint32_t frame = window[i];
+        auto& f = mFrames[frame];
+        if (f.state == FrameState::Failed)
+            continue;
+
+        uint64_t frameBytes = getFrameBytes(frame);
+        if (!overBudget && i > 0 && mConfig.memoryBudget > 0 && usedBytes + frameBytes > mConfig.memoryBudget)
+            overBudget = true;
+
+        if (overBudget)
+        {
+            if (f.state == FrameState::Resident)
+                evict(frame, plan);
+            else if (f.state == FrameState::Loading)
+                usedBytes += frameBytes;
+            continue;
+        }
+
+        if (f.state == FrameState::Unloaded)
+        {
+            if (mLoadingFrameCount >= mConfig.maxConcurrentLoads)
+                continue;
+            f.state = FrameState::Loading;
+            mLoadingFrameCount++;
+            plan.loads.push_back(frame);
+        }
+
+        usedBytes += frameBytes;
+    }
+
+    return plan;
+}
+
+void GridStreamingScheduler::onLoadCompleted(uint32_t frame, uint64_t sizeInBytes)
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    auto& f = mFrames[frame];
+    FALCOR_CHECK(f.state == FrameState::Loading, "Frame {} is not loading.", frame);
+
+    FALCOR_ASSERT(mLoadingFrameCount > 0);
+    mLoadingFrameCount--;
+    markResident(frame, sizeInBytes);
+}
+
+void GridStreamingScheduler::onLoadFailed(uint32_t frame)
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    auto& f = mFrames[frame];
+    FALCOR_CHECK(f.state == FrameState::Loading, "Frame {} is not loading.", frame);
+
+    FALCOR_ASSERT(mLoadingFrameCount > 0);
+    mLoadingFrameCount--;
+    f.state = FrameState::Failed;
+}
+
+void GridStreamingScheduler::markResident(uint32_t frame, uint64_t sizeInBytes)
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    auto& f = mFrames[frame];
+    if (f.state == FrameState::Resident)
+        mResidentBytes -= f.sizeInBytes;
+    else
+        mResidentFrameCount++;
+
+    f.state = FrameState::Resident;
+    f.sizeInBytes = sizeInBytes;
+    mResidentBytes += sizeInBytes;
+    mLoadedBytesSum += sizeInBytes;
+    mLoadedFrameCount++;
+}
+
+GridStreamingScheduler::FrameState GridStreamingScheduler::getFrameState(uint32_t frame) const
+{
+    FALCOR_CHECK(frame < getFrameCount(), "Frame {} is out of range.", frame);
+    return mFrames[frame].state;
+}
+
+uint64_t GridStreamingScheduler::getEstimatedFrameBytes() const
+{
+    return mLoadedFrameCount > 0 ? mLoadedBytesSum / mLoadedFrameCount : 0;
+}
+
+std::vector<uint32_t> GridStreamingScheduler::getWindow(uint32_t playhead) const
+{
+    const uint32_t frameCount = getFrameCount();
+    std::vector<uint32_t> window;
+    std::vector<bool> added(frameCount, false);
+
+    auto add = [&](int64_t frame)
+    {
+        if (mConfig.loop)
+            frame = ((frame % frameCount) + frameCount) % frameCount;
+        else if (frame < 0 || frame >= frameCount)
+            return;
+        if (!added[frame])
+        {
+            added[frame] = true;
+            window.push_back((uint32_t)frame);
+        }
+    };
+
+    for (uint32_t i = 0; i <= mConfig.prefetchFrameCount; ++i)
+        add((int64_t)playhead + i);
+    for (uint32_t i = 1; i <= mConfig.retainFrameCount; ++i)
+        add((int64_t)playhead - i);
+
+    return window;
+}
+
+uint64_t GridStreamingScheduler::getFrameBytes(uint32_t frame) const
+{
+    return mFrames[frame].sizeInBytes > 0 ? mFrames[frame].sizeInBytes : getEstimatedFrameBytes();
+}
+
+void GridStreamingScheduler::evict(uint32_t frame, Plan& plan)
+{
+    auto& f = mFrames[frame];
+    FALCOR_ASSERT(f.state == FrameState::Resident);
+    FALCOR_ASSERT(mResidentFrameCount > 0 && mResidentBytes >= f.sizeInBytes);
+    f.state = FrameState::Unloaded;
+    mResidentBytes -= f.sizeInBytes;
+    mResidentFrameCount--;
+    plan.evictions.push_back(frame);
+}
+} // namespace Falcor
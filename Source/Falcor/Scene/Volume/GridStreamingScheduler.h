@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Scheduler deciding which frames of a streamed grid sequence should be resident.
+ *
+ * The scheduler keeps a window of frames around the playhead resident: the current frame,
+ * a number of frames ahead of it (prefetch) and a number of frames behind it (retain).
+ * Frames are requested in order of their distance ahead of the playhead, subject to a
+ * memory budget and a limit on the number of concurrent loads. Resident frames that fall
+ * outside the window or exceed the budget are evicted, the frame at the playhead never is.
+ *
+ * The scheduler does not load anything itself, it only tracks frame states and returns
+ * a plan that the caller executes (see GridSequenceStreamer). This keeps it testable on the CPU.
+ */
+class FALCOR_API GridStreamingScheduler
+{
+public:
+    struct Config
+    {
+        uint32_t prefetchFrameCount = 8;  ///< Number of frames ahead of the playhead to keep resident.
+        uint32_t retainFrameCount = 1;    ///< Number of frames behind the playhead to keep resident.
+        uint32_t maxConcurrentLoads = 2;  ///< Maximum number of frames loading at the same time.
+        uint64_t memoryBudget = 0;        ///< Memory budget in bytes for resident and loading frames (0 = unlimited).
+        bool loop = true;                 ///< Wrap the window around the end of the sequence.
+    };
+
+    enum class FrameState
+    {
+        Unloaded,
+        Loading,
+        Resident,
+        Failed,
+    };
+
+    /// Actions the caller has to execute after a call to update().
+    struct Plan
+    {
+        std::vector<uint32_t> loads;     ///< Frames to start loading, in priority order.
+        std::vector<uint32_t> evictions; ///< Frames to release. These are already marked as unloaded.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] frameCount Number of frames in the sequence.
+     * @param[in] config Configuration.
+     */
+    GridStreamingScheduler(uint32_t frameCount, const Config& config);
+
+    /**
+     * Update the scheduler for a new playhead position.
+     * Frames returned in Plan::loads are marked as loading and must be reported back
+     * using onLoadCompleted() or onLoadFailed().
+     * @param[in] playhead Current frame.
+     * @return Loads and evictions to execute.
+     */
+    Plan update(uint32_t playhead);
+
+    /**
+     * Report a finished load.
+     * @param[in] frame Frame index.
+     * @param[in] sizeInBytes Memory used by the frame.
+     */
+    void onLoadCompleted(uint32_t frame, uint64_t sizeInBytes);
+
+    /**
+     * Report a failed load. Failed frames are not requested again.
+     * @param[in] frame Frame index.
+     */
+    void onLoadFailed(uint32_t frame);
+
+    /**
+     * Mark a frame as resident outside of a scheduled load (e.g. when loaded synchronously).
+     * @param[in] frame Frame index.
+     * @param[in] sizeInBytes Memory used by the frame.
+     */
+    void markResident(uint32_t frame, uint64_t sizeInBytes);
+
+    uint32_t getFrameCount() const { return (uint32_t)mFrames.size(); }
+    const Config& getConfig() const { return mConfig; }
+    FrameState getFrameState(uint32_t frame) const;
+
+    /// Get the memory used by resident frames in bytes.
+    uint64_t getResidentBytes() const { return mResidentBytes; }
+
+    /// Get the number of resident frames.
+    uint32_t getResidentFrameCount() const { return mResidentFrameCount; }
+
+    /// Get the number of frames currently loading.
+    uint32_t getLoadingFrameCount() const { return mLoadingFrameCount; }
+
+    /// Get the estimated size of a frame that has never been loaded (average of all frames loaded so far).
+    uint64_t getEstimatedFrameBytes() const;
+
+private:
+    struct Frame
+    {
+        FrameState state = FrameState::Unloaded;
+        uint64_t sizeInBytes = 0; ///< Size of the frame when it was last loaded (0 if never loaded).
+    };
+
+    /// Get the frames in the window in priority order (playhead, frames ahead, frames behind).
+    std::vector<uint32_t> getWindow(uint32_t playhead) const;
+    uint64_t getFrameBytes(uint32_t frame) const;
+    void evict(uint32_t frame, Plan& plan);
+
+    Config mConfig;
+    std::vector<Frame> mFrames;
+    uint64_t mResidentBytes = 0;
+    uint32_t mResidentFrameCount = 0;
+    uint32_t mLoadingFrameCount = 0;
+    uint64_t mLoadedBytesSum = 0;  ///< Sum of sizes of all completed loads (for estimation).
+    uint32_t mLoadedFrameCount = 0; ///< Number of completed loads (for estimation).
+};
+} // namespace Falcor
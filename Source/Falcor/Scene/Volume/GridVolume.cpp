@@ -29,6 +29,7 @@
 #include "Grid.h"
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "GlobalState.h"
 #include <set>
@@ -78,6 +79,16 @@ namespace Falcor
 
             bool playback = isPlaybackEnabled();
             if (widget.checkbox("Playback", playback)) setPlaybackEnabled(playback);
+
+            for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridSlot::Count; ++slotIndex)
+            {
+                if (const auto& pStreamer = mStreamers[slotIndex])
+                {
+                    const auto& scheduler = pStreamer->getScheduler();
+                    widget.text(fmt::format("Streaming '{}': {} frames resident ({}), {} loading",
+                        pStreamer->getGridName(), scheduler.getResidentFrameCount(), formatByteSize(scheduler.getResidentBytes()), scheduler.getLoadingFrameCount()));
+                }
+            }
         }
 
         if (const auto& densityGrid = getDensityGrid())
@@ -128,9 +139,8 @@ namespace Falcor
     GridVolume::GridSequence GridVolume::createGridSequence(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty)
     {
         GridSequence grids;
-        for (const auto& path : paths)
+        for (auto& grid : Grid::createFromFiles(pDevice, paths, gridname))
         {
-            auto grid = Grid::createFromFile(pDevice, path, gridname);
             if (keepEmpty || grid) grids.push_back(grid);
         }
 
@@ -175,12 +185,51 @@ namespace Falcor
         return loadGridSequence(slot, paths, gridname, keepEmpty);
     }
 
+    uint32_t GridVolume::loadGridSequenceStreamed(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const GridStreamingScheduler::Config& config)
+    {
+        uint32_t slotIndex = (uint32_t)slot;
+        FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
+
+        if (paths.empty())
+        {
+            setGridSequence(slot, {});
+            return 0;
+        }
+
+        // Load the current frame synchronously so the slot has a valid grid from the start.
+        auto pStreamer = std::make_unique<GridSequenceStreamer>(mpDevice, paths, gridname, config);
+        auto pGrid = pStreamer->loadFrame(std::min(mGridFrame, pStreamer->getFrameCount() - 1));
+        setGridSequence(slot, pGrid ? GridSequence{pGrid} : GridSequence{});
+
+        mStreamers[slotIndex] = std::move(pStreamer);
+        updateSequence();
+        updateStreaming();
+
+        return mStreamers[slotIndex]->getFrameCount();
+    }
+
+    bool GridVolume::isGridSequenceStreamed(GridSlot slot) const
+    {
+        return getGridSequenceStreamer(slot) != nullptr;
+    }
+
+    const GridSequenceStreamer* GridVolume::getGridSequenceStreamer(GridSlot slot) const
+    {
+        uint32_t slotIndex = (uint32_t)slot;
+        FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
+
+        return mStreamers[slotIndex].get();
+    }
+
     void GridVolume::setGridSequence(GridSlot slot, const GridSequence& grids)
     {
         uint32_t slotIndex = (uint32_t)slot;
         FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
 
-        if (mGrids[slotIndex] != grids)
+        bool wasStreamed = mStreamers[slotIndex] != nullptr;
+        mStreamers[slotIndex].reset();
+
+        if (mGrids[slotIndex] != grids || wasStreamed)
         {
             mGrids[slotIndex] = grids;
             updateSequence();
@@ -251,6 +300,9 @@ namespace Falcor
             uint32_t frameIndex = (mStartFrame + (uint32_t)std::floor(std::max(0.0, currentTime) * mFrameRate)) % mGridFrameCount;
             setGridFrame(frameIndex);
         }
+
+        // Streamed slots are updated every frame to pick up finished loads.
+        updateStreaming();
     }
 
     void GridVolume::setDensityScale(float densityScale)
@@ -328,10 +380,41 @@ namespace Falcor
     void GridVolume::updateSequence()
     {
         mGridFrameCount = 1;
-        for (const auto& grids : mGrids) mGridFrameCount = std::max(mGridFrameCount, (uint32_t)grids.size());
+        for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridSlot::Count; ++slotIndex)
+        {
+            uint32_t frameCount = mStreamers[slotIndex] ? mStreamers[slotIndex]->getFrameCount() : (uint32_t)mGrids[slotIndex].size();
+            mGridFrameCount = std::max(mGridFrameCount, frameCount);
+        }
         setGridFrame(std::min(mGridFrame, mGridFrameCount - 1));
     }
 
+    void GridVolume::updateStreaming()
+    {
+        bool gridsChanged = false;
+        for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridSlot::Count; ++slotIndex)
+        {
+            const auto& pStreamer = mStreamers[slotIndex];
+            if (!pStreamer) continue;
+
+            uint32_t frame = std::min(mGridFrame, pStreamer->getFrameCount() - 1);
+            pStreamer->update(frame);
+
+            // Keep using the closest previous frame until the current frame has finished loading.
+            auto pGrid = pStreamer->getClosestResidentGrid(frame);
+            if (pGrid && (mGrids[slotIndex].empty() || mGrids[slotIndex][0] != pGrid))
+            {
+                mGrids[slotIndex] = GridSequence{pGrid};
+                gridsChanged = true;
+            }
+        }
+
+        if (gridsChanged)
+        {
+            markUpdates(UpdateFlags::GridsChanged);
+            updateBounds();
+        }
+    }
+
     void GridVolume::updateBounds()
     {
         AABB bounds;
@@ -422,6 +505,20 @@ namespace Falcor
             "slot"_a, "path"_a, "gridnames"_a, "keepEmpty"_a = true
         ); // PYTHONDEPRECATED
 
+        volume.def("loadGridSequenceStreamed",
+            [](GridVolume& self, GridVolume::GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, uint32_t prefetchFrameCount, uint64_t memoryBudget)
+            {
+                std::vector<std::filesystem::path> resolvedPaths;
+                for (const auto& path : paths)
+                    resolvedPaths.push_back(getActiveAssetResolver().resolvePath(path));
+                GridStreamingScheduler::Config config;
+                config.prefetchFrameCount = prefetchFrameCount;
+                config.memoryBudget = memoryBudget;
+                return self.loadGridSequenceStreamed(slot, resolvedPaths, gridname, config);
+            },
+            "slot"_a, "paths"_a, "gridname"_a, "prefetchFrameCount"_a = GridStreamingScheduler::Config().prefetchFrameCount, "memoryBudget"_a = 0
+        );
+
         m.attr("Volume") = m.attr("GridVolume"); // PYTHONDEPRECATED
     }
 }
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Grid.h"
+#include "GridSequenceStreamer.h"
 #include "GridVolumeData.slang"
 #include "Core/Macros.h"
 #include "Utils/Math/AABB.h"
@@ -146,11 +147,32 @@ namespace Falcor
         */
         uint32_t loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty = true);
 
+        /** Load a sequence of grids from files to a grid slot and stream them during playback.
+            Only a window of frames around the current grid frame is kept resident. Upcoming frames are loaded
+            on background threads, and the previously resident frame is used until the current one is ready.
+            Note: This will replace any existing grid sequence for that slot. The current frame is loaded immediately.
+            \param[in] slot Grid slot.
+            \param[in] paths File paths of the grids. Can also include a full path or relative path from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] config Streaming configuration (prefetch window, memory budget).
+            \return Returns the length of the streamed sequence.
+        */
+        uint32_t loadGridSequenceStreamed(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const GridStreamingScheduler::Config& config = {});
+
+        /** Check if the grid sequence for the specified slot is streamed.
+        */
+        bool isGridSequenceStreamed(GridSlot slot) const;
+
+        /** Get the grid streamer for the specified slot, or nullptr if the slot is not streamed.
+        */
+        const GridSequenceStreamer* getGridSequenceStreamer(GridSlot slot) const;
+
         /** Set the grid sequence for the specified slot.
         */
         void setGridSequence(GridSlot slot, const GridSequence& grids);
 
         /** Get the grid sequence for the specified slot.
+            Note: For streamed slots this only contains the grid currently in use.
         */
         const GridSequence& getGridSequence(GridSlot slot) const;
 
@@ -284,6 +306,7 @@ namespace Falcor
 
     private:
         void updateSequence();
+        void updateStreaming();
         void updateBounds();
 
         void markUpdates(UpdateFlags updates);
@@ -292,6 +315,7 @@ namespace Falcor
         ref<Device> mpDevice;
         std::string mName;
         std::array<GridSequence, (size_t)GridSlot::Count> mGrids;
+        std::array<std::unique_ptr<GridSequenceStreamer>, (size_t)GridSlot::Count> mStreamers;
         uint32_t mGridFrame = 0;
         uint32_t mGridFrameCount = 1;
         double mFrameRate = 30.f;
@@ -0,0 +1,127 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ParallelQuantile.h"
+#include "Quantile.h"
+#include "Core/Error.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Utils/Algorithm/ParallelQuantile.cs.slang";
+const uint32_t kGroupSize = 256;
+const uint32_t kElementsPerThread = 16;
+const uint32_t kMaxGroupCount = 65535;
+} // namespace
+
+ParallelQuantile::ParallelQuantile(ref<Device> pDevice) : mpDevice(pDevice)
+{
+    DefineList defines = {
+        {"GROUP_SIZE", std::to_string(kGroupSize)},
+        {"ELEMENTS_PER_THREAD", std::to_string(kElementsPerThread)},
+        {"MAX_BIN_COUNT", std::to_string(RadixSelector::kMaxBinCount)},
+    };
+    mpProgram = Program::createCompute(mpDevice, kShaderFile, "buildHistogram", defines);
+    mpVars = ProgramVars::create(mpDevice, mpProgram.get());
+    mpState = ComputeState::create(mpDevice);
+    mpState->setProgram(mpProgram);
+}
+
+void ParallelQuantile::execute(
+    RenderContext* pRenderContext,
+    const ref<Buffer>& pValues,
+    uint32_t elementCount,
+    fstd::span<const float> quantiles,
+    fstd::span<float> results
+)
+{
+    FALCOR_PROFILE(pRenderContext, "ParallelQuantile::execute");
+
+    FALCOR_ASSERT(pRenderContext);
+    FALCOR_CHECK(elementCount > 0, "Element count must be non-zero.");
+    FALCOR_CHECK(pValues && pValues->getSize() >= elementCount * sizeof(float), "Value buffer is too small.");
+    FALCOR_CHECK(results.size() == quantiles.size(), "Result count does not match quantile count.");
+
+    const uint32_t groupCount = div_round_up(elementCount, kGroupSize * kElementsPerThread);
+    FALCOR_CHECK(groupCount <= kMaxGroupCount, "Element count {} is too large.", elementCount);
+
+    std::vector<QuantileRanks> quantileRanks;
+    std::vector<uint64_t> ranks;
+    for (float quantile : quantiles)
+    {
+        quantileRanks.push_back(QuantileRanks::compute(elementCount, quantile));
+        ranks.push_back(quantileRanks.back().lower);
+        ranks.push_back(quantileRanks.back().upper);
+    }
+
+    RadixSelector selector(elementCount, ranks);
+
+    auto var = mpVars->getRootVar();
+    var["gValues"] = pValues;
+
+    while (!selector.isDone())
+    {
+        const auto& prefixes = selector.getPrefixes();
+        const uint32_t binCount = selector.getBinCount();
+        const uint32_t histogramSize = (uint32_t)prefixes.size() * binCount;
+
+        if (!mpHistograms || mpHistograms->getSize() < histogramSize * sizeof(uint32_t))
+        {
+            mpHistograms = mpDevice->createBuffer(
+                histogramSize * sizeof(uint32_t), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal
+            );
+            mpHistograms->setName("ParallelQuantile::mpHistograms");
+        }
+        pRenderContext->clearUAV(mpHistograms->getUAV().get(), uint4(0));
+        var["gHistograms"] = mpHistograms;
+
+        // Build one histogram per prefix.
+        for (uint32_t i = 0; i < prefixes.size(); ++i)
+        {
+            var["CB"]["gElementCount"] = elementCount;
+            var["CB"]["gPrefix"] = prefixes[i];
+            var["CB"]["gPrefixBits"] = selector.getPrefixBits();
+            var["CB"]["gDigitShift"] = selector.getDigitShift();
+            var["CB"]["gBinCount"] = binCount;
+            var["CB"]["gHistogramOffset"] = i * binCount;
+            pRenderContext->dispatch(mpState.get(), mpVars.get(), {groupCount, 1, 1});
+            pRenderContext->uavBarrier(mpHistograms.get());
+        }
+
+        // Read back the histograms. This flushes the GPU.
+        std::vector<uint32_t> histograms = mpHistograms->getElements<uint32_t>(0, histogramSize);
+        selector.refine(histograms);
+    }
+
+    for (size_t i = 0; i < quantiles.size(); ++i)
+        results[i] = quantileRanks[i].interpolate(selector.getValue(2 * i), selector.getValue(2 * i + 1));
+}
+} // namespace Falcor
@@ -0,0 +1,78 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/State/ComputeState.h"
+#include "Core/Program/Program.h"
+#include "Core/Program/ProgramVars.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+
+namespace Falcor
+{
+class RenderContext;
+
+/**
+ * Computes exact quantiles of a buffer of floats on the GPU.
+ *
+ * This uses the same radix selection as computeQuantiles() (see RadixSelector). The digit histograms are
+ * built on the GPU and read back, which is at most a few KB per digit instead of the whole buffer.
+ * Each of the three digits requires a GPU flush. The results match computeQuantiles() exactly.
+ */
+class FALCOR_API ParallelQuantile
+{
+public:
+    /// Constructor. Throws an exception if creation failed.
+    ParallelQuantile(ref<Device> pDevice);
+
+    /**
+     * Compute quantiles.
+     * @param[in] pRenderContext The render context.
+     * @param[in] pValues Buffer of 32-bit floats, bound as Buffer<float>.
+     * @param[in] elementCount Number of values, must be non-zero.
+     * @param[in] quantiles Quantiles in [0,1].
+     * @param[out] results Quantile values, one per quantile.
+     */
+    void execute(
+        RenderContext* pRenderContext,
+        const ref<Buffer>& pValues,
+        uint32_t elementCount,
+        fstd::span<const float> quantiles,
+        fstd::span<float> results
+    );
+
+private:
+    ref<Device> mpDevice;
+
+    ref<ComputeState> mpState;
+    ref<Program> mpProgram;
+    ref<ProgramVars> mpVars;
+
+    ref<Buffer> mpHistograms; ///< Digit histograms, one per prefix.
+};
+} // namespace Falcor
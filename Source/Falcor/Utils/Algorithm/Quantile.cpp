@@ -0,0 +1,241 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Quantile.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kDigitBits[RadixSelector::kLevelCount] = {11, 11, 10};
+const uint32_t kDigitShift[RadixSelector::kLevelCount] = {21, 10, 0};
+const uint32_t kPrefixBits[RadixSelector::kLevelCount] = {0, 11, 22};
+
+/// Minimum number of values per chunk when building histograms in parallel.
+const size_t kMinChunkSize = 1 << 16;
+/// Maximum number of chunks, limits the memory used for per-chunk histograms.
+const size_t kMaxChunkCount = 256;
+} // namespace
+
+RadixSelector::RadixSelector(uint64_t elementCount, fstd::span<const uint64_t> ranks)
+{
+    mTargets.reserve(ranks.size());
+    for (uint64_t rank : ranks)
+    {
+        FALCOR_CHECK(rank < elementCount, "Rank {} is out of range (element count is {}).", rank, elementCount);
+        mTargets.push_back({rank, 0});
+    }
+    if (mTargets.empty())
+        mLevel = kLevelCount;
+    else
+        updatePrefixes();
+}
+
+uint32_t RadixSelector::getBinCount() const
+{
+    FALCOR_ASSERT(mLevel < kLevelCount);
+    return 1u << kDigitBits[mLevel];
+}
+
+uint32_t RadixSelector::getDigitShift() const
+{
+    FALCOR_ASSERT(mLevel < kLevelCount);
+    return kDigitShift[mLevel];
+}
+
+uint32_t RadixSelector::getPrefixBits() const
+{
+    FALCOR_ASSERT(mLevel < kLevelCount);
+    return kPrefixBits[mLevel];
+}
+
+void RadixSelector::refine(fstd::span<const uint32_t> histograms)
+{
+    FALCOR_CHECK(!isDone(), "All keys are already resolved.");
+    const uint32_t binCount = getBinCount();
+    FALCOR_CHECK(histograms.size() == mPrefixes.size() * binCount, "Expected {} histogram bins.", mPrefixes.size() * binCount);
+
+    for (auto& target : mTargets)
+    {
+        size_t prefixIndex = std::lower_bound(mPrefixes.begin(), mPrefixes.end(), target.prefix) - mPrefixes.begin();
+        const uint32_t* histogram = histograms.data() + prefixIndex * binCount;
+
+        // Find the bin containing the rank.
+        uint64_t count = 0;
+        uint32_t digit = 0;
+        while (digit < binCount && target.rank >= count + histogram[digit])
+            count += histogram[digit++];
+        FALCOR_CHECK(digit < binCount, "Histogram does not contain rank {}.", target.rank);
+
+        target.rank -= count;
+        target.prefix = (target.prefix << kDigitBits[mLevel]) | digit;
+    }
+
+    if (++mLevel < kLevelCount)
+        updatePrefixes();
+}
+
+float RadixSelector::getValue(size_t rankIndex) const
+{
+    FALCOR_CHECK(isDone(), "Keys are not resolved yet.");
+    FALCOR_CHECK(rankIndex < mTargets.size(), "Rank index {} is out of range.", rankIndex);
+    return orderedKeyToFloat(mTargets[rankIndex].prefix);
+}
+
+void RadixSelector::updatePrefixes()
+{
+    mPrefixes.clear();
+    for (const auto& target : mTargets)
+        mPrefixes.push_back(target.prefix);
+    std::sort(mPrefixes.begin(), mPrefixes.end());
+    mPrefixes.erase(std::unique(mPrefixes.begin(), mPrefixes.end()), mPrefixes.end());
+}
+
+QuantileRanks QuantileRanks::compute(uint64_t elementCount, float quantile)
+{
+    FALCOR_CHECK(elementCount > 0, "Element count must be non-zero.");
+    FALCOR_CHECK(quantile >= 0.f && quantile <= 1.f, "Quantile {} is out of range [0,1].", quantile);
+
+    double position = (double)quantile * (double)(elementCount - 1);
+    QuantileRanks ranks;
+    ranks.lower = std::min((uint64_t)position, elementCount - 1);
+    ranks.upper = std::min(ranks.lower + 1, elementCount - 1);
+    ranks.weight = (float)(position - (double)ranks.lower);
+    return ranks;
+}
+
+void selectOrderStatistics(fstd::span<const float> values, fstd::span<const uint64_t> ranks, fstd::span<float> results)
+{
+    FALCOR_CHECK(results.size() == ranks.size(), "Result count does not match rank count.");
+
+    RadixSelector selector(values.size(), ranks);
+
+    const size_t chunkSize = std::max(kMinChunkSize, (values.size() + kMaxChunkCount - 1) / kMaxChunkCount);
+    const size_t chunkCount = (values.size() + chunkSize - 1) / chunkSize;
+    std::vector<uint32_t> chunkHistograms;
+    std::vector<uint32_t> histograms;
+
+    while (!selector.isDone())
+    {
+        const auto& prefixes = selector.getPrefixes();
+        const uint32_t binCount = selector.getBinCount();
+        const size_t histogramSize = prefixes.size() * binCount;
+        chunkHistograms.assign(chunkCount * histogramSize, 0);
+
+        // With several prefixes, most values typically match none of them. These are rejected by a lookup
+        // of the first digit before searching the prefixes.
+        std::vector<uint8_t> firstDigitMask(1u << kDigitBits[0], 0);
+        if (prefixes.size() > 1)
+        {
+            for (uint32_t prefix : prefixes)
+                firstDigitMask[prefix >> (selector.getPrefixBits() - kDigitBits[0])] = 1;
+        }
+
+        // Build histograms per chunk in parallel.
+        auto buildChunk = [&](size_t chunk)
+        {
+            uint32_t* histogram = chunkHistograms.data() + chunk * histogramSize;
+            const size_t end = std::min(values.size(), (chunk + 1) * chunkSize);
+            if (prefixes.size() == 1)
+            {
+                for (size_t i = chunk * chunkSize; i < end; ++i)
+                {
+                    uint32_t key = floatToOrderedKey(values[i]);
+                    if (selector.matchesPrefix(key, prefixes[0]))
+                        histogram[selector.getDigit(key)]++;
+                }
+            }
+            else
+            {
+                const uint32_t prefixShift = 32 - selector.getPrefixBits();
+                for (size_t i = chunk * chunkSize; i < end; ++i)
+                {
+                    uint32_t key = floatToOrderedKey(values[i]);
+                    if (!firstDigitMask[key >> kDigitShift[0]])
+                        continue;
+                    auto it = std::lower_bound(prefixes.begin(), prefixes.end(), key >> prefixShift);
+                    if (it != prefixes.end() && *it == (key >> prefixShift))
+                        histogram[(it - prefixes.begin()) * binCount + selector.getDigit(key)]++;
+                }
+            }
+        };
+        auto range = NumericRange<size_t>(0, chunkCount);
+        std::for_each(std::execution::par, range.begin(), range.end(), buildChunk);
+
+        // Sum the chunk histograms.
+        histograms.assign(histogramSize, 0);
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            const uint32_t* histogram = chunkHistograms.data() + chunk * histogramSize;
+            for (size_t i = 0; i < histogramSize; ++i)
+                histograms[i] += histogram[i];
+        }
+
+        selector.refine(histograms);
+    }
+
+    for (size_t i = 0; i < ranks.size(); ++i)
+        results[i] = selector.getValue(i);
+}
+
+void computeQuantiles(fstd::span<const float> values, fstd::span<const float> quantiles, fstd::span<float> results)
+{
+    FALCOR_CHECK(!values.empty(), "Values must not be empty.");
+    FALCOR_CHECK(results.size() == quantiles.size(), "Result count does not match quantile count.");
+
+    std::vector<QuantileRanks> quantileRanks;
+    std::vector<uint64_t> ranks;
+    for (float quantile : quantiles)
+    {
+        quantileRanks.push_back(QuantileRanks::compute(values.size(), quantile));
+        ranks.push_back(quantileRanks.back().lower);
+        ranks.push_back(quantileRanks.back().upper);
+    }
+
+    std::vector<float> rankValues(ranks.size());
+    selectOrderStatistics(values, ranks, rankValues);
+
+    for (size_t i = 0; i < quantiles.size(); ++i)
+        results[i] = quantileRanks[i].interpolate(rankValues[2 * i], rankValues[2 * i + 1]);
+}
+
+float computeQuantile(fstd::span<const float> values, float quantile)
+{
+    float result;
+    computeQuantiles(values, fstd::span<const float>(&quantile, 1), fstd::span<float>(&result, 1));
+    return result;
+}
+
+float computeMedian(fstd::span<const float> values)
+{
+    return computeQuantile(values, 0.5f);
+}
+} // namespace Falcor
@@ -0,0 +1,173 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Map a float to a 32-bit key with the same ordering (-inf < ... < -0 < +0 < ... < +inf).
+ * NaNs are ordered by their sign bit below -inf or above +inf.
+ */
+inline uint32_t floatToOrderedKey(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits ^ ((bits & 0x80000000u) ? 0xffffffffu : 0x80000000u);
+}
+
+/// Inverse of floatToOrderedKey().
+inline float orderedKeyToFloat(uint32_t key)
+{
+    uint32_t bits = key ^ ((key & 0x80000000u) ? 0x80000000u : 0xffffffffu);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Exact selection of order statistics (k-th smallest values) using radix selection.
+ *
+ * Values are mapped to ordered 32-bit keys, which are resolved in three digits of 11, 11 and 10 bits.
+ * For each digit, a histogram of the digit is built over all values whose key starts with the prefix
+ * resolved so far, and the bin containing the requested rank extends the prefix. This takes three
+ * passes over the data instead of a full sort.
+ *
+ * The selector only holds the selection state, the histograms are built by the caller. This allows
+ * building them in parallel on the CPU (see selectOrderStatistics()) or on the GPU (see ParallelQuantile).
+ */
+class FALCOR_API RadixSelector
+{
+public:
+    static constexpr uint32_t kLevelCount = 3;
+    static constexpr uint32_t kMaxBinCount = 2048;
+
+    /**
+     * Constructor.
+     * @param[in] elementCount Number of values.
+     * @param[in] ranks Ranks to select (0 is the smallest value). Must be less than elementCount.
+     */
+    RadixSelector(uint64_t elementCount, fstd::span<const uint64_t> ranks);
+
+    /// Returns true when all keys are resolved.
+    bool isDone() const { return mLevel == kLevelCount; }
+
+    /// Get the current level (digit index).
+    uint32_t getLevel() const { return mLevel; }
+
+    /// Get the number of histogram bins at the current level.
+    uint32_t getBinCount() const;
+
+    /// Get the bit offset of the current digit in the key.
+    uint32_t getDigitShift() const;
+
+    /// Get the number of key bits resolved so far (length of the prefixes).
+    uint32_t getPrefixBits() const;
+
+    /// Get the distinct prefixes at the current level, in increasing order. A histogram is needed for each.
+    const std::vector<uint32_t>& getPrefixes() const { return mPrefixes; }
+
+    /// Returns true if a key matches a prefix at the current level.
+    bool matchesPrefix(uint32_t key, uint32_t prefix) const { return getPrefixBits() == 0 || (key >> (32 - getPrefixBits())) == prefix; }
+
+    /// Get the histogram bin of a key at the current level.
+    uint32_t getDigit(uint32_t key) const { return (key >> getDigitShift()) & (getBinCount() - 1); }
+
+    /**
+     * Resolve the current digit and advance to the next level.
+     * @param[in] histograms Histograms of the current digit, one after another for each prefix in getPrefixes().
+     */
+    void refine(fstd::span<const uint32_t> histograms);
+
+    /// Get the selected value for a rank. Only valid when isDone() returns true.
+    float getValue(size_t rankIndex) const;
+
+private:
+    struct Target
+    {
+        uint64_t rank; ///< Rank of the value among the values matching the prefix.
+        uint32_t prefix;
+    };
+
+    void updatePrefixes();
+
+    std::vector<Target> mTargets;
+    std::vector<uint32_t> mPrefixes;
+    uint32_t mLevel = 0;
+};
+
+/**
+ * Ranks of the two order statistics to interpolate for a quantile.
+ * Quantiles are linearly interpolated between the closest ranks (the default method in NumPy),
+ * so the quantile 0.5 is the median and the quantile 1 is the maximum.
+ */
+struct FALCOR_API QuantileRanks
+{
+    uint64_t lower = 0;
+    uint64_t upper = 0;
+    float weight = 0.f; ///< Interpolation weight of the upper value.
+
+    /**
+     * Compute the ranks for a quantile.
+     * @param[in] elementCount Number of values, must be non-zero.
+     * @param[in] quantile Quantile in [0,1].
+     */
+    static QuantileRanks compute(uint64_t elementCount, float quantile);
+
+    float interpolate(float lowerValue, float upperValue) const
+    {
+        return weight == 0.f ? lowerValue : lowerValue * (1.f - weight) + upperValue * weight;
+    }
+};
+
+/**
+ * Select order statistics of an array of values. The values are processed in parallel.
+ * @param[in] values Values.
+ * @param[in] ranks Ranks to select (0 is the smallest value). Must be less than the number of values.
+ * @param[out] results Selected values, one per rank.
+ */
+FALCOR_API void selectOrderStatistics(fstd::span<const float> values, fstd::span<const uint64_t> ranks, fstd::span<float> results);
+
+/**
+ * Compute quantiles of an array of values. The values are processed in parallel.
+ * @param[in] values Values, must not be empty.
+ * @param[in] quantiles Quantiles in [0,1].
+ * @param[out] results Quantile values, one per quantile.
+ */
+FALCOR_API void computeQuantiles(fstd::span<const float> values, fstd::span<const float> quantiles, fstd::span<float> results);
+
+/// Compute a single quantile of an array of values.
+FALCOR_API float computeQuantile(fstd::span<const float> values, float quantile);
+
+/// Compute the median of an array of values. For an even number of values, the two middle values are averaged.
+FALCOR_API float computeMedian(fstd::span<const float> values);
+} // namespace Falcor
@@ -54,13 +54,16 @@ void PixelDebug::beginFrame(RenderContext* pRenderContext, const uint2& frameDim
     mFrameDim = frameDim;
     mRunning = true;
 
-    // Reset previous data.
-    mPrintData.clear();
-    mAssertData.clear();
-    mDataValid = false;
-    mWaitingForData = false;
-
-    if (mEnabled)
+    if (!mEnabled)
+    {
+        // Reset previous data.
+        if (mpReadback)
+            mpReadback->reset();
+        mPrintData.clear();
+        mAssertData.clear();
+        mDataValid = false;
+    }
+    else
     {
         // Prepare buffers.
         if (!mpPrintBuffer)
@@ -71,12 +74,8 @@ void PixelDebug::beginFrame(RenderContext* pRenderContext, const uint2& frameDim
             mpPrintBuffer = pDevice->createStructuredBuffer(sizeof(PrintRecord), mPrintCapacity);
             mpAssertBuffer = pDevice->createStructuredBuffer(sizeof(AssertRecord), mAssertCapacity);
 
-            // Allocate readback buffer. This buffer is shared for copying all the above buffers to the CPU
-            mpReadbackBuffer = pDevice->createBuffer(
-                mpCounterBuffer->getSize() + mpPrintBuffer->getSize() + mpAssertBuffer->getSize(),
-                ResourceBindFlags::None,
-                MemoryType::ReadBack
-            );
+            // Allocate readback ring. Each slot is shared for copying all the above buffers to the CPU.
+            mpReadback = ReadbackRing::create(pDevice, mpCounterBuffer->getSize() + mpPrintBuffer->getSize() + mpAssertBuffer->getSize());
         }
 
         pRenderContext->clearUAV(mpCounterBuffer->getUAV().get(), uint4(0));
@@ -91,25 +90,20 @@ void PixelDebug::endFrame(RenderContext* pRenderContext)
 
     if (mEnabled)
     {
-        // Copy logged data to staging buffers.
-        uint32_t dst = 0;
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), dst, mpCounterBuffer.get(), 0, mpCounterBuffer->getSize());
+        // Copy logged data to staging buffers. If all slots are in flight, the oldest data is dropped.
+        mpReadback->beginWrite();
+        uint64_t dst = mpReadback->getWriteOffset();
+        const ref<Buffer>& pReadbackBuffer = mpReadback->getBuffer();
+        pRenderContext->copyBufferRegion(pReadbackBuffer.get(), dst, mpCounterBuffer.get(), 0, mpCounterBuffer->getSize());
         dst += mpCounterBuffer->getSize();
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), dst, mpPrintBuffer.get(), 0, mpPrintBuffer->getSize());
+        pRenderContext->copyBufferRegion(pReadbackBuffer.get(), dst, mpPrintBuffer.get(), 0, mpPrintBuffer->getSize());
         dst += mpPrintBuffer->getSize();
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), dst, mpAssertBuffer.get(), 0, mpAssertBuffer->getSize());
+        pRenderContext->copyBufferRegion(pReadbackBuffer.get(), dst, mpAssertBuffer.get(), 0, mpAssertBuffer->getSize());
         dst += mpAssertBuffer->getSize();
-        FALCOR_ASSERT(dst == mpReadbackBuffer->getSize());
-
-        // Create fence first time we need it.
-        if (!mpFence)
-            mpFence = mpDevice->createFence();
+        FALCOR_ASSERT(dst == mpReadback->getWriteOffset() + mpReadback->getSlotSize());
 
         // Submit command list and insert signal.
-        pRenderContext->submit(false);
-        pRenderContext->signal(mpFence.get());
-
-        mWaitingForData = true;
+        mpReadback->endWrite(pRenderContext);
     }
 }
 
@@ -249,16 +243,13 @@ bool PixelDebug::onMouseEvent(const MouseEvent& mouseEvent)
 bool PixelDebug::copyDataToCPU()
 {
     FALCOR_ASSERT(!mRunning);
-    if (mWaitingForData)
+    if (mEnabled && mpReadback)
     {
-        // Wait for signal.
-        mpFence->wait();
-        mWaitingForData = false;
-
-        if (mEnabled)
+        // Copy the latest available data from the readback ring to CPU buffers.
+        mReadbackData.resize(mpReadback->getSlotSize());
+        if (mpReadback->readLatest(mReadbackData.data()))
         {
-            // Copy data from readback buffer to CPU buffers.
-            const uint8_t* data = reinterpret_cast<const uint8_t*>(mpReadbackBuffer->map(Buffer::MapType::Read));
+            const uint8_t* data = mReadbackData.data();
             const uint32_t* counterData = reinterpret_cast<const uint32_t*>(data);
             data += mpCounterBuffer->getSize();
             const PrintRecord* printData = reinterpret_cast<const PrintRecord*>(data);
@@ -271,7 +262,6 @@ bool PixelDebug::copyDataToCPU()
             mPrintData.assign(printData, printData + printCount);
             mAssertData.assign(assertData, assertData + assertCount);
 
-            mpReadbackBuffer->unmap();
             mDataValid = true;
             return true;
         }
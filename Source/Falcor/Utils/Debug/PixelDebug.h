@@ -29,7 +29,7 @@
 #include "PixelDebugTypes.slang"
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
-#include "Core/API/Fence.h"
+#include "Core/API/ReadbackRing.h"
 #include "Core/Program/Program.h"
 #include "Utils/UI/Gui.h"
 #include <memory>
@@ -61,6 +61,7 @@ class RenderContext;
  *
  * The shader code is disabled (using macros) when debugging is off.
  * When enabled, async readback is used but expect a minor perf loss.
+ * The readback does not stall the GPU, the displayed data is from the latest frame that is available on the CPU.
  */
 class FALCOR_API PixelDebug
 {
@@ -97,8 +98,7 @@ protected:
     ref<Buffer> mpCounterBuffer;   ///< Counter buffer (print, assert) on the GPU.
     ref<Buffer> mpPrintBuffer;     ///< Print buffer on the GPU.
     ref<Buffer> mpAssertBuffer;    ///< Assert buffer on the GPU.
-    ref<Buffer> mpReadbackBuffer;  ///< Staging buffer for async readback of all data.
-    ref<Fence> mpFence;            ///< GPU fence for sychronizing readback.
+    ref<ReadbackRing> mpReadback;  ///< Ring of staging buffers for async readback of all data.
 
     // Configuration
     bool mEnabled = false;         ///< Enable debugging features.
@@ -108,13 +108,13 @@ protected:
     uint2 mFrameDim = {0, 0};
 
     bool mRunning = false;        ///< True when data collection is running (inbetween begin()/end() calls).
-    bool mWaitingForData = false; ///< True if we are waiting for data to become available on the GPU.
     bool mDataValid = false;      ///< True if data has been read back and is valid.
 
     std::unordered_map<uint32_t, std::string> mHashToString; ///< Map of string hashes to string values.
 
     std::vector<PrintRecord> mPrintData;   ///< Print data read back from the GPU.
     std::vector<AssertRecord> mAssertData; ///< Assert log data read back from the GPU.
+    std::vector<uint8_t> mReadbackData;    ///< Temporary storage for data read back from the GPU.
 
     const uint32_t mPrintCapacity = 0;  ///< Capacity of the print buffer in elements.
     const uint32_t mAssertCapacity = 0; ///< Capacity of the assert buffer in elements.
@@ -75,6 +75,13 @@ std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
     return mLoadRequestQueue.back().promise.get_future();
 }
 
+void AsyncTextureLoader::run(LoadTask task)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mLoadRequestQueue.push(LoadRequest{{}, false, false, ResourceBindFlags::None, {}, std::move(task)});
+    mCondition.notify_one();
+}
+
 void AsyncTextureLoader::runWorkers(size_t threadCount)
 {
     // Create a barrier to synchronize worker threads before issuing a global flush.
@@ -132,7 +139,11 @@ void AsyncTextureLoader::runWorker()
 
         // Load the textures (this part is running in parallel).
         ref<Texture> pTexture;
-        if (request.paths.size() == 1)
+        if (request.task)
+        {
+            request.task();
+        }
+        else if (request.paths.size() == 1)
         {
             pTexture =
                 Texture::createFromFile(mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags);
@@ -153,7 +164,7 @@ void AsyncTextureLoader::runWorker()
 
         // Issue a global flush if necessary.
         // TODO: It would be better to check the size of the upload heap instead.
-        if (!mTerminate && pTexture != nullptr && ++mUploadCounter >= kUploadsPerFlush)
+        if (!mTerminate && (pTexture != nullptr || request.task) && ++mUploadCounter >= kUploadsPerFlush)
         {
             mFlushPending = true;
             mCondition.notify_all();
@@ -51,6 +51,7 @@ class FALCOR_API AsyncTextureLoader
 {
 public:
     using LoadCallback = std::function<void(ref<Texture> pTexture)>;
+    using LoadTask = std::function<void()>;
 
     /**
      * Constructor.
@@ -96,6 +97,14 @@ public:
         LoadCallback callback = {}
     );
 
+    /**
+     * Request running a custom load task.
+     * This is used for loads that don't map to a single texture, such as UDIM sets packed into texture arrays.
+     * The task is responsible for notifying the caller when it has finished.
+     * @param[in] task Function called from a worker thread.
+     */
+    void run(LoadTask task);
+
 private:
     void runWorkers(size_t threadCount);
     void runWorker();
@@ -108,6 +117,7 @@ private:
         bool loadAsSRGB;
         ResourceBindFlags bindFlags;
         LoadCallback callback;
+        LoadTask task; ///< Custom load task. If set, the other fields are unused.
         std::promise<ref<Texture>> promise;
     };
 
@@ -66,17 +66,27 @@ static bool isConvertibleToRGBA32Float(ResourceFormat format)
  */
 static std::vector<float> convertHalfToRGBA32Float(uint32_t width, uint32_t height, uint32_t channelCount, const void* pData)
 {
-    std::vector<float> newData(width * height * 4u, 0.f);
-    const float16_t* pSrc = reinterpret_cast<const float16_t*>(pData);
-    float* pDst = newData.data();
+    const size_t pixelCount = (size_t)width * height;
+    const size_t valueCount = pixelCount * channelCount;
+    std::vector<float> newData(pixelCount * 4u, 0.f);
+    const uint16_t* pSrc = reinterpret_cast<const uint16_t*>(pData);
 
-    for (uint32_t i = 0; i < width * height; ++i)
+    if (channelCount == 4)
     {
-        for (uint32_t c = 0; c < channelCount; ++c)
+        math::float16ToFloat32(fstd::span<const uint16_t>(pSrc, valueCount), newData);
+        return newData;
+    }
+
+    // Convert in bulk to the start of the buffer, then spread the pixels out back to front.
+    math::float16ToFloat32(fstd::span<const uint16_t>(pSrc, valueCount), fstd::span<float>(newData.data(), valueCount));
+    for (size_t i = pixelCount; i-- > 0;)
+    {
+        for (uint32_t c = channelCount; c-- > 0;)
         {
-            *pDst++ = float(*pSrc++);
+            float value = newData[i * channelCount + c];
+            newData[i * channelCount + c] = 0.f;
+            newData[i * 4 + c] = value;
         }
-        pDst += (4 - channelCount);
     }
 
     return newData;
@@ -0,0 +1,654 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockCompression.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <limits>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define FALCOR_BC_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_BC_SSE2 0
+#endif
+
+namespace Falcor
+{
+namespace
+{
+// BC4 ------------------------------------------------------------------------
+
+/// Widen a range to at least 'steps' values (as in libsquish).
+void fixRange(int& min, int& max, int steps)
+{
+    if (max - min < steps)
+        max = std::min(min + steps, 255);
+    if (max - min < steps)
+        min = std::max(0, max - steps);
+}
+
+struct BC4Range
+{
+    int min5, max5; ///< Range excluding 0 and 255 for the 6-value mode.
+    int min7, max7; ///< Full range for the 8-value mode.
+};
+
+/**
+ * Fit values to an 8 entry codebook.
+ * Each value is assigned the first code with the least squared error.
+ * @return Total squared error.
+ */
+int fitBC4Codes(const uint8_t* pValues, const uint8_t* pCodes, uint8_t* pIndices)
+{
+#if FALCOR_BC_SSE2
+    const __m128i values = _mm_loadu_si128((const __m128i*)pValues);
+    __m128i best = _mm_set1_epi8((char)0xff);
+    __m128i indices = _mm_setzero_si128();
+    // Walk the codes backwards and accept ties, so that the first code with the least error wins.
+    for (int j = 7; j >= 0; --j)
+    {
+        const __m128i code = _mm_set1_epi8((char)pCodes[j]);
+        const __m128i dist = _mm_or_si128(_mm_subs_epu8(values, code), _mm_subs_epu8(code, values));
+        const __m128i mask = _mm_cmpeq_epi8(_mm_min_epu8(dist, best), dist);
+        best = _mm_min_epu8(dist, best);
+        indices = _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi8((char)j)), _mm_andnot_si128(mask, indices));
+    }
+    _mm_storeu_si128((__m128i*)pIndices, indices);
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(best, zero);
+    const __m128i hi = _mm_unpackhi_epi8(best, zero);
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int err = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int least = std::numeric_limits<int>::max();
+        int index = 0;
+        for (int j = 0; j < 8; ++j)
+        {
+            int dist = (int)pValues[i] - (int)pCodes[j];
+            dist *= dist;
+            if (dist < least)
+            {
+                least = dist;
+                index = j;
+            }
+        }
+        pIndices[i] = (uint8_t)index;
+        err += least;
+    }
+    return err;
+#endif
+}
+
+BC4Range computeBC4Range(const uint8_t* pValues)
+{
+    BC4Range r;
+#if FALCOR_BC_SSE2
+    auto hmin = [](__m128i v)
+    {
+        v = _mm_min_epu8(v, _mm_srli_si128(v, 8));
+        v = _mm_min_epu8(v, _mm_srli_si128(v, 4));
+        v = _mm_min_epu8(v, _mm_srli_si128(v, 2));
+        v = _mm_min_epu8(v, _mm_srli_si128(v, 1));
+        return _mm_cvtsi128_si32(v) & 0xff;
+    };
+    auto hmax = [](__m128i v)
+    {
+        v = _mm_max_epu8(v, _mm_srli_si128(v, 8));
+        v = _mm_max_epu8(v, _mm_srli_si128(v, 4));
+        v = _mm_max_epu8(v, _mm_srli_si128(v, 2));
+        v = _mm_max_epu8(v, _mm_srli_si128(v, 1));
+        return _mm_cvtsi128_si32(v) & 0xff;
+    };
+    const __m128i values = _mm_loadu_si128((const __m128i*)pValues);
+    r.min7 = hmin(values);
+    r.max7 = hmax(values);
+    // Exclude 0 from the minimum by mapping it to 255, and 255 from the maximum by mapping it to 0.
+    r.min5 = hmin(_mm_or_si128(values, _mm_cmpeq_epi8(values, _mm_setzero_si128())));
+    r.max5 = hmax(_mm_andnot_si128(_mm_cmpeq_epi8(values, _mm_set1_epi8((char)0xff)), values));
+#else
+    r.min5 = r.min7 = 255;
+    r.max5 = r.max7 = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int value = pValues[i];
+        r.min7 = std::min(r.min7, value);
+        r.max7 = std::max(r.max7, value);
+        if (value != 0)
+            r.min5 = std::min(r.min5, value);
+        if (value != 255)
+            r.max5 = std::max(r.max5, value);
+    }
+#endif
+    return r;
+}
+
+void writeBC4Block(int alpha0, int alpha1, const uint8_t* pIndices, uint8_t* pBlock)
+{
+    pBlock[0] = (uint8_t)alpha0;
+    pBlock[1] = (uint8_t)alpha1;
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; ++i)
+        bits |= (uint64_t)pIndices[i] << (3 * i);
+    for (int i = 0; i < 6; ++i)
+        pBlock[2 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+void encodeBC4BlockImpl(const uint8_t* pValues, uint8_t* pBlock, BCQuality quality)
+{
+    BC4Range r = computeBC4Range(pValues);
+    if (r.min7 > r.max7)
+        r.min7 = r.max7;
+    fixRange(r.min7, r.max7, 7);
+
+    // The 8-value mode. Codes are stored with min first and written with alpha0 > alpha1.
+    uint8_t codes7[8];
+    codes7[0] = (uint8_t)r.min7;
+    codes7[1] = (uint8_t)r.max7;
+    for (int i = 1; i < 7; ++i)
+        codes7[1 + i] = (uint8_t)(((7 - i) * r.min7 + i * r.max7) / 7);
+    uint8_t indices7[16];
+    int err7 = fitBC4Codes(pValues, codes7, indices7);
+
+    if (quality == BCQuality::High)
+    {
+        // The 6-value mode with explicit 0 and 255. It is stored with alpha0 <= alpha1.
+        if (r.min5 > r.max5)
+            r.min5 = r.max5;
+        fixRange(r.min5, r.max5, 5);
+        uint8_t codes5[8];
+        codes5[0] = (uint8_t)r.min5;
+        codes5[1] = (uint8_t)r.max5;
+        for (int i = 1; i < 5; ++i)
+            codes5[1 + i] = (uint8_t)(((5 - i) * r.min5 + i * r.max5) / 5);
+        codes5[6] = 0;
+        codes5[7] = 255;
+        uint8_t indices5[16];
+        int err5 = fitBC4Codes(pValues, codes5, indices5);
+
+        if (err5 <= err7)
+        {
+            FALCOR_ASSERT(r.min5 <= r.max5);
+            writeBC4Block(r.min5, r.max5, indices5, pBlock);
+            return;
+        }
+    }
+
+    // Swap the endpoints so that alpha0 > alpha1, which selects the 8-value mode.
+    uint8_t swapped[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        uint8_t index = indices7[i];
+        swapped[i] = index == 0 ? 1 : index == 1 ? 0 : (uint8_t)(9 - index);
+    }
+    writeBC4Block(r.max7, r.min7, swapped, pBlock);
+}
+
+// BC1 ------------------------------------------------------------------------
+
+struct Color
+{
+    float r, g, b;
+};
+
+uint16_t packRGB565(const Color& c)
+{
+    auto quantize = [](float v, int maxValue) { return (uint16_t)std::lround(std::clamp(v, 0.f, 255.f) * maxValue / 255.f); };
+    return (uint16_t)((quantize(c.r, 31) << 11) | (quantize(c.g, 63) << 5) | quantize(c.b, 31));
+}
+
+void unpackRGB565(uint16_t c, int* pRGB)
+{
+    int r = (c >> 11) & 31;
+    int g = (c >> 5) & 63;
+    int b = c & 31;
+    pRGB[0] = (r << 3) | (r >> 2);
+    pRGB[1] = (g << 2) | (g >> 4);
+    pRGB[2] = (b << 3) | (b >> 2);
+}
+
+/// Compute the palette as decoded by the hardware. Endpoint order selects 4-color or 3-color mode.
+void computeBC1Palette(uint16_t c0, uint16_t c1, int palette[4][3])
+{
+    unpackRGB565(c0, palette[0]);
+    unpackRGB565(c1, palette[1]);
+    for (int k = 0; k < 3; ++k)
+    {
+        if (c0 > c1)
+        {
+            palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+            palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+        }
+        else
+        {
+            palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+            palette[3][k] = 0;
+        }
+    }
+}
+
+/// Block pixels in structure-of-arrays layout.
+struct BC1Pixels
+{
+    alignas(16) float r[16];
+    alignas(16) float g[16];
+    alignas(16) float b[16];
+};
+
+/**
+ * Assign each pixel the first palette entry with the least squared error.
+ * All values are integers, so the float arithmetic is exact and both paths agree.
+ * @return Total squared error.
+ */
+float fitBC1Indices(const BC1Pixels& px, uint16_t c0, uint16_t c1, uint8_t* pIndices)
+{
+    int palette[4][3];
+    computeBC1Palette(c0, c1, palette);
+
+#if FALCOR_BC_SSE2
+    __m128 err = _mm_setzero_ps();
+    for (int i = 0; i < 16; i += 4)
+    {
+        const __m128 r = _mm_load_ps(px.r + i);
+        const __m128 g = _mm_load_ps(px.g + i);
+        const __m128 b = _mm_load_ps(px.b + i);
+        __m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+        __m128i indices = _mm_setzero_si128();
+        for (int k = 0; k < 4; ++k)
+        {
+            const __m128 dr = _mm_sub_ps(r, _mm_set1_ps((float)palette[k][0]));
+            const __m128 dg = _mm_sub_ps(g, _mm_set1_ps((float)palette[k][1]));
+            const __m128 db = _mm_sub_ps(b, _mm_set1_ps((float)palette[k][2]));
+            const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+            const __m128i mask = _mm_castps_si128(_mm_cmplt_ps(dist, best));
+            best = _mm_min_ps(dist, best);
+            indices = _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi32(k)), _mm_andnot_si128(mask, indices));
+        }
+        err = _mm_add_ps(err, best);
+        alignas(16) int32_t idx[4];
+        _mm_store_si128((__m128i*)idx, indices);
+        for (int j = 0; j < 4; ++j)
+            pIndices[i + j] = (uint8_t)idx[j];
+    }
+    alignas(16) float sums[4];
+    _mm_store_ps(sums, err);
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#else
+    float sums[4] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        float best = std::numeric_limits<float>::max();
+        int index = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+            float dr = px.r[i] - palette[k][0];
+            float dg = px.g[i] - palette[k][1];
+            float db = px.b[i] - palette[k][2];
+            float dist = (dr * dr + dg * dg) + db * db;
+            if (dist < best)
+            {
+                best = dist;
+                index = k;
+            }
+        }
+        pIndices[i] = (uint8_t)index;
+        sums[i % 4] += best;
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+}
+
+struct BC1Candidate
+{
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+    uint8_t indices[16] = {};
+    float err = std::numeric_limits<float>::max();
+};
+
+/// Quantize a pair of endpoints, fit the indices and keep the result if it improves on the best candidate.
+void tryBC1Endpoints(const BC1Pixels& px, const Color& e0, const Color& e1, BC1Candidate& best)
+{
+    uint16_t c0 = packRGB565(e0);
+    uint16_t c1 = packRGB565(e1);
+    // Prefer the 4-color mode, which requires c0 > c1. Equal endpoints fall back to the 3-color mode.
+    if (c0 < c1)
+        std::swap(c0, c1);
+    if (best.err < std::numeric_limits<float>::max() && c0 == best.c0 && c1 == best.c1)
+        return;
+
+    BC1Candidate candidate;
+    candidate.c0 = c0;
+    candidate.c1 = c1;
+    candidate.err = fitBC1Indices(px, c0, c1, candidate.indices);
+    if (candidate.err < best.err)
+        best = candidate;
+}
+
+/// Solve for the endpoints that minimize the squared error for fixed 4-color mode indices.
+bool solveBC1Endpoints(const BC1Pixels& px, const uint8_t* pIndices, Color& e0, Color& e1)
+{
+    static const float kWeights[4] = {1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+    float aa = 0.f, bb = 0.f, ab = 0.f;
+    Color ax = {}, bx = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        float a = kWeights[pIndices[i]];
+        float b = 1.f - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        ax.r += a * px.r[i], ax.g += a * px.g[i], ax.b += a * px.b[i];
+        bx.r += b * px.r[i], bx.g += b * px.g[i], bx.b += b * px.b[i];
+    }
+    float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f)
+        return false;
+    float invDet = 1.f / det;
+    e0 = {(ax.r * bb - bx.r * ab) * invDet, (ax.g * bb - bx.g * ab) * invDet, (ax.b * bb - bx.b * ab) * invDet};
+    e1 = {(bx.r * aa - ax.r * ab) * invDet, (bx.g * aa - ax.g * ab) * invDet, (bx.b * aa - ax.b * ab) * invDet};
+    return true;
+}
+
+void encodeBC1BlockImpl(const uint8_t* pRGBA, uint8_t* pBlock, BCQuality quality)
+{
+    BC1Pixels px;
+    Color mean = {}, lo = {255.f, 255.f, 255.f}, hi = {0.f, 0.f, 0.f};
+    for (int i = 0; i < 16; ++i)
+    {
+        px.r[i] = pRGBA[4 * i + 0];
+        px.g[i] = pRGBA[4 * i + 1];
+        px.b[i] = pRGBA[4 * i + 2];
+        mean.r += px.r[i], mean.g += px.g[i], mean.b += px.b[i];
+        lo = {std::min(lo.r, px.r[i]), std::min(lo.g, px.g[i]), std::min(lo.b, px.b[i])};
+        hi = {std::max(hi.r, px.r[i]), std::max(hi.g, px.g[i]), std::max(hi.b, px.b[i])};
+    }
+    mean = {mean.r / 16.f, mean.g / 16.f, mean.b / 16.f};
+
+    // Covariance matrix (xx, xy, xz, yy, yz, zz).
+    float cov[6] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        float r = px.r[i] - mean.r, g = px.g[i] - mean.g, b = px.b[i] - mean.b;
+        cov[0] += r * r, cov[1] += r * g, cov[2] += r * b;
+        cov[3] += g * g, cov[4] += g * b, cov[5] += b * b;
+    }
+
+    Color e0, e1;
+    if (quality == BCQuality::Fast)
+    {
+        // Bounding box diagonal, flipped along green/blue to follow the correlation with red.
+        e0 = hi;
+        e1 = lo;
+        if (cov[1] < 0.f)
+            std::swap(e0.g, e1.g);
+        if (cov[2] < 0.f)
+            std::swap(e0.b, e1.b);
+    }
+    else
+    {
+        // Principal axis by power iteration, starting from the bounding box diagonal.
+        Color axis = {hi.r - lo.r, hi.g - lo.g, hi.b - lo.b};
+        for (int iter = 0; iter < 8; ++iter)
+        {
+            Color v = {
+                cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b,
+                cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b,
+                cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b,
+            };
+            float len = std::max({std::abs(v.r), std::abs(v.g), std::abs(v.b)});
+            if (len < 1e-6f)
+                break;
+            axis = {v.r / len, v.g / len, v.b / len};
+        }
+
+        // Use the pixels with the extreme projections onto the axis as endpoints.
+        float minProj = std::numeric_limits<float>::max(), maxProj = -std::numeric_limits<float>::max();
+        int minIndex = 0, maxIndex = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            float proj = px.r[i] * axis.r + px.g[i] * axis.g + px.b[i] * axis.b;
+            if (proj < minProj)
+                minProj = proj, minIndex = i;
+            if (proj > maxProj)
+                maxProj = proj, maxIndex = i;
+        }
+        e0 = {px.r[maxIndex], px.g[maxIndex], px.b[maxIndex]};
+        e1 = {px.r[minIndex], px.g[minIndex], px.b[minIndex]};
+    }
+
+    // Inset the endpoints by 1/16 of the range to reduce the error at the interpolated colors.
+    Color inset = {(e0.r - e1.r) / 16.f, (e0.g - e1.g) / 16.f, (e0.b - e1.b) / 16.f};
+    e0 = {e0.r - inset.r, e0.g - inset.g, e0.b - inset.b};
+    e1 = {e1.r + inset.r, e1.g + inset.g, e1.b + inset.b};
+
+    BC1Candidate best;
+    tryBC1Endpoints(px, e0, e1, best);
+
+    if (quality == BCQuality::High)
+    {
+        // Refine the endpoints for the current indices. The solver assumes the 4-color mode.
+        for (int iter = 0; iter < 2 && best.c0 > best.c1; ++iter)
+        {
+            if (!solveBC1Endpoints(px, best.indices, e0, e1))
+                break;
+            BC1Candidate prev = best;
+            tryBC1Endpoints(px, e0, e1, best);
+            if (best.err >= prev.err)
+                break;
+        }
+    }
+
+    pBlock[0] = (uint8_t)(best.c0 & 0xff);
+    pBlock[1] = (uint8_t)(best.c0 >> 8);
+    pBlock[2] = (uint8_t)(best.c1 & 0xff);
+    pBlock[3] = (uint8_t)(best.c1 >> 8);
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; ++i)
+        bits |= (uint32_t)best.indices[i] << (2 * i);
+    std::memcpy(pBlock + 4, &bits, sizeof(bits));
+}
+
+/// Gather a 4x4 block of pixels with 'channels' bytes each, replicating the last row/column at the image border.
+void gatherBlock(
+    const uint8_t* pSrc,
+    uint32_t width,
+    uint32_t height,
+    size_t rowPitch,
+    uint32_t channels,
+    uint32_t bx,
+    uint32_t by,
+    uint8_t* pBlock
+)
+{
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        const uint8_t* pRow = pSrc + std::min(by * 4 + y, height - 1) * rowPitch;
+        for (uint32_t x = 0; x < 4; ++x)
+        {
+            const uint8_t* pPixel = pRow + std::min(bx * 4 + x, width - 1) * channels;
+            std::memcpy(pBlock + (y * 4 + x) * channels, pPixel, channels);
+        }
+    }
+}
+} // namespace
+
+void encodeBC1Block(const uint8_t* pRGBA, void* pBlock, BCQuality quality)
+{
+    encodeBC1BlockImpl(pRGBA, (uint8_t*)pBlock, quality);
+}
+
+void encodeBC4Block(const uint8_t* pValues, void* pBlock, BCQuality quality)
+{
+    encodeBC4BlockImpl(pValues, (uint8_t*)pBlock, quality);
+}
+
+void encodeBC5Block(const uint8_t* pRG, void* pBlock, BCQuality quality)
+{
+    uint8_t red[16], green[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        red[i] = pRG[2 * i + 0];
+        green[i] = pRG[2 * i + 1];
+    }
+    encodeBC4BlockImpl(red, (uint8_t*)pBlock, quality);
+    encodeBC4BlockImpl(green, (uint8_t*)pBlock + 8, quality);
+}
+
+void encodeBC4Blocks(const uint8_t* pTiles, size_t blockCount, uint64_t* pBlocks, BCQuality quality)
+{
+    for (size_t i = 0; i < blockCount; ++i)
+        encodeBC4BlockImpl(pTiles + i * 16, (uint8_t*)(pBlocks + i), quality);
+}
+
+void encodeBCImage(
+    ResourceFormat format,
+    const uint8_t* pSrc,
+    uint32_t width,
+    uint32_t height,
+    size_t srcRowPitch,
+    void* pDst,
+    BCQuality quality
+)
+{
+    uint32_t channels = 0;
+    switch (format)
+    {
+    case ResourceFormat::BC1Unorm:
+    case ResourceFormat::BC1UnormSrgb:
+        channels = 4;
+        break;
+    case ResourceFormat::BC4Unorm:
+        channels = 1;
+        break;
+    case ResourceFormat::BC5Unorm:
+        channels = 2;
+        break;
+    default:
+        FALCOR_THROW("Unsupported format '{}' for block compression.", to_string(format));
+    }
+    FALCOR_CHECK(width > 0 && height > 0, "Image must not be empty.");
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t blockSize = getFormatBytesPerBlock(format);
+
+    auto range = NumericRange<uint32_t>(0, blocksY);
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](uint32_t by)
+        {
+            uint8_t* pDstRow = (uint8_t*)pDst + (size_t)by * blocksX * blockSize;
+            uint8_t block[64];
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                gatherBlock(pSrc, width, height, srcRowPitch, channels, bx, by, block);
+                uint8_t* pBlock = pDstRow + (size_t)bx * blockSize;
+                if (channels == 4)
+                    encodeBC1BlockImpl(block, pBlock, quality);
+                else if (channels == 1)
+                    encodeBC4BlockImpl(block, pBlock, quality);
+                else
+                    encodeBC5Block(block, pBlock, quality);
+            }
+        }
+    );
+}
+
+void decodeBC1Block(const void* pBlock, uint8_t* pRGBA)
+{
+    const uint8_t* pBytes = (const uint8_t*)pBlock;
+    uint16_t c0 = (uint16_t)(pBytes[0] | (pBytes[1] << 8));
+    uint16_t c1 = (uint16_t)(pBytes[2] | (pBytes[3] << 8));
+    uint32_t bits;
+    std::memcpy(&bits, pBytes + 4, sizeof(bits));
+
+    int palette[4][3];
+    computeBC1Palette(c0, c1, palette);
+    for (int i = 0; i < 16; ++i)
+    {
+        uint32_t index = (bits >> (2 * i)) & 3;
+        pRGBA[4 * i + 0] = (uint8_t)palette[index][0];
+        pRGBA[4 * i + 1] = (uint8_t)palette[index][1];
+        pRGBA[4 * i + 2] = (uint8_t)palette[index][2];
+        // Index 3 is transparent black in the 3-color mode.
+        pRGBA[4 * i + 3] = (c0 <= c1 && index == 3) ? 0 : 255;
+    }
+}
+
+void decodeBC4Block(const void* pBlock, uint8_t* pValues)
+{
+    const uint8_t* pBytes = (const uint8_t*)pBlock;
+    int a0 = pBytes[0];
+    int a1 = pBytes[1];
+    uint8_t codes[8];
+    codes[0] = (uint8_t)a0;
+    codes[1] = (uint8_t)a1;
+    if (a0 > a1)
+    {
+        for (int k = 2; k < 8; ++k)
+            codes[k] = (uint8_t)(((8 - k) * a0 + (k - 1) * a1) / 7);
+    }
+    else
+    {
+        for (int k = 2; k < 6; ++k)
+            codes[k] = (uint8_t)(((6 - k) * a0 + (k - 1) * a1) / 5);
+        codes[6] = 0;
+        codes[7] = 255;
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i)
+        bits |= (uint64_t)pBytes[2 + i] << (8 * i);
+    for (int i = 0; i < 16; ++i)
+        pValues[i] = codes[(bits >> (3 * i)) & 7];
+}
+
+void decodeBC5Block(const void* pBlock, uint8_t* pRG)
+{
+    uint8_t red[16], green[16];
+    decodeBC4Block(pBlock, red);
+    decodeBC4Block((const uint8_t*)pBlock + 8, green);
+    for (int i = 0; i < 16; ++i)
+    {
+        pRG[2 * i + 0] = red[i];
+        pRG[2 * i + 1] = green[i];
+    }
+}
+} // namespace Falcor
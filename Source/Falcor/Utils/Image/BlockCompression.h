@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * CPU block compression encoders and decoders for BC1, BC4 and BC5.
+ *
+ * The encoders operate on 4x4 blocks of 8-bit values. The inner loops (endpoint search and
+ * index fitting) are vectorized with SSE2 on x86-64, other platforms use an equivalent scalar
+ * path that produces identical output.
+ *
+ * The BC4 encoder at BCQuality::High produces the same blocks as the libsquish-derived
+ * encoder in Scene/Volume/BC4Encode.h.
+ */
+
+enum class BCQuality
+{
+    Fast, ///< Single endpoint fit. BC4 only tries the 8-value mode, BC1 uses the bounding box diagonal.
+    High, ///< BC4 tries both modes, BC1 uses the principal axis and refines the endpoints with least squares.
+};
+
+/**
+ * Encode a BC1 block.
+ * @param[in] pRGBA 16 pixels in RGBA8 format, row-major. Alpha is ignored.
+ * @param[out] pBlock 8 bytes of BC1 encoded data.
+ * @param[in] quality Quality setting.
+ */
+FALCOR_API void encodeBC1Block(const uint8_t* pRGBA, void* pBlock, BCQuality quality = BCQuality::High);
+
+/**
+ * Encode a BC4 block.
+ * @param[in] pValues 16 values, row-major.
+ * @param[out] pBlock 8 bytes of BC4 encoded data.
+ * @param[in] quality Quality setting.
+ */
+FALCOR_API void encodeBC4Block(const uint8_t* pValues, void* pBlock, BCQuality quality = BCQuality::High);
+
+/**
+ * Encode a BC5 block.
+ * @param[in] pRG 16 pixels in RG8 format, row-major.
+ * @param[out] pBlock 16 bytes of BC5 encoded data.
+ * @param[in] quality Quality setting.
+ */
+FALCOR_API void encodeBC5Block(const uint8_t* pRG, void* pBlock, BCQuality quality = BCQuality::High);
+
+/**
+ * Encode a batch of BC4 blocks.
+ * This is meant for callers that gather their own tiles (e.g. brick atlases).
+ * @param[in] pTiles Tiles of 16 values each, stored contiguously.
+ * @param[in] blockCount Number of tiles.
+ * @param[out] pBlocks Encoded blocks, one 64-bit word per tile.
+ * @param[in] quality Quality setting.
+ */
+FALCOR_API void encodeBC4Blocks(const uint8_t* pTiles, size_t blockCount, uint64_t* pBlocks, BCQuality quality = BCQuality::High);
+
+/**
+ * Encode an image. Block rows are encoded in parallel.
+ * Image dimensions that are not a multiple of 4 are padded by replicating the last row/column.
+ * @param[in] format Destination format. Supported are BC1Unorm, BC1UnormSrgb, BC4Unorm and BC5Unorm.
+ * @param[in] pSrc Source pixels in RGBA8 (BC1), R8 (BC4) or RG8 (BC5) format.
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ * @param[in] srcRowPitch Source row pitch in bytes.
+ * @param[out] pDst Destination blocks. Must hold ceil(width/4) * ceil(height/4) blocks, stored row-major.
+ * @param[in] quality Quality setting.
+ */
+FALCOR_API void encodeBCImage(
+    ResourceFormat format,
+    const uint8_t* pSrc,
+    uint32_t width,
+    uint32_t height,
+    size_t srcRowPitch,
+    void* pDst,
+    BCQuality quality = BCQuality::High
+);
+
+/**
+ * Decode a BC1 block.
+ * @param[in] pBlock 8 bytes of BC1 encoded data.
+ * @param[out] pRGBA 16 pixels in RGBA8 format.
+ */
+FALCOR_API void decodeBC1Block(const void* pBlock, uint8_t* pRGBA);
+
+/**
+ * Decode a BC4 block.
+ * @param[in] pBlock 8 bytes of BC4 encoded data.
+ * @param[out] pValues 16 values.
+ */
+FALCOR_API void decodeBC4Block(const void* pBlock, uint8_t* pValues);
+
+/**
+ * Decode a BC5 block.
+ * @param[in] pBlock 16 bytes of BC5 encoded data.
+ * @param[out] pRG 16 pixels in RG8 format.
+ */
+FALCOR_API void decodeBC5Block(const void* pBlock, uint8_t* pRG);
+} // namespace Falcor
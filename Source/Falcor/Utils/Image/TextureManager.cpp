@@ -26,12 +26,17 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TextureManager.h"
+#include "Bitmap.h"
+#include "UdimArrayLayout.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 #include "Utils/NumericRange.h"
 
+#include <cstring>
 #include <execution>
+#include <functional>
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -43,6 +48,80 @@ namespace
 {
 const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
 static_assert(TextureManager::CpuTextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+const uint32_t kMaxTextureArrayCount = 1u << TextureHandle::kTextureArrayIDBits;
+const uint32_t kMaxTextureArraySize = 1u << TextureHandle::kTextureArraySliceBits;
+
+static constexpr bool kTopDown = true; // Memory layout when loading from file
+
+/// Tile of a UDIM set.
+struct UdimTile
+{
+    uint32_t udim = 0;
+    std::filesystem::path path;                  ///< Path of the tile, possibly containing <MIP>.
+    std::vector<std::filesystem::path> mipPaths; ///< Paths of the mip levels found on disk.
+    std::vector<Bitmap::UniqueConstPtr> mips;    ///< Loaded mip levels. Empty if the tile needs to be loaded as a texture.
+};
+
+/**
+ * Locate and load the mip levels of a UDIM tile. This is called from worker threads.
+ * DDS files are not loaded, as they are loaded as individual textures.
+ */
+void loadUdimTile(UdimTile& tile)
+{
+    std::string filename = tile.path.filename().string();
+    auto mipPos = filename.find("<MIP>");
+    if (mipPos == std::string::npos)
+    {
+        tile.mipPaths.push_back(tile.path);
+    }
+    else
+    {
+        while (true)
+        {
+            std::string basename = std::string(filename).replace(mipPos, 5, "mip" + std::to_string(tile.mipPaths.size()));
+            std::filesystem::path mipPath = tile.path.parent_path() / basename;
+            if (!std::filesystem::exists(mipPath))
+                break;
+            tile.mipPaths.push_back(mipPath);
+        }
+    }
+
+    if (tile.mipPaths.empty() || hasExtension(tile.mipPaths[0], "dds"))
+        return;
+
+    try
+    {
+        for (const auto& mipPath : tile.mipPaths)
+        {
+            Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(mipPath, kTopDown);
+            if (!pBitmap)
+            {
+                logWarning("Error loading mip {} of UDIM tile '{}'.", tile.mips.size(), mipPath);
+                break;
+            }
+            if (!tile.mips.empty())
+            {
+                const auto& pPrev = tile.mips.back();
+                if (pPrev->getFormat() != pBitmap->getFormat() || std::max(pPrev->getWidth() / 2, 1u) != pBitmap->getWidth() ||
+                    std::max(pPrev->getHeight() / 2, 1u) != pBitmap->getHeight())
+                {
+                    logWarning(
+                        "Error loading mip {} of UDIM tile '{}'. Mip levels must halve in size and share a format.",
+                        tile.mips.size(),
+                        mipPath
+                    );
+                    break;
+                }
+            }
+            tile.mips.emplace_back(std::move(pBitmap));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Error loading UDIM tile '{}': {}", tile.path, e.what());
+    }
+}
 } // namespace
 
 TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount)
@@ -110,7 +189,8 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
     ResourceBindFlags bindFlags,
     bool async,
     const AssetResolver* assetResolver,
-    size_t* loadedTextureCount
+    size_t* loadedTextureCount,
+    bool packUdimTiles
 )
 {
     std::string filename = path.filename().string();
@@ -122,7 +202,7 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
 
     auto pos = filename.find("<UDIM>");
     if (pos == std::string::npos)
-        return loadTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async);
+        return loadTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async, assetResolver, loadedTextureCount);
 
     std::filesystem::path dirpath = path.parent_path();
     filename.replace(pos, 6, "[1-9][0-9][0-9][0-9]");
@@ -148,11 +228,11 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
     if (loadedTextureCount)
         *loadedTextureCount = texturePaths.size();
 
-    std::vector<size_t> udimIndices;
-    std::vector<CpuTextureHandle> handles;
+    std::vector<UdimTile> tiles(texturePaths.size());
     size_t maxIndex = 0;
-    for (auto& it : texturePaths)
+    for (size_t i = 0; i < texturePaths.size(); ++i)
     {
+        auto& it = texturePaths[i];
         std::string textureFilename = it.filename().string();
         std::string udimStr = textureFilename.substr(pos, 4); // the 4 digits
         // Insert the udim number into the original filename (before potentially stripping <MIP>)
@@ -160,23 +240,178 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
         std::string newFilename = srcStr.replace(srcStr.find("<UDIM>"), 6, udimStr);
         it = it.parent_path() / newFilename;
         size_t udim = std::stol(udimStr);
-        maxIndex = std::max<size_t>(maxIndex, udim);
-        udimIndices.push_back(udim);
-        handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async));
-
         FALCOR_CHECK(udim >= 1001, "Texture {} is not a valid UDIM texture, as it violates the valid UDIM range of 1001-9999", it);
+        maxIndex = std::max<size_t>(maxIndex, udim);
+        tiles[i].udim = (uint32_t)udim;
+        tiles[i].path = it;
     }
 
+    // Return the existing handle if the UDIM set is already managed.
+    // Otherwise reserve the indirection range right away, so that the handle can be returned before the tiles are loaded.
     // UDIM range needs to cover all numbers from 1001 to maxIndex inclusive, so 1001, 1002, 1003 needs 3 indices
-    size_t rangeStart = getUdimRange(maxIndex - 1001 + 1);
+    const UdimKey udimKey{TextureKey(texturePaths, generateMipLevels, loadAsSRGB, bindFlags), packUdimTiles};
+    CpuTextureHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (auto it = mUdimKeyToHandle.find(udimKey); it != mUdimKeyToHandle.end())
+            return it->second;
 
-    for (size_t i = 0; i < texturePaths.size(); ++i)
+        handle = CpuTextureHandle(getUdimRange(maxIndex - 1001 + 1), true);
+        mUdimKeyToHandle[udimKey] = handle;
+    }
+
+    // Load the tiles, create the textures and fill in the indirection range.
+    auto loadTiles = [=](std::vector<UdimTile>& udimTiles)
+    {
+        // Load all tiles in parallel.
+        NumericRange<size_t> tileRange(0, udimTiles.size());
+        std::for_each(std::execution::par, tileRange.begin(), tileRange.end(), [&](size_t i) { loadUdimTile(udimTiles[i]); });
+
+        // Pack the loaded tiles into texture arrays.
+        // Without packing, the minimum array size can't be reached and all tiles stay individual textures.
+        std::vector<UdimArrayLayout::Tile> layoutTiles;
+        std::vector<uint32_t> layoutTileToTile;
+        for (uint32_t i = 0; i < (uint32_t)udimTiles.size(); ++i)
+        {
+            const auto& mips = udimTiles[i].mips;
+            if (mips.empty())
+                continue;
+            UdimArrayLayout::Tile layoutTile;
+            layoutTile.udim = udimTiles[i].udim;
+            layoutTile.width = mips[0]->getWidth();
+            layoutTile.height = mips[0]->getHeight();
+            layoutTile.format = loadAsSRGB ? linearToSrgbFormat(mips[0]->getFormat()) : mips[0]->getFormat();
+            layoutTile.mipCount = mips.size() > 1 ? (uint32_t)mips.size() : (generateMipLevels ? 0 : 1);
+            layoutTiles.push_back(layoutTile);
+            layoutTileToTile.push_back(i);
+        }
+        UdimArrayLayout layout(layoutTiles, packUdimTiles ? 2 : std::numeric_limits<uint32_t>::max(), kMaxTextureArraySize);
+
+        // Upload each array at once. Slices are stored one after the other, each with all its mip levels.
+        auto createTexture = [&](const UdimArrayLayout::Tile& desc, const std::vector<uint32_t>& layoutTileIndices)
+        {
+            size_t size = 0;
+            for (uint32_t layoutTileIndex : layoutTileIndices)
+                for (const auto& pMip : udimTiles[layoutTileToTile[layoutTileIndex]].mips)
+                    size += pMip->getSize();
+
+            std::vector<uint8_t> data(size);
+            size_t offset = 0;
+            for (uint32_t layoutTileIndex : layoutTileIndices)
+            {
+                for (const auto& pMip : udimTiles[layoutTileToTile[layoutTileIndex]].mips)
+                {
+                    std::memcpy(data.data() + offset, pMip->getData(), pMip->getSize());
+                    offset += pMip->getSize();
+                }
+            }
+
+            uint32_t mipLevels = desc.mipCount == 0 ? Texture::kMaxPossible : desc.mipCount;
+            return mpDevice->createTexture2D(
+                desc.width, desc.height, desc.format, (uint32_t)layoutTileIndices.size(), mipLevels, data.data(), bindFlags
+            );
+        };
+
+        std::vector<ref<Texture>> arrays;
+        for (const auto& array : layout.getArrays())
+        {
+            UdimArrayLayout::Tile desc{0, array.width, array.height, array.format, array.mipCount};
+            arrays.push_back(createTexture(desc, array.tiles));
+            for (uint32_t layoutTileIndex : array.tiles)
+                udimTiles[layoutTileToTile[layoutTileIndex]].mips.clear();
+            logDebug(
+                "Loaded UDIM texture array: size={}x{}x{} mips={} format={} path={}",
+                array.width,
+                array.height,
+                array.tiles.size(),
+                arrays.back()->getMipCount(),
+                to_string(array.format),
+                path
+            );
+        }
+
+        // Tiles that are not packed are added as individual textures. DDS tiles are loaded the regular way.
+        std::vector<TextureHandle> tileHandles(udimTiles.size());
+        for (uint32_t i = 0; i < (uint32_t)layoutTiles.size(); ++i)
+        {
+            if (layout.getLocation(i).arrayIndex != UdimArrayLayout::kNoArray)
+                continue;
+            auto& tile = udimTiles[layoutTileToTile[i]];
+            ref<Texture> pTexture = createTexture(layoutTiles[i], {i});
+            pTexture->setSourcePath(tile.mipPaths[0]);
+            tileHandles[layoutTileToTile[i]] = addTexture(pTexture).toGpuHandle();
+            tile.mips.clear();
+        }
+        for (size_t i = 0; i < udimTiles.size(); ++i)
+        {
+            if (!udimTiles[i].mipPaths.empty() && hasExtension(udimTiles[i].mipPaths[0], "dds"))
+                tileHandles[i] = loadTexture(udimTiles[i].path, generateMipLevels, loadAsSRGB, bindFlags, async).toGpuHandle();
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (size_t arrayIndex = 0; arrayIndex < arrays.size(); ++arrayIndex)
+        {
+            uint32_t arrayID = addTextureArray(arrays[arrayIndex]);
+            const auto& array = layout.getArrays()[arrayIndex];
+            for (uint32_t slice = 0; slice < (uint32_t)array.tiles.size(); ++slice)
+                tileHandles[layoutTileToTile[array.tiles[slice]]].setTextureArraySlice(arrayID, slice);
+        }
+
+        const size_t rangeStart = handle.getID();
+        for (size_t i = 0; i < udimTiles.size(); ++i)
+        {
+            if (tileHandles[i].getMode() == TextureHandle::Mode::Uniform)
+                continue;
+            size_t index = udimTiles[i].udim - 1001;
+            mUdimIndirection[rangeStart + index] = (int32_t)tileHandles[i].packedData;
+        }
+        mUdimIndirectionDirty = true;
+
+        logDebug(
+            "Loaded UDIM texture '{}': {} tiles in {} texture arrays, {} individual textures.",
+            path,
+            udimTiles.size(),
+            arrays.size(),
+            layout.getStandaloneTileCount()
+        );
+    };
+
+    // In deferred mode the set is loaded by endDeferredLoading().
+    // The tiles are moved to the task. They are shared as std::function requires a copyable callable.
+    if (mUseDeferredLoading)
     {
-        size_t index = udimIndices[i] - 1001;
-        mUdimIndirection[rangeStart + index] = handles[i].getID();
+        auto pTiles = std::make_shared<std::vector<UdimTile>>(std::move(tiles));
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDeferredUdimLoads.push_back([=]() { loadTiles(*pTiles); });
+        return handle;
     }
 
-    return TextureManager::CpuTextureHandle(rangeStart, true);
+#ifndef DISABLE_ASYNC_TEXTURE_LOADER
+    if (async)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mLoadRequestsInProgress++;
+        }
+
+        auto pTiles = std::make_shared<std::vector<UdimTile>>(std::move(tiles));
+        mAsyncTextureLoader.run(
+            [=]()
+            {
+                loadTiles(*pTiles);
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                mLoadRequestsInProgress--;
+                mCondition.notify_all();
+            }
+        );
+        return handle;
+    }
+#endif
+
+    loadTiles(tiles);
+    return handle;
 }
 
 TextureManager::CpuTextureHandle TextureManager::loadTexture(
@@ -186,11 +421,12 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
     ResourceBindFlags bindFlags,
     bool async,
     const AssetResolver* assetResolver,
-    size_t* loadedTextureCount
+    size_t* loadedTextureCount,
+    bool packUdimTiles
 )
 {
     if (path.string().find("<UDIM>") != std::string::npos)
-        return loadUdimTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async, assetResolver, loadedTextureCount);
+        return loadUdimTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async, assetResolver, loadedTextureCount, packUdimTiles);
 
     std::vector<std::filesystem::path> paths;
     auto addPath = [&](const std::filesystem::path& p)
@@ -383,8 +619,18 @@ void TextureManager::endDeferredLoading()
             jobs.push_back(Job{key, handle});
     }
 
-    // Early out if there are no textures to load.
+    // Load the queued UDIM sets. Their tiles are loaded in parallel by each set.
     mUseDeferredLoading = false;
+    std::vector<std::function<void()>> udimLoads;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        udimLoads = std::move(mDeferredUdimLoads);
+        mDeferredUdimLoads.clear();
+    }
+    for (const auto& udimLoad : udimLoads)
+        udimLoad();
+
+    // Early out if there are no textures to load.
     if (jobs.empty())
         return;
 
@@ -435,6 +681,7 @@ void TextureManager::removeTexture(const CpuTextureHandle& handle)
     if (handle.isUdim())
     {
         removeUdimTexture(handle);
+        return;
     }
     if (!handle)
         return;
@@ -484,7 +731,19 @@ size_t TextureManager::getTextureDescCount() const
     return mTextureDescs.size();
 }
 
-void TextureManager::bindShaderData(const ShaderVar& texturesVar, const size_t descCount, const ShaderVar& udimsVar) const
+size_t TextureManager::getTextureArrayCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mTextureArrays.size();
+}
+
+void TextureManager::bindShaderData(
+    const ShaderVar& texturesVar,
+    const size_t descCount,
+    const ShaderVar& textureArraysVar,
+    const size_t arrayDescCount,
+    const ShaderVar& udimsVar
+) const
 {
     std::lock_guard<std::mutex> lock(mMutex);
 
@@ -503,6 +762,18 @@ void TextureManager::bindShaderData(const ShaderVar& texturesVar, const size_t d
         texturesVar[i] = nullTexture;
     }
 
+    if (mTextureArrays.size() > arrayDescCount)
+    {
+        FALCOR_THROW(
+            "Descriptor array size ({}) is too small for the required number of texture arrays ({})", arrayDescCount, mTextureArrays.size()
+        );
+    }
+
+    for (size_t i = 0; i < arrayDescCount; i++)
+    {
+        textureArraysVar[i] = i < mTextureArrays.size() ? mTextureArrays[i] : nullTexture;
+    }
+
     if (mUdimIndirection.empty())
     {
         mpUdimIndirection.reset();
@@ -526,6 +797,7 @@ void TextureManager::bindShaderData(const ShaderVar& texturesVar, const size_t d
     if (mUdimIndirectionDirty)
     {
         mpUdimIndirection->setBlob(mUdimIndirection.data(), 0, mUdimIndirection.size() * sizeof(int32_t));
+        mUdimIndirectionDirty = false;
     }
 
     udimsVar = mpUdimIndirection;
@@ -548,6 +820,20 @@ TextureManager::Stats TextureManager::getStats() const
         if (isCompressedFormat(t.pTexture->getFormat()))
             s.textureCompressedCount++;
     }
+    for (const auto& pArray : mTextureArrays)
+    {
+        if (!pArray)
+            continue;
+        uint64_t texelCount = pArray->getTexelCount();
+        uint32_t channelCount = getFormatChannelCount(pArray->getFormat());
+        s.textureCount++;
+        s.textureArrayCount++;
+        s.textureTexelCount += texelCount;
+        s.textureTexelChannelCount += texelCount * channelCount;
+        s.textureMemoryInBytes += pArray->getTextureSizeInBytes();
+        if (isCompressedFormat(pArray->getFormat()))
+            s.textureCompressedCount++;
+    }
     return s;
 }
 
@@ -575,6 +861,24 @@ TextureManager::CpuTextureHandle TextureManager::addDesc(const TextureDesc& desc
     return handle;
 }
 
+uint32_t TextureManager::addTextureArray(const ref<Texture>& pTexture)
+{
+    if (!mFreeTextureArrays.empty())
+    {
+        uint32_t arrayID = mFreeTextureArrays.back();
+        mFreeTextureArrays.pop_back();
+        mTextureArrays[arrayID] = pTexture;
+        return arrayID;
+    }
+
+    if (mTextureArrays.size() >= kMaxTextureArrayCount)
+    {
+        FALCOR_THROW("Out of texture array handles");
+    }
+    mTextureArrays.push_back(pTexture);
+    return (uint32_t)mTextureArrays.size() - 1;
+}
+
 TextureManager::TextureDesc& TextureManager::getDesc(const CpuTextureHandle& handle)
 {
     FALCOR_CHECK(!handle.isUdim(), "Can't lookup texture desc from handle to UDIM texture. Resolve UDIM first.");
@@ -627,24 +931,53 @@ void TextureManager::freeUdimRange(size_t rangeStart)
 
 void TextureManager::removeUdimTexture(const CpuTextureHandle& handle)
 {
-    size_t rangeStart = handle.getID();
-    size_t rangeSize = mUdimIndirectionSize[rangeStart];
-    for (size_t i = rangeStart; i < rangeStart + rangeSize; ++i)
+    // The tiles of the set may still be loading asynchronously.
+    waitForAllTexturesLoading();
+
+    std::vector<CpuTextureHandle> textureHandles;
     {
-        if (mUdimIndirection[i] < 0)
-            continue;
-        CpuTextureHandle texHandle(mUdimIndirection[i]);
-        removeTexture(texHandle);
-        mUdimIndirection[i] = -1;
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t rangeStart = handle.getID();
+        size_t rangeSize = mUdimIndirectionSize[rangeStart];
+        for (size_t i = rangeStart; i < rangeStart + rangeSize; ++i)
+        {
+            if (mUdimIndirection[i] < 0)
+                continue;
+            TextureHandle tile((uint32_t)mUdimIndirection[i]);
+            if (tile.getMode() == TextureHandle::Mode::Texture)
+            {
+                textureHandles.push_back(CpuTextureHandle(tile.getTextureID()));
+            }
+            else if (tile.getMode() == TextureHandle::Mode::TextureArray)
+            {
+                // Arrays are owned by a single UDIM set, release them when the first of their tiles is visited.
+                uint32_t arrayID = tile.getTextureArrayID();
+                if (mTextureArrays[arrayID])
+                {
+                    mTextureArrays[arrayID] = nullptr;
+                    mFreeTextureArrays.push_back(arrayID);
+                }
+            }
+            mUdimIndirection[i] = -1;
+        }
+
+        auto it = std::find_if(
+            mUdimKeyToHandle.begin(), mUdimKeyToHandle.end(), [handle](const auto& keyVal) { return keyVal.second == handle; }
+        );
+        if (it != mUdimKeyToHandle.end())
+            mUdimKeyToHandle.erase(it);
+
+        freeUdimRange(rangeStart);
     }
 
-    freeUdimRange(rangeStart);
+    for (const auto& textureHandle : textureHandles)
+        removeTexture(textureHandle);
 }
 
-TextureManager::CpuTextureHandle TextureManager::resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const
+TextureHandle TextureManager::resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const
 {
     if (!handle.isUdim())
-        return handle;
+        return handle.toGpuHandle();
 
     // Compute which UDIM ID texture coordinate maps to.
     FALCOR_CHECK(uv[0] >= 0.f && uv[0] < 10.f && uv[1] >= 0.f && uv[1] < 10.f, "UDIM texture coordinate ({}) is out of range.", uv);
@@ -653,20 +986,43 @@ TextureManager::CpuTextureHandle TextureManager::resolveUdimTexture(const CpuTex
     return resolveUdimTexture(handle, udimID);
 }
 
-TextureManager::CpuTextureHandle TextureManager::resolveUdimTexture(const CpuTextureHandle& handle, const uint32_t udimID) const
+TextureHandle TextureManager::resolveUdimTexture(const CpuTextureHandle& handle, const uint32_t udimID) const
 {
     if (!handle.isUdim())
-        return handle;
+        return handle.toGpuHandle();
 
     // Check if UDIM ID is valid and within range of the indirection table.
     // udimID = 1001 + u + (10 * v) where u,v in 0..9 => valid IDs are 1001..1100.
     FALCOR_CHECK(udimID >= 1001 && udimID <= 1100, "Illegal UDIM ID ({}).", udimID);
+    std::lock_guard<std::mutex> lock(mMutex);
     size_t rangeStart = handle.getID();
     size_t udim = udimID - 1001;
     FALCOR_CHECK(udim < mUdimIndirectionSize[rangeStart], "UDIM ID ({}) is out of range.", udimID);
 
+    // Missing tiles resolve to a uniform handle.
     if (mUdimIndirection[rangeStart + udim] >= 0)
-        return CpuTextureHandle(mUdimIndirection[rangeStart + udim]);
-    return CpuTextureHandle();
+        return TextureHandle((uint32_t)mUdimIndirection[rangeStart + udim]);
+    return CpuTextureHandle().toGpuHandle();
+}
+
+TextureManager::TextureDesc TextureManager::getResolvedTextureDesc(const TextureHandle& handle) const
+{
+    switch (handle.getMode())
+    {
+    case TextureHandle::Mode::Texture:
+        return getTextureDesc(CpuTextureHandle(handle.getTextureID()));
+    case TextureHandle::Mode::TextureArray:
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto& pArray = mTextureArrays[handle.getTextureArrayID()];
+        TextureDesc desc;
+        desc.state = pArray ? TextureState::Loaded : TextureState::Invalid;
+        desc.pTexture = pArray;
+        desc.arraySlice = handle.getTextureArraySlice();
+        return desc;
+    }
+    default:
+        return {};
+    }
 }
 } // namespace Falcor
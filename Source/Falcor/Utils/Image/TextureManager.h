@@ -34,11 +34,13 @@
 #include "Core/Program/ShaderVar.h"
 #include "Scene/Material/TextureHandle.slang"
 #include <condition_variable>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <utility>
 
 namespace Falcor
 {
@@ -53,6 +55,10 @@ class AssetResolver;
  * Each managed texture is assigned a unique handle upon loading.
  * This handle is used in shader code to reference the given texture
  * in the array of GPU texture descriptors.
+ *
+ * UDIM tiles of equal resolution, format and mip count are packed into
+ * shared texture arrays (see UdimArrayLayout). These are bound to a separate
+ * array of GPU descriptors and referenced from the UDIM indirection table.
  */
 class FALCOR_API TextureManager
 {
@@ -72,6 +78,7 @@ public:
         uint64_t textureTexelCount = 0;        ///< Total number of texels in all textures.
         uint64_t textureTexelChannelCount = 0; ///< Total number of texel channels in all textures.
         uint64_t textureMemoryInBytes = 0;     ///< Total memory in bytes used by the textures.
+        uint64_t textureArrayCount = 0;        ///< Number of texture arrays holding packed UDIM tiles (included in the counts above).
     };
 
     /**
@@ -132,6 +139,7 @@ public:
     {
         TextureState state = TextureState::Invalid; ///< Current state of the texture.
         ref<Texture> pTexture;                      ///< Valid texture object when state is 'Loaded', or nullptr if loading failed.
+        uint32_t arraySlice = 0;                    ///< Array slice holding the data. Non-zero only for UDIM tiles packed into an array.
 
         bool isValid() const { return state != TextureState::Invalid; }
     };
@@ -166,6 +174,7 @@ public:
      * @param[in] async Load asynchronously, otherwise the function blocks until the texture data is loaded.
      * @param[in] assetResolver Optional asset resolver for resolving file paths.
      * @param[out] loadedTextureCount Optionally can provided the number of actually loaded textures (2+ can happen with UDIMs)
+     * @param[in] packUdimTiles Pack the tiles of a UDIM set into texture arrays, see loadUdimTexture().
      * @return Unique handle to the texture, or an invalid handle if the texture can't be found.
      */
     CpuTextureHandle loadTexture(
@@ -175,12 +184,19 @@ public:
         ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
         bool async = true,
         const AssetResolver* assetResolver = nullptr,
-        size_t* loadedTextureCount = nullptr
+        size_t* loadedTextureCount = nullptr,
+        bool packUdimTiles = true
     );
 
     /**
      * Same as loadTexture, but explicitly handles Udim textures. If the texture isn't Udim, it falls back to loadTexture.
      * Also, loadTexture will detect UDIM and call loadUdimTexture if needed.
+     * The tiles of a UDIM set are loaded in parallel and tiles of equal resolution, format and mip count are packed
+     * into shared texture arrays. When deferred loading is active, the set is queued and loaded by endDeferredLoading().
+     * If asynchronous loading is requested, the tiles are loaded on a worker thread and the UDIM indirection
+     * entries are filled in when loading completes. Tiles stored as DDS files are loaded as individual textures.
+     * Texture arrays can't be used where shaders expect a plain texture, such as displacement maps. Pass
+     * packUdimTiles = false to load all tiles of such sets as individual textures.
      */
     CpuTextureHandle loadUdimTexture(
         const std::filesystem::path& path,
@@ -189,7 +205,8 @@ public:
         ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
         bool async = true,
         const AssetResolver* assetResolver = nullptr,
-        size_t* loadedTextureCount = nullptr
+        size_t* loadedTextureCount = nullptr,
+        bool packUdimTiles = true
     );
 
     /**
@@ -206,10 +223,12 @@ public:
 
     /**
      * Marks the beginning of a section where texture loading is deferred.
-     * All loadTexture() and loadUdimTexture() calls after calling this will be put on a deferred list.
+     * All loadTexture() calls after calling this will be put on a deferred list, including UDIM sets.
      * A later call to endDeferredLoading() will load all queued up textures in parallel.
-     * WARNING: This is a dangerous operation because Falcor is generally not thread-safe. Only use this
-     * from the main thread when it is guaranteed to not be interleaved with any other thread.
+     * No GPU resources are created until then, so the requests may be issued from a worker thread that is the only
+     * user of the texture manager. endDeferredLoading() must be called from the main thread.
+     * WARNING: This is a dangerous operation because Falcor is generally not thread-safe. Only call endDeferredLoading()
+     * when it is guaranteed to not be interleaved with any other thread.
      */
     void beginDeferredLoading();
     void endDeferredLoading();
@@ -223,6 +242,7 @@ public:
     /**
      * Get a loaded texture. Call getTextureDesc() for more info.
      * This function handles non-UDIM textures. If UDIMs are expected, supply UDIM ID or uv coordinate.
+     * UDIM tiles may be packed into a texture array, in which case the array is returned (see TextureDesc::arraySlice).
      * @param[in] handle Texture handle.
      * @return Texture if loaded, or nullptr if handle doesn't exist or texture isn't yet loaded.
      */
@@ -239,11 +259,11 @@ public:
     TextureDesc getTextureDesc(const CpuTextureHandle& handle) const;
     TextureDesc getTextureDesc(const CpuTextureHandle& handle, const float2& uv) const
     {
-        return getTextureDesc(resolveUdimTexture(handle, uv));
+        return getResolvedTextureDesc(resolveUdimTexture(handle, uv));
     }
     TextureDesc getTextureDesc(const CpuTextureHandle& handle, const uint32_t udimID) const
     {
-        return getTextureDesc(resolveUdimTexture(handle, udimID));
+        return getResolvedTextureDesc(resolveUdimTexture(handle, udimID));
     }
 
     /**
@@ -261,15 +281,30 @@ public:
      */
     size_t getUdimIndirectionCount() const { return mUdimIndirection.size(); }
 
+    /**
+     * Number of texture arrays allocated for packed UDIM tiles.
+     * Like the UDIM indirection, this number does not shrink when UDIM textures are removed.
+     */
+    size_t getTextureArrayCount() const;
+
     /**
      * Bind all textures into a shader var.
      * The shader var should refer to a Texture2D descriptor array of fixed size.
      * The array must be large enough, otherwise an exception is thrown.
      * This restriction will go away when unbounded descriptor arrays are supported (see #1321).
-     * @param[in] var Shader var for descriptor array.
+     * @param[in] texturesVar Shader var for descriptor array.
      * @param[in] descCount Size of descriptor array.
+     * @param[in] textureArraysVar Shader var for Texture2DArray descriptor array.
+     * @param[in] arrayDescCount Size of Texture2DArray descriptor array.
+     * @param[in] udimsVar Shader var for the UDIM indirection buffer.
      */
-    void bindShaderData(const ShaderVar& texturesVar, const size_t descCount, const ShaderVar& udimsVar) const;
+    void bindShaderData(
+        const ShaderVar& texturesVar,
+        const size_t descCount,
+        const ShaderVar& textureArraysVar,
+        const size_t arrayDescCount,
+        const ShaderVar& udimsVar
+    ) const;
 
     /**
      * Returns stats for the textures
@@ -280,8 +315,10 @@ private:
     size_t getUdimRange(size_t requiredSize);
     void freeUdimRange(size_t rangeStart);
     void removeUdimTexture(const CpuTextureHandle& handle);
-    CpuTextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const;
-    CpuTextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const uint32_t udimID) const;
+    TextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const;
+    TextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const uint32_t udimID) const;
+    TextureDesc getResolvedTextureDesc(const TextureHandle& handle) const;
+    uint32_t addTextureArray(const ref<Texture>& pTexture);
 
     /**
      * Key to uniquely identify a managed texture.
@@ -310,6 +347,11 @@ private:
         }
     };
 
+    /**
+     * Key to uniquely identify a managed UDIM set. The same set may be loaded both packed and unpacked.
+     */
+    using UdimKey = std::pair<TextureKey, bool>;
+
     CpuTextureHandle addDesc(const TextureDesc& desc);
     TextureDesc& getDesc(const CpuTextureHandle& handle);
 
@@ -323,7 +365,11 @@ private:
     std::vector<CpuTextureHandle> mFreeList;                     ///< List of unused handles.
     std::map<TextureKey, CpuTextureHandle> mKeyToHandle;         ///< Map from texture key to handle.
     std::map<const Texture*, CpuTextureHandle> mTextureToHandle; ///< Map from texture ptr to handle.
-    /// Map from UDIM-1001 to an actual textureID, -1 if the texture does not exist (e.g., there is 1001 and 1003, so 1002 [1] == -1)
+    std::map<UdimKey, CpuTextureHandle> mUdimKeyToHandle;        ///< Map from UDIM set key to handle.
+    std::vector<ref<Texture>> mTextureArrays;                    ///< Texture arrays holding packed UDIM tiles, indexed by array ID.
+    std::vector<uint32_t> mFreeTextureArrays;                    ///< List of unused texture array IDs.
+    /// Map from UDIM-1001 to the packed TextureHandle of the tile (a texture or a texture array slice),
+    /// -1 if the tile does not exist (e.g., there is 1001 and 1003, so 1002 [1] == -1)
     std::vector<int32_t> mUdimIndirection;
     /// For each udim indirection range, writes (at the first element), how long that range is (there is 0 everywhere else)
     std::vector<size_t> mUdimIndirectionSize;
@@ -334,6 +380,7 @@ private:
     mutable ref<Buffer> mpUdimIndirection;
 
     bool mUseDeferredLoading = false;
+    std::vector<std::function<void()>> mDeferredUdimLoads; ///< UDIM sets queued while deferred loading is active.
 
     AsyncTextureLoader mAsyncTextureLoader; ///< Utility for asynchronous texture loading.
     size_t mLoadRequestsInProgress = 0;     ///< Number of load requests currently in progress.
@@ -0,0 +1,88 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "UdimArrayLayout.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+UdimArrayLayout::UdimArrayLayout(const std::vector<Tile>& tiles, uint32_t minArraySize, uint32_t maxArraySize) : mLocations(tiles.size())
+{
+    FALCOR_CHECK(maxArraySize > 0, "'maxArraySize' must be at least 1.");
+
+    // Visit tiles in UDIM order so that slices and arrays are assigned deterministically.
+    std::vector<uint32_t> order(tiles.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return tiles[a].udim < tiles[b].udim; });
+    for (size_t i = 1; i < order.size(); ++i)
+        FALCOR_CHECK(tiles[order[i - 1]].udim != tiles[order[i]].udim, "UDIM {} appears more than once.", tiles[order[i]].udim);
+
+    auto isCompatible = [](const Tile& a, const Tile& b)
+    { return a.width == b.width && a.height == b.height && a.format == b.format && a.mipCount == b.mipCount; };
+
+    // Group compatible tiles. Groups are ordered by their lowest UDIM.
+    std::vector<std::vector<uint32_t>> groups;
+    for (uint32_t tileIndex : order)
+    {
+        const Tile& tile = tiles[tileIndex];
+        FALCOR_CHECK(tile.width > 0 && tile.height > 0, "UDIM {} has an invalid size ({}x{}).", tile.udim, tile.width, tile.height);
+        auto it = std::find_if(groups.begin(), groups.end(), [&](const auto& group) { return isCompatible(tiles[group[0]], tile); });
+        if (it != groups.end())
+            it->push_back(tileIndex);
+        else
+            groups.push_back({tileIndex});
+    }
+
+    // Split groups into arrays of at most maxArraySize slices. Chunks that are too small stay standalone.
+    for (const auto& group : groups)
+    {
+        for (size_t first = 0; first < group.size(); first += maxArraySize)
+        {
+            size_t count = std::min<size_t>(maxArraySize, group.size() - first);
+            if (count < minArraySize)
+            {
+                mStandaloneTileCount += (uint32_t)count;
+                continue;
+            }
+
+            const Tile& tile = tiles[group[first]];
+            Array array;
+            array.width = tile.width;
+            array.height = tile.height;
+            array.format = tile.format;
+            array.mipCount = tile.mipCount;
+            array.tiles.assign(group.begin() + first, group.begin() + first + count);
+
+            for (uint32_t slice = 0; slice < count; ++slice)
+                mLocations[array.tiles[slice]] = {(uint32_t)mArrays.size(), slice};
+            mArrays.push_back(std::move(array));
+        }
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,98 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Layout of a UDIM texture set in texture arrays.
+ *
+ * Tiles of equal resolution, format and mip count are packed into the slices of a shared
+ * Texture2DArray, so that a UDIM set is stored in a few allocations rather than one texture per tile.
+ * Slices are assigned in order of increasing UDIM number. Groups with fewer than the minimum
+ * number of tiles are not packed and stay standalone textures.
+ *
+ * The layout only depends on the tile descriptions, which keeps it testable on the CPU.
+ */
+class FALCOR_API UdimArrayLayout
+{
+public:
+    static constexpr uint32_t kNoArray = uint32_t(-1);
+
+    /// Description of a tile.
+    struct Tile
+    {
+        uint32_t udim = 1001;                            ///< UDIM number (1001-9999).
+        uint32_t width = 0;                              ///< Width of mip 0 in texels.
+        uint32_t height = 0;                             ///< Height of mip 0 in texels.
+        ResourceFormat format = ResourceFormat::Unknown; ///< Texel format.
+        uint32_t mipCount = 1;                           ///< Number of mip levels, or 0 if the full mip chain is generated.
+    };
+
+    /// Texture array holding a group of tiles.
+    struct Array
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t mipCount = 1;
+        std::vector<uint32_t> tiles; ///< Tile indices, one per array slice.
+    };
+
+    /// Location of a tile.
+    struct Location
+    {
+        uint32_t arrayIndex = kNoArray; ///< Index of the array holding the tile, or kNoArray if the tile is standalone.
+        uint32_t slice = 0;             ///< Array slice of the tile.
+    };
+
+    /**
+     * Compute the layout of a UDIM set.
+     * @param[in] tiles Tile descriptions. UDIM numbers must be unique.
+     * @param[in] minArraySize Minimum number of tiles to pack into an array.
+     * @param[in] maxArraySize Maximum number of slices per array. Larger groups are split into multiple arrays.
+     */
+    UdimArrayLayout(const std::vector<Tile>& tiles, uint32_t minArraySize = 2, uint32_t maxArraySize = 2048);
+
+    const std::vector<Array>& getArrays() const { return mArrays; }
+    const Location& getLocation(uint32_t tileIndex) const { return mLocations[tileIndex]; }
+    uint32_t getTileCount() const { return (uint32_t)mLocations.size(); }
+
+    /// Get the number of tiles that are not packed into an array.
+    uint32_t getStandaloneTileCount() const { return mStandaloneTileCount; }
+
+private:
+    std::vector<Array> mArrays;
+    std::vector<Location> mLocations;
+    uint32_t mStandaloneTileCount = 0;
+};
+} // namespace Falcor
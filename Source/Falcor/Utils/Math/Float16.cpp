@@ -33,6 +33,22 @@
  */
 
 #include "Float16.h"
+#include "Core/Error.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FALCOR_FLOAT16_F16C 1
+#include <immintrin.h>
+#if FALCOR_MSVC
+#include <intrin.h>
+#define FALCOR_F16C_TARGET
+#else
+#include <cpuid.h>
+#define FALCOR_F16C_TARGET __attribute__((target("avx,f16c")))
+#endif
+#else
+#define FALCOR_FLOAT16_F16C 0
+#endif
 
 namespace Falcor
 {
@@ -99,10 +115,14 @@ uint16_t float32ToFloat16(float value)
         // We convert f to a denormalized half.
         //
 
-        m = (m | 0x00800000) >> (1 - e);
+        int shift = 14 - e;
+        int full = m | 0x00800000;
+        int rem = full & ((1 << shift) - 1);
+        int half = 1 << (shift - 1);
+        m = full >> shift;
 
         //
-        // Round to nearest, round "0.5" up.
+        // Round to nearest, round "0.5" to even.
         //
         // Rounding may cause the significand to overflow and make
         // our number normalized.  Because of the way a half's bits
@@ -110,14 +130,14 @@ uint16_t float32ToFloat16(float value)
         // the code below will handle it correctly.
         //
 
-        if (m & 0x00001000)
-            m += 0x00002000;
+        if (rem > half || (rem == half && (m & 1)))
+            m += 1;
 
         //
         // Assemble the half from s, e (zero) and m.
         //
 
-        return uint16_t(s | (m >> 13));
+        return uint16_t(s | m);
     }
     else if (e == 0xff - (127 - 15))
     {
@@ -154,10 +174,10 @@ uint16_t float32ToFloat16(float value)
         //
 
         //
-        // Round to nearest, round "0.5" up
+        // Round to nearest, round "0.5" to even
         //
 
-        if (m & 0x00001000)
+        if ((m & 0x00001fff) > 0x00001000 || ((m & 0x00001fff) == 0x00001000 && (m & 0x00002000)))
         {
             m += 0x00002000;
 
@@ -261,5 +281,99 @@ float float16ToFloat32(uint16_t value)
     return result.f;
 }
 
+#if FALCOR_FLOAT16_F16C
+namespace
+{
+/// Check for F16C (which requires AVX) and OS support for saving the YMM registers.
+bool detectF16C()
+{
+#if FALCOR_MSVC
+    int info[4];
+    __cpuid(info, 1);
+    uint32_t ecx = (uint32_t)info[2];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+#endif
+    const bool osxsave = ecx & (1u << 27);
+    const bool avx = ecx & (1u << 28);
+    const bool f16c = ecx & (1u << 29);
+    if (!osxsave || !avx || !f16c)
+        return false;
+
+#if FALCOR_MSVC
+    uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    uint64_t xcr0 = ((uint64_t)hi << 32) | lo;
+#endif
+    return (xcr0 & 6) == 6;
+}
+
+bool hasF16C()
+{
+    static const bool supported = detectF16C();
+    return supported;
+}
+
+FALCOR_F16C_TARGET void float32ToFloat16F16C(const float* pSrc, uint16_t* pDst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm_storeu_si128((__m128i*)(pDst + i), _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT));
+
+    // Convert the tail through a padded buffer so that all elements go through the same instruction.
+    if (i < count)
+    {
+        float src[8] = {};
+        uint16_t dst[8];
+        std::copy(pSrc + i, pSrc + count, src);
+        _mm_storeu_si128((__m128i*)dst, _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT));
+        std::copy(dst, dst + (count - i), pDst + i);
+    }
+}
+
+FALCOR_F16C_TARGET void float16ToFloat32F16C(const uint16_t* pSrc, float* pDst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(pDst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(pSrc + i))));
+
+    if (i < count)
+    {
+        uint16_t src[8] = {};
+        float dst[8];
+        std::copy(pSrc + i, pSrc + count, src);
+        _mm256_storeu_ps(dst, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)src)));
+        std::copy(dst, dst + (count - i), pDst + i);
+    }
+}
+} // namespace
+#endif // FALCOR_FLOAT16_F16C
+
+void float32ToFloat16(fstd::span<const float> src, fstd::span<uint16_t> dst)
+{
+    FALCOR_CHECK(src.size() == dst.size(), "Source and destination must have the same size.");
+#if FALCOR_FLOAT16_F16C
+    if (hasF16C())
+        return float32ToFloat16F16C(src.data(), dst.data(), src.size());
+#endif
+    for (size_t i = 0; i < src.size(); ++i)
+        dst[i] = float32ToFloat16(src[i]);
+}
+
+void float16ToFloat32(fstd::span<const uint16_t> src, fstd::span<float> dst)
+{
+    FALCOR_CHECK(src.size() == dst.size(), "Source and destination must have the same size.");
+#if FALCOR_FLOAT16_F16C
+    if (hasF16C())
+        return float16ToFloat32F16C(src.data(), dst.data(), src.size());
+#endif
+    for (size_t i = 0; i < src.size(); ++i)
+        dst[i] = float16ToFloat32(src[i]);
+}
+
 } // namespace math
 } // namespace Falcor
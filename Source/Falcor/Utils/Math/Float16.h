@@ -29,6 +29,8 @@
 
 #include "Core/Macros.h"
 
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+
 #include <cstdint>
 #include <limits>
 
@@ -40,6 +42,23 @@ namespace math
 FALCOR_API uint16_t float32ToFloat16(float value);
 FALCOR_API float float16ToFloat32(uint16_t value);
 
+/**
+ * Convert an array of floats to float16.
+ * Rounds to nearest even and produces denormals, same as the scalar conversion.
+ * Uses F16C instructions when supported by the CPU. NaN payloads may differ from the scalar conversion.
+ * @param[in] src Source values.
+ * @param[out] dst Destination values. Must have the same size as src.
+ */
+FALCOR_API void float32ToFloat16(fstd::span<const float> src, fstd::span<uint16_t> dst);
+
+/**
+ * Convert an array of float16 values to floats.
+ * Uses F16C instructions when supported by the CPU. NaN payloads may differ from the scalar conversion.
+ * @param[in] src Source values.
+ * @param[out] dst Destination values. Must have the same size as src.
+ */
+FALCOR_API void float16ToFloat32(fstd::span<const uint16_t> src, fstd::span<float> dst);
+
 struct float16_t
 {
     float16_t() = default;
@@ -28,9 +28,18 @@
 #include "AliasTable.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
 
 namespace Falcor
 {
+namespace
+{
+/// Number of weights processed per task when building the table.
+const uint32_t kChunkSize = 1 << 16;
+} // namespace
+
 // This builds an alias table via the O(N) algorithm from Vose 1991, "A linear algorithm for generating random
 // numbers with a given distribution," IEEE Transactions on Software Engineering 17(9), 972-975.
 //
@@ -51,37 +60,125 @@ AliasTable::AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt1
     if (weights.size() >= std::numeric_limits<uint32_t>::max())
         FALCOR_THROW("Too many entries for alias table.");
 
-    std::uniform_int_distribution<uint32_t> rngDist;
-
     mpWeights =
         pDevice->createStructuredBuffer(sizeof(float), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, weights.data());
 
-    // Our working set / intermediate buffers (underweight & overweight); initialize to "invalid"
-    std::vector<uint32_t> lowIdx(mCount, 0xFFFFFFFFu);
-    std::vector<uint32_t> highIdx(mCount, 0xFFFFFFFFu);
+    std::vector<Item> items;
+    mWeightSum = buildItems(std::move(weights), items);
+
+    // TODO: We can simplify the alias table to implicitly store indexB (aka lowIdx[i]), so the AliasTable::Item
+    // structure would be 1 float + 1 uint32_t, rather than 128 bits.  This, of course, would change usage in shaders
+    // and elsewhere.  To do this, here you'd need to sort elements by indexB so that when looking up mpItems[j],
+    // indexB==j.  This works since, by construction, only one element in the table has indexB==j (for any j
+    // in [0...mCount-1]).  Alternatively, during the loop in buildItems(), you could directly enter elements into the
+    // correct location in the alias table.
+
+    // Stash the alias table in our GPU buffer
+    mpItems = pDevice->createStructuredBuffer(
+        sizeof(AliasTable::Item), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, items.data()
+    );
+}
+
+void AliasTable::update(std::vector<float> weights, const std::vector<Range>& dirtyRanges)
+{
+    FALCOR_CHECK(weights.size() == mCount, "Number of weights ({}) does not match alias table size ({}).", weights.size(), mCount);
+
+    for (const auto& range : dirtyRanges)
+    {
+        FALCOR_CHECK(range.offset <= mCount && range.count <= mCount - range.offset, "Range is out of bounds.");
+        if (range.count > 0)
+            mpWeights->setBlob(weights.data() + range.offset, range.offset * sizeof(float), range.count * sizeof(float));
+    }
+
+    // The alias table itself is not local to the changed weights (the average changes), so it is always rebuilt.
+    std::vector<Item> items;
+    mWeightSum = buildItems(std::move(weights), items);
+    mpItems->setBlob(items.data(), 0, items.size() * sizeof(Item));
+}
+
+double AliasTable::buildItems(std::vector<float> weights, std::vector<Item>& items)
+{
+    const uint32_t count = (uint32_t)weights.size();
+    items.resize(count);
+    if (count == 0)
+        return 0.0;
+
+    // Weights are processed in fixed-size chunks. The chunk size does not depend on the number of threads,
+    // so the weight sum and the order of the working set are deterministic.
+    const uint32_t chunkCount = (count + kChunkSize - 1) / kChunkSize;
+    auto chunkRange = NumericRange<uint32_t>(0, chunkCount);
+    auto forEachChunk = [&](auto func)
+    {
+        std::for_each(
+            std::execution::par,
+            chunkRange.begin(),
+            chunkRange.end(),
+            [&](uint32_t chunk) { func(chunk, chunk * kChunkSize, std::min(count, (chunk + 1) * kChunkSize)); }
+        );
+    };
 
     // Sum element weights, use double to minimize precision issues
-    mWeightSum = 0.0;
-    for (float f : weights)
-        mWeightSum += f;
+    std::vector<double> chunkSums(chunkCount);
+    forEachChunk(
+        [&](uint32_t chunk, uint32_t begin, uint32_t end)
+        {
+            double sum = 0.0;
+            for (uint32_t i = begin; i < end; ++i)
+                sum += weights[i];
+            chunkSums[chunk] = sum;
+        }
+    );
+    double weightSum = 0.0;
+    for (double sum : chunkSums)
+        weightSum += sum;
 
     // Find the average weight
-    float avgWeight = float(mWeightSum / double(mCount));
+    float avgWeight = float(weightSum / double(count));
+
+    // Count the below-average weight elements per chunk.
+    std::vector<uint32_t> chunkLowCounts(chunkCount);
+    forEachChunk(
+        [&](uint32_t chunk, uint32_t begin, uint32_t end)
+        {
+            uint32_t lowCount = 0;
+            for (uint32_t i = begin; i < end; ++i)
+                lowCount += weights[i] < avgWeight ? 1 : 0;
+            chunkLowCounts[chunk] = lowCount;
+        }
+    );
+
+    // Our working set / intermediate buffers (underweight & overweight); initialize to "invalid"
+    std::vector<uint32_t> lowIdx(count, 0xFFFFFFFFu);
+    std::vector<uint32_t> highIdx(count, 0xFFFFFFFFu);
 
     // Initialize working set. Inset inputs into our lists of above-average or below-average weight elements.
-    int lowCount = 0;
-    int highCount = 0;
-    for (uint32_t i = 0; i < mCount; ++i)
+    // Each chunk writes to its own section of the lists, which keeps the elements in index order.
+    std::vector<uint32_t> chunkLowOffsets(chunkCount);
+    uint32_t lowCount = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
     {
-        if (weights[i] < avgWeight)
-            lowIdx[lowCount++] = i;
-        else
-            highIdx[highCount++] = i;
+        chunkLowOffsets[chunk] = lowCount;
+        lowCount += chunkLowCounts[chunk];
     }
+    uint32_t highCount = count - lowCount;
+
+    forEachChunk(
+        [&](uint32_t chunk, uint32_t begin, uint32_t end)
+        {
+            uint32_t lowOffset = chunkLowOffsets[chunk];
+            uint32_t highOffset = begin - lowOffset;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                if (weights[i] < avgWeight)
+                    lowIdx[lowOffset++] = i;
+                else
+                    highIdx[highOffset++] = i;
+            }
+        }
+    );
 
     // Create alias table entries by merging above- and below-average samples
-    std::vector<AliasTable::Item> items(mCount);
-    for (uint32_t i = 0; i < mCount; ++i)
+    for (uint32_t i = 0; i < count; ++i)
     {
         // Usual case:  We have an above-average and below-average sample we can combine into one alias table entry
         if ((lowIdx[i] != 0xFFFFFFFFu) && (highIdx[i] != 0xFFFFFFFFu))
@@ -125,17 +222,7 @@ AliasTable::AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt1
         }
     }
 
-    // TODO: We can simplify the alias table to implicitly store indexB (aka lowIdx[i]), so the AliasTable::Item
-    // structure would be 1 float + 1 uint32_t, rather than 128 bits.  This, of course, would change usage in shaders
-    // and elsewhere.  To do this, here you'd need to sort elements by indexB so that when looking up mpItems[j],
-    // indexB==j.  This works since, by construction, only one element in the table has indexB==j (for any j
-    // in [0...mCount-1]).  Alternatively, during the loop above, you could directly enter elements into the
-    // correct location in the alias table.
-
-    // Stash the alias table in our GPU buffer
-    mpItems = pDevice->createStructuredBuffer(
-        sizeof(AliasTable::Item), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, items.data()
-    );
+    return weightSum;
 }
 
 void AliasTable::bindShaderData(const ShaderVar& var) const
@@ -31,6 +31,7 @@
 #include "Core/Program/ShaderVar.h"
 #include <memory>
 #include <random>
+#include <vector>
 
 namespace Falcor
 {
@@ -40,6 +41,22 @@ namespace Falcor
 class FALCOR_API AliasTable
 {
 public:
+    /// Table item (matches AliasTable.slang).
+    struct Item
+    {
+        float threshold; ///< If rand() < threshold, pick indexB (else pick indexA)
+        uint32_t indexA; ///< The "redirect" index, if uniform sampling would overweight indexB.
+        uint32_t indexB; ///< The original / permutation index, sampled uniformly in [0...mCount-1]
+        uint32_t _pad;
+    };
+
+    /// Range of table entries.
+    struct Range
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
     /**
      * Create an alias table.
      * The weights don't need to be normalized to sum up to 1.
@@ -55,6 +72,24 @@ public:
      */
     void bindShaderData(const ShaderVar& var) const;
 
+    /**
+     * Update the table with new weights.
+     * Only the given ranges of the weights are uploaded to the GPU, the table items are rebuilt.
+     * @param[in] weights The new weights. The number of weights must not change.
+     * @param[in] dirtyRanges Ranges of weights that changed.
+     */
+    void update(std::vector<float> weights, const std::vector<Range>& dirtyRanges);
+
+    /**
+     * Build the table items on the CPU.
+     * Summing and classifying the weights runs in parallel, the items are then built in a single linear pass.
+     * The result does not depend on the number of threads.
+     * @param[in] weights The weights. These are used as scratch space.
+     * @param[out] items The table items.
+     * @return Sum of all weights.
+     */
+    static double buildItems(std::vector<float> weights, std::vector<Item>& items);
+
     /**
      * Get the number of weights in the table.
      */
@@ -66,15 +101,6 @@ public:
     double getWeightSum() const { return mWeightSum; }
 
 private:
-    // Item structure for the mpItems buffer.
-    struct Item
-    {
-        float threshold; ///< If rand() < threshold, pick indexB (else pick indexA)
-        uint32_t indexA; ///< The "redirect" index, if uniform sampling would overweight indexB.
-        uint32_t indexB; ///< The original / permutation index, sampled uniformly in [0...mCount-1]
-        uint32_t _pad;
-    };
-
     uint32_t mCount;       ///< Number of items in the alias table.
     double mWeightSum;     ///< Total weight of all elements used to create the alias table.
     ref<Buffer> mpItems;   ///< Buffer containing table items.
@@ -0,0 +1,158 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlueNoise.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Fraction of texels set in the initial binary pattern.
+const float kInitialDensity = 0.1f;
+
+/// Binary pattern with the energy of each texel, the sum of a toroidal Gaussian filter over all set texels.
+class EnergyField
+{
+public:
+    EnergyField(uint32_t size, float sigma) : mSize(size), mPattern(size * size, 0), mEnergy(size * size, 0.f), mKernel(size * size)
+    {
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                float dx = (float)std::min(x, size - x);
+                float dy = (float)std::min(y, size - y);
+                mKernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.f * sigma * sigma));
+            }
+        }
+    }
+
+    bool isSet(uint32_t index) const { return mPattern[index] != 0; }
+
+    void set(uint32_t index, bool value)
+    {
+        if (isSet(index) == value)
+            return;
+        mPattern[index] = value ? 1 : 0;
+        const float sign = value ? 1.f : -1.f;
+        const uint32_t px = index % mSize;
+        const uint32_t py = index / mSize;
+        for (uint32_t y = 0; y < mSize; ++y)
+        {
+            const uint32_t ky = ((y - py) & (mSize - 1)) * mSize;
+            for (uint32_t x = 0; x < mSize; ++x)
+                mEnergy[y * mSize + x] += sign * mKernel[ky + ((x - px) & (mSize - 1))];
+        }
+    }
+
+    /// Returns the set texel with the highest energy.
+    uint32_t findTightestCluster() const { return find(true, [](float a, float b) { return a > b; }); }
+
+    /// Returns the unset texel with the lowest energy.
+    uint32_t findLargestVoid() const { return find(false, [](float a, float b) { return a < b; }); }
+
+private:
+    template<typename Compare>
+    uint32_t find(bool value, Compare compare) const
+    {
+        uint32_t best = UINT32_MAX;
+        for (uint32_t i = 0; i < (uint32_t)mPattern.size(); ++i)
+        {
+            if (isSet(i) == value && (best == UINT32_MAX || compare(mEnergy[i], mEnergy[best])))
+                best = i;
+        }
+        FALCOR_ASSERT(best != UINT32_MAX);
+        return best;
+    }
+
+    uint32_t mSize;
+    std::vector<uint8_t> mPattern;
+    std::vector<float> mEnergy;
+    std::vector<float> mKernel;
+};
+} // namespace
+
+std::vector<uint32_t> generateBlueNoiseMask(uint32_t size, uint32_t seed, float sigma)
+{
+    FALCOR_CHECK(size >= 4 && (size & (size - 1)) == 0, "'size' must be a power of two and at least 4.");
+    FALCOR_CHECK(sigma > 0.f, "'sigma' must be positive.");
+
+    const uint32_t texelCount = size * size;
+    const uint32_t initialCount = std::max(1u, (uint32_t)(texelCount * kInitialDensity));
+
+    // Start with a random pattern.
+    EnergyField field(size, sigma);
+    std::mt19937 rng(seed);
+    for (uint32_t count = 0; count < initialCount;)
+    {
+        uint32_t index = rng() % texelCount;
+        if (!field.isSet(index))
+        {
+            field.set(index, true);
+            count++;
+        }
+    }
+
+    // Relax the initial pattern by moving points from the tightest cluster into the largest void
+    // until this no longer changes the pattern.
+    for (uint32_t iteration = 0; iteration < texelCount; ++iteration)
+    {
+        uint32_t cluster = field.findTightestCluster();
+        field.set(cluster, false);
+        uint32_t largestVoid = field.findLargestVoid();
+        field.set(largestVoid, true);
+        if (largestVoid == cluster)
+            break;
+    }
+    EnergyField prototype = field;
+
+    std::vector<uint32_t> ranks(texelCount);
+
+    // Rank the points of the initial pattern by removing the tightest cluster.
+    for (uint32_t rank = initialCount; rank-- > 0;)
+    {
+        uint32_t cluster = field.findTightestCluster();
+        field.set(cluster, false);
+        ranks[cluster] = rank;
+    }
+
+    // Rank the remaining texels by filling the largest void.
+    field = std::move(prototype);
+    for (uint32_t rank = initialCount; rank < texelCount; ++rank)
+    {
+        uint32_t largestVoid = field.findLargestVoid();
+        field.set(largestVoid, true);
+        ranks[largestVoid] = rank;
+    }
+
+    return ranks;
+}
+} // namespace Falcor
@@ -0,0 +1,242 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SobolSequence.h"
+#include "Core/Error.h"
+#include <array>
+#include <iterator>
+
+namespace Falcor
+{
+namespace
+{
+/// Maximum degree of the primitive polynomials in the direction number table.
+const uint32_t kMaxPolynomialDegree = 9;
+
+/// Primitive polynomial and initialization numbers of one dimension.
+struct DirectionNumberEntry
+{
+    uint32_t degree;                     ///< Degree s of the primitive polynomial.
+    uint32_t coefficients;               ///< Interior coefficients a of the polynomial, the coefficient of x^(s-1) in the MSB.
+    uint32_t init[kMaxPolynomialDegree]; ///< Initialization numbers m_1..m_s.
+};
+
+/**
+ * Direction numbers for dimensions 1..kSobolMaxDimensionCount-1 from the file new-joe-kuo-6.21201 of
+ * "Constructing Sobol sequences with better two-dimensional projections", Joe and Kuo 2008.
+ * Entry i is the line of dimension d = i + 2 in the file (the file counts dimensions from 1).
+ */
+const DirectionNumberEntry kJoeKuoDirectionNumbers[] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+    {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+    {7, 7, {1, 1, 3, 13, 7, 35, 63}},
+    {7, 8, {1, 3, 5, 9, 1, 25, 53}},
+    {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+    {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+    {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+    {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+    {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+    {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+    {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+    {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+    {7, 42, {1, 3, 7, 3, 13, 59, 17}},
+    {7, 50, {1, 3, 1, 3, 5, 53, 69}},
+    {7, 55, {1, 1, 5, 5, 23, 33, 13}},
+    {7, 56, {1, 1, 7, 7, 1, 61, 123}},
+    {7, 59, {1, 1, 7, 9, 13, 61, 49}},
+    {7, 62, {1, 3, 3, 5, 3, 55, 33}},
+    {8, 14, {1, 3, 1, 15, 31, 13, 49, 245}},
+    {8, 21, {1, 3, 5, 15, 31, 59, 63, 97}},
+    {8, 22, {1, 3, 1, 11, 11, 11, 77, 249}},
+    {8, 38, {1, 3, 1, 11, 27, 43, 71, 9}},
+    {8, 47, {1, 1, 7, 15, 21, 11, 81, 45}},
+    {8, 49, {1, 3, 7, 3, 25, 31, 65, 79}},
+    {8, 50, {1, 3, 1, 1, 19, 11, 3, 205}},
+    {8, 52, {1, 1, 5, 9, 19, 21, 29, 157}},
+    {8, 56, {1, 3, 7, 11, 1, 33, 89, 185}},
+    {8, 67, {1, 3, 3, 3, 15, 9, 79, 71}},
+    {8, 70, {1, 3, 7, 11, 15, 39, 119, 27}},
+    {8, 84, {1, 1, 3, 1, 11, 31, 97, 225}},
+    {8, 97, {1, 1, 1, 3, 23, 43, 57, 177}},
+    {8, 103, {1, 3, 7, 7, 17, 17, 37, 71}},
+    {8, 115, {1, 3, 1, 5, 27, 63, 123, 213}},
+    {8, 122, {1, 1, 3, 5, 11, 43, 53, 133}},
+    {9, 8, {1, 3, 5, 5, 29, 17, 47, 173, 479}},
+    {9, 13, {1, 3, 3, 11, 3, 1, 109, 9, 69}},
+    {9, 16, {1, 1, 1, 5, 17, 39, 23, 5, 343}},
+    {9, 22, {1, 3, 1, 5, 25, 15, 31, 103, 499}},
+    {9, 25, {1, 1, 1, 11, 11, 17, 63, 105, 183}},
+    {9, 44, {1, 1, 5, 11, 9, 29, 97, 231, 363}},
+    {9, 47, {1, 1, 5, 15, 19, 45, 41, 7, 383}},
+    {9, 52, {1, 3, 7, 7, 31, 19, 83, 137, 221}},
+    {9, 55, {1, 1, 1, 3, 23, 15, 111, 223, 83}},
+    {9, 59, {1, 1, 5, 13, 31, 15, 55, 25, 161}},
+    {9, 62, {1, 1, 3, 13, 25, 47, 39, 87, 257}},
+};
+
+static_assert(std::size(kJoeKuoDirectionNumbers) == kSobolMaxDimensionCount - 1);
+
+/**
+ * Compute direction numbers from a primitive polynomial and initialization numbers using the
+ * recurrence of Bratley and Fox.
+ * @param[in] entry Primitive polynomial and initialization numbers (m_k odd and less than 2^k).
+ * @param[out] matrix Direction numbers.
+ */
+void computeDirectionNumbers(const DirectionNumberEntry& entry, uint32_t* matrix)
+{
+    const uint32_t s = entry.degree;
+    std::array<uint32_t, kSobolBitCount + 1> m = {};
+    for (uint32_t k = 1; k <= kSobolBitCount; ++k)
+    {
+        if (k <= s)
+        {
+            m[k] = entry.init[k - 1];
+        }
+        else
+        {
+            m[k] = m[k - s] ^ (m[k - s] << s);
+            for (uint32_t i = 1; i < s; ++i)
+            {
+                if ((entry.coefficients >> (s - 1 - i)) & 1)
+                    m[k] ^= m[k - i] << i;
+            }
+        }
+        matrix[k - 1] = m[k] << (kSobolBitCount - k);
+    }
+}
+
+/// Returns the index of the most significant set bit.
+uint32_t getHighestBit(uint32_t x)
+{
+    uint32_t bit = 0;
+    while (x >>= 1)
+        bit++;
+    return bit;
+}
+
+/// Get the first rowCount rows of the generator matrix restricted to the first m columns.
+void getRows(const uint32_t* matrix, uint32_t rowCount, uint32_t m, uint32_t* rows)
+{
+    for (uint32_t r = 0; r < rowCount; ++r)
+    {
+        rows[r] = 0;
+        for (uint32_t c = 0; c < m; ++c)
+            rows[r] |= ((matrix[c] >> (kSobolBitCount - 1 - r)) & 1) << c;
+    }
+}
+
+/// Check if a set of GF(2) row vectors is linearly independent.
+bool isLinearlyIndependent(const uint32_t* rows, uint32_t count)
+{
+    std::array<uint32_t, kSobolBitCount> basis = {};
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t x = rows[i];
+        while (x != 0)
+        {
+            uint32_t bit = getHighestBit(x);
+            if (basis[bit] == 0)
+            {
+                basis[bit] = x;
+                break;
+            }
+            x ^= basis[bit];
+        }
+        if (x == 0)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+std::vector<uint32_t> generateSobolMatrices(uint32_t dimensionCount)
+{
+    FALCOR_CHECK(
+        dimensionCount <= kSobolMaxDimensionCount, "'dimensionCount' ({}) must not exceed {}.", dimensionCount, kSobolMaxDimensionCount
+    );
+
+    std::vector<uint32_t> matrices(dimensionCount * kSobolBitCount);
+    if (dimensionCount == 0)
+        return matrices;
+
+    // Dimension 0 is the van der Corput sequence.
+    for (uint32_t k = 0; k < kSobolBitCount; ++k)
+        matrices[k] = 1u << (kSobolBitCount - 1 - k);
+
+    for (uint32_t d = 1; d < dimensionCount; ++d)
+        computeDirectionNumbers(kJoeKuoDirectionNumbers[d - 1], matrices.data() + d * kSobolBitCount);
+
+    return matrices;
+}
+
+uint32_t computeSobolTValue(const uint32_t* matrixA, const uint32_t* matrixB, uint32_t m)
+{
+    FALCOR_CHECK(m <= kSobolBitCount, "'m' must not exceed {}.", kSobolBitCount);
+
+    std::array<uint32_t, kSobolBitCount> rowsA;
+    std::array<uint32_t, kSobolBitCount> rowsB;
+    getRows(matrixA, m, m, rowsA.data());
+    getRows(matrixB, m, m, rowsB.data());
+
+    // The points are a (t,m,2)-net with quality q = m - t if for all d1 + d2 = q
+    // the first d1 rows of A and the first d2 rows of B are linearly independent.
+    std::array<uint32_t, kSobolBitCount> rows;
+    for (uint32_t q = m; q > 0; --q)
+    {
+        bool valid = true;
+        for (uint32_t d1 = 0; d1 <= q && valid; ++d1)
+        {
+            for (uint32_t r = 0; r < d1; ++r)
+                rows[r] = rowsA[r];
+            for (uint32_t r = 0; r < q - d1; ++r)
+                rows[d1 + r] = rowsB[r];
+            valid = isLinearlyIndependent(rows.data(), q);
+        }
+        if (valid)
+            return m - q;
+    }
+    return m;
+}
+} // namespace Falcor
@@ -0,0 +1,151 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/HashUtils.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Sobol sequence with Owen scrambling.
+ *
+ * Each dimension is defined by a 32x32 generator matrix over GF(2), stored as 32 direction numbers
+ * (one per bit of the sample index). The first bit of a sample is stored in the most significant bit.
+ * The functions in this file are mirrored in SobolSequence.slang, so that the CPU and GPU produce
+ * bit-identical samples given the same matrices.
+ */
+
+/// Number of direction numbers per dimension.
+static constexpr uint32_t kSobolBitCount = 32;
+
+/// Number of dimensions with tabulated direction numbers.
+static constexpr uint32_t kSobolMaxDimensionCount = 64;
+
+/**
+ * Generate Sobol generator matrices.
+ *
+ * Dimension 0 is the van der Corput sequence. The following dimensions use the primitive polynomials
+ * and initialization numbers of the new-joe-kuo-6.21201 table (Joe and Kuo 2008), which are chosen to
+ * optimize the t-values of the 2D projections. Dimensions 0 and 1 form a (0,2)-sequence.
+ *
+ * @param[in] dimensionCount Number of dimensions (at most kSobolMaxDimensionCount).
+ * @return Direction numbers, kSobolBitCount per dimension.
+ */
+FALCOR_API std::vector<uint32_t> generateSobolMatrices(uint32_t dimensionCount);
+
+/**
+ * Compute the t-value of the 2D projection of the first 2^m points of a digital sequence.
+ * The points form a (t,m,2)-net in base 2 with this t-value, i.e. every elementary interval of area
+ * 2^(t-m) contains exactly 2^t points.
+ * @param[in] matrixA Direction numbers of the first dimension.
+ * @param[in] matrixB Direction numbers of the second dimension.
+ * @param[in] m Number of index bits (m <= kSobolBitCount).
+ * @return The t-value in [0, m].
+ */
+FALCOR_API uint32_t computeSobolTValue(const uint32_t* matrixA, const uint32_t* matrixB, uint32_t m);
+
+/**
+ * Compute a sample of one dimension of a digital sequence.
+ * @param[in] matrix Direction numbers of the dimension.
+ * @param[in] index Sample index.
+ * @return Sample value as 32-bit fixed point in [0,1).
+ */
+inline uint32_t sobolSample(const uint32_t* matrix, uint32_t index)
+{
+    uint32_t x = 0;
+    for (uint32_t bit = 0; index != 0; index >>= 1, ++bit)
+    {
+        if (index & 1)
+            x ^= matrix[bit];
+    }
+    return x;
+}
+
+/// Reverse the bits of a 32-bit value (mirrors the reversebits() intrinsic).
+inline uint32_t reverseBits32(uint32_t x)
+{
+    x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+    x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+    x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+    x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+    return (x << 16) | (x >> 16);
+}
+
+/// Combine a seed with a value into a new seed.
+inline uint32_t hashCombine(uint32_t seed, uint32_t value)
+{
+    return seed ^ (jenkinsHash(value) + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * Laine-Karras style permutation. Each bit of the result only depends on the same and lower bits
+ * of the input, so this is a nested uniform scramble of the bit-reversed value.
+ * The constants are from "Practical Hash-based Owen Scrambling", Burley 2020, with the improved
+ * mixing of Vegdahl.
+ */
+inline uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed)
+{
+    x ^= x * 0x3d20adeau;
+    x += seed;
+    x *= (seed >> 16) | 1u;
+    x ^= x * 0x05526c56u;
+    x ^= x * 0x53a22864u;
+    return x;
+}
+
+/**
+ * Owen scramble a 32-bit fixed point value. Applied to sample values this randomizes the sequence
+ * while preserving its stratification. Applied to sample indices it shuffles the sequence such that
+ * every aligned block of 2^m indices maps to an aligned block of 2^m indices.
+ */
+inline uint32_t nestedUniformScramble(uint32_t x, uint32_t seed)
+{
+    return reverseBits32(laineKarrasPermutation(reverseBits32(x), seed));
+}
+
+/**
+ * Compute a sample of an Owen-scrambled, shuffled Sobol sequence.
+ * Dimensions beyond the number of matrices reuse the matrices with a different shuffle and scramble.
+ * @param[in] matrices Direction numbers of all dimensions.
+ * @param[in] dimensionCount Number of dimensions in matrices.
+ * @param[in] index Sample index.
+ * @param[in] dimension Dimension.
+ * @param[in] seed Seed of the sequence.
+ * @return Sample value as 32-bit fixed point in [0,1).
+ */
+inline uint32_t sampleScrambledSobol(const uint32_t* matrices, uint32_t dimensionCount, uint32_t index, uint32_t dimension, uint32_t seed)
+{
+    uint32_t groupSeed = hashCombine(seed, dimension / dimensionCount);
+    uint32_t d = dimension % dimensionCount;
+    uint32_t shuffledIndex = nestedUniformScramble(index, groupSeed);
+    uint32_t x = sobolSample(matrices + d * kSobolBitCount, shuffledIndex);
+    return nestedUniformScramble(x, hashCombine(groupSeed, d + 1));
+}
+} // namespace Falcor
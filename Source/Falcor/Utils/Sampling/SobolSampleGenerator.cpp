@@ -0,0 +1,85 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SobolSampleGenerator.h"
+#include "LowDiscrepancy/BlueNoise.h"
+#include "LowDiscrepancy/SobolSequence.h"
+#include "Core/API/Device.h"
+#include "Core/Error.h"
+
+namespace Falcor
+{
+SobolSampleGenerator::SobolSampleGenerator(ref<Device> pDevice, uint32_t type) : SampleGenerator(pDevice, type)
+{
+    FALCOR_CHECK(type == SAMPLE_GENERATOR_SOBOL || type == SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, "Invalid Sobol sample generator type.");
+
+    const auto& matrices = getSobolMatrices();
+    mpSobolMatrices = mpDevice->createStructuredBuffer(
+        sizeof(uint32_t), (uint32_t)matrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, matrices.data(), false
+    );
+    mpSobolMatrices->setName("SobolSampleGenerator::mpSobolMatrices");
+
+    if (type == SAMPLE_GENERATOR_SOBOL_BLUE_NOISE)
+    {
+        const auto& mask = getBlueNoiseMask();
+        mpBlueNoiseMask = mpDevice->createStructuredBuffer(
+            sizeof(uint32_t), (uint32_t)mask.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mask.data(), false
+        );
+        mpBlueNoiseMask->setName("SobolSampleGenerator::mpBlueNoiseMask");
+    }
+}
+
+void SobolSampleGenerator::bindShaderData(const ShaderVar& var) const
+{
+    // The globals only exist if the program imports the generator, e.g. not in passes that never use it.
+    if (var.hasMember("gSobolMatrices"))
+        var["gSobolMatrices"] = mpSobolMatrices;
+    if (mpBlueNoiseMask && var.hasMember("gBlueNoiseMask"))
+        var["gBlueNoiseMask"] = mpBlueNoiseMask;
+}
+
+const std::vector<uint32_t>& SobolSampleGenerator::getSobolMatrices()
+{
+    static_assert(SOBOL_DIMENSION_COUNT <= kSobolMaxDimensionCount, "SOBOL_DIMENSION_COUNT exceeds the tabulated direction numbers.");
+    static const std::vector<uint32_t> matrices = generateSobolMatrices(SOBOL_DIMENSION_COUNT);
+    return matrices;
+}
+
+const std::vector<uint32_t>& SobolSampleGenerator::getBlueNoiseMask()
+{
+    static const std::vector<uint32_t> mask = []()
+    {
+        // Convert ranks to offsets at the center of each of the N strata of [0,1).
+        const uint32_t texelCount = BLUE_NOISE_MASK_SIZE * BLUE_NOISE_MASK_SIZE;
+        std::vector<uint32_t> offsets = generateBlueNoiseMask(BLUE_NOISE_MASK_SIZE);
+        for (uint32_t& offset : offsets)
+            offset = (uint32_t)(((2 * (uint64_t)offset + 1) << 31) / texelCount);
+        return offsets;
+    }();
+    return mask;
+}
+} // namespace Falcor
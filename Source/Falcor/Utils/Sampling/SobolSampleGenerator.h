@@ -0,0 +1,64 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SampleGenerator.h"
+#include "Core/API/Buffer.h"
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Sobol sample generators (SAMPLE_GENERATOR_SOBOL and SAMPLE_GENERATOR_SOBOL_BLUE_NOISE).
+ *
+ * The generator matrices and the blue-noise mask are generated on the host the first time they
+ * are needed, and uploaded to the GPU for each instance. See SobolSampleGenerator.slang and
+ * BlueNoiseSampleGenerator.slang for the GPU side.
+ */
+class FALCOR_API SobolSampleGenerator : public SampleGenerator
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] type SAMPLE_GENERATOR_SOBOL or SAMPLE_GENERATOR_SOBOL_BLUE_NOISE.
+     */
+    SobolSampleGenerator(ref<Device> pDevice, uint32_t type);
+
+    void bindShaderData(const ShaderVar& var) const override;
+
+    /// Get the Sobol generator matrices (SOBOL_DIMENSION_COUNT * 32 direction numbers).
+    static const std::vector<uint32_t>& getSobolMatrices();
+
+    /// Get the blue-noise mask (BLUE_NOISE_MASK_SIZE^2 offsets as 32-bit fixed point in [0,1)).
+    static const std::vector<uint32_t>& getBlueNoiseMask();
+
+private:
+    ref<Buffer> mpSobolMatrices;
+    ref<Buffer> mpBlueNoiseMask;
+};
+} // namespace Falcor
@@ -0,0 +1,432 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TLSFAllocator.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Math/Common.h"
+
+namespace Falcor
+{
+namespace
+{
+uint32_t bitScanForward64(uint64_t a)
+{
+    uint32_t lo = uint32_t(a);
+    return lo != 0 ? bitScanForward(lo) : 32 + bitScanForward(uint32_t(a >> 32));
+}
+
+uint32_t bitScanReverse64(uint64_t a)
+{
+    uint32_t hi = uint32_t(a >> 32);
+    return hi != 0 ? 32 + bitScanReverse(hi) : bitScanReverse(uint32_t(a));
+}
+} // namespace
+
+TLSFAllocator::TLSFAllocator()
+{
+    for (auto& lists : mFreeLists)
+        for (auto& list : lists)
+            list = kInvalidIndex;
+}
+
+uint32_t TLSFAllocator::addPage(uint64_t size)
+{
+    FALCOR_CHECK(size > 0, "Page size must be larger than zero.");
+
+    uint32_t page;
+    if (!mFreePageSlots.empty())
+    {
+        page = mFreePageSlots.back();
+        mFreePageSlots.pop_back();
+    }
+    else
+    {
+        page = (uint32_t)mPages.size();
+        mPages.emplace_back();
+    }
+
+    uint32_t block = createBlock();
+    mBlocks[block].offset = 0;
+    mBlocks[block].size = size;
+    mBlocks[block].page = page;
+    insertFreeBlock(block);
+
+    mPages[page] = {size, block, 0};
+    return page;
+}
+
+void TLSFAllocator::removePage(uint32_t page)
+{
+    FALCOR_CHECK(isPageValid(page), "Invalid page index {}.", page);
+    FALCOR_CHECK(isPageEmpty(page), "Page {} has live allocations.", page);
+
+    uint32_t block = mPages[page].firstBlock;
+    FALCOR_ASSERT(mBlocks[block].isFree && mBlocks[block].size == mPages[page].size);
+    removeFreeBlock(block);
+    destroyBlock(block);
+
+    mPages[page] = {};
+    mFreePageSlots.push_back(page);
+}
+
+TLSFAllocator::Allocation TLSFAllocator::allocate(uint64_t size, uint64_t alignment)
+{
+    FALCOR_CHECK(size > 0, "Allocation size must be larger than zero.");
+    FALCOR_CHECK(alignment > 0, "Alignment must be larger than zero.");
+
+    // Search for a block that fits the allocation at any offset alignment.
+    uint64_t searchSize = size + alignment - 1;
+    if (searchSize < size)
+        return {};
+    uint32_t block = findFreeBlock(searchSize);
+    if (block == kInvalidIndex)
+        return {};
+
+    removeFreeBlock(block);
+
+    // Split off the padding in front of the aligned offset. The previous block is never free, so the padding
+    // becomes a separate free block.
+    uint64_t padding = align_to(alignment, mBlocks[block].offset) - mBlocks[block].offset;
+    if (padding > 0)
+    {
+        splitFreeBlock(block, padding);
+        uint32_t next = mBlocks[block].nextPhysical;
+        insertFreeBlock(block);
+        block = next;
+    }
+
+    // Split off the remainder.
+    if (mBlocks[block].size > size)
+    {
+        splitFreeBlock(block, size);
+        insertFreeBlock(mBlocks[block].nextPhysical);
+    }
+
+    Block& b = mBlocks[block];
+    b.isFree = false;
+    mPages[b.page].allocationCount++;
+    mAllocationCount++;
+    mAllocatedBytes += b.size;
+
+    Allocation allocation;
+    allocation.page = b.page;
+    allocation.block = block;
+    allocation.offset = b.offset;
+    allocation.size = b.size;
+    return allocation;
+}
+
+uint64_t TLSFAllocator::getRequiredPageSize(uint64_t size, uint64_t alignment)
+{
+    FALCOR_CHECK(size > 0, "Allocation size must be larger than zero.");
+    FALCOR_CHECK(alignment > 0, "Alignment must be larger than zero.");
+
+    // Same search size as in allocate().
+    uint64_t searchSize = size + alignment - 1;
+    uint64_t pageSize = searchSize >= size ? roundUpToSizeClass(searchSize) : 0;
+    FALCOR_CHECK(pageSize > 0, "Allocation size {} with alignment {} is too large.", size, alignment);
+    return pageSize;
+}
+
+void TLSFAllocator::free(const Allocation& allocation)
+{
+    FALCOR_CHECK(allocation.isValid() && allocation.block < mBlocks.size(), "Invalid allocation.");
+    uint32_t block = allocation.block;
+    FALCOR_CHECK(!mBlocks[block].isFree && mBlocks[block].page == allocation.page, "Allocation was already freed.");
+
+    Block& b = mBlocks[block];
+    b.isFree = true;
+    mPages[b.page].allocationCount--;
+    mAllocationCount--;
+    mAllocatedBytes -= b.size;
+
+    // Merge with free neighbors.
+    uint32_t next = b.nextPhysical;
+    if (next != kInvalidIndex && mBlocks[next].isFree)
+    {
+        removeFreeBlock(next);
+        mergeWithNext(block);
+    }
+    uint32_t prev = mBlocks[block].prevPhysical;
+    if (prev != kInvalidIndex && mBlocks[prev].isFree)
+    {
+        removeFreeBlock(prev);
+        mergeWithNext(prev);
+        block = prev;
+    }
+
+    insertFreeBlock(block);
+}
+
+bool TLSFAllocator::isPageEmpty(uint32_t page) const
+{
+    FALCOR_ASSERT(isPageValid(page));
+    return mPages[page].allocationCount == 0;
+}
+
+TLSFAllocator::Stats TLSFAllocator::getStats() const
+{
+    Stats stats;
+    for (const auto& page : mPages)
+    {
+        if (page.size == 0)
+            continue;
+        stats.pageCount++;
+        stats.pageBytes += page.size;
+    }
+    stats.allocationCount = mAllocationCount;
+    stats.allocatedBytes = mAllocatedBytes;
+
+    for (uint32_t fl = 0; fl < kFirstLevelCount; ++fl)
+    {
+        for (uint32_t sl = 0; sl < kSecondLevelCount; ++sl)
+        {
+            for (uint32_t block = mFreeLists[fl][sl]; block != kInvalidIndex; block = mBlocks[block].nextFree)
+            {
+                stats.freeBlockCount++;
+                stats.largestFreeBlock = std::max(stats.largestFreeBlock, mBlocks[block].size);
+            }
+        }
+    }
+
+    return stats;
+}
+
+void TLSFAllocator::validate() const
+{
+    uint32_t freeBlockCount = 0;
+    uint32_t allocationCount = 0;
+    uint64_t allocatedBytes = 0;
+
+    // Check that the blocks of each page cover the page and that no two free blocks are adjacent.
+    for (uint32_t page = 0; page < mPages.size(); ++page)
+    {
+        if (!isPageValid(page))
+            continue;
+
+        uint64_t offset = 0;
+        uint32_t pageAllocationCount = 0;
+        uint32_t prev = kInvalidIndex;
+        for (uint32_t block = mPages[page].firstBlock; block != kInvalidIndex; block = mBlocks[block].nextPhysical)
+        {
+            const Block& b = mBlocks[block];
+            FALCOR_CHECK(b.page == page, "Block {} has wrong page.", block);
+            FALCOR_CHECK(b.offset == offset, "Block {} has wrong offset.", block);
+            FALCOR_CHECK(b.size > 0, "Block {} is empty.", block);
+            FALCOR_CHECK(b.prevPhysical == prev, "Block {} has wrong previous block.", block);
+            if (b.isFree)
+            {
+                FALCOR_CHECK(prev == kInvalidIndex || !mBlocks[prev].isFree, "Adjacent free blocks {} and {}.", prev, block);
+                freeBlockCount++;
+            }
+            else
+            {
+                pageAllocationCount++;
+                allocatedBytes += b.size;
+            }
+            offset += b.size;
+            prev = block;
+        }
+        FALCOR_CHECK(offset == mPages[page].size, "Blocks of page {} do not cover the page.", page);
+        FALCOR_CHECK(pageAllocationCount == mPages[page].allocationCount, "Page {} has wrong allocation count.", page);
+        allocationCount += pageAllocationCount;
+    }
+    FALCOR_CHECK(allocationCount == mAllocationCount, "Wrong allocation count.");
+    FALCOR_CHECK(allocatedBytes == mAllocatedBytes, "Wrong allocated bytes.");
+
+    // Check that the free lists contain exactly the free blocks, in the right size classes.
+    uint32_t listedBlockCount = 0;
+    for (uint32_t fl = 0; fl < kFirstLevelCount; ++fl)
+    {
+        bool hasSecondLevel = false;
+        for (uint32_t sl = 0; sl < kSecondLevelCount; ++sl)
+        {
+            bool hasBlocks = mFreeLists[fl][sl] != kInvalidIndex;
+            FALCOR_CHECK(hasBlocks == ((mSecondLevelBitmaps[fl] >> sl) & 1), "Wrong second level bitmap.");
+            hasSecondLevel |= hasBlocks;
+
+            uint32_t prev = kInvalidIndex;
+            for (uint32_t block = mFreeLists[fl][sl]; block != kInvalidIndex; block = mBlocks[block].nextFree)
+            {
+                const Block& b = mBlocks[block];
+                uint32_t blockFl, blockSl;
+                mapping(b.size, blockFl, blockSl);
+                FALCOR_CHECK(b.isFree, "Block {} in free list is not free.", block);
+                FALCOR_CHECK(blockFl == fl && blockSl == sl, "Block {} is in the wrong free list.", block);
+                FALCOR_CHECK(b.prevFree == prev, "Block {} has wrong previous free block.", block);
+                listedBlockCount++;
+                prev = block;
+            }
+        }
+        FALCOR_CHECK(hasSecondLevel == ((mFirstLevelBitmap >> fl) & 1), "Wrong first level bitmap.");
+    }
+    FALCOR_CHECK(listedBlockCount == freeBlockCount, "Free lists do not match free blocks.");
+}
+
+void TLSFAllocator::mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+    if (size < kSecondLevelCount)
+    {
+        // Small sizes map linearly to the second level of the first class.
+        firstLevel = 0;
+        secondLevel = (uint32_t)size;
+    }
+    else
+    {
+        uint32_t msb = bitScanReverse64(size);
+        firstLevel = msb - kSecondLevelBits + 1;
+        secondLevel = (uint32_t)(size >> (msb - kSecondLevelBits)) - kSecondLevelCount;
+    }
+}
+
+uint64_t TLSFAllocator::roundUpToSizeClass(uint64_t size)
+{
+    if (size < kSecondLevelCount)
+        return size;
+    uint64_t round = (1ull << (bitScanReverse64(size) - kSecondLevelBits)) - 1;
+    return size + round < size ? 0 : size + round;
+}
+
+uint32_t TLSFAllocator::createBlock()
+{
+    uint32_t block;
+    if (mFreeBlockSlot != kInvalidIndex)
+    {
+        block = mFreeBlockSlot;
+        mFreeBlockSlot = mBlocks[block].prevFree;
+    }
+    else
+    {
+        block = (uint32_t)mBlocks.size();
+        mBlocks.emplace_back();
+    }
+    mBlocks[block] = {};
+    return block;
+}
+
+void TLSFAllocator::destroyBlock(uint32_t block)
+{
+    mBlocks[block] = {};
+    mBlocks[block].prevFree = mFreeBlockSlot;
+    mFreeBlockSlot = block;
+}
+
+void TLSFAllocator::insertFreeBlock(uint32_t block)
+{
+    Block& b = mBlocks[block];
+    uint32_t fl, sl;
+    mapping(b.size, fl, sl);
+
+    b.isFree = true;
+    b.prevFree = kInvalidIndex;
+    b.nextFree = mFreeLists[fl][sl];
+    if (b.nextFree != kInvalidIndex)
+        mBlocks[b.nextFree].prevFree = block;
+    mFreeLists[fl][sl] = block;
+
+    mFirstLevelBitmap |= 1ull << fl;
+    mSecondLevelBitmaps[fl] |= 1u << sl;
+}
+
+void TLSFAllocator::removeFreeBlock(uint32_t block)
+{
+    Block& b = mBlocks[block];
+    uint32_t fl, sl;
+    mapping(b.size, fl, sl);
+
+    if (b.prevFree != kInvalidIndex)
+        mBlocks[b.prevFree].nextFree = b.nextFree;
+    else
+        mFreeLists[fl][sl] = b.nextFree;
+    if (b.nextFree != kInvalidIndex)
+        mBlocks[b.nextFree].prevFree = b.prevFree;
+    b.prevFree = b.nextFree = kInvalidIndex;
+
+    if (mFreeLists[fl][sl] == kInvalidIndex)
+    {
+        mSecondLevelBitmaps[fl] &= ~(1u << sl);
+        if (mSecondLevelBitmaps[fl] == 0)
+            mFirstLevelBitmap &= ~(1ull << fl);
+    }
+}
+
+uint32_t TLSFAllocator::findFreeBlock(uint64_t size) const
+{
+    size = roundUpToSizeClass(size);
+    if (size == 0)
+        return kInvalidIndex;
+
+    uint32_t fl, sl;
+    mapping(size, fl, sl);
+
+    uint32_t secondLevelMap = mSecondLevelBitmaps[fl] & (~0u << sl);
+    if (secondLevelMap == 0)
+    {
+        uint64_t firstLevelMap = fl + 1 < 64 ? mFirstLevelBitmap & (~0ull << (fl + 1)) : 0;
+        if (firstLevelMap == 0)
+            return kInvalidIndex;
+        fl = bitScanForward64(firstLevelMap);
+        secondLevelMap = mSecondLevelBitmaps[fl];
+    }
+    sl = bitScanForward(secondLevelMap);
+
+    return mFreeLists[fl][sl];
+}
+
+void TLSFAllocator::splitFreeBlock(uint32_t block, uint64_t size)
+{
+    FALCOR_ASSERT(mBlocks[block].size > size);
+
+    uint32_t remainder = createBlock();
+    Block& b = mBlocks[block];
+    Block& r = mBlocks[remainder];
+    r.offset = b.offset + size;
+    r.size = b.size - size;
+    r.page = b.page;
+    r.isFree = true;
+    r.prevPhysical = block;
+    r.nextPhysical = b.nextPhysical;
+    if (r.nextPhysical != kInvalidIndex)
+        mBlocks[r.nextPhysical].prevPhysical = remainder;
+    b.nextPhysical = remainder;
+    b.size = size;
+}
+
+void TLSFAllocator::mergeWithNext(uint32_t block)
+{
+    uint32_t next = mBlocks[block].nextPhysical;
+    FALCOR_ASSERT(next != kInvalidIndex);
+
+    Block& b = mBlocks[block];
+    b.size += mBlocks[next].size;
+    b.nextPhysical = mBlocks[next].nextPhysical;
+    if (b.nextPhysical != kInvalidIndex)
+        mBlocks[b.nextPhysical].prevPhysical = block;
+    destroyBlock(next);
+}
+} // namespace Falcor
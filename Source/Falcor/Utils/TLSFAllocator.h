@@ -0,0 +1,189 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Two-level segregated fit (TLSF) sub-allocator for ranges in memory pages.
+ *
+ * The allocator only manages offsets, it does not own any memory. Pages are added by the caller, which
+ * maps page indices to the actual memory (see GpuMemoryHeap). This keeps the allocation policy testable on the CPU.
+ *
+ * Free blocks are kept in size-classed free lists: the first level splits sizes by powers of two,
+ * the second level splits each power of two into 16 linear classes. Allocation and free run in constant
+ * time. Freed blocks are merged with free neighbors in the same page, so a page whose allocations
+ * have all been freed consists of a single free block and can be removed.
+ */
+class FALCOR_API TLSFAllocator
+{
+public:
+    static constexpr uint32_t kInvalidIndex = uint32_t(-1);
+
+    struct Allocation
+    {
+        uint32_t page = kInvalidIndex;  ///< Page index.
+        uint32_t block = kInvalidIndex; ///< Internal block index.
+        uint64_t offset = 0;            ///< Offset of the allocation in the page in bytes.
+        uint64_t size = 0;              ///< Size of the allocation in bytes.
+
+        bool isValid() const { return block != kInvalidIndex; }
+    };
+
+    struct Stats
+    {
+        uint32_t pageCount = 0;        ///< Number of pages.
+        uint64_t pageBytes = 0;        ///< Total size of all pages in bytes.
+        uint32_t allocationCount = 0;  ///< Number of live allocations.
+        uint64_t allocatedBytes = 0;   ///< Bytes in live allocations.
+        uint32_t freeBlockCount = 0;   ///< Number of free blocks.
+        uint64_t largestFreeBlock = 0; ///< Size of the largest free block in bytes.
+
+        /// Fragmentation of free memory, 0 if all free memory is in a single block, approaching 1 if it is split into many blocks.
+        double getFragmentation() const
+        {
+            uint64_t freeBytes = pageBytes - allocatedBytes;
+            return freeBytes > 0 ? 1.0 - (double)largestFreeBlock / (double)freeBytes : 0.0;
+        }
+    };
+
+    TLSFAllocator();
+
+    /**
+     * Add a page of memory.
+     * @param[in] size Page size in bytes.
+     * @return Page index. Indices of removed pages are reused.
+     */
+    uint32_t addPage(uint64_t size);
+
+    /**
+     * Remove an empty page.
+     * @param[in] page Page index.
+     */
+    void removePage(uint32_t page);
+
+    /**
+     * Allocate a range.
+     * @param[in] size Size in bytes (> 0).
+     * @param[in] alignment Alignment of the offset in bytes (> 0).
+     * @return The allocation, or an invalid allocation if no page has a large enough free block.
+     */
+    Allocation allocate(uint64_t size, uint64_t alignment = 1);
+
+    /**
+     * Get the smallest page size for which an allocation is guaranteed to succeed in an empty page.
+     * This is larger than the allocation size since free blocks are searched by size class.
+     * @param[in] size Size in bytes (> 0).
+     * @param[in] alignment Alignment of the offset in bytes (> 0).
+     * @return Page size in bytes.
+     */
+    static uint64_t getRequiredPageSize(uint64_t size, uint64_t alignment = 1);
+
+    /**
+     * Free an allocation.
+     * @param[in] allocation Allocation returned by allocate().
+     */
+    void free(const Allocation& allocation);
+
+    /**
+     * Check if a page has no live allocations.
+     */
+    bool isPageEmpty(uint32_t page) const;
+
+    /**
+     * Check if a page index refers to a page that has not been removed.
+     */
+    bool isPageValid(uint32_t page) const { return page < mPages.size() && mPages[page].size > 0; }
+
+    uint64_t getPageSize(uint32_t page) const { return mPages[page].size; }
+
+    /// Get the number of page slots, including those of removed pages.
+    uint32_t getPageSlotCount() const { return (uint32_t)mPages.size(); }
+
+    Stats getStats() const;
+
+    /**
+     * Check the consistency of the internal data structures. Throws on failure.
+     * This is slow and meant for testing.
+     */
+    void validate() const;
+
+private:
+    static constexpr uint32_t kSecondLevelBits = 4;
+    static constexpr uint32_t kSecondLevelCount = 1 << kSecondLevelBits;
+    static constexpr uint32_t kFirstLevelCount = 64 - kSecondLevelBits + 1;
+
+    struct Block
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t page = kInvalidIndex;
+        uint32_t prevPhysical = kInvalidIndex; ///< Previous block in the page.
+        uint32_t nextPhysical = kInvalidIndex; ///< Next block in the page.
+        uint32_t prevFree = kInvalidIndex;     ///< Previous block in the free list (or next unused block slot).
+        uint32_t nextFree = kInvalidIndex;     ///< Next block in the free list.
+        bool isFree = false;
+    };
+
+    struct Page
+    {
+        uint64_t size = 0; ///< Page size, 0 for removed pages.
+        uint32_t firstBlock = kInvalidIndex;
+        uint32_t allocationCount = 0;
+    };
+
+    static void mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+    /// Round a size up to the next size class, so that any block in the class fits. Returns 0 on overflow.
+    static uint64_t roundUpToSizeClass(uint64_t size);
+
+    uint32_t createBlock();
+    void destroyBlock(uint32_t block);
+    void insertFreeBlock(uint32_t block);
+    void removeFreeBlock(uint32_t block);
+    uint32_t findFreeBlock(uint64_t size) const;
+    /// Split a free block at the given size. The block keeps the front part, the remainder becomes a new free block.
+    void splitFreeBlock(uint32_t block, uint64_t size);
+    /// Merge a block with the next physical block. Both must be free and not in a free list.
+    void mergeWithNext(uint32_t block);
+
+    std::vector<Block> mBlocks;
+    std::vector<Page> mPages;
+    uint32_t mFreeBlockSlot = kInvalidIndex; ///< Head of the list of unused block slots.
+    std::vector<uint32_t> mFreePageSlots;
+
+    uint64_t mFirstLevelBitmap = 0;
+    uint32_t mSecondLevelBitmaps[kFirstLevelCount] = {};
+    uint32_t mFreeLists[kFirstLevelCount][kSecondLevelCount];
+
+    uint32_t mAllocationCount = 0;
+    uint64_t mAllocatedBytes = 0;
+};
+} // namespace Falcor
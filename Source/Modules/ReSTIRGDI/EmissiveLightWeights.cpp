@@ -0,0 +1,50 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # NVIDIA CORPORATION and its licensors retain all intellectual property
+ # and proprietary rights in and to this software, related documentation
+ # and any modifications thereto.  Any use, reproduction, disclosure or
+ # distribution of this software and related documentation without an express
+ # license agreement from NVIDIA CORPORATION is strictly prohibited.
+ **************************************************************************/
+#include "EmissiveLightWeights.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include <algorithm>
+#include <execution>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kChunkSize = 4096;
+    }
+
+    std::vector<AliasTable::Range> EmissiveLightWeights::getTriangleRanges(const std::vector<MeshLightData>& meshLights, const std::vector<uint32_t>& lightIndices)
+    {
+        std::vector<AliasTable::Range> ranges;
+        ranges.reserve(lightIndices.size());
+        for (uint32_t lightIdx : lightIndices)
+        {
+            ranges.push_back({ meshLights[lightIdx].triangleOffset, meshLights[lightIdx].triangleCount });
+        }
+        return ranges;
+    }
+
+    void EmissiveLightWeights::compute(const std::vector<LightCollection::MeshLightTriangle>& triangles, const std::vector<AliasTable::Range>& ranges, std::vector<float>& weights)
+    {
+        FALCOR_ASSERT(weights.size() == triangles.size());
+
+        std::vector<AliasTable::Range> chunks;
+        for (const auto& range : ranges)
+        {
+            for (uint32_t offset = 0; offset < range.count; offset += kChunkSize)
+                chunks.push_back({ range.offset + offset, std::min(kChunkSize, range.count - offset) });
+        }
+
+        std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](const AliasTable::Range& chunk)
+        {
+            for (uint32_t i = chunk.offset; i < chunk.offset + chunk.count; ++i)
+                weights[i] = luminance(triangles[i].averageRadiance) * triangles[i].area;
+        });
+    }
+}
@@ -0,0 +1,42 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # NVIDIA CORPORATION and its licensors retain all intellectual property
+ # and proprietary rights in and to this software, related documentation
+ # and any modifications thereto.  Any use, reproduction, disclosure or
+ # distribution of this software and related documentation without an express
+ # license agreement from NVIDIA CORPORATION is strictly prohibited.
+ **************************************************************************/
+#pragma once
+#include "Scene/Lights/LightCollection.h"
+#include "Utils/Sampling/AliasTable.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Sampling weights of the emissive triangles in the ReSTIR DI emissive light alias table.
+
+        The weight of a triangle is its luminance times its area. When mesh lights move or deform, only the
+        weights of their triangles are recomputed, see LightCollection::getUpdatedLights(). These updates are
+        computed on the GPU by ComputeEmissiveLightWeights.cs.slang, which must match compute().
+    */
+    class EmissiveLightWeights
+    {
+    public:
+        /** Get the emissive triangle ranges of a list of mesh lights.
+            \param[in] meshLights Mesh lights of the light collection.
+            \param[in] lightIndices Indices of the mesh lights.
+            \return List of triangle ranges, one per mesh light.
+        */
+        static std::vector<AliasTable::Range> getTriangleRanges(const std::vector<MeshLightData>& meshLights, const std::vector<uint32_t>& lightIndices);
+
+        /** Compute the weights of the given ranges of emissive triangles in parallel.
+            The ranges are split into fixed-size chunks to balance the work between a few large and many small mesh lights.
+            \param[in] triangles Emissive triangles of the light collection.
+            \param[in] ranges Triangle ranges to compute.
+            \param[in,out] weights Weights indexed by triangle. Must be sized to the triangle count, weights outside the ranges are left unchanged.
+        */
+        static void compute(const std::vector<LightCollection::MeshLightTriangle>& triangles, const std::vector<AliasTable::Range>& ranges, std::vector<float>& weights);
+    };
+}
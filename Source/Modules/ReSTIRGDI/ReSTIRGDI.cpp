@@ -8,10 +8,13 @@
  # license agreement from NVIDIA CORPORATION is strictly prohibited.
  **************************************************************************/
 #include "ReSTIRGDI.h"
+#include "EmissiveLightWeights.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Logger.h"
 #include "Utils/Timing/Profiler.h"
 #include "Utils/Color/ColorHelpers.slang"
+#include "Scene/Lights/LightPower.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -19,6 +22,7 @@ namespace Falcor
     {
         const char kReflectTypesFile[] = "Modules/ReSTIRGDI/ReflectTypes.cs.slang";
         const char kUpdateEmissiveTriangles[] = "Modules/ReSTIRGDI/UpdateEmissiveTriangles.cs.slang";
+        const char kComputeEmissiveLightWeights[] = "Modules/ReSTIRGDI/ComputeEmissiveLightWeights.cs.slang";
         const char kGenerateLightTilesFile[] = "Modules/ReSTIRGDI/GenerateLightTiles.cs.slang";
         const char kInitialResamplingFile[] = "Modules/ReSTIRGDI/InitialResampling.cs.slang";
         const char kTemporalResamplingFile[] = "Modules/ReSTIRGDI/TemporalResampling.cs.slang";
@@ -451,11 +455,27 @@ namespace Falcor
         }
 
         // Setup alias table for emissive lights.
+        // The table is built once per light collection. When mesh lights move, only the weights of their
+        // triangles are recomputed and the table is updated in place. The new weights are computed on the GPU
+        // and applied one frame later, so that moving emitters do not stall on the light collection readback.
         if (mpScene->getRenderSettings().useEmissiveLights)
         {
+            auto lightCollection = mpScene->getLightCollection(pRenderContext);
+            if (lightCollection != mpEmissiveLightCollection)
+            {
+                if (mpEmissiveTriangles)
+                {
+                    mpEmissiveTriangles = nullptr;
+                    mpEmissiveLightAliasTable = nullptr;
+                    mRecompile = true;
+                }
+                mpEmissiveLightCollection = lightCollection;
+                mEmissiveLightWeights.clear();
+                mPendingEmissiveLightRanges.clear();
+            }
+
             if (!mpEmissiveLightAliasTable)
             {
-                auto lightCollection = mpScene->getLightCollection(pRenderContext);
                 lightCollection->prepareSyncCPUData(pRenderContext);
                 lightCollection->update(pRenderContext);
                 if (lightCollection->getActiveLightCount(pRenderContext) > 0)
@@ -467,6 +487,10 @@ namespace Falcor
                     mRecompile = true;
                 }
             }
+            else
+            {
+                updateEmissiveLightAliasTable(pRenderContext, lightCollection);
+            }
         }
         else
         {
@@ -476,29 +500,36 @@ namespace Falcor
                 mpEmissiveLightAliasTable = nullptr;
                 mRecompile = true;
             }
+            mpEmissiveLightCollection = nullptr;
+            mEmissiveLightWeights.clear();
+            mPendingEmissiveLightRanges.clear();
         }
 
         // Setup alias table for analytic lights.
+        // Lights are sampled proportional to their power. The weights are recomputed whenever the lights change
+        // and the table is only rebuilt if they differ. Shaders need to be recompiled only if the light count changes.
         if (mpScene->useAnalyticLights())
         {
-            if (is_set(mpScene->getUpdates(), Scene::UpdateFlags::LightCountChanged)) mpAnalyticLightAliasTable = nullptr;
-            if (!mpAnalyticLightAliasTable)
+            const auto kLightUpdates = Scene::UpdateFlags::LightCountChanged | Scene::UpdateFlags::LightIntensityChanged |
+                Scene::UpdateFlags::LightPropertiesChanged | Scene::UpdateFlags::LightsMoved | Scene::UpdateFlags::SceneGraphChanged;
+            if (mAnalyticLightWeights.empty() || (mpScene->getUpdates() & kLightUpdates) != Scene::UpdateFlags::None)
             {
-                std::vector<ref<Light>> lights;
-                for (uint32_t i = 0; i < mpScene->getLightCount(); ++i)
+                auto weights = computeAnalyticLightWeights();
+                if (weights != mAnalyticLightWeights)
                 {
-                    const auto& light = mpScene->getLight(i);
-                    if (light->isActive()) lights.push_back(mpScene->getLight(i));
-                }
-                if (!lights.empty())
-                {
-                    mpAnalyticLightAliasTable = buildAnalyticLightAliasTable(pRenderContext, lights, mRng);
-                    mRecompile = true;
+                    const uint32_t prevCount = mpAnalyticLightAliasTable ? mpAnalyticLightAliasTable->getCount() : 0;
+                    const bool hasActiveLights = std::any_of(weights.begin(), weights.end(), [](float w) { return w > 0.f; });
+                    mpAnalyticLightAliasTable = hasActiveLights ? std::make_unique<AliasTable>(mpDevice, weights, mRng) : nullptr;
+                    mAnalyticLightWeights = std::move(weights);
+
+                    const uint32_t count = mpAnalyticLightAliasTable ? mpAnalyticLightAliasTable->getCount() : 0;
+                    if (count != prevCount) mRecompile = true;
                 }
             }
         }
         else
         {
+            mAnalyticLightWeights.clear();
             if (mpAnalyticLightAliasTable)
             {
                 mpAnalyticLightAliasTable = nullptr;
@@ -524,6 +555,36 @@ namespace Falcor
     {
         if (!mRecompile) return;
 
+        createPrograms();
+
+        // Recreate program vars. This may trigger recompilation if needed.
+        for (const auto& pPass : { mpUpdateEmissiveTriangles, mpComputeEmissiveLightWeights, mpGenerateLightTiles, mpInitialResampling, mpTemporalResampling, mpSpatialResampling, mpEvaluateFinalSamples })
+        {
+            pPass->setVars(nullptr);
+        }
+
+        mRecompile = false;
+        mResetTemporalReservoirs = true;
+    }
+
+    void ReSTIRGDI::collectProgramPermutations(RenderContext* pRenderContext, std::vector<ProgramPermutation>& permutations)
+    {
+        // The light defines depend on the alias tables, so the lighting needs to be prepared first.
+        prepareLighting(pRenderContext);
+        createPrograms();
+
+        for (const auto& pPass : { mpUpdateEmissiveTriangles, mpComputeEmissiveLightWeights, mpGenerateLightTiles, mpInitialResampling, mpTemporalResampling, mpSpatialResampling, mpEvaluateFinalSamples })
+        {
+            const auto& pProgram = pPass->getProgram();
+            permutations.push_back({ pProgram, pProgram->getDefines(), pProgram->getTypeConformances() });
+        }
+
+        // The program defines were updated without recreating the program vars. Make sure they are recreated on the next update.
+        mRecompile = true;
+    }
+
+    void ReSTIRGDI::createPrograms()
+    {
         DefineList commonDefines;
 
         commonDefines.add(mOwnerDefines);
@@ -547,7 +608,20 @@ namespace Falcor
             }
 
             mpUpdateEmissiveTriangles->getProgram()->addDefines(defines);
-            mpUpdateEmissiveTriangles->setVars(nullptr);
+        }
+
+        // ComputeEmissiveLightWeights
+        {
+            DefineList defines = commonDefines;
+
+            if (!mpComputeEmissiveLightWeights)
+            {
+                ProgramDesc desc;
+                desc.addShaderLibrary(kComputeEmissiveLightWeights).csEntry("main");
+                mpComputeEmissiveLightWeights = ComputePass::create(mpDevice, desc, defines, false);
+            }
+
+            mpComputeEmissiveLightWeights->getProgram()->addDefines(defines);
         }
 
         // GenerateLightTiles
@@ -570,7 +644,6 @@ namespace Falcor
             }
 
             mpGenerateLightTiles->getProgram()->addDefines(defines);
-            mpGenerateLightTiles->setVars(nullptr);
         }
 
         // InitialResampling
@@ -601,7 +674,6 @@ namespace Falcor
             }
 
             mpInitialResampling->getProgram()->addDefines(defines);
-            mpInitialResampling->setVars(nullptr);
         }
 
         // TemporalResampling
@@ -623,7 +695,6 @@ namespace Falcor
             }
 
             mpTemporalResampling->getProgram()->addDefines(defines);
-            mpTemporalResampling->setVars(nullptr);
         }
 
         // Spatial Resampling
@@ -643,7 +714,6 @@ namespace Falcor
             }
 
             mpSpatialResampling->getProgram()->addDefines(defines);
-            mpSpatialResampling->setVars(nullptr);
         }
 
         // EvaluateFinalSamples
@@ -666,11 +736,7 @@ namespace Falcor
             }
 
             mpEvaluateFinalSamples->getProgram()->addDefines(defines);
-            mpEvaluateFinalSamples->setVars(nullptr);
         }
-
-        mRecompile = false;
-        mResetTemporalReservoirs = true;
     }
 
     void ReSTIRGDI::updateEmissiveTriangles(RenderContext* pRenderContext)
@@ -1027,27 +1093,95 @@ namespace Falcor
 
         const auto& triangles = lightCollection->getMeshLightTriangles(pRenderContext);
 
-        std::vector<float> weights(triangles.size());
+        mEmissiveLightWeights.resize(triangles.size());
+        EmissiveLightWeights::compute(triangles, { { 0, (uint32_t)triangles.size() } }, mEmissiveLightWeights);
+
+        return std::make_unique<AliasTable>(mpDevice, mEmissiveLightWeights, rng);
+    }
+
+    void ReSTIRGDI::updateEmissiveLightAliasTable(RenderContext* pRenderContext, const ref<LightCollection>& lightCollection)
+    {
+        FALCOR_ASSERT(mpEmissiveLightAliasTable);
+        FALCOR_ASSERT(mEmissiveLightWeights.size() == lightCollection->getTotalLightCount());
+
+        // Apply the weights computed in the previous frame. The GPU has finished that frame by now,
+        // so waiting for the readback does not stall.
+        if (!mPendingEmissiveLightRanges.empty())
+        {
+            mpEmissiveLightWeightsFence->wait(mEmissiveLightWeightsFenceValue);
+
+            const float* pWeights = reinterpret_cast<const float*>(mpEmissiveLightWeightsReadback->map(Buffer::MapType::Read));
+            for (const auto& range : mPendingEmissiveLightRanges)
+            {
+                std::copy(pWeights + range.offset, pWeights + range.offset + range.count, mEmissiveLightWeights.begin() + range.offset);
+            }
+            mpEmissiveLightWeightsReadback->unmap();
+
+            mpEmissiveLightAliasTable->update(mEmissiveLightWeights, mPendingEmissiveLightRanges);
+            mPendingEmissiveLightRanges.clear();
+        }
+
+        if (!is_set(mpScene->getUpdates(), Scene::UpdateFlags::LightCollectionChanged)) return;
 
-        for (size_t i = 0; i < weights.size(); ++i)
+        // Only the triangles of the mesh lights that changed in the last update need new weights.
+        auto ranges = EmissiveLightWeights::getTriangleRanges(lightCollection->getMeshLights(), lightCollection->getUpdatedLights());
+        if (ranges.empty()) return;
+
+        FALCOR_PROFILE(pRenderContext, "computeEmissiveLightWeights");
+        FALCOR_ASSERT(mpComputeEmissiveLightWeights);
+
+        // Compute the weights of all triangles on the GPU and schedule the readback.
+        // Reading the triangles through the light collection would sync its CPU data and stall every frame.
+        const uint32_t triangleCount = lightCollection->getTotalLightCount();
+        if (!mpEmissiveLightWeights || mpEmissiveLightWeights->getElementCount() != triangleCount)
         {
-            weights[i] = luminance(triangles[i].averageRadiance) * triangles[i].area;
+            mpEmissiveLightWeights = mpDevice->createStructuredBuffer(sizeof(float), triangleCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal, nullptr, false);
+            mpEmissiveLightWeights->setName("ReSTIRGDI::mpEmissiveLightWeights");
+            mpEmissiveLightWeightsReadback = mpDevice->createBuffer(mpEmissiveLightWeights->getSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+            mpEmissiveLightWeightsReadback->setName("ReSTIRGDI::mpEmissiveLightWeightsReadback");
         }
+        if (!mpEmissiveLightWeightsFence) mpEmissiveLightWeightsFence = mpDevice->createFence();
 
-        return std::make_unique<AliasTable>(mpDevice, std::move(weights), rng);
+        mpScene->bindShaderData(mpComputeEmissiveLightWeights->getRootVar()["gScene"]);
+
+        auto var = mpComputeEmissiveLightWeights->getRootVar()["CB"]["gComputeEmissiveLightWeights"];
+        var["weights"] = mpEmissiveLightWeights;
+        var["emissiveTriangleCount"] = triangleCount;
+
+        mpComputeEmissiveLightWeights->execute(pRenderContext, uint3(triangleCount, 1, 1));
+
+        pRenderContext->copyBufferRegion(mpEmissiveLightWeightsReadback.get(), 0, mpEmissiveLightWeights.get(), 0, mpEmissiveLightWeights->getSize());
+        pRenderContext->submit(false);
+        mEmissiveLightWeightsFenceValue = pRenderContext->signal(mpEmissiveLightWeightsFence.get());
+
+        mPendingEmissiveLightRanges = std::move(ranges);
     }
 
-    std::unique_ptr<AliasTable> ReSTIRGDI::buildAnalyticLightAliasTable(RenderContext* pRenderContext, const std::vector<ref<Light>>& lights, std::mt19937& rng)
+    std::vector<float> ReSTIRGDI::computeAnalyticLightWeights() const
     {
-        std::vector<float> weights(lights.size());
+        // The table is indexed by scene light ID, inactive lights get zero weight.
+        std::vector<float> weights(mpScene->getLightCount(), 0.f);
+        const float sceneRadius = mpScene->getSceneBounds().valid() ? mpScene->getSceneBounds().radius() : 1.f;
 
-        for (size_t i = 0; i < weights.size(); ++i)
+        for (uint32_t i = 0; i < mpScene->getLightCount(); ++i)
         {
-            // TODO: Use weight based on light power.
-            weights[i] = 1.f;
+            const auto& light = mpScene->getLight(i);
+            if (!light->isActive()) continue;
+
+            switch (light->getType())
+            {
+            case LightType::Point:
+            case LightType::Directional:
+            case LightType::Distant:
+                weights[i] = estimateLightPower(*light, sceneRadius);
+                break;
+            default:
+                // Analytic area lights are not supported by the light sampling in Lights.slang.
+                break;
+            }
         }
 
-        return std::make_unique<AliasTable>(mpDevice, std::move(weights), rng);
+        return weights;
     }
 
     ref<Texture> ReSTIRGDI::createNeighborOffsetTexture(uint32_t sampleCount)
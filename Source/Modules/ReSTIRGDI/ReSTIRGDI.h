@@ -242,6 +242,14 @@ namespace Falcor
 
         void setOwnerDefines(DefineList defines);
         void updatePrograms();
+
+        /** Collect the program permutations used by updateReSTIRDI().
+            This prepares the light sampling data the program defines depend on and creates the programs
+            without compiling them, see RenderPass::collectProgramPermutations().
+            \param[in] pRenderContext Render context.
+            \param[out] permutations List of permutations to append to.
+        */
+        void collectProgramPermutations(RenderContext* pRenderContext, std::vector<ProgramPermutation>& permutations);
         void setRecompile(bool recompile) { mRecompile = recompile; }
 
 
@@ -262,6 +270,7 @@ namespace Falcor
 
         // ReSTIR DI passes.
         ref<ComputePass> mpUpdateEmissiveTriangles;   ///< Pass for updating the local emissive triangle data.
+        ref<ComputePass> mpComputeEmissiveLightWeights; ///< Pass for computing the emissive light weights when mesh lights move.
         ref<ComputePass> mpGenerateLightTiles;        ///< Pass for generating the light tiles.
         ref<ComputePass> mpInitialResampling;         ///< Pass for initial resampling.
         ref<ComputePass> mpTemporalResampling;        ///< Pass for temporal resampling.
@@ -276,6 +285,14 @@ namespace Falcor
         std::unique_ptr<AliasTable> mpEnvLightAliasTable;         ///< Alias table for sampling the env map.
         std::unique_ptr<AliasTable> mpEmissiveLightAliasTable;    ///< Alias table for sampling emissive lights.
         std::unique_ptr<AliasTable> mpAnalyticLightAliasTable;    ///< Alias table for sampling analytic lights.
+        std::vector<float> mAnalyticLightWeights;                 ///< Weights of the analytic light alias table, indexed by scene light ID.
+        ref<LightCollection> mpEmissiveLightCollection;           ///< Light collection the emissive light alias table was built for.
+        std::vector<float> mEmissiveLightWeights;                 ///< Weights of the emissive light alias table, indexed by emissive triangle.
+        ref<Buffer> mpEmissiveLightWeights;                       ///< Emissive light weights computed on the GPU when mesh lights move.
+        ref<Buffer> mpEmissiveLightWeightsReadback;               ///< Readback buffer for the emissive light weights.
+        ref<Fence> mpEmissiveLightWeightsFence;                   ///< Fence signaled when the emissive light weights have been read back.
+        uint64_t mEmissiveLightWeightsFenceValue = 0;             ///< Fence value of the pending readback.
+        std::vector<AliasTable::Range> mPendingEmissiveLightRanges; ///< Triangle ranges of the pending readback, applied to the alias table in the next frame.
 
         ref<Buffer> mpSurfaceData;                    ///< Buffer with the current frame surface data (GBuffer).
         ref<Buffer> mpPrevSurfaceData;                ///< Buffer with the previous frame surface data (GBuffer).
@@ -336,6 +353,7 @@ namespace Falcor
         // Functions
         void prepareResources(RenderContext* pRenderContext);
         void prepareLighting(RenderContext* pRenderContext);
+        void createPrograms();
         void updateEmissiveTriangles(RenderContext* pRenderContext);
         void generateLightTiles(RenderContext* pRenderContext);
 
@@ -354,7 +372,8 @@ namespace Falcor
         std::vector<float> computeEnvLightLuminance(RenderContext* pRenderContext, const ref<Texture>& texture, std::vector<float3>& radiances);
         std::unique_ptr<AliasTable> buildEnvLightAliasTable(uint32_t width, uint32_t height, const std::vector<float>& luminances, std::mt19937& rng);
         std::unique_ptr<AliasTable> buildEmissiveLightAliasTable(RenderContext* pRenderContext, const ref<LightCollection>& lightCollection, std::mt19937& rng);
-        std::unique_ptr<AliasTable> buildAnalyticLightAliasTable(RenderContext* pRenderContext, const std::vector<ref<Light>>& lights, std::mt19937& rng);
+        void updateEmissiveLightAliasTable(RenderContext* pRenderContext, const ref<LightCollection>& lightCollection);
+        std::vector<float> computeAnalyticLightWeights() const;
 
         /** Create a 1D texture with random offsets within a unit circle around (0,0).
             The texture is RG8Snorm for compactness and has no mip maps.
@@ -0,0 +1,443 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # NVIDIA CORPORATION and its licensors retain all intellectual property
+ # and proprietary rights in and to this software, related documentation
+ # and any modifications thereto.  Any use, reproduction, disclosure or
+ # distribution of this software and related documentation without an express
+ # license agreement from NVIDIA CORPORATION is strictly prohibited.
+ **************************************************************************/
+#include "ResamplingReference.h"
+#include "Core/Error.h"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Must match ReSTIRGDI.cpp.
+        const uint32_t kNeighborOffsetCount = 8192;
+
+        // Offset between the sample numbers of consecutive frames. Each pass uses its own sample number.
+        const uint32_t kPassesPerFrame = 64;
+
+        /** Generate neighbor offsets in the unit disk (same sequence as ReSTIRGDI::createNeighborOffsetTexture).
+        */
+        std::vector<float2> createNeighborOffsets(uint32_t sampleCount)
+        {
+            std::vector<float2> offsets;
+            offsets.reserve(sampleCount);
+            const int R = 254;
+            const float phi2 = 1.f / 1.3247179572447f;
+            float u = 0.5f;
+            float v = 0.5f;
+            while (offsets.size() < sampleCount)
+            {
+                u += phi2;
+                v += phi2 * phi2;
+                if (u >= 1.f) u -= 1.f;
+                if (v >= 1.f) v -= 1.f;
+
+                float rSq = (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f);
+                if (rSq > 0.25f) continue;
+
+                // Quantize like the RG8Snorm texture.
+                offsets.push_back(float2(int8_t((u - 0.5f) * R), int8_t((v - 0.5f) * R)) / 127.f);
+            }
+            return offsets;
+        }
+
+        uint32_t interleave_32bit(uint2 v)
+        {
+            uint32_t x = v.x & 0x0000ffff;
+            x = (x | (x << 8)) & 0x00FF00FF;
+            x = (x | (x << 4)) & 0x0F0F0F0F;
+            x = (x | (x << 2)) & 0x33333333;
+            x = (x | (x << 1)) & 0x55555555;
+
+            uint32_t y = v.y & 0x0000ffff;
+            y = (y | (y << 8)) & 0x00FF00FF;
+            y = (y | (y << 4)) & 0x0F0F0F0F;
+            y = (y | (y << 2)) & 0x33333333;
+            y = (y | (y << 1)) & 0x55555555;
+
+            return x | (y << 1);
+        }
+
+        uint32_t blockCipherTEA(uint32_t v0, uint32_t v1, uint32_t iterations = 16)
+        {
+            uint32_t sum = 0;
+            const uint32_t delta = 0x9e3779b9;
+            const uint32_t k[4] = { 0xa341316c, 0xc8013ea4, 0xad90777d, 0x7e95761e };
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                sum += delta;
+                v0 += ((v1 << 4) + k[0]) ^ (v1 + sum) ^ ((v1 >> 5) + k[1]);
+                v1 += ((v0 << 4) + k[2]) ^ (v0 + sum) ^ ((v0 >> 5) + k[3]);
+            }
+            return v0;
+        }
+    }
+
+    ResamplingReference::Reservoir ResamplingReference::RisState::toReservoir() const
+    {
+        Reservoir reservoir;
+        reservoir.lightIndex = lightIndex;
+        reservoir.weight = weight;
+        reservoir.M = uint32_t(M);
+        reservoir.targetPdf = targetPdf;
+        if (std::isinf(reservoir.weight) || std::isnan(reservoir.weight)) reservoir = Reservoir();
+        return reservoir;
+    }
+
+    ResamplingReference::SampleGenerator::SampleGenerator(uint2 pixel, uint32_t sampleNumber)
+        : mState(blockCipherTEA(interleave_32bit(pixel), sampleNumber))
+    {}
+
+    float ResamplingReference::SampleGenerator::next1D()
+    {
+        mState = 1664525u * mState + 1013904223u;
+        return float(mState >> 8) * 0x1p-24f;
+    }
+
+    template<typename F>
+    void ResamplingReference::forEachPixel(F func) const
+    {
+        auto rows = NumericRange<uint32_t>(0, mFrameDim.y);
+        std::for_each(std::execution::par, rows.begin(), rows.end(), [&](uint32_t y)
+        {
+            for (uint32_t x = 0; x < mFrameDim.x; ++x) func(uint2(x, y));
+        });
+    }
+
+    ResamplingReference::ResamplingReference(uint2 frameDim, std::vector<Surface> surfaces, std::vector<PointLight> lights, const Options& options)
+        : mFrameDim(frameDim)
+        , mSurfaces(std::move(surfaces))
+        , mLights(std::move(lights))
+        , mOptions(options)
+        , mNeighborOffsets(createNeighborOffsets(kNeighborOffsetCount))
+    {
+        FALCOR_CHECK(mSurfaces.size() == size_t(mFrameDim.x) * mFrameDim.y, "Number of surfaces does not match frame dimensions.");
+        FALCOR_CHECK(!mLights.empty(), "At least one light is required.");
+        FALCOR_CHECK(mOptions.initialLightSampleCount > 0, "At least one initial light sample is required.");
+        FALCOR_CHECK(mOptions.spatialNeighborCount <= 32, "Spatial neighbor count must be at most 32.");
+
+        // Sample lights proportional to their intensity.
+        double intensitySum = 0.0;
+        for (const auto& light : mLights) intensitySum += light.intensity;
+        FALCOR_CHECK(intensitySum > 0.0, "Lights must have positive total intensity.");
+
+        mLightCdf.resize(mLights.size());
+        double cdf = 0.0;
+        for (size_t i = 0; i < mLights.size(); ++i)
+        {
+            cdf += mLights[i].intensity;
+            mLightCdf[i] = float(cdf / intensitySum);
+        }
+        mLightCdf.back() = 1.f;
+
+        reset();
+    }
+
+    void ResamplingReference::reset()
+    {
+        const size_t pixelCount = mSurfaces.size();
+        mReservoirs.assign(pixelCount, Reservoir());
+        mPrevReservoirs.assign(pixelCount, Reservoir());
+        mScratchReservoirs.assign(pixelCount, Reservoir());
+        mHasHistory = false;
+    }
+
+    void ResamplingReference::execute(uint32_t frameIndex)
+    {
+        forEachPixel([&](uint2 pixel) { mReservoirs[getPixelIndex(pixel)] = initialResampling(pixel, frameIndex); });
+
+        // Temporal resampling needs a previous frame. On the GPU the history is always valid as reservoirs have M >= 1.
+        if (mOptions.useTemporalResampling && mHasHistory)
+        {
+            forEachPixel([&](uint2 pixel) { mScratchReservoirs[getPixelIndex(pixel)] = temporalResampling(pixel, frameIndex); });
+            std::swap(mReservoirs, mScratchReservoirs);
+        }
+
+        if (mOptions.useSpatialResampling)
+        {
+            for (uint32_t spatialPassIdx = 0; spatialPassIdx < mOptions.spatialIterations; ++spatialPassIdx)
+            {
+                forEachPixel([&](uint2 pixel) { mScratchReservoirs[getPixelIndex(pixel)] = spatialResampling(pixel, frameIndex, spatialPassIdx, mReservoirs); });
+                std::swap(mReservoirs, mScratchReservoirs);
+            }
+        }
+
+        mPrevReservoirs = mReservoirs;
+        mHasHistory = true;
+    }
+
+    std::vector<float> ResamplingReference::evalEstimate() const
+    {
+        std::vector<float> estimate(mSurfaces.size(), 0.f);
+        forEachPixel([&](uint2 pixel)
+        {
+            const uint32_t pixelIndex = getPixelIndex(pixel);
+            const Reservoir& reservoir = mReservoirs[pixelIndex];
+            if (reservoir.isValid()) estimate[pixelIndex] = evalTargetFunction(mSurfaces[pixelIndex], reservoir.lightIndex) * reservoir.weight;
+        });
+        return estimate;
+    }
+
+    std::vector<float> ResamplingReference::evalReference() const
+    {
+        std::vector<float> reference(mSurfaces.size(), 0.f);
+        forEachPixel([&](uint2 pixel)
+        {
+            const uint32_t pixelIndex = getPixelIndex(pixel);
+            double sum = 0.0;
+            for (uint32_t lightIndex = 0; lightIndex < mLights.size(); ++lightIndex) sum += evalTargetFunction(mSurfaces[pixelIndex], lightIndex);
+            reference[pixelIndex] = float(sum);
+        });
+        return reference;
+    }
+
+    float ResamplingReference::evalTargetFunction(const Surface& surface, uint32_t lightIndex) const
+    {
+        if (!surface.valid || lightIndex == kInvalidLight) return 0.f;
+
+        const PointLight& light = mLights[lightIndex];
+        float3 toLight = light.pos - surface.pos;
+        float distSqr = dot(toLight, toLight);
+        if (distSqr <= 0.f) return 0.f;
+        float cosTheta = dot(surface.normal, toLight) / std::sqrt(distSqr);
+        return cosTheta > 0.f ? surface.albedo * float(M_1_PI) * light.intensity * cosTheta / distSqr : 0.f;
+    }
+
+    float ResamplingReference::getLightPdf(uint32_t lightIndex) const
+    {
+        return lightIndex == 0 ? mLightCdf[0] : mLightCdf[lightIndex] - mLightCdf[lightIndex - 1];
+    }
+
+    bool ResamplingReference::streamingInitialResampleMIS(RisState& state, uint32_t lightIndex, float targetPdf, float sourcePdf, float misWeight, SampleGenerator& sg)
+    {
+        float sampleWeight = misWeight * targetPdf / sourcePdf;
+
+        state.weightSum += sampleWeight;
+        state.M += 1.f;
+
+        bool selectSample = sg.next1D() * state.weightSum < sampleWeight;
+
+        if (selectSample)
+        {
+            state.lightIndex = lightIndex;
+            state.targetPdf = targetPdf;
+        }
+
+        return selectSample;
+    }
+
+    float ResamplingReference::mFactor(float q0, float q1)
+    {
+        return q0 == 0.f ? 1.f : std::clamp(std::pow(std::min(q1 / q0, 1.f), 8.f), 0.f, 1.f);
+    }
+
+    float ResamplingReference::pairwiseMISNonDefensiveNonCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc)
+    {
+        return pc == 0.f ? 0.f : mCandidate * pi / ((mSum - mCanonical) * pi + mCanonical * pc);
+    }
+
+    float ResamplingReference::pairwiseMISNonDefensiveCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc)
+    {
+        float w = mCanonical * pc;
+        return pc == 0.f ? 0.f : (mCandidate / (mSum - mCanonical)) * w / ((mSum - mCanonical) * pi + w);
+    }
+
+    float ResamplingReference::pairwiseMISDefensiveNonCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc)
+    {
+        float w = (mSum - mCanonical) * pi;
+        return pc == 0.f ? 0.f : (mCandidate / mSum) * w / (w + mCanonical * pc);
+    }
+
+    float ResamplingReference::pairwiseMISDefensiveCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc)
+    {
+        float w = mCanonical * pc;
+        return pc == 0.f ? 0.f : (mCandidate / mSum) * w / ((mSum - mCanonical) * pi + w);
+    }
+
+    bool ResamplingReference::resamplePairwiseMIS(RisState& state, const Reservoir& canonical, float canonicalTargetPdfAtOther, const Reservoir& candidate,
+        float candidateTargetPdfAtOther, PairwiseMIS mis, bool useMFactor, float confidenceWeightSum, SampleGenerator& sg)
+    {
+        float canonicalTargetPdf = canonical.targetPdf;
+        float candidateTargetPdf = candidate.targetPdf;
+
+        // Compute MIS weights
+        float candidateConfidenceWeight = float(candidate.M);
+        float m0, m1;
+        if (mis == PairwiseMIS::NonDefensive)
+        {
+            m0 = pairwiseMISNonDefensiveNonCanonical(confidenceWeightSum, candidateConfidenceWeight, candidateTargetPdf, float(canonical.M), candidateTargetPdfAtOther);
+            m1 = pairwiseMISNonDefensiveCanonical(confidenceWeightSum, candidateConfidenceWeight, canonicalTargetPdfAtOther, float(canonical.M), canonicalTargetPdf);
+        }
+        else
+        {
+            m0 = pairwiseMISDefensiveNonCanonical(confidenceWeightSum, candidateConfidenceWeight, candidateTargetPdf, float(canonical.M), candidateTargetPdfAtOther);
+            m1 = pairwiseMISDefensiveCanonical(confidenceWeightSum, candidateConfidenceWeight, canonicalTargetPdfAtOther, float(canonical.M), canonicalTargetPdf);
+        }
+
+        // Candidate resampling weight
+        float sampleWeight = candidateTargetPdfAtOther * candidate.weight * m0;
+        float mScaler = std::min(mFactor(candidateTargetPdf, candidateTargetPdfAtOther), mFactor(canonicalTargetPdfAtOther, canonicalTargetPdf));
+        state.M += candidateConfidenceWeight * (useMFactor ? mScaler : 1.f);
+        state.weightSum += sampleWeight;
+        state.canonicalWeight += m1; // MIS weight for canonical reservoir
+
+        bool selectSample = sg.next1D() * state.weightSum < sampleWeight;
+
+        if (selectSample)
+        {
+            state.lightIndex = candidate.lightIndex;
+            state.targetPdf = candidateTargetPdfAtOther;
+        }
+
+        return selectSample;
+    }
+
+    bool ResamplingReference::streamingResampleFinalizeMIS(RisState& state, const Reservoir& canonical, float canonicalTargetPdf, SampleGenerator& sg)
+    {
+        float sampleWeight = state.canonicalWeight * canonicalTargetPdf * canonical.weight;
+
+        state.M += float(canonical.M);
+        state.weightSum += sampleWeight;
+
+        bool selectSample = sg.next1D() * state.weightSum < sampleWeight;
+        if (selectSample)
+        {
+            state.targetPdf = canonicalTargetPdf;
+            state.lightIndex = canonical.lightIndex;
+        }
+
+        return selectSample;
+    }
+
+    uint32_t ResamplingReference::sampleLight(float u) const
+    {
+        auto it = std::upper_bound(mLightCdf.begin(), mLightCdf.end(), u);
+        return uint32_t(std::min<size_t>(std::distance(mLightCdf.begin(), it), mLightCdf.size() - 1));
+    }
+
+    ResamplingReference::Reservoir ResamplingReference::initialResampling(uint2 pixel, uint32_t frameIndex) const
+    {
+        const Surface& surface = mSurfaces[getPixelIndex(pixel)];
+        SampleGenerator sg(pixel, frameIndex * kPassesPerFrame);
+
+        // Background pixels get an empty reservoir with M = 1 (as on the GPU) so they stay valid for reuse.
+        if (!surface.valid)
+        {
+            Reservoir reservoir;
+            reservoir.M = 1;
+            return reservoir;
+        }
+
+        // Resample light samples. Without BRDF samples the balance heuristic reduces to 1 / N.
+        RisState risState;
+        const uint32_t sampleCount = mOptions.initialLightSampleCount;
+        for (uint32_t i = 0; i < sampleCount; ++i)
+        {
+            uint32_t lightIndex = sampleLight(sg.next1D());
+            float p = getLightPdf(lightIndex);
+            float misWeight = 1.f / sampleCount;
+            float pHat = evalTargetFunction(surface, lightIndex);
+            streamingInitialResampleMIS(risState, lightIndex, pHat, p, misWeight, sg);
+        }
+
+        risState.weight = risState.targetPdf > 0.f ? risState.weightSum / risState.targetPdf : 0.f;
+        risState.M = 1.f;
+
+        return risState.toReservoir();
+    }
+
+    ResamplingReference::Reservoir ResamplingReference::temporalResampling(uint2 pixel, uint32_t frameIndex) const
+    {
+        const uint32_t pixelIndex = getPixelIndex(pixel);
+        const Surface& surface = mSurfaces[pixelIndex];
+        SampleGenerator sg(pixel, frameIndex * kPassesPerFrame + 1);
+
+        // The camera is static, so the pixel reprojects onto itself.
+        const Reservoir& currentReservoir = mReservoirs[pixelIndex];
+        Reservoir prevReservoir = mPrevReservoirs[pixelIndex];
+        prevReservoir.M = std::min(prevReservoir.M, currentReservoir.M * mOptions.maxHistoryLength);
+
+        RisState risState;
+        float confidenceWeightSum = float(prevReservoir.M + currentReservoir.M);
+        if (mOptions.temporalMIS == PairwiseMIS::Defensive) risState.canonicalWeight = float(currentReservoir.M) / confidenceWeightSum;
+
+        // First resample empty risState with the previous sample, then resample the current sample.
+        float candidateTargetPdfAtOther = evalTargetFunction(surface, prevReservoir.lightIndex);
+        float canonicalTargetPdfAtOther = evalTargetFunction(surface, currentReservoir.lightIndex);
+        resamplePairwiseMIS(risState, currentReservoir, canonicalTargetPdfAtOther, prevReservoir, candidateTargetPdfAtOther,
+            mOptions.temporalMIS, mOptions.useMFactor, confidenceWeightSum, sg);
+        streamingResampleFinalizeMIS(risState, currentReservoir, currentReservoir.targetPdf, sg);
+        risState.weight = risState.targetPdf > 0.f ? risState.weightSum / risState.targetPdf : 0.f;
+
+        return risState.toReservoir();
+    }
+
+    ResamplingReference::Reservoir ResamplingReference::spatialResampling(uint2 pixel, uint32_t frameIndex, uint32_t spatialPassIdx, const std::vector<Reservoir>& reservoirs) const
+    {
+        const uint32_t pixelIndex = getPixelIndex(pixel);
+        const Surface& surface = mSurfaces[pixelIndex];
+        SampleGenerator sg(pixel, frameIndex * kPassesPerFrame + 2 + spatialPassIdx);
+
+        const Reservoir& currentReservoir = reservoirs[pixelIndex];
+        const uint32_t startIndex = uint32_t(sg.next1D() * kNeighborOffsetCount);
+
+        auto getNeighborPixel = [&](uint32_t i, uint2& neighborPixel)
+        {
+            float2 offset = mNeighborOffsets[(startIndex + i) & (kNeighborOffsetCount - 1)] * mOptions.spatialGatherRadius;
+            int2 p = int2(pixel) + int2(offset);
+            if (any(p < int2(0)) || any(p >= int2(mFrameDim))) return false;
+            neighborPixel = uint2(p);
+            return true;
+        };
+
+        // Compute confidence weight sum
+        float confidenceWeightSum = float(currentReservoir.M);
+        uint32_t validNeighborMask = 0;
+        for (uint32_t i = 0; i < mOptions.spatialNeighborCount; ++i)
+        {
+            uint2 neighborPixel;
+            if (!getNeighborPixel(i, neighborPixel)) continue;
+            const uint32_t neighborPixelIndex = getPixelIndex(neighborPixel);
+            if (mOptions.rejectNeighborPixelForNormal && dot(surface.normal, mSurfaces[neighborPixelIndex].normal) < mOptions.normalThreshold) continue;
+
+            confidenceWeightSum += float(reservoirs[neighborPixelIndex].M);
+            validNeighborMask |= 1u << i;
+        }
+
+        RisState risState;
+        if (mOptions.spatialMIS == PairwiseMIS::Defensive)
+            risState.canonicalWeight = confidenceWeightSum > 0.f ? float(currentReservoir.M) / confidenceWeightSum : 0.f;
+
+        // Start resampling
+        for (uint32_t i = 0; i < mOptions.spatialNeighborCount; ++i)
+        {
+            if (!(validNeighborMask & (1u << i))) continue;
+
+            uint2 neighborPixel;
+            getNeighborPixel(i, neighborPixel);
+            const uint32_t neighborPixelIndex = getPixelIndex(neighborPixel);
+            const Reservoir& neighborReservoir = reservoirs[neighborPixelIndex];
+
+            float candidateTargetPdfAtOther = evalTargetFunction(surface, neighborReservoir.lightIndex);
+            float canonicalTargetPdfAtOther = evalTargetFunction(mSurfaces[neighborPixelIndex], currentReservoir.lightIndex);
+            resamplePairwiseMIS(risState, currentReservoir, canonicalTargetPdfAtOther, neighborReservoir, candidateTargetPdfAtOther,
+                mOptions.spatialMIS, mOptions.useMFactor, confidenceWeightSum, sg);
+        }
+
+        streamingResampleFinalizeMIS(risState, currentReservoir, currentReservoir.targetPdf, sg);
+        risState.M = float(currentReservoir.M);
+        risState.weight = risState.targetPdf > 0.f ? risState.weightSum / risState.targetPdf : 0.f;
+
+        return risState.toReservoir();
+    }
+}
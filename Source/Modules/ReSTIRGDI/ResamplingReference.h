@@ -0,0 +1,214 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # NVIDIA CORPORATION and its licensors retain all intellectual property
+ # and proprietary rights in and to this software, related documentation
+ # and any modifications thereto.  Any use, reproduction, disclosure or
+ # distribution of this software and related documentation without an express
+ # license agreement from NVIDIA CORPORATION is strictly prohibited.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** CPU reference implementation of the ReSTIR DI resampling pipeline.
+
+        This mirrors the reservoir logic in Reservoir.slang and Resampling.slang, and the initial,
+        temporal and spatial resampling passes, on a synthetic scene: a G-buffer of diffuse surfaces
+        lit by point lights. The target function is the unshadowed shading, which makes the exact
+        solution known and allows measuring bias and variance of the resampling on the CPU.
+
+        Differences to the GPU passes:
+        - Initial light samples are drawn directly from the light distribution instead of light tiles.
+        - There are no BRDF samples, no visibility and no path samples.
+        - The camera is static, temporal resampling reuses the reservoir of the same pixel.
+        - Random numbers are generated like TinyUniformSampleGenerator, but the sequences do not
+          match the GPU. Results only agree statistically.
+
+        Pixels are processed in parallel.
+    */
+    class ResamplingReference
+    {
+    public:
+        static constexpr uint32_t kInvalidLight = 0xffffffff;
+
+        /** Surface in the synthetic G-buffer.
+        */
+        struct Surface
+        {
+            float3 pos = float3(0.f);
+            float3 normal = float3(0.f, 0.f, 1.f);
+            float albedo = 0.f;             ///< Diffuse albedo.
+            bool valid = false;             ///< False for background pixels.
+        };
+
+        /** Isotropic point light.
+        */
+        struct PointLight
+        {
+            float3 pos = float3(0.f);
+            float intensity = 0.f;
+        };
+
+        /** Reservoir (mirrors Reservoir.slang).
+        */
+        struct Reservoir
+        {
+            uint32_t lightIndex = kInvalidLight;    ///< Selected light.
+            uint32_t M = 0;                         ///< Number of samples seen so far.
+            float weight = 0.f;                     ///< Unbiased contribution weight.
+            float targetPdf = 0.f;                  ///< Target pdf of the selected light.
+
+            bool isValid() const { return lightIndex != kInvalidLight; }
+        };
+
+        /** Resampled importance sampling state (mirrors RisState in Resampling.slang).
+        */
+        struct RisState
+        {
+            uint32_t lightIndex = kInvalidLight;
+            float weightSum = 0.f;
+            float M = 0.f;
+            float weight = 0.f;
+            float targetPdf = 0.f;
+            float canonicalWeight = 0.f;
+
+            /** Create a reservoir from the current RIS state.
+                An empty reservoir is returned if the weight is infinite or NaN.
+            */
+            Reservoir toReservoir() const;
+        };
+
+        /** Pairwise MIS variants.
+        */
+        enum class PairwiseMIS
+        {
+            NonDefensive,   ///< Used by temporal resampling.
+            Defensive,      ///< Used by spatial resampling.
+        };
+
+        /** Random number generator (mirrors TinyUniformSampleGenerator).
+        */
+        class SampleGenerator
+        {
+        public:
+            SampleGenerator(uint2 pixel, uint32_t sampleNumber);
+            float next1D();
+
+        private:
+            uint32_t mState;
+        };
+
+        struct Options
+        {
+            uint32_t initialLightSampleCount = 32;      ///< Number of initial light samples to resample per pixel.
+            bool useTemporalResampling = true;          ///< Enable temporal resampling.
+            uint32_t maxHistoryLength = 20;             ///< Maximum temporal history length.
+            bool useSpatialResampling = true;           ///< Enable spatial resampling.
+            uint32_t spatialIterations = 1;             ///< Number of spatial resampling iterations.
+            uint32_t spatialNeighborCount = 4;          ///< Number of neighbor samples to resample per pixel and iteration.
+            float spatialGatherRadius = 30.f;           ///< Radius to gather samples from.
+            bool rejectNeighborPixelForNormal = false;  ///< Reject neighbors with a normal cosine below the threshold.
+            float normalThreshold = 0.5f;               ///< Normal cosine threshold for reusing spatial neighbor samples.
+            bool useMFactor = false;                    ///< Scale confidence weights by the M-factor.
+            PairwiseMIS temporalMIS = PairwiseMIS::NonDefensive;
+            PairwiseMIS spatialMIS = PairwiseMIS::Defensive;
+        };
+
+        /** Constructor.
+            \param[in] frameDim Frame dimensions.
+            \param[in] surfaces Surfaces, one per pixel in scanline order.
+            \param[in] lights Point lights. Lights are sampled proportional to their intensity.
+            \param[in] options Options.
+        */
+        ResamplingReference(uint2 frameDim, std::vector<Surface> surfaces, std::vector<PointLight> lights, const Options& options);
+
+        /** Run initial, temporal and spatial resampling for a frame.
+            The reservoirs of the previous frame are used for temporal resampling.
+            \param[in] frameIndex Frame index used to seed the random number generators.
+        */
+        void execute(uint32_t frameIndex);
+
+        /** Clear the temporal history.
+        */
+        void reset();
+
+        /** Get the final reservoirs of the last executed frame.
+        */
+        const std::vector<Reservoir>& getReservoirs() const { return mReservoirs; }
+
+        /** Evaluate the shading estimate per pixel from the final reservoirs.
+        */
+        std::vector<float> evalEstimate() const;
+
+        /** Evaluate the exact shading per pixel.
+        */
+        std::vector<float> evalReference() const;
+
+        /** Evaluate the target function (unshadowed shading) of a light at a surface.
+        */
+        float evalTargetFunction(const Surface& surface, uint32_t lightIndex) const;
+
+        /** Get the probability of sampling a light.
+        */
+        float getLightPdf(uint32_t lightIndex) const;
+
+        uint2 getFrameDim() const { return mFrameDim; }
+        const Options& getOptions() const { return mOptions; }
+
+        // Resampling functions (mirror Resampling.slang).
+
+        static bool streamingInitialResampleMIS(RisState& state, uint32_t lightIndex, float targetPdf, float sourcePdf, float misWeight, SampleGenerator& sg);
+        static float mFactor(float q0, float q1);
+        static float pairwiseMISNonDefensiveNonCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc);
+        static float pairwiseMISNonDefensiveCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc);
+        static float pairwiseMISDefensiveNonCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc);
+        static float pairwiseMISDefensiveCanonical(float mSum, float mCandidate, float pi, float mCanonical, float pc);
+
+        /** Resample a candidate reservoir using pairwise MIS.
+            \param[in,out] state RIS state.
+            \param[in] canonical Canonical reservoir.
+            \param[in] canonicalTargetPdfAtOther Target pdf of the canonical sample at the candidate's surface.
+            \param[in] candidate Candidate reservoir.
+            \param[in] candidateTargetPdfAtOther Target pdf of the candidate sample at the canonical surface.
+            \param[in] mis Pairwise MIS variant.
+            \param[in] useMFactor Scale the confidence weight by the M-factor.
+            \param[in] confidenceWeightSum Sum of confidence weights of all reservoirs taking part.
+            \param[in,out] sg Sample generator.
+            \return Returns true if the candidate sample was selected.
+        */
+        static bool resamplePairwiseMIS(RisState& state, const Reservoir& canonical, float canonicalTargetPdfAtOther, const Reservoir& candidate,
+            float candidateTargetPdfAtOther, PairwiseMIS mis, bool useMFactor, float confidenceWeightSum, SampleGenerator& sg);
+
+        /** Resample the canonical reservoir after all candidates have been resampled using pairwise MIS.
+        */
+        static bool streamingResampleFinalizeMIS(RisState& state, const Reservoir& canonical, float canonicalTargetPdf, SampleGenerator& sg);
+
+    private:
+        uint32_t getPixelIndex(uint2 pixel) const { return pixel.y * mFrameDim.x + pixel.x; }
+        uint32_t sampleLight(float u) const;
+
+        template<typename F>
+        void forEachPixel(F func) const;
+
+        Reservoir initialResampling(uint2 pixel, uint32_t frameIndex) const;
+        Reservoir temporalResampling(uint2 pixel, uint32_t frameIndex) const;
+        Reservoir spatialResampling(uint2 pixel, uint32_t frameIndex, uint32_t spatialPassIdx, const std::vector<Reservoir>& reservoirs) const;
+
+        uint2 mFrameDim;
+        std::vector<Surface> mSurfaces;
+        std::vector<PointLight> mLights;
+        Options mOptions;
+
+        std::vector<float> mLightCdf;                   ///< Cumulative light sampling probabilities.
+        std::vector<float2> mNeighborOffsets;           ///< Neighbor offsets in the unit disk.
+
+        std::vector<Reservoir> mReservoirs;             ///< Final reservoirs of the current frame.
+        std::vector<Reservoir> mPrevReservoirs;         ///< Final reservoirs of the previous frame.
+        std::vector<Reservoir> mScratchReservoirs;
+        bool mHasHistory = false;
+    };
+}
@@ -0,0 +1,407 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BatchRenderer.h"
+#include "Mogwai.h"
+#include "Extensions/Capture/FrameCapture.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <BS_thread_pool.hpp>
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <thread>
+
+namespace Mogwai
+{
+    namespace
+    {
+        // Manifest lines are "<frame> done". The suffix makes a line that was cut off by a crash detectable.
+        const std::string kManifestHeader = "# Mogwai batch manifest";
+        const std::string kManifestSuffix = " done";
+
+        // Interval between progress messages in seconds.
+        const double kProgressInterval = 10.0;
+
+        double getElapsedSeconds(CpuTimer::TimePoint start)
+        {
+            return CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) * 1e-3;
+        }
+
+        template<typename T>
+        bool parseInteger(std::string_view str, T& value)
+        {
+            auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+            return ec == std::errc() && ptr == str.data() + str.size();
+        }
+    }
+
+    std::pair<uint64_t, uint64_t> BatchRenderer::getShardRange(uint64_t startFrame, uint64_t endFrame, uint32_t shardIndex, uint32_t shardCount)
+    {
+        FALCOR_CHECK(startFrame <= endFrame, "Invalid frame range [{}, {}).", startFrame, endFrame);
+        FALCOR_CHECK(shardCount > 0 && shardIndex < shardCount, "Invalid shard {}/{}.", shardIndex, shardCount);
+
+        // Contiguous ranges keep consecutive frames in the same process, which matters for passes with temporal state.
+        const uint64_t frameCount = endFrame - startFrame;
+        const uint64_t first = startFrame + frameCount * shardIndex / shardCount;
+        const uint64_t last = startFrame + frameCount * (shardIndex + 1) / shardCount;
+        return { first, last };
+    }
+
+    std::pair<uint32_t, uint32_t> BatchRenderer::parseShard(const std::string& str)
+    {
+        auto pos = str.find('/');
+        uint32_t index = 0, count = 0;
+        if (pos == std::string::npos || !parseInteger(std::string_view(str).substr(0, pos), index) || !parseInteger(std::string_view(str).substr(pos + 1), count))
+        {
+            FALCOR_THROW("Invalid shard '{}'. Expected 'i/n'.", str);
+        }
+        FALCOR_CHECK(count > 0 && index < count, "Invalid shard '{}'. Shard index must be less than the shard count.", str);
+        return { index, count };
+    }
+
+    std::pair<uint64_t, uint64_t> BatchRenderer::parseFrameRange(const std::string& str)
+    {
+        auto pos = str.find(':');
+        uint64_t first = 0, end = 0;
+        if (pos == std::string::npos || !parseInteger(std::string_view(str).substr(0, pos), first) || !parseInteger(std::string_view(str).substr(pos + 1), end))
+        {
+            FALCOR_THROW("Invalid frame range '{}'. Expected 'first:end'.", str);
+        }
+        FALCOR_CHECK(first <= end, "Invalid frame range '{}'. First frame must not be larger than the end frame.", str);
+        return { first, end };
+    }
+
+    BatchRenderer::BatchRenderer(Renderer* pRenderer, const Options& options)
+        : mpRenderer(pRenderer)
+        , mOptions(options)
+        , mOutputDir(std::filesystem::absolute(options.outputDir))
+    {
+        FALCOR_CHECK(mOptions.shardCount > 0 && mOptions.shardIndex < mOptions.shardCount, "Invalid shard {}/{}.", mOptions.shardIndex, mOptions.shardCount);
+        FALCOR_CHECK(mOptions.startFrame <= mOptions.endFrame, "Invalid frame range [{}, {}).", mOptions.startFrame, mOptions.endFrame);
+
+        mpImageProcessing = std::make_unique<ImageProcessing>(mpRenderer->getDevice());
+
+        uint32_t threadCount = mOptions.encoderThreadCount > 0 ? mOptions.encoderThreadCount : std::max(1u, std::thread::hardware_concurrency());
+        mpEncoderPool = std::make_unique<BS::thread_pool>(threadCount);
+    }
+
+    BatchRenderer::~BatchRenderer()
+    {
+        // Make sure no encoding task outlives the renderer (only the case if run() threw).
+        for (auto& f : mEncodeQueue) f.wait();
+        mpEncoderPool.reset();
+    }
+
+    std::filesystem::path BatchRenderer::getManifestPath() const
+    {
+        return mOutputDir / fmt::format("{}.shard{}-of-{}.manifest", mOptions.baseFilename, mOptions.shardIndex, mOptions.shardCount);
+    }
+
+    BatchRenderer::Report BatchRenderer::run()
+    {
+        const auto [firstFrame, lastFrame] = getShardRange(mOptions.startFrame, mOptions.endFrame, mOptions.shardIndex, mOptions.shardCount);
+
+        mReport = {};
+        mReport.frameCount = lastFrame - firstFrame;
+
+        std::filesystem::create_directories(mOutputDir);
+        loadManifest();
+
+        // Finish pending background scene loads, the batch has to render the final scene.
+        mpRenderer->waitForSceneLoad();
+        FALCOR_CHECK(mpRenderer->getActiveGraph(), "Batch rendering requires an active render graph.");
+
+        // Frame times are derived from frame indices, this requires a fixed framerate.
+        auto& clock = mpRenderer->getGlobalClock();
+        if (clock.getFramerate() == 0)
+        {
+            logWarning("Batch rendering requires a fixed framerate, using 60 fps. Set 'm.clock.framerate' to override.");
+            clock.setFramerate(60);
+        }
+
+        logInfo("Batch rendering frames [{}, {}) of [{}, {}) (shard {}/{}) to '{}'.",
+            firstFrame, lastFrame, mOptions.startFrame, mOptions.endFrame, mOptions.shardIndex, mOptions.shardCount, mOutputDir);
+
+        RenderContext* pRenderContext = mpRenderer->getRenderContext();
+        const auto startTime = CpuTimer::getCurrentTimePoint();
+        double lastProgressTime = 0.0;
+
+        // Drain the readback and encoding queues. This records all completed frames in the manifest.
+        auto drain = [&]()
+        {
+            while (!mReadbackQueue.empty()) retireFrame();
+            waitForEncoder(0);
+        };
+
+        try
+        {
+            for (uint64_t frame = firstFrame; frame < lastFrame; ++frame)
+            {
+                if (mCompletedFrames.count(frame))
+                {
+                    mReport.skippedFrames++;
+                    continue;
+                }
+
+                renderFrame(pRenderContext, frame);
+                mReport.renderedFrames++;
+
+                while (mReadbackQueue.size() > mOptions.readbackDepth) retireFrame();
+
+                double elapsedTime = getElapsedSeconds(startTime);
+                if (elapsedTime - lastProgressTime >= kProgressInterval)
+                {
+                    lastProgressTime = elapsedTime;
+                    uint64_t doneFrames = mReport.skippedFrames + mReport.renderedFrames;
+                    logInfo("Batch rendering: {}/{} frames, {:.2f} frames/s.", doneFrames, mReport.frameCount, mReport.renderedFrames / elapsedTime);
+                }
+            }
+
+            drain();
+        }
+        catch (...)
+        {
+            // Keep the frames finished so far so that a restarted run resumes after them.
+            try
+            {
+                drain();
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to finish pending frames: {}", e.what());
+            }
+            throw;
+        }
+
+        mReport.totalTime = getElapsedSeconds(startTime);
+        {
+            std::lock_guard<std::mutex> lock(mManifestMutex);
+            mReport.encodeTime = mEncodeTime;
+            mReport.failedFrames = mFailedFrames;
+        }
+
+        logInfo("Batch rendered {} frames ({} skipped, {} failed) in {:.2f} s ({:.2f} frames/s). "
+            "Render {:.2f} s, readback {:.2f} s, encode {:.2f} s ({} threads), encoder stalls {:.2f} s.",
+            mReport.renderedFrames, mReport.skippedFrames, mReport.failedFrames, mReport.totalTime, mReport.getFramesPerSecond(),
+            mReport.renderTime, mReport.readbackTime, mReport.encodeTime, mpEncoderPool->get_thread_count(), mReport.encodeStallTime);
+        writeReport(mReport);
+
+        return mReport;
+    }
+
+    void BatchRenderer::loadManifest()
+    {
+        mCompletedFrames.clear();
+        const auto path = getManifestPath();
+
+        std::string content;
+        if (mOptions.resume && std::filesystem::exists(path))
+        {
+            std::ifstream ifs(path, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+            // Only accept complete lines. Anything after the last newline was cut off.
+            std::string_view view(content);
+            size_t pos = 0;
+            while (true)
+            {
+                size_t end = view.find('\n', pos);
+                if (end == std::string_view::npos) break;
+                std::string_view line = view.substr(pos, end - pos);
+                pos = end + 1;
+
+                if (line.empty() || line[0] == '#') continue;
+                uint64_t frame = 0;
+                if (line.size() > kManifestSuffix.size() && line.substr(line.size() - kManifestSuffix.size()) == kManifestSuffix &&
+                    parseInteger(line.substr(0, line.size() - kManifestSuffix.size()), frame))
+                {
+                    mCompletedFrames.insert(frame);
+                }
+                else
+                {
+                    logWarning("Ignoring invalid line '{}' in batch manifest '{}'.", line, path);
+                }
+            }
+
+            if (!mCompletedFrames.empty()) logInfo("Resuming batch, {} frames already completed according to '{}'.", mCompletedFrames.size(), path);
+        }
+
+        mManifest.open(path, mOptions.resume ? std::ios::app : std::ios::trunc);
+        if (!mManifest) FALCOR_THROW("Failed to open batch manifest '{}'.", path);
+
+        if (content.empty()) mManifest << kManifestHeader << "\n";
+        else if (content.back() != '\n') mManifest << "\n"; // Terminate a line that was cut off.
+        mManifest.flush();
+    }
+
+    void BatchRenderer::renderFrame(RenderContext* pRenderContext, uint64_t frame)
+    {
+        const auto startTime = CpuTimer::getCurrentTimePoint();
+
+        auto& clock = mpRenderer->getGlobalClock();
+        clock.setFrame(frame);
+
+        RenderGraph* pGraph = mpRenderer->getActiveGraph();
+        pGraph->compile(pRenderContext);
+
+        if (mpRenderer->mpScene)
+        {
+            auto sceneUpdates = mpRenderer->mpScene->update(pRenderContext, clock.getTime());
+            for (auto& g : mpRenderer->mGraphs) g.sceneUpdates |= sceneUpdates;
+        }
+
+        mpRenderer->executeActiveGraph(pRenderContext);
+
+        // Issue the readbacks. The data is read once later frames have been submitted.
+        PendingFrame pending;
+        pending.frame = frame;
+        for (uint32_t i = 0; i < pGraph->getOutputCount(); i++)
+        {
+            const std::string prefix = fmt::format("{}.{}.{}", mOptions.baseFilename, pGraph->getOutputName(i), frame);
+
+            for (const auto& image : FrameCapture::getCaptureImages(*mpImageProcessing, pRenderContext, pGraph, i))
+            {
+                ref<Texture> pTex = image.pTexture;
+                auto ext = Bitmap::getFileExtFromResourceFormat(pTex->getFormat());
+
+                PendingImage pendingImage;
+                pendingImage.path = mOutputDir / (prefix + image.suffix + "." + ext);
+                pendingImage.fileFormat = Bitmap::getFormatFromFileExtension(ext);
+                pendingImage.exportFlags = image.exportFlags;
+                pendingImage.resourceFormat = pTex->getFormat();
+                pendingImage.width = pTex->getWidth();
+                pendingImage.height = pTex->getHeight();
+
+                // Bitmap export needs at least three channels for floating-point data (same as Texture::captureToFile).
+                if (getFormatType(pTex->getFormat()) == FormatType::Float && getFormatChannelCount(pTex->getFormat()) < 3)
+                {
+                    auto pExpanded = mpRenderer->getDevice()->createTexture2D(pTex->getWidth(), pTex->getHeight(), ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource);
+                    pRenderContext->blit(pTex->getSRV(0, 1, 0, 1), pExpanded->getRTV(0, 0, 1));
+                    pTex = pExpanded;
+                    pendingImage.resourceFormat = ResourceFormat::RGBA32Float;
+                }
+
+                pendingImage.pReadTask = pRenderContext->asyncReadTextureSubresource(pTex.get(), 0);
+                pending.images.push_back(std::move(pendingImage));
+            }
+        }
+
+#if FALCOR_ENABLE_PROFILER
+        mpRenderer->getDevice()->getProfiler()->endFrame(pRenderContext);
+#endif
+        mpRenderer->getDevice()->endFrame();
+
+        mReadbackQueue.push_back(std::move(pending));
+        mReport.renderTime += getElapsedSeconds(startTime);
+    }
+
+    void BatchRenderer::retireFrame()
+    {
+        FALCOR_ASSERT(!mReadbackQueue.empty());
+        auto pFrame = std::make_shared<PendingFrame>(std::move(mReadbackQueue.front()));
+        mReadbackQueue.pop_front();
+
+        const auto startTime = CpuTimer::getCurrentTimePoint();
+        for (auto& image : pFrame->images)
+        {
+            image.data = image.pReadTask->getData();
+            image.pReadTask.reset();
+        }
+        mReport.readbackTime += getElapsedSeconds(startTime);
+
+        // Bound the number of frames held in memory while waiting to be encoded.
+        waitForEncoder(2 * mpEncoderPool->get_thread_count());
+        mEncodeQueue.push_back(mpEncoderPool->submit([this, pFrame]() { encodeFrame(*pFrame); }));
+    }
+
+    void BatchRenderer::encodeFrame(PendingFrame& frame)
+    {
+        const auto startTime = CpuTimer::getCurrentTimePoint();
+
+        bool success = true;
+        for (auto& image : frame.images)
+        {
+            try
+            {
+                Bitmap::saveImage(image.path, image.width, image.height, image.fileFormat, image.exportFlags, image.resourceFormat, true, image.data.data());
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to write batch image '{}': {}", image.path, e.what());
+                success = false;
+            }
+            image.data = {};
+        }
+
+        std::lock_guard<std::mutex> lock(mManifestMutex);
+        mEncodeTime += getElapsedSeconds(startTime);
+        if (success)
+        {
+            mManifest << frame.frame << kManifestSuffix << "\n";
+            mManifest.flush();
+        }
+        else
+        {
+            mFailedFrames++;
+        }
+    }
+
+    void BatchRenderer::waitForEncoder(size_t maxPending)
+    {
+        while (mEncodeQueue.size() > maxPending)
+        {
+            const auto startTime = CpuTimer::getCurrentTimePoint();
+            auto future = std::move(mEncodeQueue.front());
+            mEncodeQueue.pop_front();
+            future.get();
+            mReport.encodeStallTime += getElapsedSeconds(startTime);
+        }
+    }
+
+    void BatchRenderer::writeReport(const Report& report) const
+    {
+        nlohmann::json j;
+        j["startFrame"] = mOptions.startFrame;
+        j["endFrame"] = mOptions.endFrame;
+        j["shardIndex"] = mOptions.shardIndex;
+        j["shardCount"] = mOptions.shardCount;
+        j["frameCount"] = report.frameCount;
+        j["skippedFrames"] = report.skippedFrames;
+        j["renderedFrames"] = report.renderedFrames;
+        j["failedFrames"] = report.failedFrames;
+        j["totalTime"] = report.totalTime;
+        j["renderTime"] = report.renderTime;
+        j["readbackTime"] = report.readbackTime;
+        j["encodeTime"] = report.encodeTime;
+        j["encodeStallTime"] = report.encodeStallTime;
+        j["framesPerSecond"] = report.getFramesPerSecond();
+
+        auto path = getManifestPath().replace_extension(".report.json");
+        std::ofstream ofs(path);
+        if (!ofs) logWarning("Failed to write batch report '{}'.", path);
+        else ofs << j.dump(4) << "\n";
+    }
+}
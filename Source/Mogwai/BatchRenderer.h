@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "Utils/Image/ImageProcessing.h"
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace BS
+{
+    class thread_pool;
+}
+
+using namespace Falcor;
+
+namespace Mogwai
+{
+    class Renderer;
+
+    /** Renders a range of frames of the active graph and writes its outputs to disk without going through the interactive loop.
+        Each frame sets the global clock, updates the scene and executes the active graph. No UI, framebuffer blit or present
+        is done and Mogwai extensions are not invoked. Graph outputs are captured like FrameCapture does.
+
+        Readback and encoding are pipelined: the outputs of a frame are copied to readback buffers and only read on the CPU
+        once a number of later frames have been submitted, images are then encoded and written on worker threads.
+
+        The frame range can be split into contiguous shards to render it with several processes (or machines).
+        Completed frames are appended to a per-shard manifest in the output directory. A run with the same range, shard and
+        output directory skips frames already listed there, so a failed or killed run can simply be restarted.
+    */
+    class BatchRenderer
+    {
+    public:
+        struct Options
+        {
+            uint64_t startFrame = 0;            ///< First frame to render.
+            uint64_t endFrame = 0;              ///< End of the frame range (exclusive).
+            uint32_t shardIndex = 0;            ///< Index of the shard rendered by this process.
+            uint32_t shardCount = 1;            ///< Number of shards the frame range is split into.
+            std::filesystem::path outputDir = ".";
+            std::string baseFilename = "Mogwai";
+            bool resume = true;                 ///< Skip frames listed in an existing manifest.
+            uint32_t readbackDepth = 3;         ///< Number of frames submitted before the oldest one is read back.
+            uint32_t encoderThreadCount = 0;    ///< Number of image encoding threads (0 = number of hardware threads).
+        };
+
+        struct Report
+        {
+            uint64_t frameCount = 0;        ///< Number of frames in the shard.
+            uint64_t skippedFrames = 0;     ///< Frames skipped because they were already in the manifest.
+            uint64_t renderedFrames = 0;    ///< Frames rendered in this run.
+            uint64_t failedFrames = 0;      ///< Frames whose images failed to be written.
+            double totalTime = 0.0;         ///< Wall-clock time of the run in seconds.
+            double renderTime = 0.0;        ///< Time spent updating the scene and recording/submitting frames.
+            double readbackTime = 0.0;      ///< Time spent waiting for the GPU and copying readback data.
+            double encodeTime = 0.0;        ///< Time spent encoding and writing images, summed over all encoding threads.
+            double encodeStallTime = 0.0;   ///< Time the render thread spent waiting for encoding threads to catch up.
+
+            double getFramesPerSecond() const { return totalTime > 0.0 ? renderedFrames / totalTime : 0.0; }
+        };
+
+        /** Get the frames [first, last) of a shard. Frames are split into contiguous ranges of (almost) equal size.
+        */
+        static std::pair<uint64_t, uint64_t> getShardRange(uint64_t startFrame, uint64_t endFrame, uint32_t shardIndex, uint32_t shardCount);
+
+        /** Parse a shard specification of the form "i/n".
+        */
+        static std::pair<uint32_t, uint32_t> parseShard(const std::string& str);
+
+        /** Parse a frame range of the form "first:end" (end exclusive).
+        */
+        static std::pair<uint64_t, uint64_t> parseFrameRange(const std::string& str);
+
+        BatchRenderer(Renderer* pRenderer, const Options& options);
+        ~BatchRenderer();
+
+        BatchRenderer(const BatchRenderer&) = delete;
+        BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+        /** Render all frames of the shard that are not in the manifest.
+            Frames completed before an error are recorded in the manifest before the error is rethrown.
+            \return The throughput report. It is also logged and written next to the manifest.
+        */
+        Report run();
+
+        const Options& getOptions() const { return mOptions; }
+
+        /** Get the path of the manifest listing the completed frames of this shard.
+        */
+        std::filesystem::path getManifestPath() const;
+
+    private:
+        struct PendingImage
+        {
+            std::filesystem::path path;
+            Bitmap::FileFormat fileFormat;
+            Bitmap::ExportFlags exportFlags;
+            ResourceFormat resourceFormat;
+            uint32_t width;
+            uint32_t height;
+            CopyContext::ReadTextureTask::SharedPtr pReadTask;
+            std::vector<uint8_t> data;
+        };
+
+        struct PendingFrame
+        {
+            uint64_t frame;
+            std::vector<PendingImage> images;
+        };
+
+        void loadManifest();
+        void renderFrame(RenderContext* pRenderContext, uint64_t frame);
+        void retireFrame();
+        void encodeFrame(PendingFrame& frame);
+        void waitForEncoder(size_t maxPending);
+        void writeReport(const Report& report) const;
+
+        Renderer* mpRenderer;
+        Options mOptions;
+        std::filesystem::path mOutputDir;
+        std::unique_ptr<ImageProcessing> mpImageProcessing;
+
+        std::set<uint64_t> mCompletedFrames;        ///< Frames listed in the manifest when the run started.
+        std::deque<PendingFrame> mReadbackQueue;    ///< Frames waiting for readback, oldest first.
+        std::deque<std::future<void>> mEncodeQueue; ///< Frames being encoded, oldest first.
+        std::unique_ptr<BS::thread_pool> mpEncoderPool;
+
+        std::mutex mManifestMutex;                  ///< Protects mManifest, mEncodeTime and mFailedFrames.
+        std::ofstream mManifest;
+        double mEncodeTime = 0.0;
+        uint64_t mFailedFrames = 0;
+
+        Report mReport;
+    };
+}
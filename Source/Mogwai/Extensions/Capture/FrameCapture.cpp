@@ -161,12 +161,28 @@ namespace Mogwai
         const std::string outputName = pGraph->getOutputName(outputIndex);
         const std::string basename = getOutputNamePrefix(outputName) + std::to_string(mpRenderer->getGlobalClock().getFrame());
 
+        for (const auto& image : getCaptureImages(*mpImageProcessing, pRenderContext, pGraph, outputIndex))
+        {
+            // Write output image.
+            auto ext = Bitmap::getFileExtFromResourceFormat(image.pTexture->getFormat());
+            auto fileformat = Bitmap::getFormatFromFileExtension(ext);
+            std::string filename = basename + image.suffix + "." + ext;
+
+            image.pTexture->captureToFile(0, 0, filename, fileformat, image.exportFlags);
+        }
+    }
+
+    std::vector<FrameCapture::CaptureImage> FrameCapture::getCaptureImages(ImageProcessing& imageProcessing, RenderContext* pRenderContext, RenderGraph* pGraph, const uint32_t outputIndex)
+    {
+        const std::string outputName = pGraph->getOutputName(outputIndex);
+
         const ref<Texture> pOutput = pGraph->getOutput(outputIndex)->asTexture();
         if (!pOutput) FALCOR_THROW("Graph output {} is not a texture", outputName);
 
         const ResourceFormat format = pOutput->getFormat();
         const uint32_t channels = getFormatChannelCount(format);
 
+        std::vector<CaptureImage> images;
         for (auto mask : pGraph->getOutputMasks(outputIndex))
         {
             // Determine output color channels and filename suffix.
@@ -237,19 +253,17 @@ namespace Mogwai
                 }
 
                 // Copy color channel into temporary texture.
-                pTex = mpRenderer->getDevice()->createTexture2D(pOutput->getWidth(), pOutput->getHeight(), outputFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
-                mpImageProcessing->copyColorChannel(pRenderContext, pOutput->getSRV(0, 1, 0, 1), pTex->getUAV(), mask);
+                pTex = pRenderContext->getDevice()->createTexture2D(pOutput->getWidth(), pOutput->getHeight(), outputFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+                imageProcessing.copyColorChannel(pRenderContext, pOutput->getSRV(0, 1, 0, 1), pTex->getUAV(), mask);
             }
 
-            // Write output image.
-            auto ext = Bitmap::getFileExtFromResourceFormat(pTex->getFormat());
-            auto fileformat = Bitmap::getFormatFromFileExtension(ext);
-            std::string filename = basename + suffix + "." + ext;
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
 
-            pTex->captureToFile(0, 0, filename, fileformat, flags);
+            images.push_back({ pTex, suffix, flags });
         }
+
+        return images;
     }
 
     void FrameCapture::addFrames(const RenderGraph* pGraph, const uint64_vec& frames)
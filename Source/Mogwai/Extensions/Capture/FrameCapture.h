@@ -43,6 +43,20 @@ namespace Mogwai
         virtual void triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID) override;
         void capture();
 
+        /** Image to capture for one mask of a graph output.
+        */
+        struct CaptureImage
+        {
+            ref<Texture> pTexture;  ///< Texture holding the captured channels.
+            std::string suffix;     ///< Filename suffix identifying the channels (empty for RGB).
+            Bitmap::ExportFlags exportFlags = Bitmap::ExportFlags::None;
+        };
+
+        /** Get the images to capture for a graph output, one per output mask.
+            Single channels are copied into temporary textures.
+        */
+        static std::vector<CaptureImage> getCaptureImages(ImageProcessing& imageProcessing, RenderContext* pRenderContext, RenderGraph* pGraph, uint32_t outputIndex);
+
     private:
         FrameCapture(Renderer* pRenderer);
 
@@ -85,6 +85,7 @@ namespace Mogwai
 
     void Renderer::onShutdown()
     {
+        mpSceneLoader.reset();
         resetEditor();
         getDevice()->wait(); // Need to do that because clearing the graphs will try to release some state objects which might be in use
         mGraphs.clear();
@@ -116,7 +117,8 @@ namespace Mogwai
         // Load script provided via command line.
         if (!mOptions.scriptFile.empty())
         {
-            if (mOptions.deferredLoad)
+            // Batch rendering starts right after loading, so the script cannot be deferred.
+            if (mOptions.deferredLoad && !mOptions.batch)
             {
                 loadScriptDeferred(mOptions.scriptFile);
             }
@@ -135,6 +137,12 @@ namespace Mogwai
             // Add scene to recent files only if not in silent mode (which is used during image tests).
             if (!mOptions.silentMode) mAppData.addRecentScene(mOptions.sceneFile);
         }
+
+        if (mOptions.batch)
+        {
+            auto report = renderBatch(*mOptions.batch);
+            shutdown(report.failedFrames > 0 ? 1 : 0);
+        }
     }
 
     void Renderer::onOptionsChange()
@@ -309,7 +317,7 @@ namespace Mogwai
         }
         else if (std::any_of(Scene::getFileExtensionFilters().begin(), Scene::getFileExtensionFilters().end(), [&ext](FileDialogFilter f) {return f.ext == ext; }))
         {
-            loadScene(path);
+            loadSceneInteractive(path);
             mAppData.addRecentScene(path);
         }
         else
@@ -528,13 +536,16 @@ namespace Mogwai
         std::filesystem::path path;
         if (openFileDialog(Scene::getFileExtensionFilters(), path))
         {
-            loadScene(path);
+            loadSceneInteractive(path);
             mAppData.addRecentScene(path);
         }
     }
 
     void Renderer::loadScene(std::filesystem::path path, SceneBuilder::Flags buildFlags)
     {
+        // A synchronous load supersedes a pending background load.
+        cancelSceneLoad();
+
         if (mOptions.useSceneCache) buildFlags |= SceneBuilder::Flags::UseCache;
         if (mOptions.rebuildSceneCache) buildFlags |= SceneBuilder::Flags::RebuildCache;
 
@@ -564,8 +575,86 @@ namespace Mogwai
         }
     }
 
+    void Renderer::loadSceneAsync(std::filesystem::path path, SceneBuilder::Flags buildFlags)
+    {
+        // Only importers that do no GPU work can run on the worker thread.
+        // This also excludes Python scenes, which are built by running a script that needs the interpreter owned by the main thread.
+        if (!Importer::isCpuOnly(getExtensionFromPath(path)))
+        {
+            logInfo("Scene '{}' can't be imported in the background, loading it synchronously.", path);
+            loadScene(path, buildFlags);
+            return;
+        }
+
+        cancelSceneLoad();
+
+        if (mOptions.useSceneCache) buildFlags |= SceneBuilder::Flags::UseCache;
+        if (mOptions.rebuildSceneCache) buildFlags |= SceneBuilder::Flags::RebuildCache;
+
+        logInfo("Loading scene '{}' in the background.", path);
+        mpSceneLoader = std::make_unique<SceneLoader>(getDevice(), path, getSettings(), buildFlags);
+    }
+
+    void Renderer::loadSceneInteractive(const std::filesystem::path& path)
+    {
+        if (mLoadScenesInBackground) loadSceneAsync(path);
+        else loadScene(path);
+    }
+
+    void Renderer::cancelSceneLoad()
+    {
+        // Destroying the loader cancels the build and waits for the worker thread to exit.
+        mpSceneLoader.reset();
+    }
+
+    void Renderer::waitForSceneLoad()
+    {
+        if (!mpSceneLoader) return;
+        mpSceneLoader->wait();
+        updateSceneLoader();
+    }
+
+    void Renderer::updateSceneLoader()
+    {
+        if (!mpSceneLoader || !mpSceneLoader->isDone()) return;
+
+        // Take ownership of the loader, it is destroyed once the scene is swapped in.
+        // The scene and its GPU resources are created here on the main thread, before anything is rendered this frame.
+        auto pLoader = std::move(mpSceneLoader);
+        pLoader->finish();
+        auto progress = pLoader->getProgress();
+        switch (progress.state)
+        {
+        case SceneLoader::State::Finished:
+            logInfo("Loaded scene '{}' in the background in {:.2f} s.", pLoader->getPath(), progress.elapsedTime);
+            setScene(pLoader->takeScene());
+            break;
+        case SceneLoader::State::Failed:
+            reportErrorAndContinue(pLoader->getError());
+            break;
+        default:
+            break;
+        }
+    }
+
+    pybind11::dict Renderer::getSceneLoadProgress() const
+    {
+        pybind11::dict d;
+        d["loading"] = mpSceneLoader != nullptr;
+        if (mpSceneLoader)
+        {
+            auto progress = mpSceneLoader->getProgress();
+            d["path"] = mpSceneLoader->getPath().string();
+            d["stage"] = progress.stage;
+            d["stageProgress"] = progress.stageProgress;
+            d["elapsedTime"] = progress.elapsedTime;
+        }
+        return d;
+    }
+
     void Renderer::unloadScene()
     {
+        cancelSceneLoad();
         setScene(nullptr);
     }
 
@@ -603,6 +692,13 @@ namespace Mogwai
         return mpScene;
     }
 
+    BatchRenderer::Report Renderer::renderBatch(const BatchRenderer::Options& options)
+    {
+        getProgressBar().close();
+        BatchRenderer batchRenderer(this, options);
+        return batchRenderer.run();
+    }
+
     void Renderer::applyEditorChanges()
     {
         if (!mEditorProcess) return;
@@ -669,6 +765,9 @@ namespace Mogwai
 
     void Renderer::onFrameRender(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo)
     {
+        // Swap in a scene loaded in the background before anything else uses the scene this frame.
+        updateSceneLoader();
+
         if (!mScriptPath.empty())
         {
             auto path = mScriptPath;
@@ -847,6 +946,10 @@ int runMain(int argc, char** argv)
     args::Flag generateShaderDebugInfoFlag(parser, "", "Generate shader debug info.", {"debug-shaders"});
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag preciseProgramFlag(parser, "", "Force all slang programs to run in precise mode", { "precise" });
+    args::ValueFlag<std::string> batchFramesFlag(parser, "first:end", "Render frames [first, end) of the active graph to disk and exit (implies --headless).", {"batch-frames"});
+    args::ValueFlag<std::string> shardFlag(parser, "i/n", "Render only shard i of n of the batch frame range.", {"shard"});
+    args::ValueFlag<std::string> batchOutputFlag(parser, "path", "Output directory for batch rendering.", {"batch-output"});
+    args::Flag batchRestartFlag(parser, "", "Render all batch frames, ignoring frames completed by a previous run.", {"batch-restart"});
 
     args::CompletionFlag completionFlag(parser, {"complete"});
 
@@ -947,6 +1050,22 @@ int runMain(int argc, char** argv)
     if (useSceneCacheFlag) options.useSceneCache = true;
     if (rebuildSceneCacheFlag) options.rebuildSceneCache = true;
 
+    if (batchFramesFlag)
+    {
+        Mogwai::BatchRenderer::Options batch;
+        std::tie(batch.startFrame, batch.endFrame) = Mogwai::BatchRenderer::parseFrameRange(args::get(batchFramesFlag));
+        if (shardFlag) std::tie(batch.shardIndex, batch.shardCount) = Mogwai::BatchRenderer::parseShard(args::get(shardFlag));
+        if (batchOutputFlag) batch.outputDir = args::get(batchOutputFlag);
+        if (batchRestartFlag) batch.resume = false;
+        options.batch = batch;
+        options.silentMode = true;
+        config.headless = true;
+    }
+    else if (shardFlag || batchOutputFlag || batchRestartFlag)
+    {
+        logWarning("Batch rendering options are ignored without --batch-frames.");
+    }
+
     Mogwai::Renderer renderer(config, options);
     return renderer.run();
 }
@@ -31,6 +31,9 @@
 #include "Scene/SceneBuilder.h"
 #include "RenderGraph/RenderGraph.h"
 #include "AppData.h"
+#include "SceneLoader.h"
+#include "BatchRenderer.h"
+#include <optional>
 
 namespace Falcor
 {
@@ -87,6 +90,7 @@ namespace Mogwai
             bool silentMode = false;
             bool useSceneCache = false;
             bool rebuildSceneCache = false;
+            std::optional<BatchRenderer::Options> batch; ///< If set, render the batch after loading and exit.
         };
 
         using KeyCallback = std::function<bool(bool pressed, uint32_t key)>;
@@ -154,6 +158,13 @@ namespace Mogwai
         };
 
         ref<Scene> mpScene;
+        std::unique_ptr<SceneLoader> mpSceneLoader;
+        bool mLoadScenesInBackground = true; ///< Use background loading for scenes loaded from the UI.
+
+        /** Swap in a scene that finished loading in the background. Called at frame boundaries.
+        */
+        void updateSceneLoader();
+        pybind11::dict getSceneLoadProgress() const;
 
         void addGraph(const ref<RenderGraph>& pGraph);
         void setActiveGraph(const ref<RenderGraph>& pGraph);
@@ -165,9 +176,26 @@ namespace Mogwai
         void removeActiveGraph();
         void loadSceneDialog();
         void loadScene(std::filesystem::path path, SceneBuilder::Flags buildFlags = SceneBuilder::Flags::Default);
+        /** Load a scene in the background. The scene is imported on a worker thread while the current scene keeps rendering.
+            At the start of the first frame after the import finished, the new scene is created on the main thread and
+            swapped in. Starting a new load cancels a pending one. Scenes whose importer needs the GPU or the Python
+            interpreter (see Importer::isCpuOnly()) are loaded synchronously.
+        */
+        void loadSceneAsync(std::filesystem::path path, SceneBuilder::Flags buildFlags = SceneBuilder::Flags::Default);
+        /** Load a scene asynchronously if background loading is enabled (used by UI), synchronously otherwise.
+        */
+        void loadSceneInteractive(const std::filesystem::path& path);
+        void cancelSceneLoad();
+        /** Wait for a pending background load to finish and swap the scene in.
+        */
+        void waitForSceneLoad();
+        bool isSceneLoading() const { return mpSceneLoader != nullptr; }
         void unloadScene();
         void setScene(const ref<Scene>& pScene);
         ref<Scene> getScene() const;
+        /** Render a range of frames of the active graph to disk, bypassing the interactive loop. See BatchRenderer.
+        */
+        BatchRenderer::Report renderBatch(const BatchRenderer::Options& options);
         void executeActiveGraph(RenderContext* pRenderContext);
         void beginFrame(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo);
         void endFrame(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo);
@@ -41,6 +41,10 @@ namespace Mogwai
         const std::string kRunScript = "script";
         const std::string kLoadScene = "loadScene";
         const std::string kUnloadScene = "unloadScene";
+        const std::string kLoadSceneAsync = "loadSceneAsync";
+        const std::string kCancelSceneLoad = "cancelSceneLoad";
+        const std::string kWaitForSceneLoad = "waitForSceneLoad";
+        const std::string kSceneLoadProgress = "sceneLoadProgress";
         const std::string kSaveConfig = "saveConfig";
         const std::string kAddGraph = "addGraph";
         const std::string kSetActiveGraph = "setActiveGraph";
@@ -50,6 +54,7 @@ namespace Mogwai
         const std::string kKeyCallback = "keyCallback";
         const std::string kResizeFrameBuffer = "resizeFrameBuffer";
         const std::string kRenderFrame = "renderFrame";
+        const std::string kRenderBatch = "renderBatch";
         const std::string kActiveGraph = "activeGraph";
         const std::string kScene = "scene";
         const std::string kClock = "clock";
@@ -129,6 +134,10 @@ namespace Mogwai
         renderer.def(kRunScript.c_str(), &Renderer::loadScript, "path"_a);
         renderer.def(kLoadScene.c_str(), &Renderer::loadScene, "path"_a, "buildFlags"_a = SceneBuilder::Flags::Default);
         renderer.def(kUnloadScene.c_str(), &Renderer::unloadScene);
+        renderer.def(kLoadSceneAsync.c_str(), &Renderer::loadSceneAsync, "path"_a, "buildFlags"_a = SceneBuilder::Flags::Default);
+        renderer.def(kCancelSceneLoad.c_str(), &Renderer::cancelSceneLoad);
+        renderer.def(kWaitForSceneLoad.c_str(), &Renderer::waitForSceneLoad);
+        renderer.def_property_readonly(kSceneLoadProgress.c_str(), &Renderer::getSceneLoadProgress);
         renderer.def(kSaveConfig.c_str(), &Renderer::saveConfig, "path"_a);
         renderer.def(kAddGraph.c_str(), &Renderer::addGraph, "graph"_a);
         renderer.def(kSetActiveGraph.c_str(),
@@ -147,6 +156,39 @@ namespace Mogwai
         auto renderFrame = [](Renderer* pRenderer) { pRenderer->getProgressBar().close(); pRenderer->renderFrame(); };
         renderer.def(kRenderFrame.c_str(), renderFrame);
 
+        auto renderBatch = [](Renderer* pRenderer, uint64_t startFrame, uint64_t endFrame, const std::filesystem::path& outputDir,
+            const std::string& baseFilename, uint32_t shardIndex, uint32_t shardCount, bool resume, uint32_t readbackDepth, uint32_t encoderThreadCount)
+        {
+            BatchRenderer::Options options;
+            options.startFrame = startFrame;
+            options.endFrame = endFrame;
+            options.outputDir = outputDir;
+            options.baseFilename = baseFilename;
+            options.shardIndex = shardIndex;
+            options.shardCount = shardCount;
+            options.resume = resume;
+            options.readbackDepth = readbackDepth;
+            options.encoderThreadCount = encoderThreadCount;
+            auto report = pRenderer->renderBatch(options);
+
+            pybind11::dict d;
+            d["frameCount"] = report.frameCount;
+            d["skippedFrames"] = report.skippedFrames;
+            d["renderedFrames"] = report.renderedFrames;
+            d["failedFrames"] = report.failedFrames;
+            d["totalTime"] = report.totalTime;
+            d["renderTime"] = report.renderTime;
+            d["readbackTime"] = report.readbackTime;
+            d["encodeTime"] = report.encodeTime;
+            d["encodeStallTime"] = report.encodeStallTime;
+            d["framesPerSecond"] = report.getFramesPerSecond();
+            return d;
+        };
+        BatchRenderer::Options defaultBatch;
+        renderer.def(kRenderBatch.c_str(), renderBatch, "startFrame"_a, "endFrame"_a, "outputDir"_a = defaultBatch.outputDir,
+            "baseFilename"_a = defaultBatch.baseFilename, "shardIndex"_a = defaultBatch.shardIndex, "shardCount"_a = defaultBatch.shardCount,
+            "resume"_a = defaultBatch.resume, "readbackDepth"_a = defaultBatch.readbackDepth, "encoderThreadCount"_a = defaultBatch.encoderThreadCount);
+
         renderer.def_property_readonly(kScene.c_str(), &Renderer::getScene);
         renderer.def_property_readonly(kActiveGraph.c_str(), &Renderer::getActiveGraph);
         renderer.def_property_readonly(kClock.c_str(), [] (Renderer* pRenderer) { return &pRenderer->getGlobalClock(); });
@@ -259,6 +259,20 @@ namespace Mogwai
         pActiveGraph->renderUI(mpRenderer->getRenderContext(), w);
     }
 
+    void MogwaiSettings::renderSceneLoadProgress(Gui* pGui)
+    {
+        if (!mpRenderer->mpSceneLoader) return;
+
+        auto progress = mpRenderer->mpSceneLoader->getProgress();
+        Gui::Window w(pGui, "Loading Scene", { 400, 0 }, { 320, 80 }, Gui::WindowFlags::Default);
+        w.text(mpRenderer->mpSceneLoader->getPath().string());
+        std::string stage = progress.stage;
+        if (progress.stageProgress >= 0.f) stage += fmt::format(" ({:.0f}%)", progress.stageProgress * 100.f);
+        w.text(stage);
+        w.text(fmt::format("Elapsed: {:.1f} s", progress.elapsedTime));
+        if (w.button("Cancel")) mpRenderer->cancelSceneLoad();
+    }
+
     void MogwaiSettings::renderMainMenu(Gui* pGui)
     {
         if (mAutoHideMenu && mMousePosition.y >= 20) return;
@@ -270,6 +284,7 @@ namespace Mogwai
             if (file.item("Load Script", "Ctrl+O")) mpRenderer->loadScriptDialog();
             if (file.item("Save Config")) mpRenderer->saveConfigDialog();
             if (file.item("Load Scene", "Ctrl+Shift+O")) mpRenderer->loadSceneDialog();
+            file.item("Load Scenes in Background", mpRenderer->mLoadScenesInBackground);
             // if (file.item("Reset Scene")) mpRenderer->setScene(nullptr);
             file.separator();
 
@@ -293,7 +308,7 @@ namespace Mogwai
                 {
                     if (recentScenes.item(path.string()))
                     {
-                        mpRenderer->loadScene(path);
+                        mpRenderer->loadSceneInteractive(path);
                         appData.addRecentScene(path);
                     }
                 }
@@ -332,6 +347,7 @@ namespace Mogwai
         Gui* pGui = (Gui*)pGui__;
         renderMainMenu(pGui);
         renderGraphs(pGui);
+        renderSceneLoadProgress(pGui);
         if (mShowFps) showFps(pGui, mpRenderer);
         if (mShowTime) renderTimeSettings(pGui);
         if (mShowWinSize) renderWindowSettings(pGui);
@@ -49,6 +49,7 @@ namespace Mogwai
 
         void renderMainMenu(Gui* pGui);
         void renderGraphs(Gui* pGui);
+        void renderSceneLoadProgress(Gui* pGui);
         void renderTimeSettings(Gui* pGui);
         void renderWindowSettings(Gui* pGui);
         void selectNextGraph();
@@ -0,0 +1,154 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneLoader.h"
+#include "Scene/ImporterError.h"
+#include "Utils/Timing/TimeReport.h"
+
+namespace Mogwai
+{
+    SceneLoader::SceneLoader(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, SceneBuilder::Flags buildFlags)
+        : mpDevice(pDevice)
+        , mPath(path)
+        , mStartTime(CpuTimer::getCurrentTimePoint())
+        , mStage("Starting")
+    {
+        bool readFromCache = false;
+        runStage([&]()
+        {
+            mpBuilder = std::make_unique<SceneBuilder>(mpDevice, settings, buildFlags);
+            mpBuilder->setProgressCallback([this](std::string_view stage, float progress) { return onProgress(stage, progress); });
+            readFromCache = mpBuilder->readSceneCache(mPath);
+        });
+
+        if (mState != State::Loading || readFromCache)
+        {
+            mDone = true;
+            return;
+        }
+
+        mThread = std::thread(&SceneLoader::run, this);
+    }
+
+    SceneLoader::~SceneLoader()
+    {
+        cancel();
+        wait();
+    }
+
+    void SceneLoader::wait()
+    {
+        if (mThread.joinable()) mThread.join();
+    }
+
+    void SceneLoader::finish()
+    {
+        if (mFinished) return;
+        wait();
+
+        // Load the textures and create the scene on this thread.
+        if (mState == State::Loading)
+        {
+            runStage([&]()
+            {
+                TimeReport timeReport;
+                mpScene = mpBuilder->getScene();
+                timeReport.measure("Creating scene on the main thread");
+                timeReport.printToLog();
+                mState = State::Finished;
+            });
+        }
+
+        mpBuilder.reset();
+        mFinished = true;
+    }
+
+    SceneLoader::Progress SceneLoader::getProgress() const
+    {
+        Progress progress;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            progress.stage = mStage;
+            progress.stageProgress = mStageProgress;
+        }
+        progress.state = mDone ? mState : State::Loading;
+        progress.elapsedTime = CpuTimer::calcDuration(mStartTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+        return progress;
+    }
+
+    ref<Scene> SceneLoader::takeScene()
+    {
+        FALCOR_CHECK(mFinished, "Scene load has not finished yet.");
+        return std::move(mpScene);
+    }
+
+    void SceneLoader::run()
+    {
+        runStage([&]()
+        {
+            TimeReport timeReport;
+            mpBuilder->importFile(mPath);
+            timeReport.measure("Importing scene in background");
+            timeReport.printToLog();
+        });
+
+        mDone = true;
+    }
+
+    void SceneLoader::runStage(const std::function<void()>& func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const SceneBuildCancelled&)
+        {
+            logInfo("Cancelled loading scene '{}'.", mPath);
+            mState = State::Cancelled;
+        }
+        catch (const ImporterError& e)
+        {
+            mError = fmt::format("Failed to load scene.\n\nError in {}\n\n{}", e.path(), e.what());
+            mState = State::Failed;
+        }
+        catch (const std::exception& e)
+        {
+            mError = fmt::format("Failed to load scene '{}'.\n\n{}", mPath, e.what());
+            mState = State::Failed;
+        }
+    }
+
+    bool SceneLoader::onProgress(std::string_view stage, float progress)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStage = stage;
+            mStageProgress = progress;
+        }
+        return !mCancelRequested;
+    }
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "Scene/SceneBuilder.h"
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace Falcor;
+
+namespace Mogwai
+{
+    /** Loads a scene in the background.
+        Only the import runs on a worker thread, which requires an importer that does no GPU work (see Importer::isCpuOnly()).
+        The owner polls the loader once per frame. Once the import is done, it calls finish() from the main thread between
+        frames, which loads the textures and creates the scene and its GPU resources. The scene builder is only created and
+        destroyed on the thread owning the loader.
+    */
+    class SceneLoader
+    {
+    public:
+        enum class State
+        {
+            Loading,
+            Finished,
+            Failed,
+            Cancelled,
+        };
+
+        struct Progress
+        {
+            State state = State::Loading;
+            std::string stage;          ///< Description of the current stage.
+            float stageProgress = -1.f; ///< Progress of the current stage in [0,1], negative if unknown.
+            double elapsedTime = 0.0;   ///< Time since the load was started in seconds.
+        };
+
+        /** Start loading a scene.
+            The scene builder is created on the calling thread. If the build flags enable the scene cache and it is valid,
+            the scene is read from the cache right away and no worker thread is started.
+            \param[in] pDevice GPU device.
+            \param[in] path Scene file path.
+            \param[in] settings Settings passed to the scene builder.
+            \param[in] buildFlags Scene builder flags.
+        */
+        SceneLoader(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, SceneBuilder::Flags buildFlags);
+
+        /** Destructor. Cancels the load and waits for the worker thread to exit.
+            Must be called from the main thread, as it releases the scene builder.
+        */
+        ~SceneLoader();
+
+        SceneLoader(const SceneLoader&) = delete;
+        SceneLoader& operator=(const SceneLoader&) = delete;
+
+        /** Request cancellation. The builder stops at its next progress report.
+        */
+        void cancel() { mCancelRequested = true; }
+
+        /** Block until the worker thread has exited.
+        */
+        void wait();
+
+        /** Check if the import has finished (successfully or not).
+        */
+        bool isDone() const { return mDone; }
+
+        /** Build the scene from the imported data and release the scene builder.
+            This creates GPU resources, so it must be called from the main thread at a frame boundary.
+            Waits for the import to finish if needed. Afterwards the state is Finished, Failed or Cancelled.
+        */
+        void finish();
+
+        Progress getProgress() const;
+
+        /** Take the loaded scene. Only valid after finish().
+            \return The scene, or nullptr if the load failed or was cancelled.
+        */
+        ref<Scene> takeScene();
+
+        /** Get the error message if the load failed.
+        */
+        const std::string& getError() const { return mError; }
+
+        const std::filesystem::path& getPath() const { return mPath; }
+
+    private:
+        void run();
+        bool onProgress(std::string_view stage, float progress);
+        void runStage(const std::function<void()>& func);
+
+        ref<Device> mpDevice;
+        std::filesystem::path mPath;
+        CpuTimer::TimePoint mStartTime;
+
+        mutable std::mutex mMutex;  ///< Protects mStage and mStageProgress.
+        std::string mStage;
+        float mStageProgress = -1.f;
+
+        std::atomic<bool> mCancelRequested = false;
+        std::atomic<bool> mDone = false;    ///< True once the import is done.
+        bool mFinished = false;             ///< True once finish() was called.
+
+        // Written by the worker thread before setting mDone, and by finish().
+        State mState = State::Loading;
+        std::string mError;
+
+        std::unique_ptr<SceneBuilder> mpBuilder; ///< Created and destroyed by the owning thread, used by the worker thread while it runs.
+        ref<Scene> mpScene;
+
+        std::thread mThread;
+    };
+}
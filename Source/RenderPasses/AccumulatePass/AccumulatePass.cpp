@@ -33,6 +33,26 @@ static void regAccumulatePass(pybind11::module& m)
     pybind11::class_<AccumulatePass, RenderPass, ref<AccumulatePass>> pass(m, "AccumulatePass");
     pass.def_property("enabled", &AccumulatePass::isEnabled, &AccumulatePass::setEnabled);
     pass.def("reset", &AccumulatePass::reset);
+
+    // Convergence queries wait for the last frame, so scripts see the state of the frames rendered so far.
+    pass.def_property_readonly("converged", [](AccumulatePass& self) { return self.getConvergenceResult(true).converged; });
+    pass.def(
+        "get_convergence_stats",
+        [](AccumulatePass& self)
+        {
+            const ConvergenceResult& result = self.getConvergenceResult(true);
+            pybind11::dict d;
+            d["frame_count"] = result.frameCount;
+            d["tile_count"] = result.tileCount;
+            d["converged_tile_count"] = result.convergedTileCount;
+            d["max_tile_error"] = result.maxTileError;
+            d["mean_tile_error"] = result.meanTileError;
+            d["converged"] = result.converged;
+            return d;
+        }
+    );
+    pass.def("get_convergence_map", [](AccumulatePass& self) { return self.getConvergenceMap(true); });
+    pass.def_property_readonly("convergence_tile_count", &AccumulatePass::getConvergenceTileCount);
 }
 
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
@@ -44,9 +64,11 @@ extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registr
 namespace
 {
 const char kShaderFile[] = "RenderPasses/AccumulatePass/Accumulate.cs.slang";
+const char kConvergenceShaderFile[] = "RenderPasses/AccumulatePass/ConvergenceTiles.cs.slang";
 
 const char kInputChannel[] = "input";
 const char kOutputChannel[] = "output";
+const char kConvergenceChannel[] = "convergence";
 
 // Serialized parameters
 const char kEnabled[] = "enabled";
@@ -57,6 +79,13 @@ const char kAutoReset[] = "autoReset";
 const char kPrecisionMode[] = "precisionMode";
 const char kMaxFrameCount[] = "maxFrameCount";
 const char kOverflowMode[] = "overflowMode";
+const char kTrackConvergence[] = "trackConvergence";
+const char kConvergenceTileSize[] = "convergenceTileSize";
+const char kConvergenceTarget[] = "convergenceTarget";
+const char kConvergenceMinFrames[] = "convergenceMinFrames";
+const char kConvergenceTileFraction[] = "convergenceTileFraction";
+const char kConvergenceMinLuminance[] = "convergenceMinLuminance";
+const char kStopOnConvergence[] = "stopOnConvergence";
 } // namespace
 
 AccumulatePass::AccumulatePass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
@@ -80,6 +109,20 @@ AccumulatePass::AccumulatePass(ref<Device> pDevice, const Properties& props) : R
             mMaxFrameCount = value;
         else if (key == kOverflowMode)
             mOverflowMode = value;
+        else if (key == kTrackConvergence)
+            mTrackConvergence = value;
+        else if (key == kConvergenceTileSize)
+            mConvergenceTileSize = value;
+        else if (key == kConvergenceTarget)
+            mConvergenceCriteria.targetRelError = value;
+        else if (key == kConvergenceMinFrames)
+            mConvergenceCriteria.minFrameCount = value;
+        else if (key == kConvergenceTileFraction)
+            mConvergenceCriteria.convergedTileFraction = value;
+        else if (key == kConvergenceMinLuminance)
+            mConvergenceCriteria.minLuminance = value;
+        else if (key == kStopOnConvergence)
+            mStopOnConvergence = value;
         else
             logWarning("Unknown property '{}' in AccumulatePass properties.", key);
     }
@@ -91,6 +134,11 @@ AccumulatePass::AccumulatePass(ref<Device> pDevice, const Properties& props) : R
             mEnabled = props["enableAccumulation"];
     }
 
+    if (mConvergenceTileSize == 0)
+        FALCOR_THROW("AccumulatePass: '{}' must be positive.", kConvergenceTileSize);
+    if (!(mConvergenceCriteria.minLuminance > 0.f))
+        FALCOR_THROW("AccumulatePass: '{}' must be positive.", kConvergenceMinLuminance);
+
     mpState = ComputeState::create(mpDevice);
 }
 
@@ -107,6 +155,16 @@ Properties AccumulatePass::getProperties() const
     props[kPrecisionMode] = mPrecisionMode;
     props[kMaxFrameCount] = mMaxFrameCount;
     props[kOverflowMode] = mOverflowMode;
+    props[kTrackConvergence] = mTrackConvergence;
+    if (mTrackConvergence)
+    {
+        props[kConvergenceTileSize] = mConvergenceTileSize;
+        props[kConvergenceTarget] = mConvergenceCriteria.targetRelError;
+        props[kConvergenceMinFrames] = mConvergenceCriteria.minFrameCount;
+        props[kConvergenceTileFraction] = mConvergenceCriteria.convergedTileFraction;
+        props[kConvergenceMinLuminance] = mConvergenceCriteria.minLuminance;
+        props[kStopOnConvergence] = mStopOnConvergence;
+    }
     return props;
 }
 
@@ -121,11 +179,25 @@ RenderPassReflection AccumulatePass::reflect(const CompileData& compileData)
         .bindFlags(ResourceBindFlags::RenderTarget | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource)
         .format(fmt)
         .texture2D(sz.x, sz.y);
+    reflector.addOutput(kConvergenceChannel, "Relative error of the accumulated luminance per convergence tile")
+        .bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource)
+        .format(ResourceFormat::R32Float)
+        .texture2D(sz.x, sz.y)
+        .flags(RenderPassReflection::Field::Flags::Optional);
     return reflector;
 }
 
 void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& renderData)
 {
+    // The optional convergence output is only written while convergence is tracked during accumulation.
+    // It is cleared on all other paths so that it never shows stale tile errors.
+    ref<Texture> pConvergenceMap = renderData.getTexture(kConvergenceChannel);
+    auto clearConvergenceMap = [&]()
+    {
+        if (pConvergenceMap)
+            pRenderContext->clearUAV(pConvergenceMap->getUAV().get(), float4(0.f));
+    };
+
     if (mAutoReset)
     {
         // Query refresh flags passed down from the application and other passes.
@@ -161,6 +233,7 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
         switch (mOverflowMode)
         {
         case OverflowMode::Stop:
+            clearConvergenceMap();
             return;
         case OverflowMode::Reset:
             reset();
@@ -170,6 +243,17 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
         }
     }
 
+    // Stop accumulation once converged. The result lags a few frames behind, so a few more frames may be accumulated.
+    if (mTrackConvergence && mStopOnConvergence && mEnabled)
+    {
+        readConvergence(false);
+        if (mConvergenceResult.converged)
+        {
+            clearConvergenceMap();
+            return;
+        }
+    }
+
     // Grab our input/output buffers.
     ref<Texture> pSrc = renderData.getTexture(kInputChannel);
     ref<Texture> pDst = renderData.getTexture(kOutputChannel);
@@ -205,15 +289,21 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
     {
         // Only blit mip 0 and array slice 0, because that's what the accumulation uses otherwise.
         pRenderContext->blit(pSrc->getSRV(0, 1, 0, 1), pDst->getRTV(0, 0, 1));
+        clearConvergenceMap();
     }
     else if (resolutionMatch)
     {
         accumulate(pRenderContext, pSrc, pDst);
+        if (mEnabled && mTrackConvergence)
+            computeConvergence(pRenderContext, pConvergenceMap);
+        else
+            clearConvergenceMap();
     }
     else
     {
         logWarning("AccumulatePass unsupported I/O configuration. The output will be cleared.");
         pRenderContext->clearUAV(pDst->getUAV().get(), uint4(0));
+        clearConvergenceMap();
     }
 }
 
@@ -275,6 +365,8 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const ref<Texture
     var["gLastFrameCorr"] = mpLastFrameCorr;
     var["gLastFrameSumLo"] = mpLastFrameSumLo;
     var["gLastFrameSumHi"] = mpLastFrameSumHi;
+    var["PerFrameCB"]["gTrackConvergence"] = mTrackConvergence;
+    var["gConvergenceState"] = mpConvergenceState;
 
     // Update the frame count.
     // The accumulation limit (mMaxFrameCount) has a special value of 0 (no limit) and is not supported in the SingleCompensated mode.
@@ -291,6 +383,80 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const ref<Texture
     pRenderContext->dispatch(mpState.get(), mpVars.get(), numGroups);
 }
 
+void AccumulatePass::computeConvergence(RenderContext* pRenderContext, const ref<Texture>& pConvergenceMap)
+{
+    FALCOR_ASSERT(mpConvergenceState);
+
+    const uint2 tileCount = getConvergenceTileCount();
+    const uint32_t tileErrorsSize = tileCount.x * tileCount.y * sizeof(float);
+
+    if (!mpConvergencePass)
+        mpConvergencePass = ComputePass::create(mpDevice, kConvergenceShaderFile, "main");
+
+    // (Re-)create the tile errors and the readback ring when the tile count changes.
+    if (!mpTileErrors || mpTileErrors->getSize() != tileErrorsSize)
+    {
+        mpTileErrors = mpDevice->createStructuredBuffer(
+            sizeof(float),
+            tileCount.x * tileCount.y,
+            ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
+            MemoryType::DeviceLocal,
+            nullptr,
+            false
+        );
+        mpConvergenceReadback = ReadbackRing::create(mpDevice, tileErrorsSize);
+    }
+
+    auto var = mpConvergencePass->getRootVar();
+    var["CB"]["gResolution"] = mFrameDim;
+    var["CB"]["gTileCount"] = tileCount;
+    var["CB"]["gTileSize"] = mConvergenceTileSize;
+    var["CB"]["gSampleCount"] = mFrameCount;
+    var["CB"]["gMinLuminance"] = mConvergenceCriteria.minLuminance;
+    var["CB"]["gWriteMap"] = pConvergenceMap != nullptr;
+    var["gConvergenceState"] = mpConvergenceState;
+    var["gTileErrors"] = mpTileErrors;
+    var["gConvergenceMap"] = pConvergenceMap;
+
+    // One thread group per tile.
+    mpConvergencePass->execute(pRenderContext, uint3(tileCount * mpConvergencePass->getThreadGroupSize().xy(), 1));
+
+    // Tag the result with the frame count, as accumulation may be reset before it is read back.
+    if (mpConvergenceReadback->beginWrite())
+    {
+        pRenderContext->copyBufferRegion(
+            mpConvergenceReadback->getBuffer().get(), mpConvergenceReadback->getWriteOffset(), mpTileErrors.get(), 0, tileErrorsSize
+        );
+        mpConvergenceReadback->endWrite(pRenderContext, mFrameCount);
+    }
+}
+
+void AccumulatePass::readConvergence(bool wait)
+{
+    if (!mpConvergenceReadback)
+        return;
+
+    std::vector<float> tileErrors(mpConvergenceReadback->getSlotSize() / sizeof(float));
+    uint64_t frameCount = 0;
+    if (mpConvergenceReadback->readLatest(tileErrors.data(), wait, &frameCount))
+    {
+        mTileErrors = std::move(tileErrors);
+        mConvergenceResult = ConvergenceStats::evaluate(mTileErrors, (uint32_t)frameCount, mConvergenceCriteria);
+    }
+}
+
+const ConvergenceResult& AccumulatePass::getConvergenceResult(bool wait)
+{
+    readConvergence(wait);
+    return mConvergenceResult;
+}
+
+const std::vector<float>& AccumulatePass::getConvergenceMap(bool wait)
+{
+    readConvergence(wait);
+    return mTileErrors;
+}
+
 void AccumulatePass::renderUI(Gui::Widgets& widget)
 {
     // Controls for output size.
@@ -345,6 +511,43 @@ void AccumulatePass::renderUI(Gui::Widgets& widget)
 
         const std::string text = std::string("Frames accumulated ") + std::to_string(mFrameCount);
         widget.text(text);
+
+        if (widget.checkbox("Track convergence", mTrackConvergence))
+            reset();
+        widget.tooltip(
+            "Estimate the relative error of the accumulated luminance per pixel and combine it into tiles.\n"
+            "Connect the 'convergence' output to view the tile errors."
+        );
+
+        if (mTrackConvergence)
+        {
+            // Changing the tile size or criteria invalidates the current result, so restart accumulation.
+            bool changed = false;
+            changed |= widget.var("Tile size", mConvergenceTileSize, 1u, 256u);
+            changed |= widget.var("Target relative error", mConvergenceCriteria.targetRelError, 0.f, 1.f, 1e-4f);
+            changed |= widget.var("Min frames", mConvergenceCriteria.minFrameCount, 2u);
+            widget.tooltip("Minimum number of frames before the variance estimate is trusted.");
+            changed |= widget.var("Converged tile fraction", mConvergenceCriteria.convergedTileFraction, 0.f, 1.f, 0.01f);
+            widget.tooltip("Fraction of tiles that must reach the target error for the image to be converged.");
+            changed |= widget.var("Min luminance", mConvergenceCriteria.minLuminance, 1e-6f, 1e3f, 1e-4f);
+            widget.tooltip("Lower bound for the mean luminance in the relative error, avoids large errors in dark pixels.");
+            if (changed)
+                reset();
+            widget.checkbox("Stop on convergence", mStopOnConvergence);
+            widget.tooltip("Stop accumulation and retain the accumulated image once converged.");
+
+            readConvergence(false);
+            const ConvergenceResult& result = mConvergenceResult;
+            widget.text(fmt::format(
+                "Converged tiles {}/{} (frame {})\nMax tile error {:.4f}, mean tile error {:.4f}\n{}",
+                result.convergedTileCount,
+                result.tileCount,
+                result.frameCount,
+                result.maxTileError,
+                result.meanTileError,
+                result.converged ? "Converged" : "Not converged"
+            ));
+        }
     }
 }
 
@@ -375,6 +578,12 @@ void AccumulatePass::setEnabled(bool enabled)
 void AccumulatePass::reset()
 {
     mFrameCount = 0;
+
+    // Discard convergence results of the previous accumulation.
+    if (mpConvergenceReadback)
+        mpConvergenceReadback->reset();
+    mTileErrors.clear();
+    mConvergenceResult = {};
 }
 
 void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height)
@@ -413,4 +622,5 @@ void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t
     prepareBuffer(mpLastFrameCorr, ResourceFormat::RGBA32Float, mPrecisionMode == Precision::SingleCompensated);
     prepareBuffer(mpLastFrameSumLo, ResourceFormat::RGBA32Uint, mPrecisionMode == Precision::Double);
     prepareBuffer(mpLastFrameSumHi, ResourceFormat::RGBA32Uint, mPrecisionMode == Precision::Double);
+    prepareBuffer(mpConvergenceState, ResourceFormat::RG32Float, mTrackConvergence);
 }
@@ -29,6 +29,7 @@
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
 #include "RenderGraph/RenderPassHelpers.h"
+#include "Rendering/Utils/ConvergenceStats.h"
 
 using namespace Falcor;
 
@@ -41,6 +42,11 @@ using namespace Falcor;
  * For accumulating many samples for ground truth rendering etc., fp32 precision
  * is not always sufficient. The pass supports higher precision modes using
  * either error compensation (Kahan summation) or double precision math.
+ *
+ * The pass can optionally track convergence: the relative standard error of the
+ * luminance is estimated per pixel and combined into tiles (see ConvergenceStats).
+ * The tile errors are read back asynchronously and evaluated against the
+ * convergence criteria, which lets scripts render until the image has converged.
  */
 class AccumulatePass : public RenderPass
 {
@@ -67,6 +73,21 @@ public:
     // Scripting functions
     void reset();
 
+    /**
+     * Get the convergence state of the accumulated image.
+     * @param[in] wait If true, wait for the tile errors of the last frame. Otherwise the result may lag a few frames behind.
+     */
+    const ConvergenceResult& getConvergenceResult(bool wait = false);
+
+    /**
+     * Get the tile errors of the convergence result.
+     * @param[in] wait If true, wait for the tile errors of the last frame.
+     */
+    const std::vector<float>& getConvergenceMap(bool wait = false);
+
+    /// Get the number of tiles of the convergence map.
+    uint2 getConvergenceTileCount() const { return ConvergenceStats::getTileCount(mFrameDim, mConvergenceTileSize); }
+
     enum class Precision : uint32_t
     {
         Double,            ///< Standard summation in double precision.
@@ -102,6 +123,8 @@ public:
 protected:
     void prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height);
     void accumulate(RenderContext* pRenderContext, const ref<Texture>& pSrc, const ref<Texture>& pDst);
+    void computeConvergence(RenderContext* pRenderContext, const ref<Texture>& pConvergenceMap);
+    void readConvergence(bool wait);
 
     // Internal state
 
@@ -128,6 +151,19 @@ protected:
     ref<Texture> mpLastFrameSumLo;
     /// Last frame running sum (hi bits). Used in Double mode.
     ref<Texture> mpLastFrameSumHi;
+    /// Running mean and variance of the luminance per pixel. Used when convergence tracking is enabled.
+    ref<Texture> mpConvergenceState;
+
+    /// Pass computing the tile errors of the convergence map.
+    ref<ComputePass> mpConvergencePass;
+    /// Tile errors of the current frame.
+    ref<Buffer> mpTileErrors;
+    /// Ring of staging buffers for async readback of the tile errors.
+    ref<ReadbackRing> mpConvergenceReadback;
+    /// Tile errors of the latest convergence result.
+    std::vector<float> mTileErrors;
+    /// Latest convergence result.
+    ConvergenceResult mConvergenceResult;
 
     // UI variables
 
@@ -142,6 +178,15 @@ protected:
     /// What to do after maximum number of frames are accumulated.
     OverflowMode mOverflowMode = OverflowMode::Stop;
 
+    /// Track per-pixel convergence statistics.
+    bool mTrackConvergence = false;
+    /// Tile size in pixels of the convergence map.
+    uint32_t mConvergenceTileSize = 16;
+    /// Criteria for deciding when the image has converged.
+    ConvergenceCriteria mConvergenceCriteria;
+    /// Stop accumulation and retain the accumulated image once converged.
+    bool mStopOnConvergence = false;
+
     /// Output format (uses default when set to ResourceFormat::Unknown).
     ResourceFormat mOutputFormat = ResourceFormat::Unknown;
     /// Selected output size.
@@ -131,7 +131,8 @@ void BSDFOptimizer::initOptimization()
     mCurBSDFParams = mInitBSDFParams;
 
     // Set learning rates and adam optimizer.
-    std::vector<float> lr(mCurBSDFParams.size(), 0.f);
+    // Parameters without a learning rate are not optimized.
+    std::vector<OptimizerParamGroup> groups;
     const auto& pMaterial = mpScene->getMaterial(MaterialID{mParams.initMaterialID});
 
     auto learningRateMap = kLearningRates.find(pMaterial->getType());
@@ -142,13 +143,19 @@ void BSDFOptimizer::initOptimization()
             auto learningRate = learningRateMap->second.find(param.pythonName);
             if (learningRate != learningRateMap->second.end())
             {
-                for (uint32_t i = 0; i < param.size; ++i)
-                    lr[param.offset + i] = learningRate->second;
+                OptimizerParamGroup group;
+                group.offset = param.offset;
+                group.size = param.size;
+                group.learningRate = learningRate->second;
+                groups.push_back(group);
             }
         }
     }
 
-    mAdam = AdamOptimizer(lr);
+    OptimizerConfig config;
+    config.type = OptimizerType::Adam;
+    config.epsilon = 1e-6f;
+    mpOptimizer = std::make_unique<Optimizer>((uint32_t)mCurBSDFParams.size(), config, std::move(groups));
 }
 
 void BSDFOptimizer::setScene(RenderContext* pRenderContext, const ref<Scene>& pScene)
@@ -231,7 +238,9 @@ void BSDFOptimizer::step(RenderContext* pRenderContext)
     pBuffer->getBlob(mBSDFGrads.data(), 0, sizeof(float) * mBSDFGrads.size());
 
     // Update BSDF parameters.
-    mAdam.step(mBSDFGrads, mCurBSDFParams);
+    mpOptimizer->step(
+        fstd::span<const float>(mBSDFGrads.data(), mBSDFGrads.size()), fstd::span<float>(mCurBSDFParams.data(), mCurBSDFParams.size())
+    );
     mpScene->getMaterial(MaterialID(mParams.initMaterialID))->deserializeParams(mCurBSDFParams);
 }
 
@@ -342,34 +351,6 @@ void BSDFOptimizer::renderUI(Gui::Widgets& widget)
     }
 }
 
-void BSDFOptimizer::AdamOptimizer::step(fstd::span<float> dx, fstd::span<float> x)
-{
-    if (lr.size() != dx.size() || lr.size() != x.size())
-    {
-        logError("AdamOptimizer::step(): lr, dx, and x must have the same size.");
-        return;
-    }
-
-    if (m.empty() || v.empty())
-    {
-        m.resize(dx.size(), 0.f);
-        v.resize(dx.size(), 0.f);
-    }
-
-    steps++;
-    for (size_t i = 0; i < dx.size(); i++)
-    {
-        if (lr[i] == 0.f)
-            continue; // Skip parameters with zero learning rate.
-        m[i] = beta1 * m[i] + (1.f - beta1) * dx[i];
-        v[i] = beta2 * v[i] + (1.f - beta2) * dx[i] * dx[i];
-        float mHat = m[i] / (1.f - std::pow(beta1, steps));
-        float vHat = v[i] / (1.f - std::pow(beta2, steps));
-        float delta = lr[i] * mHat / (std::sqrt(vHat) + epsilon);
-        x[i] -= delta;
-    }
-}
-
 // Python bindings.
 
 uint32_t BSDFOptimizer::getBSDFSliceResolution() const
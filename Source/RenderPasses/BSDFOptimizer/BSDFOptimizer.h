@@ -29,9 +29,9 @@
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
 #include "Utils/Sampling/SampleGenerator.h"
+#include "DiffRendering/Optimizer.h"
 #include "DiffRendering/SceneGradients.h"
 #include "BSDFOptimizerParams.slang"
-#include <fstd/span.h>
 
 using namespace Falcor;
 
@@ -69,26 +69,6 @@ private:
     void step(RenderContext* pRenderContext);
     void executeViewerPass(RenderContext* pRenderContext, const RenderData& renderData);
 
-    struct AdamOptimizer
-    {
-        std::vector<float> lr;
-        float beta1;
-        float beta2;
-        float epsilon;
-        int steps;
-
-        std::vector<float> m;
-        std::vector<float> v;
-
-        AdamOptimizer() {}
-
-        AdamOptimizer(fstd::span<float> lr, float beta1 = 0.9f, float beta2 = 0.999f, float epsilon = 1e-6f)
-            : lr(lr.begin(), lr.end()), beta1(beta1), beta2(beta2), epsilon(epsilon), steps(0)
-        {}
-
-        void step(fstd::span<float> dx, fstd::span<float> x);
-    };
-
     // Internal state
     ref<Scene> mpScene; ///< Loaded scene if any, nullptr otherwise.
     std::unique_ptr<SceneGradients> mpSceneGradients;
@@ -98,7 +78,7 @@ private:
 
     SerializedMaterialParams mCurBSDFParams;
     SerializedMaterialParams mBSDFGrads;
-    AdamOptimizer mAdam;
+    std::unique_ptr<Optimizer> mpOptimizer;
 
     /// Parameters shared with the shaders.
     BSDFOptimizerParams mParams;
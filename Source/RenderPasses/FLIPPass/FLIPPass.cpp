@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "FLIPPass.h"
 #include "Utils/Algorithm/ParallelReduction.h"
+#include "Utils/Algorithm/ParallelQuantile.h"
 
 namespace
 {
@@ -75,6 +76,7 @@ FLIPPass::FLIPPass(ref<Device> pDevice, const Properties& props) : RenderPass(pD
 
     // Create parallel reduction helper.
     mpParallelReduction = std::make_unique<ParallelReduction>(mpDevice);
+    mpParallelQuantile = std::make_unique<ParallelQuantile>(mpDevice);
 
     // Fill some reasonable defaults for monitor information.
     mMonitorWidthPixels = 3840;
@@ -204,24 +206,6 @@ static void solveSecondDegree(const float a, const float b, float c, float& xMin
     xMax = d1 + d2;
 }
 
-// At some point, we want to replace this with a compute pass. The BitonicSort needs to be updated so it can handle
-// large amounts of floatintpoint numbers.
-static void computeMedianMax(const float* values, const uint32_t numValues, float& median, float& max)
-{
-    std::vector<float> sortedValues(values, values + numValues);
-    std::sort(sortedValues.begin(), sortedValues.end());
-    if (numValues & 1) // Odd number of values.
-    {
-        median = sortedValues[numValues / 2];
-    }
-    else // Even number of values.
-    {
-        uint32_t medianLocation = numValues / 2 - 1;
-        median = (sortedValues[medianLocation] + sortedValues[medianLocation + 1]) * 0.5f;
-    }
-    max = sortedValues[numValues - 1];
-}
-
 void FLIPPass::computeExposureParameters(const float Ymedian, const float Ymax)
 {
     std::vector<float> tmCoefficients;
@@ -305,10 +289,12 @@ void FLIPPass::execute(RenderContext* pRenderContext, const RenderData& renderDa
         );
     }
 
-    if (!mpLuminance)
+    if (!mpLuminance || mpLuminance->getSize() < outputResolution.x * outputResolution.y * sizeof(float))
     {
         mpLuminance = mpDevice->createBuffer(
-            outputResolution.x * outputResolution.y * sizeof(float), ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal
+            outputResolution.x * outputResolution.y * sizeof(float),
+            ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource,
+            MemoryType::DeviceLocal
         );
     }
 
@@ -346,13 +332,13 @@ void FLIPPass::execute(RenderContext* pRenderContext, const RenderData& renderDa
         rootVar["PerFrameCB"]["gResolution"] = outputResolution;
         // Compute luminance of the reference image.
         mpComputeLuminancePass->execute(pRenderContext, uint3(outputResolution.x, outputResolution.y, 1u));
-        pRenderContext->submit(true);
 
-        float Ymedian, Ymax;
-        std::vector<float> luminanceValues = mpLuminance->getElements<float>(0, outputResolution.x * outputResolution.y);
-        computeMedianMax(luminanceValues.data(), luminanceValues.size(), Ymedian, Ymax);
+        // Compute the median and max luminance on the GPU. Only small histograms are read back.
+        const float quantiles[] = {0.5f, 1.f};
+        float Y[2];
+        mpParallelQuantile->execute(pRenderContext, mpLuminance, outputResolution.x * outputResolution.y, quantiles, Y);
 
-        computeExposureParameters(Ymedian, Ymax);
+        computeExposureParameters(Y[0], Y[1]);
     }
 
     // Compute FLIP error map and exposure map.
@@ -363,17 +349,37 @@ void FLIPPass::execute(RenderContext* pRenderContext, const RenderData& renderDa
     pRenderContext->blit(mpExposureMapDisplay->getSRV(), pExposureMapDisplayOutput->getRTV());
 
     // Compute mean, min, and max using parallel reduction.
+    // The results are read back asynchronously, the displayed values lag a few frames behind.
     if (mComputePooledFLIPValues)
     {
-        float4 FLIPSum, FLIPMinMax[2];
-        mpParallelReduction->execute<float4>(pRenderContext, pErrorMapOutput, ParallelReduction::Type::Sum, &FLIPSum);
-        mpParallelReduction->execute<float4>(pRenderContext, pErrorMapOutput, ParallelReduction::Type::MinMax, &FLIPMinMax[0]);
-        pRenderContext->submit(true);
+        if (!mpPooledFLIPReadback)
+            mpPooledFLIPReadback = ReadbackRing::create(mpDevice, 3 * sizeof(float4));
+
+        if (mpPooledFLIPReadback->beginWrite())
+        {
+            const ref<Buffer>& pBuffer = mpPooledFLIPReadback->getBuffer();
+            uint64_t offset = mpPooledFLIPReadback->getWriteOffset();
+            mpParallelReduction->execute<float4>(pRenderContext, pErrorMapOutput, ParallelReduction::Type::Sum, nullptr, pBuffer, offset);
+            mpParallelReduction->execute<float4>(
+                pRenderContext, pErrorMapOutput, ParallelReduction::Type::MinMax, nullptr, pBuffer, offset + sizeof(float4)
+            );
+            // Tag the result with the pixel count, as the resolution may change before it is read back.
+            mpPooledFLIPReadback->endWrite(pRenderContext, (uint64_t)outputResolution.x * outputResolution.y);
+        }
 
         // Extract metrics from readback values. RGB channels contain magma mapping, and the alpa channel contains FLIP value.
-        mAverageFLIP = FLIPSum.a / (outputResolution.x * outputResolution.y);
-        mMinFLIP = FLIPMinMax[0].a;
-        mMaxFLIP = FLIPMinMax[1].a;
+        float4 FLIPResult[3]; // Sum, min, max.
+        uint64_t pixelCount = 0;
+        if (mpPooledFLIPReadback->readLatest(FLIPResult, false, &pixelCount))
+        {
+            mAverageFLIP = FLIPResult[0].a / pixelCount;
+            mMinFLIP = FLIPResult[1].a;
+            mMaxFLIP = FLIPResult[2].a;
+        }
+    }
+    else
+    {
+        mpPooledFLIPReadback = nullptr;
     }
 }
 
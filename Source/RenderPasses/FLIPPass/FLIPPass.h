@@ -30,6 +30,7 @@
 #include "RenderGraph/RenderPass.h"
 #include "Core/Platform/MonitorInfo.h"
 #include "Utils/Algorithm/ParallelReduction.h"
+#include "Utils/Algorithm/ParallelQuantile.h"
 #include "ToneMappers.slang"
 
 using namespace Falcor;
@@ -107,15 +108,19 @@ private:
     ref<ComputePass> mpComputeLuminancePass;
     /// Helper for parallel reduction on the GPU.
     std::unique_ptr<ParallelReduction> mpParallelReduction;
+    /// Helper for computing the median and max luminance on the GPU.
+    std::unique_ptr<ParallelQuantile> mpParallelQuantile;
+    /// Ring of readback buffers for the pooled FLIP values (sum, min, max), read back without stalling the GPU.
+    ref<ReadbackRing> mpPooledFLIPReadback;
 
     /// Enable to use parallel reduction to compute FLIP mean/min/max across whole frame.
     bool mComputePooledFLIPValues = false;
     /// Average FLIP value across whole frame.
-    float mAverageFLIP;
+    float mAverageFLIP = 0.f;
     /// Minimum FLIP value across whole frame.
-    float mMinFLIP;
+    float mMinFLIP = 0.f;
     /// Maximum FLIP value across whole frame.
-    float mMaxFLIP;
+    float mMaxFLIP = 0.f;
     /// When enabled, user-proided monitor data will be overriden by real monitor data from the OS.
     bool mUseRealMonitorInfo = false;
     /// Recompilation flag.
@@ -151,18 +151,7 @@ void MinimalPathTracer::execute(RenderContext* pRenderContext, const RenderData&
 
     // Specialize program.
     // These defines should not modify the program vars. Do not trigger program vars re-creation.
-    mTracer.pProgram->addDefine("MAX_BOUNCES", std::to_string(mMaxBounces));
-    mTracer.pProgram->addDefine("COMPUTE_DIRECT", mComputeDirect ? "1" : "0");
-    mTracer.pProgram->addDefine("USE_IMPORTANCE_SAMPLING", mUseImportanceSampling ? "1" : "0");
-    mTracer.pProgram->addDefine("USE_ANALYTIC_LIGHTS", mpScene->useAnalyticLights() ? "1" : "0");
-    mTracer.pProgram->addDefine("USE_EMISSIVE_LIGHTS", mpScene->useEmissiveLights() ? "1" : "0");
-    mTracer.pProgram->addDefine("USE_ENV_LIGHT", mpScene->useEnvLight() ? "1" : "0");
-    mTracer.pProgram->addDefine("USE_ENV_BACKGROUND", mpScene->useEnvBackground() ? "1" : "0");
-
-    // For optional I/O resources, set 'is_valid_<name>' defines to inform the program of which ones it can access.
-    // TODO: This should be moved to a more general mechanism using Slang.
-    mTracer.pProgram->addDefines(getValidResourceDefines(kInputChannels, renderData));
-    mTracer.pProgram->addDefines(getValidResourceDefines(kOutputChannels, renderData));
+    mTracer.pProgram->addDefines(getProgramDefines(renderData));
 
     // Prepare program vars. This may trigger shader compilation.
     // The program should have all necessary defines set at this point.
@@ -198,6 +187,30 @@ void MinimalPathTracer::execute(RenderContext* pRenderContext, const RenderData&
     mFrameCount++;
 }
 
+void MinimalPathTracer::collectProgramPermutations(RenderContext* pRenderContext, const RenderData& renderData, std::vector<ProgramPermutation>& permutations)
+{
+    if (!mTracer.pProgram)
+        return;
+
+    // Permutation used by execute(), with the defines and type conformances set in prepareVars().
+    DefineList defines = mTracer.pProgram->getDefines();
+    defines.add(getProgramDefines(renderData));
+    defines.add(mpSampleGenerator->getDefines());
+    TypeConformanceList typeConformances = mpScene->getTypeConformances();
+    permutations.push_back({mTracer.pProgram, defines, typeConformances});
+
+    // Light types can be toggled in the scene render settings at runtime. Add the variants with one light type disabled.
+    for (const char* name : {"USE_ANALYTIC_LIGHTS", "USE_EMISSIVE_LIGHTS", "USE_ENV_LIGHT"})
+    {
+        if (defines[name] == "1")
+        {
+            DefineList variant = defines;
+            variant[name] = "0";
+            permutations.push_back({mTracer.pProgram, variant, typeConformances});
+        }
+    }
+}
+
 void MinimalPathTracer::renderUI(Gui::Widgets& widget)
 {
     bool dirty = false;
@@ -300,6 +313,27 @@ void MinimalPathTracer::setScene(RenderContext* pRenderContext, const ref<Scene>
     }
 }
 
+DefineList MinimalPathTracer::getProgramDefines(const RenderData& renderData) const
+{
+    FALCOR_ASSERT(mpScene);
+
+    DefineList defines;
+    defines.add("MAX_BOUNCES", std::to_string(mMaxBounces));
+    defines.add("COMPUTE_DIRECT", mComputeDirect ? "1" : "0");
+    defines.add("USE_IMPORTANCE_SAMPLING", mUseImportanceSampling ? "1" : "0");
+    defines.add("USE_ANALYTIC_LIGHTS", mpScene->useAnalyticLights() ? "1" : "0");
+    defines.add("USE_EMISSIVE_LIGHTS", mpScene->useEmissiveLights() ? "1" : "0");
+    defines.add("USE_ENV_LIGHT", mpScene->useEnvLight() ? "1" : "0");
+    defines.add("USE_ENV_BACKGROUND", mpScene->useEnvBackground() ? "1" : "0");
+
+    // For optional I/O resources, set 'is_valid_<name>' defines to inform the program of which ones it can access.
+    // TODO: This should be moved to a more general mechanism using Slang.
+    defines.add(getValidResourceDefines(kInputChannels, renderData));
+    defines.add(getValidResourceDefines(kOutputChannels, renderData));
+
+    return defines;
+}
+
 void MinimalPathTracer::prepareVars()
 {
     FALCOR_ASSERT(mpScene);
@@ -59,11 +59,13 @@ public:
     virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
     virtual void renderUI(Gui::Widgets& widget) override;
     virtual void setScene(RenderContext* pRenderContext, const ref<Scene>& pScene) override;
+    virtual void collectProgramPermutations(RenderContext* pRenderContext, const RenderData& renderData, std::vector<ProgramPermutation>& permutations) override;
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
 private:
     void parseProperties(const Properties& props);
+    DefineList getProgramDefines(const RenderData& renderData) const;
     void prepareVars();
 
     // Internal state
@@ -491,6 +491,54 @@ void PathTracer::execute(RenderContext* pRenderContext, const RenderData& render
     endFrame(pRenderContext, renderData);
 }
 
+void PathTracer::collectProgramPermutations(RenderContext* pRenderContext, const RenderData& renderData, std::vector<ProgramPermutation>& permutations)
+{
+    if (mpScene == nullptr || !mEnabled) return;
+
+    // The program defines depend on the light samplers, ReSTIR and the connected outputs.
+    // Prepare them the same way as beginFrame() does, so the reported permutations match the ones used in execute().
+    prepareMaterials(pRenderContext);
+    prepareLighting(pRenderContext);
+    updateOutputFlags(renderData);
+    prepareReSTIRGDI(pRenderContext, renderData);
+
+    auto defines = mStaticParams.getDefines(*this);
+    createPrograms(defines);
+
+    auto addPermutation = [&](const ref<Program>& pProgram, const DefineList& passDefines)
+    {
+        DefineList programDefines = defines;
+        programDefines.add(passDefines);
+        permutations.push_back({ pProgram, programDefines, pProgram->getTypeConformances() });
+    };
+
+    // The trace passes are additionally specialized in tracePass() and by the pixel stats.
+    auto addTracePass = [&](const TracePass& tracePass)
+    {
+        DefineList passDefines = getTracePassDefines(renderData);
+        if (!tracePass.passDefine.empty()) passDefines.add(tracePass.passDefine);
+        if (mpPixelStats->isEnabled()) passDefines.add("_PIXEL_STATS_ENABLED");
+        addPermutation(tracePass.pProgram, passDefines);
+    };
+
+    addTracePass(*mpTracePass);
+    if (mOutputNRDAdditionalData)
+    {
+        addTracePass(*mpTraceDeltaReflectionPass);
+        addTracePass(*mpTraceDeltaTransmissionPass);
+    }
+
+    addPermutation(mpGeneratePaths->getProgram(), getGeneratePathsDefines());
+    addPermutation(mpResolvePass->getProgram(), getResolvePassDefines());
+    addPermutation(mpReflectTypes->getProgram(), {});
+
+    if (mpReSTIRGDI) mpReSTIRGDI->collectProgramPermutations(pRenderContext, permutations);
+
+    // Variants enabled by the pixel debugger are not reported.
+    // The programs are updated with the current defines on the next call to execute().
+    mRecompile = true;
+}
+
 void PathTracer::renderUI(Gui::Widgets& widget)
 {
     bool dirty = false;
@@ -803,26 +851,17 @@ void PathTracer::resetPrograms()
     mRecompile = true;
 }
 
-void PathTracer::updatePrograms()
+void PathTracer::createPrograms(const DefineList& defines)
 {
     FALCOR_ASSERT(mpScene);
 
-    if (mRecompile == false) return;
-
-    // If we get here, a change that require recompilation of shader programs has occurred.
-    // This may be due to change of scene defines, type conformances, shader modules, or other changes that require recompilation.
-    // When type conformances and/or shader modules change, the programs need to be recreated. We assume programs have been reset upon such changes.
-    // When only defines have changed, it is sufficient to update the existing programs and recreate the program vars.
-
-    auto defines = mStaticParams.getDefines(*this);
+    // Create the programs that are missing. This does not compile them.
     auto globalTypeConformances = mpScene->getTypeConformances();
 
     // Create trace pass.
     if (!mpTracePass)
         mpTracePass = std::make_unique<TracePass>(mpDevice, "tracePass", "", mpScene, defines, globalTypeConformances);
 
-    mpTracePass->prepareProgram(mpDevice, defines);
-
     // Create specialized trace passes.
     if (mOutputNRDAdditionalData)
     {
@@ -830,9 +869,6 @@ void PathTracer::updatePrograms()
             mpTraceDeltaReflectionPass = std::make_unique<TracePass>(mpDevice, "traceDeltaReflectionPass", "DELTA_REFLECTION_PASS", mpScene, defines, globalTypeConformances);
         if (!mpTraceDeltaTransmissionPass)
             mpTraceDeltaTransmissionPass = std::make_unique<TracePass>(mpDevice, "traceDeltaTransmissionPass", "DELTA_TRANSMISSION_PASS", mpScene, defines, globalTypeConformances);
-
-        mpTraceDeltaReflectionPass->prepareProgram(mpDevice, defines);
-        mpTraceDeltaTransmissionPass->prepareProgram(mpDevice, defines);
     }
 
     // Create compute passes.
@@ -852,6 +888,30 @@ void PathTracer::updatePrograms()
         desc.addShaderLibrary(kReflectTypesFile).csEntry("main");
         mpReflectTypes = ComputePass::create(mpDevice, desc, defines, false);
     }
+}
+
+void PathTracer::updatePrograms()
+{
+    FALCOR_ASSERT(mpScene);
+
+    if (mRecompile == false) return;
+
+    // If we get here, a change that require recompilation of shader programs has occurred.
+    // This may be due to change of scene defines, type conformances, shader modules, or other changes that require recompilation.
+    // When type conformances and/or shader modules change, the programs need to be recreated. We assume programs have been reset upon such changes.
+    // When only defines have changed, it is sufficient to update the existing programs and recreate the program vars.
+
+    auto defines = mStaticParams.getDefines(*this);
+    createPrograms(defines);
+
+    mpTracePass->prepareProgram(mpDevice, defines);
+
+    // Prepare specialized trace passes.
+    if (mOutputNRDAdditionalData)
+    {
+        mpTraceDeltaReflectionPass->prepareProgram(mpDevice, defines);
+        mpTraceDeltaTransmissionPass->prepareProgram(mpDevice, defines);
+    }
 
     auto preparePass = [&](ref<ComputePass> pass)
     {
@@ -1093,6 +1153,49 @@ void PathTracer::prepareReSTIRGDI(RenderContext* pRenderContext, const RenderDat
     }
 }
 
+void PathTracer::updateOutputFlags(const RenderData& renderData)
+{
+    // Check if fixed sample count should be used. When the sample count input is connected we load the count from there instead.
+    mFixedSampleCount = renderData[kInputSampleCount] == nullptr;
+
+    // Check if guide data should be generated.
+    mOutputGuideData = renderData[kOutputAlbedo] != nullptr || renderData[kOutputSpecularAlbedo] != nullptr
+        || renderData[kOutputIndirectAlbedo] != nullptr || renderData[kOutputGuideNormal] != nullptr
+        || renderData[kOutputReflectionPosW] != nullptr;
+
+    // Check if NRD data should be generated.
+    mOutputNRDData =
+        renderData[kOutputNRDDiffuseRadianceHitDist] != nullptr
+        || renderData[kOutputNRDSpecularRadianceHitDist] != nullptr
+        || renderData[kOutputNRDResidualRadianceHitDist] != nullptr
+        || renderData[kOutputNRDEmission] != nullptr
+        || renderData[kOutputNRDDiffuseReflectance] != nullptr
+        || renderData[kOutputNRDSpecularReflectance] != nullptr;
+
+    // Check if additional NRD data should be generated.
+    bool prevOutputNRDAdditionalData = mOutputNRDAdditionalData;
+    mOutputNRDAdditionalData =
+        renderData[kOutputNRDDeltaReflectionRadianceHitDist] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionRadianceHitDist] != nullptr
+        || renderData[kOutputNRDDeltaReflectionReflectance] != nullptr
+        || renderData[kOutputNRDDeltaReflectionEmission] != nullptr
+        || renderData[kOutputNRDDeltaReflectionNormWRoughMaterialID] != nullptr
+        || renderData[kOutputNRDDeltaReflectionPathLength] != nullptr
+        || renderData[kOutputNRDDeltaReflectionHitDist] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionReflectance] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionEmission] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionNormWRoughMaterialID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionPathLength] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionPosW] != nullptr;
+    if (mOutputNRDAdditionalData != prevOutputNRDAdditionalData) mRecompile = true;
+
+    // Enable pixel stats if rayCount or pathLength outputs are connected.
+    if (renderData[kOutputRayCount] != nullptr || renderData[kOutputPathLength] != nullptr)
+    {
+        mpPixelStats->setEnabled(true);
+    }
+}
+
 void PathTracer::setNRDData(const ShaderVar& var, const RenderData& renderData) const
 {
     var["sampleRadiance"] = mpSampleNRDRadiance;
@@ -1251,45 +1354,7 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
             mParams.filterNorm);
     }
 
-    // Check if fixed sample count should be used. When the sample count input is connected we load the count from there instead.
-    mFixedSampleCount = renderData[kInputSampleCount] == nullptr;
-
-    // Check if guide data should be generated.
-    mOutputGuideData = renderData[kOutputAlbedo] != nullptr || renderData[kOutputSpecularAlbedo] != nullptr
-        || renderData[kOutputIndirectAlbedo] != nullptr || renderData[kOutputGuideNormal] != nullptr
-        || renderData[kOutputReflectionPosW] != nullptr;
-
-    // Check if NRD data should be generated.
-    mOutputNRDData =
-        renderData[kOutputNRDDiffuseRadianceHitDist] != nullptr
-        || renderData[kOutputNRDSpecularRadianceHitDist] != nullptr
-        || renderData[kOutputNRDResidualRadianceHitDist] != nullptr
-        || renderData[kOutputNRDEmission] != nullptr
-        || renderData[kOutputNRDDiffuseReflectance] != nullptr
-        || renderData[kOutputNRDSpecularReflectance] != nullptr;
-
-    // Check if additional NRD data should be generated.
-    bool prevOutputNRDAdditionalData = mOutputNRDAdditionalData;
-    mOutputNRDAdditionalData =
-        renderData[kOutputNRDDeltaReflectionRadianceHitDist] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionRadianceHitDist] != nullptr
-        || renderData[kOutputNRDDeltaReflectionReflectance] != nullptr
-        || renderData[kOutputNRDDeltaReflectionEmission] != nullptr
-        || renderData[kOutputNRDDeltaReflectionNormWRoughMaterialID] != nullptr
-        || renderData[kOutputNRDDeltaReflectionPathLength] != nullptr
-        || renderData[kOutputNRDDeltaReflectionHitDist] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionReflectance] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionEmission] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionNormWRoughMaterialID] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionPathLength] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionPosW] != nullptr;
-    if (mOutputNRDAdditionalData != prevOutputNRDAdditionalData) mRecompile = true;
-
-    // Enable pixel stats if rayCount or pathLength outputs are connected.
-    if (renderData[kOutputRayCount] != nullptr || renderData[kOutputPathLength] != nullptr)
-    {
-        mpPixelStats->setEnabled(true);
-    }
+    updateOutputFlags(renderData);
 
     mpPixelStats->beginFrame(pRenderContext, mParams.frameDim);
     mpPixelDebug->beginFrame(pRenderContext, mParams.frameDim);
@@ -1346,10 +1411,7 @@ void PathTracer::generatePaths(RenderContext* pRenderContext, const RenderData&
     FALCOR_ASSERT(mpGeneratePaths->getThreadGroupSize().y == 1 && mpGeneratePaths->getThreadGroupSize().z == 1);
 
     // Additional specialization. This shouldn't change resource declarations.
-    mpGeneratePaths->addDefine("USE_VIEW_DIR", mStaticParams.useViewDir ? "1" : "0");
-    mpGeneratePaths->addDefine("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
-    mpGeneratePaths->addDefine("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
-    mpGeneratePaths->addDefine("OUTPUT_NRD_ADDITIONAL_DATA", mOutputNRDAdditionalData ? "1" : "0");
+    mpGeneratePaths->getProgram()->addDefines(getGeneratePathsDefines());
 
     // Bind resources.
     auto var = mpGeneratePaths->getRootVar()["CB"]["gPathGenerator"];
@@ -1376,10 +1438,7 @@ void PathTracer::tracePass(RenderContext* pRenderContext, const RenderData& rend
     FALCOR_ASSERT(tracePass.pProgram != nullptr && tracePass.pBindingTable != nullptr && tracePass.pVars != nullptr);
 
     // Additional specialization. This shouldn't change resource declarations.
-    tracePass.pProgram->addDefine("USE_VIEW_DIR", (mpScene->getCamera()->getApertureRadius() > 0 && renderData[kInputViewDir] != nullptr) ? "1" : "0");
-    tracePass.pProgram->addDefine("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
-    tracePass.pProgram->addDefine("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
-    tracePass.pProgram->addDefine("OUTPUT_NRD_ADDITIONAL_DATA", mOutputNRDAdditionalData ? "1" : "0");
+    tracePass.pProgram->addDefines(getTracePassDefines(renderData));
 
     // Bind global resources.
     auto var = tracePass.pVars->getRootVar();
@@ -1415,8 +1474,7 @@ void PathTracer::resolvePass(RenderContext* pRenderContext, const RenderData& re
     // locate the samples for each pixel.
 
     // Additional specialization. This shouldn't change resource declarations.
-    mpResolvePass->addDefine("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
-    mpResolvePass->addDefine("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
+    mpResolvePass->getProgram()->addDefines(getResolvePassDefines());
 
     // Bind resources.
     auto var = mpResolvePass->getRootVar()["CB"]["gResolvePass"];
@@ -1457,6 +1515,34 @@ void PathTracer::resolvePass(RenderContext* pRenderContext, const RenderData& re
     mpResolvePass->execute(pRenderContext, { mParams.frameDim, 1u });
 }
 
+DefineList PathTracer::getGeneratePathsDefines() const
+{
+    DefineList defines;
+    defines.add("USE_VIEW_DIR", mStaticParams.useViewDir ? "1" : "0");
+    defines.add("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
+    defines.add("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
+    defines.add("OUTPUT_NRD_ADDITIONAL_DATA", mOutputNRDAdditionalData ? "1" : "0");
+    return defines;
+}
+
+DefineList PathTracer::getTracePassDefines(const RenderData& renderData) const
+{
+    DefineList defines;
+    defines.add("USE_VIEW_DIR", (mpScene->getCamera()->getApertureRadius() > 0 && renderData[kInputViewDir] != nullptr) ? "1" : "0");
+    defines.add("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
+    defines.add("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
+    defines.add("OUTPUT_NRD_ADDITIONAL_DATA", mOutputNRDAdditionalData ? "1" : "0");
+    return defines;
+}
+
+DefineList PathTracer::getResolvePassDefines() const
+{
+    DefineList defines;
+    defines.add("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
+    defines.add("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
+    return defines;
+}
+
 DefineList PathTracer::StaticParams::getDefines(const PathTracer& owner) const
 {
     DefineList defines;
@@ -59,6 +59,7 @@ public:
     virtual RenderPassReflection reflect(const CompileData& compileData) override;
     virtual void setScene(RenderContext* pRenderContext, const ref<Scene>& pScene) override;
     virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
+    virtual void collectProgramPermutations(RenderContext* pRenderContext, const RenderData& renderData, std::vector<ProgramPermutation>& permutations) override;
     virtual void renderUI(Gui::Widgets& widget) override;
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override;
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override;
@@ -85,6 +86,7 @@ private:
     void parseProperties(const Properties& props);
     void validateOptions();
     void resetPrograms();
+    void createPrograms(const DefineList& defines);
     void updatePrograms();
     void setFrameDim(const uint2 frameDim);
     void prepareResources(RenderContext* pRenderContext, const RenderData& renderData);
@@ -93,6 +95,7 @@ private:
     void prepareMaterials(RenderContext* pRenderContext);
     bool prepareLighting(RenderContext* pRenderContext);
     void prepareReSTIRGDI(RenderContext* pRenderContext, const RenderData& renderData);
+    void updateOutputFlags(const RenderData& renderData);
     void setNRDData(const ShaderVar& var, const RenderData& renderData) const;
     void bindShaderData(const ShaderVar& var, const RenderData& renderData, bool useLightSampling = true) const;
     bool renderRenderingUI(Gui::Widgets& widget);
@@ -103,6 +106,9 @@ private:
     void generatePaths(RenderContext* pRenderContext, const RenderData& renderData);
     void tracePass(RenderContext* pRenderContext, const RenderData& renderData, TracePass& tracePass);
     void resolvePass(RenderContext* pRenderContext, const RenderData& renderData);
+    DefineList getGeneratePathsDefines() const;
+    DefineList getTracePassDefines(const RenderData& renderData) const;
+    DefineList getResolvePassDefines() const;
 
     /** Static configuration. Changing any of these options require shader recompilation.
     */
@@ -27,6 +27,15 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Core/Object.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+// The binding benchmark is disabled by default as it binds 64 textures for 1024 frames and only logs timings.
+// ShaderVar_BindMovesReferences checks the reference counting of the binding path in every run.
+// #define RUN_SHADER_VAR_BINDING_BENCHMARK
 
 namespace Falcor
 {
@@ -172,4 +181,134 @@ CPU_TEST(Object_BreakableReference)
     }
 }
 
+#if FALCOR_ENABLE_REF_COUNT_STATS
+CPU_TEST(Object_RefCountStats)
+{
+    auto start = Object::getThreadRefCountStats();
+    auto globalStart = Object::getRefCountStats();
+    {
+        ref<DummyObject> r1 = make_ref<DummyObject>(); // +1 inc
+        ref<DummyObject> r2 = r1;                      // +1 inc
+        ref<DummyObject> r3 = std::move(r2);           // no-op
+        r1 = nullptr;                                  // +1 dec
+    }                                                  // +1 dec
+    auto stats = Object::getThreadRefCountStats() - start;
+    auto globalStats = Object::getRefCountStats() - globalStart;
+
+    // The thread statistics are exact, the global statistics include operations of other threads.
+    EXPECT_EQ(stats.incRefCount, 2);
+    EXPECT_EQ(stats.decRefCount, 2);
+    EXPECT_EQ(stats.getTotal(), 4);
+    EXPECT_GE(globalStats.incRefCount, 2);
+    EXPECT_GE(globalStats.decRefCount, 2);
+
+    // Operations of exited threads are retained.
+    std::thread([]() { ref<DummyObject> r = make_ref<DummyObject>(); }).join();
+    auto joinedStats = Object::getRefCountStats() - globalStart;
+    EXPECT_GE(joinedStats.incRefCount, 3);
+    EXPECT_GE(joinedStats.decRefCount, 3);
+    EXPECT_EQ((Object::getThreadRefCountStats() - start).getTotal(), 4);
+}
+#endif
+
+GPU_TEST(ShaderVar_BindMovesReferences)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ref<Texture> pTexture = pDevice->createTexture2D(1, 1, ResourceFormat::RGBA8Unorm, 1, 1, nullptr, ResourceBindFlags::ShaderResource);
+
+    ctx.createProgram("Tests/Core/ObjectTests.cs.slang", "main", DefineList{{"TEXTURE_COUNT", "1"}});
+    ShaderVar var = ctx["gTextures"][0];
+
+    // Bind once so that the views are created before measuring.
+    var = pTexture;
+    const int refCount = pTexture->refCount();
+
+    // Binding a temporary moves it into the parameter block.
+    ref<Texture> pTemp = pTexture;
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    auto start = Object::getThreadRefCountStats();
+#endif
+    var = std::move(pTemp);
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    auto rvalueStats = Object::getThreadRefCountStats() - start;
+#endif
+    EXPECT(pTemp == nullptr);
+    EXPECT_EQ(pTexture->refCount(), refCount);
+
+    // Binding an existing reference copies it.
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    start = Object::getThreadRefCountStats();
+#endif
+    var = pTexture;
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    auto lvalueStats = Object::getThreadRefCountStats() - start;
+#endif
+    EXPECT_EQ(pTexture->refCount(), refCount);
+    EXPECT(var.getTexture() == pTexture);
+
+#if FALCOR_ENABLE_REF_COUNT_STATS
+    // Both bindings release the previously bound reference and look up the same views.
+    // The only difference is the copy of the bound reference.
+    EXPECT_EQ(lvalueStats.incRefCount, rvalueStats.incRefCount + 1);
+    EXPECT_EQ(lvalueStats.decRefCount, rvalueStats.decRefCount);
+#endif
+}
+
+#ifdef RUN_SHADER_VAR_BINDING_BENCHMARK
+GPU_TEST(ShaderVar_BindingBenchmark)
+#else
+GPU_TEST(ShaderVar_BindingBenchmark, "Disabled for performance reasons")
+#endif
+{
+    // Simulate the binding path of a frame: bind a list of textures to a shader variable each frame,
+    // once from existing references and once from temporaries (e.g. returned by RenderData::getTexture()).
+    ref<Device> pDevice = ctx.getDevice();
+    const uint32_t textureCount = 64;
+    const uint32_t frameCount = 1024;
+
+    std::vector<ref<Texture>> textures(textureCount);
+    for (auto& pTexture : textures)
+        pTexture = pDevice->createTexture2D(1, 1, ResourceFormat::RGBA8Unorm, 1, 1, nullptr, ResourceBindFlags::ShaderResource);
+
+    DefineList defines = {{"TEXTURE_COUNT", std::to_string(textureCount)}};
+    ctx.createProgram("Tests/Core/ObjectTests.cs.slang", "main", defines);
+    ShaderVar var = ctx["gTextures"];
+
+    auto run = [&](auto&& bind)
+    {
+#if FALCOR_ENABLE_REF_COUNT_STATS
+        auto startStats = Object::getThreadRefCountStats();
+#endif
+        auto t0 = CpuTimer::getCurrentTimePoint();
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            for (uint32_t i = 0; i < textureCount; ++i)
+                bind(var[i], i);
+        }
+        auto t1 = CpuTimer::getCurrentTimePoint();
+#if FALCOR_ENABLE_REF_COUNT_STATS
+        uint64_t ops = (Object::getThreadRefCountStats() - startStats).getTotal() / frameCount;
+#else
+        uint64_t ops = 0;
+#endif
+        return std::make_pair(CpuTimer::calcDuration(t0, t1), ops);
+    };
+
+    auto [lvalueTime, lvalueOps] = run([&](const ShaderVar& v, uint32_t i) { v = textures[i]; });
+    auto [rvalueTime, rvalueOps] = run([&](const ShaderVar& v, uint32_t i) { v = ref<Texture>(textures[i]); });
+
+    for (uint32_t i = 0; i < textureCount; ++i)
+        EXPECT(var[i].getTexture() == textures[i]);
+
+    logInfo(
+        "Binding {} textures x {} frames: references {:.2f} ms ({} ref count ops/frame), temporaries {:.2f} ms ({} ops/frame).",
+        textureCount,
+        frameCount,
+        lvalueTime,
+        lvalueOps,
+        rvalueTime,
+        rvalueOps
+    );
+}
+
 } // namespace Falcor
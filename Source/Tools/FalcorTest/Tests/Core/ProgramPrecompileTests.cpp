@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramManager.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Tests/Core/ProgramPrecompileTests.cs.slang";
+const uint32_t kElementCount = 32;
+} // namespace
+
+GPU_TEST(ProgramPrecompile)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ProgramManager* pProgramManager = pDevice->getProgramManager();
+
+    ref<Program> pProgram = Program::createCompute(pDevice, kShaderFile, "main");
+
+    std::vector<ProgramPermutation> permutations;
+    for (uint32_t value = 1; value <= 4; ++value)
+        permutations.push_back({pProgram, {{"VALUE", std::to_string(value)}}, {}});
+    permutations.push_back({pProgram, {{"VALUE", "2"}}, {}});
+    permutations.push_back({pProgram, {{"VALUE", "1"}, {"FAIL", "1"}}, {}});
+
+    pProgramManager->resetCompilationStats();
+    auto results = pProgramManager->precompilePrograms(permutations, 2);
+    ASSERT_EQ(results.size(), permutations.size());
+
+    // Duplicates are compiled once, failures are reported.
+    for (size_t i = 0; i < 5; ++i)
+    {
+        EXPECT(results[i].success);
+        EXPECT(!results[i].alreadyCompiled);
+        EXPECT(results[i].defines == permutations[i].defines);
+    }
+    EXPECT(!results[5].success);
+    EXPECT(!results[5].log.empty());
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, 4);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programKernelsCount, 4);
+
+    // Switching to a precompiled permutation does not compile, and the program computes the expected results.
+    auto pState = ComputeState::create(pDevice);
+    pState->setProgram(pProgram);
+    auto pBuffer = pDevice->createStructuredBuffer(sizeof(uint32_t), kElementCount, ResourceBindFlags::UnorderedAccess);
+    for (uint32_t value = 1; value <= 4; ++value)
+    {
+        pProgram->setDefines({{"VALUE", std::to_string(value)}});
+        auto pVars = ProgramVars::create(pDevice, pProgram.get());
+        pVars->getRootVar()["result"] = pBuffer;
+        ctx.getRenderContext()->dispatch(pState.get(), pVars.get(), uint3(1, 1, 1));
+
+        std::vector<uint32_t> result = pBuffer->getElements<uint32_t>();
+        for (uint32_t i = 0; i < kElementCount; ++i)
+            EXPECT_EQ(result[i], i * value) << "i = " << i << ", value = " << value;
+    }
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, 4);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programKernelsCount, 4);
+
+    // Existing versions are skipped.
+    permutations.resize(4);
+    results = pProgramManager->precompilePrograms(permutations);
+    for (const auto& result : results)
+    {
+        EXPECT(result.success);
+        EXPECT(result.alreadyCompiled);
+    }
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, 4);
+}
+} // namespace Falcor
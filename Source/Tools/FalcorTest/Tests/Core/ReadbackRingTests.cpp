@@ -0,0 +1,231 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/API/ReadbackRing.h"
+
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Fence emulating a GPU that completes work on demand.
+struct MockFence
+{
+    uint64_t signaledValue = 0;
+    uint64_t completedValue = 0;
+    uint32_t waitCount = 0;
+
+    uint64_t signal() { return ++signaledValue; }
+    uint64_t getCurrentValue() const { return completedValue; }
+    void wait(uint64_t value)
+    {
+        waitCount++;
+        completedValue = std::max(completedValue, value);
+    }
+    void complete(uint64_t value) { completedValue = std::max(completedValue, value); }
+};
+
+using Slots = ReadbackSlots<MockFence>;
+using SlotState = Slots::SlotState;
+
+/// Acquire a slot and commit it with a new fence value. Returns the slot index.
+uint32_t write(Slots& slots, MockFence& fence, uint64_t tag)
+{
+    uint32_t slot = slots.acquire(fence);
+    if (slot != Slots::kInvalidSlot)
+        slots.commit(slot, fence.signal(), tag);
+    return slot;
+}
+} // namespace
+
+CPU_TEST(ReadbackSlots_LatestAvailable)
+{
+    MockFence fence;
+    Slots slots(3, ReadbackOverflowPolicy::DropOldest);
+
+    // Nothing is available before the fence passes.
+    uint32_t s0 = write(slots, fence, 10);
+    uint32_t s1 = write(slots, fence, 11);
+    EXPECT(slots.getSlotState(s0) == SlotState::Pending);
+    EXPECT_EQ(slots.acquireLatest(fence), Slots::kInvalidSlot);
+
+    // Completing the first write makes it available.
+    fence.complete(1);
+    uint32_t slot = slots.acquireLatest(fence);
+    EXPECT_EQ(slot, s0);
+    EXPECT_EQ(slots.getSlotTag(slot), 10);
+    EXPECT(slots.getSlotState(s0) == SlotState::Free);
+    EXPECT(slots.getSlotState(s1) == SlotState::Pending);
+    EXPECT_EQ(slots.acquireLatest(fence), Slots::kInvalidSlot);
+
+    // When several results are ready, only the newest is returned and the older ones are dropped.
+    write(slots, fence, 12);
+    write(slots, fence, 13);
+    fence.complete(4);
+    slot = slots.acquireLatest(fence);
+    EXPECT_EQ(slots.getSlotTag(slot), 13);
+    EXPECT_EQ(slots.getDroppedCount(), 2);
+    EXPECT_EQ(slots.getReadCount(), 2);
+    for (uint32_t i = 0; i < slots.getSlotCount(); ++i)
+        EXPECT(slots.getSlotState(i) == SlotState::Free);
+    EXPECT_EQ(fence.waitCount, 0);
+}
+
+CPU_TEST(ReadbackSlots_Wait)
+{
+    MockFence fence;
+    Slots slots(2, ReadbackOverflowPolicy::DropOldest);
+
+    write(slots, fence, 1);
+    write(slots, fence, 2);
+
+    // Waiting returns the last written result.
+    uint32_t slot = slots.acquireLatest(fence, true);
+    EXPECT_EQ(slots.getSlotTag(slot), 2);
+    EXPECT_EQ(fence.waitCount, 1);
+    EXPECT_EQ(fence.completedValue, 2);
+
+    // Nothing in flight, waiting does not block.
+    EXPECT_EQ(slots.acquireLatest(fence, true), Slots::kInvalidSlot);
+    EXPECT_EQ(fence.waitCount, 1);
+}
+
+CPU_TEST(ReadbackSlots_OverflowDropOldest)
+{
+    MockFence fence;
+    Slots slots(2, ReadbackOverflowPolicy::DropOldest);
+
+    uint32_t s0 = write(slots, fence, 1);
+    write(slots, fence, 2);
+
+    // All slots are pending, the oldest is reused without waiting.
+    uint32_t s2 = write(slots, fence, 3);
+    EXPECT_EQ(s2, s0);
+    EXPECT_EQ(slots.getDroppedCount(), 1);
+    EXPECT_EQ(fence.waitCount, 0);
+
+    // The reused slot is tagged with the new fence value, so it is not ready when the old value passes.
+    fence.complete(1);
+    EXPECT_EQ(slots.acquireLatest(fence), Slots::kInvalidSlot);
+    fence.complete(2);
+    uint32_t slot = slots.acquireLatest(fence);
+    EXPECT_EQ(slots.getSlotTag(slot), 2);
+    fence.complete(3);
+    slot = slots.acquireLatest(fence);
+    EXPECT_EQ(slots.getSlotTag(slot), 3);
+}
+
+CPU_TEST(ReadbackSlots_OverflowSkipNew)
+{
+    MockFence fence;
+    Slots slots(2, ReadbackOverflowPolicy::SkipNew);
+
+    write(slots, fence, 1);
+    write(slots, fence, 2);
+    uint32_t slot = write(slots, fence, 3);
+    EXPECT_EQ(slot, Slots::kInvalidSlot);
+    EXPECT_EQ(slots.getSkippedCount(), 1);
+    EXPECT_EQ(slots.getDroppedCount(), 0);
+
+    // Ready slots that have not been read are reused before skipping.
+    fence.complete(1);
+    slot = write(slots, fence, 4);
+    EXPECT_NE(slot, Slots::kInvalidSlot);
+    EXPECT_EQ(slots.getSkippedCount(), 1);
+    EXPECT_EQ(slots.getDroppedCount(), 1);
+
+    fence.complete(3);
+    slot = slots.acquireLatest(fence);
+    EXPECT_EQ(slots.getSlotTag(slot), 4);
+}
+
+CPU_TEST(ReadbackSlots_OverflowWait)
+{
+    MockFence fence;
+    Slots slots(2, ReadbackOverflowPolicy::Wait);
+
+    uint32_t s0 = write(slots, fence, 1);
+    write(slots, fence, 2);
+    uint32_t s2 = write(slots, fence, 3);
+    EXPECT_EQ(s2, s0);
+    EXPECT_EQ(fence.waitCount, 1);
+    EXPECT_EQ(fence.completedValue, 1);
+}
+
+CPU_TEST(ReadbackSlots_Reset)
+{
+    MockFence fence;
+    Slots slots(2, ReadbackOverflowPolicy::DropOldest);
+
+    write(slots, fence, 1);
+    slots.reset();
+    fence.complete(1);
+    EXPECT_EQ(slots.acquireLatest(fence), Slots::kInvalidSlot);
+}
+
+CPU_TEST(ReadbackSlots_Random)
+{
+    // Simulate a GPU lagging a random number of frames behind the CPU.
+    // Results must be read in order, never before their fence value has passed.
+    for (auto policy : {ReadbackOverflowPolicy::DropOldest, ReadbackOverflowPolicy::SkipNew, ReadbackOverflowPolicy::Wait})
+    {
+        MockFence fence;
+        Slots slots(3, policy);
+        std::mt19937 rng(1234);
+        uint64_t lastTag = 0;
+        uint64_t writeCount = 0;
+
+        for (uint64_t frame = 1; frame <= 1000; ++frame)
+        {
+            if (write(slots, fence, frame) != Slots::kInvalidSlot)
+                writeCount++;
+
+            uint64_t lag = rng() % 5;
+            if (fence.signaledValue > lag)
+                fence.complete(fence.signaledValue - lag);
+
+            uint32_t slot = slots.acquireLatest(fence, rng() % 50 == 0);
+            if (slot != Slots::kInvalidSlot)
+            {
+                ASSERT_LE(slots.getSlotFenceValue(slot), fence.completedValue);
+                ASSERT_GT(slots.getSlotTag(slot), lastTag);
+                lastTag = slots.getSlotTag(slot);
+            }
+
+            // Every write is either read, dropped or still held in a slot.
+            uint32_t usedCount = 0;
+            for (uint32_t i = 0; i < slots.getSlotCount(); ++i)
+                usedCount += slots.getSlotState(i) != SlotState::Free ? 1 : 0;
+            ASSERT_EQ(writeCount, slots.getReadCount() + slots.getDroppedCount() + usedCount);
+        }
+        EXPECT_EQ(writeCount + slots.getSkippedCount(), 1000);
+        EXPECT_GT(slots.getReadCount(), 0);
+    }
+}
+} // namespace Falcor
@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "DiffRendering/SceneGradients.h"
+#include "Utils/Math/HashUtils.h"
+#include <set>
 
 namespace Falcor
 {
@@ -71,6 +73,78 @@ void testAggregateGradients(GPUUnitTestContext& ctx, const uint32_t hashSize)
         EXPECT_LE(relAbsDiff, 1e-6f);
     }
 }
+
+void testSparseGradients(GPUUnitTestContext& ctx, uint32_t capacity, bool denseMirror)
+{
+    // Scatter 64k unit gradients over 64k of 1M parameters and compare
+    // the sparse and (optional) dense outputs against a CPU reference.
+    const uint32_t gradDim = 1 << 20;
+    const uint32_t updateCount = 1 << 16;
+
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    ref<SceneGradients> pSceneGradients = SceneGradients::createSparse(pDevice, uint2(gradDim, 0), uint2(capacity, 0), denseMirror);
+    EXPECT_EQ(pSceneGradients->getSparseSlotCount(GradientType::Material), SparseGradientTable::getSlotCount(capacity));
+    EXPECT_EQ(pSceneGradients->getSparseSlotCount(GradientType::Geometry), 0);
+    EXPECT(pSceneGradients->isSparse(GradientType::Material));
+    EXPECT(!pSceneGradients->isSparse(GradientType::Geometry));
+    EXPECT_EQ(pSceneGradients->getGradsBuffer(GradientType::Material) != nullptr, denseMirror);
+
+    std::vector<float> reference(gradDim, 0.f);
+    std::set<uint32_t> blocks;
+    for (uint32_t i = 0; i < updateCount; ++i)
+    {
+        uint32_t gradIndex = jenkinsHash(i) % (gradDim / 16);
+        reference[gradIndex] += 1.f;
+        blocks.insert(gradIndex / kSparseGradBlockSize);
+    }
+
+    // Run twice to check that clearing resets the table.
+    for (uint32_t iteration = 0; iteration < 2; ++iteration)
+    {
+        pSceneGradients->clearGrads(pRenderContext, GradientType::Material);
+
+        ctx.createProgram(kShaderFile, "atomicAddScattered");
+        ctx["CB"]["sz"] = uint2(gradDim, updateCount);
+        ctx["CB"]["hashSize"] = 1u;
+        pSceneGradients->bindShaderData(ctx["gSceneGradients"]);
+        ctx.runProgram(updateCount, 1, 1);
+
+        pSceneGradients->aggregateGrads(pRenderContext, GradientType::Material);
+
+        SparseGradients sparse = pSceneGradients->readSparseGrads(GradientType::Material);
+        if (blocks.size() <= SparseGradientTable::getSlotCount(capacity) / 2)
+        {
+            // Enough space, all gradients are kept.
+            EXPECT_EQ(sparse.overflowCount, 0);
+            EXPECT_EQ(sparse.getBlockCount(), blocks.size());
+            EXPECT(sparse.toDense(gradDim) == reference);
+        }
+        else
+        {
+            // Too many blocks, the table is filled and the rest is dropped and counted.
+            EXPECT_GT(sparse.overflowCount, 0);
+            std::vector<float> dense = sparse.toDense(gradDim);
+            double sum = 0.0;
+            for (uint32_t i = 0; i < gradDim; ++i)
+            {
+                EXPECT_LE(dense[i], reference[i]) << "i = " << i;
+                sum += dense[i];
+            }
+            EXPECT_EQ(sum + sparse.overflowCount, updateCount);
+        }
+
+        // The dense mirror matches the coordinate list.
+        if (denseMirror)
+        {
+            std::vector<float> grads = pSceneGradients->getGradsBuffer(GradientType::Material)->getElements<float>();
+            EXPECT(grads == sparse.toDense(gradDim));
+        }
+    }
+
+    EXPECT_LT(pSceneGradients->getTmpMemoryUsage(GradientType::Material), gradDim * sizeof(float));
+}
 } // namespace
 
 // Disabled on Vulkan for now as the compiler generates invalid code.
@@ -78,4 +152,16 @@ GPU_TEST(AggregateGradients, Device::Type::D3D12)
 {
     testAggregateGradients(ctx, 64);
 }
+
+GPU_TEST(SceneGradients_Sparse, Device::Type::D3D12)
+{
+    testSparseGradients(ctx, 1 << 16, false);
+    testSparseGradients(ctx, 1 << 16, true);
+}
+
+GPU_TEST(SceneGradients_SparseOverflow, Device::Type::D3D12)
+{
+    testSparseGradients(ctx, 1 << 10, false);
+    testSparseGradients(ctx, 1 << 10, true);
+}
 } // namespace Falcor
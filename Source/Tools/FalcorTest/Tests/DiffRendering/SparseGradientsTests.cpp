@@ -0,0 +1,197 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "DiffRendering/SparseGradients.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <random>
+#include <set>
+
+// The sparse gradients benchmark is disabled by default as it accumulates 4M updates into a 16M parameter space.
+// Enable it to compare the sparse table against dense accumulation.
+// #define RUN_SPARSE_GRADIENTS_BENCHMARK
+
+namespace Falcor
+{
+namespace
+{
+/// Scattered gradient updates: a few random parameter ranges receiving many updates each.
+struct GradientUpdates
+{
+    std::vector<uint32_t> indices;
+    std::vector<float> values;
+};
+
+GradientUpdates createUpdates(uint32_t gradDim, uint32_t rangeCount, uint32_t rangeSize, uint32_t updateCount, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> rangeStarts(rangeCount);
+    for (auto& start : rangeStarts)
+        start = rng() % (gradDim - rangeSize + 1);
+
+    GradientUpdates updates;
+    std::uniform_real_distribution<float> value(-1.f, 1.f);
+    for (uint32_t i = 0; i < updateCount; ++i)
+    {
+        updates.indices.push_back(rangeStarts[rng() % rangeCount] + rng() % rangeSize);
+        updates.values.push_back(value(rng));
+    }
+    return updates;
+}
+} // namespace
+
+CPU_TEST(SparseGradients_MatchesDense)
+{
+    const uint32_t gradDim = 1 << 20;
+    GradientUpdates updates = createUpdates(gradDim, 500, 16, 100000, 1);
+
+    std::vector<double> reference(gradDim, 0.0);
+    std::set<uint32_t> blocks;
+    SparseGradientTable table(gradDim, 8192);
+    for (size_t i = 0; i < updates.indices.size(); ++i)
+    {
+        reference[updates.indices[i]] += updates.values[i];
+        blocks.insert(updates.indices[i] / kSparseGradBlockSize);
+        EXPECT(table.add(updates.indices[i], updates.values[i]));
+    }
+    EXPECT_EQ(table.getOverflowCount(), 0);
+    EXPECT_EQ(table.getOccupiedSlotCount(), blocks.size());
+
+    SparseGradients sparse = table.compact();
+    ASSERT_EQ(sparse.getBlockCount(), blocks.size());
+    ASSERT_EQ(sparse.values.size(), blocks.size() * kSparseGradBlockSize);
+    EXPECT(std::is_sorted(sparse.blockIndices.begin(), sparse.blockIndices.end()));
+    EXPECT(std::equal(blocks.begin(), blocks.end(), sparse.blockIndices.begin()));
+
+    std::vector<float> dense = sparse.toDense(gradDim);
+    for (uint32_t i = 0; i < gradDim; ++i)
+        ASSERT_LE(std::abs(dense[i] - reference[i]), 1e-4) << "i = " << i;
+
+    // Clearing removes all gradients.
+    table.clear();
+    EXPECT_EQ(table.getOccupiedSlotCount(), 0);
+    EXPECT_EQ(table.compact().getBlockCount(), 0);
+}
+
+CPU_TEST(SparseGradients_Blocks)
+{
+    // Parameters in the same block share a slot, parameters out of range are ignored.
+    SparseGradientTable table(10, 4);
+    EXPECT_EQ(table.getSlotCount(), 4);
+    table.add(0, 1.f);
+    table.add(3, 2.f);
+    table.add(9, 3.f);
+    table.add(9, 1.f);
+    table.add(10, 5.f);
+    EXPECT_EQ(table.getOccupiedSlotCount(), 2);
+
+    SparseGradients sparse = table.compact();
+    ASSERT_EQ(sparse.getBlockCount(), 2);
+    EXPECT_EQ(sparse.blockIndices[0], 0);
+    EXPECT_EQ(sparse.blockIndices[1], 2);
+    std::vector<float> dense = sparse.toDense(10);
+    EXPECT(dense == std::vector<float>({1.f, 0.f, 0.f, 2.f, 0.f, 0.f, 0.f, 0.f, 0.f, 4.f}));
+
+    EXPECT_EQ(SparseGradientTable::getSlotCount(0), 1);
+    EXPECT_EQ(SparseGradientTable::getSlotCount(1000), 1024);
+}
+
+CPU_TEST(SparseGradients_Overflow)
+{
+    // Gradients of blocks that do not fit are dropped and counted, the others remain exact.
+    const uint32_t gradDim = 1000;
+    SparseGradientTable table(gradDim, 16);
+    std::vector<float> reference(gradDim, 0.f);
+    uint32_t dropped = 0;
+    for (uint32_t i = 0; i < gradDim; ++i)
+    {
+        if (table.add(i, 1.f))
+            reference[i] += 1.f;
+        else
+            dropped++;
+    }
+    EXPECT_EQ(table.getOccupiedSlotCount(), 16);
+    EXPECT_EQ(table.getOverflowCount(), dropped);
+    EXPECT_EQ(dropped, gradDim - 16 * kSparseGradBlockSize);
+
+    SparseGradients sparse = table.compact();
+    EXPECT_EQ(sparse.overflowCount, dropped);
+    EXPECT(sparse.toDense(gradDim) == reference);
+}
+
+#ifdef RUN_SPARSE_GRADIENTS_BENCHMARK
+CPU_TEST(SparseGradients_Benchmark)
+#else
+CPU_TEST(SparseGradients_Benchmark, "Disabled for performance reasons")
+#endif
+{
+    // Per-texel gradients of a 2048^2 RGBA texture where 1% of the texels receive gradients.
+    const uint32_t gradDim = 2048 * 2048 * 4;
+    const uint32_t hashSize = 256;
+    const uint32_t touchedBlocks = gradDim / kSparseGradBlockSize / 100;
+    const uint32_t capacity = 2 * touchedBlocks;
+    GradientUpdates updates = createUpdates(gradDim, touchedBlocks / 4, 4 * kSparseGradBlockSize, 4000000, 2);
+
+    // Accumulate into dense gradients (a single copy of the hash grid).
+    auto t0 = CpuTimer::getCurrentTimePoint();
+    std::vector<float> dense(gradDim, 0.f);
+    for (size_t i = 0; i < updates.indices.size(); ++i)
+        dense[updates.indices[i]] += updates.values[i];
+    auto t1 = CpuTimer::getCurrentTimePoint();
+
+    // Accumulate into the sparse table and compact.
+    SparseGradientTable table(gradDim, capacity);
+    for (size_t i = 0; i < updates.indices.size(); ++i)
+        table.add(updates.indices[i], updates.values[i]);
+    SparseGradients sparse = table.compact();
+    auto t2 = CpuTimer::getCurrentTimePoint();
+
+    EXPECT_EQ(sparse.overflowCount, 0);
+    std::vector<float> fromSparse = sparse.toDense(gradDim);
+    for (uint32_t i = 0; i < gradDim; ++i)
+        ASSERT_LE(std::abs(fromSparse[i] - dense[i]), 1e-3f) << "i = " << i;
+
+    uint64_t denseBytes = SparseGradientTable::getDenseMemoryUsage(gradDim, hashSize);
+    uint64_t sparseBytes = SparseGradientTable::getMemoryUsage(capacity);
+    EXPECT_LT(sparseBytes * 100, denseBytes);
+
+    logInfo(
+        "Sparse gradients with {} parameters, {} blocks touched by {} updates: "
+        "temporary memory {:.1f} MB (hash grid with {} copies {:.1f} MB), "
+        "dense accumulation {:.2f} ms, sparse accumulation and compaction {:.2f} ms.",
+        gradDim,
+        sparse.getBlockCount(),
+        updates.indices.size(),
+        sparseBytes / (1024.0 * 1024.0),
+        hashSize,
+        denseBytes / (1024.0 * 1024.0),
+        CpuTimer::calcDuration(t0, t1),
+        CpuTimer::calcDuration(t1, t2)
+    );
+}
+} // namespace Falcor
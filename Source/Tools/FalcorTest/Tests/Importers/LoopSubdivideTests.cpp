@@ -0,0 +1,153 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PBRTImporter/LoopSubdivide.h"
+
+#include <array>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Closed mesh with vertices of valence 4.
+TestMesh createOctahedron()
+{
+    TestMesh mesh;
+    mesh.positions = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    mesh.indices = {0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4, 2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5};
+    return mesh;
+}
+
+/// Open triangulated grid with jittered vertices. Optionally removes random faces, keeping all vertices referenced.
+TestMesh createGrid(uint32_t size, bool holes, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+
+    TestMesh mesh;
+    for (uint32_t y = 0; y <= size; ++y)
+        for (uint32_t x = 0; x <= size; ++x)
+            mesh.positions.push_back(float3(x + jitter(rng), y + jitter(rng), jitter(rng)));
+
+    std::vector<bool> referenced(mesh.positions.size(), false);
+    std::vector<uint32_t> removed;
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            uint32_t i0 = y * (size + 1) + x;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + size + 1;
+            uint32_t i3 = i2 + 1;
+            for (const auto& face : {std::array<uint32_t, 3>{i0, i1, i3}, std::array<uint32_t, 3>{i0, i3, i2}})
+            {
+                auto& target = holes && rng() % 8 == 0 ? removed : mesh.indices;
+                target.insert(target.end(), face.begin(), face.end());
+            }
+        }
+    }
+
+    // Add back removed faces that would leave a vertex unreferenced.
+    for (uint32_t i : mesh.indices)
+        referenced[i] = true;
+    for (size_t f = 0; f < removed.size(); f += 3)
+    {
+        if (!referenced[removed[f]] || !referenced[removed[f + 1]] || !referenced[removed[f + 2]])
+        {
+            for (uint32_t j = 0; j < 3; ++j)
+            {
+                mesh.indices.push_back(removed[f + j]);
+                referenced[removed[f + j]] = true;
+            }
+        }
+    }
+
+    return mesh;
+}
+
+void compare(CPUUnitTestContext& ctx, const TestMesh& mesh, uint32_t levels)
+{
+    auto ref = pbrt::loopSubdivideReference(levels, mesh.positions, mesh.indices);
+    auto res = pbrt::loopSubdivide(levels, mesh.positions, mesh.indices);
+
+    ASSERT_EQ(res.positions.size(), ref.positions.size());
+    ASSERT_EQ(res.normals.size(), ref.normals.size());
+    ASSERT_EQ(res.indices.size(), ref.indices.size());
+
+    // The results are expected to match exactly.
+    for (size_t i = 0; i < ref.positions.size(); ++i)
+    {
+        EXPECT(all(res.positions[i] == ref.positions[i])) << fmt::format("levels={} vertex={}", levels, i);
+        EXPECT(all(res.normals[i] == ref.normals[i])) << fmt::format("levels={} vertex={}", levels, i);
+    }
+    for (size_t i = 0; i < ref.indices.size(); ++i)
+        EXPECT_EQ(res.indices[i], ref.indices[i]) << fmt::format("levels={} index={}", levels, i);
+}
+} // namespace
+
+CPU_TEST(LoopSubdivide_Closed)
+{
+    auto mesh = createOctahedron();
+    for (uint32_t levels = 0; levels <= 4; ++levels)
+        compare(ctx, mesh, levels);
+}
+
+CPU_TEST(LoopSubdivide_Boundary)
+{
+    auto mesh = createGrid(8, false, 1);
+    for (uint32_t levels = 0; levels <= 3; ++levels)
+        compare(ctx, mesh, levels);
+}
+
+CPU_TEST(LoopSubdivide_Holes)
+{
+    for (uint32_t seed = 0; seed < 4; ++seed)
+    {
+        auto mesh = createGrid(12, true, seed);
+        for (uint32_t levels = 0; levels <= 2; ++levels)
+            compare(ctx, mesh, levels);
+    }
+}
+
+CPU_TEST(LoopSubdivide_Counts)
+{
+    // Each level splits every face into four and adds one vertex per edge (V' = V + E, F' = 4F).
+    auto mesh = createOctahedron();
+    auto res = pbrt::loopSubdivide(2, mesh.positions, mesh.indices);
+    EXPECT_EQ(res.indices.size(), 3 * 8 * 16);
+    EXPECT_EQ(res.positions.size(), 66);
+    EXPECT_EQ(res.normals.size(), res.positions.size());
+}
+} // namespace Falcor
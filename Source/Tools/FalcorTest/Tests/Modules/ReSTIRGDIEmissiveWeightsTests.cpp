@@ -0,0 +1,188 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Logger.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include "Utils/Timing/CpuTimer.h"
+#include "ReSTIRGDI/EmissiveLightWeights.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+// The emissive weights benchmark is disabled by default as it builds 2M synthetic triangles and only logs timings.
+// Enable it to compare the incremental weight update against a full rebuild.
+// #define RUN_EMISSIVE_WEIGHTS_BENCHMARK
+
+namespace Falcor
+{
+namespace
+{
+/// Synthetic emissive geometry, as it would be returned by a light collection.
+struct EmissiveGeometry
+{
+    std::vector<MeshLightData> meshLights;
+    std::vector<LightCollection::MeshLightTriangle> triangles;
+};
+
+EmissiveGeometry createEmissiveGeometry(const std::vector<uint32_t>& triangleCounts, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> uniform;
+    EmissiveGeometry geometry;
+    for (uint32_t lightIdx = 0; lightIdx < triangleCounts.size(); ++lightIdx)
+    {
+        MeshLightData meshLight;
+        meshLight.instanceID = lightIdx;
+        meshLight.triangleOffset = (uint32_t)geometry.triangles.size();
+        meshLight.triangleCount = triangleCounts[lightIdx];
+        geometry.meshLights.push_back(meshLight);
+
+        for (uint32_t i = 0; i < triangleCounts[lightIdx]; ++i)
+        {
+            LightCollection::MeshLightTriangle triangle;
+            triangle.lightIdx = lightIdx;
+            triangle.averageRadiance = float3(uniform(rng), uniform(rng), uniform(rng));
+            triangle.area = uniform(rng);
+            geometry.triangles.push_back(triangle);
+        }
+    }
+    return geometry;
+}
+
+/// Move the given mesh lights. This changes the areas of their triangles (e.g. scaling or skinning).
+void moveMeshLights(EmissiveGeometry& geometry, const std::vector<uint32_t>& lightIndices, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> uniform;
+    for (uint32_t lightIdx : lightIndices)
+    {
+        const auto& meshLight = geometry.meshLights[lightIdx];
+        for (uint32_t i = meshLight.triangleOffset; i < meshLight.triangleOffset + meshLight.triangleCount; ++i)
+            geometry.triangles[i].area *= 0.5f + uniform(rng);
+    }
+}
+
+std::vector<float> computeAllWeights(const EmissiveGeometry& geometry)
+{
+    std::vector<float> weights(geometry.triangles.size(), 0.f);
+    EmissiveLightWeights::compute(geometry.triangles, {{0, (uint32_t)geometry.triangles.size()}}, weights);
+    return weights;
+}
+
+bool itemsEqual(const std::vector<AliasTable::Item>& a, const std::vector<AliasTable::Item>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(AliasTable::Item)) == 0;
+}
+} // namespace
+
+CPU_TEST(ReSTIRGDI_EmissiveWeightsUpdate)
+{
+    // Mesh lights of very different sizes, some spanning multiple chunks.
+    std::mt19937 rng(1234);
+    std::vector<uint32_t> triangleCounts;
+    for (uint32_t i = 0; i < 50; ++i)
+        triangleCounts.push_back(1 + rng() % (i % 10 == 0 ? 20000 : 500));
+    EmissiveGeometry geometry = createEmissiveGeometry(triangleCounts, rng);
+
+    std::vector<float> weights = computeAllWeights(geometry);
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        float expected = luminance(geometry.triangles[i].averageRadiance) * geometry.triangles[i].area;
+        EXPECT_LE(std::abs(weights[i] - expected), 1e-6f * expected);
+    }
+
+    // Only the ranges of the updated mesh lights are recomputed. The result must match a full rebuild.
+    const std::vector<uint32_t> updatedLights = {0, 3, 10, 49};
+    moveMeshLights(geometry, updatedLights, rng);
+
+    auto ranges = EmissiveLightWeights::getTriangleRanges(geometry.meshLights, updatedLights);
+    ASSERT_EQ(ranges.size(), updatedLights.size());
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        EXPECT_EQ(ranges[i].offset, geometry.meshLights[updatedLights[i]].triangleOffset);
+        EXPECT_EQ(ranges[i].count, geometry.meshLights[updatedLights[i]].triangleCount);
+    }
+
+    std::vector<float> patchedWeights = weights;
+    EmissiveLightWeights::compute(geometry.triangles, ranges, patchedWeights);
+    std::vector<float> rebuiltWeights = computeAllWeights(geometry);
+    EXPECT(patchedWeights != weights);
+    EXPECT(patchedWeights == rebuiltWeights);
+
+    std::vector<AliasTable::Item> patchedItems, rebuiltItems;
+    EXPECT_EQ(AliasTable::buildItems(patchedWeights, patchedItems), AliasTable::buildItems(rebuiltWeights, rebuiltItems));
+    EXPECT(itemsEqual(patchedItems, rebuiltItems));
+}
+
+#ifdef RUN_EMISSIVE_WEIGHTS_BENCHMARK
+CPU_TEST(ReSTIRGDI_EmissiveWeightsBenchmark)
+#else
+CPU_TEST(ReSTIRGDI_EmissiveWeightsBenchmark, "Disabled for performance reasons")
+#endif
+{
+    // 2M emissive triangles in 2000 mesh lights, of which 1% move every frame.
+    const uint32_t meshCount = 2000;
+    const uint32_t trianglesPerMesh = 1000;
+    const uint32_t movedMeshCount = meshCount / 100;
+
+    std::mt19937 rng(1234);
+    EmissiveGeometry geometry = createEmissiveGeometry(std::vector<uint32_t>(meshCount, trianglesPerMesh), rng);
+    std::vector<float> weights = computeAllWeights(geometry);
+
+    std::vector<uint32_t> updatedLights;
+    for (uint32_t i = 0; i < movedMeshCount; ++i)
+        updatedLights.push_back(i * (meshCount / movedMeshCount));
+    moveMeshLights(geometry, updatedLights, rng);
+
+    // Full rebuild: recompute the weights of all triangles.
+    auto t0 = CpuTimer::getCurrentTimePoint();
+    std::vector<float> rebuiltWeights = computeAllWeights(geometry);
+    auto t1 = CpuTimer::getCurrentTimePoint();
+
+    // Incremental update: recompute the weights of the updated mesh lights only, as ReSTIRGDI does.
+    std::vector<float> patchedWeights = weights;
+    t1 = CpuTimer::getCurrentTimePoint();
+    EmissiveLightWeights::compute(geometry.triangles, EmissiveLightWeights::getTriangleRanges(geometry.meshLights, updatedLights), patchedWeights);
+    auto t2 = CpuTimer::getCurrentTimePoint();
+
+    // Build the table items. This is needed in both cases, as the average weight changes.
+    std::vector<AliasTable::Item> items;
+    AliasTable::buildItems(patchedWeights, items);
+    auto t3 = CpuTimer::getCurrentTimePoint();
+
+    EXPECT(patchedWeights == rebuiltWeights);
+
+    logInfo(
+        "Emissive alias table with {} triangles, {} moved: full weights {:.2f} ms, incremental weights {:.2f} ms, build {:.2f} ms.",
+        geometry.triangles.size(),
+        movedMeshCount * trianglesPerMesh,
+        CpuTimer::calcDuration(t0, t1),
+        CpuTimer::calcDuration(t1, t2),
+        CpuTimer::calcDuration(t2, t3)
+    );
+}
+} // namespace Falcor
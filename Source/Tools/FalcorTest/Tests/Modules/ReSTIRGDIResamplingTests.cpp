@@ -0,0 +1,245 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+#include "ReSTIRGDI/ResamplingReference.h"
+
+#include <cmath>
+#include <random>
+
+// The resampling benchmark is disabled by default as it runs several full frames of the CPU reference.
+// Enable it to measure the throughput of the reference when changing the resampling code.
+// #define RUN_RESAMPLING_REFERENCE_BENCHMARK
+
+namespace Falcor
+{
+namespace
+{
+using Options = ResamplingReference::Options;
+using PairwiseMIS = ResamplingReference::PairwiseMIS;
+
+/// Create a synthetic scene: a bumpy diffuse ground plane with a checkerboard albedo lit by random point lights.
+ResamplingReference createReference(uint2 frameDim, uint32_t lightCount, const Options& options)
+{
+    std::vector<ResamplingReference::Surface> surfaces(frameDim.x * frameDim.y);
+    for (uint32_t y = 0; y < frameDim.y; ++y)
+    {
+        for (uint32_t x = 0; x < frameDim.x; ++x)
+        {
+            auto& surface = surfaces[y * frameDim.x + x];
+            surface.pos = float3(10.f * x / frameDim.x, 10.f * y / frameDim.y, 0.f);
+            surface.normal = normalize(float3(0.5f * std::sin(0.3f * x), 0.5f * std::cos(0.2f * y), 1.f));
+            surface.albedo = ((x / 8 + y / 8) % 2) ? 0.8f : 0.2f;
+            // Leave a few rows of background.
+            surface.valid = y >= 2;
+        }
+    }
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> uniform;
+    std::vector<ResamplingReference::PointLight> lights(lightCount);
+    for (auto& light : lights)
+    {
+        light.pos = float3(12.f * uniform(rng) - 1.f, 12.f * uniform(rng) - 1.f, 0.5f + 2.5f * uniform(rng));
+        light.intensity = 0.1f + 10.f * uniform(rng) * uniform(rng);
+    }
+
+    return ResamplingReference(frameDim, std::move(surfaces), std::move(lights), options);
+}
+
+struct Stats
+{
+    double relativeBias = 0.0; ///< Relative bias of the mean estimate over all frames and pixels.
+    double relativeRMSE = 0.0; ///< Relative RMSE of the per-frame estimates.
+};
+
+/// Run a number of frames and compare the per-pixel estimates to the exact solution.
+Stats runFrames(ResamplingReference& reference, uint32_t frameCount, uint32_t warmupFrameCount)
+{
+    const std::vector<float> exact = reference.evalReference();
+    double exactSum = 0.0;
+    for (float v : exact)
+        exactSum += v;
+
+    double estimateSum = 0.0;
+    double squaredErrorSum = 0.0;
+    for (uint32_t frame = 0; frame < warmupFrameCount + frameCount; ++frame)
+    {
+        reference.execute(frame);
+        if (frame < warmupFrameCount)
+            continue;
+
+        const std::vector<float> estimate = reference.evalEstimate();
+        for (size_t i = 0; i < estimate.size(); ++i)
+        {
+            estimateSum += estimate[i];
+            squaredErrorSum += double(estimate[i] - exact[i]) * (estimate[i] - exact[i]);
+        }
+    }
+
+    const double pixelCount = double(exact.size());
+    Stats stats;
+    stats.relativeBias = (estimateSum / frameCount - exactSum) / exactSum;
+    stats.relativeRMSE = std::sqrt(squaredErrorSum / (frameCount * pixelCount)) / (exactSum / pixelCount);
+    return stats;
+}
+} // namespace
+
+CPU_TEST(ReSTIRGDI_PairwiseMIS)
+{
+    // For any sample, the pairwise MIS weights of the canonical and candidate techniques must sum to one.
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        float mCanonical = 1.f + std::floor(20.f * uniform(rng));
+        float mCandidate = 1.f + std::floor(20.f * uniform(rng));
+        float mSum = mCanonical + mCandidate;
+        float pc = uniform(rng) + 0.01f;
+        float pi = uniform(rng) + 0.01f;
+
+        float nonDefensive = ResamplingReference::pairwiseMISNonDefensiveNonCanonical(mSum, mCandidate, pi, mCanonical, pc) +
+                             ResamplingReference::pairwiseMISNonDefensiveCanonical(mSum, mCandidate, pi, mCanonical, pc);
+        EXPECT_LE(std::abs(nonDefensive - 1.f), 1e-5f);
+
+        float defensive = mCanonical / mSum + ResamplingReference::pairwiseMISDefensiveNonCanonical(mSum, mCandidate, pi, mCanonical, pc) +
+                          ResamplingReference::pairwiseMISDefensiveCanonical(mSum, mCandidate, pi, mCanonical, pc);
+        EXPECT_LE(std::abs(defensive - 1.f), 1e-5f);
+    }
+
+    // Samples with zero target pdf at the canonical surface get zero weight.
+    EXPECT_EQ(ResamplingReference::pairwiseMISDefensiveNonCanonical(2.f, 1.f, 1.f, 1.f, 0.f), 0.f);
+    EXPECT_EQ(ResamplingReference::mFactor(0.f, 1.f), 1.f);
+    EXPECT_EQ(ResamplingReference::mFactor(1.f, 0.5f), std::pow(0.5f, 8.f));
+}
+
+CPU_TEST(ReSTIRGDI_InitialResampling)
+{
+    Options options;
+    options.initialLightSampleCount = 8;
+    options.useTemporalResampling = false;
+    options.useSpatialResampling = false;
+    auto reference = createReference(uint2(64, 64), 32, options);
+
+    // Background pixels keep an empty reservoir with M = 1.
+    reference.execute(0);
+    EXPECT(!reference.getReservoirs()[0].isValid());
+    EXPECT_EQ(reference.getReservoirs()[0].M, 1);
+
+    Stats stats = runFrames(reference, 64, 0);
+    EXPECT_LE(std::abs(stats.relativeBias), 0.01);
+
+    // More initial samples reduce the error.
+    options.initialLightSampleCount = 32;
+    auto reference32 = createReference(uint2(64, 64), 32, options);
+    Stats stats32 = runFrames(reference32, 16, 0);
+    EXPECT_LT(stats32.relativeRMSE, stats.relativeRMSE);
+}
+
+CPU_TEST(ReSTIRGDI_SpatiotemporalResampling)
+{
+    // Initial resampling only as the baseline.
+    Options options;
+    options.initialLightSampleCount = 4;
+    options.useTemporalResampling = false;
+    options.useSpatialResampling = false;
+    auto baseline = createReference(uint2(64, 64), 32, options);
+    Stats baselineStats = runFrames(baseline, 32, 0);
+
+    // The tolerance on the bias accounts for the noise, which is correlated across pixels and frames by the reuse.
+    auto check = [&](const Options& options, const char* name, bool expectUnbiased)
+    {
+        auto reference = createReference(uint2(64, 64), 32, options);
+        Stats stats = runFrames(reference, 64, 8);
+        logInfo("{}: relative bias {:.5f}, relative RMSE {:.4f} (initial only {:.4f}).", name, stats.relativeBias, stats.relativeRMSE, baselineStats.relativeRMSE);
+        if (expectUnbiased)
+            EXPECT_LE(std::abs(stats.relativeBias), 0.02);
+        EXPECT_LT(stats.relativeRMSE, baselineStats.relativeRMSE);
+    };
+
+    options.useTemporalResampling = true;
+    check(options, "Temporal", true);
+
+    options.useSpatialResampling = true;
+    check(options, "Temporal + spatial", true);
+
+    options.spatialIterations = 2;
+    options.rejectNeighborPixelForNormal = true;
+    check(options, "Temporal + 2x spatial, normal rejection", true);
+
+    options.spatialIterations = 1;
+    options.rejectNeighborPixelForNormal = false;
+    options.temporalMIS = PairwiseMIS::Defensive;
+    check(options, "Temporal + spatial, defensive temporal MIS", true);
+
+    // Non-defensive pairwise MIS weights only sum to one for a single candidate.
+    // With several spatial neighbors the result is biased (darker), this is logged for reference.
+    options.temporalMIS = PairwiseMIS::NonDefensive;
+    options.spatialMIS = PairwiseMIS::NonDefensive;
+    check(options, "Temporal + spatial, non-defensive spatial MIS", false);
+
+    // Pixels are processed in parallel, but the result must be deterministic.
+    auto reference0 = createReference(uint2(64, 64), 32, Options());
+    auto reference1 = createReference(uint2(64, 64), 32, Options());
+    for (uint32_t frame = 0; frame < 3; ++frame)
+    {
+        reference0.execute(frame);
+        reference1.execute(frame);
+    }
+    EXPECT(reference0.evalEstimate() == reference1.evalEstimate());
+}
+
+#ifdef RUN_RESAMPLING_REFERENCE_BENCHMARK
+CPU_TEST(ReSTIRGDI_ResamplingBenchmark)
+#else
+CPU_TEST(ReSTIRGDI_ResamplingBenchmark, "Disabled for performance reasons")
+#endif
+{
+    Options options;
+    const uint2 frameDim(256, 256);
+    auto reference = createReference(frameDim, 1024, options);
+
+    const uint32_t frameCount = 8;
+    reference.execute(0);
+    auto t0 = CpuTimer::getCurrentTimePoint();
+    for (uint32_t frame = 1; frame <= frameCount; ++frame)
+        reference.execute(frame);
+    auto t1 = CpuTimer::getCurrentTimePoint();
+
+    double ms = CpuTimer::calcDuration(t0, t1) / frameCount;
+    logInfo(
+        "ReSTIR DI reference at {}x{} with {} initial samples: {:.2f} ms/frame ({:.2f} Mpixels/s).",
+        frameDim.x,
+        frameDim.y,
+        options.initialLightSampleCount,
+        ms,
+        frameDim.x * frameDim.y / (ms * 1e3)
+    );
+}
+} // namespace Falcor
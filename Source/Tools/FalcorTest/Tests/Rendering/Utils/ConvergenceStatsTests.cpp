@@ -0,0 +1,225 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/ConvergenceStats.h"
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+CPU_TEST(ConvergenceStats_RunningVariance)
+{
+    std::mt19937 rng(1);
+    std::normal_distribution<float> dist(2.f, 0.5f);
+
+    std::vector<double> values;
+    float2 state = float2(0.f);
+    for (uint32_t n = 1; n <= 1000; ++n)
+    {
+        float value = dist(rng);
+        values.push_back(value);
+        state = updateRunningVariance(state, value, 1.f / n);
+
+        // Two-pass reference of the mean and population variance.
+        double mean = 0.0;
+        for (double v : values)
+            mean += v;
+        mean /= n;
+        double variance = 0.0;
+        for (double v : values)
+            variance += (v - mean) * (v - mean);
+        variance /= n;
+
+        ASSERT_LE(std::abs(state.x - mean), 1e-4 * mean) << "n = " << n;
+        ASSERT_LE(std::abs(state.y - variance), 1e-3 * 0.25 + 1e-6) << "n = " << n;
+    }
+
+    // With a fixed weight (exponential moving average) the statistics stay bounded.
+    for (uint32_t i = 0; i < 100000; ++i)
+        state = updateRunningVariance(state, dist(rng), 1.f / 100);
+    EXPECT_LE(std::abs(state.x - 2.f), 0.2f);
+    EXPECT_LE(std::abs(state.y - 0.25f), 0.1f);
+}
+
+CPU_TEST(ConvergenceStats_RelativeError)
+{
+    EXPECT_EQ(evalRelativeError(float2(1.f, 1.f), 0, 1e-3f), 0.f);
+    EXPECT_EQ(evalRelativeError(float2(1.f, 1.f), 1, 1e-3f), 0.f);
+    EXPECT_EQ(evalRelativeError(float2(2.f, 4.f), 5, 1e-3f), 0.5f);
+    // Dark pixels are measured against the minimum mean.
+    EXPECT_EQ(evalRelativeError(float2(0.f, 0.f), 5, 1e-3f), 0.f);
+    EXPECT_LE(std::abs(evalRelativeError(float2(0.f, 4e-6f), 5, 1e-3f) - 1.f), 1e-5f);
+
+    // The relative error of pixels with relative standard deviation sigma decreases as sigma / sqrt(n).
+    // Few frames are skipped as the noisy mean in the denominator biases the estimate.
+    const uint2 frameDim(64, 64);
+    const float sigma = 0.5f;
+    ConvergenceStats stats(frameDim, 64);
+    std::mt19937 rng(2);
+    std::normal_distribution<float> dist(1.f, sigma);
+    std::vector<float> frame(frameDim.x * frameDim.y);
+    for (uint32_t n = 1; n <= 256; ++n)
+    {
+        for (auto& v : frame)
+            v = dist(rng);
+        stats.addFrame(frame);
+
+        if (n == 16 || n == 64 || n == 256)
+        {
+            std::vector<float> tileErrors = stats.computeTileErrors(1e-3f);
+            ASSERT_EQ(tileErrors.size(), 1);
+            float expected = sigma / std::sqrt((float)n);
+            EXPECT_LE(std::abs(tileErrors[0] - expected), 0.1f * expected) << "n = " << n;
+        }
+    }
+    EXPECT_EQ(stats.getFrameCount(), 256);
+
+    stats.reset();
+    EXPECT_EQ(stats.getFrameCount(), 0);
+    EXPECT_EQ(stats.computeTileErrors(1e-3f)[0], 0.f);
+}
+
+CPU_TEST(ConvergenceStats_Tiles)
+{
+    // 5x3 frame with 2x2 tiles, the right column and bottom row of tiles are partial.
+    const uint2 frameDim(5, 3);
+    EXPECT(all(ConvergenceStats::getTileCount(frameDim, 2) == uint2(3, 2)));
+    EXPECT(all(ConvergenceStats::getTileCount(frameDim, 5) == uint2(1, 1)));
+
+    std::vector<float> pixelErrors = {
+        1.f, 1.f, 3.f, 4.f, 2.f, //
+        1.f, 1.f, 0.f, 0.f, 0.f, //
+        5.f, 0.f, 1.f, 1.f, 6.f, //
+    };
+    std::vector<float> tileErrors = ConvergenceStats::computeTileErrors(frameDim, 2, pixelErrors);
+    ASSERT_EQ(tileErrors.size(), 6);
+    EXPECT_EQ(tileErrors[0], 1.f);
+    EXPECT_EQ(tileErrors[1], std::sqrt(25.f / 4.f));
+    EXPECT_EQ(tileErrors[2], std::sqrt(4.f / 2.f));
+    EXPECT_EQ(tileErrors[3], std::sqrt(25.f / 2.f));
+    EXPECT_EQ(tileErrors[4], 1.f);
+    EXPECT_EQ(tileErrors[5], 6.f);
+
+    EXPECT_THROW(ConvergenceStats::computeTileErrors(frameDim, 2, fstd::span<const float>(pixelErrors.data(), 14)));
+}
+
+CPU_TEST(ConvergenceStats_Criteria)
+{
+    ConvergenceCriteria criteria;
+    criteria.targetRelError = 0.1f;
+    criteria.minFrameCount = 8;
+    criteria.convergedTileFraction = 0.75f;
+
+    std::vector<float> tileErrors = {0.05f, 0.1f, 0.2f, 0.01f};
+    ConvergenceResult result = ConvergenceStats::evaluate(tileErrors, 8, criteria);
+    EXPECT_EQ(result.frameCount, 8);
+    EXPECT_EQ(result.tileCount, 4);
+    EXPECT_EQ(result.convergedTileCount, 3);
+    EXPECT_EQ(result.maxTileError, 0.2f);
+    EXPECT_LE(std::abs(result.meanTileError - 0.09f), 1e-6f);
+    EXPECT(result.converged);
+
+    // Not enough frames.
+    EXPECT(!ConvergenceStats::evaluate(tileErrors, 7, criteria).converged);
+
+    // Not enough converged tiles.
+    criteria.convergedTileFraction = 1.f;
+    EXPECT(!ConvergenceStats::evaluate(tileErrors, 8, criteria).converged);
+
+    // NaN tiles are never converged.
+    tileErrors = {0.f, std::numeric_limits<float>::quiet_NaN()};
+    EXPECT(!ConvergenceStats::evaluate(tileErrors, 8, criteria).converged);
+
+    // At least two frames are needed to estimate the error.
+    criteria.minFrameCount = 0;
+    tileErrors = {0.f};
+    EXPECT(!ConvergenceStats::evaluate(tileErrors, 1, criteria).converged);
+    EXPECT(ConvergenceStats::evaluate(tileErrors, 2, criteria).converged);
+    EXPECT(!ConvergenceStats::evaluate({}, 2, criteria).converged);
+}
+
+CPU_TEST(ConvergenceStats_StoppingCriterion)
+{
+    // Simulated render with an easy left half (relative standard deviation 0.1) and a hard right half (1.0).
+    // To reach a relative error of 1%, the easy tiles need about 100 frames and the hard tiles about 10000.
+    const uint2 frameDim(32, 16);
+    const uint32_t tileSize = 16;
+    ConvergenceCriteria criteria;
+    criteria.targetRelError = 0.01f;
+
+    ConvergenceStats stats(frameDim, tileSize);
+    std::mt19937 rng(3);
+    std::normal_distribution<float> easy(1.f, 0.1f);
+    std::exponential_distribution<float> hard(1.f);
+
+    std::vector<float> frame(frameDim.x * frameDim.y);
+    std::vector<double> sums(frame.size(), 0.0);
+    uint32_t easyConvergedFrame = 0;
+    ConvergenceResult result;
+    while (stats.getFrameCount() < 20000)
+    {
+        for (uint32_t y = 0; y < frameDim.y; ++y)
+        {
+            for (uint32_t x = 0; x < frameDim.x; ++x)
+            {
+                uint32_t i = y * frameDim.x + x;
+                frame[i] = x < frameDim.x / 2 ? easy(rng) : hard(rng);
+                sums[i] += frame[i];
+            }
+        }
+        stats.addFrame(frame);
+
+        result = stats.evaluate(criteria);
+        if (easyConvergedFrame == 0 && result.frameCount >= criteria.minFrameCount && result.convergedTileCount > 0)
+        {
+            EXPECT_EQ(result.convergedTileCount, 1);
+            easyConvergedFrame = result.frameCount;
+        }
+        if (result.converged)
+            break;
+    }
+
+    ASSERT(result.converged);
+    EXPECT_EQ(result.convergedTileCount, 2);
+    EXPECT_GE(easyConvergedFrame, 80);
+    EXPECT_LE(easyConvergedFrame, 125);
+    EXPECT_GE(result.frameCount, 8000);
+    EXPECT_LE(result.frameCount, 12500);
+
+    // The actual error of the accumulated mean is close to the target.
+    double sumSq = 0.0;
+    for (uint32_t i = 0; i < frame.size(); ++i)
+    {
+        double error = sums[i] / result.frameCount - 1.0;
+        sumSq += error * error;
+    }
+    double rmsError = std::sqrt(sumSq / frame.size());
+    EXPECT_LE(rmsError, 1.5 * criteria.targetRelError);
+}
+} // namespace Falcor
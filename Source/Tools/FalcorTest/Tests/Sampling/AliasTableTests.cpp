@@ -30,6 +30,7 @@
 
 #include <hypothesis/hypothesis.h>
 
+#include <cstring>
 #include <iostream>
 
 namespace Falcor
@@ -137,8 +138,75 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
         }
     }
 }
+
+/// Check that the table items select each element with a probability proportional to its weight.
+void checkAliasTableItems(CPUUnitTestContext& ctx, const std::vector<float>& weights, const std::vector<AliasTable::Item>& items, double weightSum)
+{
+    const size_t N = weights.size();
+    ASSERT_EQ(items.size(), N);
+
+    // Each element is picked with probability 1/N through its own item and can receive more through redirects.
+    std::vector<double> probabilities(N, 0.0);
+    std::vector<uint32_t> indexBCount(N, 0);
+    for (const auto& item : items)
+    {
+        ASSERT_LT(item.indexA, N);
+        ASSERT_LT(item.indexB, N);
+        probabilities[item.indexB] += item.threshold / N;
+        probabilities[item.indexA] += (1.0 - item.threshold) / N;
+        indexBCount[item.indexB]++;
+    }
+
+    // The residual weights are tracked in single precision, so individual probabilities drift slightly.
+    // Check the total variation distance to the target distribution instead.
+    double distance = 0.0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        EXPECT_EQ(indexBCount[i], 1);
+        distance += std::abs(probabilities[i] - weights[i] / weightSum);
+    }
+    EXPECT_LE(0.5 * distance, 1e-5);
+}
 } // namespace
 
+CPU_TEST(AliasTable_BuildItems)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform;
+
+    // Use enough weights to span multiple chunks, with a few zeros and a few large weights.
+    const uint32_t N = 200000;
+    std::vector<float> weights(N);
+    for (uint32_t i = 0; i < N; ++i)
+        weights[i] = uniform(rng);
+    for (uint32_t i = 0; i < N / 100; ++i)
+        weights[rng() % N] = 0.f;
+    for (uint32_t i = 0; i < 10; ++i)
+        weights[rng() % N] = 10.f;
+
+    std::vector<AliasTable::Item> items;
+    double weightSum = AliasTable::buildItems(weights, items);
+
+    double refWeightSum = 0.0;
+    for (float w : weights)
+        refWeightSum += w;
+    EXPECT_LE(std::abs(weightSum - refWeightSum), 1e-9 * refWeightSum);
+
+    checkAliasTableItems(ctx, weights, items, weightSum);
+
+    // The build must be deterministic.
+    std::vector<AliasTable::Item> items2;
+    EXPECT_EQ(AliasTable::buildItems(weights, items2), weightSum);
+    EXPECT(std::memcmp(items.data(), items2.data(), items.size() * sizeof(AliasTable::Item)) == 0);
+
+    // Small tables.
+    std::vector<AliasTable::Item> smallItems;
+    EXPECT_EQ(AliasTable::buildItems({}, smallItems), 0.0);
+    EXPECT(smallItems.empty());
+    checkAliasTableItems(ctx, {2.f}, smallItems, AliasTable::buildItems({2.f}, smallItems));
+    checkAliasTableItems(ctx, {1.f, 3.f, 0.f}, smallItems, AliasTable::buildItems({1.f, 3.f, 0.f}, smallItems));
+}
+
 GPU_TEST(AliasTable)
 {
     testAliasTable(ctx, 1, {1.f});
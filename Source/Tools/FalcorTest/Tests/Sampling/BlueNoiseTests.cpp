@@ -0,0 +1,159 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Sampling/LowDiscrepancy/BlueNoise.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kSize = 64;
+
+const std::vector<uint32_t>& getMask()
+{
+    static std::vector<uint32_t> mask = generateBlueNoiseMask(kSize);
+    return mask;
+}
+
+/// Compute the mean toroidal distance from each texel in the set to its nearest neighbor.
+double computeMeanNearestNeighborDistance(const std::vector<uint32_t>& texels, uint32_t size)
+{
+    double sum = 0.0;
+    for (uint32_t a : texels)
+    {
+        uint32_t best = UINT32_MAX;
+        for (uint32_t b : texels)
+        {
+            if (a == b)
+                continue;
+            uint32_t dx = (a % size - b % size) & (size - 1);
+            uint32_t dy = (a / size - b / size) & (size - 1);
+            dx = std::min(dx, size - dx);
+            dy = std::min(dy, size - dy);
+            best = std::min(best, dx * dx + dy * dy);
+        }
+        sum += std::sqrt((double)best);
+    }
+    return sum / texels.size();
+}
+
+/// Compute the mean power of the low frequencies 0 < |k| <= maxFrequency of a binary pattern.
+double computeLowFrequencyPower(const std::vector<uint8_t>& pattern, uint32_t size, int maxFrequency)
+{
+    double mean = 0.0;
+    for (uint8_t v : pattern)
+        mean += v;
+    mean /= pattern.size();
+
+    double sum = 0.0;
+    uint32_t count = 0;
+    for (int ky = -maxFrequency; ky <= maxFrequency; ++ky)
+    {
+        for (int kx = -maxFrequency; kx <= maxFrequency; ++kx)
+        {
+            if ((kx == 0 && ky == 0) || kx * kx + ky * ky > maxFrequency * maxFrequency)
+                continue;
+            double re = 0.0;
+            double im = 0.0;
+            for (uint32_t y = 0; y < size; ++y)
+            {
+                for (uint32_t x = 0; x < size; ++x)
+                {
+                    double phase = 2.0 * M_PI * (kx * (int)x + ky * (int)y) / size;
+                    double v = pattern[y * size + x] - mean;
+                    re += v * std::cos(phase);
+                    im += v * std::sin(phase);
+                }
+            }
+            sum += (re * re + im * im) / pattern.size();
+            count++;
+        }
+    }
+    return sum / count;
+}
+} // namespace
+
+CPU_TEST(BlueNoise_Permutation)
+{
+    const auto& mask = getMask();
+    ASSERT_EQ(mask.size(), kSize * kSize);
+    std::vector<uint32_t> sorted = mask;
+    std::sort(sorted.begin(), sorted.end());
+    for (uint32_t i = 0; i < kSize * kSize; ++i)
+        EXPECT_EQ(sorted[i], i);
+
+    // The mask is deterministic.
+    EXPECT(generateBlueNoiseMask(16, 3) == generateBlueNoiseMask(16, 3));
+    EXPECT_THROW(generateBlueNoiseMask(48));
+}
+
+CPU_TEST(BlueNoise_Distribution)
+{
+    // Thresholding the mask gives points that are spread out more evenly than white noise,
+    // i.e. the nearest neighbor of each point is further away.
+    const auto& mask = getMask();
+    std::mt19937 rng(1);
+    std::vector<uint32_t> shuffled(kSize * kSize);
+    for (uint32_t i = 0; i < shuffled.size(); ++i)
+        shuffled[i] = i;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    for (uint32_t count : {64u, 256u})
+    {
+        std::vector<uint32_t> blueNoise;
+        for (uint32_t i = 0; i < mask.size(); ++i)
+        {
+            if (mask[i] < count)
+                blueNoise.push_back(i);
+        }
+        std::vector<uint32_t> whiteNoise(shuffled.begin(), shuffled.begin() + count);
+
+        double blueNoiseDistance = computeMeanNearestNeighborDistance(blueNoise, kSize);
+        double whiteNoiseDistance = computeMeanNearestNeighborDistance(whiteNoise, kSize);
+        EXPECT_GT(blueNoiseDistance, 1.3 * whiteNoiseDistance) << "count = " << count;
+    }
+
+    // At all threshold levels the low frequencies of the pattern are suppressed.
+    for (uint32_t count : {256u, 1024u, 2048u, 3072u})
+    {
+        std::vector<uint8_t> blueNoise(kSize * kSize, 0);
+        std::vector<uint8_t> whiteNoise(kSize * kSize, 0);
+        for (uint32_t i = 0; i < mask.size(); ++i)
+            blueNoise[i] = mask[i] < count ? 1 : 0;
+        for (uint32_t i = 0; i < count; ++i)
+            whiteNoise[shuffled[i]] = 1;
+
+        double blueNoisePower = computeLowFrequencyPower(blueNoise, kSize, 4);
+        double whiteNoisePower = computeLowFrequencyPower(whiteNoise, kSize, 4);
+        EXPECT_LT(blueNoisePower, 0.2 * whiteNoisePower) << "count = " << count;
+    }
+}
+} // namespace Falcor
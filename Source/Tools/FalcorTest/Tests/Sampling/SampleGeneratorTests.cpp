@@ -70,7 +70,14 @@ double correlation(const float* elems, const size_t numElems, const size_t strid
     return r_xy;
 }
 
-void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double meanError, const double corrThreshold, bool testInstances)
+void testSampleGenerator(
+    GPUUnitTestContext& ctx,
+    uint32_t type,
+    const double meanError,
+    const double corrThreshold,
+    bool testPixels,
+    bool testInstances
+)
 {
     // Create sample generator.
     ref<SampleGenerator> pSampleGenerator = SampleGenerator::create(ctx.getDevice(), type);
@@ -122,16 +129,19 @@ void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double me
         EXPECT_LE(corr(i), corrThreshold) << "i = " << i;
     }
 
-    // Test nearby pixels.
-    const size_t xStride = kDimensions;
-    const size_t yStride = kDispatchDim.x * kDimensions;
-    for (size_t y = 0; y < 4; y++)
+    // Test nearby pixels, if they are expected to be uncorrelated.
+    if (testPixels)
     {
-        for (size_t x = 0; x < 4; x++)
+        const size_t xStride = kDimensions;
+        const size_t yStride = kDispatchDim.x * kDimensions;
+        for (size_t y = 0; y < 4; y++)
         {
-            if (x == 0 && y == 0)
-                continue;
-            EXPECT_LE(corr(x * xStride + y * yStride), corrThreshold) << "x = " << x << " y = " << y;
+            for (size_t x = 0; x < 4; x++)
+            {
+                if (x == 0 && y == 0)
+                    continue;
+                EXPECT_LE(corr(x * xStride + y * yStride), corrThreshold) << "x = " << x << " y = " << y;
+            }
         }
     }
 
@@ -155,12 +165,24 @@ void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double me
 
 GPU_TEST(SampleGenerator_TinyUniform)
 {
-    testSampleGenerator(ctx, SAMPLE_GENERATOR_TINY_UNIFORM, 0.01, 0.0025, true);
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_TINY_UNIFORM, 0.01, 0.0025, true, true);
 }
 
 GPU_TEST(SampleGenerator_Uniform)
 {
-    testSampleGenerator(ctx, SAMPLE_GENERATOR_UNIFORM, 0.01, 0.002, true);
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_UNIFORM, 0.01, 0.002, true, true);
+}
+
+// Successive sample numbers are stratified against each other, so instances are correlated by design.
+GPU_TEST(SampleGenerator_Sobol)
+{
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL, 0.01, 0.005, true, false);
+}
+
+// Neighboring pixels are anti-correlated by design.
+GPU_TEST(SampleGenerator_SobolBlueNoise)
+{
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, 0.01, 0.01, false, false);
 }
 
 } // namespace Falcor
@@ -0,0 +1,285 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Sampling/LowDiscrepancy/SobolSequence.h"
+#include "Utils/Sampling/SobolSampleGenerator.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kDimensionCount = SOBOL_DIMENSION_COUNT;
+
+const std::vector<uint32_t>& getMatrices()
+{
+    return SobolSampleGenerator::getSobolMatrices();
+}
+
+const uint32_t* getMatrix(uint32_t dimension)
+{
+    return getMatrices().data() + dimension * kSobolBitCount;
+}
+
+/// Check that each interval [k/2^m, (k+1)/2^m) contains exactly one of the 2^m values.
+bool isStratified(const std::vector<uint32_t>& values, uint32_t m)
+{
+    std::vector<uint32_t> counts(1u << m, 0);
+    for (uint32_t v : values)
+        counts[m == 0 ? 0 : v >> (32 - m)]++;
+    for (uint32_t c : counts)
+    {
+        if (c != 1)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Compute the squared L2-star discrepancy of a point set using Warnock's formula.
+ * @param[in] points Points in [0,1)^d stored one after another.
+ * @param[in] d Number of dimensions.
+ */
+double computeL2StarDiscrepancySquared(const std::vector<double>& points, uint32_t d)
+{
+    const size_t n = points.size() / d;
+    double sum1 = 0.0;
+    double sum2 = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double p = 1.0;
+        for (uint32_t k = 0; k < d; ++k)
+            p *= 1.0 - points[i * d + k] * points[i * d + k];
+        sum1 += p;
+        for (size_t j = 0; j < n; ++j)
+        {
+            double q = 1.0;
+            for (uint32_t k = 0; k < d; ++k)
+                q *= 1.0 - std::max(points[i * d + k], points[j * d + k]);
+            sum2 += q;
+        }
+    }
+    return std::pow(3.0, -(double)d) - std::pow(2.0, 1.0 - d) / n * sum1 + sum2 / ((double)n * n);
+}
+
+double toUnit(uint32_t x)
+{
+    return x * 0x1p-32;
+}
+} // namespace
+
+CPU_TEST(SobolSequence_FirstDimensions)
+{
+    // The first two dimensions form a (0,2)-sequence.
+    for (uint32_t m = 1; m <= 16; ++m)
+        EXPECT_EQ(computeSobolTValue(getMatrix(0), getMatrix(1), m), 0) << "m = " << m;
+
+    // Dimension 0 is the van der Corput sequence.
+    for (uint32_t i = 0; i < 1024; ++i)
+        EXPECT_EQ(sobolSample(getMatrix(0), i), reverseBits32(i)) << "i = " << i;
+
+    // Dimensions 1 and 2 use the polynomials x + 1 and x^2 + x + 1 of the Joe-Kuo table.
+    // Direction number k is m_k / 2^k with the following m_k.
+    const uint32_t m1[] = {1, 3, 5, 15, 17, 51};
+    const uint32_t m2[] = {1, 3, 3, 9, 29, 23};
+    for (uint32_t k = 1; k <= 6; ++k)
+    {
+        EXPECT_EQ(getMatrix(1)[k - 1], m1[k - 1] << (kSobolBitCount - k)) << "k = " << k;
+        EXPECT_EQ(getMatrix(2)[k - 1], m2[k - 1] << (kSobolBitCount - k)) << "k = " << k;
+    }
+
+    // The matrices are a prefix of the tabulated dimensions.
+    EXPECT(generateSobolMatrices(8) == std::vector<uint32_t>(getMatrices().begin(), getMatrices().begin() + 8 * kSobolBitCount));
+    EXPECT_THROW(generateSobolMatrices(kSobolMaxDimensionCount + 1));
+}
+
+CPU_TEST(SobolSequence_Stratification)
+{
+    // Each dimension is a (0,1)-sequence: every aligned block of 2^m samples is stratified.
+    for (uint32_t d = 0; d < kDimensionCount; ++d)
+    {
+        for (uint32_t m = 0; m <= 10; ++m)
+        {
+            for (uint32_t block = 0; block < 3; ++block)
+            {
+                std::vector<uint32_t> values;
+                for (uint32_t i = 0; i < (1u << m); ++i)
+                    values.push_back(sobolSample(getMatrix(d), (block << m) + i));
+                EXPECT(isStratified(values, m)) << "d = " << d << " m = " << m << " block = " << block;
+            }
+        }
+    }
+}
+
+CPU_TEST(SobolSequence_Projections)
+{
+    // The Joe-Kuo direction numbers keep the 2D projections of 256 points well distributed.
+    // For comparison, the worst possible t-value is 8 (all points on a line).
+    uint32_t maxT = 0;
+    uint32_t sumT = 0;
+    uint32_t pairCount = 0;
+    for (uint32_t a = 0; a < kDimensionCount; ++a)
+    {
+        for (uint32_t b = a + 1; b < kDimensionCount; ++b)
+        {
+            uint32_t t = computeSobolTValue(getMatrix(a), getMatrix(b), 8);
+            maxT = std::max(maxT, t);
+            sumT += t;
+            pairCount++;
+        }
+    }
+    EXPECT_LE(maxT, 6);
+    EXPECT_LE((double)sumT / pairCount, 2.5);
+}
+
+CPU_TEST(SobolSequence_TValue)
+{
+    // A dimension paired with itself has all points on the diagonal, only the 1D intervals are stratified.
+    EXPECT_EQ(computeSobolTValue(getMatrix(0), getMatrix(0), 6), 5);
+    EXPECT_EQ(computeSobolTValue(getMatrix(5), getMatrix(5), 7), 6);
+    EXPECT_EQ(computeSobolTValue(getMatrix(0), getMatrix(1), 0), 0);
+}
+
+CPU_TEST(SobolSequence_NestedUniformScramble)
+{
+    // The scramble is a bijection where the top m bits of the output only depend on the top m bits of the input.
+    std::mt19937 rng(1);
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        uint32_t seed = rng();
+        uint32_t x = rng();
+        uint32_t m = rng() % 32;
+        uint32_t mask = m == 0 ? 0 : ~0u << (32 - m);
+        uint32_t y = (x & mask) | (rng() & ~mask);
+        EXPECT_EQ(nestedUniformScramble(x, seed) & mask, nestedUniformScramble(y, seed) & mask);
+    }
+
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 4096; ++i)
+        values.push_back(nestedUniformScramble(i << 20, 1234));
+    EXPECT(isStratified(values, 12));
+}
+
+CPU_TEST(SobolSequence_Scrambled)
+{
+    // Scrambling and shuffling preserves the stratification, also for dimensions beyond the matrix count.
+    const uint32_t m = 8;
+    for (uint32_t seed : {0u, 1u, 0x12345678u})
+    {
+        for (uint32_t d = 0; d < 2 * kDimensionCount; ++d)
+        {
+            std::vector<uint32_t> values;
+            for (uint32_t i = 0; i < (1u << m); ++i)
+                values.push_back(sampleScrambledSobol(getMatrices().data(), kDimensionCount, (1u << m) + i, d, seed));
+            EXPECT(isStratified(values, m)) << "d = " << d << " seed = " << seed;
+        }
+
+        // The first two dimensions remain a (0,m,2)-net: each elementary interval of area 2^-m holds one point.
+        for (uint32_t mx = 0; mx <= m; ++mx)
+        {
+            uint32_t my = m - mx;
+            std::vector<uint32_t> counts(1u << m, 0);
+            for (uint32_t i = 0; i < (1u << m); ++i)
+            {
+                uint32_t x = sampleScrambledSobol(getMatrices().data(), kDimensionCount, i, 0, seed);
+                uint32_t y = sampleScrambledSobol(getMatrices().data(), kDimensionCount, i, 1, seed);
+                uint32_t cx = mx == 0 ? 0 : x >> (32 - mx);
+                uint32_t cy = my == 0 ? 0 : y >> (32 - my);
+                counts[(cy << mx) | cx]++;
+            }
+            EXPECT(std::all_of(counts.begin(), counts.end(), [](uint32_t c) { return c == 1; })) << "mx = " << mx << " seed = " << seed;
+        }
+    }
+
+    // Different seeds give different sequences.
+    EXPECT_NE(
+        sampleScrambledSobol(getMatrices().data(), kDimensionCount, 5, 3, 1),
+        sampleScrambledSobol(getMatrices().data(), kDimensionCount, 5, 3, 2)
+    );
+}
+
+CPU_TEST(SobolSequence_Discrepancy)
+{
+    // The L2-star discrepancy of the scrambled sequence is well below that of uniform random points.
+    // The discrepancy of a single randomization varies, so it is averaged over a few seeds.
+    const uint32_t n = 1024;
+    const uint32_t seedCount = 4;
+    std::mt19937 rng(7);
+    for (uint32_t firstDimension : {0u, 2u, 10u, 40u, 60u})
+    {
+        for (uint32_t d : {2u, 4u})
+        {
+            double sobolD2 = 0.0;
+            double randomD2 = 0.0;
+            for (uint32_t seed = 0; seed < seedCount; ++seed)
+            {
+                std::vector<double> sobol;
+                std::vector<double> random;
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    for (uint32_t k = 0; k < d; ++k)
+                    {
+                        sobol.push_back(toUnit(sampleScrambledSobol(getMatrices().data(), kDimensionCount, i, firstDimension + k, seed)));
+                        random.push_back(toUnit(rng()));
+                    }
+                }
+                sobolD2 += computeL2StarDiscrepancySquared(sobol, d);
+                randomD2 += computeL2StarDiscrepancySquared(random, d);
+            }
+            EXPECT_LT(sobolD2, 0.6 * randomD2) << "firstDimension = " << firstDimension << " d = " << d;
+        }
+    }
+}
+
+GPU_TEST(SobolSequence_CompareToCPU)
+{
+    // The GPU implementation is bit-identical to the CPU.
+    const uint32_t sampleCount = 256;
+    const uint32_t dimensions = 2 * kDimensionCount;
+    const uint32_t seed = 0xc0ffee;
+
+    ctx.createProgram("Tests/Sampling/SobolSequenceTests.cs.slang", "testScrambledSobol");
+    ctx.allocateStructuredBuffer("matrices", (uint32_t)getMatrices().size(), getMatrices().data(), getMatrices().size() * sizeof(uint32_t));
+    ctx.allocateStructuredBuffer("result", sampleCount * dimensions);
+    ctx["CB"]["gSampleCount"] = sampleCount;
+    ctx["CB"]["gDimensions"] = dimensions;
+    ctx["CB"]["gMatrixDimensions"] = kDimensionCount;
+    ctx["CB"]["gSeed"] = seed;
+    ctx.runProgram(sampleCount, dimensions, 1);
+
+    std::vector<uint32_t> result = ctx.readBuffer<uint32_t>("result");
+    for (uint32_t i = 0; i < sampleCount; ++i)
+    {
+        for (uint32_t d = 0; d < dimensions; ++d)
+        {
+            EXPECT_EQ(result[i * dimensions + d], sampleScrambledSobol(getMatrices().data(), kDimensionCount, i, d, seed))
+                << "i = " << i << " d = " << d;
+        }
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,165 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/BinaryScene.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/TriangleMesh.h"
+#include "Scene/Lights/Light.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Image/Bitmap.h"
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kScenePath = std::filesystem::temp_directory_path() / "FalcorBinarySceneTest" / "test.fscene";
+const std::filesystem::path kTexturePath = kScenePath.parent_path() / "baseColor.png";
+
+void writeTexture()
+{
+    std::filesystem::create_directories(kTexturePath.parent_path());
+    uint8_t data[4 * 4 * 4];
+    for (size_t i = 0; i < std::size(data); ++i)
+        data[i] = (uint8_t)(i * 4);
+    Bitmap::saveImage(
+        kTexturePath, 4, 4, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data
+    );
+}
+
+void buildScene(SceneBuilder& builder)
+{
+    ref<Device> pDevice = builder.getDevice();
+
+    auto pRed = StandardMaterial::create(pDevice, "Red");
+    pRed->setBaseColor(float4(1.f, 0.f, 0.f, 1.f));
+    builder.loadMaterialTexture(pRed, Material::TextureSlot::BaseColor, kTexturePath);
+    auto pGreen = StandardMaterial::create(pDevice, "Green");
+    pGreen->setBaseColor(float4(0.f, 1.f, 0.f, 1.f));
+    pGreen->setRoughness(0.25f);
+
+    SceneBuilder::Node root;
+    root.name = "Root";
+    root.transform = math::matrixFromTranslation(float3(1.f, 2.f, 3.f));
+    NodeID rootID = builder.addNode(root);
+
+    MeshID cubeID = builder.addTriangleMesh(TriangleMesh::createCube(), pRed);
+    MeshID sphereID = builder.addTriangleMesh(TriangleMesh::createSphere(), pGreen);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        SceneBuilder::Node node;
+        node.name = fmt::format("Instance{}", i);
+        node.transform = math::matrixFromTranslation(float3((float)i, 0.f, 0.f));
+        node.parent = rootID;
+        NodeID nodeID = builder.addNode(node);
+        builder.addMeshInstance(nodeID, cubeID);
+        if (i == 1)
+            builder.addMeshInstance(nodeID, sphereID);
+    }
+
+    auto pCamera = Camera::create("Camera");
+    pCamera->setPosition(float3(0.f, 0.f, 5.f));
+    builder.addCamera(pCamera);
+    builder.setSelectedCamera(pCamera);
+
+    auto pLight = PointLight::create("Light");
+    pLight->setIntensity(float3(2.f, 3.f, 4.f));
+    builder.addLight(pLight);
+
+    builder.setCameraSpeed(3.f);
+}
+} // namespace
+
+GPU_TEST(BinaryScene_RoundTrip)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    writeTexture();
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::DontOptimizeGraph | SceneBuilder::Flags::DontMergeMeshes);
+    buildScene(builder);
+    BinaryScene::write(builder, kScenePath);
+    ASSERT(std::filesystem::exists(kScenePath));
+    ASSERT(std::filesystem::exists(BinaryScene::getMeshPayloadPath(kScenePath)));
+
+    // Import into a builder that already contains a node to check that node references are remapped.
+    SceneBuilder loaded(pDevice, Settings(), SceneBuilder::Flags::DontOptimizeGraph | SceneBuilder::Flags::DontMergeMeshes);
+    SceneBuilder::Node existing;
+    existing.name = "Existing";
+    loaded.addNode(existing);
+    BinaryScene::read(kScenePath, loaded);
+
+    ASSERT_EQ(loaded.getNodeCount(), builder.getNodeCount() + 1);
+    for (uint32_t i = 0; i < builder.getNodeCount(); ++i)
+    {
+        const auto& expected = builder.getNode(NodeID(i));
+        const auto& node = loaded.getNode(NodeID(i + 1));
+        EXPECT_EQ(node.name, expected.name);
+        EXPECT(node.transform == expected.transform);
+        EXPECT_EQ(node.parent.isValid(), expected.parent.isValid());
+        if (expected.parent.isValid())
+            EXPECT_EQ(node.parent.get(), expected.parent.get() + 1);
+    }
+
+    ASSERT_EQ(loaded.getMaterials().size(), 2);
+    auto pGreen = static_ref_cast<StandardMaterial>(loaded.getMaterial("Green"));
+    ASSERT(pGreen != nullptr);
+    EXPECT(all(pGreen->getBaseColor() == float4(0.f, 1.f, 0.f, 1.f)));
+    EXPECT_EQ(pGreen->getRoughness(), 0.25f);
+
+    // The texture was still loading when the scene was written. It must be part of the export.
+    loaded.waitForMaterialTextureLoading();
+    auto pRed = static_ref_cast<StandardMaterial>(loaded.getMaterial("Red"));
+    ASSERT(pRed != nullptr);
+    ref<Texture> pTexture = pRed->getBaseColorTexture();
+    ASSERT(pTexture != nullptr);
+    EXPECT(std::filesystem::equivalent(pTexture->getSourcePath(), kTexturePath));
+    EXPECT_EQ(pTexture->getWidth(), 4);
+    EXPECT_EQ(pTexture->getHeight(), 4);
+
+    ASSERT_EQ(loaded.getCameras().size(), 1);
+    EXPECT_EQ(loaded.getSelectedCamera()->getName(), "Camera");
+    EXPECT(all(loaded.getSelectedCamera()->getPosition() == float3(0.f, 0.f, 5.f)));
+    ASSERT_EQ(loaded.getLights().size(), 1);
+    EXPECT(all(loaded.getLights()[0]->getIntensity() == float3(2.f, 3.f, 4.f)));
+    EXPECT_EQ(loaded.getCameraSpeed(), 3.f);
+
+    // Both builders produce the same geometry.
+    ref<Scene> pExpectedScene = builder.getScene();
+    ref<Scene> pScene = loaded.getScene();
+    ASSERT(pExpectedScene && pScene);
+    EXPECT_EQ(pScene->getMeshCount(), pExpectedScene->getMeshCount());
+    EXPECT_EQ(pScene->getGeometryInstanceCount(), pExpectedScene->getGeometryInstanceCount());
+    for (uint32_t i = 0; i < pScene->getMeshCount(); ++i)
+    {
+        EXPECT_EQ(pScene->getMesh(MeshID(i)).vertexCount, pExpectedScene->getMesh(MeshID(i)).vertexCount);
+        EXPECT_EQ(pScene->getMesh(MeshID(i)).indexCount, pExpectedScene->getMesh(MeshID(i)).indexCount);
+    }
+
+    std::filesystem::remove_all(kScenePath.parent_path());
+}
+} // namespace Falcor
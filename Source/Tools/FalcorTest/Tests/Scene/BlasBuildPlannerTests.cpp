@@ -0,0 +1,221 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/BlasBuildPlanner.h"
+
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+using Item = BlasBuildPlanner::Item;
+using Strategy = BlasBuildPlanner::Strategy;
+
+const uint64_t kMB = 1ull << 20;
+
+/// Check that a plan is consistent with the items and return the largest group size (result plus scratch).
+void validatePlan(CPUUnitTestContext& ctx, const std::vector<Item>& items, const BlasBuildPlanner::Plan& plan)
+{
+    ASSERT_EQ(plan.itemGroups.size(), items.size());
+    std::vector<uint32_t> itemCount(items.size(), 0);
+    uint64_t maxResult = 0;
+    uint64_t maxScratch = 0;
+    for (uint32_t groupIndex = 0; groupIndex < plan.groups.size(); ++groupIndex)
+    {
+        const auto& group = plan.groups[groupIndex];
+        ASSERT(!group.items.empty());
+        uint64_t resultSize = 0;
+        uint64_t scratchSize = 0;
+        for (uint32_t i : group.items)
+        {
+            ASSERT_LT(i, items.size());
+            itemCount[i]++;
+            EXPECT_EQ(plan.itemGroups[i], groupIndex);
+            EXPECT_EQ(plan.resultByteOffsets[i], resultSize);
+            EXPECT_EQ(plan.scratchByteOffsets[i], scratchSize);
+            resultSize += items[i].resultByteSize;
+            scratchSize += items[i].scratchByteSize;
+        }
+        EXPECT_EQ(group.resultByteSize, resultSize);
+        EXPECT_EQ(group.scratchByteSize, scratchSize);
+        maxResult = std::max(maxResult, resultSize);
+        maxScratch = std::max(maxScratch, scratchSize);
+    }
+    for (uint32_t count : itemCount)
+        EXPECT_EQ(count, 1);
+    EXPECT_EQ(plan.resultBufferSize, maxResult);
+    EXPECT_EQ(plan.scratchBufferSize, maxScratch);
+    EXPECT_EQ(plan.predictedPeakBytes, maxResult + maxScratch + plan.predictedFinalBytes);
+}
+
+/**
+ * Generate a set of BLAS prebuild sizes resembling large scenes: many small BLASes and a few large ones
+ * (log-normal distribution), with the scratch size a varying fraction of the result size.
+ */
+std::vector<Item> generateItems(uint32_t count, uint32_t seed, float scratchScale)
+{
+    std::mt19937 rng(seed);
+    std::lognormal_distribution<double> resultDist(std::log(2.0 * kMB), 1.5);
+    std::uniform_real_distribution<double> scratchDist(0.2, 1.5);
+    std::vector<Item> items(count);
+    for (auto& item : items)
+    {
+        double result = std::min(resultDist(rng), 300.0 * kMB);
+        item.resultByteSize = std::max<uint64_t>(256, (uint64_t)result & ~255ull);
+        item.scratchByteSize = std::max<uint64_t>(256, (uint64_t)(result * scratchScale * scratchDist(rng)) & ~255ull);
+        item.useCompaction = true;
+    }
+    return items;
+}
+} // namespace
+
+CPU_TEST(BlasBuildPlanner_InOrder)
+{
+    // In-order grouping fills groups in scene order.
+    std::vector<Item> items = {{40, 10}, {30, 10}, {20, 10}, {50, 10}, {10, 10}};
+    BlasBuildPlanner::Config config;
+    config.memoryBudget = 100;
+    config.strategy = Strategy::InOrder;
+    auto plan = BlasBuildPlanner(config).plan(items);
+    validatePlan(ctx, items, plan);
+    ASSERT_EQ(plan.groups.size(), 3);
+    EXPECT(plan.groups[0].items == std::vector<uint32_t>({0, 1}));
+    EXPECT(plan.groups[1].items == std::vector<uint32_t>({2, 3}));
+    EXPECT(plan.groups[2].items == std::vector<uint32_t>({4}));
+}
+
+CPU_TEST(BlasBuildPlanner_Lopsided)
+{
+    // Items alternating between large result and large scratch sizes. Filling groups in order puts the largest
+    // result and the largest scratch size into different groups, exceeding the budget.
+    std::vector<Item> items = {{50, 5}, {5, 50}, {40, 5}, {5, 40}};
+    BlasBuildPlanner::Config config;
+    config.memoryBudget = 100;
+
+    config.strategy = Strategy::InOrder;
+    auto inOrder = BlasBuildPlanner(config).plan(items);
+    validatePlan(ctx, items, inOrder);
+    EXPECT_EQ(inOrder.getIntermediateBytes(), 105);
+
+    config.strategy = Strategy::BinPacking;
+    auto packed = BlasBuildPlanner(config).plan(items);
+    validatePlan(ctx, items, packed);
+    EXPECT_EQ(packed.groups.size(), 3);
+    EXPECT_EQ(packed.getIntermediateBytes(), 100);
+}
+
+CPU_TEST(BlasBuildPlanner_Oversized)
+{
+    // An item exceeding the budget on its own gets a group of its own.
+    std::vector<Item> items = {{10, 10}, {150, 50}, {10, 10}};
+    BlasBuildPlanner::Config config;
+    config.memoryBudget = 100;
+    auto plan = BlasBuildPlanner(config).plan(items);
+    validatePlan(ctx, items, plan);
+    ASSERT_EQ(plan.groups.size(), 2);
+    EXPECT_EQ(plan.groups[plan.itemGroups[1]].items.size(), 1);
+    EXPECT_EQ(plan.itemGroups[0], plan.itemGroups[2]);
+    EXPECT_EQ(plan.getIntermediateBytes(), 200);
+}
+
+CPU_TEST(BlasBuildPlanner_Compaction)
+{
+    using Mode = BlasBuildPlanner::CompactionMode;
+    EXPECT(BlasBuildPlanner::shouldCompact(Mode::Auto, false, false));
+    EXPECT(BlasBuildPlanner::shouldCompact(Mode::Auto, false, true));
+    EXPECT(BlasBuildPlanner::shouldCompact(Mode::Auto, true, false));
+    EXPECT(!BlasBuildPlanner::shouldCompact(Mode::Auto, true, true));
+    EXPECT(!BlasBuildPlanner::shouldCompact(Mode::Disabled, false, false));
+
+    // Compacted BLASes are predicted to shrink by the compaction ratio.
+    std::vector<Item> items = {{100, 10, true}, {100, 10, false}};
+    BlasBuildPlanner::Config config;
+    config.memoryBudget = 1000;
+    config.compactionRatio = 0.25f;
+    auto plan = BlasBuildPlanner(config).plan(items);
+    validatePlan(ctx, items, plan);
+    EXPECT_EQ(plan.predictedFinalBytes, 125);
+    EXPECT_EQ(plan.predictedPeakBytes, 345);
+}
+
+CPU_TEST(BlasBuildPlanner_Packing)
+{
+    // Compare packing quality against in-order grouping on sets of various sizes.
+    struct Set
+    {
+        uint32_t count;
+        uint32_t seed;
+        float scratchScale;
+        uint64_t budget;
+    };
+    const Set sets[] = {
+        {100, 1, 0.5f, 512 * kMB},
+        {1000, 2, 0.5f, 512 * kMB},
+        {1000, 3, 1.f, 512 * kMB},
+        {5000, 4, 0.3f, 512 * kMB},
+        {1000, 5, 0.5f, 128 * kMB},
+        {200, 6, 2.f, 1024 * kMB},
+    };
+
+    for (const auto& set : sets)
+    {
+        auto items = generateItems(set.count, set.seed, set.scratchScale);
+        uint64_t maxItemResult = 0;
+        uint64_t maxItemScratch = 0;
+        uint64_t totalSize = 0;
+        for (const auto& item : items)
+        {
+            maxItemResult = std::max(maxItemResult, item.resultByteSize);
+            maxItemScratch = std::max(maxItemScratch, item.scratchByteSize);
+            totalSize += item.resultByteSize + item.scratchByteSize;
+        }
+        const uint64_t budget = std::max(set.budget, maxItemResult + maxItemScratch);
+
+        BlasBuildPlanner::Config config;
+        config.memoryBudget = set.budget;
+        config.strategy = Strategy::InOrder;
+        auto inOrder = BlasBuildPlanner(config).plan(items);
+        config.strategy = Strategy::BinPacking;
+        auto packed = BlasBuildPlanner(config).plan(items);
+
+        validatePlan(ctx, items, inOrder);
+        validatePlan(ctx, items, packed);
+
+        // Packed plans keep the intermediate memory within the budget and use at most as many groups as
+        // in-order grouping. With the same number of groups they use no more memory. The group count is
+        // close to the lower bound.
+        EXPECT_LE(packed.getIntermediateBytes(), budget);
+        EXPECT_LE(packed.groups.size(), inOrder.groups.size());
+        if (packed.groups.size() == inOrder.groups.size())
+            EXPECT_LE(packed.predictedPeakBytes, inOrder.predictedPeakBytes);
+        uint64_t minGroupCount = (totalSize + budget - 1) / budget;
+        EXPECT_LE(packed.groups.size(), minGroupCount + minGroupCount / 4 + 1);
+    }
+}
+} // namespace Falcor
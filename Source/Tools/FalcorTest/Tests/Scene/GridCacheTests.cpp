@@ -0,0 +1,177 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Volume/GridCache.h"
+
+#include <fstream>
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+/// Use a temporary cache directory for the duration of a test.
+struct ScopedCacheDirectory
+{
+    GridCache::Options previousOptions;
+    std::filesystem::path directory;
+
+    ScopedCacheDirectory(const std::string& name)
+    {
+        previousOptions = GridCache::getOptions();
+        directory = std::filesystem::temp_directory_path() / ("FalcorGridCacheTest_" + name);
+        std::filesystem::remove_all(directory);
+        GridCache::Options options = previousOptions;
+        options.directory = directory;
+        GridCache::setOptions(options);
+    }
+
+    ~ScopedCacheDirectory()
+    {
+        GridCache::setOptions(previousOptions);
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+    }
+};
+
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream fs(path, std::ios_base::binary);
+    fs.write(content.data(), content.size());
+}
+
+/// Brick data with sizes matching the dimensions (2^3 bricks, 4 range mips, 8x8x4 BC4 atlas).
+BrickedGridData createBrickData()
+{
+    BrickedGridData data;
+    data.rangeDim = uint3(2, 2, 2);
+    data.atlasDim = uint3(8, 8, 4);
+    data.atlasFormat = ResourceFormat::BC4Unorm;
+    data.range.resize(8 + 1 + 1 + 1);
+    data.indirection.resize(8);
+    data.atlas.resize(2 * 2 * 4 * 8);
+    std::iota(data.range.begin(), data.range.end(), 1);
+    std::iota(data.indirection.begin(), data.indirection.end(), 100);
+    std::iota(data.atlas.begin(), data.atlas.end(), uint8_t(0));
+    return data;
+}
+} // namespace
+
+CPU_TEST(GridCache_Key)
+{
+    ScopedCacheDirectory cacheDirectory("Key");
+    std::filesystem::create_directories(cacheDirectory.directory);
+    auto pathA = cacheDirectory.directory / "a.vdb";
+    auto pathB = cacheDirectory.directory / "b.vdb";
+    writeFile(pathA, "grid data");
+    writeFile(pathB, "grid data");
+
+    auto keyA = GridCache::computeKey(pathA, "density");
+    ASSERT(keyA.has_value());
+
+    // The key only depends on the contents and the grid name, not the location.
+    EXPECT(GridCache::computeKey(pathB, "density") == keyA);
+    EXPECT(GridCache::computeKey(pathA, "temperature") != keyA);
+
+    writeFile(pathB, "grid data, modified");
+    EXPECT(GridCache::computeKey(pathB, "density") != keyA);
+
+    EXPECT(!GridCache::computeKey(cacheDirectory.directory / "missing.vdb", "density").has_value());
+}
+
+CPU_TEST(GridCache_Bricks)
+{
+    ScopedCacheDirectory cacheDirectory("Bricks");
+
+    BrickedGridData data = createBrickData();
+
+    GridCache::Key key = {};
+    key[0] = 42;
+    EXPECT(!GridCache::readBricks(key, ResourceFormat::BC4Unorm).has_value());
+
+    GridCache::writeBricks(key, data);
+    auto cached = GridCache::readBricks(key, ResourceFormat::BC4Unorm);
+    ASSERT(cached.has_value());
+    EXPECT(all(cached->rangeDim == data.rangeDim));
+    EXPECT(all(cached->atlasDim == data.atlasDim));
+    EXPECT(cached->atlasFormat == data.atlasFormat);
+    EXPECT(cached->range == data.range);
+    EXPECT(cached->indirection == data.indirection);
+    EXPECT(cached->atlas == data.atlas);
+
+    // Entries with a different atlas format are ignored.
+    EXPECT(!GridCache::readBricks(key, ResourceFormat::R8Unorm).has_value());
+
+    // No temporary files are left behind.
+    size_t fileCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory.directory))
+    {
+        EXPECT(entry.path().extension() == ".bricks");
+        fileCount++;
+    }
+    EXPECT_EQ(fileCount, 1);
+}
+
+CPU_TEST(GridCache_BricksInvalid)
+{
+    ScopedCacheDirectory cacheDirectory("BricksInvalid");
+    GridCache::Key key = {};
+    key[0] = 43;
+    auto cachePath = cacheDirectory.directory / (SHA1::toString(key) + ".bricks");
+
+    // Truncated and oversized files are rejected.
+    GridCache::writeBricks(key, createBrickData());
+    auto fileSize = std::filesystem::file_size(cachePath);
+    std::filesystem::resize_file(cachePath, fileSize - 1);
+    EXPECT(!GridCache::readBricks(key, ResourceFormat::BC4Unorm).has_value());
+    std::filesystem::resize_file(cachePath, fileSize + 1);
+    EXPECT(!GridCache::readBricks(key, ResourceFormat::BC4Unorm).has_value());
+    std::filesystem::resize_file(cachePath, 8);
+    EXPECT(!GridCache::readBricks(key, ResourceFormat::BC4Unorm).has_value());
+
+    // Sizes that don't match the dimensions are rejected, even if they match the file size.
+    auto writeAndRead = [&](const BrickedGridData& data)
+    {
+        GridCache::writeBricks(key, data);
+        return GridCache::readBricks(key, ResourceFormat::BC4Unorm).has_value();
+    };
+    BrickedGridData data = createBrickData();
+    EXPECT(writeAndRead(data));
+    data.range.pop_back();
+    EXPECT(!writeAndRead(data));
+    data = createBrickData();
+    data.indirection.push_back(0);
+    EXPECT(!writeAndRead(data));
+    data = createBrickData();
+    data.atlasDim.z = 8;
+    EXPECT(!writeAndRead(data));
+    data = createBrickData();
+    data.rangeDim = uint3(0xffffffffu);
+    EXPECT(!writeAndRead(data));
+}
+} // namespace Falcor
@@ -0,0 +1,233 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Volume/GridStreamingScheduler.h"
+
+#include <algorithm>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+using FrameState = GridStreamingScheduler::FrameState;
+
+/// Complete all loads in a plan, using a fixed size per frame.
+void completeLoads(GridStreamingScheduler& scheduler, const GridStreamingScheduler::Plan& plan, uint64_t frameBytes)
+{
+    for (uint32_t frame : plan.loads)
+        scheduler.onLoadCompleted(frame, frameBytes);
+}
+
+bool contains(const std::vector<uint32_t>& v, uint32_t x)
+{
+    return std::find(v.begin(), v.end(), x) != v.end();
+}
+} // namespace
+
+CPU_TEST(GridStreamingScheduler_Prefetch)
+{
+    GridStreamingScheduler::Config config;
+    config.prefetchFrameCount = 3;
+    config.retainFrameCount = 1;
+    config.maxConcurrentLoads = 8;
+    GridStreamingScheduler scheduler(10, config);
+
+    // Frames are requested in order of distance ahead of the playhead, then behind it (wrapping around).
+    auto plan = scheduler.update(0);
+    EXPECT(plan.evictions.empty());
+    ASSERT_EQ(plan.loads.size(), 5);
+    EXPECT_EQ(plan.loads[0], 0);
+    EXPECT_EQ(plan.loads[1], 1);
+    EXPECT_EQ(plan.loads[2], 2);
+    EXPECT_EQ(plan.loads[3], 3);
+    EXPECT_EQ(plan.loads[4], 9);
+    EXPECT(scheduler.getFrameState(0) == FrameState::Loading);
+    EXPECT_EQ(scheduler.getLoadingFrameCount(), 5);
+
+    // Loading frames are not requested again.
+    EXPECT(scheduler.update(0).loads.empty());
+
+    completeLoads(scheduler, plan, 100);
+    EXPECT_EQ(scheduler.getResidentFrameCount(), 5);
+    EXPECT_EQ(scheduler.getResidentBytes(), 500);
+
+    // Advancing the playhead loads one new frame and evicts the one that left the window.
+    plan = scheduler.update(1);
+    ASSERT_EQ(plan.loads.size(), 1);
+    EXPECT_EQ(plan.loads[0], 4);
+    ASSERT_EQ(plan.evictions.size(), 1);
+    EXPECT_EQ(plan.evictions[0], 9);
+    EXPECT(scheduler.getFrameState(9) == FrameState::Unloaded);
+    EXPECT_EQ(scheduler.getResidentBytes(), 400);
+}
+
+CPU_TEST(GridStreamingScheduler_NoLoop)
+{
+    GridStreamingScheduler::Config config;
+    config.prefetchFrameCount = 4;
+    config.retainFrameCount = 2;
+    config.maxConcurrentLoads = 8;
+    config.loop = false;
+    GridStreamingScheduler scheduler(4, config);
+
+    auto plan = scheduler.update(2);
+    EXPECT_EQ(plan.loads.size(), 4);
+    EXPECT(contains(plan.loads, 0) && contains(plan.loads, 1) && contains(plan.loads, 3));
+    EXPECT_EQ(plan.loads[0], 2);
+}
+
+CPU_TEST(GridStreamingScheduler_ConcurrencyLimit)
+{
+    GridStreamingScheduler::Config config;
+    config.prefetchFrameCount = 8;
+    config.maxConcurrentLoads = 2;
+    GridStreamingScheduler scheduler(16, config);
+
+    auto plan = scheduler.update(0);
+    ASSERT_EQ(plan.loads.size(), 2);
+    EXPECT_EQ(plan.loads[0], 0);
+    EXPECT_EQ(plan.loads[1], 1);
+    EXPECT(scheduler.update(0).loads.empty());
+
+    // A failed frame frees its slot and is never requested again.
+    scheduler.onLoadFailed(1);
+    EXPECT(scheduler.getFrameState(1) == FrameState::Failed);
+    plan = scheduler.update(0);
+    ASSERT_EQ(plan.loads.size(), 1);
+    EXPECT_EQ(plan.loads[0], 2);
+}
+
+CPU_TEST(GridStreamingScheduler_MemoryBudget)
+{
+    GridStreamingScheduler::Config config;
+    config.prefetchFrameCount = 8;
+    config.retainFrameCount = 0;
+    config.maxConcurrentLoads = 1;
+    config.memoryBudget = 350;
+    GridStreamingScheduler scheduler(16, config);
+
+    // Without a size estimate only the concurrency limit applies.
+    auto plan = scheduler.update(0);
+    ASSERT_EQ(plan.loads.size(), 1);
+    completeLoads(scheduler, plan, 100);
+    EXPECT_EQ(scheduler.getEstimatedFrameBytes(), 100);
+
+    // Fill the window until the budget is reached (3 frames of 100 bytes).
+    for (int i = 0; i < 8; ++i)
+        completeLoads(scheduler, scheduler.update(0), 100);
+    EXPECT_EQ(scheduler.getResidentFrameCount(), 3);
+    EXPECT_LE(scheduler.getResidentBytes(), config.memoryBudget);
+    EXPECT(scheduler.getFrameState(3) == FrameState::Unloaded);
+
+    // A frame that turns out larger than estimated pushes the farthest frame out of the budget.
+    plan = scheduler.update(1);
+    ASSERT_EQ(plan.loads.size(), 1);
+    EXPECT_EQ(plan.loads[0], 3);
+    EXPECT_EQ(plan.evictions.size(), 1);
+    EXPECT_EQ(plan.evictions[0], 0);
+    scheduler.onLoadCompleted(3, 200);
+    plan = scheduler.update(1);
+    ASSERT_EQ(plan.evictions.size(), 1);
+    EXPECT_EQ(plan.evictions[0], 3);
+    EXPECT_LE(scheduler.getResidentBytes(), config.memoryBudget);
+
+    // The frame at the playhead is always kept, even if it exceeds the budget on its own.
+    scheduler.markResident(1, 1000);
+    plan = scheduler.update(1);
+    EXPECT(scheduler.getFrameState(1) == FrameState::Resident);
+    EXPECT_EQ(scheduler.getResidentFrameCount(), 1);
+    EXPECT(contains(plan.evictions, 2));
+}
+
+CPU_TEST(GridStreamingScheduler_RandomPlayback)
+{
+    // Simulate playback with random seeks and loads completing with a delay.
+    // Check that the bookkeeping is consistent and the budget is respected after loads have settled.
+    GridStreamingScheduler::Config config;
+    config.prefetchFrameCount = 6;
+    config.retainFrameCount = 2;
+    config.maxConcurrentLoads = 3;
+    config.memoryBudget = 1000;
+    const uint32_t frameCount = 240;
+    GridStreamingScheduler scheduler(frameCount, config);
+
+    std::mt19937 rng(1234);
+    std::vector<uint32_t> loading;
+    uint32_t playhead = 0;
+
+    for (uint32_t step = 0; step < 5000; ++step)
+    {
+        playhead = (rng() % 20 == 0) ? rng() % frameCount : (playhead + 1) % frameCount;
+
+        auto plan = scheduler.update(playhead);
+        loading.insert(loading.end(), plan.loads.begin(), plan.loads.end());
+
+        // Complete a random subset of pending loads with sizes around 100 bytes.
+        for (auto it = loading.begin(); it != loading.end();)
+        {
+            if (rng() % 2 == 0)
+            {
+                scheduler.onLoadCompleted(*it, 50 + rng() % 100);
+                it = loading.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        uint32_t residentCount = 0;
+        uint32_t loadingCount = 0;
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto state = scheduler.getFrameState(frame);
+            if (state == FrameState::Resident)
+                residentCount++;
+            if (state == FrameState::Loading)
+                loadingCount++;
+        }
+        ASSERT_EQ(residentCount, scheduler.getResidentFrameCount());
+        ASSERT_EQ(loadingCount, scheduler.getLoadingFrameCount());
+        ASSERT_EQ(loadingCount, loading.size());
+        ASSERT_LE(loadingCount, config.maxConcurrentLoads);
+        ASSERT_LE(residentCount, config.prefetchFrameCount + config.retainFrameCount + 1 + loadingCount);
+    }
+
+    // Let all loads finish and settle. The budget must now be respected.
+    while (!loading.empty())
+    {
+        for (uint32_t frame : loading)
+            scheduler.onLoadCompleted(frame, 100);
+        loading = scheduler.update(playhead).loads;
+    }
+    scheduler.update(playhead);
+    EXPECT_LE(scheduler.getResidentBytes(), config.memoryBudget);
+    EXPECT(scheduler.getFrameState(playhead) == FrameState::Resident);
+}
+} // namespace Falcor
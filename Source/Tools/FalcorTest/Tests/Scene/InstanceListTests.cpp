@@ -0,0 +1,173 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/InstanceList.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
+// The scatter benchmark is disabled by default as it groups a million instance lists and only logs timings.
+// Enable it when changing InstanceList or the mesh grouping in SceneBuilder.
+// #define RUN_INSTANCE_LIST_BENCHMARK
+
+namespace Falcor
+{
+CPU_TEST(InstanceList_Basic)
+{
+    InstanceList list;
+    EXPECT(list.empty());
+    EXPECT_EQ(list.getSignature(), 0);
+
+    // Insertion keeps the list sorted and unique.
+    EXPECT(list.insert(NodeID(5)));
+    EXPECT(list.insert(NodeID(9)));
+    EXPECT(list.insert(NodeID(1)));
+    EXPECT(list.insert(NodeID(7)));
+    EXPECT(!list.insert(NodeID(5)));
+    ASSERT_EQ(list.size(), 4);
+    EXPECT_EQ(list[0].get(), 1);
+    EXPECT_EQ(list[1].get(), 5);
+    EXPECT_EQ(list[2].get(), 7);
+    EXPECT_EQ(list[3].get(), 9);
+    EXPECT_EQ(list.rbegin()->get(), 9);
+    EXPECT(list.contains(NodeID(7)));
+    EXPECT(!list.contains(NodeID(6)));
+
+    // The signature does not depend on the insertion order.
+    InstanceList other;
+    for (uint32_t id : {9, 7, 5, 1})
+        other.insert(NodeID(id));
+    EXPECT(list == other);
+    EXPECT_EQ(list.getSignature(), other.getSignature());
+
+    // Removal updates the signature.
+    EXPECT(list.erase(NodeID(7)));
+    EXPECT(!list.erase(NodeID(7)));
+    EXPECT(list != other);
+    EXPECT_NE(list.getSignature(), other.getSignature());
+    list.insert(NodeID(7));
+    EXPECT(list == other);
+
+    list.clear();
+    EXPECT(list.empty());
+    EXPECT_EQ(list.getSignature(), 0);
+}
+
+CPU_TEST(InstanceList_Groups)
+{
+    std::vector<InstanceList> lists(6);
+    for (uint32_t id : {1, 2, 3})
+    {
+        lists[0].insert(NodeID(id));
+        lists[2].insert(NodeID(id));
+        lists[5].insert(NodeID(id));
+    }
+    for (uint32_t id : {4, 5})
+    {
+        lists[1].insert(NodeID(id));
+        lists[4].insert(NodeID(id));
+    }
+    lists[3].insert(NodeID(1));
+
+    InstanceListGroups<uint32_t> groups;
+    for (uint32_t i = 0; i < lists.size(); ++i)
+        groups.add(lists[i], i);
+
+    // Groups are ordered by first occurrence.
+    ASSERT_EQ(groups.size(), 3);
+    EXPECT_EQ(groups.getItemCount(), 6);
+    EXPECT(groups.getGroups()[0] == std::vector<uint32_t>({0, 2, 5}));
+    EXPECT(groups.getGroups()[1] == std::vector<uint32_t>({1, 4}));
+    EXPECT(groups.getGroups()[2] == std::vector<uint32_t>({3}));
+}
+
+#ifdef RUN_INSTANCE_LIST_BENCHMARK
+CPU_TEST(InstanceList_ScatterBenchmark)
+#else
+CPU_TEST(InstanceList_ScatterBenchmark, "Disabled for performance reasons")
+#endif
+{
+    // Synthetic scatter scene: a number of prototype objects made of a few meshes each, scattered at random.
+    // Each scatter instance is a node instancing all meshes of its prototype.
+    const uint32_t prototypeCount = 100;
+    const uint32_t meshesPerPrototype = 4;
+    const uint32_t instancesPerPrototype = 2500;
+    const uint32_t meshCount = prototypeCount * meshesPerPrototype;
+
+    std::vector<uint32_t> nodePrototypes(prototypeCount * instancesPerPrototype);
+    for (size_t i = 0; i < nodePrototypes.size(); ++i)
+        nodePrototypes[i] = uint32_t(i % prototypeCount);
+    std::shuffle(nodePrototypes.begin(), nodePrototypes.end(), std::mt19937(1234));
+
+    // Reference: std::set instance lists grouped in a std::map.
+    auto t0 = CpuTimer::getCurrentTimePoint();
+    std::vector<std::set<NodeID>> sets(meshCount);
+    for (uint32_t nodeID = 0; nodeID < nodePrototypes.size(); ++nodeID)
+    {
+        for (uint32_t i = 0; i < meshesPerPrototype; ++i)
+            sets[nodePrototypes[nodeID] * meshesPerPrototype + i].insert(NodeID(nodeID));
+    }
+    std::map<std::set<NodeID>, std::vector<uint32_t>> setGroups;
+    for (uint32_t meshID = 0; meshID < meshCount; ++meshID)
+        setGroups[sets[meshID]].push_back(meshID);
+    auto t1 = CpuTimer::getCurrentTimePoint();
+
+    // Instance lists grouped by signature.
+    std::vector<InstanceList> lists(meshCount);
+    for (uint32_t nodeID = 0; nodeID < nodePrototypes.size(); ++nodeID)
+    {
+        for (uint32_t i = 0; i < meshesPerPrototype; ++i)
+            lists[nodePrototypes[nodeID] * meshesPerPrototype + i].insert(NodeID(nodeID));
+    }
+    InstanceListGroups<uint32_t> listGroups;
+    for (uint32_t meshID = 0; meshID < meshCount; ++meshID)
+        listGroups.add(lists[meshID], meshID);
+    auto t2 = CpuTimer::getCurrentTimePoint();
+
+    // Both must produce one group per prototype containing its meshes.
+    EXPECT_EQ(setGroups.size(), prototypeCount);
+    ASSERT_EQ(listGroups.size(), prototypeCount);
+    for (const auto& meshes : listGroups.getGroups())
+    {
+        ASSERT_EQ(meshes.size(), meshesPerPrototype);
+        EXPECT(setGroups[sets[meshes[0]]] == meshes);
+    }
+
+    logInfo(
+        "Grouping {} meshes with {} instances each: std::set {:.2f} ms, InstanceList {:.2f} ms.",
+        meshCount,
+        instancesPerPrototype,
+        CpuTimer::calcDuration(t0, t1),
+        CpuTimer::calcDuration(t1, t2)
+    );
+}
+} // namespace Falcor
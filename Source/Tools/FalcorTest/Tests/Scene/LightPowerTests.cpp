@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Lights/Light.h"
+#include "Scene/Lights/LightPower.h"
+
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+const float kPi = (float)M_PI;
+}
+
+CPU_TEST(LightPower_SpotSolidAngle)
+{
+    // Hard cut-off: the solid angle of the cone.
+    for (float angle : {0.f, 0.1f, 0.25f * kPi, 0.5f * kPi, 2.f, kPi})
+        EXPECT_LE(std::abs(computeSpotLightSolidAngle(angle, 0.f) - 2.f * kPi * (1.f - std::cos(angle))), 1e-5f) << "angle=" << angle;
+
+    // Smoothstep penumbra over the whole opening angle. The integrals are evaluated analytically:
+    // openingAngle = pi: 2pi * int_0^pi (1 - 3(x/pi)^2 + 2(x/pi)^3) sin(x) dx = 2pi.
+    EXPECT_LE(std::abs(computeSpotLightSolidAngle(kPi, kPi) - 2.f * kPi), 1e-5f);
+    // openingAngle = pi/2: 2pi * (1 + 24/pi^2 - 96/pi^3).
+    const float expected = 2.f * kPi * (1.f + 24.f / (kPi * kPi) - 96.f / (kPi * kPi * kPi));
+    EXPECT_LE(std::abs(computeSpotLightSolidAngle(0.5f * kPi, 0.5f * kPi) - expected), 1e-5f);
+
+    // A penumbra only removes light from the cone, and more so the wider it is.
+    float prev = computeSpotLightSolidAngle(1.f, 0.f);
+    for (float penumbra : {0.2f, 0.5f, 1.f})
+    {
+        float solidAngle = computeSpotLightSolidAngle(1.f, penumbra);
+        EXPECT_LT(solidAngle, prev);
+        EXPECT_GT(solidAngle, computeSpotLightSolidAngle(1.f - penumbra, 0.f));
+        prev = solidAngle;
+    }
+}
+
+CPU_TEST(LightPower_Lights)
+{
+    // Point light: intensity times solid angle.
+    auto pPointLight = PointLight::create();
+    pPointLight->setIntensity(float3(2.f));
+    EXPECT_LE(std::abs(pPointLight->getPower() - 8.f * kPi), 1e-4f);
+    pPointLight->setOpeningAngle(0.25f * kPi);
+    EXPECT_LE(std::abs(pPointLight->getPower() - 4.f * kPi * (1.f - std::cos(0.25f * kPi))), 1e-4f);
+    EXPECT_EQ(estimateLightPower(*pPointLight, 100.f), pPointLight->getPower());
+
+    // Area lights: pi times radiance times area.
+    auto pRectLight = RectLight::create();
+    pRectLight->setIntensity(float3(2.f));
+    pRectLight->setScaling(float3(2.f, 3.f, 1.f));
+    EXPECT_LE(std::abs(pRectLight->getPower() - kPi * 2.f * 24.f), 1e-3f);
+
+    auto pDiscLight = DiscLight::create();
+    pDiscLight->setIntensity(float3(2.f));
+    pDiscLight->setScaling(float3(2.f, 3.f, 1.f));
+    EXPECT_LE(std::abs(pDiscLight->getPower() - kPi * 2.f * kPi * 6.f), 1e-3f);
+
+    // Directional light: irradiance times scene cross-section.
+    auto pDirectionalLight = DirectionalLight::create();
+    pDirectionalLight->setIntensity(float3(2.f));
+    EXPECT_LE(std::abs(estimateLightPower(*pDirectionalLight, 10.f) - 2.f * kPi * 100.f), 1e-3f);
+}
+} // namespace Falcor
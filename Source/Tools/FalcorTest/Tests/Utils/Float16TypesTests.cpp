@@ -27,8 +27,15 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Math/ScalarMath.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
 #include <fstd/bit.h> // TODO C++20: Replace with <bit>
 #include <random>
+#include <vector>
+
+// The bulk conversion benchmark is disabled by default as it converts 16M values and only logs timings.
+// Enable it to compare the bulk conversion against the scalar f32tof16/f16tof32 loops.
+// #define RUN_FLOAT16_BULK_BENCHMARK
 
 namespace Falcor
 {
@@ -162,4 +169,100 @@ CPU_TEST(Float16Scalar)
         EXPECT_EQ(fstd::bit_cast<uint16_t>(result), fstd::bit_cast<uint16_t>(expected));
     }
 }
+
+CPU_TEST(Float16RoundToNearestEven)
+{
+    // Ties are rounded to the even mantissa.
+    EXPECT_EQ(math::f32tof16(0x1.0060p0f), math::f32tof16(0x1.0080p0f));
+    EXPECT_EQ(math::f32tof16(0x1.00a0p0f), math::f32tof16(0x1.0080p0f));
+    EXPECT_EQ(math::f32tof16(0x1.00e0p0f), math::f32tof16(0x1.0100p0f));
+    EXPECT_EQ(math::f32tof16(0x1.005fp0f), math::f32tof16(0x1.0040p0f));
+    EXPECT_EQ(math::f32tof16(0x1.0061p0f), math::f32tof16(0x1.0080p0f));
+
+    // Ties in the denormal range.
+    EXPECT_EQ(math::f32tof16(0x1p-25f), 0x0000);     // Half of the smallest denormal rounds to zero.
+    EXPECT_EQ(math::f32tof16(0x1.8p-24f), 0x0002);   // 1.5 denormal steps rounds to 2.
+    EXPECT_EQ(math::f32tof16(0x1.4p-23f), 0x0002);   // 2.5 denormal steps rounds to 2.
+    EXPECT_EQ(math::f32tof16(0x1.ffcp-15f), 0x0400); // Rounding up to the smallest normal.
+
+    // Overflow.
+    EXPECT_EQ(math::f32tof16(65504.f), 0x7bff);
+    EXPECT_EQ(math::f32tof16(65519.f), 0x7bff);
+    EXPECT_EQ(math::f32tof16(65520.f), 0x7c00);
+    EXPECT_EQ(math::f32tof16(-65520.f), 0xfc00);
+}
+
+CPU_TEST(Float16Bulk)
+{
+    // Test conversion to float for all bit patterns.
+    std::vector<uint16_t> halfs(0x10000);
+    for (uint32_t bits = 0; bits < 0x10000; bits++)
+        halfs[bits] = (uint16_t)bits;
+    std::vector<float> floats(halfs.size());
+    math::float16ToFloat32(halfs, floats);
+    for (uint32_t bits = 0; bits < 0x10000; bits++)
+    {
+        float expected = math::f16tof32(bits);
+        if (std::isnan(expected))
+            EXPECT(std::isnan(floats[bits]));
+        else
+            EXPECT_EQ(fstd::bit_cast<uint32_t>(floats[bits]), fstd::bit_cast<uint32_t>(expected)) << "bits = " << bits;
+    }
+
+    // Test conversion from float for random bit patterns (covering denormals, ties and overflow).
+    // Use a size that is not a multiple of the vector width to test the tail.
+    std::mt19937 rng;
+    std::vector<float> values(100003);
+    for (auto& v : values)
+    {
+        do
+            v = fstd::bit_cast<float>((uint32_t)rng());
+        while (std::isnan(v));
+    }
+    values[0] = 0x1.0060p0f;
+    values[1] = -0x1p-25f;
+    values[2] = 65520.f;
+    std::vector<uint16_t> result(values.size());
+    math::float32ToFloat16(values, result);
+    for (size_t i = 0; i < values.size(); i++)
+        EXPECT_EQ(result[i], math::f32tof16(values[i])) << "v = " << values[i] << " (i = " << i << ")";
+
+    EXPECT_THROW(math::float32ToFloat16(values, fstd::span<uint16_t>(result.data(), 1)));
+}
+
+#ifdef RUN_FLOAT16_BULK_BENCHMARK
+CPU_TEST(Float16BulkBenchmark)
+#else
+CPU_TEST(Float16BulkBenchmark, "Disabled for performance reasons")
+#endif
+{
+    const size_t count = 1 << 24;
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float> values(count);
+    for (auto& v : values)
+        v = dist(rng);
+    std::vector<uint16_t> halfs(count);
+
+    auto t0 = CpuTimer::getCurrentTimePoint();
+    for (size_t i = 0; i < count; i++)
+        halfs[i] = (uint16_t)math::f32tof16(values[i]);
+    auto t1 = CpuTimer::getCurrentTimePoint();
+    math::float32ToFloat16(values, halfs);
+    auto t2 = CpuTimer::getCurrentTimePoint();
+    for (size_t i = 0; i < count; i++)
+        values[i] = math::f16tof32(halfs[i]);
+    auto t3 = CpuTimer::getCurrentTimePoint();
+    math::float16ToFloat32(halfs, values);
+    auto t4 = CpuTimer::getCurrentTimePoint();
+
+    logInfo(
+        "float32ToFloat16: scalar {:.2f} ms, bulk {:.2f} ms. float16ToFloat32: scalar {:.2f} ms, bulk {:.2f} ms ({} values).",
+        CpuTimer::calcDuration(t0, t1),
+        CpuTimer::calcDuration(t1, t2),
+        CpuTimer::calcDuration(t2, t3),
+        CpuTimer::calcDuration(t3, t4),
+        count
+    );
+}
 } // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Utils/Math/HashUtils.h"
 #include <vector>
 
 // The perfect hash tests are disabled by default as they take a really long time to run.
@@ -35,22 +36,6 @@
 
 namespace Falcor
 {
-namespace
-{
-/** Jenkins hash. This should match HashUtils.slang.
- */
-uint32_t jenkinsHash(uint32_t a)
-{
-    a = (a + 0x7ed55d16) + (a << 12);
-    a = (a ^ 0xc761c23c) ^ (a >> 19);
-    a = (a + 0x165667b1) + (a << 5);
-    a = (a + 0xd3a2646c) ^ (a << 9);
-    a = (a + 0xfd7046c5) + (a << 3);
-    a = (a ^ 0xb55a4f09) ^ (a >> 16);
-    return a;
-}
-} // namespace
-
 GPU_TEST(JenkinsHash_CompareToCPU)
 {
     ref<Device> pDevice = ctx.getDevice();
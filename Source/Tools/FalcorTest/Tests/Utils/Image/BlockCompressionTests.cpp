@@ -0,0 +1,239 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/BlockCompression.h"
+#include "Scene/Volume/BC4Encode.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Generate test tiles: random noise, smooth gradients, constant values and gradients touching 0/255.
+std::vector<uint8_t> generateTiles(uint32_t count, uint32_t channels, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> tiles(count * 16 * channels);
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        uint8_t* pTile = tiles.data() + t * 16 * channels;
+        uint32_t kind = t % 4;
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            int base = rng() % 256;
+            int dx = (int)(rng() % 31) - 15;
+            int dy = (int)(rng() % 31) - 15;
+            for (int i = 0; i < 16; ++i)
+            {
+                int x = i % 4, y = i / 4;
+                int value = 0;
+                if (kind == 0)
+                    value = rng() % 256;
+                else if (kind == 1)
+                    value = base + x * dx + y * dy + (int)(rng() % 5) - 2;
+                else if (kind == 2)
+                    value = base;
+                else
+                    value = (x + y) * 64 - 64 + (int)(rng() % 9);
+                pTile[i * channels + c] = (uint8_t)std::clamp(value, 0, 255);
+            }
+        }
+    }
+    return tiles;
+}
+
+uint64_t squaredError(const uint8_t* pA, const uint8_t* pB, size_t count, size_t stride = 1, size_t channels = 1)
+{
+    uint64_t err = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t c = 0; c < channels; ++c)
+        {
+            int d = (int)pA[i * stride + c] - (int)pB[i * stride + c];
+            err += d * d;
+        }
+    }
+    return err;
+}
+} // namespace
+
+CPU_TEST(BlockCompression_BC4MatchesScalar)
+{
+    // The high quality BC4 encoder must produce the same blocks as the scalar libsquish port.
+    const uint32_t count = 20000;
+    auto tiles = generateTiles(count, 1, 1);
+    std::vector<uint64_t> blocks(count);
+    encodeBC4Blocks(tiles.data(), count, blocks.data(), BCQuality::High);
+
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        uint64_t ref = 0;
+        CompressAlphaDxt5(tiles.data() + t * 16, &ref);
+        ASSERT_EQ(blocks[t], ref) << "tile " << t;
+    }
+}
+
+CPU_TEST(BlockCompression_BC4Quality)
+{
+    const uint32_t count = 20000;
+    auto tiles = generateTiles(count, 1, 2);
+    uint64_t errHigh = 0, errFast = 0;
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        const uint8_t* pTile = tiles.data() + t * 16;
+        uint64_t block;
+        uint8_t decoded[16];
+
+        encodeBC4Block(pTile, &block, BCQuality::High);
+        decodeBC4Block(&block, decoded);
+        errHigh += squaredError(pTile, decoded, 16);
+
+        encodeBC4Block(pTile, &block, BCQuality::Fast);
+        decodeBC4Block(&block, decoded);
+        errFast += squaredError(pTile, decoded, 16);
+
+        // Constant tiles are encoded exactly.
+        if (t % 4 == 2)
+            EXPECT_EQ(squaredError(pTile, decoded, 16), 0);
+    }
+
+    // The fast mode only uses one of the two modes, so it can only be worse.
+    EXPECT_LE(errHigh, errFast);
+    double rmseHigh = std::sqrt((double)errHigh / (count * 16));
+    double rmseFast = std::sqrt((double)errFast / (count * 16));
+    EXPECT_LT(rmseHigh, 6.5);
+    EXPECT_LT(rmseFast, 7.5);
+}
+
+CPU_TEST(BlockCompression_BC1Quality)
+{
+    const uint32_t count = 20000;
+    auto tiles = generateTiles(count, 4, 3);
+    uint64_t errHigh = 0, errFast = 0, errSmooth = 0;
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        const uint8_t* pTile = tiles.data() + t * 64;
+        uint8_t block[8];
+        uint8_t decoded[64];
+
+        encodeBC1Block(pTile, block, BCQuality::High);
+        decodeBC1Block(block, decoded);
+        uint64_t err = squaredError(pTile, decoded, 16, 4, 3);
+        errHigh += err;
+        if (t % 4 == 1)
+            errSmooth += err;
+
+        // Constant tiles are within the 565 quantization error.
+        if (t % 4 == 2)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                EXPECT_LE(std::abs((int)pTile[4 * i + 0] - (int)decoded[4 * i + 0]), 4);
+                EXPECT_LE(std::abs((int)pTile[4 * i + 1] - (int)decoded[4 * i + 1]), 2);
+                EXPECT_LE(std::abs((int)pTile[4 * i + 2] - (int)decoded[4 * i + 2]), 4);
+            }
+        }
+
+        encodeBC1Block(pTile, block, BCQuality::Fast);
+        decodeBC1Block(block, decoded);
+        errFast += squaredError(pTile, decoded, 16, 4, 3);
+    }
+
+    EXPECT_LE(errHigh, errFast);
+    EXPECT_LT(std::sqrt((double)errSmooth / (count / 4 * 48)), 8.0);
+}
+
+CPU_TEST(BlockCompression_BC5)
+{
+    // BC5 is two independent BC4 blocks.
+    const uint32_t count = 1000;
+    auto tiles = generateTiles(count, 2, 4);
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        const uint8_t* pTile = tiles.data() + t * 32;
+        uint8_t red[16], green[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            red[i] = pTile[2 * i];
+            green[i] = pTile[2 * i + 1];
+        }
+
+        uint64_t block[2];
+        encodeBC5Block(pTile, block);
+        uint64_t ref[2];
+        CompressAlphaDxt5(red, &ref[0]);
+        CompressAlphaDxt5(green, &ref[1]);
+        EXPECT_EQ(block[0], ref[0]);
+        EXPECT_EQ(block[1], ref[1]);
+
+        uint8_t decoded[32];
+        decodeBC5Block(block, decoded);
+        uint8_t decodedRed[16];
+        decodeBC4Block(&ref[0], decodedRed);
+        for (int i = 0; i < 16; ++i)
+            EXPECT_EQ(decoded[2 * i], decodedRed[i]);
+    }
+}
+
+CPU_TEST(BlockCompression_Image)
+{
+    // Encode an image with dimensions that are not a multiple of 4 and compare against encoding padded blocks.
+    const uint32_t width = 37, height = 22;
+    const size_t rowPitch = width * 4 + 12;
+    std::mt19937 rng(5);
+    std::vector<uint8_t> image(rowPitch * height);
+    for (auto& v : image)
+        v = (uint8_t)(rng() % 256);
+
+    const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    std::vector<uint64_t> blocks(blocksX * blocksY);
+    encodeBCImage(ResourceFormat::BC1Unorm, image.data(), width, height, rowPitch, blocks.data());
+
+    for (uint32_t by = 0; by < blocksY; ++by)
+    {
+        for (uint32_t bx = 0; bx < blocksX; ++bx)
+        {
+            uint8_t tile[64];
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t x = std::min(bx * 4 + i % 4, width - 1);
+                uint32_t y = std::min(by * 4 + i / 4, height - 1);
+                std::memcpy(tile + 4 * i, image.data() + y * rowPitch + x * 4, 4);
+            }
+            uint64_t ref;
+            encodeBC1Block(tile, &ref);
+            EXPECT_EQ(blocks[by * blocksX + bx], ref);
+        }
+    }
+
+    EXPECT_THROW(encodeBCImage(ResourceFormat::BC7Unorm, image.data(), width, height, rowPitch, blocks.data()));
+}
+} // namespace Falcor
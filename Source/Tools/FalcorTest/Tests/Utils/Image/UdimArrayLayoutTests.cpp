@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/UdimArrayLayout.h"
+
+namespace Falcor
+{
+namespace
+{
+UdimArrayLayout::Tile makeTile(uint32_t udim, uint32_t size, ResourceFormat format = ResourceFormat::RGBA8Unorm, uint32_t mipCount = 0)
+{
+    return {udim, size, size, format, mipCount};
+}
+} // namespace
+
+CPU_TEST(UdimArrayLayout_SingleGroup)
+{
+    // Tiles are given out of order. Slices are assigned in UDIM order.
+    std::vector<UdimArrayLayout::Tile> tiles = {makeTile(1003, 512), makeTile(1001, 512), makeTile(1012, 512), makeTile(1002, 512)};
+    UdimArrayLayout layout(tiles);
+
+    ASSERT_EQ(layout.getArrays().size(), 1);
+    EXPECT_EQ(layout.getStandaloneTileCount(), 0);
+    const auto& array = layout.getArrays()[0];
+    EXPECT_EQ(array.width, 512);
+    EXPECT_EQ(array.height, 512);
+    EXPECT(array.format == ResourceFormat::RGBA8Unorm);
+    EXPECT_EQ(array.mipCount, 0);
+    ASSERT_EQ(array.tiles.size(), 4);
+    EXPECT_EQ(array.tiles[0], 1);
+    EXPECT_EQ(array.tiles[1], 3);
+    EXPECT_EQ(array.tiles[2], 0);
+    EXPECT_EQ(array.tiles[3], 2);
+
+    for (uint32_t i = 0; i < layout.getTileCount(); ++i)
+    {
+        const auto& location = layout.getLocation(i);
+        EXPECT_EQ(location.arrayIndex, 0);
+        EXPECT_EQ(array.tiles[location.slice], i);
+    }
+}
+
+CPU_TEST(UdimArrayLayout_Groups)
+{
+    // Tiles are grouped by size, format and mip count. Groups are ordered by their lowest UDIM.
+    std::vector<UdimArrayLayout::Tile> tiles = {
+        makeTile(1001, 1024),
+        makeTile(1002, 512),
+        makeTile(1003, 1024),
+        makeTile(1004, 512),
+        makeTile(1005, 1024, ResourceFormat::RGBA8UnormSrgb),
+        makeTile(1006, 1024, ResourceFormat::RGBA8Unorm, 11),
+        makeTile(1007, 1024, ResourceFormat::RGBA8Unorm, 11),
+        makeTile(1008, 512),
+    };
+    UdimArrayLayout layout(tiles);
+
+    ASSERT_EQ(layout.getArrays().size(), 3);
+    EXPECT_EQ(layout.getStandaloneTileCount(), 1);
+
+    const auto& arrays = layout.getArrays();
+    EXPECT_EQ(arrays[0].width, 1024);
+    EXPECT(arrays[0].tiles == std::vector<uint32_t>({0, 2}));
+    EXPECT_EQ(arrays[1].width, 512);
+    EXPECT(arrays[1].tiles == std::vector<uint32_t>({1, 3, 7}));
+    EXPECT_EQ(arrays[2].mipCount, 11);
+    EXPECT(arrays[2].tiles == std::vector<uint32_t>({5, 6}));
+
+    // The sRGB tile has no compatible tiles and stays standalone.
+    EXPECT_EQ(layout.getLocation(4).arrayIndex, UdimArrayLayout::kNoArray);
+    EXPECT_EQ(layout.getLocation(7).arrayIndex, 1);
+    EXPECT_EQ(layout.getLocation(7).slice, 2);
+    EXPECT_EQ(layout.getLocation(6).arrayIndex, 2);
+    EXPECT_EQ(layout.getLocation(6).slice, 1);
+}
+
+CPU_TEST(UdimArrayLayout_ArraySizeLimits)
+{
+    std::vector<UdimArrayLayout::Tile> tiles;
+    for (uint32_t i = 0; i < 98; ++i)
+        tiles.push_back(makeTile(1001 + i, 256));
+
+    // Groups are split into arrays of at most maxArraySize slices.
+    // The remaining chunk is smaller than minArraySize and stays standalone.
+    UdimArrayLayout layout(tiles, 3, 32);
+    ASSERT_EQ(layout.getArrays().size(), 3);
+    EXPECT_EQ(layout.getStandaloneTileCount(), 2);
+    for (const auto& array : layout.getArrays())
+        EXPECT_EQ(array.tiles.size(), 32);
+    EXPECT_EQ(layout.getLocation(33).arrayIndex, 1);
+    EXPECT_EQ(layout.getLocation(33).slice, 1);
+    EXPECT_EQ(layout.getLocation(96).arrayIndex, UdimArrayLayout::kNoArray);
+
+    // With a large enough minimum nothing is packed.
+    UdimArrayLayout unpacked(tiles, 99);
+    EXPECT(unpacked.getArrays().empty());
+    EXPECT_EQ(unpacked.getStandaloneTileCount(), 98);
+}
+
+CPU_TEST(UdimArrayLayout_Invalid)
+{
+    EXPECT_THROW(UdimArrayLayout({makeTile(1001, 256), makeTile(1001, 256)}));
+    EXPECT_THROW(UdimArrayLayout({makeTile(1001, 0)}));
+    EXPECT_THROW(UdimArrayLayout({makeTile(1001, 256)}, 2, 0));
+
+    UdimArrayLayout empty({});
+    EXPECT_EQ(empty.getTileCount(), 0);
+    EXPECT(empty.getArrays().empty());
+}
+} // namespace Falcor
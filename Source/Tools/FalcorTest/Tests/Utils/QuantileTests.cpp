@@ -0,0 +1,169 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/Quantile.h"
+#include "Utils/Algorithm/ParallelQuantile.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const float kQuantiles[] = {0.f, 0.01f, 0.25f, 0.5f, 0.75f, 0.99f, 1.f};
+
+/// Compute a quantile from sorted values.
+float referenceQuantile(const std::vector<float>& sorted, float quantile)
+{
+    auto ranks = QuantileRanks::compute(sorted.size(), quantile);
+    return ranks.interpolate(sorted[ranks.lower], sorted[ranks.upper]);
+}
+
+/// Generate test sets: random values of various distributions and sizes, including duplicates, negative values and infinities.
+std::vector<std::vector<float>> generateSets()
+{
+    std::vector<std::vector<float>> sets;
+    std::mt19937 rng(1234);
+
+    sets.push_back({1.f});
+    sets.push_back({2.f, 1.f});
+    sets.push_back({3.f, -1.f, 2.f});
+    sets.push_back(std::vector<float>(1000, 0.5f));
+    sets.push_back({-0.f, 0.f, -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), 1e-40f, -1e-40f});
+
+    for (uint32_t count : {100u, 10000u, 1000000u})
+    {
+        std::uniform_real_distribution<float> uniform(-100.f, 100.f);
+        std::lognormal_distribution<float> lognormal(0.f, 3.f);
+        std::uniform_int_distribution<int> small(0, 10);
+
+        std::vector<float> a(count), b(count), c(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            a[i] = uniform(rng);
+            b[i] = lognormal(rng);
+            c[i] = (float)small(rng);
+        }
+        sets.push_back(std::move(a));
+        sets.push_back(std::move(b));
+        sets.push_back(std::move(c));
+    }
+    return sets;
+}
+} // namespace
+
+CPU_TEST(Quantile_OrderedKey)
+{
+    const float values[] = {
+        -std::numeric_limits<float>::infinity(), -1e30f, -1.f, -1e-40f, -0.f, 0.f, 1e-40f, 1.f, 1e30f, std::numeric_limits<float>::infinity()};
+    for (size_t i = 0; i < std::size(values); ++i)
+    {
+        EXPECT_EQ(orderedKeyToFloat(floatToOrderedKey(values[i])), values[i]);
+        if (i > 0)
+            EXPECT_LT(floatToOrderedKey(values[i - 1]), floatToOrderedKey(values[i]));
+    }
+}
+
+CPU_TEST(Quantile_Ranks)
+{
+    auto ranks = QuantileRanks::compute(4, 0.5f);
+    EXPECT_EQ(ranks.lower, 1);
+    EXPECT_EQ(ranks.upper, 2);
+    EXPECT_EQ(ranks.weight, 0.5f);
+
+    ranks = QuantileRanks::compute(5, 0.5f);
+    EXPECT_EQ(ranks.lower, 2);
+    EXPECT_EQ(ranks.weight, 0.f);
+
+    ranks = QuantileRanks::compute(5, 1.f);
+    EXPECT_EQ(ranks.lower, 4);
+    EXPECT_EQ(ranks.upper, 4);
+
+    EXPECT_THROW(QuantileRanks::compute(0, 0.5f));
+    EXPECT_THROW(QuantileRanks::compute(4, 1.5f));
+}
+
+CPU_TEST(Quantile_OrderStatistics)
+{
+    for (const auto& values : generateSets())
+    {
+        std::vector<float> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<uint64_t> ranks = {0, sorted.size() / 3, sorted.size() / 2, sorted.size() - 1};
+        std::vector<float> results(ranks.size());
+        selectOrderStatistics(values, ranks, results);
+        for (size_t i = 0; i < ranks.size(); ++i)
+            EXPECT_EQ(results[i], sorted[ranks[i]]) << "count=" << values.size() << " rank=" << ranks[i];
+    }
+
+    std::vector<float> values = {1.f, 2.f};
+    std::vector<uint64_t> ranks = {2};
+    std::vector<float> results(1);
+    EXPECT_THROW(selectOrderStatistics(values, ranks, results));
+}
+
+CPU_TEST(Quantile_Quantiles)
+{
+    for (const auto& values : generateSets())
+    {
+        std::vector<float> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<float> results(std::size(kQuantiles));
+        computeQuantiles(values, kQuantiles, results);
+        for (size_t i = 0; i < std::size(kQuantiles); ++i)
+            EXPECT_EQ(results[i], referenceQuantile(sorted, kQuantiles[i])) << "count=" << values.size() << " q=" << kQuantiles[i];
+
+        EXPECT_EQ(computeMedian(values), referenceQuantile(sorted, 0.5f));
+    }
+}
+
+GPU_TEST(ParallelQuantile)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ParallelQuantile parallelQuantile(pDevice);
+
+    for (const auto& values : generateSets())
+    {
+        ref<Buffer> pValues = pDevice->createTypedBuffer<float>(
+            (uint32_t)values.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, values.data()
+        );
+
+        std::vector<float> results(std::size(kQuantiles));
+        parallelQuantile.execute(ctx.getRenderContext(), pValues, (uint32_t)values.size(), kQuantiles, results);
+
+        std::vector<float> expected(std::size(kQuantiles));
+        computeQuantiles(values, kQuantiles, expected);
+        for (size_t i = 0; i < std::size(kQuantiles); ++i)
+            EXPECT_EQ(results[i], expected[i]) << "count=" << values.size() << " q=" << kQuantiles[i];
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,237 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/TLSFAllocator.h"
+#include "Utils/Math/Common.h"
+
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+bool overlaps(const TLSFAllocator::Allocation& a, const TLSFAllocator::Allocation& b)
+{
+    return a.page == b.page && a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+} // namespace
+
+CPU_TEST(TLSFAllocator_Basic)
+{
+    TLSFAllocator allocator;
+
+    // Nothing can be allocated without pages.
+    EXPECT(!allocator.allocate(16).isValid());
+
+    uint32_t page = allocator.addPage(1024);
+    auto a = allocator.allocate(100);
+    auto b = allocator.allocate(200);
+    auto c = allocator.allocate(300);
+    ASSERT(a.isValid() && b.isValid() && c.isValid());
+    EXPECT_EQ(a.page, page);
+    EXPECT(!overlaps(a, b) && !overlaps(a, c) && !overlaps(b, c));
+    EXPECT_EQ(allocator.getStats().allocationCount, 3);
+    EXPECT_EQ(allocator.getStats().allocatedBytes, 600);
+    EXPECT(!allocator.isPageEmpty(page));
+    allocator.validate();
+
+    // The page is too small for another large allocation.
+    EXPECT(!allocator.allocate(500).isValid());
+
+    // Freeing everything merges the blocks back into a single block.
+    allocator.free(b);
+    allocator.validate();
+    allocator.free(a);
+    allocator.validate();
+    allocator.free(c);
+    allocator.validate();
+    EXPECT(allocator.isPageEmpty(page));
+    auto stats = allocator.getStats();
+    EXPECT_EQ(stats.freeBlockCount, 1);
+    EXPECT_EQ(stats.largestFreeBlock, 1024);
+    EXPECT_EQ(stats.getFragmentation(), 0.0);
+
+    // The whole page can be allocated.
+    auto d = allocator.allocate(1024);
+    EXPECT(d.isValid());
+    EXPECT_EQ(d.offset, 0);
+    allocator.free(d);
+}
+
+CPU_TEST(TLSFAllocator_Alignment)
+{
+    TLSFAllocator allocator;
+    allocator.addPage(1 << 16);
+
+    std::vector<TLSFAllocator::Allocation> allocations;
+    for (uint64_t alignment : {1, 4, 16, 256, 48, 4096})
+    {
+        auto allocation = allocator.allocate(10, alignment);
+        ASSERT(allocation.isValid());
+        EXPECT_EQ(allocation.offset % alignment, 0) << "alignment = " << alignment;
+        EXPECT_EQ(allocation.size, 10);
+        for (const auto& other : allocations)
+            EXPECT(!overlaps(allocation, other));
+        allocations.push_back(allocation);
+        allocator.validate();
+    }
+
+    // Padding in front of aligned allocations is reused.
+    auto small = allocator.allocate(8);
+    ASSERT(small.isValid());
+    EXPECT_LT(small.offset, 4096);
+
+    for (const auto& allocation : allocations)
+        allocator.free(allocation);
+    allocator.free(small);
+    allocator.validate();
+    EXPECT_EQ(allocator.getStats().freeBlockCount, 1);
+}
+
+CPU_TEST(TLSFAllocator_Pages)
+{
+    TLSFAllocator allocator;
+    uint32_t page0 = allocator.addPage(256);
+    uint32_t page1 = allocator.addPage(4096);
+
+    // Allocations use the smallest size class that fits.
+    auto a = allocator.allocate(128);
+    EXPECT_EQ(a.page, page0);
+    auto b = allocator.allocate(1024);
+    EXPECT_EQ(b.page, page1);
+
+    // Only empty pages can be removed.
+    allocator.free(b);
+    EXPECT(allocator.isPageEmpty(page1));
+    allocator.removePage(page1);
+    EXPECT(!allocator.isPageValid(page1));
+    allocator.validate();
+    EXPECT(!allocator.allocate(1024).isValid());
+
+    // Page indices are reused.
+    uint32_t page2 = allocator.addPage(2048);
+    EXPECT_EQ(page2, page1);
+    EXPECT_EQ(allocator.getStats().pageCount, 2);
+    EXPECT_EQ(allocator.getStats().pageBytes, 256 + 2048);
+
+    allocator.free(a);
+    allocator.removePage(page0);
+    allocator.removePage(page2);
+    allocator.validate();
+    EXPECT_EQ(allocator.getStats().pageCount, 0);
+}
+
+CPU_TEST(TLSFAllocator_LargeRequests)
+{
+    // Requests larger than a page get a dedicated page (see GpuMemoryHeap). The page must cover the size class
+    // searched by the allocator, which is larger than the request above 32 pages.
+    const uint64_t pageSize = 2 * 1024 * 1024;
+    const uint64_t MB = 1024 * 1024;
+    for (uint64_t size : {3 * MB + 1, 64 * MB + 1, 68 * MB + 1, 80 * MB + 1, 200 * MB + 1, 5000 * MB + 1})
+    {
+        for (uint64_t alignment : {1, 256, 65536})
+        {
+            uint64_t requiredSize = TLSFAllocator::getRequiredPageSize(size, alignment);
+            EXPECT_GE(requiredSize, size + alignment - 1);
+
+            TLSFAllocator allocator;
+            allocator.addPage(pageSize);
+            uint32_t page = allocator.addPage(align_to(pageSize, requiredSize));
+            auto allocation = allocator.allocate(size, alignment);
+            ASSERT(allocation.isValid()) << "size = " << size << ", alignment = " << alignment;
+            EXPECT_EQ(allocation.page, page);
+            EXPECT_EQ(allocation.size, size);
+            EXPECT_EQ(allocation.offset % alignment, 0);
+            allocator.validate();
+        }
+    }
+
+    // Every request fits in an empty page of the required size.
+    std::mt19937 rng(1);
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        uint64_t size = 1 + (((uint64_t)rng() << 32) | rng()) % (1ull << (1 + rng() % 40));
+        uint64_t alignment = 1ull << (rng() % 17);
+        TLSFAllocator allocator;
+        allocator.addPage(TLSFAllocator::getRequiredPageSize(size, alignment));
+        ASSERT(allocator.allocate(size, alignment).isValid()) << "size = " << size << ", alignment = " << alignment;
+    }
+
+    EXPECT_THROW(TLSFAllocator::getRequiredPageSize(~0ull, 2));
+}
+
+CPU_TEST(TLSFAllocator_Random)
+{
+    TLSFAllocator allocator;
+    std::mt19937 rng(1234);
+    allocator.addPage(1 << 20);
+    allocator.addPage(1 << 18);
+
+    std::vector<TLSFAllocator::Allocation> allocations;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        if (allocations.empty() || rng() % 3 != 0)
+        {
+            // Mostly small allocations with occasional large ones.
+            uint64_t size = rng() % 8 == 0 ? 1 + rng() % 65536 : 1 + rng() % 1024;
+            uint64_t alignment = 1ull << (rng() % 9);
+            auto allocation = allocator.allocate(size, alignment);
+            if (!allocation.isValid())
+                continue;
+            ASSERT_EQ(allocation.offset % alignment, 0);
+            ASSERT_LE(allocation.offset + allocation.size, allocator.getPageSize(allocation.page));
+            allocations.push_back(allocation);
+        }
+        else
+        {
+            size_t index = rng() % allocations.size();
+            allocator.free(allocations[index]);
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        }
+        if (i % 1000 == 0)
+            allocator.validate();
+    }
+
+    // Live allocations never overlap.
+    std::sort(
+        allocations.begin(),
+        allocations.end(),
+        [](const auto& a, const auto& b) { return std::make_pair(a.page, a.offset) < std::make_pair(b.page, b.offset); }
+    );
+    for (size_t i = 1; i < allocations.size(); ++i)
+        ASSERT(!overlaps(allocations[i - 1], allocations[i]));
+
+    for (const auto& allocation : allocations)
+        allocator.free(allocation);
+    allocator.validate();
+    auto stats = allocator.getStats();
+    EXPECT_EQ(stats.allocationCount, 0);
+    EXPECT_EQ(stats.freeBlockCount, 2);
+}
+} // namespace Falcor
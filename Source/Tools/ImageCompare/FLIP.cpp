@@ -0,0 +1,655 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FLIP.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const float kPi = 3.14159265358979323846f;
+
+// FLIP constants (see FLIPPass.cs.slang).
+const float gqc = 0.7f;
+const float gpc = 0.4f;
+const float gpt = 0.95f;
+const float gw = 0.082f;
+const float gqf = 0.5f;
+
+struct Color
+{
+    float x, y, z;
+};
+
+// Color conversions (mirror Utils/Color/ColorHelpers.slang).
+
+Color linearRGBToXYZ(Color c)
+{
+    const float a11 = 10135552.0f / 24577794.0f;
+    const float a12 = 8788810.0f / 24577794.0f;
+    const float a13 = 4435075.0f / 24577794.0f;
+    const float a21 = 2613072.0f / 12288897.0f;
+    const float a22 = 8788810.0f / 12288897.0f;
+    const float a23 = 887015.0f / 12288897.0f;
+    const float a31 = 1425312.0f / 73733382.0f;
+    const float a32 = 8788810.0f / 73733382.0f;
+    const float a33 = 70074185.0f / 73733382.0f;
+    return {
+        a11 * c.x + a12 * c.y + a13 * c.z,
+        a21 * c.x + a22 * c.y + a23 * c.z,
+        a31 * c.x + a32 * c.y + a33 * c.z,
+    };
+}
+
+Color XYZToLinearRGB(Color c)
+{
+    return {
+        3.241003275f * c.x - 1.537398934f * c.y - 0.498615861f * c.z,
+        -0.969224334f * c.x + 1.875930071f * c.y + 0.041554224f * c.z,
+        0.055639423f * c.x - 0.204011202f * c.y + 1.057148933f * c.z,
+    };
+}
+
+const Color kD65ReferenceIlluminant = {0.950428545f, 1.000000000f, 1.088900371f};
+const Color kInvD65ReferenceIlluminant = {1.052156925f, 1.000000000f, 0.918357670f};
+
+Color XYZToCIELab(Color c)
+{
+    const float delta = 6.0f / 29.0f;
+    const float deltaCube = delta * delta * delta;
+    const float factor = 1.0f / (3.0f * delta * delta);
+    const float term = 4.0f / 29.0f;
+    auto f = [&](float t) { return t > deltaCube ? std::pow(t, 1.0f / 3.0f) : factor * t + term; };
+    float x = f(c.x * kInvD65ReferenceIlluminant.x);
+    float y = f(c.y * kInvD65ReferenceIlluminant.y);
+    float z = f(c.z * kInvD65ReferenceIlluminant.z);
+    return {116.0f * y - 16.0f, 500.0f * (x - y), 200.0f * (y - z)};
+}
+
+Color XYZToYCxCz(Color c)
+{
+    float x = c.x * kInvD65ReferenceIlluminant.x;
+    float y = c.y * kInvD65ReferenceIlluminant.y;
+    float z = c.z * kInvD65ReferenceIlluminant.z;
+    return {116.0f * y - 16.0f, 500.0f * (x - y), 200.0f * (y - z)};
+}
+
+Color YCxCzToXYZ(Color c)
+{
+    float y = (c.x + 16.0f) / 116.0f;
+    float x = c.y / 500.0f + y;
+    float z = y - c.z / 200.0f;
+    return {x * kD65ReferenceIlluminant.x, y * kD65ReferenceIlluminant.y, z * kD65ReferenceIlluminant.z};
+}
+
+Color Hunt(Color c)
+{
+    float huntValue = 0.01f * c.x;
+    return {c.x, huntValue * c.y, huntValue * c.z};
+}
+
+float HyAB(Color a, Color b)
+{
+    float dx = a.x - b.x;
+    float dy = a.y - b.y;
+    float dz = a.z - b.z;
+    return std::abs(dx) + std::sqrt(dy * dy + dz * dz);
+}
+
+float clamp01(float x)
+{
+    return std::min(std::max(x, 0.0f), 1.0f);
+}
+
+// Tone mappers (mirror ToneMappers.slang).
+
+Color toneMap(Color c, FLIPToneMapper toneMapper)
+{
+    float k0, k1, k2, k3, k4, k5;
+    switch (toneMapper)
+    {
+    case FLIPToneMapper::ACES:
+        // Include pre-exposure cancelation in constants.
+        k0 = 0.6f * 0.6f * 2.51f;
+        k1 = 0.6f * 0.03f;
+        k2 = 0.0f;
+        k3 = 0.6f * 0.6f * 2.43f;
+        k4 = 0.6f * 0.59f;
+        k5 = 0.14f;
+        break;
+    case FLIPToneMapper::Hable:
+    {
+        const float A = 0.15f;
+        const float B = 0.50f;
+        const float C = 0.10f;
+        const float D = 0.20f;
+        const float E = 0.02f;
+        const float F = 0.30f;
+        k0 = A * F - A * E;
+        k1 = C * B * F - B * E;
+        k2 = 0.0f;
+        k3 = A * F;
+        k4 = B * F;
+        k5 = D * F * F;
+
+        const float W = 11.2f;
+        const float nom = k0 * W * W + k1 * W + k2;
+        const float denom = k3 * W * W + k4 * W + k5;
+        const float whiteScale = denom / nom;
+
+        // Include white scale and exposure bias in rational polynomial coefficients.
+        k0 = 4.0f * k0 * whiteScale;
+        k1 = 2.0f * k1 * whiteScale;
+        k2 = k2 * whiteScale;
+        k3 = 4.0f * k3;
+        k4 = 2.0f * k4;
+        break;
+    }
+    case FLIPToneMapper::Reinhard:
+    {
+        float Y = 0.2126f * c.x + 0.7152f * c.y + 0.0722f * c.z;
+        return {clamp01(c.x / (Y + 1.0f)), clamp01(c.y / (Y + 1.0f)), clamp01(c.z / (Y + 1.0f))};
+    }
+    default:
+        throw std::runtime_error("Unknown tone mapper");
+    }
+
+    auto f = [&](float x)
+    {
+        float nom = k0 * x * x + k1 * x + k2;
+        float denom = k3 * x * x + k4 * x + k5;
+        if (std::isinf(denom))
+            denom = 1.0f; // Avoid inf / inf division.
+        return clamp01(nom / denom);
+    };
+    return {f(c.x), f(c.y), f(c.z)};
+}
+
+/// Compute start exposure, exposure delta and number of exposures for HDR-FLIP (mirrors FLIPPass::computeExposureParameters).
+void computeExposureParameters(FLIPToneMapper toneMapper, float Ymedian, float Ymax, float& startExposure, float& exposureDelta, uint32_t& numExposures)
+{
+    float tm[6];
+    switch (toneMapper)
+    {
+    case FLIPToneMapper::Reinhard:
+        tm[0] = 0.0f, tm[1] = 1.0f, tm[2] = 0.0f, tm[3] = 0.0f, tm[4] = 1.0f, tm[5] = 1.0f;
+        break;
+    case FLIPToneMapper::ACES:
+        // 0.6 is pre-exposure cancellation.
+        tm[0] = 0.6f * 0.6f * 2.51f, tm[1] = 0.6f * 0.03f, tm[2] = 0.0f, tm[3] = 0.6f * 0.6f * 2.43f, tm[4] = 0.6f * 0.59f, tm[5] = 0.14f;
+        break;
+    case FLIPToneMapper::Hable:
+        tm[0] = 0.231683f, tm[1] = 0.013791f, tm[2] = 0.0f, tm[3] = 0.18f, tm[4] = 0.3f, tm[5] = 0.018f;
+        break;
+    default:
+        throw std::runtime_error("Unknown tone mapper");
+    }
+
+    const float t = 0.85f;
+    const float a = tm[0] - t * tm[3];
+    const float b = tm[1] - t * tm[4];
+    const float c = tm[2] - t * tm[5];
+
+    // Solve a * x^2 + b * x + c = 0 for the largest root.
+    float xMax = 0.f;
+    if (a == 0.0f)
+    {
+        xMax = -c / b;
+    }
+    else
+    {
+        const float d1 = -0.5f * (b / a);
+        const float d2 = std::sqrt((d1 * d1) - (c / a));
+        xMax = d1 + d2;
+    }
+
+    startExposure = std::log2(xMax / Ymax);
+    float stopExposure = std::log2(xMax / Ymedian);
+
+    numExposures = uint32_t(std::max(2.0f, std::ceil(stopExposure - startExposure)));
+    exposureDelta = (stopExposure - startExposure) / (numExposures - 1.0f);
+}
+
+/// Run func(begin, end) on ranges of [0, count) using a number of threads.
+template<typename F>
+void parallelFor(uint32_t count, uint32_t threadCount, F func)
+{
+    const uint32_t kGrainSize = 8;
+    std::atomic<uint32_t> next{0};
+    auto worker = [&]()
+    {
+        for (uint32_t begin = next.fetch_add(kGrainSize); begin < count; begin = next.fetch_add(kGrainSize))
+            func(begin, std::min(begin + kGrainSize, count));
+    };
+
+    threadCount = std::max(1u, std::min(threadCount, (count + kGrainSize - 1) / kGrainSize));
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+/// Single channel image.
+struct Plane
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> data;
+
+    Plane(uint32_t width, uint32_t height) : width(width), height(height), data(size_t(width) * height) {}
+    float* row(uint32_t y) { return data.data() + size_t(y) * width; }
+    const float* row(uint32_t y) const { return data.data() + size_t(y) * width; }
+};
+
+/// 1D filter kernel with taps at offsets [-radius, radius].
+using Kernel = std::vector<float>;
+
+/**
+ * Filter rows of a plane with one or more kernels (correlation with clamp-to-edge addressing).
+ * The inner loops run over contiguous pixels so that the compiler can vectorize them.
+ */
+void filterRows(const Plane& src, const std::vector<std::pair<const Kernel*, Plane*>>& passes, int radius, uint32_t threadCount)
+{
+    const uint32_t width = src.width;
+    parallelFor(
+        src.height,
+        threadCount,
+        [&](uint32_t begin, uint32_t end)
+        {
+            std::vector<float> padded(width + 2 * radius);
+            for (uint32_t y = begin; y < end; ++y)
+            {
+                const float* in = src.row(y);
+                for (int i = 0; i < (int)padded.size(); ++i)
+                    padded[i] = in[std::min(std::max(i - radius, 0), (int)width - 1)];
+
+                for (const auto& [pKernel, pDst] : passes)
+                {
+                    float* out = pDst->row(y);
+                    std::fill(out, out + width, 0.f);
+                    for (int k = 0; k <= 2 * radius; ++k)
+                    {
+                        const float w = (*pKernel)[k];
+                        const float* p = padded.data() + k;
+                        for (uint32_t x = 0; x < width; ++x)
+                            out[x] += w * p[x];
+                    }
+                }
+            }
+        }
+    );
+}
+
+/**
+ * Filter columns of a plane with a kernel (correlation with clamp-to-edge addressing).
+ * If accumulate is true, the result is added to dst.
+ */
+void filterColumns(const Plane& src, const Kernel& kernel, Plane& dst, int radius, bool accumulate, uint32_t threadCount)
+{
+    const uint32_t width = src.width;
+    const int height = (int)src.height;
+    parallelFor(
+        src.height,
+        threadCount,
+        [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t y = begin; y < end; ++y)
+            {
+                float* out = dst.row(y);
+                if (!accumulate)
+                    std::fill(out, out + width, 0.f);
+                for (int k = -radius; k <= radius; ++k)
+                {
+                    const float w = kernel[k + radius];
+                    const float* in = src.row(std::min(std::max((int)y + k, 0), height - 1));
+                    for (uint32_t x = 0; x < width; ++x)
+                        out[x] += w * in[x];
+                }
+            }
+        }
+    );
+}
+
+/// Kernels used by the color and feature pipelines.
+struct FLIPKernels
+{
+    int radius = 0;
+
+    // Color pipeline. The CSF filter of each channel is a sum of separable Gaussians (a2 == 0 for A and RG).
+    // The horizontal kernel of each term is unnormalized, the vertical one includes the term weight and normalization.
+    struct Term
+    {
+        Kernel h;
+        Kernel v;
+    };
+    std::vector<Term> csf[3];
+
+    // Feature pipeline (normalized Gaussian, point and edge detectors).
+    Kernel g;
+    Kernel point;
+    Kernel edge;
+
+    explicit FLIPKernels(float pixelsPerDegree)
+    {
+        // Use radius of the spatial filter kernel, as it is always greater than or equal to the radius of the feature detection kernel.
+        // See FLIP paper for explanation of the 0.04 and 3.0 factors.
+        radius = int(std::ceil(3.0f * std::sqrt(0.04f / (2.0f * kPi * kPi)) * pixelsPerDegree));
+        const int size = 2 * radius + 1;
+        const float dx = 1.0f / pixelsPerDegree;
+
+        // Color pipeline. a1, a2, b1, b2 for A, RG and BY.
+        const float abValues[3][4] = {
+            {1.0f, 0.0f, 0.0047f, 1.0e-5f},
+            {1.0f, 0.0f, 0.0053f, 1.0e-5f},
+            {34.1f, 13.5f, 0.04f, 0.025f},
+        };
+        for (int c = 0; c < 3; ++c)
+        {
+            float kernelSum2D = 0.f;
+            for (int i = 0; i < 2; ++i)
+            {
+                const float a = abValues[c][i];
+                const float b = abValues[c][2 + i];
+                if (a == 0.f)
+                    continue;
+
+                Term term;
+                term.h.resize(size);
+                float sum = 0.f;
+                for (int x = -radius; x <= radius; ++x)
+                {
+                    const float p = x * dx;
+                    term.h[x + radius] = std::exp(-(p * p) * kPi * kPi / b);
+                    sum += term.h[x + radius];
+                }
+                const float scale = a * std::sqrt(kPi / b);
+                term.v = term.h;
+                for (float& w : term.v)
+                    w *= scale;
+                kernelSum2D += scale * sum * sum;
+                csf[c].push_back(std::move(term));
+            }
+            for (auto& term : csf[c])
+                for (float& w : term.v)
+                    w /= kernelSum2D;
+        }
+
+        // Feature pipeline.
+        const float sigmaFeatures = 0.5f * gw * pixelsPerDegree;
+        const float sigmaFeaturesSquared = sigmaFeatures * sigmaFeatures;
+        g.resize(size);
+        point.resize(size);
+        edge.resize(size);
+        float gSum = 0.f;
+        float positiveKernelSum = 0.f;
+        float negativeKernelSum = 0.f;
+        float edgeKernelSum = 0.f;
+        for (int x = -radius; x <= radius; ++x)
+        {
+            const float gx = std::exp(-(x * x) / (2.0f * sigmaFeaturesSquared));
+            g[x + radius] = gx;
+            point[x + radius] = (x * x / sigmaFeaturesSquared - 1.0f) * gx;
+            edge[x + radius] = -x * gx;
+            gSum += gx;
+            positiveKernelSum += std::max(point[x + radius], 0.f);
+            negativeKernelSum += std::max(-point[x + radius], 0.f);
+            edgeKernelSum += std::max(edge[x + radius], 0.f);
+        }
+        // The 2D kernel sums are products of the 1D sums, so normalization can be split between the two passes.
+        for (int i = 0; i < size; ++i)
+        {
+            g[i] /= gSum;
+            point[i] /= point[i] >= 0.f ? positiveKernelSum : negativeKernelSum;
+            edge[i] /= edgeKernelSum;
+        }
+    }
+};
+
+/// Filtered image data needed to evaluate FLIP.
+struct FilteredImage
+{
+    Plane color[3];       ///< Spatially filtered YCxCz.
+    Plane pointGradient;  ///< Magnitude of the point detector response.
+    Plane edgeGradient;   ///< Magnitude of the edge detector response.
+
+    FilteredImage(uint32_t width, uint32_t height)
+        : color{{width, height}, {width, height}, {width, height}}, pointGradient(width, height), edgeGradient(width, height)
+    {}
+};
+
+/// Scratch planes reused between images and exposures.
+struct Scratch
+{
+    Plane ycxcz[3];
+    Plane h[3];
+    Plane v[4];
+
+    Scratch(uint32_t width, uint32_t height)
+        : ycxcz{{width, height}, {width, height}, {width, height}}
+        , h{{width, height}, {width, height}, {width, height}}
+        , v{{width, height}, {width, height}, {width, height}, {width, height}}
+    {}
+};
+
+void filterImage(
+    const float* rgba,
+    const FLIPOptions& options,
+    float exposure,
+    const FLIPKernels& kernels,
+    Scratch& scratch,
+    FilteredImage& result,
+    uint32_t threadCount
+)
+{
+    const uint32_t width = result.pointGradient.width;
+    const uint32_t height = result.pointGradient.height;
+    const int radius = kernels.radius;
+    const float exposureScale = std::pow(2.0f, exposure);
+
+    // Convert to YCxCz (mirrors getPixel() in FLIPPass.cs.slang).
+    parallelFor(
+        height,
+        threadCount,
+        [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t y = begin; y < end; ++y)
+            {
+                const float* src = rgba + size_t(y) * width * 4;
+                float* dst[3] = {scratch.ycxcz[0].row(y), scratch.ycxcz[1].row(y), scratch.ycxcz[2].row(y)};
+                for (uint32_t x = 0; x < width; ++x, src += 4)
+                {
+                    Color c = {src[0], src[1], src[2]};
+                    if (options.hdr)
+                    {
+                        if (options.clampInput)
+                            c = {std::max(c.x, 0.f), std::max(c.y, 0.f), std::max(c.z, 0.f)};
+                        c = toneMap({exposureScale * c.x, exposureScale * c.y, exposureScale * c.z}, options.toneMapper);
+                    }
+                    else if (options.clampInput)
+                    {
+                        c = {clamp01(c.x), clamp01(c.y), clamp01(c.z)};
+                    }
+                    c = XYZToYCxCz(linearRGBToXYZ(c));
+                    dst[0][x] = c.x;
+                    dst[1][x] = c.y;
+                    dst[2][x] = c.z;
+                }
+            }
+        }
+    );
+
+    // Color pipeline: CSF filtering of each channel.
+    for (int c = 0; c < 3; ++c)
+    {
+        bool accumulate = false;
+        for (const auto& term : kernels.csf[c])
+        {
+            filterRows(scratch.ycxcz[c], {{&term.h, &scratch.h[0]}}, radius, threadCount);
+            filterColumns(scratch.h[0], term.v, result.color[c], radius, accumulate, threadCount);
+            accumulate = true;
+        }
+    }
+
+    // Feature pipeline: point and edge detection on normalized luminance.
+    Plane& luminance = scratch.ycxcz[1]; // Reuse Cx plane, which is no longer needed.
+    for (size_t i = 0; i < luminance.data.size(); ++i)
+        luminance.data[i] = (scratch.ycxcz[0].data[i] + 16.0f) / 116.0f;
+
+    Plane& hg = scratch.h[0];
+    Plane& hp = scratch.h[1];
+    Plane& he = scratch.h[2];
+    filterRows(luminance, {{&kernels.g, &hg}, {&kernels.point, &hp}, {&kernels.edge, &he}}, radius, threadCount);
+    filterColumns(hp, kernels.g, scratch.v[0], radius, false, threadCount);     // Point x.
+    filterColumns(hg, kernels.point, scratch.v[1], radius, false, threadCount); // Point y.
+    filterColumns(he, kernels.g, scratch.v[2], radius, false, threadCount);     // Edge x.
+    filterColumns(hg, kernels.edge, scratch.v[3], radius, false, threadCount);  // Edge y.
+
+    for (size_t i = 0; i < luminance.data.size(); ++i)
+    {
+        result.pointGradient.data[i] = std::sqrt(scratch.v[0].data[i] * scratch.v[0].data[i] + scratch.v[1].data[i] * scratch.v[1].data[i]);
+        result.edgeGradient.data[i] = std::sqrt(scratch.v[2].data[i] * scratch.v[2].data[i] + scratch.v[3].data[i] * scratch.v[3].data[i]);
+    }
+}
+
+Color filteredToHuntLab(const FilteredImage& image, size_t i)
+{
+    Color c = XYZToLinearRGB(YCxCzToXYZ({image.color[0].data[i], image.color[1].data[i], image.color[2].data[i]}));
+    c = {clamp01(c.x), clamp01(c.y), clamp01(c.z)};
+    return Hunt(XYZToCIELab(linearRGBToXYZ(c)));
+}
+
+float redistributeErrors(float colorDifference, float featureDifference, float maxDistance)
+{
+    float error = std::pow(colorDifference, gqc);
+
+    // Normalization.
+    const float perceptualCutoff = gpc * maxDistance;
+    if (error < perceptualCutoff)
+        error *= (gpt / perceptualCutoff);
+    else
+        error = gpt + ((error - perceptualCutoff) / (maxDistance - perceptualCutoff)) * (1.0f - gpt);
+
+    return std::pow(error, (1.0f - featureDifference));
+}
+
+/// Evaluate LDR-FLIP for one exposure and update the per-pixel maximum.
+void evalLDRFLIP(const FilteredImage& reference, const FilteredImage& test, std::vector<float>& flip, uint32_t threadCount)
+{
+    const float maxDistance =
+        std::pow(HyAB(Hunt(XYZToCIELab(linearRGBToXYZ({0.f, 1.f, 0.f}))), Hunt(XYZToCIELab(linearRGBToXYZ({0.f, 0.f, 1.f})))), gqc);
+    const uint32_t width = reference.pointGradient.width;
+    const uint32_t height = reference.pointGradient.height;
+
+    parallelFor(
+        height,
+        threadCount,
+        [&](uint32_t begin, uint32_t end)
+        {
+            for (size_t i = size_t(begin) * width; i < size_t(end) * width; ++i)
+            {
+                const float colorDiff = HyAB(filteredToHuntLab(reference, i), filteredToHuntLab(test, i));
+                const float edgeDifference = std::abs(reference.edgeGradient.data[i] - test.edgeGradient.data[i]);
+                const float pointDifference = std::abs(reference.pointGradient.data[i] - test.pointGradient.data[i]);
+                const float featureDiff = std::pow(std::max(pointDifference, edgeDifference) * std::sqrt(0.5f), gqf);
+                flip[i] = std::max(flip[i], redistributeErrors(colorDiff, featureDiff, maxDistance));
+            }
+        }
+    );
+}
+} // namespace
+
+double computeFLIP(const float* reference, const float* test, uint32_t width, uint32_t height, const FLIPOptions& options, float* errorMap)
+{
+    const size_t pixelCount = size_t(width) * height;
+    if (pixelCount == 0)
+        return 0.0;
+
+    const uint32_t threadCount = options.threadCount > 0 ? options.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    const float pixelsPerDegree = options.monitorDistanceMeters * (options.monitorWidthPixels / options.monitorWidthMeters) * (kPi / 180.0f);
+    const FLIPKernels kernels(pixelsPerDegree);
+
+    // Determine exposures. HDR-FLIP is the maximum LDR-FLIP over a range of exposures.
+    float startExposure = 0.f;
+    float exposureDelta = 0.f;
+    uint32_t numExposures = 1;
+    if (options.hdr)
+    {
+        if (options.useCustomExposure)
+        {
+            startExposure = options.startExposure;
+            numExposures = std::max(2u, options.numExposures);
+            exposureDelta = (options.stopExposure - options.startExposure) / (numExposures - 1.0f);
+        }
+        else
+        {
+            // Compute median and max luminance of the reference image.
+            std::vector<float> luminance(pixelCount);
+            for (size_t i = 0; i < pixelCount; ++i)
+                luminance[i] = 0.2126f * reference[i * 4] + 0.7152f * reference[i * 4 + 1] + 0.0722f * reference[i * 4 + 2];
+            const size_t mid = pixelCount / 2;
+            std::nth_element(luminance.begin(), luminance.begin() + mid, luminance.end());
+            float Ymedian = luminance[mid];
+            if ((pixelCount & 1) == 0)
+                Ymedian = (Ymedian + *std::max_element(luminance.begin(), luminance.begin() + mid)) * 0.5f;
+            const float Ymax = *std::max_element(luminance.begin(), luminance.end());
+            computeExposureParameters(options.toneMapper, Ymedian, Ymax, startExposure, exposureDelta, numExposures);
+        }
+    }
+
+    Scratch scratch(width, height);
+    FilteredImage filteredReference(width, height);
+    FilteredImage filteredTest(width, height);
+    std::vector<float> flip(pixelCount, 0.f);
+
+    for (uint32_t i = 0; i < numExposures; ++i)
+    {
+        const float exposure = startExposure + i * exposureDelta;
+        filterImage(reference, options, exposure, kernels, scratch, filteredReference, threadCount);
+        filterImage(test, options, exposure, kernels, scratch, filteredTest, threadCount);
+        evalLDRFLIP(filteredReference, filteredTest, flip, threadCount);
+    }
+
+    // Invalid values are reported as maximum error, like in FLIPPass.
+    double sum = 0.0;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        float value = flip[i];
+        if (std::isnan(value) || std::isinf(value) || value < 0.0f || value > 1.0f)
+            value = 1.0f;
+        if (errorMap)
+            errorMap[i] = value;
+        sum += value;
+    }
+    return sum / pixelCount;
+}
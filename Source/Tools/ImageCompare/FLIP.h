@@ -0,0 +1,77 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include <cstdint>
+
+/**
+ * CPU implementation of the FLIP image difference evaluator.
+ *
+ * This mirrors the FLIPPass render pass (LDR-FLIP and HDR-FLIP) so that perceptual image comparisons
+ * can run without a GPU. The spatial filters of the color and feature pipelines are evaluated as
+ * separable row/column passes on planar images, which is equivalent to the dense kernels used on the GPU.
+ *
+ * See FLIPPass.cs.slang for references to the papers.
+ */
+
+enum class FLIPToneMapper
+{
+    ACES,
+    Hable,
+    Reinhard,
+};
+
+struct FLIPOptions
+{
+    bool hdr = false;                                 ///< Compute HDR-FLIP instead of LDR-FLIP.
+    FLIPToneMapper toneMapper = FLIPToneMapper::ACES; ///< Tone mapper assumed by HDR-FLIP.
+    bool clampInput = false;                          ///< Clamp input to the expected range ([0,1] for LDR-FLIP and [0, inf) for HDR-FLIP).
+
+    bool useCustomExposure = false; ///< Use the exposure parameters below instead of computing them from the reference image.
+    float startExposure = 0.f;      ///< Start exposure for HDR-FLIP.
+    float stopExposure = 0.f;       ///< Stop exposure for HDR-FLIP.
+    uint32_t numExposures = 2;      ///< Number of exposures for HDR-FLIP.
+
+    // Viewing conditions used to compute the number of pixels per degree.
+    uint32_t monitorWidthPixels = 3840;
+    float monitorWidthMeters = 0.7f;
+    float monitorDistanceMeters = 0.7f;
+
+    uint32_t threadCount = 0; ///< Number of worker threads (0 = number of hardware threads).
+};
+
+/**
+ * Compute FLIP between a reference and a test image.
+ * @param[in] reference Reference image in RGBA32F format.
+ * @param[in] test Test image in RGBA32F format.
+ * @param[in] width Image width.
+ * @param[in] height Image height.
+ * @param[in] options Options.
+ * @param[out] errorMap (Optional) Per-pixel FLIP values (width * height floats).
+ * @return Mean FLIP value.
+ */
+double computeFLIP(const float* reference, const float* test, uint32_t width, uint32_t height, const FLIPOptions& options, float* errorMap);
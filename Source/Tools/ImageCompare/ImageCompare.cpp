@@ -25,6 +25,8 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include "FLIP.h"
+
 #include <FreeImage.h>
 #include <args.hxx>
 
@@ -276,6 +278,18 @@ double compare(const Image& imageA, const Image& imageB, bool alpha, float* erro
     return sum / count;
 }
 
+/// Options for the FLIP metrics (set from the command line).
+static FLIPOptions sFLIPOptions;
+
+template<bool HDR>
+double compareFLIP(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+{
+    // FLIP is asymmetric, the first image is the reference.
+    FLIPOptions options = sFLIPOptions;
+    options.hdr = HDR;
+    return computeFLIP(imageA.getData(), imageB.getData(), imageA.getWidth(), imageA.getHeight(), options, errorMap);
+}
+
 struct ErrorMetric
 {
     std::string name;
@@ -289,6 +303,8 @@ static const std::vector<ErrorMetric> errorMetrics = {
     {"mae", "Mean Absolute Error", compare<MAE>},
     {"mape", "Mean Absolute Percentage Error", compare<MAPE>},
     {"rmae", "Relative Mean Absolute Error", compare<RMAE>},
+    {"flip", "LDR-FLIP perceptual error (first image is the reference)", compareFLIP<false>},
+    {"hdrflip", "HDR-FLIP perceptual error (first image is the reference)", compareFLIP<true>},
 };
 
 static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
@@ -329,7 +345,8 @@ static bool compareImages(
     ErrorMetric metric,
     float threshold,
     bool alpha,
-    const std::filesystem::path& heatMapPath
+    const std::filesystem::path& heatMapPath,
+    const std::filesystem::path& errorMapPath
 )
 {
     auto loadImage = [](const std::filesystem::path& path)
@@ -377,16 +394,30 @@ static bool compareImages(
 
 
     // Compare images.
-    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(width * height);
+    bool needErrorMap = !heatMapPath.empty() || !errorMapPath.empty();
+    std::unique_ptr<float[]> errorMap = needErrorMap ? std::make_unique<float[]>(width * height) : nullptr;
     double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
 
     // Generate heat map.
-    if (errorMap)
+    if (!heatMapPath.empty())
     {
         auto heatMap = generateHeatMap(width, height, errorMap.get());
         saveImage(*heatMap, heatMapPath);
     }
 
+    // Write raw error map (error replicated to all channels).
+    if (!errorMapPath.empty())
+    {
+        auto image = Image::create(width, height);
+        float* dst = image->getData();
+        for (size_t i = 0; i < width * height; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+                *dst++ = errorMap[i];
+        }
+        saveImage(*image, errorMapPath);
+    }
+
     std::cout << error << std::endl;
 
     // Treat nans and infs as errors.
@@ -415,6 +446,16 @@ int main(int argc, char** argv)
     args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
     args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
+    args::ValueFlag<std::string> errorMapFlag(parser, "filename", "Write raw per-pixel error map.", {'f'});
+    args::Group flipGroup(parser, "FLIP options:");
+    args::ValueFlag<std::string> toneMapperFlag(flipGroup, "name", "HDR-FLIP tone mapper (aces, hable, reinhard).", {"tone-mapper"});
+    args::ValueFlag<float> startExposureFlag(flipGroup, "value", "HDR-FLIP start exposure.", {"start-exposure"});
+    args::ValueFlag<float> stopExposureFlag(flipGroup, "value", "HDR-FLIP stop exposure.", {"stop-exposure"});
+    args::ValueFlag<uint32_t> numExposuresFlag(flipGroup, "count", "HDR-FLIP number of exposures.", {"num-exposures"});
+    args::ValueFlag<uint32_t> monitorWidthPixelsFlag(flipGroup, "pixels", "Monitor width in pixels.", {"monitor-width-pixels"});
+    args::ValueFlag<float> monitorWidthMetersFlag(flipGroup, "meters", "Monitor width in meters.", {"monitor-width-meters"});
+    args::ValueFlag<float> monitorDistanceFlag(flipGroup, "meters", "Distance to monitor in meters.", {"monitor-distance"});
+    args::Flag clampInputFlag(flipGroup, "", "Clamp input to the expected range.", {"clamp-input"});
     args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
     args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
     args::CompletionFlag completionFlag(parser, {"complete"});
@@ -467,13 +508,49 @@ int main(int argc, char** argv)
         metric = *it;
     }
 
+    if (toneMapperFlag)
+    {
+        static const std::map<std::string, FLIPToneMapper> toneMappers = {
+            {"aces", FLIPToneMapper::ACES},
+            {"hable", FLIPToneMapper::Hable},
+            {"reinhard", FLIPToneMapper::Reinhard},
+        };
+        auto it = toneMappers.find(args::get(toneMapperFlag));
+        if (it == toneMappers.end())
+        {
+            std::cerr << "Unknown tone mapper '" << args::get(toneMapperFlag) << "'." << std::endl;
+            return 1;
+        }
+        sFLIPOptions.toneMapper = it->second;
+    }
+    if (startExposureFlag || stopExposureFlag || numExposuresFlag)
+    {
+        if (!(startExposureFlag && stopExposureFlag && numExposuresFlag))
+        {
+            std::cerr << "Custom exposure requires --start-exposure, --stop-exposure and --num-exposures." << std::endl;
+            return 1;
+        }
+        sFLIPOptions.useCustomExposure = true;
+        sFLIPOptions.startExposure = args::get(startExposureFlag);
+        sFLIPOptions.stopExposure = args::get(stopExposureFlag);
+        sFLIPOptions.numExposures = args::get(numExposuresFlag);
+    }
+    if (monitorWidthPixelsFlag)
+        sFLIPOptions.monitorWidthPixels = args::get(monitorWidthPixelsFlag);
+    if (monitorWidthMetersFlag)
+        sFLIPOptions.monitorWidthMeters = args::get(monitorWidthMetersFlag);
+    if (monitorDistanceFlag)
+        sFLIPOptions.monitorDistanceMeters = args::get(monitorDistanceFlag);
+    sFLIPOptions.clampInput = clampInputFlag;
+
     bool success = compareImages(
         args::get(image1),
         args::get(image2),
         metric,
         thresholdFlag ? args::get(thresholdFlag) : 0.f,
         alphaFlag ? args::get(alphaFlag) : false,
-        heatMapFlag ? args::get(heatMapFlag) : ""
+        heatMapFlag ? args::get(heatMapFlag) : "",
+        errorMapFlag ? args::get(errorMapFlag) : ""
     );
     return success ? 0 : 1;
 }
@@ -1125,6 +1125,7 @@ void importInternal(const void* buffer, size_t byteSize, const std::filesystem::
     Assimp::Importer importer;
     importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, removeFlags);
 
+    builder.reportProgress("Reading asset file");
     const aiScene* pScene = nullptr;
     if (!path.empty())
     {
@@ -1160,16 +1161,19 @@ void importInternal(const void* buffer, size_t byteSize, const std::filesystem::
 
     // dumpAssimpData(data);
 
+    builder.reportProgress("Creating materials");
     createAllMaterials(data, searchPath, importMode);
     timeReport.measure("Creating materials");
 
     createSceneGraph(data);
     timeReport.measure("Creating scene graph");
 
+    builder.reportProgress("Creating meshes");
     createMeshes(data);
     addMeshInstances(data, data.pScene->mRootNode);
     timeReport.measure("Creating meshes");
 
+    builder.reportProgress("Creating animations");
     createAnimations(data, importMode);
     timeReport.measure("Creating animations");
 
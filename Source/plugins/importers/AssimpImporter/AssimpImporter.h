@@ -44,7 +44,8 @@ public:
              {
                  "fbx", "gltf", "obj", "dae",  "x",   "md5mesh", "ply", "3ds", "blend", "ase", "ifc", "xgl", "zgl", "dxf", "lwo", "lws",
                  "lxo", "stl",  "ac",  "ms3d", "cob", "scn",     "3d",  "mdl", "mdl2",  "pk3", "smd", "vta", "raw", "ter", "glb",
-             }}
+             },
+             true}
         )
     );
 
@@ -33,11 +33,14 @@
 
 #include "LoopSubdivide.h"
 #include "Core/Error.h"
+#include "Utils/NumericRange.h"
 
 #include <algorithm>
+#include <execution>
 #include <map>
 #include <memory>
 #include <memory_resource>
+#include <numeric>
 #include <set>
 
 #include <cmath>
@@ -171,7 +174,7 @@ inline float loopGamma(uint32_t valence)
     return 1.f / (valence + 3.f / (8.f * beta(valence)));
 }
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+LoopSubdivideResult loopSubdivideReference(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
 {
     std::vector<SDVertex*> vertices;
     std::vector<SDFace*> faces;
@@ -539,4 +542,515 @@ static float3 weightBoundary(SDVertex* vert, float beta)
     return p;
 }
 
+
+// Flat-array implementation.
+// Faces and vertices are stored in arrays and referenced by index. The vertex and face order, as well as the
+// order of all floating-point operations, match the pointer-based implementation above so that the results are
+// identical: even vertices keep their index, odd vertices are appended in the order their edge is first visited
+// when iterating faces, and face i is replaced by its four children at indices 4i..4i+3.
+
+namespace
+{
+constexpr uint32_t kInvalidIndex = uint32_t(-1);
+constexpr size_t kParallelBlockSize = 4096;
+
+/// Call fn(begin, end) for blocks of the range [0, count) in parallel.
+template<typename F>
+void parallelForBlocks(size_t count, F&& fn)
+{
+    const size_t blockCount = (count + kParallelBlockSize - 1) / kParallelBlockSize;
+    auto range = NumericRange<size_t>(0, blockCount);
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](size_t block) { fn(block * kParallelBlockSize, std::min(count, (block + 1) * kParallelBlockSize)); }
+    );
+}
+
+struct SubdivMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> startFaces; ///< Per vertex: index of a face containing the vertex.
+    std::vector<uint8_t> boundary;    ///< Per vertex: 1 if the vertex is on a boundary.
+    std::vector<uint8_t> regular;     ///< Per vertex: 1 if the vertex is regular.
+    std::vector<uint32_t> indices;    ///< Per face: three vertex indices.
+    std::vector<uint32_t> neighbors;  ///< Per face: three neighbor faces, neighbor k is across edge (v[k], v[NEXT(k)]).
+
+    uint32_t getVertexCount() const { return (uint32_t)positions.size(); }
+    uint32_t getFaceCount() const { return (uint32_t)(indices.size() / 3); }
+
+    uint32_t vnum(uint32_t face, uint32_t vert) const
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            if (indices[3 * face + i] == vert)
+                return i;
+        }
+        FALCOR_THROW("Basic logic error in SubdivMesh::vnum().");
+    }
+
+    uint32_t nextFace(uint32_t face, uint32_t vert) const { return neighbors[3 * face + vnum(face, vert)]; }
+    uint32_t prevFace(uint32_t face, uint32_t vert) const { return neighbors[3 * face + PREV(vnum(face, vert))]; }
+    uint32_t nextVert(uint32_t face, uint32_t vert) const { return indices[3 * face + NEXT(vnum(face, vert))]; }
+    uint32_t prevVert(uint32_t face, uint32_t vert) const { return indices[3 * face + PREV(vnum(face, vert))]; }
+
+    uint32_t otherVert(uint32_t face, uint32_t v0, uint32_t v1) const
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            uint32_t v = indices[3 * face + i];
+            if (v != v0 && v != v1)
+                return v;
+        }
+        FALCOR_THROW("Basic logic error in SubdivMesh::otherVert()");
+    }
+
+    uint32_t valence(uint32_t vert) const
+    {
+        uint32_t f = startFaces[vert];
+        if (!boundary[vert])
+        {
+            // Compute valence of interior vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vert)) != startFaces[vert])
+                ++nf;
+            return nf;
+        }
+        else
+        {
+            // Compute valence of boundary vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vert)) != kInvalidIndex)
+                ++nf;
+            f = startFaces[vert];
+            while ((f = prevFace(f, vert)) != kInvalidIndex)
+                ++nf;
+            return nf + 1;
+        }
+    }
+
+    /// Call fn(vertex) for all vertices in the one-ring of a vertex, in the same order as SDVertex::oneRing().
+    template<typename F>
+    void forEachOneRing(uint32_t vert, F&& fn) const
+    {
+        uint32_t face = startFaces[vert];
+        if (!boundary[vert])
+        {
+            do
+            {
+                fn(nextVert(face, vert));
+                face = nextFace(face, vert);
+            } while (face != startFaces[vert]);
+        }
+        else
+        {
+            uint32_t f2;
+            while ((f2 = nextFace(face, vert)) != kInvalidIndex)
+                face = f2;
+            fn(nextVert(face, vert));
+            do
+            {
+                fn(prevVert(face, vert));
+                face = prevFace(face, vert);
+            } while (face != kInvalidIndex);
+        }
+    }
+
+    float3 weightOneRing(uint32_t vert, float beta) const
+    {
+        uint32_t valence = this->valence(vert);
+        float3 p = (1 - valence * beta) * positions[vert];
+        forEachOneRing(vert, [&](uint32_t v) { p += beta * positions[v]; });
+        return p;
+    }
+
+    float3 weightBoundary(uint32_t vert, float beta) const
+    {
+        uint32_t first = kInvalidIndex;
+        uint32_t last = kInvalidIndex;
+        forEachOneRing(
+            vert,
+            [&](uint32_t v)
+            {
+                if (first == kInvalidIndex)
+                    first = v;
+                last = v;
+            }
+        );
+        float3 p = (1 - 2 * beta) * positions[vert];
+        p += beta * positions[first];
+        p += beta * positions[last];
+        return p;
+    }
+};
+
+/// Edges of all faces, sorted by vertex pair and then by face edge index (3 * face + k).
+struct SortedEdges
+{
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> faceEdges;
+    std::vector<uint32_t> groupStarts; ///< Index of the first entry with the same key.
+};
+
+SortedEdges sortEdges(const SubdivMesh& mesh)
+{
+    const size_t edgeCount = mesh.indices.size();
+
+    std::vector<std::pair<uint64_t, uint32_t>> entries(edgeCount);
+    parallelForBlocks(
+        edgeCount,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t fe = begin; fe < end; ++fe)
+            {
+                uint32_t face = (uint32_t)(fe / 3);
+                uint32_t k = (uint32_t)(fe % 3);
+                uint64_t v0 = mesh.indices[3 * face + k];
+                uint64_t v1 = mesh.indices[3 * face + NEXT(k)];
+                entries[fe] = {(std::min(v0, v1) << 32) | std::max(v0, v1), (uint32_t)fe};
+            }
+        }
+    );
+    std::sort(std::execution::par, entries.begin(), entries.end());
+
+    SortedEdges edges;
+    edges.keys.resize(edgeCount);
+    edges.faceEdges.resize(edgeCount);
+    edges.groupStarts.resize(edgeCount);
+    parallelForBlocks(
+        edgeCount,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                edges.keys[i] = entries[i].first;
+                edges.faceEdges[i] = entries[i].second;
+                edges.groupStarts[i] = (i == 0 || entries[i].first != entries[i - 1].first) ? (uint32_t)i : 0;
+            }
+        }
+    );
+    std::inclusive_scan(
+        std::execution::par,
+        edges.groupStarts.begin(),
+        edges.groupStarts.end(),
+        edges.groupStarts.begin(),
+        [](uint32_t a, uint32_t b) { return std::max(a, b); }
+    );
+
+    return edges;
+}
+
+SubdivMesh createBaseMesh(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    SubdivMesh mesh;
+    const uint32_t vertexCount = (uint32_t)positions.size();
+    mesh.positions.assign(positions.begin(), positions.end());
+    mesh.indices.assign(indices.begin(), indices.end());
+    const uint32_t faceCount = mesh.getFaceCount();
+
+    // Set vertex to face indices. The last face referencing a vertex is used.
+    mesh.startFaces.resize(vertexCount, kInvalidIndex);
+    for (uint32_t face = 0; face < faceCount; ++face)
+    {
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            uint32_t v = mesh.indices[3 * face + j];
+            FALCOR_CHECK(v < vertexCount, "Vertex index {} is out of range.", v);
+            mesh.startFaces[v] = face;
+        }
+    }
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        FALCOR_CHECK(mesh.startFaces[v] != kInvalidIndex, "Vertex {} is not referenced by any face.", v);
+
+    // Set neighbor indices in faces. Faces sharing an edge are paired in the order they are visited,
+    // which matches the pairing in the reference implementation for non-manifold edges.
+    mesh.neighbors.resize(mesh.indices.size(), kInvalidIndex);
+    auto edges = sortEdges(mesh);
+    parallelForBlocks(
+        edges.keys.size(),
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if ((i - edges.groupStarts[i]) % 2 != 0 || i + 1 >= edges.keys.size() || edges.keys[i + 1] != edges.keys[i])
+                    continue;
+                uint32_t fe0 = edges.faceEdges[i];
+                uint32_t fe1 = edges.faceEdges[i + 1];
+                mesh.neighbors[fe0] = fe1 / 3;
+                mesh.neighbors[fe1] = fe0 / 3;
+            }
+        }
+    );
+
+    // Finish vertex initialization.
+    mesh.boundary.resize(vertexCount);
+    mesh.regular.resize(vertexCount);
+    parallelForBlocks(
+        vertexCount,
+        [&](size_t begin, size_t end)
+        {
+            for (uint32_t v = (uint32_t)begin; v < (uint32_t)end; ++v)
+            {
+                uint32_t f = mesh.startFaces[v];
+                do
+                {
+                    f = mesh.nextFace(f, v);
+                } while (f != kInvalidIndex && f != mesh.startFaces[v]);
+                mesh.boundary[v] = f == kInvalidIndex;
+                uint32_t valence = mesh.valence(v);
+                mesh.regular[v] = (!mesh.boundary[v] && valence == 6) || (mesh.boundary[v] && valence == 4);
+            }
+        }
+    );
+
+    return mesh;
+}
+
+SubdivMesh subdivide(const SubdivMesh& mesh)
+{
+    const uint32_t vertexCount = mesh.getVertexCount();
+    const uint32_t faceCount = mesh.getFaceCount();
+    const size_t edgeCount = mesh.indices.size();
+
+    // Assign odd vertices to edges. An odd vertex is created for the first face edge visiting a vertex pair,
+    // and all face edges with the same vertex pair share it.
+    auto edges = sortEdges(mesh);
+    std::vector<uint32_t> isFirst(edgeCount, 0);
+    parallelForBlocks(
+        edgeCount,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (edges.groupStarts[i] == i)
+                    isFirst[edges.faceEdges[i]] = 1;
+            }
+        }
+    );
+    std::vector<uint32_t> oddRank(edgeCount);
+    std::exclusive_scan(std::execution::par, isFirst.begin(), isFirst.end(), oddRank.begin(), 0u);
+    const uint32_t oddCount = edgeCount > 0 ? oddRank.back() + isFirst.back() : 0;
+
+    std::vector<uint32_t> edgeVertices(edgeCount);
+    parallelForBlocks(
+        edgeCount,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                edgeVertices[edges.faceEdges[i]] = vertexCount + oddRank[edges.faceEdges[edges.groupStarts[i]]];
+        }
+    );
+
+    SubdivMesh child;
+    const uint32_t childVertexCount = vertexCount + oddCount;
+    child.positions.resize(childVertexCount);
+    child.startFaces.resize(childVertexCount);
+    child.boundary.resize(childVertexCount);
+    child.regular.resize(childVertexCount);
+    child.indices.resize(4 * mesh.indices.size());
+    child.neighbors.resize(4 * mesh.neighbors.size());
+
+    // Update vertex positions for even vertices.
+    parallelForBlocks(
+        vertexCount,
+        [&](size_t begin, size_t end)
+        {
+            for (uint32_t v = (uint32_t)begin; v < (uint32_t)end; ++v)
+            {
+                if (!mesh.boundary[v])
+                {
+                    // Apply one-ring rule for even vertex.
+                    if (mesh.regular[v])
+                        child.positions[v] = mesh.weightOneRing(v, 1.f / 16.f);
+                    else
+                        child.positions[v] = mesh.weightOneRing(v, beta(mesh.valence(v)));
+                }
+                else
+                {
+                    // Apply boundary rule for even vertex.
+                    child.positions[v] = mesh.weightBoundary(v, 1.f / 8.f);
+                }
+                uint32_t startFace = mesh.startFaces[v];
+                child.startFaces[v] = 4 * startFace + mesh.vnum(startFace, v);
+                child.boundary[v] = mesh.boundary[v];
+                child.regular[v] = mesh.regular[v];
+            }
+        }
+    );
+
+    // Compute new odd edge vertices.
+    parallelForBlocks(
+        edgeCount,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t fe = begin; fe < end; ++fe)
+            {
+                if (!isFirst[fe])
+                    continue;
+
+                uint32_t face = (uint32_t)(fe / 3);
+                uint32_t k = (uint32_t)(fe % 3);
+                uint32_t v0 = mesh.indices[3 * face + k];
+                uint32_t v1 = mesh.indices[3 * face + NEXT(k)];
+                uint32_t neighbor = mesh.neighbors[fe];
+                uint32_t vert = edgeVertices[fe];
+
+                child.regular[vert] = true;
+                child.boundary[vert] = neighbor == kInvalidIndex;
+                child.startFaces[vert] = 4 * face + 3;
+
+                // Apply edge rules to compute new vertex position.
+                float3 p;
+                if (child.boundary[vert])
+                {
+                    p = 0.5f * mesh.positions[std::min(v0, v1)];
+                    p += 0.5f * mesh.positions[std::max(v0, v1)];
+                }
+                else
+                {
+                    p = 3.f / 8.f * mesh.positions[std::min(v0, v1)];
+                    p += 3.f / 8.f * mesh.positions[std::max(v0, v1)];
+                    p += 1.f / 8.f * mesh.positions[mesh.otherVert(face, v0, v1)];
+                    p += 1.f / 8.f * mesh.positions[mesh.otherVert(neighbor, v0, v1)];
+                }
+                child.positions[vert] = p;
+            }
+        }
+    );
+
+    // Update new mesh topology.
+    parallelForBlocks(
+        faceCount,
+        [&](size_t begin, size_t end)
+        {
+            for (uint32_t face = (uint32_t)begin; face < (uint32_t)end; ++face)
+            {
+                const uint32_t* v = &mesh.indices[3 * face];
+                const uint32_t* f = &mesh.neighbors[3 * face];
+                uint32_t* childIndices = &child.indices[12 * face];
+                uint32_t* childNeighbors = &child.neighbors[12 * face];
+
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    // Update children neighbors for siblings.
+                    childNeighbors[9 + j] = 4 * face + NEXT(j);
+                    childNeighbors[3 * j + NEXT(j)] = 4 * face + 3;
+
+                    // Update children neighbors for neighbor children.
+                    uint32_t f2 = f[j];
+                    childNeighbors[3 * j + j] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, v[j]) : kInvalidIndex;
+                    f2 = f[PREV(j)];
+                    childNeighbors[3 * j + PREV(j)] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, v[j]) : kInvalidIndex;
+                }
+
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    // Update child vertex index to new even vertex.
+                    childIndices[3 * j + j] = v[j];
+
+                    // Update child vertex index to new odd vertex.
+                    uint32_t vert = edgeVertices[3 * face + j];
+                    childIndices[3 * j + NEXT(j)] = vert;
+                    childIndices[3 * NEXT(j) + j] = vert;
+                    childIndices[9 + j] = vert;
+                }
+            }
+        }
+    );
+
+    return child;
+}
+} // namespace
+
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    SubdivMesh mesh = createBaseMesh(positions, indices);
+
+    for (uint32_t i = 0; i < levels; ++i)
+        mesh = subdivide(mesh);
+
+    const uint32_t vertexCount = mesh.getVertexCount();
+
+    // Push vertices to limit surface.
+    std::vector<float3> pLimit(vertexCount);
+    parallelForBlocks(
+        vertexCount,
+        [&](size_t begin, size_t end)
+        {
+            for (uint32_t v = (uint32_t)begin; v < (uint32_t)end; ++v)
+            {
+                if (mesh.boundary[v])
+                    pLimit[v] = mesh.weightBoundary(v, 1.f / 5.f);
+                else
+                    pLimit[v] = mesh.weightOneRing(v, loopGamma(mesh.valence(v)));
+            }
+        }
+    );
+    mesh.positions = pLimit;
+
+    // Compute vertex tangents on limit surface.
+    std::vector<float3> Ns(vertexCount);
+    parallelForBlocks(
+        vertexCount,
+        [&](size_t begin, size_t end)
+        {
+            std::vector<float3> pRing;
+            for (uint32_t v = (uint32_t)begin; v < (uint32_t)end; ++v)
+            {
+                float3 S(0.f);
+                float3 T(0.f);
+                const float3& p = mesh.positions[v];
+                pRing.clear();
+                mesh.forEachOneRing(v, [&](uint32_t r) { pRing.push_back(mesh.positions[r]); });
+                uint32_t valence = (uint32_t)pRing.size();
+                if (!mesh.boundary[v])
+                {
+                    // Compute tangents of interior face
+                    for (uint32_t j = 0; j < valence; ++j)
+                    {
+                        S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                        T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                    }
+                }
+                else
+                {
+                    // Compute tangents of boundary face
+                    S = pRing[valence - 1] - pRing[0];
+                    if (valence == 2)
+                    {
+                        T = float3(pRing[0] + pRing[1] - 2.f * p);
+                    }
+                    else if (valence == 3)
+                    {
+                        T = pRing[1] - p;
+                    }
+                    else if (valence == 4) // regular
+                    {
+                        T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                    }
+                    else
+                    {
+                        float theta = float(M_PI) / float(valence - 1);
+                        T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
+                        for (uint32_t k = 1; k < valence - 1; ++k)
+                        {
+                            float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                            T += float3(wt * pRing[k]);
+                        }
+                        T = -T;
+                    }
+                }
+                Ns[v] = cross(S, T);
+            }
+        }
+    );
+
+    LoopSubdivideResult result;
+    result.positions = std::move(mesh.positions);
+    result.normals = std::move(Ns);
+    result.indices = std::move(mesh.indices);
+    return result;
+}
+
 } // namespace Falcor::pbrt
@@ -46,6 +46,22 @@ struct LoopSubdivideResult
     std::vector<uint32_t> indices;
 };
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> vertices);
+/**
+ * Apply Loop subdivision to a triangle mesh and push the vertices to the limit surface.
+ * The mesh is stored in flat arrays with face adjacency built by sorting edges,
+ * and each subdivision level is computed in parallel.
+ * The result is identical to loopSubdivideReference().
+ * @param[in] levels Number of subdivision levels.
+ * @param[in] positions Vertex positions.
+ * @param[in] indices Triangle indices (3 per face). All vertices must be referenced by at least one face.
+ * @return Subdivided mesh with limit surface positions and normals.
+ */
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices);
+
+/**
+ * Reference implementation of Loop subdivision.
+ * This is a straight port of pbrt's pointer-based implementation and is kept for validation.
+ */
+LoopSubdivideResult loopSubdivideReference(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices);
 
 } // namespace Falcor::pbrt
@@ -1793,6 +1793,8 @@ InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceD
 
 void buildScene(BuilderContext& ctx)
 {
+    ctx.builder.reportProgress("Creating materials");
+
     // Load float textures.
     for (const auto& [name, entity] : ctx.scene.getFloatTextures())
         ctx.floatTextures.emplace(name, createFloatTexture(ctx, entity));
@@ -1843,8 +1845,12 @@ void buildScene(BuilderContext& ctx)
     }
 
     // Process shapes and create meshes.
-    for (const auto& entity : ctx.scene.getShapes())
+    const auto& shapes = ctx.scene.getShapes();
+    for (size_t i = 0; i < shapes.size(); ++i)
     {
+        const auto& entity = shapes[i];
+        if (i % 64 == 0)
+            ctx.builder.reportProgress("Creating shapes", float(i) / shapes.size());
         auto shape = createShape(ctx, entity);
         if (shape.pTriangleMesh)
         {
@@ -1890,6 +1896,7 @@ void buildScene(BuilderContext& ctx)
     };
 
     // Create instanced shapes.
+    ctx.builder.reportProgress("Creating instances");
     for (const auto& entity : ctx.scene.getInstances())
     {
         const auto& instanceDefinition = getInstanceDefinition(entity);
@@ -1925,6 +1932,7 @@ void PBRTImporter::importScene(
         TimeReport timeReport;
         pbrt::BasicScene pbrtScene(path.parent_path());
         pbrt::BasicSceneBuilder pbrtBuilder(pbrtScene);
+        builder.reportProgress("Parsing pbrt scene");
         pbrt::parseFile(pbrtBuilder, path);
         timeReport.measure("Parsing pbrt scene");
 
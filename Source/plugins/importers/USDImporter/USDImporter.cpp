@@ -325,6 +325,7 @@ namespace Falcor
         auto resolverContext = ArGetResolver().CreateDefaultContextForAsset(path.string());
         ArResolverContextBinder binder(resolverContext);
 
+        builder.reportProgress("Opening USD stage");
         UsdStageRefPtr pStage = UsdStage::Open(path.string());
         if (!pStage)
         {
@@ -397,6 +398,7 @@ namespace Falcor
         ctx.setRootXform(rootXform);
 
         // Traverse the stage, converting USD prims to Falcor equivalents
+        builder.reportProgress("Converting USD prims");
         traversePrims(rootPrim, ctx);
 
         // Only the stage root xform should remain.
@@ -404,6 +406,7 @@ namespace Falcor
 
         timeReport.measure("Traverse prims");
 
+        builder.reportProgress("Processing USD geometry");
         ctx.finalize();
 
         if (ctx.builder.getCameras().empty())
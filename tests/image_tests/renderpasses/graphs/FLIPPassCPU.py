@@ -0,0 +1,23 @@
+from falcor import *
+
+def test_FLIPPassCPU():
+    imageLoaderA = createPass("ImageLoader", {'filename': 'test_images/cubemap/sorsele3/posz.jpg', 'mips': False, 'srgb': False})
+    imageLoaderB = createPass("ImageLoader", {'filename': 'test_images/cubemap/sorsele3/posx.jpg', 'mips': False, 'srgb': False})
+    # Use default viewing conditions so that results do not depend on the attached monitor.
+    flip = createPass("FLIPPass", {'useMagma': False, 'useRealMonitorInfo': False})
+
+    graph = RenderGraph("FLIPCPU")
+    graph.addPass(imageLoaderA, "ImageLoaderA")
+    graph.addPass(imageLoaderB, "ImageLoaderB")
+    graph.addPass(flip, "FLIP")
+    graph.addEdge("ImageLoaderA.dst", "FLIP.referenceImage")
+    graph.addEdge("ImageLoaderB.dst", "FLIP.testImage")
+    graph.markOutput("ImageLoaderA.dst")
+    graph.markOutput("ImageLoaderB.dst")
+    graph.markOutput("FLIP.errorMap")
+
+    return graph
+
+FLIPPassCPU = test_FLIPPassCPU()
+try: m.addGraph(FLIPPassCPU)
+except NameError: None
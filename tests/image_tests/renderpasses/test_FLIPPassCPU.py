@@ -0,0 +1,19 @@
+# Captures FLIP inputs and raw error maps. The references are used by
+# tests/testing/verify_cpu_flip.py to validate the CPU FLIP implementation in ImageCompare.
+import sys
+sys.path.append('..')
+from helpers import render_frames
+from graphs.FLIPPassCPU import FLIPPassCPU as g
+from falcor import *
+
+m.addGraph(g)
+
+# LDR-FLIP
+render_frames(m, 'LDR')
+
+# HDR-FLIP
+for toneMapper in ['ACES', 'Hable', 'Reinhard']:
+    g.updatePass('FLIP', {'useMagma': False, 'useRealMonitorInfo': False, 'isHDR': True, 'toneMapper': toneMapper})
+    render_frames(m, 'HDR.' + toneMapper)
+
+exit()
@@ -140,6 +140,9 @@ class Test:
         # Get tolerance.
         self.tolerance = self.header.get('tolerance', config.DEFAULT_TOLERANCE)
 
+        # Get image comparison metric.
+        self.metric = self.header.get('metric', config.DEFAULT_METRIC)
+
         # Get timeout.
         self.timeout = self.header.get('timeout', config.DEFAULT_TIMEOUT)
 
@@ -274,7 +277,7 @@ class Test:
             result_file = result_dir / image
             error_file = result_dir / (str(image) + config.ERROR_IMAGE_SUFFIX)
 
-            args = [str(image_compare_exe), '-m', 'mse', '-t', str(self.tolerance), str(ref_file), str(result_file)]
+            args = [str(image_compare_exe), '-m', self.metric, '-t', str(self.tolerance), str(ref_file), str(result_file)]
             if error_file:
                 args += ['-e', str(error_file)]
             processes[image] = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
@@ -0,0 +1,89 @@
+'''
+Verifies the CPU FLIP implementation in ImageCompare against FLIPPass.
+
+Runs ImageCompare with the FLIP metrics on the input images stored in the
+references of the renderpasses/test_FLIPPassCPU image test and compares the
+resulting error maps to the error maps computed by FLIPPass.
+'''
+
+import sys
+import argparse
+import subprocess
+import tempfile
+from pathlib import Path
+
+from core import Environment, config
+from core.environment import find_most_recent_build_config
+
+# Test containing the FLIPPass references.
+TEST_NAME = 'renderpasses/test_FLIPPassCPU'
+
+# Captured runs and the ImageCompare arguments to reproduce them.
+RUNS = {
+    'LDR': ['-m', 'flip'],
+    'HDR.ACES': ['-m', 'hdrflip', '--tone-mapper', 'aces'],
+    'HDR.Hable': ['-m', 'hdrflip', '--tone-mapper', 'hable'],
+    'HDR.Reinhard': ['-m', 'hdrflip', '--tone-mapper', 'reinhard'],
+}
+
+# Default tolerance (MSE between CPU and GPU error maps).
+DEFAULT_TOLERANCE = 1e-6
+
+def find_image(ref_dir, prefix):
+    images = [p for p in ref_dir.glob(prefix + '.*') if p.suffix in config.IMAGE_EXTENSIONS and not p.name.endswith(config.ERROR_IMAGE_SUFFIX)]
+    return images[0] if len(images) > 0 else None
+
+def verify_run(env, ref_dir, name, compare_args, tolerance, work_dir):
+    '''
+    Compute the CPU error map for a run and compare it against the FLIPPass error map.
+    Returns (success, message).
+    '''
+    reference = find_image(ref_dir, f'{name}.ImageLoaderA.dst.1')
+    test = find_image(ref_dir, f'{name}.ImageLoaderB.dst.1')
+    gpu_error_map = find_image(ref_dir, f'{name}.FLIP.errorMap.1')
+    if not reference or not test or not gpu_error_map:
+        return False, f'Missing reference images for "{name}" in "{ref_dir}".'
+
+    cpu_error_map = work_dir / f'{name}.errorMap.exr'
+    args = [str(env.image_compare_exe), '-t', '1', '-f', str(cpu_error_map)] + compare_args + [str(reference), str(test)]
+    p = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if not cpu_error_map.exists():
+        return False, f'Failed to compute CPU FLIP for "{name}":\n{p.stdout}'
+    cpu_mean = p.stdout.strip()
+
+    args = [str(env.image_compare_exe), '-m', 'mse', '-t', str(tolerance), str(gpu_error_map), str(cpu_error_map)]
+    p = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    return p.returncode == 0, f'{name}: mean FLIP (CPU) = {cpu_mean}, error map MSE = {p.stdout.strip()}'
+
+def main():
+    default_config = find_most_recent_build_config()
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--environment', type=str, action='store', help=f'Environment', default=None)
+    parser.add_argument('--config', type=str, action='store', help=f'Build configuration (default: {default_config})', default=default_config)
+    parser.add_argument('-d', '--device-type', type=str, action='store', help='Device type of the references', default='d3d12')
+    parser.add_argument('-b', '--ref-branch', help='Reference branch (defaults to master branch)', default='master')
+    parser.add_argument('--build-id', type=str, action='store', help='TeamCity build ID', default='unknown')
+    parser.add_argument('--tolerance', type=float, action='store', help=f'Error map tolerance (default: {DEFAULT_TOLERANCE})', default=DEFAULT_TOLERANCE)
+    args = parser.parse_args()
+
+    try:
+        env = Environment(args.environment, args.config)
+    except Exception as e:
+        print(e)
+        sys.exit(1)
+
+    ref_dir = env.resolve_image_dir(env.image_tests_ref_dir, args.ref_branch, args.build_id) / f'{TEST_NAME}_{args.device_type}'
+    print(f'Reference directory: {ref_dir}')
+
+    success = True
+    with tempfile.TemporaryDirectory() as work_dir:
+        for name, compare_args in RUNS.items():
+            run_success, message = verify_run(env, ref_dir, name, compare_args, args.tolerance, Path(work_dir))
+            print(('PASSED ' if run_success else 'FAILED ') + message)
+            success = success and run_success
+
+    sys.exit(0 if success else 1)
+
+if __name__ == '__main__':
+    main()